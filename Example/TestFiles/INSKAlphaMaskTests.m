@@ -0,0 +1,174 @@
+// INSKAlphaMaskTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The size of the test image in pixels.
+static const size_t INSKAlphaMaskTestsImageSize = 256;
+// The number of hit tests per measurement.
+static const NSUInteger INSKAlphaMaskTestsIterations = 100000;
+
+
+@interface INSKAlphaMaskTests : XCTestCase
+
+@property (nonatomic, assign) CGImageRef image;
+@property (nonatomic, strong) SKSpriteNode *sprite;
+@property (nonatomic, assign) CGPoint *points;
+
+@end
+
+
+@implementation INSKAlphaMaskTests
+
+- (void)setUp {
+    [super setUp];
+    
+    // An opaque circle filling the image, so the corners are transparent.
+    size_t size = INSKAlphaMaskTestsImageSize;
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(NULL, size, size, 8, size * 4, colorSpace, (CGBitmapInfo)kCGImageAlphaPremultipliedLast);
+    CGColorSpaceRelease(colorSpace);
+    CGContextSetRGBFillColor(context, 1, 0, 0, 1);
+    CGContextFillEllipseInRect(context, CGRectMake(0, 0, size, size));
+    self.image = CGBitmapContextCreateImage(context);
+    CGContextRelease(context);
+    
+    self.sprite = [SKSpriteNode spriteNodeWithColor:[SKColor redColor] size:CGSizeMake(size, size)];
+    
+    // Random points in and around the sprite.
+    self.points = malloc(INSKAlphaMaskTestsIterations * sizeof(CGPoint));
+    srand(1);
+    for (NSUInteger index = 0; index < INSKAlphaMaskTestsIterations; ++index) {
+        self.points[index] = CGPointMake((rand() % (size + 40)) - (size + 40) / 2.0, (rand() % (size + 40)) - (size + 40) / 2.0);
+    }
+}
+
+- (void)tearDown {
+    free(self.points);
+    CGImageRelease(self.image);
+    [super tearDown];
+}
+
+// Reads the alpha value of a single pixel of the image by drawing it into a 1x1 context, which is what a hit test without a mask would have to do.
+- (BOOL)isImageOpaqueAtPoint:(CGPoint)point ofSprite:(SKSpriteNode *)sprite {
+    if (![sprite isPointInside:point]) {
+        return NO;
+    }
+    size_t width = CGImageGetWidth(self.image);
+    size_t height = CGImageGetHeight(self.image);
+    // The right and top edges belong to the last pixel like in the mask.
+    CGFloat x = MIN(floor((point.x / sprite.size.width + sprite.anchorPoint.x) * width), width - 1);
+    CGFloat y = MIN(floor((point.y / sprite.size.height + sprite.anchorPoint.y) * height), height - 1);
+    uint8_t alpha = 0;
+    CGContextRef context = CGBitmapContextCreate(&alpha, 1, 1, 8, 1, NULL, (CGBitmapInfo)kCGImageAlphaOnly);
+    CGContextDrawImage(context, CGRectMake(-x, -y, width, height), self.image);
+    CGContextRelease(context);
+    return alpha > 127;
+}
+
+
+#pragma mark - mask
+
+- (void)test_mask_isOpaqueInsideOfTheCircleOnly {
+    INSKAlphaMask *mask = [[INSKAlphaMask alloc] initWithCGImage:self.image downsampling:1 alphaThreshold:0.5];
+    XCTAssertNotNil(mask, @"mask should be created");
+    XCTAssert(CGSizeEqualToSize(mask.size, CGSizeMake(INSKAlphaMaskTestsImageSize, INSKAlphaMaskTestsImageSize)), @"mask size is wrong");
+    XCTAssertTrue([mask isOpaqueAtNormalizedPoint:CGPointMake(0.5, 0.5)], @"center should be opaque");
+    XCTAssertTrue([mask isOpaqueAtNormalizedPoint:CGPointMake(0.5, 0.02)], @"bottom edge should be opaque");
+    XCTAssertFalse([mask isOpaqueAtNormalizedPoint:CGPointMake(0.02, 0.02)], @"bottom left corner should be transparent");
+    XCTAssertFalse([mask isOpaqueAtNormalizedPoint:CGPointMake(0.98, 0.98)], @"top right corner should be transparent");
+    XCTAssertFalse([mask isOpaqueAtNormalizedPoint:CGPointMake(1.5, 0.5)], @"outside should be transparent");
+}
+
+- (void)test_mask_downsamplingReducesMemory {
+    NSUInteger memoryBefore = [INSKAlphaMask totalMemorySize];
+    INSKAlphaMask *mask = [[INSKAlphaMask alloc] initWithCGImage:self.image downsampling:1 alphaThreshold:0.5];
+    INSKAlphaMask *downsampledMask = [[INSKAlphaMask alloc] initWithCGImage:self.image downsampling:4 alphaThreshold:0.5];
+    XCTAssert(CGSizeEqualToSize(downsampledMask.size, CGSizeMake(INSKAlphaMaskTestsImageSize / 4, INSKAlphaMaskTestsImageSize / 4)), @"mask size is wrong");
+    XCTAssert(downsampledMask.memorySize < mask.memorySize / 8, @"downsampled mask should use less memory");
+    XCTAssertEqual([INSKAlphaMask totalMemorySize], memoryBefore + mask.memorySize + downsampledMask.memorySize, @"memory is not accounted");
+    XCTAssertTrue([downsampledMask isOpaqueAtNormalizedPoint:CGPointMake(0.5, 0.5)], @"center should be opaque");
+    XCTAssertFalse([downsampledMask isOpaqueAtNormalizedPoint:CGPointMake(0.02, 0.02)], @"corner should be transparent");
+}
+
+
+#pragma mark - sprite
+
+- (void)test_isPointInside_withAlphaMaskIgnoresTransparentCorners {
+    CGPoint corner = CGPointMake(-INSKAlphaMaskTestsImageSize * 0.48, INSKAlphaMaskTestsImageSize * 0.48);
+    XCTAssertTrue([self.sprite isPointInside:corner], @"corner should be inside without a mask");
+    
+    self.sprite.alphaMask = [[INSKAlphaMask alloc] initWithCGImage:self.image downsampling:1 alphaThreshold:0.5];
+    XCTAssertFalse([self.sprite isPointInside:corner], @"corner should be outside with a mask");
+    XCTAssertTrue([self.sprite isPointInside:CGPointZero], @"center should be inside with a mask");
+    
+    self.sprite.anchorPoint = CGPointZero;
+    XCTAssertTrue([self.sprite isPointInside:CGPointMake(INSKAlphaMaskTestsImageSize / 2, INSKAlphaMaskTestsImageSize / 2)], @"center should be inside with another anchor point");
+    XCTAssertFalse([self.sprite isPointInside:CGPointMake(2, 2)], @"corner should be outside with another anchor point");
+}
+
+- (void)test_isPointInside_withAlphaMaskMatchesImageSampling {
+    self.sprite.alphaMask = [[INSKAlphaMask alloc] initWithCGImage:self.image downsampling:1 alphaThreshold:0.5];
+    for (NSUInteger index = 0; index < 1000; ++index) {
+        CGPoint point = self.points[index];
+        XCTAssertEqual([self.sprite isPointInside:point], [self isImageOpaqueAtPoint:point ofSprite:self.sprite], @"mask and image differ at %f, %f", point.x, point.y);
+    }
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_rectOnly {
+    [self measureBlock:^{
+        NSUInteger hits = 0;
+        for (NSUInteger index = 0; index < INSKAlphaMaskTestsIterations; ++index) {
+            hits += [self.sprite isPointInside:self.points[index]];
+        }
+        XCTAssert(hits > 0, @"no hits");
+    }];
+}
+
+- (void)test_performance_bitmask {
+    self.sprite.alphaMask = [[INSKAlphaMask alloc] initWithCGImage:self.image downsampling:1 alphaThreshold:0.5];
+    [self measureBlock:^{
+        NSUInteger hits = 0;
+        for (NSUInteger index = 0; index < INSKAlphaMaskTestsIterations; ++index) {
+            hits += [self.sprite isPointInside:self.points[index]];
+        }
+        XCTAssert(hits > 0, @"no hits");
+    }];
+}
+
+- (void)test_performance_imageSampling {
+    [self measureBlock:^{
+        NSUInteger hits = 0;
+        for (NSUInteger index = 0; index < INSKAlphaMaskTestsIterations; ++index) {
+            hits += [self isImageOpaqueAtPoint:self.points[index] ofSprite:self.sprite];
+        }
+        XCTAssert(hits > 0, @"no hits");
+    }];
+}
+
+
+@end
@@ -0,0 +1,191 @@
+// INSKFixedTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The checksum of the simulation, which has to be the same on all devices, simulators and Tools/INSKFixedTests.c.
+static const uint64_t INSKFixedTestsExpectedChecksum = 0x40CC6F1233CD6F11ull;
+
+// The number of sampled values per test, Tools/INSKFixedTests.c checks many more.
+static const NSUInteger INSKFixedTestsSampleCount = 100000;
+
+
+@interface INSKFixedTests : XCTestCase
+
+@end
+
+
+@implementation INSKFixedTests
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+
+#pragma mark - helpers
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKFixedTestsRandom(uint32_t *state) {
+    uint32_t value = *state;
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    *state = value;
+    return value;
+}
+
+// Adds a value to a FNV-1a checksum byte by byte, so the byte order of the platform doesn't matter.
+static uint64_t INSKFixedTestsChecksumAdd(uint64_t checksum, INSKFixed value) {
+    uint32_t bits = (uint32_t)value;
+    for (int byte = 0; byte < 4; ++byte) {
+        checksum ^= (bits >> (byte * 8)) & 0xFF;
+        checksum *= 0x100000001B3ull;
+    }
+    return checksum;
+}
+
+// Steers a swarm of agents with all fixed-point functions like Tools/INSKFixedTests.c and returns the checksum of all states.
+static uint64_t INSKFixedTestsSimulationChecksum(void) {
+    enum { agentCount = 64, stepCount = 2000 };
+    INSKFixedPoint positions[agentCount];
+    INSKFixed headings[agentCount];
+    uint32_t state = 1;
+    for (int agent = 0; agent < agentCount; ++agent) {
+        positions[agent] = INSKFixedPointMake((INSKFixed)(INSKFixedTestsRandom(&state) % (1000u * 65536u)) - 500 * INSKFixedOne,
+                                              (INSKFixed)(INSKFixedTestsRandom(&state) % (1000u * 65536u)) - 500 * INSKFixedOne);
+        headings[agent] = (INSKFixed)(INSKFixedTestsRandom(&state) % (uint32_t)INSKFixedPiX2);
+    }
+
+    uint64_t checksum = 0xCBF29CE484222325ull;
+    INSKFixed timeStep = INSKFixedDivide(INSKFixedOne, INSKFixedFromInt(60));
+    INSKFixed maxTurn = INSKFixedMultiply(INSKFixedPi, timeStep);
+    for (int step = 0; step < stepCount; ++step) {
+        // A target moving on a circle.
+        INSKFixedPoint target = INSKFixedPointMultiplyScalar(INSKFixedPointForAngle(INSKFixedMultiply(INSKFixedFromInt(step), timeStep)), INSKFixedFromInt(200));
+        for (int agent = 0; agent < agentCount; ++agent) {
+            INSKFixedPoint toTarget = INSKFixedPointSubtract(target, positions[agent]);
+            INSKFixed turn = INSKFixedShortestAngleBetween(headings[agent], INSKFixedPointToAngle(toTarget));
+            headings[agent] = INSKFixedAngleInPi(INSKFixedAdd(headings[agent], INSKFixedClamp(turn, -maxTurn, maxTurn)));
+            INSKFixed distance = INSKFixedPointDistance(positions[agent], target);
+            INSKFixed speed = INSKFixedClamp(INSKFixedSqrt(distance) * 8, INSKFixedFromInt(10), INSKFixedFromInt(150));
+            INSKFixedPoint velocity = INSKFixedPointMultiplyScalar(INSKFixedPointForAngle(headings[agent]), INSKFixedMultiply(speed, timeStep));
+            INSKFixedPoint direction = INSKFixedPointNormalize(toTarget);
+            if (INSKFixedPointDotProduct(direction, velocity) < 0) {
+                velocity = INSKFixedPointLerp(velocity, INSKFixedPointMultiplyScalar(direction, INSKFixedAbs(INSKFixedPointCrossProduct(direction, velocity))), INSKFixedOne / 8);
+            }
+            positions[agent] = INSKFixedPointAdd(positions[agent], velocity);
+            checksum = INSKFixedTestsChecksumAdd(checksum, positions[agent].x);
+            checksum = INSKFixedTestsChecksumAdd(checksum, positions[agent].y);
+            checksum = INSKFixedTestsChecksumAdd(checksum, headings[agent]);
+        }
+    }
+    return checksum;
+}
+
+
+#pragma mark - convertions
+
+- (void)test_fromCGFloat_roundsToNearest {
+    XCTAssertEqual(INSKFixedFromCGFloat(1.0), INSKFixedOne, @"1.0 not converted");
+    XCTAssertEqual(INSKFixedFromCGFloat(-0.25), (INSKFixed)-16384, @"-0.25 not converted");
+    XCTAssertEqual(INSKFixedFromCGFloat(M_PI), INSKFixedPi, @"M_PI not converted");
+    XCTAssertEqual(INSKFixedFromCGFloat(1e10), (INSKFixed)INT32_MAX, @"big value not clamped");
+    XCTAssertEqual(INSKFixedFromCGFloat(NAN), (INSKFixed)0, @"NaN not converted to 0");
+}
+
+- (void)test_pointConvertions_areExactForRepresentableValues {
+    CGPoint point = CGPointFromINSKFixedPoint(INSKFixedPointFromCGPoint(CGPointMake(12.5, -7.25)));
+    XCTAssertEqual(point.x, (CGFloat)12.5, @"x not converted");
+    XCTAssertEqual(point.y, (CGFloat)-7.25, @"y not converted");
+}
+
+
+#pragma mark - calculations
+
+- (void)test_pointCalculations_returnExactValues {
+    INSKFixedPoint point = INSKFixedPointFromCGPoint(CGPointMake(3.0, 4.0));
+    XCTAssertEqual(INSKFixedPointLength(point), 5 * INSKFixedOne, @"length wrong");
+    XCTAssertEqual(INSKFixedPointDotProduct(point, point), 25 * INSKFixedOne, @"dot product wrong");
+    XCTAssertEqual(INSKFixedSqrt(4 * INSKFixedOne), 2 * INSKFixedOne, @"square root wrong");
+}
+
+- (void)test_sinCos_staysInDocumentedMaxError {
+    for (NSUInteger index = 0; index <= INSKFixedTestsSampleCount; ++index) {
+        INSKFixed angle = (INSKFixed)(-4 * INSKFixedPiX2 + (int64_t)8 * INSKFixedPiX2 * (int64_t)index / (int64_t)INSKFixedTestsSampleCount);
+        INSKFixedPoint point = INSKFixedPointForAngle(angle);
+        double radians = angle / 65536.0;
+        XCTAssertEqualWithAccuracy(point.x / 65536.0, cos(radians), 2.0 / 65536.0, @"cosine not accurate at %f", radians);
+        XCTAssertEqualWithAccuracy(point.y / 65536.0, sin(radians), 2.0 / 65536.0, @"sine not accurate at %f", radians);
+    }
+}
+
+- (void)test_pointToAngle_staysInDocumentedMaxError {
+    for (NSUInteger index = 0; index <= INSKFixedTestsSampleCount; ++index) {
+        double radians = -M_PI + 2.0 * M_PI * index / INSKFixedTestsSampleCount;
+        INSKFixedPoint point = INSKFixedPointFromCGPoint(CGPointMake(cos(radians) * 100.0, sin(radians) * 100.0));
+        XCTAssertEqualWithAccuracy(INSKFixedPointToAngle(point) / 65536.0, atan2(point.y, point.x), 2.0 / 65536.0, @"angle not accurate at %f", radians);
+    }
+}
+
+
+#pragma mark - determinism
+
+- (void)test_simulation_matchesChecksumOfAllPlatforms {
+    XCTAssertEqual(INSKFixedTestsSimulationChecksum(), INSKFixedTestsExpectedChecksum, @"results differ from the other platforms");
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_steering_CGFloat {
+    [self measureBlock:^{
+        CGFloat sum = 0;
+        for (NSUInteger index = 0; index < INSKFixedTestsSampleCount; ++index) {
+            CGPoint position = CGPointMake(1.0 + index % 7, 0.5 * index);
+            CGFloat heading = AngleInPi(CGPointToAngle(position) + 0.1);
+            sum += CGPointAdd(position, CGPointMultiplyScalar(CGPointForAngle(heading), CGPointLength(position) * 0.01)).x;
+        }
+        XCTAssert(sum != 0, @"no result");
+    }];
+}
+
+- (void)test_performance_steering_fixed {
+    [self measureBlock:^{
+        INSKFixed sum = 0;
+        for (NSUInteger index = 0; index < INSKFixedTestsSampleCount; ++index) {
+            INSKFixedPoint position = INSKFixedPointMake(INSKFixedFromInt(1 + index % 7), (INSKFixed)(index % 1000) * 32768);
+            INSKFixed heading = INSKFixedAngleInPi(INSKFixedPointToAngle(position) + 6554);
+            sum += INSKFixedPointAdd(position, INSKFixedPointMultiplyScalar(INSKFixedPointForAngle(heading), INSKFixedPointLength(position) / 100)).x;
+        }
+        XCTAssert(sum != 0, @"no result");
+    }];
+}
+
+@end
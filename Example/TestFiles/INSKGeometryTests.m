@@ -0,0 +1,128 @@
+// INSKGeometryTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The number of sampled points per test, Tools/INSKGeometryTests.c checks the other batch functions too.
+static const NSUInteger INSKGeometryTestsSampleCount = 100000;
+
+
+@interface INSKGeometryTests : XCTestCase
+
+@end
+
+
+@implementation INSKGeometryTests {
+    CGPoint *_points;
+    bool *_results;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    _points = malloc(sizeof(CGPoint) * INSKGeometryTestsSampleCount);
+    _results = malloc(sizeof(bool) * INSKGeometryTestsSampleCount);
+    for (NSUInteger index = 0; index < INSKGeometryTestsSampleCount; ++index) {
+        _points[index] = CGPointMake(index % 317 - 158.0, index % 211 - 105.0);
+    }
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    free(_points);
+    free(_results);
+    [super tearDown];
+}
+
+
+#pragma mark - containment
+
+- (void)test_axisAlignedBox_includesBoundary {
+    INSKAxisAlignedBox box = INSKAxisAlignedBoxFromCGRect(CGRectMake(0, 0, 100, -50));
+    XCTAssertTrue(INSKAxisAlignedBoxContainsPoint(box, CGPointMake(100, -50)), @"corner not inside");
+    XCTAssertTrue(INSKAxisAlignedBoxContainsPoint(box, CGPointMake(50, -25)), @"center not inside");
+    XCTAssertFalse(INSKAxisAlignedBoxContainsPoint(box, CGPointMake(50, 1)), @"outside point inside");
+}
+
+- (void)test_orientedBox_containsRotatedPoints {
+    INSKOrientedBox box = INSKOrientedBoxMake(CGPointZero, CGSizeMake(4, 2), M_PI_4);
+    XCTAssertTrue(INSKOrientedBoxContainsPoint(box, CGPointMake(1.4, 1.4)), @"point along the axis not inside");
+    XCTAssertFalse(INSKOrientedBoxContainsPoint(box, CGPointMake(1.9, 0)), @"point of the unrotated box inside");
+}
+
+- (void)test_polygon_excludesConcaveGap {
+    CGPoint corners[] = {{-5, 5}, {-2, 5}, {-2, 0}, {2, 0}, {2, 5}, {5, 5}, {5, -5}, {-5, -5}};
+    INSKPolygon polygon = INSKPolygonMake(corners, 8);
+    XCTAssertTrue(INSKPolygonContainsPoint(polygon, CGPointMake(-3.5, 3)), @"arm not inside");
+    XCTAssertFalse(INSKPolygonContainsPoint(polygon, CGPointMake(0, 3)), @"gap inside");
+}
+
+
+#pragma mark - overlap
+
+- (void)test_orientedBoxes_areSeparatedOnDiagonal {
+    INSKOrientedBox box = INSKOrientedBoxMake(CGPointZero, CGSizeMake(2, 2), 0);
+    INSKOrientedBox rotated = INSKOrientedBoxMake(CGPointMake(1.5, 1.5), CGSizeMake(1, 1), M_PI_4);
+    XCTAssertFalse(INSKOrientedBoxOverlapsBox(box, rotated), @"separated boxes overlap");
+    rotated.center = CGPointMake(1.2, 1.2);
+    XCTAssertTrue(INSKOrientedBoxOverlapsBox(box, rotated), @"overlapping boxes don't overlap");
+}
+
+
+#pragma mark - batches
+
+- (void)test_circleBatch_matchesSingleTests {
+    INSKCircle circle = INSKCircleMake(CGPointMake(10, -20), 80);
+    size_t inside = INSKCircleContainsPoints(circle, _points, _results, INSKGeometryTestsSampleCount);
+    size_t expected = 0;
+    for (NSUInteger index = 0; index < INSKGeometryTestsSampleCount; ++index) {
+        XCTAssertEqual(_results[index], INSKCircleContainsPoint(circle, _points[index]), @"batch differs at %lu", (unsigned long)index);
+        expected += _results[index];
+    }
+    XCTAssertEqual(inside, expected, @"batch counted wrong");
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_orientedBox_single {
+    INSKOrientedBox box = INSKOrientedBoxMake(CGPointMake(5, 5), CGSizeMake(120, 60), 0.3);
+    [self measureBlock:^{
+        size_t inside = 0;
+        for (NSUInteger index = 0; index < INSKGeometryTestsSampleCount; ++index) {
+            inside += INSKOrientedBoxContainsPoint(box, _points[index]);
+        }
+        XCTAssert(inside > 0, @"no result");
+    }];
+}
+
+- (void)test_performance_orientedBox_batch {
+    INSKOrientedBox box = INSKOrientedBoxMake(CGPointMake(5, 5), CGSizeMake(120, 60), 0.3);
+    [self measureBlock:^{
+        size_t inside = INSKOrientedBoxContainsPoints(box, _points, NULL, INSKGeometryTestsSampleCount);
+        XCTAssert(inside > 0, @"no result");
+    }];
+}
+
+@end
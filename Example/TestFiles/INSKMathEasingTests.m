@@ -0,0 +1,123 @@
+// INSKMathEasingTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The number of evaluated values per test, Tools/INSKMathEasingTests.c checks the curves against their formulas in detail.
+static const NSUInteger INSKMathEasingTestsSampleCount = 100000;
+
+
+@interface INSKMathEasingTests : XCTestCase
+
+@end
+
+
+@implementation INSKMathEasingTests {
+    CGFloat *_times;
+    CGFloat *_values;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    _times = malloc(sizeof(CGFloat) * INSKMathEasingTestsSampleCount);
+    _values = malloc(sizeof(CGFloat) * INSKMathEasingTestsSampleCount);
+    for (NSUInteger index = 0; index < INSKMathEasingTestsSampleCount; ++index) {
+        _times[index] = (CGFloat)((index * 7919) % INSKMathEasingTestsSampleCount) / INSKMathEasingTestsSampleCount;
+    }
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    free(_times);
+    free(_values);
+    [super tearDown];
+}
+
+
+#pragma mark - curves
+
+- (void)test_allCurves_startAtZeroAndEndAtOne {
+    for (int type = INSKEasingTypeLinear; type <= INSKEasingTypeCubicBezier; ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake((INSKEasingType)type);
+        XCTAssertEqual(INSKEasingCurveEvaluate(curve, 0.0), (CGFloat)0.0, @"type %d doesn't start at 0", type);
+        XCTAssertEqual(INSKEasingCurveEvaluate(curve, 1.0), (CGFloat)1.0, @"type %d doesn't end at 1", type);
+        XCTAssertEqual(INSKEasingCurveEvaluate(curve, 2.0), (CGFloat)1.0, @"type %d doesn't clamp the progress", type);
+    }
+}
+
+- (void)test_polynomialCurves_returnExactValues {
+    XCTAssertEqual(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeQuadOut), 0.5), (CGFloat)0.75, @"QuadOut wrong");
+    XCTAssertEqual(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeCubicInOut), 0.75), (CGFloat)0.9375, @"CubicInOut wrong");
+}
+
+- (void)test_cubicBezier_matchesCSSEaseInOut {
+    INSKEasingCurve curve = INSKEasingCurveMakeCubicBezier(0.42, 0.0, 0.58, 1.0);
+    XCTAssertEqualWithAccuracy(INSKEasingCurveEvaluate(curve, 0.5), 0.5, 1e-6, @"symmetric curve not at 0.5");
+    XCTAssertEqualWithAccuracy(INSKEasingCurveEvaluate(curve, 0.25) + INSKEasingCurveEvaluate(curve, 0.75), 1.0, 1e-6, @"curve not symmetric");
+}
+
+
+#pragma mark - batches and tables
+
+- (void)test_batchEvaluation_matchesScalarEvaluation {
+    for (int type = INSKEasingTypeLinear; type <= INSKEasingTypeCubicBezier; ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake((INSKEasingType)type);
+        INSKEasingCurveEvaluateValues(_values, _times, curve, 1000);
+        for (NSUInteger index = 0; index < 1000; ++index) {
+            XCTAssertEqual(_values[index], INSKEasingCurveEvaluate(curve, _times[index]), @"type %d differs", type);
+        }
+    }
+}
+
+- (void)test_tweenTable_hitsFramesExactly {
+    INSKEasingCurve curve = INSKEasingCurveMake(INSKEasingTypeElasticOut);
+    INSKEasingTable *table = INSKEasingTableCreateForTween(curve, 0.25, 60.0);
+    XCTAssertEqual(INSKEasingTableSampleCount(table), (size_t)16, @"wrong number of samples");
+    for (int frame = 0; frame <= 15; ++frame) {
+        CGFloat t = frame / 15.0;
+        XCTAssertEqualWithAccuracy(INSKEasingTableEvaluate(table, t), INSKEasingCurveEvaluate(curve, t), 1e-6, @"frame %d interpolated", frame);
+    }
+    INSKEasingTableDestroy(table);
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_elastic_curve {
+    INSKEasingCurve curve = INSKEasingCurveMake(INSKEasingTypeElasticOut);
+    [self measureBlock:^{
+        INSKEasingCurveEvaluateValues(_values, _times, curve, INSKMathEasingTestsSampleCount);
+    }];
+}
+
+- (void)test_performance_elastic_table {
+    INSKEasingTable *table = INSKEasingTableCreate(INSKEasingCurveMake(INSKEasingTypeElasticOut), 1024);
+    [self measureBlock:^{
+        INSKEasingTableEvaluateValues(_values, _times, table, INSKMathEasingTestsSampleCount);
+    }];
+    INSKEasingTableDestroy(table);
+}
+
+@end
@@ -0,0 +1,144 @@
+// INSKMathFastTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The number of sampled values per test, Tools/INSKMathFastTests.c checks many more.
+static const NSUInteger INSKMathFastTestsSampleCount = 100000;
+
+
+@interface INSKMathFastTests : XCTestCase
+
+@end
+
+
+@implementation INSKMathFastTests
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+
+#pragma mark - accuracy
+
+- (void)test_sinCosFast_staysInDocumentedMaxError {
+    for (NSUInteger index = 0; index <= INSKMathFastTestsSampleCount; ++index) {
+        double angle = -4.0 * M_PI + 8.0 * M_PI * index / INSKMathFastTestsSampleCount;
+        CGFloat sine;
+        CGFloat cosine;
+        SinCosFast(angle, &sine, &cosine);
+        XCTAssertEqualWithAccuracy(sine, sin(angle), 1e-11, @"sine not accurate at %f", angle);
+        XCTAssertEqualWithAccuracy(cosine, cos(angle), 1e-11, @"cosine not accurate at %f", angle);
+    }
+}
+
+- (void)test_sinCosFast_withAngleBeyondLimit_returnsExactValues {
+    CGFloat angle = INSK_FAST_ANGLE_LIMIT * 10.0 + 0.5;
+    CGPoint point = CGPointForAngleFast(angle);
+    XCTAssertEqual(point.x, (CGFloat)cos(angle), @"cosine not exact");
+    XCTAssertEqual(point.y, (CGFloat)sin(angle), @"sine not exact");
+}
+
+- (void)test_atan2Fast_staysInDocumentedMaxError {
+    for (NSUInteger index = 0; index <= INSKMathFastTestsSampleCount; ++index) {
+        double angle = -M_PI + 2.0 * M_PI * index / INSKMathFastTestsSampleCount;
+        CGPoint vector = CGPointMultiplyScalar(CGPointForAngle(angle), 1.0 + index % 100);
+        XCTAssertEqualWithAccuracy(CGPointToAngleFast(vector), CGPointToAngle(vector), 1e-7, @"angle not accurate at %f", angle);
+    }
+}
+
+- (void)test_atan2Fast_withSpecialValues_returnsSameAsAtan2 {
+    XCTAssertEqual(Atan2Fast(0.0, 0.0), (CGFloat)atan2(0.0, 0.0), @"zero vector not handled");
+    XCTAssertEqual(Atan2Fast(-0.0, -1.0), (CGFloat)atan2(-0.0, -1.0), @"negative zero not handled");
+    XCTAssertEqual(Atan2Fast(INFINITY, 1.0), (CGFloat)atan2(INFINITY, 1.0), @"infinity not handled");
+    XCTAssertTrue(isnan(Atan2Fast(NAN, 1.0)), @"NaN not handled");
+}
+
+- (void)test_normalizeFast_staysInDocumentedMaxError {
+    for (NSUInteger index = 0; index <= INSKMathFastTestsSampleCount; ++index) {
+        double angle = -M_PI + 2.0 * M_PI * index / INSKMathFastTestsSampleCount;
+        CGPoint vector = CGPointMultiplyScalar(CGPointForAngle(angle), 0.001 + index % 1000);
+        CGPoint fast = CGPointNormalizeFast(vector);
+        CGPoint exact = CGPointNormalize(vector);
+        XCTAssertEqualWithAccuracy(fast.x, exact.x, 2e-7 * fabs(exact.x) + INSK_EPSILON, @"x not accurate at %f", angle);
+        XCTAssertEqualWithAccuracy(fast.y, exact.y, 2e-7 * fabs(exact.y) + INSK_EPSILON, @"y not accurate at %f", angle);
+    }
+}
+
+- (void)test_normalizeFast_withZeroVector_returnsZeroVector {
+    CGPoint point = CGPointNormalizeFast(CGPointMake(0, 0));
+    XCTAssertEqual(point.x, (CGFloat)0.0, @"zero vector not handled");
+    XCTAssertEqual(point.y, (CGFloat)0.0, @"zero vector not handled");
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_pointForAngle_libm {
+    [self measureBlock:^{
+        CGFloat sum = 0;
+        for (NSUInteger index = 0; index < INSKMathFastTestsSampleCount; ++index) {
+            sum += CGPointForAngle(index * 0.001).x;
+        }
+        XCTAssert(sum != 0, @"no result");
+    }];
+}
+
+- (void)test_performance_pointForAngle_fast {
+    [self measureBlock:^{
+        CGFloat sum = 0;
+        for (NSUInteger index = 0; index < INSKMathFastTestsSampleCount; ++index) {
+            sum += CGPointForAngleFast(index * 0.001).x;
+        }
+        XCTAssert(sum != 0, @"no result");
+    }];
+}
+
+- (void)test_performance_pointToAngle_libm {
+    [self measureBlock:^{
+        CGFloat sum = 0;
+        for (NSUInteger index = 0; index < INSKMathFastTestsSampleCount; ++index) {
+            sum += CGPointToAngle(CGPointMake(1.0 + index % 7, 0.5 * index));
+        }
+        XCTAssert(sum != 0, @"no result");
+    }];
+}
+
+- (void)test_performance_pointToAngle_fast {
+    [self measureBlock:^{
+        CGFloat sum = 0;
+        for (NSUInteger index = 0; index < INSKMathFastTestsSampleCount; ++index) {
+            sum += CGPointToAngleFast(CGPointMake(1.0 + index % 7, 0.5 * index));
+        }
+        XCTAssert(sum != 0, @"no result");
+    }];
+}
+
+@end
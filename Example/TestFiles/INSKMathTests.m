@@ -144,7 +144,66 @@
 
 #pragma mark - CGPoint calculations
 
-// any tests needed for wrapping methods?
+- (void)test_pointArithmetic_returnsCorrectPoints {
+    CGPoint point1 = CGPointMake(3.0, -4.0);
+    CGPoint point2 = CGPointMake(0.5, 2.0);
+    CGPoint result = CGPointAdd(point1, point2);
+    XCTAssert(result.x == 3.5 && result.y == -2.0, @"addition is not correct");
+    result = CGPointSubtract(point1, point2);
+    XCTAssert(result.x == 2.5 && result.y == -6.0, @"subtraction is not correct");
+    result = CGPointMultiply(point1, point2);
+    XCTAssert(result.x == 1.5 && result.y == -8.0, @"multiplication is not correct");
+    result = CGPointMultiplyScalar(point1, 2.0);
+    XCTAssert(result.x == 6.0 && result.y == -8.0, @"scalar multiplication is not correct");
+    result = CGPointDivide(point1, point2);
+    XCTAssert(result.x == 6.0 && result.y == -2.0, @"division is not correct");
+    result = CGPointDivideScalar(point1, 2.0);
+    XCTAssert(result.x == 1.5 && result.y == -2.0, @"scalar division is not correct");
+    result = CGPointOffset(point1, 1.0, 1.0);
+    XCTAssert(result.x == 4.0 && result.y == -3.0, @"offset is not correct");
+    result = CGPointNegate(point1);
+    XCTAssert(result.x == -3.0 && result.y == 4.0, @"negation is not correct");
+}
+
+- (void)test_pointLengths_returnCorrectValues {
+    CGPoint point = CGPointMake(3.0, -4.0);
+    XCTAssertEqualWithAccuracy(CGPointLength(point), 5.0, INSK_EPSILON, @"length is not correct");
+    XCTAssertEqualWithAccuracy(CGPointLengthSq(point), 25.0, INSK_EPSILON, @"squared length is not correct");
+    XCTAssertEqualWithAccuracy(CGPointDistance(point, CGPointMake(0.0, 0.0)), 5.0, INSK_EPSILON, @"distance is not correct");
+    XCTAssertEqualWithAccuracy(CGPointDistanceSq(point, CGPointMake(3.0, 0.0)), 16.0, INSK_EPSILON, @"squared distance is not correct");
+    CGPoint normalized = CGPointNormalize(point);
+    XCTAssertEqualWithAccuracy(normalized.x, 0.6, INSK_EPSILON, @"normalization is not correct");
+    XCTAssertEqualWithAccuracy(normalized.y, -0.8, INSK_EPSILON, @"normalization is not correct");
+}
+
+- (void)test_pointProducts_returnCorrectValues {
+    CGPoint point1 = CGPointMake(2.0, 3.0);
+    CGPoint point2 = CGPointMake(4.0, -1.0);
+    XCTAssert(CGPointDotProduct(point1, point2) == 5.0, @"dot product is not correct");
+    XCTAssert(CGPointCrossProduct(point1, point2) == -14.0, @"cross product is not correct");
+    CGPoint projection = CGPointProject(point1, CGPointMake(2.0, 0.0));
+    XCTAssert(projection.x == 2.0 && projection.y == 0.0, @"projection is not correct");
+    CGPoint lerp = CGPointLerp(point1, point2, 0.25);
+    XCTAssert(lerp.x == 2.5 && lerp.y == 2.0, @"interpolation is not correct");
+    CGPoint normalized = CGPointNormalizedInRect(CGPointMake(15.0, 30.0), CGRectMake(10.0, 20.0, 10.0, 40.0));
+    XCTAssert(normalized.x == 0.5 && normalized.y == 0.25, @"normalization in rect is not correct");
+    normalized = CGPointNormalizedInSize(CGPointMake(5.0, 10.0), CGSizeMake(10.0, 40.0));
+    XCTAssert(normalized.x == 0.5 && normalized.y == 0.25, @"normalization in size is not correct");
+}
+
+- (void)test_pointCalculations_keepCGFloatPrecision {
+    // A float only has 24 bits of mantissa, so these values would be rounded when calculating with floats.
+    CGPoint point = CGPointMake(16777216.0, 0.1);
+    CGPoint result = CGPointAdd(point, CGPointMake(1.0, 0.2));
+#if CGFLOAT_IS_DOUBLE
+    XCTAssert(result.x == 16777217.0, @"precision is lost");
+    XCTAssert(result.y == 0.1 + 0.2, @"precision is lost");
+#endif
+    result = CGPointLerp(point, CGPointMake(16777218.0, 0.1), 0.5);
+#if CGFLOAT_IS_DOUBLE
+    XCTAssert(result.x == 16777217.0, @"precision is lost");
+#endif
+}
 
 
 #pragma mark - CGSize calculations
@@ -437,4 +496,61 @@
 }
 
 
+- (void)test_angleWrapping_withHugeAngles_returnsExactlyWrappedAngles {
+    XCTAssertEqualWithAccuracy(fmod(1000000.0, M_PI_X_2), AngleIn2Pi(1000000.0), 0.000001, @"wrapping not exact");
+    XCTAssertEqualWithAccuracy(fmod(1000000.0, M_PI_X_2) - M_PI_X_2, AngleInPi(1000000.0), 0.000001, @"wrapping not exact");
+    CGFloat angle = AngleIn2Pi(-1.0e15);
+    XCTAssertTrue(angle >= 0.0 && angle < M_PI_X_2, @"wrapping not correct");
+    angle = AngleInPi(1.0e15);
+    XCTAssertTrue(angle >= -M_PI && angle < M_PI, @"wrapping not correct");
+}
+
+- (void)test_shortestAngleBetween_withHugeAngles_returnsTheDifference {
+    XCTAssertEqualWithAccuracy(0.5, ShortestAngleBetween(1000*M_PI_X_2, 1000*M_PI_X_2+0.5), 0.001, @"calculation not correct");
+    XCTAssertEqualWithAccuracy(-0.5, ShortestAngleBetween(-1000*M_PI_X_2+0.5, -1000*M_PI_X_2), 0.001, @"calculation not correct");
+}
+
+
+#pragma mark - affine transformations
+
+- (void)test_affineTransformApply_withComposedTransform_returnsTransformedPoint {
+    // Scaled by 2, then rotated by 90 degrees, then moved by (10, 20).
+    INSKAffineTransform transform = INSKAffineTransformConcat(INSKAffineTransformConcat(INSKAffineTransformMakeScale(2.0, 2.0), INSKAffineTransformMakeRotation(M_PI_2)), INSKAffineTransformMakeTranslation(10.0, 20.0));
+    CGPoint point = CGPointApplyINSKAffineTransform(CGPointMake(1.0, 0.0), transform);
+    XCTAssertEqualWithAccuracy(point.x, 10.0, 0.00001, @"transformation not correct");
+    XCTAssertEqualWithAccuracy(point.y, 22.0, 0.00001, @"transformation not correct");
+}
+
+- (void)test_affineTransformTranslateRotateScale_prependToTransform {
+    INSKAffineTransform transform = INSKAffineTransformScale(INSKAffineTransformRotate(INSKAffineTransformTranslate(INSKAffineTransformMakeIdentity(), 10.0, 20.0), M_PI_2), 2.0, 2.0);
+    // Like CGAffineTransform the last added transformation is applied first: scaled, rotated and then moved.
+    CGPoint point = CGPointApplyINSKAffineTransform(CGPointMake(1.0, 0.0), transform);
+    XCTAssertEqualWithAccuracy(point.x, 10.0, 0.00001, @"transformation not correct");
+    XCTAssertEqualWithAccuracy(point.y, 22.0, 0.00001, @"transformation not correct");
+}
+
+- (void)test_affineTransformInvert_returnsTransformBack {
+    INSKAffineTransform transform = INSKAffineTransformRotate(INSKAffineTransformMakeTranslation(-3.0, 7.0), 0.3);
+    transform = INSKAffineTransformScale(transform, 1.5, -0.5);
+    INSKAffineTransform identity = INSKAffineTransformConcat(transform, INSKAffineTransformInvert(transform));
+    XCTAssertEqualWithAccuracy(identity.a, 1.0, 0.00001, @"inversion not correct");
+    XCTAssertEqualWithAccuracy(identity.b, 0.0, 0.00001, @"inversion not correct");
+    XCTAssertEqualWithAccuracy(identity.c, 0.0, 0.00001, @"inversion not correct");
+    XCTAssertEqualWithAccuracy(identity.d, 1.0, 0.00001, @"inversion not correct");
+    XCTAssertEqualWithAccuracy(identity.tx, 0.0, 0.00001, @"inversion not correct");
+    XCTAssertEqualWithAccuracy(identity.ty, 0.0, 0.00001, @"inversion not correct");
+}
+
+- (void)test_affineTransformInvert_withSingularTransform_returnsSameTransform {
+    INSKAffineTransform transform = INSKAffineTransformMakeScale(0.0, 2.0);
+    INSKAffineTransform inverted = INSKAffineTransformInvert(transform);
+    XCTAssertEqual(inverted.a, transform.a, @"singular transformation changed");
+    XCTAssertEqual(inverted.d, transform.d, @"singular transformation changed");
+}
+
+- (void)test_affineTransformIsIdentity_returnsCorrectValues {
+    XCTAssertTrue(INSKAffineTransformIsIdentity(INSKAffineTransformMakeIdentity()), @"identity not recognized");
+    XCTAssertFalse(INSKAffineTransformIsIdentity(INSKAffineTransformMakeTranslation(1.0, 0.0)), @"translation recognized as identity");
+}
+
 @end
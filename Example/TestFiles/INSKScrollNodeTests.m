@@ -0,0 +1,135 @@
+// INSKScrollNodeTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+@interface INSKScrollNodeTests : XCTestCase <INSKScrollNodeDelegate>
+
+@end
+
+
+@implementation INSKScrollNodeTests {
+    INSKScrollNode *_scrollNode;
+    NSUInteger _scrollCount;
+    NSUInteger _changeCount;
+    INSKScrollNodeVisibleContentChange _change;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    _scrollNode = [INSKScrollNode scrollNodeWithSize:CGSizeMake(100, 100)];
+    _scrollNode.scrollContentSize = CGSizeMake(1000, 1000);
+    _scrollNode.scrollDelegate = self;
+    _scrollCount = 0;
+    _changeCount = 0;
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    _scrollNode = nil;
+    [super tearDown];
+}
+
+
+#pragma mark - INSKScrollNodeDelegate
+
+- (void)scrollNode:(INSKScrollNode *)scrollNode didScrollFromOffset:(CGPoint)fromOffset toOffset:(CGPoint)toOffset velocity:(CGPoint)velocity {
+    _scrollCount++;
+}
+
+- (void)scrollNode:(INSKScrollNode *)scrollNode didChangeVisibleContentRect:(INSKScrollNodeVisibleContentChange)change {
+    _change = change;
+    _changeCount++;
+}
+
+
+#pragma mark - helpers
+
+- (CGFloat)areaOfRects:(const CGRect *)rects count:(NSUInteger)count {
+    CGFloat area = 0;
+    for (NSUInteger index = 0; index < count; ++index) {
+        area += rects[index].size.width * rects[index].size.height;
+    }
+    return area;
+}
+
+
+#pragma mark - coalesced notifications
+
+- (void)test_coalescedNotifications_areDeliveredOnce {
+    _scrollNode.coalescesScrollNotifications = YES;
+    _scrollNode.scrollContentPosition = CGPointMake(-10, 5);
+    _scrollNode.scrollContentPosition = CGPointMake(-20, 10);
+    _scrollNode.scrollContentPosition = CGPointMake(-30, 20);
+    XCTAssertEqual(_changeCount, 0, @"notified before the delivery");
+
+    [_scrollNode deliverScrollNotifications];
+    XCTAssertEqual(_changeCount, 1, @"not notified exactly once");
+    XCTAssertTrue(CGRectEqualToRect(_change.previousRect, CGRectMake(0, -100, 100, 100)), @"wrong previous rect");
+    XCTAssertTrue(CGRectEqualToRect(_change.currentRect, CGRectMake(30, -120, 100, 100)), @"wrong current rect");
+
+    [_scrollNode deliverScrollNotifications];
+    XCTAssertEqual(_changeCount, 1, @"notified again without a change");
+}
+
+- (void)test_coalescedNotifications_containEnteredAndExitedRegions {
+    _scrollNode.coalescesScrollNotifications = YES;
+    _scrollNode.scrollContentPosition = CGPointMake(-30, 20);
+    [_scrollNode deliverScrollNotifications];
+
+    XCTAssertEqual(_change.enteredCount, 2, @"wrong number of entered rects");
+    XCTAssertEqual(_change.exitedCount, 2, @"wrong number of exited rects");
+    // The rects don't overlap, so their areas add up to the area of the difference.
+    XCTAssertEqualWithAccuracy([self areaOfRects:_change.enteredRects count:_change.enteredCount], 100 * 20 + 30 * 80, 0.001, @"wrong entered area");
+    XCTAssertEqualWithAccuracy([self areaOfRects:_change.exitedRects count:_change.exitedCount], 100 * 20 + 30 * 80, 0.001, @"wrong exited area");
+    for (NSUInteger index = 0; index < _change.enteredCount; ++index) {
+        XCTAssertTrue(CGRectContainsRect(_change.currentRect, _change.enteredRects[index]), @"entered rect outside of the current rect");
+        XCTAssertFalse(CGRectIntersectsRect(_change.previousRect, CGRectInset(_change.enteredRects[index], 0.5, 0.5)), @"entered rect was visible before");
+    }
+    for (NSUInteger index = 0; index < _change.exitedCount; ++index) {
+        XCTAssertTrue(CGRectContainsRect(_change.previousRect, _change.exitedRects[index]), @"exited rect outside of the previous rect");
+        XCTAssertFalse(CGRectIntersectsRect(_change.currentRect, CGRectInset(_change.exitedRects[index], 0.5, 0.5)), @"exited rect is still visible");
+    }
+}
+
+- (void)test_coalescedNotifications_areDeliveredWhenTurnedOff {
+    _scrollNode.coalescesScrollNotifications = YES;
+    _scrollNode.scrollContentPosition = CGPointMake(-30, 20);
+    _scrollNode.coalescesScrollNotifications = NO;
+    XCTAssertEqual(_changeCount, 1, @"pending notification not delivered");
+
+    _scrollNode.scrollContentPosition = CGPointMake(-40, 30);
+    [_scrollNode deliverScrollNotifications];
+    XCTAssertEqual(_changeCount, 1, @"notified without coalescing");
+}
+
+- (void)test_uncoalescedNotifications_areNotSentForVisibleRects {
+    _scrollNode.scrollContentPosition = CGPointMake(-30, 20);
+    [_scrollNode deliverScrollNotifications];
+    XCTAssertEqual(_changeCount, 0, @"notified without coalescing");
+    XCTAssertEqual(_scrollCount, 0, @"programmatic scrolling reported as a drag");
+}
+
+@end
@@ -0,0 +1,141 @@
+// INSKScrollPhysicsTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The number of physics stepped by the performance tests.
+static const NSUInteger INSKScrollPhysicsTestsInstanceCount = 1000;
+
+
+@interface INSKScrollPhysicsTests : XCTestCase
+
+@end
+
+
+@implementation INSKScrollPhysicsTests {
+    INSKScrollPhysics _physics;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    INSKScrollPhysicsInit(&_physics);
+    _physics.viewportSize = CGSizeMake(320, 480);
+    INSKScrollPhysicsSetLimits(&_physics, CGPointMake(-1280, 0), CGPointMake(0, 4320));
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+
+#pragma mark - deceleration
+
+- (void)test_deceleration_stopsAtClosedFormPosition {
+    _physics.mode = INSKScrollPhysicsModeDecelerate;
+    _physics.deceleration = 1000;
+    INSKScrollPhysicsSetPosition(&_physics, CGPointMake(0, 1000));
+    INSKScrollPhysicsRelease(&_physics, CGPointMake(0, 1000), 0);
+    INSKScrollPhysicsStep(&_physics, 0.5);
+    XCTAssertEqualWithAccuracy(INSKScrollPhysicsPosition(&_physics).y, 1375, 0.01, @"wrong position during the deceleration");
+    XCTAssertFalse(INSKScrollPhysicsStep(&_physics, 1.0), @"deceleration didn't stop");
+    XCTAssertEqualWithAccuracy(INSKScrollPhysicsPosition(&_physics).y, 1500, 0.01, @"wrong resting position");
+}
+
+- (void)test_deceleration_bouncesAtLimit {
+    _physics.mode = INSKScrollPhysicsModeDecelerate;
+    _physics.bounces = YES;
+    INSKScrollPhysicsSetPosition(&_physics, CGPointMake(0, 4000));
+    INSKScrollPhysicsRelease(&_physics, CGPointMake(0, 5000), 0);
+    CGFloat maximum = 0;
+    for (NSUInteger frame = 1; frame < 600 && INSKScrollPhysicsStep(&_physics, frame / 60.0); ++frame) {
+        maximum = MAX(maximum, INSKScrollPhysicsPosition(&_physics).y);
+    }
+    XCTAssertGreaterThan(maximum, 4320, @"no overshoot");
+    XCTAssertEqual(INSKScrollPhysicsPosition(&_physics).y, 4320, @"didn't return to the limit");
+}
+
+
+#pragma mark - paging
+
+- (void)test_paging_followsDirection {
+    _physics.mode = INSKScrollPhysicsModePagingDirection;
+    _physics.pageSize = CGSizeMake(320, 480);
+    INSKScrollPhysicsSetPosition(&_physics, CGPointMake(-100, 500));
+    INSKScrollPhysicsRelease(&_physics, CGPointMake(-10, -10), 0);
+    INSKScrollPhysicsStep(&_physics, 1.0);
+    XCTAssertEqual(INSKScrollPhysicsPosition(&_physics).x, -320, @"wrong page on the X-axis");
+    XCTAssertEqual(INSKScrollPhysicsPosition(&_physics).y, 480, @"wrong page on the Y-axis");
+}
+
+
+#pragma mark - prediction
+
+- (void)test_restingPosition_predictsPagingTarget {
+    _physics.mode = INSKScrollPhysicsModePagingHalfPage;
+    _physics.pageSize = CGSizeMake(320, 480);
+    INSKScrollPhysicsSetPosition(&_physics, CGPointMake(-500, 1700));
+    INSKScrollPhysicsRelease(&_physics, CGPointMake(0, 100), 0);
+    CGPoint predicted = INSKScrollPhysicsRestingPosition(&_physics);
+    XCTAssertTrue(CGPointEqualToPoint(predicted, CGPointMake(-640, 1920)), @"wrong predicted page");
+    INSKScrollPhysicsStep(&_physics, 1.0);
+    XCTAssertTrue(CGPointEqualToPoint(INSKScrollPhysicsPosition(&_physics), predicted), @"rests elsewhere than predicted");
+}
+
+
+#pragma mark - rubber band
+
+- (void)test_drag_isDampedBeyondLimits {
+    _physics.bounces = YES;
+    INSKScrollPhysicsBeginDrag(&_physics, CGPointZero);
+    INSKScrollPhysicsDrag(&_physics, CGPointMake(0, -10000));
+    CGFloat position = INSKScrollPhysicsPosition(&_physics).y;
+    XCTAssertLessThan(position, 0, @"not dragged beyond the limit");
+    XCTAssertGreaterThan(position, -480, @"dragged further than the viewport");
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_deceleration {
+    INSKScrollPhysics *physics = malloc(sizeof(INSKScrollPhysics) * INSKScrollPhysicsTestsInstanceCount);
+    [self measureBlock:^{
+        for (NSUInteger index = 0; index < INSKScrollPhysicsTestsInstanceCount; ++index) {
+            physics[index] = _physics;
+            physics[index].mode = INSKScrollPhysicsModeDecelerate;
+            physics[index].bounces = YES;
+            INSKScrollPhysicsSetPosition(&physics[index], CGPointMake(0, index));
+            INSKScrollPhysicsRelease(&physics[index], CGPointMake(index, 3000 + index), 0);
+        }
+        for (NSUInteger frame = 1; frame < 120; ++frame) {
+            for (NSUInteger index = 0; index < INSKScrollPhysicsTestsInstanceCount; ++index) {
+                INSKScrollPhysicsStep(&physics[index], frame / 60.0);
+            }
+        }
+    }];
+    free(physics);
+}
+
+@end
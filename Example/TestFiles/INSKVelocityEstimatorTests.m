@@ -0,0 +1,115 @@
+// INSKVelocityEstimatorTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The number of movements added by the performance tests.
+static const NSUInteger INSKVelocityEstimatorTestsMovementCount = 100000;
+
+
+@interface INSKVelocityEstimatorTests : XCTestCase
+
+@end
+
+
+@implementation INSKVelocityEstimatorTests {
+    INSKVelocityEstimator _estimator;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    INSKVelocityEstimatorInit(&_estimator);
+    INSKVelocityEstimatorReset(&_estimator, 1.0);
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [super tearDown];
+}
+
+
+#pragma mark - methods
+
+- (void)test_velocity_isExactForConstantVelocity {
+    INSKVelocityEstimatorMethod methods[] = {INSKVelocityEstimatorMethodAverage, INSKVelocityEstimatorMethodLeastSquares, INSKVelocityEstimatorMethodExponential};
+    for (NSUInteger index = 0; index < sizeof(methods) / sizeof(methods[0]); ++index) {
+        INSKVelocityEstimatorInit(&_estimator);
+        _estimator.method = methods[index];
+        INSKVelocityEstimatorReset(&_estimator, 1.0);
+        INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(5, -10), 1.01);
+        INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(10, -20), 1.03);
+        INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(2.5, -5), 1.035);
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&_estimator, 1.035);
+        XCTAssertEqualWithAccuracy(velocity.x, 500, 0.01, @"wrong velocity for method %d", (int)methods[index]);
+        XCTAssertEqualWithAccuracy(velocity.y, -1000, 0.01, @"wrong velocity for method %d", (int)methods[index]);
+    }
+}
+
+- (void)test_velocity_leastSquaresFollowsSlowingDrag {
+    // The position is 3000 * t - 15000 * t^2, so the velocity is 3000 - 30000 * t.
+    CGFloat lastPosition = 0;
+    for (NSUInteger sample = 1; sample <= 8; ++sample) {
+        CGFloat time = sample / 120.0;
+        CGFloat position = 3000 * time - 15000 * time * time;
+        INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(position - lastPosition, 0), 1.0 + time);
+        lastPosition = position;
+    }
+    CGPoint velocity = INSKVelocityEstimatorVelocity(&_estimator, 1.0 + 8 / 120.0);
+    XCTAssertEqualWithAccuracy(velocity.x, 3000 - 30000 * 8 / 120.0, 0.1, @"wrong velocity");
+}
+
+
+#pragma mark - time handling
+
+- (void)test_addMovement_mergesSameTimestamp {
+    INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(10, 0), 1.01);
+    INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(10, 0), 1.01);
+    XCTAssertEqual(_estimator.count, 2, @"movement without time passing added a sample");
+    XCTAssertEqualWithAccuracy(INSKVelocityEstimatorVelocity(&_estimator, 1.01).x, 2000, 0.01, @"wrong merged velocity");
+}
+
+- (void)test_velocity_isZeroAfterResting {
+    INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(10, 0), 1.01);
+    INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(10, 0), 1.02);
+    CGPoint velocity = INSKVelocityEstimatorVelocity(&_estimator, 1.5);
+    XCTAssertEqual(velocity.x, 0, @"velocity of a rested drag");
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_addMovementAndVelocity {
+    [self measureBlock:^{
+        CGFloat sum = 0;
+        for (NSUInteger index = 0; index < INSKVelocityEstimatorTestsMovementCount; ++index) {
+            double timestamp = 1.0 + (index + 1) / 120.0;
+            INSKVelocityEstimatorAddMovement(&_estimator, CGPointMake(1, 2), timestamp);
+            sum += INSKVelocityEstimatorVelocity(&_estimator, timestamp).y;
+        }
+        XCTAssertGreaterThan(sum, 0, @"no velocity");
+    }];
+}
+
+@end
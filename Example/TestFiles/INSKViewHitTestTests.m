@@ -0,0 +1,263 @@
+// INSKViewHitTestTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The swizzled setter calls Sprite Kit's original implementation, like an action or the physics simulation do without being tracked.
+// Only callable after [SKNode startSceneGraphTracking] has swizzled it.
+@interface SKNode (INSKViewHitTestTestsUntrackedSetter)
+
+- (void)insk_setPosition:(CGPoint)position;
+
+@end
+
+
+@interface INSKViewHitTestTests : XCTestCase
+
+@end
+
+
+@implementation INSKViewHitTestTests {
+    INSKView *_view;
+    SKScene *_scene;
+    SKNode *_parent;
+    SKSpriteNode *_sprite;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    [SKNode startSceneGraphTracking];
+    _view = [[INSKView alloc] initWithFrame:CGRectMake(0, 0, 400, 400)];
+    _scene = [SKScene sceneWithSize:CGSizeMake(400, 400)];
+    _scene.anchorPoint = CGPointZero;
+    _parent = [SKNode node];
+    _parent.position = CGPointMake(100, 100);
+    [_scene addChild:_parent];
+    _sprite = [SKSpriteNode spriteNodeWithColor:[SKColor whiteColor] size:CGSizeMake(50, 50)];
+    _sprite.userInteractionEnabled = YES;
+    [_parent addChild:_sprite];
+    [_view presentScene:_scene];
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    [_view removeFromSuperview];
+    _view = nil;
+    _scene = nil;
+    _parent = nil;
+    _sprite = nil;
+    [super tearDown];
+}
+
+
+#pragma mark - untracked changes
+
+- (void)testSceneToNodeTransformIsInvalidatedByMovingAncestor {
+    CGPoint position = CGPointMake(110, 120);
+    CGPoint converted = [_sprite convertPointFromScene:position];
+    XCTAssertEqualWithAccuracy(converted.x, 10, 0.001);
+    XCTAssertEqualWithAccuracy(converted.y, 20, 0.001);
+
+    _parent.position = CGPointMake(300, 300);
+    _parent.zRotation = M_PI_2;
+    _parent.xScale = 2;
+    converted = [_sprite convertPointFromScene:position];
+    CGPoint expected = [_scene convertPoint:position toNode:_sprite];
+    XCTAssertEqualWithAccuracy(converted.x, expected.x, 0.001);
+    XCTAssertEqualWithAccuracy(converted.y, expected.y, 0.001);
+}
+
+- (void)testSceneToNodeTransformNoticesUntrackedMoveOfAncestorAfterTransformsDidChange {
+    CGPoint position = CGPointMake(110, 120);
+    CGPoint converted = [_sprite convertPointFromScene:position];
+    XCTAssertEqualWithAccuracy(converted.x, 10, 0.001);
+    XCTAssertEqualWithAccuracy(converted.y, 20, 0.001);
+
+    [_parent insk_setPosition:CGPointMake(300, 300)];
+    [SKNode sceneToNodeTransformsDidChange];
+    converted = [_sprite convertPointFromScene:position];
+    CGPoint expected = [_scene convertPoint:position toNode:_sprite];
+    XCTAssertEqualWithAccuracy(converted.x, expected.x, 0.001);
+    XCTAssertEqualWithAccuracy(converted.y, expected.y, 0.001);
+    XCTAssertEqualWithAccuracy(converted.x, -190, 0.001);
+}
+
+- (void)testTopInteractingNodeNoticesUntrackedMove {
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(100, 100)], _sprite);
+
+    [_parent insk_setPosition:CGPointMake(300, 300)];
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(300, 300)], _sprite);
+    XCTAssertNil([_view topInteractingNodeAtPosition:CGPointMake(100, 100)]);
+}
+
+- (void)testTopInteractingNodesAtPositionsNoticesUntrackedMove {
+    CGPoint positions[2] = {CGPointMake(100, 100), CGPointMake(300, 300)};
+    NSArray *nodes = [_view topInteractingNodesAtPositions:positions count:2];
+    XCTAssertEqual(nodes[0], _sprite);
+    XCTAssertEqual(nodes[1], [NSNull null]);
+
+    [_sprite insk_setPosition:CGPointMake(200, 200)];
+    nodes = [_view topInteractingNodesAtPositions:positions count:2];
+    XCTAssertEqual(nodes[0], [NSNull null]);
+    XCTAssertEqual(nodes[1], _sprite);
+}
+
+- (void)testHitTestCacheDoesNotReturnMovedNode {
+    _view.hitTestCacheEnabled = YES;
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(100, 100)], _sprite);
+
+    [_parent insk_setPosition:CGPointMake(300, 300)];
+    XCTAssertNil([_view topInteractingNodeAtPosition:CGPointMake(100, 100)]);
+}
+
+- (void)testHitTestCacheDoesNotReturnRemovedNode {
+    _view.hitTestCacheEnabled = YES;
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(100, 100)], _sprite);
+
+    [_scene removeAllChildren];
+    XCTAssertNil([_view topInteractingNodeAtPosition:CGPointMake(100, 100)]);
+}
+
+- (void)testHitTestCacheIsDroppedForNewScene {
+    _view.hitTestCacheEnabled = YES;
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(100, 100)], _sprite);
+
+    [_view presentScene:[SKScene sceneWithSize:CGSizeMake(400, 400)]];
+    XCTAssertNil([_view topInteractingNodeAtPosition:CGPointMake(100, 100)]);
+}
+
+
+#pragma mark - batch
+
+// Adds overlapping nodes of all kinds the touch delivery has to order.
+- (void)addOverlappingNodes {
+    SKSpriteNode *above = [SKSpriteNode spriteNodeWithColor:[SKColor redColor] size:CGSizeMake(40, 40)];
+    above.position = CGPointMake(110, 110);
+    above.zPosition = 1;
+    above.userInteractionEnabled = YES;
+    [_scene addChild:above];
+
+    SKSpriteNode *prioritized = [SKSpriteNode spriteNodeWithColor:[SKColor greenColor] size:CGSizeMake(30, 30)];
+    prioritized.position = CGPointMake(-15, -15);
+    prioritized.touchPriority = 1;
+    prioritized.userInteractionEnabled = YES;
+    [_parent insertChild:prioritized atIndex:0];
+
+    SKNode *rotated = [SKNode node];
+    rotated.position = CGPointMake(120, 90);
+    rotated.zRotation = M_PI_4;
+    [_scene addChild:rotated];
+    SKSpriteNode *rotatedSprite = [SKSpriteNode spriteNodeWithColor:[SKColor blueColor] size:CGSizeMake(60, 20)];
+    rotatedSprite.userInteractionEnabled = YES;
+    [rotated addChild:rotatedSprite];
+
+    SKSpriteNode *notInteracting = [SKSpriteNode spriteNodeWithColor:[SKColor grayColor] size:CGSizeMake(40, 40)];
+    notInteracting.position = CGPointMake(130, 130);
+    notInteracting.zPosition = 5;
+    [_scene addChild:notInteracting];
+
+    SKSpriteNode *hidden = [SKSpriteNode spriteNodeWithColor:[SKColor yellowColor] size:CGSizeMake(40, 40)];
+    hidden.position = CGPointMake(90, 120);
+    hidden.zPosition = 5;
+    hidden.hidden = YES;
+    hidden.userInteractionEnabled = YES;
+    [_scene addChild:hidden];
+
+    SKNode *container = [SKNode node];
+    container.position = CGPointMake(80, 80);
+    container.userInteractionEnabled = YES;
+    [_scene addChild:container];
+    SKSpriteNode *child = [SKSpriteNode spriteNodeWithColor:[SKColor whiteColor] size:CGSizeMake(20, 20)];
+    [container addChild:child];
+}
+
+// Compares topInteractingNodesAtPositions:count: with topInteractingNodeAtPosition: for each position of a grid over the overlapping nodes.
+- (void)assertBatchMatchesSinglePositions {
+    // More than 64 positions, so several chunks are resolved.
+    NSUInteger const gridSize = 21;
+    NSUInteger const count = gridSize * gridSize;
+    CGPoint positions[count];
+    for (NSUInteger index = 0; index < count; ++index) {
+        positions[index] = CGPointMake(55 + 5 * (index % gridSize), 55 + 5 * (index / gridSize));
+    }
+
+    NSArray *nodes = [_view topInteractingNodesAtPositions:positions count:count];
+    XCTAssertEqual(nodes.count, count);
+    for (NSUInteger index = 0; index < count; ++index) {
+        id expected = [_view topInteractingNodeAtPosition:positions[index]];
+        if (expected == nil) {
+            expected = [NSNull null];
+        }
+        XCTAssertEqual(nodes[index], expected, @"at (%f, %f)", positions[index].x, positions[index].y);
+    }
+}
+
+- (void)testTopInteractingNodesAtPositionsMatchesSinglePositionsForOverlappingNodes {
+    [self addOverlappingNodes];
+    [self assertBatchMatchesSinglePositions];
+}
+
+- (void)testTopInteractingNodesAtPositionsMatchesSinglePositionsForOverlappingNodesWithIndex {
+    _view.hitTestIndexEnabled = YES;
+    [self addOverlappingNodes];
+    [self assertBatchMatchesSinglePositions];
+}
+
+
+#pragma mark - actions
+
+- (void)testTopInteractingNodeFindsNodeMovedByAction {
+    // The view has to be on screen so the scene runs its actions.
+#if TARGET_OS_IPHONE
+    UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 400, 400)];
+    [window addSubview:_view];
+    window.hidden = NO;
+#else
+    NSWindow *window = [[NSWindow alloc] initWithContentRect:NSMakeRect(0, 0, 400, 400) styleMask:NSBorderlessWindowMask backing:NSBackingStoreBuffered defer:NO];
+    window.releasedWhenClosed = NO;
+    [window.contentView addSubview:_view];
+    [window orderFront:nil];
+#endif
+
+    // Cache the transformation at the old position.
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(100, 100)], _sprite);
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"moved"];
+    [_parent runAction:[SKAction sequence:@[[SKAction moveTo:CGPointMake(300, 300) duration:0], [SKAction runBlock:^{
+        [expectation fulfill];
+    }]]]];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    XCTAssertEqual([_view topInteractingNodeAtPosition:CGPointMake(300, 300)], _sprite);
+    XCTAssertNil([_view topInteractingNodeAtPosition:CGPointMake(100, 100)]);
+
+#if TARGET_OS_IPHONE
+    window.hidden = YES;
+#else
+    [window close];
+#endif
+}
+
+@end
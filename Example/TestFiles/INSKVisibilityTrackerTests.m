@@ -0,0 +1,198 @@
+// INSKVisibilityTrackerTests.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <XCTest/XCTest.h>
+
+
+// The number of rows of the list, Tools/INSKVisibilityTrackerTests.c compares random layouts with a brute force scan.
+static const NSUInteger INSKVisibilityTrackerTestsRowCount = 10000;
+static const CGFloat INSKVisibilityTrackerTestsRowHeight = 44;
+
+
+// A data source with rows of alternating types counting the created nodes.
+@interface INSKVisibilityTrackerTestsDataSource : NSObject <INSKScrollNodeDataSource>
+
+@property (nonatomic, assign) NSUInteger numberOfCreatedNodes;
+@property (nonatomic, strong) NSMutableIndexSet *prefetchedIndexes;
+
+@end
+
+
+@implementation INSKVisibilityTrackerTestsDataSource
+
+- (NSUInteger)numberOfItemsInScrollNode:(INSKScrollNode *)scrollNode {
+    return INSKVisibilityTrackerTestsRowCount;
+}
+
+- (CGRect)scrollNode:(INSKScrollNode *)scrollNode frameOfItemAtIndex:(NSUInteger)index {
+    return CGRectMake(0, -(index + 1.0) * INSKVisibilityTrackerTestsRowHeight, 320, INSKVisibilityTrackerTestsRowHeight);
+}
+
+- (NSString *)scrollNode:(INSKScrollNode *)scrollNode reuseIdentifierForItemAtIndex:(NSUInteger)index {
+    return (index % 2 == 0) ? @"even" : @"odd";
+}
+
+- (SKNode *)scrollNode:(INSKScrollNode *)scrollNode nodeForItemAtIndex:(NSUInteger)index reusableNode:(SKNode *)reusableNode {
+    SKNode *node = reusableNode;
+    if (node == nil) {
+        node = [SKNode node];
+        self.numberOfCreatedNodes++;
+    }
+    node.name = (index % 2 == 0) ? @"even" : @"odd";
+    return node;
+}
+
+- (void)scrollNode:(INSKScrollNode *)scrollNode prefetchItemsAtIndexes:(NSIndexSet *)indexes {
+    if (self.prefetchedIndexes == nil) {
+        self.prefetchedIndexes = [NSMutableIndexSet indexSet];
+    }
+    [self.prefetchedIndexes addIndexes:indexes];
+}
+
+@end
+
+
+@interface INSKVisibilityTrackerTests : XCTestCase
+
+@end
+
+
+@implementation INSKVisibilityTrackerTests {
+    INSKSpatialBounds *_rows;
+}
+
+- (void)setUp {
+    [super setUp];
+    // Put setup code here. This method is called before the invocation of each test method in the class.
+    _rows = malloc(sizeof(INSKSpatialBounds) * INSKVisibilityTrackerTestsRowCount);
+    for (NSUInteger index = 0; index < INSKVisibilityTrackerTestsRowCount; ++index) {
+        _rows[index] = (INSKSpatialBounds){0, -(index + 1.0) * INSKVisibilityTrackerTestsRowHeight, 320, -(double)index * INSKVisibilityTrackerTestsRowHeight};
+    }
+}
+
+- (void)tearDown {
+    // Put teardown code here. This method is called after the invocation of each test method in the class.
+    free(_rows);
+    [super tearDown];
+}
+
+
+#pragma mark - tracker
+
+- (void)test_tracker_reportsEnteringAndLeavingRows {
+    INSKVisibilityTracker *tracker = INSKVisibilityTrackerCreate();
+    XCTAssertTrue(INSKVisibilityTrackerSetItems(tracker, _rows, INSKVisibilityTrackerTestsRowCount), @"setting the rows failed");
+
+    INSKVisibilityTrackerUpdate(tracker, (INSKSpatialBounds){0, -439, 320, -1});
+    size_t count;
+    INSKVisibilityTrackerEntered(tracker, &count);
+    XCTAssertEqual(count, 10, @"wrong number of rows entered");
+    XCTAssertTrue(INSKVisibilityTrackerIsVisible(tracker, 9), @"last row not visible");
+    XCTAssertFalse(INSKVisibilityTrackerIsVisible(tracker, 10), @"row below visible");
+
+    INSKVisibilityTrackerUpdate(tracker, (INSKSpatialBounds){0, -527, 320, -89});
+    INSKVisibilityTrackerEntered(tracker, &count);
+    XCTAssertEqual(count, 2, @"wrong number of rows entered");
+    INSKVisibilityTrackerExited(tracker, &count);
+    XCTAssertEqual(count, 2, @"wrong number of rows exited");
+    XCTAssertFalse(INSKVisibilityTrackerIsVisible(tracker, 1), @"scrolled out row still visible");
+
+    INSKVisibilityTrackerDestroy(tracker);
+}
+
+static void INSKVisibilityTrackerTestsCountItem(size_t item, void *context) {
+    (*(size_t *)context)++;
+}
+
+- (void)test_tracker_queryKeepsVisibleRows {
+    INSKVisibilityTracker *tracker = INSKVisibilityTrackerCreate();
+    INSKVisibilityTrackerSetItems(tracker, _rows, INSKVisibilityTrackerTestsRowCount);
+    INSKVisibilityTrackerUpdate(tracker, (INSKSpatialBounds){0, -439, 320, -1});
+
+    size_t visited = 0;
+    size_t count = INSKVisibilityTrackerQuery(tracker, (INSKSpatialBounds){0, -4839, 320, -4401}, INSKVisibilityTrackerTestsCountItem, &visited);
+    XCTAssertEqual(count, 10, @"wrong number of rows found");
+    XCTAssertEqual(visited, 10, @"wrong number of rows visited");
+    XCTAssertTrue(INSKVisibilityTrackerIsVisible(tracker, 0), @"query changed the visible rows");
+    XCTAssertFalse(INSKVisibilityTrackerIsVisible(tracker, 105), @"query changed the visible rows");
+
+    INSKVisibilityTrackerDestroy(tracker);
+}
+
+
+#pragma mark - scroll node
+
+- (void)test_scrollNode_recyclesNodesOfLeavingRows {
+    INSKVisibilityTrackerTestsDataSource *dataSource = [[INSKVisibilityTrackerTestsDataSource alloc] init];
+    INSKScrollNode *scrollNode = [INSKScrollNode scrollNodeWithSize:CGSizeMake(320, 440)];
+    scrollNode.scrollContentSize = CGSizeMake(320, INSKVisibilityTrackerTestsRowCount * INSKVisibilityTrackerTestsRowHeight);
+    scrollNode.virtualizationMargin = 0;
+    scrollNode.dataSource = dataSource;
+
+    XCTAssertEqual(scrollNode.scrollContentNode.children.count, 11, @"wrong number of materialized rows");
+    XCTAssertNotNil([scrollNode nodeForItemAtIndex:0], @"first row not materialized");
+    XCTAssertNil([scrollNode nodeForItemAtIndex:11], @"invisible row materialized");
+
+    // Scroll through the whole list, the nodes of the first screen are enough.
+    for (CGFloat y = 0; y < scrollNode.scrollContentSize.height; y += 30) {
+        scrollNode.scrollContentPosition = CGPointMake(0, y);
+    }
+    XCTAssertLessThanOrEqual(dataSource.numberOfCreatedNodes, 14, @"nodes not reused");
+    XCTAssertNotNil([scrollNode nodeForItemAtIndex:INSKVisibilityTrackerTestsRowCount - 1], @"last row not materialized");
+    XCTAssertEqualObjects([scrollNode nodeForItemAtIndex:INSKVisibilityTrackerTestsRowCount - 1].name, @"odd", @"node reused for the wrong type");
+
+    scrollNode.dataSource = nil;
+    XCTAssertEqual(scrollNode.scrollContentNode.children.count, 0, @"rows not removed");
+}
+
+- (void)test_scrollNode_prefetchesRowsAtPredictedPosition {
+    INSKVisibilityTrackerTestsDataSource *dataSource = [[INSKVisibilityTrackerTestsDataSource alloc] init];
+    INSKScrollNode *scrollNode = [INSKScrollNode scrollNodeWithSize:CGSizeMake(320, 440)];
+    scrollNode.scrollContentSize = CGSizeMake(320, INSKVisibilityTrackerTestsRowCount * INSKVisibilityTrackerTestsRowHeight);
+    scrollNode.virtualizationMargin = 0;
+    scrollNode.dataSource = dataSource;
+
+    [scrollNode setScrollContentPosition:CGPointMake(0, 4400) animationDuration:1];
+    XCTAssertTrue(CGPointEqualToPoint(scrollNode.predictedScrollContentPosition, CGPointMake(0, 4400)), @"wrong predicted position");
+    XCTAssertTrue(CGRectEqualToRect(scrollNode.predictedVisibleContentRect, CGRectMake(0, -4840, 320, 440)), @"wrong predicted visible rect");
+    XCTAssertTrue([dataSource.prefetchedIndexes containsIndexesInRange:NSMakeRange(100, 10)], @"rows at the predicted position not prefetched");
+    XCTAssertFalse([dataSource.prefetchedIndexes containsIndex:0], @"visible row prefetched");
+    XCTAssertNil([scrollNode nodeForItemAtIndex:100], @"prefetched row materialized before arrival");
+}
+
+
+#pragma mark - performance
+
+- (void)test_performance_scrollNode_scrolling {
+    INSKVisibilityTrackerTestsDataSource *dataSource = [[INSKVisibilityTrackerTestsDataSource alloc] init];
+    INSKScrollNode *scrollNode = [INSKScrollNode scrollNodeWithSize:CGSizeMake(320, 568)];
+    scrollNode.scrollContentSize = CGSizeMake(320, INSKVisibilityTrackerTestsRowCount * INSKVisibilityTrackerTestsRowHeight);
+    scrollNode.dataSource = dataSource;
+    [self measureBlock:^{
+        for (CGFloat y = 0; y < scrollNode.scrollContentSize.height; y += 25) {
+            scrollNode.scrollContentPosition = CGPointMake(0, y);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,88 @@
+// INSKAlphaBitmask.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKAlphaBitmask.h"
+#include <stdlib.h>
+
+
+#pragma mark - public functions
+
+INSKAlphaBitmask *INSKAlphaBitmaskCreate(const uint8_t *alpha, size_t width, size_t height, ptrdiff_t bytesPerRow, size_t bytesPerPixel, uint8_t threshold, unsigned int downsampling) {
+    if (downsampling == 0) {
+        downsampling = 1;
+    }
+    INSKAlphaBitmask *mask = malloc(sizeof(INSKAlphaBitmask));
+    if (mask == NULL) {
+        return NULL;
+    }
+    mask->width = (width + downsampling - 1) / downsampling;
+    mask->height = (height + downsampling - 1) / downsampling;
+    mask->wordsPerRow = (mask->width + 63) / 64;
+    mask->downsampling = downsampling;
+    size_t wordCount = mask->wordsPerRow * mask->height;
+    mask->bits = calloc(wordCount > 0 ? wordCount : 1, sizeof(uint64_t));
+    if (mask->bits == NULL) {
+        free(mask);
+        return NULL;
+    }
+
+    for (size_t y = 0; y < height; ++y) {
+        const uint8_t *row = alpha + (ptrdiff_t)y * bytesPerRow;
+        uint64_t *maskRow = mask->bits + (y / downsampling) * mask->wordsPerRow;
+        for (size_t x = 0; x < width; ++x) {
+            if (row[x * bytesPerPixel] > threshold) {
+                size_t column = x / downsampling;
+                maskRow[column >> 6] |= (uint64_t)1 << (column & 63);
+            }
+        }
+    }
+    return mask;
+}
+
+void INSKAlphaBitmaskDestroy(INSKAlphaBitmask *mask) {
+    if (mask == NULL) {
+        return;
+    }
+    free(mask->bits);
+    free(mask);
+}
+
+size_t INSKAlphaBitmaskMemorySize(const INSKAlphaBitmask *mask) {
+    return sizeof(INSKAlphaBitmask) + mask->wordsPerRow * mask->height * sizeof(uint64_t);
+}
+
+bool INSKAlphaBitmaskTestNormalized(const INSKAlphaBitmask *mask, double u, double v) {
+    if (!(u >= 0.0 && u <= 1.0 && v >= 0.0 && v <= 1.0) || mask->width == 0 || mask->height == 0) {
+        return false;
+    }
+    // The right and bottom edges belong to the last texel.
+    size_t x = (size_t)(u * (double)mask->width);
+    size_t y = (size_t)(v * (double)mask->height);
+    if (x >= mask->width) {
+        x = mask->width - 1;
+    }
+    if (y >= mask->height) {
+        y = mask->height - 1;
+    }
+    return INSKAlphaBitmaskTest(mask, x, y);
+}
@@ -0,0 +1,119 @@
+// INSKAlphaBitmask.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_ALPHA_BITMASK_H
+#define INSK_ALPHA_BITMASK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ A bit per texel which tells whether the texel of an image is opaque.
+
+ The mask is built once from the alpha values of an image, afterwards a lookup is a single shift and mask, so it is cheap enough for every touch.
+ Each row starts at a new 64 bit word, bit x % 64 of word x / 64 belongs to column x.
+ Row 0 is the first row passed to INSKAlphaBitmaskCreate(), INSKAlphaMask passes the bottom row first like SpriteKit's coordinate system.
+ */
+typedef struct {
+    /// The number of columns of the mask.
+    size_t width;
+    /// The number of rows of the mask.
+    size_t height;
+    /// The number of 64 bit words per row.
+    size_t wordsPerRow;
+    /// The number of image pixels in each direction which are combined into a single bit.
+    unsigned int downsampling;
+    /// The bits, wordsPerRow * height words.
+    uint64_t *bits;
+} INSKAlphaBitmask;
+
+
+/**
+ Creates a mask from the alpha values of an image.
+
+ A bit is set if any of the downsampling x downsampling pixels it covers has an alpha value higher than the threshold.
+ This keeps thin opaque parts touchable when downsampling.
+
+ @param alpha Points to the alpha value of the first pixel of the first row.
+ @param width The width of the image in pixels.
+ @param height The height of the image in pixels.
+ @param bytesPerRow The distance from one row of the image to the next one in bytes, negative for going backwards, i.e. to start with the last row of a buffer.
+ @param bytesPerPixel The distance from one pixel of a row to the next one in bytes, i.e. 4 for RGBA images and 1 for alpha only images.
+ @param threshold The alpha value a pixel has to exceed to be opaque.
+ @param downsampling The number of pixels in each direction combined into a single bit, 0 is treated as 1.
+ @return The new mask or NULL if the memory couldn't be allocated.
+ */
+INSKAlphaBitmask *INSKAlphaBitmaskCreate(const uint8_t *alpha, size_t width, size_t height, ptrdiff_t bytesPerRow, size_t bytesPerPixel, uint8_t threshold, unsigned int downsampling);
+
+/**
+ Frees a mask.
+
+ @param mask The mask to free, may be NULL.
+ */
+void INSKAlphaBitmaskDestroy(INSKAlphaBitmask *mask);
+
+/**
+ Returns the number of bytes used by a mask including the struct itself.
+
+ @param mask The mask.
+ @return The memory size in bytes.
+ */
+size_t INSKAlphaBitmaskMemorySize(const INSKAlphaBitmask *mask);
+
+/**
+ Returns whether a bit of the mask is set.
+
+ @param mask The mask.
+ @param x The column, has to be less than the mask's width.
+ @param y The row, has to be less than the mask's height.
+ @return True if the texel is opaque.
+ */
+static inline bool INSKAlphaBitmaskTest(const INSKAlphaBitmask *mask, size_t x, size_t y) {
+    return (mask->bits[y * mask->wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+}
+
+/**
+ Returns whether the texel at a normalized position of the image is opaque.
+
+ Positions outside of the range [0, 1] are never opaque.
+
+ @param mask The mask.
+ @param u The horizontal position, 0 is the left and 1 the right edge.
+ @param v The vertical position, 0 is the first and 1 the last row.
+ @return True if the texel is opaque.
+ */
+bool INSKAlphaBitmaskTestNormalized(const INSKAlphaBitmask *mask, double u, double v);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
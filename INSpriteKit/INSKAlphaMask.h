@@ -0,0 +1,111 @@
+// INSKAlphaMask.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import <SpriteKit/SpriteKit.h>
+#import "INSKAlphaBitmask.h"
+
+
+/**
+ An immutable 1 bit per texel alpha mask of an image for pixel accurate hit tests.
+
+ The mask is created once from the image's alpha values and can be shared by all sprites showing the same image, see SKSpriteNode's alphaMask property.
+ Masks created with alphaMaskWithImageNamed: are cached by name and downsampling as long as they are in use, so asking for the same image again returns the same mask.
+ 
+ SKTexture doesn't give access to its pixels, so the mask has to be created from the image the texture is made of.
+ */
+@interface INSKAlphaMask : NSObject
+
+
+/**
+ The number of texels of the mask in each direction, which is the image's size in pixels divided by the downsampling.
+ */
+@property (nonatomic, assign, readonly) CGSize size;
+
+/**
+ The number of image pixels in each direction which are combined into a single bit.
+ */
+@property (nonatomic, assign, readonly) NSUInteger downsampling;
+
+/**
+ The number of bytes used by the mask.
+ */
+@property (nonatomic, assign, readonly) NSUInteger memorySize;
+
+/**
+ The underlying C mask for fast lookups without message sends.
+ */
+@property (nonatomic, assign, readonly) const INSKAlphaBitmask *bitmask;
+
+
+/**
+ Returns the shared mask of an image without downsampling.
+
+ @param name The name of the image like for imageNamed:.
+ @return The shared mask or nil if there is no such image.
+ @see alphaMaskWithImageNamed:downsampling:
+ */
++ (instancetype)alphaMaskWithImageNamed:(NSString *)name;
+
+/**
+ Returns the shared mask of an image.
+
+ The mask is created on the first call and kept in a cache as long as someone holds a reference to it.
+ A texel is opaque if any of its pixels has an alpha value of more than 0.5.
+
+ @param name The name of the image like for imageNamed:.
+ @param downsampling The number of pixels in each direction combined into a single bit, i.e. 2 needs a quarter of the memory. 0 is treated as 1.
+ @return The shared mask or nil if there is no such image.
+ */
++ (instancetype)alphaMaskWithImageNamed:(NSString *)name downsampling:(NSUInteger)downsampling;
+
+/**
+ Initializes a new mask with an image.
+
+ The mask is not added to the cache of alphaMaskWithImageNamed:downsampling:.
+
+ @param image The image.
+ @param downsampling The number of pixels in each direction combined into a single bit. 0 is treated as 1.
+ @param alphaThreshold The alpha value between 0 and 1 a pixel has to exceed to be opaque.
+ @return A new initialized mask or nil if the image couldn't be read.
+ */
+- (instancetype)initWithCGImage:(CGImageRef)image downsampling:(NSUInteger)downsampling alphaThreshold:(CGFloat)alphaThreshold;
+
+
+/**
+ Returns whether the image is opaque at a normalized position.
+
+ @param point The position in the image, (0, 0) is the bottom left and (1, 1) the top right corner like for anchor points.
+ @return YES if the texel at the position is opaque, NO if it is transparent or the position is outside of the image.
+ */
+- (BOOL)isOpaqueAtNormalizedPoint:(CGPoint)point;
+
+
+/**
+ Returns the number of bytes used by all masks currently alive.
+
+ @return The memory size in bytes.
+ */
++ (NSUInteger)totalMemorySize;
+
+
+@end
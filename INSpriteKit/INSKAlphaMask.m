@@ -0,0 +1,124 @@
+// INSKAlphaMask.m
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#import "INSKAlphaMask.h"
+#import "INSKOSBridge.h"
+
+
+// The bytes used by all masks alive.
+static NSUInteger INSKAlphaMaskTotalMemorySize = 0;
+
+
+@interface INSKAlphaMask ()
+
+@property (nonatomic, assign, readwrite) INSKAlphaBitmask *mutableBitmask;
+
+@end
+
+
+@implementation INSKAlphaMask
+
++ (NSMapTable *)insk_sharedMasks {
+    static NSMapTable *sharedMasks = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedMasks = [NSMapTable strongToWeakObjectsMapTable];
+    });
+    return sharedMasks;
+}
+
++ (instancetype)alphaMaskWithImageNamed:(NSString *)name {
+    return [self alphaMaskWithImageNamed:name downsampling:1];
+}
+
++ (instancetype)alphaMaskWithImageNamed:(NSString *)name downsampling:(NSUInteger)downsampling {
+    if (downsampling == 0) {
+        downsampling = 1;
+    }
+    NSMapTable *sharedMasks = [self insk_sharedMasks];
+    NSString *key = [NSString stringWithFormat:@"%@@%lu", name, (unsigned long)downsampling];
+    INSKAlphaMask *mask;
+    @synchronized (sharedMasks) {
+        mask = [sharedMasks objectForKey:key];
+        if (mask == nil) {
+            UIImage *image = [UIImage imageNamed:name];
+            if (image == nil) {
+                return nil;
+            }
+            mask = [[self alloc] initWithCGImage:image.CGImage downsampling:downsampling alphaThreshold:0.5];
+            if (mask != nil) {
+                [sharedMasks setObject:mask forKey:key];
+            }
+        }
+    }
+    return mask;
+}
+
+- (instancetype)initWithCGImage:(CGImageRef)image downsampling:(NSUInteger)downsampling alphaThreshold:(CGFloat)alphaThreshold {
+    self = [super init];
+    if (self == nil || image == NULL) return nil;
+
+    // Let Core Graphics convert any image format into plain alpha values.
+    size_t width = CGImageGetWidth(image);
+    size_t height = CGImageGetHeight(image);
+    CGContextRef context = CGBitmapContextCreate(NULL, width, height, 8, width, NULL, (CGBitmapInfo)kCGImageAlphaOnly);
+    if (context == NULL) return nil;
+    CGContextDrawImage(context, CGRectMake(0, 0, width, height), image);
+    const uint8_t *alpha = CGBitmapContextGetData(context);
+    uint8_t threshold = (uint8_t)(MAX(0.0, MIN(1.0, alphaThreshold)) * 255.0);
+    // The rows of the context start with the top of the image, so begin with the last one to have the mask's rows going upwards.
+    ptrdiff_t bytesPerRow = (ptrdiff_t)CGBitmapContextGetBytesPerRow(context);
+    const uint8_t *bottomRow = height > 0 ? alpha + (ptrdiff_t)(height - 1) * bytesPerRow : alpha;
+    self.mutableBitmask = INSKAlphaBitmaskCreate(bottomRow, width, height, -bytesPerRow, 1, threshold, (unsigned int)downsampling);
+    CGContextRelease(context);
+    if (self.mutableBitmask == NULL) return nil;
+
+    _size = CGSizeMake(self.mutableBitmask->width, self.mutableBitmask->height);
+    _downsampling = self.mutableBitmask->downsampling;
+    _memorySize = INSKAlphaBitmaskMemorySize(self.mutableBitmask);
+    __sync_fetch_and_add(&INSKAlphaMaskTotalMemorySize, _memorySize);
+
+    return self;
+}
+
+- (void)dealloc {
+    if (self.mutableBitmask != NULL) {
+        __sync_fetch_and_sub(&INSKAlphaMaskTotalMemorySize, _memorySize);
+        INSKAlphaBitmaskDestroy(self.mutableBitmask);
+    }
+}
+
+- (const INSKAlphaBitmask *)bitmask {
+    return self.mutableBitmask;
+}
+
+- (BOOL)isOpaqueAtNormalizedPoint:(CGPoint)point {
+    return INSKAlphaBitmaskTestNormalized(self.mutableBitmask, point.x, point.y);
+}
+
++ (NSUInteger)totalMemorySize {
+    return __sync_fetch_and_add(&INSKAlphaMaskTotalMemorySize, 0);
+}
+
+
+@end
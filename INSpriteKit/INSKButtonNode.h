@@ -114,7 +114,7 @@
     [self addChild:button];
  
  */
-@interface INSKButtonNode : SKSpriteNode
+@interface INSKButtonNode : SKSpriteNode <INSKCoalescedTouchHandling>
 
 // ------------------------------------------------------------
 #pragma mark - Initializer
@@ -283,6 +283,24 @@
     }
 }
 
+// Highlights the button while a touch is inside and informs the delegate about changes.
+- (void)updateHighlightedStateAfterMove {
+    if (!self.enabled) {
+        return;
+    }
+    BOOL oldHighlightedState = self.highlighted;
+    if (self.numberOfTouchesInside > 0) {
+        self.highlighted = YES;
+    } else {
+        self.highlighted = NO;
+    }
+    if (oldHighlightedState != self.highlighted) {
+        if ([self.inskButtonNodeDelegate respondsToSelector:@selector(buttonNode:touchMoveUpdatesHighlightState:)]) {
+            [self.inskButtonNodeDelegate buttonNode:self touchMoveUpdatesHighlightState:self.highlighted];
+        }
+    }
+}
+
 - (void)informTarget:(id)target withSelector:(SEL)selector {
     // A replacement for performSelector:withObject:
     NSMethodSignature *methodSig = [[target class] instanceMethodSignatureForSelector:selector];
@@ -409,19 +427,7 @@
     }
     
     // Update state
-    if (self.enabled) {
-        BOOL oldHighlightedState = self.highlighted;
-        if (self.numberOfTouchesInside > 0) {
-            self.highlighted = YES;
-        } else {
-            self.highlighted = NO;
-        }
-        if (oldHighlightedState != self.highlighted) {
-            if ([self.inskButtonNodeDelegate respondsToSelector:@selector(buttonNode:touchMoveUpdatesHighlightState:)]) {
-                [self.inskButtonNodeDelegate buttonNode:self touchMoveUpdatesHighlightState:self.highlighted];
-            }
-        }
-    }
+    [self updateHighlightedStateAfterMove];
 }
 
 - (void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event {
@@ -531,19 +537,7 @@
     }
     
     // Update state
-    if (self.enabled) {
-        BOOL oldHighlightedState = self.highlighted;
-        if (self.numberOfTouchesInside > 0) {
-            self.highlighted = YES;
-        } else {
-            self.highlighted = NO;
-        }
-        if (oldHighlightedState != self.highlighted) {
-            if ([self.inskButtonNodeDelegate respondsToSelector:@selector(buttonNode:touchMoveUpdatesHighlightState:)]) {
-                [self.inskButtonNodeDelegate buttonNode:self touchMoveUpdatesHighlightState:self.highlighted];
-            }
-        }
-    }
+    [self updateHighlightedStateAfterMove];
 }
 
 - (void)mouseUp:(NSEvent *)theEvent {
@@ -590,5 +584,33 @@
 #endif // OS X
 
 
+#pragma mark - coalesced touch handling
+
+- (void)touchMovedCoalesced:(id)touch samples:(const INSKTouchSample *)samples count:(NSUInteger)count startLocation:(CGPoint)startLocation {
+    // Only the first and the last location matter for the inside state.
+    CGPoint newTouchPoint = [self convertPointFromScene:samples[count - 1].location];
+#if TARGET_OS_IPHONE
+    CGPoint oldTouchPoint = [self convertPointFromScene:startLocation];
+    BOOL wasInside = [self isPointInside:oldTouchPoint];
+    BOOL isInside = [self isPointInside:newTouchPoint];
+    if (wasInside && !isInside) {
+        self.numberOfTouchesInside--;
+    } else if (!wasInside && isInside) {
+        self.numberOfTouchesInside++;
+    }
+#else
+    self.positionOfLastMouseEvent = newTouchPoint;
+    if ([self isPointInside:self.positionOfLastMouseEvent]) {
+        self.numberOfTouchesInside = 1;
+    } else {
+        self.numberOfTouchesInside = 0;
+    }
+#endif
+    
+    // Update state
+    [self updateHighlightedStateAfterMove];
+}
+
+
 @end
 
@@ -0,0 +1,159 @@
+// INSKFixed.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKFixed.h"
+
+#include <math.h>
+
+
+// The number of CORDIC iterations, the angles are calculated with 28 fraction bits.
+#define INSKFixedCORDICIterations 28
+
+// atan(2^-i) with 28 fraction bits.
+static const int32_t INSKFixedCORDICAngles[INSKFixedCORDICIterations] = {
+    210828714, 124459457, 65760959, 33381290, 16755422, 8385879, 4193963, 2097109, 1048571, 524287, 262144, 131072, 65536, 32768,
+    16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64, 32, 16, 8, 4, 2
+};
+
+// The reciprocal of the CORDIC gain with 30 fraction bits, used as start value so the results have a length of 1.
+static const int32_t INSKFixedCORDICGainReciprocal = 652032874;
+
+// M_PI with 28 fraction bits.
+static const int64_t INSKFixedPiQ28 = 843314857;
+
+// M_PI*2, M_PI and M_PI_2 with 44 fraction bits for reducing angles without accumulating the error of INSKFixedPiX2.
+static const int64_t INSKFixedPiX2Q44 = 110534964875444;
+static const int64_t INSKFixedPiQ44 = 55267482437722;
+static const int64_t INSKFixedPiHalfQ44 = 27633741218861;
+
+
+#pragma mark - private functions
+
+// Returns the square root of an integer up to 2^63 rounded down.
+// The estimate of sqrt() is corrected with integer comparisons, so the result is exact and the same on all platforms.
+static uint64_t INSKFixedSqrt64(uint64_t value) {
+    uint64_t result = (uint64_t)sqrt((double)value);
+    while (result * result > value) {
+        result--;
+    }
+    while ((result + 1) * (result + 1) <= value) {
+        result++;
+    }
+    return result;
+}
+
+
+#pragma mark - public functions
+
+INSKFixed INSKFixedSqrt(INSKFixed value) {
+    if (value <= 0) {
+        return 0;
+    }
+    return (INSKFixed)INSKFixedSqrt64((uint64_t)value << INSKFixedFractionBits);
+}
+
+INSKFixed INSKFixedPointLength(INSKFixedPoint point) {
+    uint64_t lengthSq = (uint64_t)((int64_t)point.x * point.x) + (uint64_t)((int64_t)point.y * point.y);
+    uint64_t length = INSKFixedSqrt64(lengthSq);
+    return length > INT32_MAX ? INT32_MAX : (INSKFixed)length;
+}
+
+INSKFixedPoint INSKFixedPointNormalize(INSKFixedPoint point) {
+    INSKFixed length = INSKFixedPointLength(point);
+    if (length == 0) {
+        return INSKFixedPointMake(0, 0);
+    }
+    return INSKFixedPointMake((INSKFixed)((int64_t)point.x * INSKFixedOne / length), (INSKFixed)((int64_t)point.y * INSKFixedOne / length));
+}
+
+void INSKFixedSinCos(INSKFixed angle, INSKFixed *sine, INSKFixed *cosine) {
+    // Reduce the angle to -M_PI_2 to M_PI_2 with 44 fraction bits, the other half of the circle has the negated values.
+    int64_t reduced = ((int64_t)angle * 268435456) % INSKFixedPiX2Q44;
+    if (reduced >= INSKFixedPiQ44) {
+        reduced -= INSKFixedPiX2Q44;
+    } else if (reduced < -INSKFixedPiQ44) {
+        reduced += INSKFixedPiX2Q44;
+    }
+    bool negate = false;
+    if (reduced > INSKFixedPiHalfQ44) {
+        reduced -= INSKFixedPiQ44;
+        negate = true;
+    } else if (reduced < -INSKFixedPiHalfQ44) {
+        reduced += INSKFixedPiQ44;
+        negate = true;
+    }
+
+    // Rotate the vector (1, 0) by the angle in steps of atan(2^-i).
+    int32_t z = (int32_t)((reduced + 32768) >> 16);
+    int32_t x = INSKFixedCORDICGainReciprocal;
+    int32_t y = 0;
+    // The direction is applied with a sign mask instead of a branch, which the CPU couldn't predict.
+    for (int i = 0; i < INSKFixedCORDICIterations; ++i) {
+        int32_t sign = z >> 31;
+        int32_t dx = ((x >> i) ^ sign) - sign;
+        int32_t dy = ((y >> i) ^ sign) - sign;
+        x -= dy;
+        y += dx;
+        z -= (INSKFixedCORDICAngles[i] ^ sign) - sign;
+    }
+
+    INSKFixed cosineValue = (INSKFixed)((x + 8192) >> 14);
+    INSKFixed sineValue = (INSKFixed)((y + 8192) >> 14);
+    *sine = negate ? -sineValue : sineValue;
+    *cosine = negate ? -cosineValue : cosineValue;
+}
+
+INSKFixed INSKFixedPointToAngle(INSKFixedPoint point) {
+    if (point.x == 0 && point.y == 0) {
+        return 0;
+    }
+    // Mirror vectors pointing to the left to the right side and remember the half turn.
+    int64_t x = point.x;
+    int64_t y = point.y;
+    int64_t z = 0;
+    if (x < 0) {
+        z = y >= 0 ? INSKFixedPiQ28 : -INSKFixedPiQ28;
+        x = -x;
+        y = -y;
+    }
+    // Scale small vectors up so the shifts don't lose precision, first in big steps.
+    while (x < ((int64_t)1 << 32) && y < ((int64_t)1 << 32) && y > -((int64_t)1 << 32)) {
+        x *= 256;
+        y *= 256;
+    }
+    while (x < ((int64_t)1 << 40) && y < ((int64_t)1 << 40) && y > -((int64_t)1 << 40)) {
+        x *= 2;
+        y *= 2;
+    }
+
+    // Rotate the vector onto the x axis in steps of atan(2^-i) and sum up the angles.
+    for (int i = 0; i < INSKFixedCORDICIterations; ++i) {
+        int64_t sign = y >> 63;
+        int64_t dx = ((x >> i) ^ sign) - sign;
+        int64_t dy = ((y >> i) ^ sign) - sign;
+        x += dy;
+        y -= dx;
+        z += (INSKFixedCORDICAngles[i] ^ sign) - sign;
+    }
+    return (INSKFixed)((z + 2048) >> 12);
+}
@@ -0,0 +1,488 @@
+// INSKFixed.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_FIXED_H
+#define INSK_FIXED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "INSKMath.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ------------------------------------------------------------
+#pragma mark - definitions
+// ------------------------------------------------------------
+/// @name definitions
+
+// The functions of this header calculate with Q16.16 fixed-point numbers in integer arithmetic only, so they return bit-identical results
+// on every CPU, compiler and CGFloat size, i.e. for lockstep multiplayer games or for validating replays recorded on another device.
+// Values from -32768 to 32767.99998 can be represented with a precision of 1/65536, an overflow wraps around like integers do.
+// Rounding divisions and shifts assume the two's complement arithmetic right shift of all platforms supported.
+// Tools/INSKFixedTests.c checks the results against a checksum and Tools/INSKMathBenchmark.c compares the throughput with the CGFloat functions,
+// the additions and multiplications are as fast, the CORDIC functions a few times slower than libm.
+
+/**
+ A Q16.16 fixed-point number, the upper 16 bits are the integer part, the lower 16 bits the fraction.
+ */
+typedef int32_t INSKFixed;
+
+/**
+ A point or vector of two Q16.16 fixed-point numbers.
+ */
+typedef struct {
+    INSKFixed x;
+    INSKFixed y;
+} INSKFixedPoint;
+
+/**
+ The number of fraction bits.
+ */
+#define INSKFixedFractionBits 16
+
+/**
+ 1.0 as fixed-point number.
+ */
+#define INSKFixedOne ((INSKFixed)65536)
+
+/**
+ M_PI as fixed-point number.
+ */
+#define INSKFixedPi ((INSKFixed)205887)
+
+/**
+ M_PI_2 as fixed-point number.
+ */
+#define INSKFixedPiHalf ((INSKFixed)102944)
+
+/**
+ M_PI*2 as fixed-point number.
+ */
+#define INSKFixedPiX2 ((INSKFixed)411775)
+
+
+// ------------------------------------------------------------
+#pragma mark - convertions
+// ------------------------------------------------------------
+/// @name convertions
+
+/**
+ Converts an integer into a fixed-point number.
+
+ @param value An integer from -32768 to 32767.
+ @return The fixed-point number.
+ */
+static inline INSKFixed INSKFixedFromInt(int32_t value) {
+    return (INSKFixed)((uint32_t)value << INSKFixedFractionBits);
+}
+
+/**
+ Converts a fixed-point number into an integer by rounding down.
+
+ @param value A fixed-point number.
+ @return The biggest integer not greater than the value.
+ */
+static inline int32_t INSKFixedToInt(INSKFixed value) {
+    return value >> INSKFixedFractionBits;
+}
+
+/**
+ Converts a CGFloat into the nearest fixed-point number.
+
+ The conversion is exact IEEE arithmetic, so the same CGFloat results in the same fixed-point number everywhere.
+ Values out of range are clamped, NaN results in 0.
+
+ @param value A CGFloat.
+ @return The fixed-point number.
+ */
+static inline INSKFixed INSKFixedFromCGFloat(CGFloat value) {
+    double scaled = floor((double)value * 65536.0 + 0.5);
+    if (scaled >= 2147483647.0) {
+        return INT32_MAX;
+    }
+    if (scaled <= -2147483648.0) {
+        return INT32_MIN;
+    }
+    if (scaled != scaled) {
+        return 0;
+    }
+    return (INSKFixed)scaled;
+}
+
+/**
+ Converts a fixed-point number into a CGFloat.
+
+ With a double CGFloat the conversion is exact, with a float CGFloat values above 256 are rounded to 24 bits.
+
+ @param value A fixed-point number.
+ @return The CGFloat.
+ */
+static inline CGFloat INSKFixedToCGFloat(INSKFixed value) {
+    return (CGFloat)((double)value / 65536.0);
+}
+
+/**
+ Creates a fixed-point point.
+
+ @param x The x value.
+ @param y The y value.
+ @return The point.
+ */
+static inline INSKFixedPoint INSKFixedPointMake(INSKFixed x, INSKFixed y) {
+    INSKFixedPoint point = {x, y};
+    return point;
+}
+
+/**
+ Converts a CGPoint into the nearest fixed-point point.
+
+ @param point A CGPoint.
+ @return The fixed-point point.
+ */
+static inline INSKFixedPoint INSKFixedPointFromCGPoint(CGPoint point) {
+    return INSKFixedPointMake(INSKFixedFromCGFloat(point.x), INSKFixedFromCGFloat(point.y));
+}
+
+/**
+ Converts a fixed-point point into a CGPoint.
+
+ @param point A fixed-point point.
+ @return The CGPoint.
+ */
+static inline CGPoint CGPointFromINSKFixedPoint(INSKFixedPoint point) {
+    return CGPointMake(INSKFixedToCGFloat(point.x), INSKFixedToCGFloat(point.y));
+}
+
+
+// ------------------------------------------------------------
+#pragma mark - scalar calculations
+// ------------------------------------------------------------
+/// @name scalar calculations
+
+/**
+ Adds two fixed-point numbers.
+
+ @param value1 The first value.
+ @param value2 The second value.
+ @return The sum.
+ */
+static inline INSKFixed INSKFixedAdd(INSKFixed value1, INSKFixed value2) {
+    return (INSKFixed)((uint32_t)value1 + (uint32_t)value2);
+}
+
+/**
+ Subtracts a fixed-point number from another.
+
+ @param value1 The value to subtract from.
+ @param value2 The value to subtract.
+ @return The difference.
+ */
+static inline INSKFixed INSKFixedSubtract(INSKFixed value1, INSKFixed value2) {
+    return (INSKFixed)((uint32_t)value1 - (uint32_t)value2);
+}
+
+/**
+ Multiplies two fixed-point numbers and rounds the product to the nearest fixed-point number.
+
+ @param value1 The first value.
+ @param value2 The second value.
+ @return The product.
+ */
+static inline INSKFixed INSKFixedMultiply(INSKFixed value1, INSKFixed value2) {
+    int64_t product = (int64_t)value1 * (int64_t)value2;
+    return (INSKFixed)((product + (1 << (INSKFixedFractionBits - 1))) >> INSKFixedFractionBits);
+}
+
+/**
+ Divides a fixed-point number by another, the quotient is truncated towards zero.
+
+ @param value1 The dividend.
+ @param value2 The divisor, a divisor of 0 results in the biggest or smallest fixed-point number depending on the sign of the dividend.
+ @return The quotient.
+ */
+static inline INSKFixed INSKFixedDivide(INSKFixed value1, INSKFixed value2) {
+    if (value2 == 0) {
+        return value1 >= 0 ? INT32_MAX : INT32_MIN;
+    }
+    return (INSKFixed)((int64_t)value1 * INSKFixedOne / value2);
+}
+
+/**
+ Returns the absolute value of a fixed-point number.
+
+ @param value The value.
+ @return The absolute value.
+ */
+static inline INSKFixed INSKFixedAbs(INSKFixed value) {
+    return value < 0 ? INSKFixedSubtract(0, value) : value;
+}
+
+/**
+ Clamps a fixed-point number between a min and max value.
+
+ @param value The value to clamp.
+ @param min The minimum value.
+ @param max The maximum value.
+ @return The value clamped between min and max.
+ */
+static inline INSKFixed INSKFixedClamp(INSKFixed value, INSKFixed min, INSKFixed max) {
+    return value < min ? min : (value > max ? max : value);
+}
+
+/**
+ Returns the sign of a fixed-point number.
+
+ @param value The value.
+ @return INSKFixedOne for a positive value, -INSKFixedOne for a negative value and 0 for 0.
+ */
+static inline INSKFixed INSKFixedSign(INSKFixed value) {
+    return value > 0 ? INSKFixedOne : (value < 0 ? -INSKFixedOne : 0);
+}
+
+/**
+ Calculates the square root of a fixed-point number.
+
+ The result is the exact square root rounded down to the next fixed-point number.
+
+ @param value The value.
+ @return The square root or 0 for negative values.
+ */
+INSKFixed INSKFixedSqrt(INSKFixed value);
+
+
+// ------------------------------------------------------------
+#pragma mark - point calculations
+// ------------------------------------------------------------
+/// @name point calculations
+
+/**
+ Adds two fixed-point points.
+
+ @param point1 The first point.
+ @param point2 The second point.
+ @return The sum.
+ */
+static inline INSKFixedPoint INSKFixedPointAdd(INSKFixedPoint point1, INSKFixedPoint point2) {
+    return INSKFixedPointMake(INSKFixedAdd(point1.x, point2.x), INSKFixedAdd(point1.y, point2.y));
+}
+
+/**
+ Subtracts a fixed-point point from another.
+
+ @param point1 The point to subtract from.
+ @param point2 The point to subtract.
+ @return The difference.
+ */
+static inline INSKFixedPoint INSKFixedPointSubtract(INSKFixedPoint point1, INSKFixedPoint point2) {
+    return INSKFixedPointMake(INSKFixedSubtract(point1.x, point2.x), INSKFixedSubtract(point1.y, point2.y));
+}
+
+/**
+ Multiplies both values of a fixed-point point with a fixed-point number.
+
+ @param point The point.
+ @param value The factor.
+ @return The scaled point.
+ */
+static inline INSKFixedPoint INSKFixedPointMultiplyScalar(INSKFixedPoint point, INSKFixed value) {
+    return INSKFixedPointMake(INSKFixedMultiply(point.x, value), INSKFixedMultiply(point.y, value));
+}
+
+/**
+ Negates a fixed-point point.
+
+ @param point The point.
+ @return The negated point.
+ */
+static inline INSKFixedPoint INSKFixedPointNegate(INSKFixedPoint point) {
+    return INSKFixedPointMake(INSKFixedSubtract(0, point.x), INSKFixedSubtract(0, point.y));
+}
+
+/**
+ Calculates the dot product of two fixed-point points.
+
+ @param point1 The first point.
+ @param point2 The second point.
+ @return The dot product.
+ */
+static inline INSKFixed INSKFixedPointDotProduct(INSKFixedPoint point1, INSKFixedPoint point2) {
+    int64_t product = (int64_t)point1.x * point2.x + (int64_t)point1.y * point2.y;
+    return (INSKFixed)((product + (1 << (INSKFixedFractionBits - 1))) >> INSKFixedFractionBits);
+}
+
+/**
+ Calculates the cross product of two fixed-point points.
+
+ @param point1 The first point.
+ @param point2 The second point.
+ @return The z value of the cross product.
+ */
+static inline INSKFixed INSKFixedPointCrossProduct(INSKFixedPoint point1, INSKFixedPoint point2) {
+    int64_t product = (int64_t)point1.x * point2.y - (int64_t)point1.y * point2.x;
+    return (INSKFixed)((product + (1 << (INSKFixedFractionBits - 1))) >> INSKFixedFractionBits);
+}
+
+/**
+ Calculates the square length of a fixed-point vector.
+
+ @param point The vector.
+ @return The square length, which wraps around for vectors longer than 181.
+ */
+static inline INSKFixed INSKFixedPointLengthSq(INSKFixedPoint point) {
+    return INSKFixedPointDotProduct(point, point);
+}
+
+/**
+ Calculates the length of a fixed-point vector.
+
+ The square length is calculated with 64 bits, so all vectors can be measured.
+
+ @param point The vector.
+ @return The length rounded down to the next fixed-point number.
+ */
+INSKFixed INSKFixedPointLength(INSKFixedPoint point);
+
+/**
+ Calculates the distance between two fixed-point points.
+
+ @param point1 The first point.
+ @param point2 The second point.
+ @return The distance.
+ */
+static inline INSKFixed INSKFixedPointDistance(INSKFixedPoint point1, INSKFixedPoint point2) {
+    return INSKFixedPointLength(INSKFixedPointSubtract(point2, point1));
+}
+
+/**
+ Calculates the square distance between two fixed-point points.
+
+ @param point1 The first point.
+ @param point2 The second point.
+ @return The square distance, which wraps around for distances longer than 181.
+ */
+static inline INSKFixed INSKFixedPointDistanceSq(INSKFixedPoint point1, INSKFixedPoint point2) {
+    return INSKFixedPointLengthSq(INSKFixedPointSubtract(point2, point1));
+}
+
+/**
+ Normalizes a fixed-point vector to a length of 1.
+
+ @param point The vector.
+ @return The normalized vector or the zero vector for a zero vector.
+ */
+INSKFixedPoint INSKFixedPointNormalize(INSKFixedPoint point);
+
+/**
+ Interpolates linear between two fixed-point points.
+
+ @param point1 The start point returned for t = 0.
+ @param point2 The end point returned for t = INSKFixedOne.
+ @param t The interpolation factor.
+ @return The interpolated point.
+ */
+static inline INSKFixedPoint INSKFixedPointLerp(INSKFixedPoint point1, INSKFixedPoint point2, INSKFixed t) {
+    return INSKFixedPointAdd(point1, INSKFixedPointMultiplyScalar(INSKFixedPointSubtract(point2, point1), t));
+}
+
+
+// ------------------------------------------------------------
+#pragma mark - angular calculations
+// ------------------------------------------------------------
+/// @name angular calculations
+
+/**
+ Wraps a fixed-point angle in radians around so it stays in the range of 0 to INSKFixedPiX2.
+
+ @param angle An angle in radians.
+ @return The angle from 0 to below INSKFixedPiX2.
+ */
+static inline INSKFixed INSKFixedAngleIn2Pi(INSKFixed angle) {
+    INSKFixed wrapped = angle % INSKFixedPiX2;
+    return wrapped < 0 ? wrapped + INSKFixedPiX2 : wrapped;
+}
+
+/**
+ Wraps a fixed-point angle in radians around so it stays in the range of -INSKFixedPi to INSKFixedPi.
+
+ @param angle An angle in radians.
+ @return The angle from -INSKFixedPi to below INSKFixedPi.
+ */
+static inline INSKFixed INSKFixedAngleInPi(INSKFixed angle) {
+    INSKFixed wrapped = INSKFixedAngleIn2Pi(angle);
+    return wrapped >= INSKFixedPi ? wrapped - INSKFixedPiX2 : wrapped;
+}
+
+/**
+ Returns the shortest angle between two fixed-point angles in radians like ShortestAngleBetween().
+
+ @param angle1 The first angle.
+ @param angle2 The second angle.
+ @return The difference angle from -INSKFixedPi to below INSKFixedPi, positive if angle2 is bigger.
+ */
+static inline INSKFixed INSKFixedShortestAngleBetween(INSKFixed angle1, INSKFixed angle2) {
+    return INSKFixedAngleInPi(INSKFixedAngleIn2Pi(angle2) - INSKFixedAngleIn2Pi(angle1));
+}
+
+/**
+ Calculates the sine and cosine of a fixed-point angle with the integer CORDIC algorithm.
+
+ The maximum absolute error is 2/65536.
+
+ @param angle An angle in radians.
+ @param sine Receives the sine.
+ @param cosine Receives the cosine.
+ */
+void INSKFixedSinCos(INSKFixed angle, INSKFixed *sine, INSKFixed *cosine);
+
+/**
+ Creates a fixed-point vector of length 1 for an angle like CGPointForAngle().
+
+ @param angle An angle in radians.
+ @return The vector.
+ */
+static inline INSKFixedPoint INSKFixedPointForAngle(INSKFixed angle) {
+    INSKFixedPoint point;
+    INSKFixedSinCos(angle, &point.y, &point.x);
+    return point;
+}
+
+/**
+ Returns the angle of a fixed-point vector like CGPointToAngle() calculated with the integer CORDIC algorithm.
+
+ The maximum absolute error is 2/65536.
+
+ @param point The vector.
+ @return The angle from -INSKFixedPi to INSKFixedPi, 0 for the zero vector.
+ */
+INSKFixed INSKFixedPointToAngle(INSKFixedPoint point);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+// INSKGeometry.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKGeometry.h"
+
+
+#pragma mark - private functions
+
+// Returns true if the horizontal ray from the point to the right crosses the edge from corner1 to corner2.
+// The comparison of the cross product replaces the division of the intersection, so horizontal edges need no special case.
+static inline bool INSKGeometryRayCrossesEdge(CGPoint point, CGPoint corner1, CGPoint corner2) {
+    bool straddles = (corner1.y > point.y) != (corner2.y > point.y);
+    CGFloat cross = (corner2.x - corner1.x) * (point.y - corner1.y) - (point.x - corner1.x) * (corner2.y - corner1.y);
+    return straddles & ((cross > 0.0) == (corner2.y > corner1.y));
+}
+
+// Projects all corners of a polygon onto an axis and returns the smallest and biggest value.
+static void INSKGeometryProjectPolygon(INSKPolygon polygon, CGPoint axis, CGFloat *min, CGFloat *max) {
+    CGFloat minValue = CGPointDotProduct(polygon.points[0], axis);
+    CGFloat maxValue = minValue;
+    for (size_t index = 1; index < polygon.count; ++index) {
+        CGFloat value = CGPointDotProduct(polygon.points[index], axis);
+        minValue = MIN(minValue, value);
+        maxValue = MAX(maxValue, value);
+    }
+    *min = minValue;
+    *max = maxValue;
+}
+
+// Returns true if one of the edge normals of the first polygon separates both polygons.
+static bool INSKGeometryEdgesSeparatePolygons(INSKPolygon polygon1, INSKPolygon polygon2) {
+    for (size_t index = 0; index < polygon1.count; ++index) {
+        CGPoint corner1 = polygon1.points[index];
+        CGPoint corner2 = polygon1.points[(index + 1) % polygon1.count];
+        CGPoint normal = CGPointMake(corner1.y - corner2.y, corner2.x - corner1.x);
+        CGFloat min1, max1, min2, max2;
+        INSKGeometryProjectPolygon(polygon1, normal, &min1, &max1);
+        INSKGeometryProjectPolygon(polygon2, normal, &min2, &max2);
+        if (max1 < min2 || max2 < min1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the half length of the projection of an oriented box onto a unit axis.
+static inline CGFloat INSKGeometryOrientedBoxRadius(INSKOrientedBox box, CGPoint axis) {
+    CGPoint perpendicular = CGPointMake(-box.axis.y, box.axis.x);
+    return box.halfSize.width * fabs(CGPointDotProduct(box.axis, axis)) + box.halfSize.height * fabs(CGPointDotProduct(perpendicular, axis));
+}
+
+
+#pragma mark - public functions
+
+INSKAxisAlignedBox INSKAxisAlignedBoxFromPoints(const CGPoint *points, size_t count) {
+    if (count == 0) {
+        return INSKAxisAlignedBoxMake(0.0, 0.0, 0.0, 0.0);
+    }
+    INSKAxisAlignedBox box = {points[0], points[0]};
+    for (size_t index = 1; index < count; ++index) {
+        box.min.x = MIN(box.min.x, points[index].x);
+        box.min.y = MIN(box.min.y, points[index].y);
+        box.max.x = MAX(box.max.x, points[index].x);
+        box.max.y = MAX(box.max.y, points[index].y);
+    }
+    return box;
+}
+
+bool INSKConvexPolygonContainsPoint(INSKPolygon polygon, CGPoint point) {
+    if (polygon.count == 0) {
+        return false;
+    }
+    // Inside means on the same side of all edges, whichever side that is for the winding of the polygon.
+    bool hasLeft = false;
+    bool hasRight = false;
+    for (size_t index = 0; index < polygon.count; ++index) {
+        CGPoint corner1 = polygon.points[index];
+        CGPoint corner2 = polygon.points[(index + 1) % polygon.count];
+        CGFloat cross = CGPointCrossProduct(CGPointSubtract(corner2, corner1), CGPointSubtract(point, corner1));
+        hasLeft |= cross > 0.0;
+        hasRight |= cross < 0.0;
+    }
+    return !(hasLeft && hasRight);
+}
+
+bool INSKPolygonContainsPoint(INSKPolygon polygon, CGPoint point) {
+    bool inside = false;
+    for (size_t index = 0, previous = polygon.count - 1; index < polygon.count; previous = index++) {
+        inside ^= INSKGeometryRayCrossesEdge(point, polygon.points[previous], polygon.points[index]);
+    }
+    return inside;
+}
+
+bool INSKOrientedBoxOverlapsBox(INSKOrientedBox box1, INSKOrientedBox box2) {
+    CGPoint offset = CGPointSubtract(box2.center, box1.center);
+    CGPoint axes[4] = {
+        box1.axis, CGPointMake(-box1.axis.y, box1.axis.x),
+        box2.axis, CGPointMake(-box2.axis.y, box2.axis.x)
+    };
+    for (int index = 0; index < 4; ++index) {
+        CGFloat distance = fabs(CGPointDotProduct(offset, axes[index]));
+        if (distance > INSKGeometryOrientedBoxRadius(box1, axes[index]) + INSKGeometryOrientedBoxRadius(box2, axes[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool INSKConvexPolygonOverlapsPolygon(INSKPolygon polygon1, INSKPolygon polygon2) {
+    if (polygon1.count == 0 || polygon2.count == 0) {
+        return false;
+    }
+    return !INSKGeometryEdgesSeparatePolygons(polygon1, polygon2) && !INSKGeometryEdgesSeparatePolygons(polygon2, polygon1);
+}
+
+bool INSKConvexPolygonOverlapsCircle(INSKPolygon polygon, INSKCircle circle) {
+    if (polygon.count == 0) {
+        return false;
+    }
+    if (INSKConvexPolygonContainsPoint(polygon, circle.center)) {
+        return true;
+    }
+    // Otherwise the circle has to reach the nearest point of an edge.
+    CGFloat radiusSq = circle.radius * circle.radius;
+    for (size_t index = 0; index < polygon.count; ++index) {
+        CGPoint corner1 = polygon.points[index];
+        CGPoint corner2 = polygon.points[(index + 1) % polygon.count];
+        CGPoint edge = CGPointSubtract(corner2, corner1);
+        CGFloat lengthSq = CGPointLengthSq(edge);
+        CGFloat t = lengthSq > 0.0 ? Clamp(CGPointDotProduct(CGPointSubtract(circle.center, corner1), edge) / lengthSq, 0.0, 1.0) : 0.0;
+        if (CGPointDistanceSq(CGPointAdd(corner1, CGPointMultiplyScalar(edge, t)), circle.center) <= radiusSq) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t INSKAxisAlignedBoxContainsPoints(INSKAxisAlignedBox box, const CGPoint *points, bool *results, size_t count) {
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        CGPoint point = points[index];
+        bool result = (point.x >= box.min.x) & (point.x <= box.max.x) & (point.y >= box.min.y) & (point.y <= box.max.y);
+        if (results != NULL) {
+            results[index] = result;
+        }
+        inside += result;
+    }
+    return inside;
+}
+
+size_t INSKOrientedBoxContainsPoints(INSKOrientedBox box, const CGPoint *points, bool *results, size_t count) {
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        CGFloat dx = points[index].x - box.center.x;
+        CGFloat dy = points[index].y - box.center.y;
+        CGFloat u = dx * box.axis.x + dy * box.axis.y;
+        CGFloat v = dy * box.axis.x - dx * box.axis.y;
+        bool result = (fabs(u) <= box.halfSize.width) & (fabs(v) <= box.halfSize.height);
+        if (results != NULL) {
+            results[index] = result;
+        }
+        inside += result;
+    }
+    return inside;
+}
+
+size_t INSKCircleContainsPoints(INSKCircle circle, const CGPoint *points, bool *results, size_t count) {
+    CGFloat radiusSq = circle.radius * circle.radius;
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        CGFloat dx = points[index].x - circle.center.x;
+        CGFloat dy = points[index].y - circle.center.y;
+        bool result = dx * dx + dy * dy <= radiusSq;
+        if (results != NULL) {
+            results[index] = result;
+        }
+        inside += result;
+    }
+    return inside;
+}
+
+size_t INSKPolygonContainsPoints(INSKPolygon polygon, const CGPoint *points, bool *results, size_t count) {
+    for (size_t index = 0; index < count; ++index) {
+        results[index] = false;
+    }
+    for (size_t edge = 0, previous = polygon.count - 1; edge < polygon.count; previous = edge++) {
+        CGPoint corner1 = polygon.points[previous];
+        CGPoint corner2 = polygon.points[edge];
+        for (size_t index = 0; index < count; ++index) {
+            results[index] ^= INSKGeometryRayCrossesEdge(points[index], corner1, corner2);
+        }
+    }
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        inside += results[index];
+    }
+    return inside;
+}
+
+size_t INSKAxisAlignedBoxesContainPoint(const INSKAxisAlignedBox *boxes, CGPoint point, bool *results, size_t count) {
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        const INSKAxisAlignedBox *box = &boxes[index];
+        bool result = (point.x >= box->min.x) & (point.x <= box->max.x) & (point.y >= box->min.y) & (point.y <= box->max.y);
+        if (results != NULL) {
+            results[index] = result;
+        }
+        inside += result;
+    }
+    return inside;
+}
+
+size_t INSKOrientedBoxesContainPoint(const INSKOrientedBox *boxes, CGPoint point, bool *results, size_t count) {
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        const INSKOrientedBox *box = &boxes[index];
+        CGFloat dx = point.x - box->center.x;
+        CGFloat dy = point.y - box->center.y;
+        CGFloat u = dx * box->axis.x + dy * box->axis.y;
+        CGFloat v = dy * box->axis.x - dx * box->axis.y;
+        bool result = (fabs(u) <= box->halfSize.width) & (fabs(v) <= box->halfSize.height);
+        if (results != NULL) {
+            results[index] = result;
+        }
+        inside += result;
+    }
+    return inside;
+}
+
+size_t INSKCirclesContainPoint(const INSKCircle *circles, CGPoint point, bool *results, size_t count) {
+    size_t inside = 0;
+    for (size_t index = 0; index < count; ++index) {
+        CGFloat dx = point.x - circles[index].center.x;
+        CGFloat dy = point.y - circles[index].center.y;
+        bool result = dx * dx + dy * dy <= circles[index].radius * circles[index].radius;
+        if (results != NULL) {
+            results[index] = result;
+        }
+        inside += result;
+    }
+    return inside;
+}
+
+size_t INSKAxisAlignedBoxesOverlapBox(const INSKAxisAlignedBox *boxes, INSKAxisAlignedBox box, bool *results, size_t count) {
+    size_t overlapping = 0;
+    for (size_t index = 0; index < count; ++index) {
+        const INSKAxisAlignedBox *other = &boxes[index];
+        bool result = (other->min.x <= box.max.x) & (box.min.x <= other->max.x) & (other->min.y <= box.max.y) & (box.min.y <= other->max.y);
+        if (results != NULL) {
+            results[index] = result;
+        }
+        overlapping += result;
+    }
+    return overlapping;
+}
+
+size_t INSKCirclesOverlapBox(const INSKCircle *circles, INSKAxisAlignedBox box, bool *results, size_t count) {
+    size_t overlapping = 0;
+    for (size_t index = 0; index < count; ++index) {
+        CGPoint center = circles[index].center;
+        CGFloat dx = center.x - MIN(MAX(center.x, box.min.x), box.max.x);
+        CGFloat dy = center.y - MIN(MAX(center.y, box.min.y), box.max.y);
+        bool result = dx * dx + dy * dy <= circles[index].radius * circles[index].radius;
+        if (results != NULL) {
+            results[index] = result;
+        }
+        overlapping += result;
+    }
+    return overlapping;
+}
+
+size_t INSKAxisAlignedBoxSubtract(INSKAxisAlignedBox box, INSKAxisAlignedBox subtrahend, INSKAxisAlignedBox *pieces) {
+    if (!(box.min.x < box.max.x) || !(box.min.y < box.max.y)) {
+        return 0;
+    }
+    // A subtrahend without an area or only touching the box takes nothing away.
+    if (!(subtrahend.min.x < subtrahend.max.x) || !(subtrahend.min.y < subtrahend.max.y)
+        || subtrahend.min.x >= box.max.x || subtrahend.max.x <= box.min.x || subtrahend.min.y >= box.max.y || subtrahend.max.y <= box.min.y) {
+        pieces[0] = box;
+        return 1;
+    }
+    size_t count = 0;
+    if (subtrahend.min.y > box.min.y) {
+        pieces[count++] = INSKAxisAlignedBoxMake(box.min.x, box.min.y, box.max.x, subtrahend.min.y);
+    }
+    if (subtrahend.max.y < box.max.y) {
+        pieces[count++] = INSKAxisAlignedBoxMake(box.min.x, subtrahend.max.y, box.max.x, box.max.y);
+    }
+    CGFloat minY = MAX(box.min.y, subtrahend.min.y);
+    CGFloat maxY = MIN(box.max.y, subtrahend.max.y);
+    if (subtrahend.min.x > box.min.x) {
+        pieces[count++] = INSKAxisAlignedBoxMake(box.min.x, minY, subtrahend.min.x, maxY);
+    }
+    if (subtrahend.max.x < box.max.x) {
+        pieces[count++] = INSKAxisAlignedBoxMake(subtrahend.max.x, minY, box.max.x, maxY);
+    }
+    return count;
+}
@@ -0,0 +1,476 @@
+// INSKGeometry.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_GEOMETRY_H
+#define INSK_GEOMETRY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "INSKMath.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ------------------------------------------------------------
+#pragma mark - shapes
+// ------------------------------------------------------------
+/// @name shapes
+
+// Containment and overlap tests of 2D shapes in plain C, so they can be used for hit testing and culling and be tested on any platform.
+// All tests include the boundary of the shapes, a point on an edge is inside and touching shapes overlap.
+// The batch functions are branchless loops the compiler vectorizes.
+
+/**
+ An axis-aligned box given by its minimum and maximum corner.
+ */
+typedef struct {
+    /// The corner with the smallest x and y values.
+    CGPoint min;
+    /// The corner with the biggest x and y values.
+    CGPoint max;
+} INSKAxisAlignedBox;
+
+/**
+ A box rotated around its center.
+ */
+typedef struct {
+    /// The center of the box.
+    CGPoint center;
+    /// The unit vector of the box's x axis, which is (cos(angle), sin(angle)) of the rotation.
+    CGPoint axis;
+    /// Half of the width and height of the box.
+    CGSize halfSize;
+} INSKOrientedBox;
+
+/**
+ A circle.
+ */
+typedef struct {
+    /// The center of the circle.
+    CGPoint center;
+    /// The radius of the circle.
+    CGFloat radius;
+} INSKCircle;
+
+/**
+ A closed polygon given by its corners, the last corner is connected to the first one.
+ */
+typedef struct {
+    /// The corners in clockwise or counterclockwise order.
+    const CGPoint *points;
+    /// The number of corners.
+    size_t count;
+} INSKPolygon;
+
+
+/**
+ Creates an axis-aligned box from its minimum and maximum values.
+
+ @param minX The smallest x value.
+ @param minY The smallest y value.
+ @param maxX The biggest x value.
+ @param maxY The biggest y value.
+ @return The box.
+ */
+static inline INSKAxisAlignedBox INSKAxisAlignedBoxMake(CGFloat minX, CGFloat minY, CGFloat maxX, CGFloat maxY) {
+    INSKAxisAlignedBox box = {{minX, minY}, {maxX, maxY}};
+    return box;
+}
+
+/**
+ Creates an axis-aligned box from a rect, which may have a negative width or height.
+
+ @param rect The rect.
+ @return The box covering the rect.
+ */
+static inline INSKAxisAlignedBox INSKAxisAlignedBoxFromCGRect(CGRect rect) {
+    CGFloat x2 = rect.origin.x + rect.size.width;
+    CGFloat y2 = rect.origin.y + rect.size.height;
+    return INSKAxisAlignedBoxMake(MIN(rect.origin.x, x2), MIN(rect.origin.y, y2), MAX(rect.origin.x, x2), MAX(rect.origin.y, y2));
+}
+
+/**
+ Creates an oriented box.
+
+ @param center The center of the box.
+ @param size The width and height of the box.
+ @param angle The rotation of the box in radians.
+ @return The box.
+ */
+static inline INSKOrientedBox INSKOrientedBoxMake(CGPoint center, CGSize size, CGFloat angle) {
+    INSKOrientedBox box = {center, CGPointForAngle(angle), {size.width * 0.5, size.height * 0.5}};
+    return box;
+}
+
+/**
+ Creates a circle.
+
+ @param center The center of the circle.
+ @param radius The radius of the circle.
+ @return The circle.
+ */
+static inline INSKCircle INSKCircleMake(CGPoint center, CGFloat radius) {
+    INSKCircle circle = {center, radius};
+    return circle;
+}
+
+/**
+ Creates a polygon of corners, the corners are not copied.
+
+ @param points The corners.
+ @param count The number of corners.
+ @return The polygon.
+ */
+static inline INSKPolygon INSKPolygonMake(const CGPoint *points, size_t count) {
+    INSKPolygon polygon = {points, count};
+    return polygon;
+}
+
+
+// ------------------------------------------------------------
+#pragma mark - bounding boxes
+// ------------------------------------------------------------
+/// @name bounding boxes
+
+/**
+ Returns the smallest axis-aligned box of some points.
+
+ @param points The points.
+ @param count The number of points.
+ @return The box or a box with both corners at (0, 0) if count is 0.
+ */
+INSKAxisAlignedBox INSKAxisAlignedBoxFromPoints(const CGPoint *points, size_t count);
+
+/**
+ Returns the smallest axis-aligned box of an oriented box.
+
+ @param box The oriented box.
+ @return The axis-aligned box.
+ */
+static inline INSKAxisAlignedBox INSKOrientedBoxGetBoundingBox(INSKOrientedBox box) {
+    CGFloat extentX = fabs(box.axis.x) * box.halfSize.width + fabs(box.axis.y) * box.halfSize.height;
+    CGFloat extentY = fabs(box.axis.y) * box.halfSize.width + fabs(box.axis.x) * box.halfSize.height;
+    return INSKAxisAlignedBoxMake(box.center.x - extentX, box.center.y - extentY, box.center.x + extentX, box.center.y + extentY);
+}
+
+/**
+ Returns the smallest axis-aligned box of a circle.
+
+ @param circle The circle.
+ @return The axis-aligned box.
+ */
+static inline INSKAxisAlignedBox INSKCircleGetBoundingBox(INSKCircle circle) {
+    return INSKAxisAlignedBoxMake(circle.center.x - circle.radius, circle.center.y - circle.radius, circle.center.x + circle.radius, circle.center.y + circle.radius);
+}
+
+
+// ------------------------------------------------------------
+#pragma mark - containment
+// ------------------------------------------------------------
+/// @name containment
+
+/**
+ Returns true if a point is inside of an axis-aligned box.
+
+ @param box The box.
+ @param point The point.
+ @return True if the point is inside or on the boundary.
+ */
+static inline bool INSKAxisAlignedBoxContainsPoint(INSKAxisAlignedBox box, CGPoint point) {
+    return point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y && point.y <= box.max.y;
+}
+
+/**
+ Returns true if a point is inside of an oriented box.
+
+ @param box The box.
+ @param point The point.
+ @return True if the point is inside or on the boundary.
+ */
+static inline bool INSKOrientedBoxContainsPoint(INSKOrientedBox box, CGPoint point) {
+    CGPoint offset = CGPointSubtract(point, box.center);
+    return fabs(CGPointDotProduct(offset, box.axis)) <= box.halfSize.width && fabs(CGPointCrossProduct(box.axis, offset)) <= box.halfSize.height;
+}
+
+/**
+ Returns true if a point is inside of a circle.
+
+ @param circle The circle.
+ @param point The point.
+ @return True if the point is inside or on the boundary.
+ */
+static inline bool INSKCircleContainsPoint(INSKCircle circle, CGPoint point) {
+    return CGPointDistanceSq(circle.center, point) <= circle.radius * circle.radius;
+}
+
+/**
+ Returns true if a point is inside of a convex polygon.
+
+ The polygon may be clockwise or counterclockwise, but has to be convex.
+
+ @param polygon The convex polygon.
+ @param point The point.
+ @return True if the point is inside or on the boundary.
+ */
+bool INSKConvexPolygonContainsPoint(INSKPolygon polygon, CGPoint point);
+
+/**
+ Returns true if a point is inside of any polygon, which may be concave or self-intersecting.
+
+ The even-odd rule is used, so areas enclosed an even number of times are outside.
+ Points exactly on an edge may be reported as inside or outside.
+
+ @param polygon The polygon.
+ @param point The point.
+ @return True if the point is inside.
+ */
+bool INSKPolygonContainsPoint(INSKPolygon polygon, CGPoint point);
+
+
+// ------------------------------------------------------------
+#pragma mark - overlap
+// ------------------------------------------------------------
+/// @name overlap
+
+/**
+ Returns true if two axis-aligned boxes overlap.
+
+ @param box1 The first box.
+ @param box2 The second box.
+ @return True if the boxes overlap or touch.
+ */
+static inline bool INSKAxisAlignedBoxOverlapsBox(INSKAxisAlignedBox box1, INSKAxisAlignedBox box2) {
+    return box1.min.x <= box2.max.x && box2.min.x <= box1.max.x && box1.min.y <= box2.max.y && box2.min.y <= box1.max.y;
+}
+
+/**
+ Returns true if an axis-aligned box and a circle overlap.
+
+ @param box The box.
+ @param circle The circle.
+ @return True if the shapes overlap or touch.
+ */
+static inline bool INSKAxisAlignedBoxOverlapsCircle(INSKAxisAlignedBox box, INSKCircle circle) {
+    return INSKCircleContainsPoint(circle, CGPointClamp(circle.center, box.min, box.max));
+}
+
+/**
+ Returns true if two circles overlap.
+
+ @param circle1 The first circle.
+ @param circle2 The second circle.
+ @return True if the circles overlap or touch.
+ */
+static inline bool INSKCircleOverlapsCircle(INSKCircle circle1, INSKCircle circle2) {
+    CGFloat radius = circle1.radius + circle2.radius;
+    return CGPointDistanceSq(circle1.center, circle2.center) <= radius * radius;
+}
+
+/**
+ Returns true if an oriented box and a circle overlap.
+
+ @param box The box.
+ @param circle The circle.
+ @return True if the shapes overlap or touch.
+ */
+static inline bool INSKOrientedBoxOverlapsCircle(INSKOrientedBox box, INSKCircle circle) {
+    // Test the circle in the coordinate system of the box, where the box is axis-aligned.
+    CGPoint offset = CGPointSubtract(circle.center, box.center);
+    INSKCircle localCircle = {{CGPointDotProduct(offset, box.axis), CGPointCrossProduct(box.axis, offset)}, circle.radius};
+    INSKAxisAlignedBox localBox = INSKAxisAlignedBoxMake(-box.halfSize.width, -box.halfSize.height, box.halfSize.width, box.halfSize.height);
+    return INSKAxisAlignedBoxOverlapsCircle(localBox, localCircle);
+}
+
+/**
+ Returns true if two oriented boxes overlap with the separating axis test.
+
+ @param box1 The first box.
+ @param box2 The second box.
+ @return True if the boxes overlap or touch.
+ */
+bool INSKOrientedBoxOverlapsBox(INSKOrientedBox box1, INSKOrientedBox box2);
+
+/**
+ Returns true if two convex polygons overlap with the separating axis test.
+
+ @param polygon1 The first convex polygon.
+ @param polygon2 The second convex polygon.
+ @return True if the polygons overlap or touch, false if one of them has no corners.
+ */
+bool INSKConvexPolygonOverlapsPolygon(INSKPolygon polygon1, INSKPolygon polygon2);
+
+/**
+ Returns true if a convex polygon and a circle overlap.
+
+ @param polygon The convex polygon.
+ @param circle The circle.
+ @return True if the shapes overlap or touch, false if the polygon has no corners.
+ */
+bool INSKConvexPolygonOverlapsCircle(INSKPolygon polygon, INSKCircle circle);
+
+
+// ------------------------------------------------------------
+#pragma mark - points against one shape
+// ------------------------------------------------------------
+/// @name points against one shape
+
+/**
+ Tests many points against an axis-aligned box like INSKAxisAlignedBoxContainsPoint().
+
+ @param box The box.
+ @param points The points.
+ @param results Receives for each point whether it is inside, may be NULL if only the number is needed.
+ @param count The number of points.
+ @return The number of points inside.
+ */
+size_t INSKAxisAlignedBoxContainsPoints(INSKAxisAlignedBox box, const CGPoint *points, bool *results, size_t count);
+
+/**
+ Tests many points against an oriented box like INSKOrientedBoxContainsPoint().
+
+ @param box The box.
+ @param points The points.
+ @param results Receives for each point whether it is inside, may be NULL if only the number is needed.
+ @param count The number of points.
+ @return The number of points inside.
+ */
+size_t INSKOrientedBoxContainsPoints(INSKOrientedBox box, const CGPoint *points, bool *results, size_t count);
+
+/**
+ Tests many points against a circle like INSKCircleContainsPoint().
+
+ @param circle The circle.
+ @param points The points.
+ @param results Receives for each point whether it is inside, may be NULL if only the number is needed.
+ @param count The number of points.
+ @return The number of points inside.
+ */
+size_t INSKCircleContainsPoints(INSKCircle circle, const CGPoint *points, bool *results, size_t count);
+
+/**
+ Tests many points against a polygon like INSKPolygonContainsPoint().
+
+ The edges are the outer loop, so each edge is loaded once for all points.
+
+ @param polygon The polygon, which may be concave.
+ @param points The points.
+ @param results Receives for each point whether it is inside, must not be NULL.
+ @param count The number of points.
+ @return The number of points inside.
+ */
+size_t INSKPolygonContainsPoints(INSKPolygon polygon, const CGPoint *points, bool *results, size_t count);
+
+
+// ------------------------------------------------------------
+#pragma mark - one point against shapes
+// ------------------------------------------------------------
+/// @name one point against shapes
+
+/**
+ Tests a point against many axis-aligned boxes like INSKAxisAlignedBoxContainsPoint().
+
+ @param boxes The boxes.
+ @param point The point.
+ @param results Receives for each box whether it contains the point, may be NULL if only the number is needed.
+ @param count The number of boxes.
+ @return The number of boxes containing the point.
+ */
+size_t INSKAxisAlignedBoxesContainPoint(const INSKAxisAlignedBox *boxes, CGPoint point, bool *results, size_t count);
+
+/**
+ Tests a point against many oriented boxes like INSKOrientedBoxContainsPoint().
+
+ @param boxes The boxes.
+ @param point The point.
+ @param results Receives for each box whether it contains the point, may be NULL if only the number is needed.
+ @param count The number of boxes.
+ @return The number of boxes containing the point.
+ */
+size_t INSKOrientedBoxesContainPoint(const INSKOrientedBox *boxes, CGPoint point, bool *results, size_t count);
+
+/**
+ Tests a point against many circles like INSKCircleContainsPoint().
+
+ @param circles The circles.
+ @param point The point.
+ @param results Receives for each circle whether it contains the point, may be NULL if only the number is needed.
+ @param count The number of circles.
+ @return The number of circles containing the point.
+ */
+size_t INSKCirclesContainPoint(const INSKCircle *circles, CGPoint point, bool *results, size_t count);
+
+/**
+ Tests many axis-aligned boxes against one box like INSKAxisAlignedBoxOverlapsBox(), i.e. for culling nodes against the visible area.
+
+ @param boxes The boxes.
+ @param box The box to test against, i.e. the visible area.
+ @param results Receives for each box whether it overlaps, may be NULL if only the number is needed.
+ @param count The number of boxes.
+ @return The number of overlapping boxes.
+ */
+size_t INSKAxisAlignedBoxesOverlapBox(const INSKAxisAlignedBox *boxes, INSKAxisAlignedBox box, bool *results, size_t count);
+
+/**
+ Tests many circles against one axis-aligned box like INSKAxisAlignedBoxOverlapsCircle(), i.e. for culling nodes against the visible area.
+
+ @param circles The circles.
+ @param box The box to test against, i.e. the visible area.
+ @param results Receives for each circle whether it overlaps, may be NULL if only the number is needed.
+ @param count The number of circles.
+ @return The number of overlapping circles.
+ */
+size_t INSKCirclesOverlapBox(const INSKCircle *circles, INSKAxisAlignedBox box, bool *results, size_t count);
+
+
+// ------------------------------------------------------------
+#pragma mark - regions
+// ------------------------------------------------------------
+/// @name regions
+
+/**
+ The maximum number of boxes INSKAxisAlignedBoxSubtract() returns.
+ */
+#define INSKAxisAlignedBoxSubtractMaxPieces 4
+
+/**
+ Splits the part of a box which lies outside of another box into boxes, i.e. the area which has scrolled into or out of view.
+
+ The pieces don't overlap but may touch, they are the bands below and above the subtrahend over the full width of the box
+ followed by the parts left and right of the subtrahend. Pieces without an area are left out.
+
+ @param box The box to subtract from.
+ @param subtrahend The box to subtract.
+ @param pieces Receives the pieces, needs room for INSKAxisAlignedBoxSubtractMaxPieces boxes.
+ @return The number of pieces, 0 if the box lies inside of the subtrahend or has no area, 1 with the box itself if the boxes don't overlap.
+ */
+size_t INSKAxisAlignedBoxSubtract(INSKAxisAlignedBox box, INSKAxisAlignedBox subtrahend, INSKAxisAlignedBox *pieces);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
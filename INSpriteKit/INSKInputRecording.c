@@ -0,0 +1,235 @@
+// INSKInputRecording.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKInputRecording.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// The magic bytes at the beginning of an encoded recording.
+static const char INSKInputRecordingMagic[8] = {'I', 'N', 'S', 'K', 'I', 'N', 'P', 'T'};
+// The version of the format.
+static const uint32_t INSKInputRecordingVersion = 1;
+// The size of the header and of each event in the encoded format.
+#define INSKInputRecordingHeaderSize 16
+#define INSKInputRecordingEventSize 24
+
+
+struct INSKInputRecording {
+    INSKInputEvent *events;
+    size_t count;
+    size_t capacity;
+};
+
+
+#pragma mark - private functions
+
+static void INSKInputRecordingPutUInt32(unsigned char *bytes, uint32_t value) {
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+    bytes[2] = (unsigned char)(value >> 16);
+    bytes[3] = (unsigned char)(value >> 24);
+}
+
+static uint32_t INSKInputRecordingGetUInt32(const unsigned char *bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static void INSKInputRecordingPutUInt64(unsigned char *bytes, uint64_t value) {
+    INSKInputRecordingPutUInt32(bytes, (uint32_t)value);
+    INSKInputRecordingPutUInt32(bytes + 4, (uint32_t)(value >> 32));
+}
+
+static uint64_t INSKInputRecordingGetUInt64(const unsigned char *bytes) {
+    return (uint64_t)INSKInputRecordingGetUInt32(bytes) | (uint64_t)INSKInputRecordingGetUInt32(bytes + 4) << 32;
+}
+
+
+#pragma mark - public functions
+
+INSKInputRecording *INSKInputRecordingCreate(void) {
+    return calloc(1, sizeof(INSKInputRecording));
+}
+
+void INSKInputRecordingDestroy(INSKInputRecording *recording) {
+    if (recording == NULL) {
+        return;
+    }
+    free(recording->events);
+    free(recording);
+}
+
+void INSKInputRecordingClear(INSKInputRecording *recording) {
+    recording->count = 0;
+}
+
+size_t INSKInputRecordingCount(const INSKInputRecording *recording) {
+    return recording->count;
+}
+
+const INSKInputEvent *INSKInputRecordingEvents(const INSKInputRecording *recording) {
+    return recording->events;
+}
+
+bool INSKInputRecordingAppend(INSKInputRecording *recording, const INSKInputEvent *event) {
+    if (recording->count == recording->capacity) {
+        size_t capacity = recording->capacity > 0 ? recording->capacity * 2 : 256;
+        INSKInputEvent *events = realloc(recording->events, capacity * sizeof(INSKInputEvent));
+        if (events == NULL) {
+            return false;
+        }
+        recording->events = events;
+        recording->capacity = capacity;
+    }
+    recording->events[recording->count++] = *event;
+    return true;
+}
+
+size_t INSKInputRecordingEncodedSize(const INSKInputRecording *recording) {
+    return INSKInputRecordingHeaderSize + recording->count * INSKInputRecordingEventSize;
+}
+
+size_t INSKInputRecordingEncode(const INSKInputRecording *recording, void *buffer, size_t size) {
+    size_t encodedSize = INSKInputRecordingEncodedSize(recording);
+    if (size < encodedSize || recording->count > UINT32_MAX) {
+        return 0;
+    }
+
+    unsigned char *bytes = buffer;
+    memcpy(bytes, INSKInputRecordingMagic, sizeof(INSKInputRecordingMagic));
+    INSKInputRecordingPutUInt32(bytes + 8, INSKInputRecordingVersion);
+    INSKInputRecordingPutUInt32(bytes + 12, (uint32_t)recording->count);
+    bytes += INSKInputRecordingHeaderSize;
+
+    for (size_t index = 0; index < recording->count; ++index) {
+        const INSKInputEvent *event = &recording->events[index];
+        uint64_t timestamp;
+        uint32_t x, y;
+        memcpy(&timestamp, &event->timestamp, sizeof(timestamp));
+        memcpy(&x, &event->x, sizeof(x));
+        memcpy(&y, &event->y, sizeof(y));
+        INSKInputRecordingPutUInt64(bytes, timestamp);
+        INSKInputRecordingPutUInt32(bytes + 8, x);
+        INSKInputRecordingPutUInt32(bytes + 12, y);
+        INSKInputRecordingPutUInt32(bytes + 16, event->touchId);
+        bytes[20] = event->phase;
+        bytes[21] = event->buttons;
+        bytes[22] = 0;
+        bytes[23] = 0;
+        bytes += INSKInputRecordingEventSize;
+    }
+    return encodedSize;
+}
+
+INSKInputRecording *INSKInputRecordingDecode(const void *buffer, size_t size) {
+    const unsigned char *bytes = buffer;
+    if (size < INSKInputRecordingHeaderSize || memcmp(bytes, INSKInputRecordingMagic, sizeof(INSKInputRecordingMagic)) != 0) {
+        return NULL;
+    }
+    if (INSKInputRecordingGetUInt32(bytes + 8) != INSKInputRecordingVersion) {
+        return NULL;
+    }
+    size_t count = INSKInputRecordingGetUInt32(bytes + 12);
+    if ((size - INSKInputRecordingHeaderSize) / INSKInputRecordingEventSize < count) {
+        return NULL;
+    }
+    bytes += INSKInputRecordingHeaderSize;
+
+    INSKInputRecording *recording = INSKInputRecordingCreate();
+    if (recording == NULL) {
+        return NULL;
+    }
+    for (size_t index = 0; index < count; ++index) {
+        INSKInputEvent event;
+        uint64_t timestamp = INSKInputRecordingGetUInt64(bytes);
+        uint32_t x = INSKInputRecordingGetUInt32(bytes + 8);
+        uint32_t y = INSKInputRecordingGetUInt32(bytes + 12);
+        memcpy(&event.timestamp, &timestamp, sizeof(timestamp));
+        memcpy(&event.x, &x, sizeof(x));
+        memcpy(&event.y, &y, sizeof(y));
+        event.touchId = INSKInputRecordingGetUInt32(bytes + 16);
+        event.phase = bytes[20];
+        event.buttons = bytes[21];
+        if (!INSKInputRecordingAppend(recording, &event)) {
+            INSKInputRecordingDestroy(recording);
+            return NULL;
+        }
+        bytes += INSKInputRecordingEventSize;
+    }
+    return recording;
+}
+
+bool INSKInputRecordingWriteFile(const INSKInputRecording *recording, const char *path) {
+    size_t size = INSKInputRecordingEncodedSize(recording);
+    void *buffer = malloc(size);
+    if (buffer == NULL) {
+        return false;
+    }
+    bool success = false;
+    if (INSKInputRecordingEncode(recording, buffer, size) == size) {
+        FILE *file = fopen(path, "wb");
+        if (file != NULL) {
+            success = fwrite(buffer, 1, size, file) == size;
+            success = (fclose(file) == 0) && success;
+        }
+    }
+    free(buffer);
+    return success;
+}
+
+INSKInputRecording *INSKInputRecordingReadFile(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    INSKInputRecording *recording = NULL;
+    unsigned char *buffer = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+    bool success = true;
+    while (success) {
+        if (size == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 4096;
+            unsigned char *newBuffer = realloc(buffer, capacity);
+            if (newBuffer == NULL) {
+                success = false;
+                break;
+            }
+            buffer = newBuffer;
+        }
+        size_t read = fread(buffer + size, 1, capacity - size, file);
+        size += read;
+        if (read == 0) {
+            success = !ferror(file);
+            break;
+        }
+    }
+    if (success) {
+        recording = INSKInputRecordingDecode(buffer, size);
+    }
+    free(buffer);
+    fclose(file);
+    return recording;
+}
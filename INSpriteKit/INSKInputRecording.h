@@ -0,0 +1,178 @@
+// INSKInputRecording.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_INPUT_RECORDING_H
+#define INSK_INPUT_RECORDING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ The phase of a recorded event. The values are the same as those of INSKTouchPhase.
+ */
+typedef enum {
+    /// A touch began or a mouse button has been pressed.
+    INSKInputPhaseBegan = 1 << 0,
+    /// A touch moved or the mouse has been dragged.
+    INSKInputPhaseMoved = 1 << 1,
+    /// A touch ended or a mouse button has been released.
+    INSKInputPhaseEnded = 1 << 2,
+    /// A touch has been cancelled.
+    INSKInputPhaseCancelled = 1 << 3
+} INSKInputPhase;
+
+
+/**
+ A single recorded touch or mouse event.
+ */
+typedef struct {
+    /// The time of the event in seconds.
+    double timestamp;
+    /// The location in the scene's coordinate system.
+    float x;
+    float y;
+    /// An identifier which is the same for all events of the same touch, 0 for mouse events.
+    uint32_t touchId;
+    /// The phase of the event.
+    uint8_t phase;
+    /// The mouse button as INSKMouseButton value, 0 for touches.
+    uint8_t buttons;
+} INSKInputEvent;
+
+
+/**
+ A growing list of touch and mouse events which can be saved to and loaded from a compact binary format.
+
+ The format starts with the 8 bytes "INSKINPT", followed by the version and the number of events as 32 bit unsigned integers.
+ Each event follows with 24 bytes: the timestamp as 64 bit double, x and y as 32 bit floats, the touch identifier as 32 bit unsigned integer,
+ the phase and the buttons as one byte each and two bytes of padding.
+ All values are stored in little endian, so recordings made on a device can be replayed on any other platform.
+
+ This is plain C without any dependencies to Sprite Kit, so a INSKView can record the events on a device while INSKInputReplay.h replays them anywhere.
+ */
+typedef struct INSKInputRecording INSKInputRecording;
+
+
+/**
+ Creates a new empty recording.
+
+ @return A new recording which has to be freed with INSKInputRecordingDestroy() or NULL if the memory couldn't be allocated.
+ */
+INSKInputRecording *INSKInputRecordingCreate(void);
+
+/**
+ Frees the recording and all its events.
+
+ @param recording The recording to free, may be NULL.
+ */
+void INSKInputRecordingDestroy(INSKInputRecording *recording);
+
+/**
+ Removes all events from the recording.
+
+ @param recording The recording.
+ */
+void INSKInputRecordingClear(INSKInputRecording *recording);
+
+/**
+ Returns the number of events in the recording.
+
+ @param recording The recording.
+ @return The number of events.
+ */
+size_t INSKInputRecordingCount(const INSKInputRecording *recording);
+
+/**
+ Returns the recorded events.
+
+ @param recording The recording.
+ @return A pointer to the events which is valid until the recording is changed.
+ */
+const INSKInputEvent *INSKInputRecordingEvents(const INSKInputRecording *recording);
+
+/**
+ Adds an event to the end of the recording.
+
+ @param recording The recording.
+ @param event The event to add.
+ @return False if the memory couldn't be allocated.
+ */
+bool INSKInputRecordingAppend(INSKInputRecording *recording, const INSKInputEvent *event);
+
+/**
+ Returns the number of bytes needed to encode the recording.
+
+ @param recording The recording.
+ @return The size of the encoded recording in bytes.
+ */
+size_t INSKInputRecordingEncodedSize(const INSKInputRecording *recording);
+
+/**
+ Encodes the recording into a buffer.
+
+ @param recording The recording.
+ @param buffer The buffer which receives the encoded recording.
+ @param size The size of the buffer, has to be at least INSKInputRecordingEncodedSize().
+ @return The number of bytes written or 0 if the buffer is too small.
+ */
+size_t INSKInputRecordingEncode(const INSKInputRecording *recording, void *buffer, size_t size);
+
+/**
+ Decodes a recording from a buffer.
+
+ @param buffer The encoded recording.
+ @param size The size of the buffer.
+ @return A new recording which has to be freed with INSKInputRecordingDestroy() or NULL if the data is invalid or the memory couldn't be allocated.
+ */
+INSKInputRecording *INSKInputRecordingDecode(const void *buffer, size_t size);
+
+/**
+ Saves the recording into a file.
+
+ @param recording The recording.
+ @param path The path of the file, an existing file will be overwritten.
+ @return False if the file couldn't be written.
+ */
+bool INSKInputRecordingWriteFile(const INSKInputRecording *recording, const char *path);
+
+/**
+ Loads a recording from a file.
+
+ @param path The path of the file.
+ @return A new recording which has to be freed with INSKInputRecordingDestroy() or NULL if the file couldn't be read or is invalid.
+ */
+INSKInputRecording *INSKInputRecordingReadFile(const char *path);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
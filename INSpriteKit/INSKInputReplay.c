@@ -0,0 +1,265 @@
+// INSKInputReplay.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKInputReplay.h"
+#include "INSKTouchSlotTable.h"
+#include "INSKInstrumentation.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+
+// The state of a replay passed to the visitor of the spatial index.
+typedef struct {
+    const INSKInputReplayScene *scene;
+    unsigned int mouseButton;
+    double x;
+    double y;
+    const INSKInputReplayNode *topNode;
+} INSKInputReplayHitTest;
+
+
+#pragma mark - private functions
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKInputReplayRandom(uint32_t *state) {
+    uint32_t value = *state;
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    *state = value;
+    return value;
+}
+
+// Returns a random number in the range [min, max].
+static double INSKInputReplayRandomInRange(uint32_t *state, double min, double max) {
+    return min + (max - min) * (INSKInputReplayRandom(state) / (double)UINT32_MAX);
+}
+
+// Returns true if the node should receive a touch instead of the current top node, which may be NULL.
+static bool INSKInputReplayNodeIsAbove(const INSKInputReplayNode *node, const INSKInputReplayNode *topNode) {
+    if (topNode == NULL) {
+        return true;
+    }
+    if (node->touchPriority != topNode->touchPriority) {
+        return node->touchPriority > topNode->touchPriority;
+    }
+    if (node->zPosition != topNode->zPosition) {
+        return node->zPosition > topNode->zPosition;
+    }
+    return node->treeOrder > topNode->treeOrder;
+}
+
+// Visitor for the spatial index which keeps the top interacting node.
+static void INSKInputReplayVisitNode(void *object, void *context) {
+    INSKInputReplayHitTest *hitTest = context;
+    const INSKInputReplayNode *node = object;
+    if (!node->interacting || !(node->supportedMouseButtons & hitTest->mouseButton)) {
+        return;
+    }
+    if (INSKInputReplayNodeIsAbove(node, hitTest->topNode)) {
+        hitTest->topNode = node;
+    }
+}
+
+// Returns the number of observers interested in the event.
+static size_t INSKInputReplayInformObservers(const INSKInputReplayScene *scene, const INSKInputEvent *event) {
+    size_t calls = 0;
+    for (size_t index = 0; index < scene->observerCount; ++index) {
+        const INSKInputReplayObserver *observer = &scene->observers[index];
+        if (!(observer->phases & event->phase)) {
+            continue;
+        }
+        if (observer->hasRegion && (event->x < observer->region.minX || event->x > observer->region.maxX || event->y < observer->region.minY || event->y > observer->region.maxY)) {
+            continue;
+        }
+        calls++;
+    }
+    return calls;
+}
+
+static int INSKInputReplayCompareLatencies(const void *first, const void *second) {
+    uint64_t firstLatency = *(const uint64_t *)first;
+    uint64_t secondLatency = *(const uint64_t *)second;
+    return (firstLatency > secondLatency) - (firstLatency < secondLatency);
+}
+
+
+#pragma mark - public functions
+
+bool INSKInputReplayRun(const INSKInputReplayScene *scene, const INSKInputRecording *recording, unsigned int iterations, INSKInputReplayResult *result) {
+    memset(result, 0, sizeof(INSKInputReplayResult));
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    size_t eventCount = INSKInputRecordingCount(recording);
+    const INSKInputEvent *events = INSKInputRecordingEvents(recording);
+    if (eventCount == 0) {
+        return true;
+    }
+
+    // Build the index like INSKView does before the first touch.
+    INSKSpatialBounds worldBounds = {0.0, 0.0, 0.0, 0.0};
+    for (size_t index = 0; index < scene->nodeCount; ++index) {
+        INSKSpatialBounds bounds = scene->nodes[index].bounds;
+        if (index == 0) {
+            worldBounds = bounds;
+        } else {
+            worldBounds.minX = fmin(worldBounds.minX, bounds.minX);
+            worldBounds.minY = fmin(worldBounds.minY, bounds.minY);
+            worldBounds.maxX = fmax(worldBounds.maxX, bounds.maxX);
+            worldBounds.maxY = fmax(worldBounds.maxY, bounds.maxY);
+        }
+    }
+    INSKSpatialIndex *index = INSKSpatialIndexCreate(worldBounds, 8);
+    uint64_t *latencies = malloc(eventCount * iterations * sizeof(uint64_t));
+    bool success = index != NULL && latencies != NULL;
+    for (size_t nodeIndex = 0; success && nodeIndex < scene->nodeCount; ++nodeIndex) {
+        const INSKInputReplayNode *node = &scene->nodes[nodeIndex];
+        success = INSKSpatialIndexInsert(index, node->bounds, (void *)node) != INSKSpatialIndexInvalidHandle;
+    }
+
+    INSKTouchSlotTable table;
+    size_t latencyCount = 0;
+    for (unsigned int iteration = 0; success && iteration < iterations; ++iteration) {
+        INSKTouchSlotTableInit(&table);
+        for (size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex) {
+            const INSKInputEvent *event = &events[eventIndex];
+            uintptr_t key = (uintptr_t)event->touchId + 1;
+            uint64_t start = INSKInstrumentationNow();
+
+            result->observerCalls += INSKInputReplayInformObservers(scene, event);
+            if (event->phase == INSKInputPhaseBegan) {
+                INSKInputReplayHitTest hitTest = {scene, event->buttons != 0 ? event->buttons : ~0u, event->x, event->y, NULL};
+                INSKSpatialIndexQueryPoint(index, hitTest.x, hitTest.y, INSKInputReplayVisitNode, &hitTest);
+                if (hitTest.topNode != NULL) {
+                    result->nodeHits++;
+                }
+                // Without a node the scene gets the touch, which is represented by the scene pointer.
+                INSKTouchSlotTableSet(&table, key, hitTest.topNode != NULL ? (void *)hitTest.topNode : (void *)scene, NULL);
+            } else if (event->phase == INSKInputPhaseMoved) {
+                INSKTouchSlotTableGet(&table, key);
+            } else {
+                INSKTouchSlotTableRemove(&table, key);
+            }
+
+            latencies[latencyCount++] = INSKInstrumentationNow() - start;
+        }
+    }
+
+    if (success) {
+        qsort(latencies, latencyCount, sizeof(uint64_t), INSKInputReplayCompareLatencies);
+        double sum = 0.0;
+        for (size_t latencyIndex = 0; latencyIndex < latencyCount; ++latencyIndex) {
+            sum += (double)latencies[latencyIndex];
+        }
+        result->eventCount = latencyCount;
+        result->p50 = (double)latencies[(latencyCount - 1) * 50 / 100];
+        result->p99 = (double)latencies[(latencyCount - 1) * 99 / 100];
+        result->max = (double)latencies[latencyCount - 1];
+        result->mean = sum / (double)latencyCount;
+    }
+
+    free(latencies);
+    INSKSpatialIndexDestroy(index);
+    return success;
+}
+
+void INSKInputReplayFillRandomNodes(INSKInputReplayNode *nodes, size_t count, INSKSpatialBounds worldBounds, unsigned int seed) {
+    uint32_t state = seed != 0 ? seed : 1;
+    double width = worldBounds.maxX - worldBounds.minX;
+    double height = worldBounds.maxY - worldBounds.minY;
+    for (size_t index = 0; index < count; ++index) {
+        INSKInputReplayNode *node = &nodes[index];
+        // Mostly small nodes like buttons and sprites, some bigger ones like backgrounds.
+        double maxSize = (INSKInputReplayRandom(&state) % 20 == 0) ? 0.5 : 0.05;
+        double nodeWidth = INSKInputReplayRandomInRange(&state, 0.01, maxSize) * width;
+        double nodeHeight = INSKInputReplayRandomInRange(&state, 0.01, maxSize) * height;
+        double x = INSKInputReplayRandomInRange(&state, worldBounds.minX, worldBounds.maxX - nodeWidth);
+        double y = INSKInputReplayRandomInRange(&state, worldBounds.minY, worldBounds.maxY - nodeHeight);
+        node->bounds.minX = x;
+        node->bounds.minY = y;
+        node->bounds.maxX = x + nodeWidth;
+        node->bounds.maxY = y + nodeHeight;
+        node->touchPriority = (INSKInputReplayRandom(&state) % 50 == 0) ? 1 : 0;
+        node->zPosition = (INSKInputReplayRandom(&state) % 10 == 0) ? (double)(INSKInputReplayRandom(&state) % 4) : 0.0;
+        node->treeOrder = index;
+        node->interacting = INSKInputReplayRandom(&state) % 10 != 0;
+        node->supportedMouseButtons = ~0u;
+    }
+}
+
+bool INSKInputReplayAppendRandomTouches(INSKInputRecording *recording, size_t touchCount, INSKSpatialBounds worldBounds, unsigned int seed) {
+    uint32_t state = seed != 0 ? seed : 1;
+    double timestamp = 0.0;
+    uint32_t touchId = 1;
+    size_t touchesAdded = 0;
+    while (touchesAdded < touchCount) {
+        // A group of touches at the same time, which begin one after another, move together and end one after another.
+        size_t groupSize = 1 + INSKInputReplayRandom(&state) % 5;
+        if (groupSize > touchCount - touchesAdded) {
+            groupSize = touchCount - touchesAdded;
+        }
+        INSKInputEvent group[5];
+        for (size_t member = 0; member < groupSize; ++member) {
+            INSKInputEvent *event = &group[member];
+            event->timestamp = timestamp;
+            event->x = (float)INSKInputReplayRandomInRange(&state, worldBounds.minX, worldBounds.maxX);
+            event->y = (float)INSKInputReplayRandomInRange(&state, worldBounds.minY, worldBounds.maxY);
+            event->touchId = touchId++;
+            event->phase = INSKInputPhaseBegan;
+            event->buttons = 0;
+            if (!INSKInputRecordingAppend(recording, event)) {
+                return false;
+            }
+        }
+        size_t moves = 2 + INSKInputReplayRandom(&state) % 8;
+        for (size_t move = 0; move < moves; ++move) {
+            timestamp += 1.0 / 120.0;
+            for (size_t member = 0; member < groupSize; ++member) {
+                INSKInputEvent *event = &group[member];
+                event->timestamp = timestamp;
+                event->x += (float)INSKInputReplayRandomInRange(&state, -4.0, 4.0);
+                event->y += (float)INSKInputReplayRandomInRange(&state, -4.0, 4.0);
+                event->phase = INSKInputPhaseMoved;
+                if (!INSKInputRecordingAppend(recording, event)) {
+                    return false;
+                }
+            }
+        }
+        timestamp += 1.0 / 120.0;
+        for (size_t member = 0; member < groupSize; ++member) {
+            INSKInputEvent *event = &group[member];
+            event->timestamp = timestamp;
+            event->phase = (INSKInputReplayRandom(&state) % 20 == 0) ? INSKInputPhaseCancelled : INSKInputPhaseEnded;
+            if (!INSKInputRecordingAppend(recording, event)) {
+                return false;
+            }
+        }
+        timestamp += 0.25;
+        touchesAdded += groupSize;
+    }
+    return true;
+}
@@ -0,0 +1,150 @@
+// INSKInputReplay.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_INPUT_REPLAY_H
+#define INSK_INPUT_REPLAY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "INSKInputRecording.h"
+#include "INSKSpatialIndex.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ A node of a synthetic scene for replaying recorded events.
+ */
+typedef struct {
+    /// The frame of the node in the scene's coordinate system.
+    INSKSpatialBounds bounds;
+    /// The touch priority of the node.
+    long touchPriority;
+    /// The zPosition of the node.
+    double zPosition;
+    /// The position in the rendering order, nodes with a higher value are rendered later.
+    size_t treeOrder;
+    /// Whether the node receives touches, i.e. userInteractionEnabled is set and the node is visible.
+    bool interacting;
+    /// The supported mouse buttons as INSKMouseButton value.
+    unsigned int supportedMouseButtons;
+} INSKInputReplayNode;
+
+
+/**
+ A touch observer of a synthetic scene for replaying recorded events.
+ */
+typedef struct {
+    /// The phases the observer is interested in as INSKInputPhase values.
+    unsigned int phases;
+    /// Whether the observer is only interested in events inside of the region.
+    bool hasRegion;
+    /// The region in the scene's coordinate system.
+    INSKSpatialBounds region;
+} INSKInputReplayObserver;
+
+
+/**
+ A synthetic scene the events are replayed against.
+ */
+typedef struct {
+    const INSKInputReplayNode *nodes;
+    size_t nodeCount;
+    const INSKInputReplayObserver *observers;
+    size_t observerCount;
+} INSKInputReplayScene;
+
+
+/**
+ The results of a replay. All times are in nanoseconds per event.
+ */
+typedef struct {
+    /// The number of events replayed, which is the number of events in the recording times the iterations.
+    size_t eventCount;
+    /// The median of the latencies.
+    double p50;
+    /// The 99th percentile of the latencies.
+    double p99;
+    /// The highest latency.
+    double max;
+    /// The average latency.
+    double mean;
+    /// The number of began events which found a node, the others are delivered to the scene.
+    size_t nodeHits;
+    /// The number of calls to observers.
+    size_t observerCalls;
+} INSKInputReplayResult;
+
+
+/**
+ Replays recorded events against a synthetic scene and measures the latency of each event.
+
+ This is a headless model of INSKView's touch delivery which runs on any platform, so recordings made on a device can be used as benchmarks everywhere.
+ For each event the interested observers are determined, for a began event the top interacting node is searched with a INSKSpatialIndex
+ and stored in a INSKTouchSlotTable, for all other events the node is looked up in or removed from the table.
+ The rules for finding the top node are the same as those of INSKView: highest touch priority first, then highest zPosition, then the last rendered node.
+
+ @param scene The synthetic scene.
+ @param recording The events to replay.
+ @param iterations The number of times the recording should be replayed, at least 1.
+ @param result Receives the results.
+ @return False if the memory couldn't be allocated.
+ */
+bool INSKInputReplayRun(const INSKInputReplayScene *scene, const INSKInputRecording *recording, unsigned int iterations, INSKInputReplayResult *result);
+
+/**
+ Fills a list of nodes with random frames inside of the world bounds for a synthetic scene.
+
+ The same seed results in the same nodes on all platforms.
+ About a tenth of the nodes is not interacting, some have a zPosition or touchPriority set and the rendering order is the order in the list.
+
+ @param nodes The nodes to fill.
+ @param count The number of nodes.
+ @param worldBounds The area where the nodes are placed in.
+ @param seed The seed for the random numbers.
+ */
+void INSKInputReplayFillRandomNodes(INSKInputReplayNode *nodes, size_t count, INSKSpatialBounds worldBounds, unsigned int seed);
+
+/**
+ Adds random touches to a recording, i.e. for benchmarking without a recorded session.
+
+ Each touch begins, moves a few times and ends, up to five touches overlap.
+ The same seed results in the same events on all platforms.
+
+ @param recording The recording to add the events to.
+ @param touchCount The number of touches to add.
+ @param worldBounds The area where the touches are placed in.
+ @param seed The seed for the random numbers.
+ @return False if the memory couldn't be allocated.
+ */
+bool INSKInputReplayAppendRandomTouches(INSKInputRecording *recording, size_t touchCount, INSKSpatialBounds worldBounds, unsigned int seed);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
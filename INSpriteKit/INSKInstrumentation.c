@@ -0,0 +1,166 @@
+// INSKInstrumentation.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKInstrumentation.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+
+// The names of the stages in the JSON output.
+static const char *const INSKInstrumentationStageNames[INSKInstrumentationStageCount] = {"sceneQuery", "filtering", "orderResolution", "delivery"};
+
+// The global histograms.
+static INSKInstrumentationSnapshot INSKInstrumentationHistograms;
+
+
+#pragma mark - private functions
+
+// Returns the bucket of a sample, which is the index of the highest set bit.
+static unsigned int INSKInstrumentationBucket(uint64_t nanoseconds) {
+    unsigned int bucket = 0;
+    while (nanoseconds > 1 && bucket < INSKInstrumentationBucketCount - 1) {
+        nanoseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// Appends formatted text to the buffer like snprintf() and keeps track of the whole length.
+static void INSKInstrumentationAppend(char *buffer, size_t size, size_t *length, const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    char *position = (*length < size) ? buffer + *length : NULL;
+    size_t remaining = (*length < size) ? size - *length : 0;
+    int written = vsnprintf(position, remaining, format, arguments);
+    va_end(arguments);
+    if (written > 0) {
+        *length += (size_t)written;
+    }
+}
+
+
+#pragma mark - public functions
+
+uint64_t INSKInstrumentationNow(void) {
+#if defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+#endif
+}
+
+void INSKInstrumentationRecord(INSKInstrumentationStage stage, uint64_t nanoseconds) {
+    if ((unsigned int)stage >= INSKInstrumentationStageCount) {
+        return;
+    }
+    INSKInstrumentationHistogram *histogram = &INSKInstrumentationHistograms.stages[stage];
+    __sync_fetch_and_add(&histogram->count, 1);
+    __sync_fetch_and_add(&histogram->sum, nanoseconds);
+    __sync_fetch_and_add(&histogram->buckets[INSKInstrumentationBucket(nanoseconds)], 1);
+    uint64_t max = histogram->max;
+    while (nanoseconds > max) {
+        uint64_t previous = __sync_val_compare_and_swap(&histogram->max, max, nanoseconds);
+        if (previous == max) {
+            break;
+        }
+        max = previous;
+    }
+}
+
+void INSKInstrumentationGetSnapshot(INSKInstrumentationSnapshot *snapshot) {
+    for (unsigned int stage = 0; stage < INSKInstrumentationStageCount; ++stage) {
+        INSKInstrumentationHistogram *source = &INSKInstrumentationHistograms.stages[stage];
+        INSKInstrumentationHistogram *histogram = &snapshot->stages[stage];
+        histogram->count = __sync_fetch_and_add(&source->count, 0);
+        histogram->sum = __sync_fetch_and_add(&source->sum, 0);
+        histogram->max = __sync_fetch_and_add(&source->max, 0);
+        for (unsigned int bucket = 0; bucket < INSKInstrumentationBucketCount; ++bucket) {
+            histogram->buckets[bucket] = __sync_fetch_and_add(&source->buckets[bucket], 0);
+        }
+    }
+}
+
+void INSKInstrumentationReset(void) {
+    for (unsigned int stage = 0; stage < INSKInstrumentationStageCount; ++stage) {
+        INSKInstrumentationHistogram *histogram = &INSKInstrumentationHistograms.stages[stage];
+        __sync_lock_test_and_set(&histogram->count, 0);
+        __sync_lock_test_and_set(&histogram->sum, 0);
+        __sync_lock_test_and_set(&histogram->max, 0);
+        for (unsigned int bucket = 0; bucket < INSKInstrumentationBucketCount; ++bucket) {
+            __sync_lock_test_and_set(&histogram->buckets[bucket], 0);
+        }
+    }
+}
+
+uint64_t INSKInstrumentationHistogramPercentile(const INSKInstrumentationHistogram *histogram, double percentile) {
+    uint64_t count = 0;
+    for (unsigned int bucket = 0; bucket < INSKInstrumentationBucketCount; ++bucket) {
+        count += histogram->buckets[bucket];
+    }
+    if (count == 0) {
+        return 0;
+    }
+    // The rank of the sample, at least the first one.
+    double rank = percentile / 100.0 * (double)count;
+    uint64_t samples = 0;
+    for (unsigned int bucket = 0; bucket < INSKInstrumentationBucketCount; ++bucket) {
+        samples += histogram->buckets[bucket];
+        if (samples > 0 && (double)samples >= rank) {
+            uint64_t upperBound = ((uint64_t)2 << bucket) - 1;
+            return upperBound < histogram->max ? upperBound : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+size_t INSKInstrumentationSnapshotWriteJSON(const INSKInstrumentationSnapshot *snapshot, char *buffer, size_t size) {
+    size_t length = 0;
+    INSKInstrumentationAppend(buffer, size, &length, "{");
+    for (unsigned int stage = 0; stage < INSKInstrumentationStageCount; ++stage) {
+        const INSKInstrumentationHistogram *histogram = &snapshot->stages[stage];
+        INSKInstrumentationAppend(buffer, size, &length, "%s\"%s\":{\"count\":%llu,\"sum\":%llu,\"max\":%llu,\"p50\":%llu,\"p99\":%llu,\"buckets\":[",
+                                  stage > 0 ? "," : "", INSKInstrumentationStageNames[stage],
+                                  (unsigned long long)histogram->count, (unsigned long long)histogram->sum, (unsigned long long)histogram->max,
+                                  (unsigned long long)INSKInstrumentationHistogramPercentile(histogram, 50.0),
+                                  (unsigned long long)INSKInstrumentationHistogramPercentile(histogram, 99.0));
+        for (unsigned int bucket = 0; bucket < INSKInstrumentationBucketCount; ++bucket) {
+            INSKInstrumentationAppend(buffer, size, &length, "%s%llu", bucket > 0 ? "," : "", (unsigned long long)histogram->buckets[bucket]);
+        }
+        INSKInstrumentationAppend(buffer, size, &length, "]}");
+    }
+    INSKInstrumentationAppend(buffer, size, &length, "}");
+    return length;
+}
@@ -0,0 +1,178 @@
+// INSKInstrumentation.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_INSTRUMENTATION_H
+#define INSK_INSTRUMENTATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ The stages of the touch delivery of INSKView which are measured.
+ */
+typedef enum {
+    /// Asking the scene or the hit test index for the nodes at a position.
+    INSKInstrumentationStageSceneQuery = 0,
+    /// Checking the found nodes for their interaction state and whether the position is inside of a sprite's texture.
+    INSKInstrumentationStageFiltering,
+    /// Comparing the touch priority, zPosition and tree order of the nodes.
+    INSKInstrumentationStageOrderResolution,
+    /// Calling the touch or mouse methods of the observers and nodes.
+    INSKInstrumentationStageDelivery,
+    /// The number of stages.
+    INSKInstrumentationStageCount
+} INSKInstrumentationStage;
+
+
+/**
+ The number of buckets of a histogram, bucket i counts the samples from 2^i to 2^(i+1)-1 nanoseconds, bucket 0 also those of 0 nanoseconds.
+ */
+#define INSKInstrumentationBucketCount 40
+
+
+/**
+ A histogram of the time spent in a stage.
+ */
+typedef struct {
+    /// The number of samples.
+    uint64_t count;
+    /// The sum of all samples in nanoseconds.
+    uint64_t sum;
+    /// The highest sample in nanoseconds.
+    uint64_t max;
+    /// The number of samples per power of two nanoseconds, the last bucket also counts all bigger samples.
+    uint64_t buckets[INSKInstrumentationBucketCount];
+} INSKInstrumentationHistogram;
+
+
+/**
+ A copy of the histograms of all stages.
+ */
+typedef struct {
+    INSKInstrumentationHistogram stages[INSKInstrumentationStageCount];
+} INSKInstrumentationSnapshot;
+
+
+/**
+ Measures a statement and adds the time spent as a sample to the histogram of a stage.
+
+ INSKView uses these macros for measuring its touch delivery.
+ The measuring is only compiled in when INSK_INSTRUMENTATION is defined to 1 for the library, i.e. with the preprocessor flag -DINSK_INSTRUMENTATION=1.
+ Otherwise the macros expand to the statements alone, so there is no overhead at all.
+ The statements must not contain break or continue, because they are wrapped in a do-while block.
+ */
+#if INSK_INSTRUMENTATION
+#define INSK_INSTRUMENT(stage, ...) do { \
+        uint64_t inskInstrumentationStart = INSKInstrumentationNow(); \
+        __VA_ARGS__; \
+        INSKInstrumentationRecord((stage), INSKInstrumentationNow() - inskInstrumentationStart); \
+    } while (0)
+#else
+#define INSK_INSTRUMENT(stage, ...) do { __VA_ARGS__; } while (0)
+#endif
+
+/**
+ Declares a local variable which sums up the time spent in several statements with INSK_INSTRUMENT_ACCUMULATE().
+
+ Use INSK_INSTRUMENT_RECORD() to add the sum as a single sample, i.e. for measuring a loop per event instead of per iteration.
+ */
+#if INSK_INSTRUMENTATION
+#define INSK_INSTRUMENT_ACCUMULATOR(name) uint64_t name = 0
+#define INSK_INSTRUMENT_ACCUMULATE(name, ...) do { \
+        uint64_t inskInstrumentationStart = INSKInstrumentationNow(); \
+        __VA_ARGS__; \
+        name += INSKInstrumentationNow() - inskInstrumentationStart; \
+    } while (0)
+#define INSK_INSTRUMENT_RECORD(stage, name) INSKInstrumentationRecord((stage), (name))
+#else
+#define INSK_INSTRUMENT_ACCUMULATOR(name) do {} while (0)
+#define INSK_INSTRUMENT_ACCUMULATE(name, ...) do { __VA_ARGS__; } while (0)
+#define INSK_INSTRUMENT_RECORD(stage, name) do {} while (0)
+#endif
+
+
+/**
+ Returns a monotonic time stamp in nanoseconds.
+
+ @return The current time stamp.
+ */
+uint64_t INSKInstrumentationNow(void);
+
+/**
+ Adds a sample to the histogram of a stage.
+
+ The histograms are global and updated with atomic operations, so samples may be added from any thread without locks.
+
+ @param stage The stage.
+ @param nanoseconds The time spent.
+ */
+void INSKInstrumentationRecord(INSKInstrumentationStage stage, uint64_t nanoseconds);
+
+/**
+ Copies the current histograms of all stages.
+
+ Samples added while copying may be only partially included.
+
+ @param snapshot Receives the histograms.
+ */
+void INSKInstrumentationGetSnapshot(INSKInstrumentationSnapshot *snapshot);
+
+/**
+ Removes all samples from the histograms.
+ */
+void INSKInstrumentationReset(void);
+
+/**
+ Returns an estimated percentile of a histogram.
+
+ @param histogram The histogram.
+ @param percentile The percentile between 0 and 100, i.e. 99 for the p99 value.
+ @return The upper bound of the bucket which contains the percentile in nanoseconds or 0 if the histogram is empty.
+ */
+uint64_t INSKInstrumentationHistogramPercentile(const INSKInstrumentationHistogram *histogram, double percentile);
+
+/**
+ Writes the histograms of a snapshot as a JSON object into a buffer.
+
+ The object has a key for each stage (sceneQuery, filtering, orderResolution, delivery) with the count, sum, max, p50 and p99 values and the buckets.
+ The string is always null terminated and truncated if the buffer is too small.
+
+ @param snapshot The snapshot.
+ @param buffer The buffer which receives the string, may be NULL if size is 0.
+ @param size The size of the buffer.
+ @return The length of the whole JSON string without the terminating null, like snprintf().
+ */
+size_t INSKInstrumentationSnapshotWriteJSON(const INSKInstrumentationSnapshot *snapshot, char *buffer, size_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
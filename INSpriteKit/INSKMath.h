@@ -21,7 +21,92 @@
 // THE SOFTWARE.
 
 
-#import <GLKit/GLKMath.h>
+#ifndef INSK_MATH_H
+#define INSK_MATH_H
+
+// The functions are plain C and don't depend on GLKit, so the header can be used on any platform.
+// On other platforms than Apple's the few Core Graphics types used are defined here.
+#ifdef __cplusplus
+#include <cmath>
+#endif
+
+#if defined(__APPLE__)
+#include <CoreGraphics/CoreGraphics.h>
+#include <objc/objc.h>
+#if !defined(INSK_MATH_NO_GLKIT)
+#include <GLKit/GLKMath.h>
+#endif
+#else
+#include <math.h>
+#include <float.h>
+#include <stdbool.h>
+
+// CGFloat is a double like on Apple's 64 bit platforms, define INSK_MATH_CGFLOAT_IS_FLOAT for a float like on the 32 bit ones.
+#if defined(INSK_MATH_CGFLOAT_IS_FLOAT)
+typedef float CGFloat;
+#define CGFLOAT_IS_DOUBLE 0
+#else
+typedef double CGFloat;
+#define CGFLOAT_IS_DOUBLE 1
+#endif
+
+typedef struct {
+    CGFloat x;
+    CGFloat y;
+} CGPoint;
+
+typedef struct {
+    CGFloat width;
+    CGFloat height;
+} CGSize;
+
+typedef struct {
+    CGFloat dx;
+    CGFloat dy;
+} CGVector;
+
+typedef struct {
+    CGPoint origin;
+    CGSize size;
+} CGRect;
+
+typedef bool BOOL;
+#define YES true
+#define NO false
+
+static inline CGPoint CGPointMake(CGFloat x, CGFloat y) {
+    CGPoint point = {x, y};
+    return point;
+}
+
+static inline CGSize CGSizeMake(CGFloat width, CGFloat height) {
+    CGSize size = {width, height};
+    return size;
+}
+
+static inline CGVector CGVectorMake(CGFloat dx, CGFloat dy) {
+    CGVector vector = {dx, dy};
+    return vector;
+}
+
+static inline CGRect CGRectMake(CGFloat x, CGFloat y, CGFloat width, CGFloat height) {
+    CGRect rect = {{x, y}, {width, height}};
+    return rect;
+}
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#define M_PI_2 1.57079632679489661923132169163975144
+#define M_PI_4 0.785398163397448309615660845819875721
+#endif
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
 
 
 // ------------------------------------------------------------
@@ -103,6 +188,7 @@ static inline CGVector CGVectorFromCGPoint(CGPoint point) {
     return CGVectorMake(point.x, point.y);
 }
 
+#if defined(__APPLE__) && !defined(INSK_MATH_NO_GLKIT)
 /**
  Converts a GLKVector2 into a CGPoint.
  
@@ -122,6 +208,7 @@ static inline CGPoint CGPointFromGLKVector2(GLKVector2 vector) {
 static inline GLKVector2 GLKVector2FromCGPoint(CGPoint point) {
     return GLKVector2Make(point.x, point.y);
 }
+#endif
 
 
 // ------------------------------------------------------------
@@ -195,7 +282,7 @@ static inline CGFloat ScalarSign(CGFloat value) {
  @return A new point.
  */
 static inline CGPoint CGPointOffset(CGPoint point, CGFloat dx, CGFloat dy) {
-    return CGPointFromGLKVector2(GLKVector2Add(GLKVector2FromCGPoint(point), GLKVector2Make(dx, dy)));
+    return CGPointMake(point.x + dx, point.y + dy);
 }
 
 /**
@@ -206,7 +293,7 @@ static inline CGPoint CGPointOffset(CGPoint point, CGFloat dx, CGFloat dy) {
  @return A new point.
  */
 static inline CGPoint CGPointAdd(CGPoint point1, CGPoint point2) {
-    return CGPointFromGLKVector2(GLKVector2Add(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2)));
+    return CGPointMake(point1.x + point2.x, point1.y + point2.y);
 }
 
 /**
@@ -217,7 +304,7 @@ static inline CGPoint CGPointAdd(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGPoint CGPointSubtract(CGPoint point1, CGPoint point2) {
-    return CGPointFromGLKVector2(GLKVector2Subtract(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2)));
+    return CGPointMake(point1.x - point2.x, point1.y - point2.y);
 }
 
 /**
@@ -228,7 +315,7 @@ static inline CGPoint CGPointSubtract(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGPoint CGPointMultiply(CGPoint point1, CGPoint point2) {
-    return CGPointFromGLKVector2(GLKVector2Multiply(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2)));
+    return CGPointMake(point1.x * point2.x, point1.y * point2.y);
 }
 
 /**
@@ -239,7 +326,7 @@ static inline CGPoint CGPointMultiply(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGPoint CGPointMultiplyScalar(CGPoint point, CGFloat value) {
-    return CGPointFromGLKVector2(GLKVector2MultiplyScalar(GLKVector2FromCGPoint(point), value));
+    return CGPointMake(point.x * value, point.y * value);
 }
 
 /**
@@ -250,7 +337,7 @@ static inline CGPoint CGPointMultiplyScalar(CGPoint point, CGFloat value) {
  @return A new point.
  */
 static inline CGPoint CGPointDivide(CGPoint point1, CGPoint point2) {
-    return CGPointFromGLKVector2(GLKVector2Divide(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2)));
+    return CGPointMake(point1.x / point2.x, point1.y / point2.y);
 }
 
 /**
@@ -261,7 +348,7 @@ static inline CGPoint CGPointDivide(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGPoint CGPointDivideScalar(CGPoint point, CGFloat value) {
-    return CGPointFromGLKVector2(GLKVector2DivideScalar(GLKVector2FromCGPoint(point), value));
+    return CGPointMake(point.x / value, point.y / value);
 }
 
 /**
@@ -271,7 +358,7 @@ static inline CGPoint CGPointDivideScalar(CGPoint point, CGFloat value) {
  @return The length scalar.
  */
 static inline CGFloat CGPointLength(CGPoint point) {
-    return GLKVector2Length(GLKVector2FromCGPoint(point));
+    return sqrt(point.x * point.x + point.y * point.y);
 }
 
 /**
@@ -281,8 +368,7 @@ static inline CGFloat CGPointLength(CGPoint point) {
  @return The squared length.
  */
 static inline CGFloat CGPointLengthSq(CGPoint point) {
-    GLKVector2 vector = GLKVector2FromCGPoint(point);
-	return GLKVector2DotProduct(vector, vector);
+    return point.x * point.x + point.y * point.y;
 }
 
 /**
@@ -292,7 +378,8 @@ static inline CGFloat CGPointLengthSq(CGPoint point) {
  @return A new point.
  */
 static inline CGPoint CGPointNormalize(CGPoint point) {
-    return CGPointFromGLKVector2(GLKVector2Normalize(GLKVector2FromCGPoint(point)));
+    CGFloat length = sqrt(point.x * point.x + point.y * point.y);
+    return CGPointMake(point.x / length, point.y / length);
 }
 
 /**
@@ -303,7 +390,9 @@ static inline CGPoint CGPointNormalize(CGPoint point) {
  @return A new point.
  */
 static inline CGFloat CGPointDistance(CGPoint point1, CGPoint point2) {
-    return GLKVector2Distance(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2));
+    CGFloat dx = point1.x - point2.x;
+    CGFloat dy = point1.y - point2.y;
+    return sqrt(dx * dx + dy * dy);
 }
 
 /**
@@ -314,7 +403,9 @@ static inline CGFloat CGPointDistance(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGFloat CGPointDistanceSq(CGPoint point1, CGPoint point2) {
-	return CGPointLengthSq(CGPointSubtract(point1, point2));
+    CGFloat dx = point1.x - point2.x;
+    CGFloat dy = point1.y - point2.y;
+    return dx * dx + dy * dy;
 }
 
 /**
@@ -324,7 +415,7 @@ static inline CGFloat CGPointDistanceSq(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGPoint CGPointNegate(CGPoint point) {
-    return CGPointFromGLKVector2(GLKVector2Negate(GLKVector2FromCGPoint(point)));
+    return CGPointMake(-point.x, -point.y);
 }
 
 /**
@@ -337,7 +428,7 @@ static inline CGPoint CGPointNegate(CGPoint point) {
  @return A new point.
  */
 static inline CGPoint CGPointLerp(CGPoint point1, CGPoint point2, CGFloat t) {
-    return CGPointFromGLKVector2(GLKVector2Lerp(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2), t));
+    return CGPointMake(point1.x + (point2.x - point1.x) * t, point1.y + (point2.y - point1.y) * t);
 }
 
 /**
@@ -348,7 +439,7 @@ static inline CGPoint CGPointLerp(CGPoint point1, CGPoint point2, CGFloat t) {
  @return A new point.
  */
 static inline CGFloat CGPointDotProduct(CGPoint point1, CGPoint point2) {
-    return GLKVector2DotProduct(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2));
+    return point1.x * point2.x + point1.y * point2.y;
 }
 
 /**
@@ -370,7 +461,8 @@ static inline CGFloat CGPointCrossProduct(CGPoint point1, CGPoint point2) {
  @return A new point.
  */
 static inline CGPoint CGPointProject(CGPoint point1, CGPoint point2) {
-    return CGPointFromGLKVector2(GLKVector2Project(GLKVector2FromCGPoint(point1), GLKVector2FromCGPoint(point2)));
+    CGFloat scale = (point1.x * point2.x + point1.y * point2.y) / (point2.x * point2.x + point2.y * point2.y);
+    return CGPointMake(point2.x * scale, point2.y * scale);
 }
 
 /**
@@ -394,8 +486,7 @@ static inline CGPoint CGPointClamp(CGPoint point, CGPoint min, CGPoint max) {
  @return A new point.
  */
 static inline CGPoint CGPointNormalizedInRect(CGPoint point, CGRect rect) {
-    GLKVector2 relativePoint = GLKVector2Subtract(GLKVector2FromCGPoint(point), GLKVector2FromCGPoint(rect.origin));
-    return CGPointFromGLKVector2(GLKVector2Divide(relativePoint, GLKVector2Make(rect.size.width, rect.size.height)));
+    return CGPointMake((point.x - rect.origin.x) / rect.size.width, (point.y - rect.origin.y) / rect.size.height);
 }
 
 /**
@@ -406,7 +497,7 @@ static inline CGPoint CGPointNormalizedInRect(CGPoint point, CGRect rect) {
  @return A new point.
  */
 static inline CGPoint CGPointNormalizedInSize(CGPoint point, CGSize size) {
-    return CGPointFromGLKVector2(GLKVector2Divide(GLKVector2FromCGPoint(point), GLKVector2Make(size.width, size.height)));
+    return CGPointMake(point.x / size.width, point.y / size.height);
 }
 
 /**
@@ -549,33 +640,37 @@ static inline CGFloat CGPointToAngle(CGPoint point) {
 /**
  Wraps a radian angle around so it stays in the range of 0 to 2 * M_PI.
  
- @param angle An angle in radians from -M_PI to M_PI.
+ The angle is wrapped in constant time with fmod(), which is exact, so angles accumulated by long running rotations don't drift.
+ For angles from -M_PI to M_PI the result is the same as adding 2*M_PI to negative angles.
+ 
+ @param angle An angle in radians, usually from -M_PI to M_PI, but any finite angle is wrapped.
  @return The angle in radians from 0 to 2*M_PI.
  */
 static inline CGFloat AngleIn2Pi(CGFloat angle) {
-    while (angle >= M_PI_X_2) {
-        angle -= M_PI_X_2;
-    }
-    while (angle < 0.0) {
-        angle += M_PI_X_2;
+    CGFloat wrapped = fmod(angle, M_PI_X_2);
+    if (wrapped < 0.0) {
+        wrapped += M_PI_X_2;
     }
-    return angle;
+    return wrapped;
 }
     
 /**
  Wraps a radian angle around so it stays in the range of -M_PI to M_PI.
  
- @param angle An angle in radians from 0 to 2*M_PI.
+ The angle is wrapped in constant time with fmod(), which is exact, so angles accumulated by long running rotations don't drift.
+ For angles from 0 to 2*M_PI the result is the same as subtracting 2*M_PI from angles of M_PI and above.
+ 
+ @param angle An angle in radians, usually from 0 to 2*M_PI, but any finite angle is wrapped.
  @return The angle in radians from -M_PI to M_PI.
  */
 static inline CGFloat AngleInPi(CGFloat angle) {
-    while (angle >= M_PI) {
-        angle -= M_PI_X_2;
-    }
-    while (angle < -M_PI) {
-        angle += M_PI_X_2;
+    CGFloat wrapped = fmod(angle, M_PI_X_2);
+    if (wrapped >= M_PI) {
+        wrapped -= M_PI_X_2;
+    } else if (wrapped < -M_PI) {
+        wrapped += M_PI_X_2;
     }
-    return angle;
+    return wrapped;
 }
     
 /**
@@ -583,6 +678,7 @@ static inline CGFloat AngleInPi(CGFloat angle) {
  
  If the angle1 is smaller than angle2 a negative angle will be returned.
  If angle1 is bigger than angle2 a positive angle will be returned.
+ The difference is wrapped in constant time with fmod(), so the angles may be of any size.
  
  @param angle1 The first angle in radians.
  @parma angle2 The second angle in radians.
@@ -595,17 +691,372 @@ static inline CGFloat ShortestAngleBetween(CGFloat angle1, CGFloat angle2) {
     if (angle2 < 0.0) {
         angle2 += M_PI_X_2;
     }
-    CGFloat angle = angle2 - angle1;
-    while (angle > M_PI) {
+    CGFloat angle = fmod(angle2 - angle1, M_PI_X_2);
+    if (angle > M_PI) {
         angle -= M_PI_X_2;
-    }
-    while (angle < -M_PI) {
+    } else if (angle < -M_PI) {
         angle += M_PI_X_2;
     }
     return angle;
 }
 
 
+
+// ------------------------------------------------------------
+#pragma mark - affine transformations
+// ------------------------------------------------------------
+/// @name affine transformations
+
+/**
+ A 2D affine transformation with the same layout and meaning as CGAffineTransform, but available on all platforms.
+ 
+ A point (x, y) is transformed to (a * x + c * y + tx, b * x + d * y + ty).
+ */
+typedef struct {
+    CGFloat a;
+    CGFloat b;
+    CGFloat c;
+    CGFloat d;
+    CGFloat tx;
+    CGFloat ty;
+} INSKAffineTransform;
+
+/**
+ Creates an affine transformation from its matrix values.
+ 
+ @param a The a value.
+ @param b The b value.
+ @param c The c value.
+ @param d The d value.
+ @param tx The x translation.
+ @param ty The y translation.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformMake(CGFloat a, CGFloat b, CGFloat c, CGFloat d, CGFloat tx, CGFloat ty) {
+    INSKAffineTransform transform = {a, b, c, d, tx, ty};
+    return transform;
+}
+
+/**
+ Returns the identity transformation, which doesn't change any point.
+ 
+ @return The identity transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformMakeIdentity(void) {
+    return INSKAffineTransformMake(1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+}
+
+/**
+ Creates a transformation which moves points.
+ 
+ @param tx The distance to move along the x axis.
+ @param ty The distance to move along the y axis.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformMakeTranslation(CGFloat tx, CGFloat ty) {
+    return INSKAffineTransformMake(1.0, 0.0, 0.0, 1.0, tx, ty);
+}
+
+/**
+ Creates a transformation which rotates points counterclockwise around the origin like zRotation does.
+ 
+ @param angle The angle in radians.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformMakeRotation(CGFloat angle) {
+    CGFloat cosine = cos(angle);
+    CGFloat sine = sin(angle);
+    return INSKAffineTransformMake(cosine, sine, -sine, cosine, 0.0, 0.0);
+}
+
+/**
+ Creates a transformation which scales points relative to the origin.
+ 
+ @param sx The scale factor along the x axis.
+ @param sy The scale factor along the y axis.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformMakeScale(CGFloat sx, CGFloat sy) {
+    return INSKAffineTransformMake(sx, 0.0, 0.0, sy, 0.0, 0.0);
+}
+
+/**
+ Composes two transformations, so the result transforms points first by transform1 and then by transform2 like CGAffineTransformConcat().
+ 
+ @param transform1 The transformation applied first.
+ @param transform2 The transformation applied second.
+ @return The composed transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformConcat(INSKAffineTransform transform1, INSKAffineTransform transform2) {
+    return INSKAffineTransformMake(transform1.a * transform2.a + transform1.b * transform2.c,
+                                   transform1.a * transform2.b + transform1.b * transform2.d,
+                                   transform1.c * transform2.a + transform1.d * transform2.c,
+                                   transform1.c * transform2.b + transform1.d * transform2.d,
+                                   transform1.tx * transform2.a + transform1.ty * transform2.c + transform2.tx,
+                                   transform1.tx * transform2.b + transform1.ty * transform2.d + transform2.ty);
+}
+
+/**
+ Adds a translation which is applied before the transformation like CGAffineTransformTranslate().
+ 
+ @param transform The transformation.
+ @param tx The distance to move along the x axis.
+ @param ty The distance to move along the y axis.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformTranslate(INSKAffineTransform transform, CGFloat tx, CGFloat ty) {
+    return INSKAffineTransformConcat(INSKAffineTransformMakeTranslation(tx, ty), transform);
+}
+
+/**
+ Adds a rotation which is applied before the transformation like CGAffineTransformRotate().
+ 
+ @param transform The transformation.
+ @param angle The angle in radians.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformRotate(INSKAffineTransform transform, CGFloat angle) {
+    return INSKAffineTransformConcat(INSKAffineTransformMakeRotation(angle), transform);
+}
+
+/**
+ Adds a scaling which is applied before the transformation like CGAffineTransformScale().
+ 
+ @param transform The transformation.
+ @param sx The scale factor along the x axis.
+ @param sy The scale factor along the y axis.
+ @return A new transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformScale(INSKAffineTransform transform, CGFloat sx, CGFloat sy) {
+    return INSKAffineTransformConcat(INSKAffineTransformMakeScale(sx, sy), transform);
+}
+
+/**
+ Returns the inverted transformation, which transforms points back.
+ 
+ Like CGAffineTransformInvert() a transformation which can't be inverted, i.e. with a scale of 0, is returned unchanged.
+ 
+ @param transform The transformation.
+ @return The inverted transformation.
+ */
+static inline INSKAffineTransform INSKAffineTransformInvert(INSKAffineTransform transform) {
+    CGFloat determinant = transform.a * transform.d - transform.b * transform.c;
+    if (determinant == 0.0) {
+        return transform;
+    }
+    return INSKAffineTransformMake(transform.d / determinant,
+                                   -transform.b / determinant,
+                                   -transform.c / determinant,
+                                   transform.a / determinant,
+                                   (transform.c * transform.ty - transform.d * transform.tx) / determinant,
+                                   (transform.b * transform.tx - transform.a * transform.ty) / determinant);
+}
+
+/**
+ Returns true if the transformation is the identity transformation.
+ 
+ @param transform The transformation.
+ @return True if the transformation doesn't change points.
+ */
+static inline BOOL INSKAffineTransformIsIdentity(INSKAffineTransform transform) {
+    return transform.a == 1.0 && transform.b == 0.0 && transform.c == 0.0 && transform.d == 1.0 && transform.tx == 0.0 && transform.ty == 0.0;
+}
+
+/**
+ Transforms a point like CGPointApplyAffineTransform().
+ 
+ @param point The point.
+ @param transform The transformation.
+ @return The transformed point.
+ */
+static inline CGPoint CGPointApplyINSKAffineTransform(CGPoint point, INSKAffineTransform transform) {
+    return CGPointMake(transform.a * point.x + transform.c * point.y + transform.tx, transform.b * point.x + transform.d * point.y + transform.ty);
+}
+
+#if defined(__APPLE__)
+/**
+ Converts a CGAffineTransform into an INSKAffineTransform.
+ 
+ @param transform A CGAffineTransform.
+ @return The same transformation as INSKAffineTransform.
+ */
+static inline INSKAffineTransform INSKAffineTransformFromCGAffineTransform(CGAffineTransform transform) {
+    return INSKAffineTransformMake(transform.a, transform.b, transform.c, transform.d, transform.tx, transform.ty);
+}
+
+/**
+ Converts an INSKAffineTransform into a CGAffineTransform.
+ 
+ @param transform An INSKAffineTransform.
+ @return The same transformation as CGAffineTransform.
+ */
+static inline CGAffineTransform CGAffineTransformFromINSKAffineTransform(INSKAffineTransform transform) {
+    return CGAffineTransformMake(transform.a, transform.b, transform.c, transform.d, transform.tx, transform.ty);
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
+
+#ifdef __cplusplus
+
+// ------------------------------------------------------------
+#pragma mark - C++ templates
+// ------------------------------------------------------------
+/// @name C++ templates
+
+/**
+ Templates of the point calculations for C++ which work with float and double points and may be evaluated at compile time.
+ 
+ The C functions above always calculate with CGFloat, these are for code which uses its own vector types or wants to store float vectors to save memory.
+ The functions have the same semantics as their C counterparts without the CGPoint prefix, i.e. INSKMath::Add() is CGPointAdd().
+ */
+namespace INSKMath {
+
+    /**
+     A 2D vector or point with float or double fields.
+     */
+    template <typename T>
+    struct Vector2 {
+        T x;
+        T y;
+    };
+
+    template <typename T>
+    constexpr Vector2<T> Make(T x, T y) {
+        return Vector2<T>{x, y};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> FromCGPoint(CGPoint point) {
+        return Vector2<T>{static_cast<T>(point.x), static_cast<T>(point.y)};
+    }
+
+    template <typename T>
+    inline CGPoint ToCGPoint(Vector2<T> vector) {
+        return CGPointMake(static_cast<CGFloat>(vector.x), static_cast<CGFloat>(vector.y));
+    }
+
+    template <typename T>
+    constexpr T Clamp(T value, T min, T max) {
+        return (value < min) ? min : ((value > max) ? max : value);
+    }
+
+    template <typename T>
+    constexpr T ScalarSign(T value) {
+        return (value >= T(0)) ? T(1) : T(-1);
+    }
+
+    template <typename T>
+    constexpr T DegreesToRadians(T degrees) {
+        return degrees * T(0.01745329251994329547437168059786927);
+    }
+
+    template <typename T>
+    constexpr T RadiansToDegrees(T radians) {
+        return radians * T(57.29577951308232286464772187173366547);
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Offset(Vector2<T> point, T dx, T dy) {
+        return Vector2<T>{point.x + dx, point.y + dy};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Add(Vector2<T> point1, Vector2<T> point2) {
+        return Vector2<T>{point1.x + point2.x, point1.y + point2.y};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Subtract(Vector2<T> point1, Vector2<T> point2) {
+        return Vector2<T>{point1.x - point2.x, point1.y - point2.y};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Multiply(Vector2<T> point1, Vector2<T> point2) {
+        return Vector2<T>{point1.x * point2.x, point1.y * point2.y};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> MultiplyScalar(Vector2<T> point, T value) {
+        return Vector2<T>{point.x * value, point.y * value};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Divide(Vector2<T> point1, Vector2<T> point2) {
+        return Vector2<T>{point1.x / point2.x, point1.y / point2.y};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> DivideScalar(Vector2<T> point, T value) {
+        return Vector2<T>{point.x / value, point.y / value};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Negate(Vector2<T> point) {
+        return Vector2<T>{-point.x, -point.y};
+    }
+
+    template <typename T>
+    constexpr T LengthSq(Vector2<T> point) {
+        return point.x * point.x + point.y * point.y;
+    }
+
+    template <typename T>
+    constexpr T DistanceSq(Vector2<T> point1, Vector2<T> point2) {
+        return (point1.x - point2.x) * (point1.x - point2.x) + (point1.y - point2.y) * (point1.y - point2.y);
+    }
+
+    template <typename T>
+    constexpr T DotProduct(Vector2<T> point1, Vector2<T> point2) {
+        return point1.x * point2.x + point1.y * point2.y;
+    }
+
+    template <typename T>
+    constexpr T CrossProduct(Vector2<T> point1, Vector2<T> point2) {
+        return point1.x * point2.y - point1.y * point2.x;
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Lerp(Vector2<T> point1, Vector2<T> point2, T t) {
+        return Vector2<T>{point1.x + (point2.x - point1.x) * t, point1.y + (point2.y - point1.y) * t};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Project(Vector2<T> point1, Vector2<T> point2) {
+        return MultiplyScalar(point2, DotProduct(point1, point2) / DotProduct(point2, point2));
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Clamp(Vector2<T> point, Vector2<T> min, Vector2<T> max) {
+        return Vector2<T>{Clamp(point.x, min.x, max.x), Clamp(point.y, min.y, max.y)};
+    }
+
+    template <typename T>
+    constexpr bool NearToPointWithVariance(Vector2<T> point1, Vector2<T> point2, T variance) {
+        return point1.x <= point2.x + variance && point1.x >= point2.x - variance && point1.y <= point2.y + variance && point1.y >= point2.y - variance;
+    }
+
+    // sqrt() can't be evaluated at compile time, so the following functions are only inline.
+
+    template <typename T>
+    inline T Length(Vector2<T> point) {
+        return std::sqrt(LengthSq(point));
+    }
+
+    template <typename T>
+    inline T Distance(Vector2<T> point1, Vector2<T> point2) {
+        return std::sqrt(DistanceSq(point1, point2));
+    }
+
+    template <typename T>
+    inline Vector2<T> Normalize(Vector2<T> point) {
+        return DivideScalar(point, Length(point));
+    }
+
+} // namespace INSKMath
+
+#endif
+
+#endif
@@ -0,0 +1,581 @@
+// INSKMathBatch.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKMathBatch.h"
+
+
+// The SIMD paths calculate with doubles, so they are only used where CGFloat is a double.
+#if CGFLOAT_IS_DOUBLE && defined(__AVX__)
+#include <immintrin.h>
+#define INSK_BATCH_AVX 1
+#endif
+#if CGFLOAT_IS_DOUBLE && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define INSK_BATCH_SSE2 1
+#elif CGFLOAT_IS_DOUBLE && defined(__aarch64__)
+#include <arm_neon.h>
+#define INSK_BATCH_NEON 1
+#endif
+
+
+// Whether the SIMD paths should be used if available.
+static bool INSKMathBatchSIMDEnabled = true;
+
+
+#pragma mark - private functions
+
+// A vector of two doubles, which is the widest type available on all SIMD platforms and exactly one CGPoint.
+#if INSK_BATCH_SSE2
+typedef __m128d INSKBatchVector;
+
+static inline INSKBatchVector INSKBatchLoad(const double *values) { return _mm_loadu_pd(values); }
+static inline void INSKBatchStore(double *values, INSKBatchVector vector) { _mm_storeu_pd(values, vector); }
+static inline INSKBatchVector INSKBatchSplat(double value) { return _mm_set1_pd(value); }
+static inline INSKBatchVector INSKBatchMake(double low, double high) { return _mm_set_pd(high, low); }
+static inline INSKBatchVector INSKBatchAdd(INSKBatchVector a, INSKBatchVector b) { return _mm_add_pd(a, b); }
+static inline INSKBatchVector INSKBatchSubtract(INSKBatchVector a, INSKBatchVector b) { return _mm_sub_pd(a, b); }
+static inline INSKBatchVector INSKBatchMultiply(INSKBatchVector a, INSKBatchVector b) { return _mm_mul_pd(a, b); }
+static inline INSKBatchVector INSKBatchDivide(INSKBatchVector a, INSKBatchVector b) { return _mm_div_pd(a, b); }
+static inline INSKBatchVector INSKBatchSqrt(INSKBatchVector a) { return _mm_sqrt_pd(a); }
+// Returns (a.low + a.high, b.low + b.high).
+static inline INSKBatchVector INSKBatchPairwiseAdd(INSKBatchVector a, INSKBatchVector b) { return _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b)); }
+static inline INSKBatchVector INSKBatchSplatLow(INSKBatchVector a) { return _mm_unpacklo_pd(a, a); }
+static inline INSKBatchVector INSKBatchSplatHigh(INSKBatchVector a) { return _mm_unpackhi_pd(a, a); }
+
+// A mask with all bits of a lane set where a comparison is true.
+typedef __m128d INSKBatchMask;
+
+static inline INSKBatchMask INSKBatchLess(INSKBatchVector a, INSKBatchVector b) { return _mm_cmplt_pd(a, b); }
+static inline INSKBatchMask INSKBatchLessEqual(INSKBatchVector a, INSKBatchVector b) { return _mm_cmple_pd(a, b); }
+static inline INSKBatchMask INSKBatchMaskAnd(INSKBatchMask a, INSKBatchMask b) { return _mm_and_pd(a, b); }
+static inline bool INSKBatchMaskAll(INSKBatchMask mask) { return _mm_movemask_pd(mask) == 3; }
+// Returns the lanes of a where the mask is set and those of b otherwise.
+static inline INSKBatchVector INSKBatchSelect(INSKBatchMask mask, INSKBatchVector a, INSKBatchVector b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+#elif INSK_BATCH_NEON
+typedef float64x2_t INSKBatchVector;
+
+static inline INSKBatchVector INSKBatchLoad(const double *values) { return vld1q_f64(values); }
+static inline void INSKBatchStore(double *values, INSKBatchVector vector) { vst1q_f64(values, vector); }
+static inline INSKBatchVector INSKBatchSplat(double value) { return vdupq_n_f64(value); }
+static inline INSKBatchVector INSKBatchMake(double low, double high) { return vcombine_f64(vdup_n_f64(low), vdup_n_f64(high)); }
+static inline INSKBatchVector INSKBatchAdd(INSKBatchVector a, INSKBatchVector b) { return vaddq_f64(a, b); }
+static inline INSKBatchVector INSKBatchSubtract(INSKBatchVector a, INSKBatchVector b) { return vsubq_f64(a, b); }
+static inline INSKBatchVector INSKBatchMultiply(INSKBatchVector a, INSKBatchVector b) { return vmulq_f64(a, b); }
+static inline INSKBatchVector INSKBatchDivide(INSKBatchVector a, INSKBatchVector b) { return vdivq_f64(a, b); }
+static inline INSKBatchVector INSKBatchSqrt(INSKBatchVector a) { return vsqrtq_f64(a); }
+// Returns (a.low + a.high, b.low + b.high).
+static inline INSKBatchVector INSKBatchPairwiseAdd(INSKBatchVector a, INSKBatchVector b) { return vpaddq_f64(a, b); }
+static inline INSKBatchVector INSKBatchSplatLow(INSKBatchVector a) { return vdupq_laneq_f64(a, 0); }
+static inline INSKBatchVector INSKBatchSplatHigh(INSKBatchVector a) { return vdupq_laneq_f64(a, 1); }
+
+// A mask with all bits of a lane set where a comparison is true.
+typedef uint64x2_t INSKBatchMask;
+
+static inline INSKBatchMask INSKBatchLess(INSKBatchVector a, INSKBatchVector b) { return vcltq_f64(a, b); }
+static inline INSKBatchMask INSKBatchLessEqual(INSKBatchVector a, INSKBatchVector b) { return vcleq_f64(a, b); }
+static inline INSKBatchMask INSKBatchMaskAnd(INSKBatchMask a, INSKBatchMask b) { return vandq_u64(a, b); }
+static inline bool INSKBatchMaskAll(INSKBatchMask mask) { return (vgetq_lane_u64(mask, 0) & vgetq_lane_u64(mask, 1)) != 0; }
+// Returns the lanes of a where the mask is set and those of b otherwise.
+static inline INSKBatchVector INSKBatchSelect(INSKBatchMask mask, INSKBatchVector a, INSKBatchVector b) { return vbslq_f64(mask, a, b); }
+#endif
+
+#if INSK_BATCH_SSE2 || INSK_BATCH_NEON
+#define INSK_BATCH_SIMD 1
+#endif
+
+// Returns true if the SIMD paths should be used.
+static inline bool INSKBatchUseSIMD(void) {
+#if INSK_BATCH_SIMD
+    return INSKMathBatchSIMDEnabled;
+#else
+    return false;
+#endif
+}
+
+// Element wise operations on plain arrays of CGFloat, used for both layouts, because they don't care about x and y.
+// The SIMD loops process as many values as possible and return the index of the first value left for the scalar loop.
+
+#if INSK_BATCH_SIMD
+static size_t INSKBatchValuesAddSIMD(CGFloat *destination, const CGFloat *values1, const CGFloat *values2, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_AVX
+    for (; index + 4 <= count; index += 4) {
+        _mm256_storeu_pd(destination + index, _mm256_add_pd(_mm256_loadu_pd(values1 + index), _mm256_loadu_pd(values2 + index)));
+    }
+#endif
+    for (; index + 2 <= count; index += 2) {
+        INSKBatchStore(destination + index, INSKBatchAdd(INSKBatchLoad(values1 + index), INSKBatchLoad(values2 + index)));
+    }
+    return index;
+}
+#endif
+
+static void INSKBatchValuesAdd(CGFloat *destination, const CGFloat *values1, const CGFloat *values2, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        index = INSKBatchValuesAddSIMD(destination, values1, values2, count);
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = values1[index] + values2[index];
+    }
+}
+
+#if INSK_BATCH_SIMD
+static size_t INSKBatchValuesSubtractSIMD(CGFloat *destination, const CGFloat *values1, const CGFloat *values2, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_AVX
+    for (; index + 4 <= count; index += 4) {
+        _mm256_storeu_pd(destination + index, _mm256_sub_pd(_mm256_loadu_pd(values1 + index), _mm256_loadu_pd(values2 + index)));
+    }
+#endif
+    for (; index + 2 <= count; index += 2) {
+        INSKBatchStore(destination + index, INSKBatchSubtract(INSKBatchLoad(values1 + index), INSKBatchLoad(values2 + index)));
+    }
+    return index;
+}
+#endif
+
+static void INSKBatchValuesSubtract(CGFloat *destination, const CGFloat *values1, const CGFloat *values2, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        index = INSKBatchValuesSubtractSIMD(destination, values1, values2, count);
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = values1[index] - values2[index];
+    }
+}
+
+#if INSK_BATCH_SIMD
+static size_t INSKBatchValuesMultiplyScalarSIMD(CGFloat *destination, const CGFloat *values, CGFloat value, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_AVX
+    __m256d factor4 = _mm256_set1_pd(value);
+    for (; index + 4 <= count; index += 4) {
+        _mm256_storeu_pd(destination + index, _mm256_mul_pd(_mm256_loadu_pd(values + index), factor4));
+    }
+#endif
+    INSKBatchVector factor = INSKBatchSplat(value);
+    for (; index + 2 <= count; index += 2) {
+        INSKBatchStore(destination + index, INSKBatchMultiply(INSKBatchLoad(values + index), factor));
+    }
+    return index;
+}
+#endif
+
+static void INSKBatchValuesMultiplyScalar(CGFloat *destination, const CGFloat *values, CGFloat value, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        index = INSKBatchValuesMultiplyScalarSIMD(destination, values, value, count);
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = values[index] * value;
+    }
+}
+
+#if INSK_BATCH_SIMD
+static size_t INSKBatchValuesLerpSIMD(CGFloat *destination, const CGFloat *values1, const CGFloat *values2, CGFloat t, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_AVX
+    __m256d t4 = _mm256_set1_pd(t);
+    for (; index + 4 <= count; index += 4) {
+        __m256d start = _mm256_loadu_pd(values1 + index);
+        __m256d difference = _mm256_sub_pd(_mm256_loadu_pd(values2 + index), start);
+        _mm256_storeu_pd(destination + index, _mm256_add_pd(start, _mm256_mul_pd(difference, t4)));
+    }
+#endif
+    INSKBatchVector t2 = INSKBatchSplat(t);
+    for (; index + 2 <= count; index += 2) {
+        INSKBatchVector start = INSKBatchLoad(values1 + index);
+        INSKBatchVector difference = INSKBatchSubtract(INSKBatchLoad(values2 + index), start);
+        INSKBatchStore(destination + index, INSKBatchAdd(start, INSKBatchMultiply(difference, t2)));
+    }
+    return index;
+}
+#endif
+
+static void INSKBatchValuesLerp(CGFloat *destination, const CGFloat *values1, const CGFloat *values2, CGFloat t, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        index = INSKBatchValuesLerpSIMD(destination, values1, values2, t, count);
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = values1[index] + (values2[index] - values1[index]) * t;
+    }
+}
+
+#if INSK_BATCH_SIMD
+// Returns true if all lanes are between -2*M_PI and 2*M_PI, where fmod() returns the angle unchanged, so a single comparison and addition per lane gives the same result.
+static inline bool INSKBatchAnglesInFmodIdentityRange(INSKBatchVector angles) {
+    return INSKBatchMaskAll(INSKBatchMaskAnd(INSKBatchLess(INSKBatchSplat(-M_PI_X_2), angles), INSKBatchLess(angles, INSKBatchSplat(M_PI_X_2))));
+}
+
+// Adds 2*M_PI to the negative lanes like the scalar angle functions do.
+static inline INSKBatchVector INSKBatchAnglesWrapNegative(INSKBatchVector angles) {
+    return INSKBatchSelect(INSKBatchLess(angles, INSKBatchSplat(0.0)), INSKBatchAdd(angles, INSKBatchSplat(M_PI_X_2)), angles);
+}
+#endif
+
+#if INSK_BATCH_SIMD
+// Composes two transformations like INSKAffineTransformConcat() with the rows (a, b), (c, d) and (tx, ty) as vectors.
+static inline INSKAffineTransform INSKBatchAffineTransformConcatSIMD(INSKAffineTransform transform1, INSKAffineTransform transform2) {
+    INSKBatchVector row1 = INSKBatchLoad(&transform2.a);
+    INSKBatchVector row2 = INSKBatchLoad(&transform2.c);
+    INSKBatchVector row3 = INSKBatchLoad(&transform2.tx);
+    INSKAffineTransform result;
+    INSKBatchStore(&result.a, INSKBatchAdd(INSKBatchMultiply(INSKBatchSplat(transform1.a), row1), INSKBatchMultiply(INSKBatchSplat(transform1.b), row2)));
+    INSKBatchStore(&result.c, INSKBatchAdd(INSKBatchMultiply(INSKBatchSplat(transform1.c), row1), INSKBatchMultiply(INSKBatchSplat(transform1.d), row2)));
+    INSKBatchStore(&result.tx, INSKBatchAdd(INSKBatchAdd(INSKBatchMultiply(INSKBatchSplat(transform1.tx), row1), INSKBatchMultiply(INSKBatchSplat(transform1.ty), row2)), row3));
+    return result;
+}
+#endif
+
+// Composes two transformations with the SIMD implementation if enabled.
+static inline INSKAffineTransform INSKBatchAffineTransformConcat(INSKAffineTransform transform1, INSKAffineTransform transform2) {
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        return INSKBatchAffineTransformConcatSIMD(transform1, transform2);
+    }
+#endif
+    return INSKAffineTransformConcat(transform1, transform2);
+}
+
+
+#pragma mark - public functions
+
+INSKMathBatchImplementation INSKMathBatchGetImplementation(void) {
+    if (!INSKBatchUseSIMD()) {
+        return INSKMathBatchImplementationScalar;
+    }
+#if INSK_BATCH_AVX
+    return INSKMathBatchImplementationAVX;
+#elif INSK_BATCH_SSE2
+    return INSKMathBatchImplementationSSE2;
+#elif INSK_BATCH_NEON
+    return INSKMathBatchImplementationNEON;
+#else
+    return INSKMathBatchImplementationScalar;
+#endif
+}
+
+void INSKMathBatchSetSIMDEnabled(bool enabled) {
+    INSKMathBatchSIMDEnabled = enabled;
+}
+
+// A CGPoint is two CGFloats in a row, so element wise operations can treat an array of points as an array of twice as many values.
+
+void INSKPointsAdd(CGPoint *destination, const CGPoint *points1, const CGPoint *points2, size_t count) {
+    INSKBatchValuesAdd((CGFloat *)destination, (const CGFloat *)points1, (const CGFloat *)points2, count * 2);
+}
+
+void INSKPointsSubtract(CGPoint *destination, const CGPoint *points1, const CGPoint *points2, size_t count) {
+    INSKBatchValuesSubtract((CGFloat *)destination, (const CGFloat *)points1, (const CGFloat *)points2, count * 2);
+}
+
+void INSKPointsMultiplyScalar(CGPoint *destination, const CGPoint *points, CGFloat value, size_t count) {
+    INSKBatchValuesMultiplyScalar((CGFloat *)destination, (const CGFloat *)points, value, count * 2);
+}
+
+void INSKPointsDistanceSq(CGFloat *distances, const CGPoint *points, CGPoint origin, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        // Two points per iteration, each point fills one vector.
+        INSKBatchVector originVector = INSKBatchMake(origin.x, origin.y);
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector difference1 = INSKBatchSubtract(INSKBatchLoad(&points[index].x), originVector);
+            INSKBatchVector difference2 = INSKBatchSubtract(INSKBatchLoad(&points[index + 1].x), originVector);
+            INSKBatchVector sum = INSKBatchPairwiseAdd(INSKBatchMultiply(difference1, difference1), INSKBatchMultiply(difference2, difference2));
+            INSKBatchStore(distances + index, sum);
+        }
+    }
+#endif
+    for (; index < count; ++index) {
+        distances[index] = CGPointDistanceSq(points[index], origin);
+    }
+}
+
+void INSKPointsNormalize(CGPoint *destination, const CGPoint *points, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector point1 = INSKBatchLoad(&points[index].x);
+            INSKBatchVector point2 = INSKBatchLoad(&points[index + 1].x);
+            INSKBatchVector lengths = INSKBatchSqrt(INSKBatchPairwiseAdd(INSKBatchMultiply(point1, point1), INSKBatchMultiply(point2, point2)));
+            INSKBatchStore(&destination[index].x, INSKBatchDivide(point1, INSKBatchSplatLow(lengths)));
+            INSKBatchStore(&destination[index + 1].x, INSKBatchDivide(point2, INSKBatchSplatHigh(lengths)));
+        }
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = CGPointNormalize(points[index]);
+    }
+}
+
+void INSKPointsLerp(CGPoint *destination, const CGPoint *points1, const CGPoint *points2, CGFloat t, size_t count) {
+    INSKBatchValuesLerp((CGFloat *)destination, (const CGFloat *)points1, (const CGFloat *)points2, t, count * 2);
+}
+
+void INSKPointsSoAAdd(INSKPointsSoA destination, INSKPointsSoA points1, INSKPointsSoA points2, size_t count) {
+    INSKBatchValuesAdd(destination.x, points1.x, points2.x, count);
+    INSKBatchValuesAdd(destination.y, points1.y, points2.y, count);
+}
+
+void INSKPointsSoASubtract(INSKPointsSoA destination, INSKPointsSoA points1, INSKPointsSoA points2, size_t count) {
+    INSKBatchValuesSubtract(destination.x, points1.x, points2.x, count);
+    INSKBatchValuesSubtract(destination.y, points1.y, points2.y, count);
+}
+
+void INSKPointsSoAMultiplyScalar(INSKPointsSoA destination, INSKPointsSoA points, CGFloat value, size_t count) {
+    INSKBatchValuesMultiplyScalar(destination.x, points.x, value, count);
+    INSKBatchValuesMultiplyScalar(destination.y, points.y, value, count);
+}
+
+void INSKPointsSoADistanceSq(CGFloat *distances, INSKPointsSoA points, CGPoint origin, size_t count) {
+    size_t index = 0;
+    if (INSKBatchUseSIMD()) {
+#if INSK_BATCH_AVX
+        __m256d originX4 = _mm256_set1_pd(origin.x);
+        __m256d originY4 = _mm256_set1_pd(origin.y);
+        for (; index + 4 <= count; index += 4) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(points.x + index), originX4);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(points.y + index), originY4);
+            _mm256_storeu_pd(distances + index, _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+        }
+#endif
+#if INSK_BATCH_SIMD
+        INSKBatchVector originX = INSKBatchSplat(origin.x);
+        INSKBatchVector originY = INSKBatchSplat(origin.y);
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector dx = INSKBatchSubtract(INSKBatchLoad(points.x + index), originX);
+            INSKBatchVector dy = INSKBatchSubtract(INSKBatchLoad(points.y + index), originY);
+            INSKBatchStore(distances + index, INSKBatchAdd(INSKBatchMultiply(dx, dx), INSKBatchMultiply(dy, dy)));
+        }
+#endif
+    }
+    for (; index < count; ++index) {
+        CGFloat dx = points.x[index] - origin.x;
+        CGFloat dy = points.y[index] - origin.y;
+        distances[index] = dx * dx + dy * dy;
+    }
+}
+
+void INSKPointsSoANormalize(INSKPointsSoA destination, INSKPointsSoA points, size_t count) {
+    size_t index = 0;
+    if (INSKBatchUseSIMD()) {
+#if INSK_BATCH_AVX
+        for (; index + 4 <= count; index += 4) {
+            __m256d x = _mm256_loadu_pd(points.x + index);
+            __m256d y = _mm256_loadu_pd(points.y + index);
+            __m256d length = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)));
+            _mm256_storeu_pd(destination.x + index, _mm256_div_pd(x, length));
+            _mm256_storeu_pd(destination.y + index, _mm256_div_pd(y, length));
+        }
+#endif
+#if INSK_BATCH_SIMD
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector x = INSKBatchLoad(points.x + index);
+            INSKBatchVector y = INSKBatchLoad(points.y + index);
+            INSKBatchVector length = INSKBatchSqrt(INSKBatchAdd(INSKBatchMultiply(x, x), INSKBatchMultiply(y, y)));
+            INSKBatchStore(destination.x + index, INSKBatchDivide(x, length));
+            INSKBatchStore(destination.y + index, INSKBatchDivide(y, length));
+        }
+#endif
+    }
+    for (; index < count; ++index) {
+        CGFloat x = points.x[index];
+        CGFloat y = points.y[index];
+        CGFloat length = sqrt(x * x + y * y);
+        destination.x[index] = x / length;
+        destination.y[index] = y / length;
+    }
+}
+
+void INSKPointsSoALerp(INSKPointsSoA destination, INSKPointsSoA points1, INSKPointsSoA points2, CGFloat t, size_t count) {
+    INSKBatchValuesLerp(destination.x, points1.x, points2.x, t, count);
+    INSKBatchValuesLerp(destination.y, points1.y, points2.y, t, count);
+}
+
+void INSKAnglesIn2Pi(CGFloat *destination, const CGFloat *angles, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector angle = INSKBatchLoad(angles + index);
+            if (INSKBatchAnglesInFmodIdentityRange(angle)) {
+                INSKBatchStore(destination + index, INSKBatchAnglesWrapNegative(angle));
+            } else {
+                destination[index] = AngleIn2Pi(angles[index]);
+                destination[index + 1] = AngleIn2Pi(angles[index + 1]);
+            }
+        }
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = AngleIn2Pi(angles[index]);
+    }
+}
+
+void INSKAnglesInPi(CGFloat *destination, const CGFloat *angles, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        INSKBatchVector pi = INSKBatchSplat(M_PI);
+        INSKBatchVector minusPi = INSKBatchSplat(-M_PI);
+        INSKBatchVector twoPi = INSKBatchSplat(M_PI_X_2);
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector angle = INSKBatchLoad(angles + index);
+            if (INSKBatchAnglesInFmodIdentityRange(angle)) {
+                INSKBatchVector raised = INSKBatchSelect(INSKBatchLess(angle, minusPi), INSKBatchAdd(angle, twoPi), angle);
+                INSKBatchStore(destination + index, INSKBatchSelect(INSKBatchLessEqual(pi, angle), INSKBatchSubtract(angle, twoPi), raised));
+            } else {
+                destination[index] = AngleInPi(angles[index]);
+                destination[index + 1] = AngleInPi(angles[index + 1]);
+            }
+        }
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = AngleInPi(angles[index]);
+    }
+}
+
+void INSKAnglesShortestBetween(CGFloat *destination, const CGFloat *angles1, const CGFloat *angles2, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        INSKBatchVector pi = INSKBatchSplat(M_PI);
+        INSKBatchVector minusPi = INSKBatchSplat(-M_PI);
+        INSKBatchVector twoPi = INSKBatchSplat(M_PI_X_2);
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector angle1 = INSKBatchAnglesWrapNegative(INSKBatchLoad(angles1 + index));
+            INSKBatchVector angle2 = INSKBatchAnglesWrapNegative(INSKBatchLoad(angles2 + index));
+            INSKBatchVector angle = INSKBatchSubtract(angle2, angle1);
+            if (INSKBatchAnglesInFmodIdentityRange(angle)) {
+                INSKBatchVector raised = INSKBatchSelect(INSKBatchLess(angle, minusPi), INSKBatchAdd(angle, twoPi), angle);
+                INSKBatchStore(destination + index, INSKBatchSelect(INSKBatchLess(pi, angle), INSKBatchSubtract(angle, twoPi), raised));
+            } else {
+                // Both results are calculated before storing, because the destination may be one of the sources.
+                CGFloat first = ShortestAngleBetween(angles1[index], angles2[index]);
+                CGFloat second = ShortestAngleBetween(angles1[index + 1], angles2[index + 1]);
+                destination[index] = first;
+                destination[index + 1] = second;
+            }
+        }
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = ShortestAngleBetween(angles1[index], angles2[index]);
+    }
+}
+
+void INSKPointsApplyAffineTransform(CGPoint *destination, const CGPoint *points, INSKAffineTransform transform, size_t count) {
+    size_t index = 0;
+#if INSK_BATCH_SIMD
+    if (INSKBatchUseSIMD()) {
+        // Each point is one vector, x scales the first and y the second column of the matrix.
+        INSKBatchVector column1 = INSKBatchMake(transform.a, transform.b);
+        INSKBatchVector column2 = INSKBatchMake(transform.c, transform.d);
+        INSKBatchVector translation = INSKBatchMake(transform.tx, transform.ty);
+        for (; index < count; ++index) {
+            INSKBatchVector point = INSKBatchLoad(&points[index].x);
+            INSKBatchVector product = INSKBatchAdd(INSKBatchMultiply(INSKBatchSplatLow(point), column1), INSKBatchMultiply(INSKBatchSplatHigh(point), column2));
+            INSKBatchStore(&destination[index].x, INSKBatchAdd(product, translation));
+        }
+    }
+#endif
+    for (; index < count; ++index) {
+        destination[index] = CGPointApplyINSKAffineTransform(points[index], transform);
+    }
+}
+
+void INSKPointsSoAApplyAffineTransform(INSKPointsSoA destination, INSKPointsSoA points, INSKAffineTransform transform, size_t count) {
+    size_t index = 0;
+    if (INSKBatchUseSIMD()) {
+#if INSK_BATCH_AVX
+        __m256d a4 = _mm256_set1_pd(transform.a);
+        __m256d b4 = _mm256_set1_pd(transform.b);
+        __m256d c4 = _mm256_set1_pd(transform.c);
+        __m256d d4 = _mm256_set1_pd(transform.d);
+        __m256d tx4 = _mm256_set1_pd(transform.tx);
+        __m256d ty4 = _mm256_set1_pd(transform.ty);
+        for (; index + 4 <= count; index += 4) {
+            __m256d x = _mm256_loadu_pd(points.x + index);
+            __m256d y = _mm256_loadu_pd(points.y + index);
+            _mm256_storeu_pd(destination.x + index, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a4, x), _mm256_mul_pd(c4, y)), tx4));
+            _mm256_storeu_pd(destination.y + index, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(b4, x), _mm256_mul_pd(d4, y)), ty4));
+        }
+#endif
+#if INSK_BATCH_SIMD
+        INSKBatchVector a = INSKBatchSplat(transform.a);
+        INSKBatchVector b = INSKBatchSplat(transform.b);
+        INSKBatchVector c = INSKBatchSplat(transform.c);
+        INSKBatchVector d = INSKBatchSplat(transform.d);
+        INSKBatchVector tx = INSKBatchSplat(transform.tx);
+        INSKBatchVector ty = INSKBatchSplat(transform.ty);
+        for (; index + 2 <= count; index += 2) {
+            INSKBatchVector x = INSKBatchLoad(points.x + index);
+            INSKBatchVector y = INSKBatchLoad(points.y + index);
+            INSKBatchStore(destination.x + index, INSKBatchAdd(INSKBatchAdd(INSKBatchMultiply(a, x), INSKBatchMultiply(c, y)), tx));
+            INSKBatchStore(destination.y + index, INSKBatchAdd(INSKBatchAdd(INSKBatchMultiply(b, x), INSKBatchMultiply(d, y)), ty));
+        }
+#endif
+    }
+    for (; index < count; ++index) {
+        CGFloat x = points.x[index];
+        CGFloat y = points.y[index];
+        destination.x[index] = transform.a * x + transform.c * y + transform.tx;
+        destination.y[index] = transform.b * x + transform.d * y + transform.ty;
+    }
+}
+
+INSKAffineTransform INSKAffineTransformConcatChain(const INSKAffineTransform *transforms, size_t count) {
+    if (count == 0) {
+        return INSKAffineTransformMakeIdentity();
+    }
+    INSKAffineTransform result = transforms[0];
+    for (size_t index = 1; index < count; ++index) {
+        result = INSKBatchAffineTransformConcat(result, transforms[index]);
+    }
+    return result;
+}
+
+void INSKAffineTransformConcatPrefixes(INSKAffineTransform *destination, const INSKAffineTransform *transforms, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    INSKAffineTransform result = transforms[0];
+    destination[0] = result;
+    for (size_t index = 1; index < count; ++index) {
+        result = INSKBatchAffineTransformConcat(result, transforms[index]);
+        destination[index] = result;
+    }
+}
@@ -0,0 +1,313 @@
+// INSKMathBatch.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_MATH_BATCH_H
+#define INSK_MATH_BATCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "INSKMath.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ Points stored as two separate arrays for the x and y values (structure of arrays).
+ 
+ This layout is the fastest for the batch functions, because all lanes of a SIMD register can be filled with the same component.
+ Use arrays of CGPoint (array of structures) where points are needed as CGPoint anyway.
+ */
+typedef struct {
+    /// The x values.
+    CGFloat *x;
+    /// The y values.
+    CGFloat *y;
+} INSKPointsSoA;
+
+
+/**
+ The implementations of the batch functions.
+ */
+typedef enum {
+    /// Plain C loops which the compiler may vectorize on its own.
+    INSKMathBatchImplementationScalar = 0,
+    /// SSE2 on x86 with 2 doubles per register.
+    INSKMathBatchImplementationSSE2,
+    /// AVX on x86 with 4 doubles per register, only where the library is compiled with AVX enabled, i.e. with -mavx.
+    INSKMathBatchImplementationAVX,
+    /// NEON on 64 bit ARM with 2 doubles per register.
+    INSKMathBatchImplementationNEON
+} INSKMathBatchImplementation;
+
+
+/**
+ Returns the implementation used by the batch functions.
+
+ The SIMD implementation is chosen at compile time by the target's instruction set.
+ SIMD is only used where CGFloat is a double, 32 bit targets always use the scalar implementation.
+
+ @return The implementation currently used.
+ */
+INSKMathBatchImplementation INSKMathBatchGetImplementation(void);
+
+/**
+ Switches between the SIMD implementation and the scalar fallback at run time, i.e. for validating or benchmarking them against each other.
+
+ All implementations return the same results as the scalar INSKMath functions within the rounding errors of a few ulps.
+
+ @param enabled False to force the scalar implementation, true to use the SIMD implementation if available, which is the default.
+ */
+void INSKMathBatchSetSIMDEnabled(bool enabled);
+
+
+// ------------------------------------------------------------
+#pragma mark - array of CGPoint
+// ------------------------------------------------------------
+/// @name array of CGPoint
+
+/**
+ Adds two arrays of points like CGPointAdd().
+
+ The destination may be the same array as one of the sources.
+
+ @param destination Receives the sums.
+ @param points1 The first points.
+ @param points2 The points to add.
+ @param count The number of points in each array.
+ */
+void INSKPointsAdd(CGPoint *destination, const CGPoint *points1, const CGPoint *points2, size_t count);
+
+/**
+ Subtracts two arrays of points like CGPointSubtract().
+
+ @param destination Receives the differences, may be the same array as one of the sources.
+ @param points1 The first points.
+ @param points2 The points to subtract.
+ @param count The number of points in each array.
+ */
+void INSKPointsSubtract(CGPoint *destination, const CGPoint *points1, const CGPoint *points2, size_t count);
+
+/**
+ Multiplies an array of points with a scalar like CGPointMultiplyScalar().
+
+ @param destination Receives the products, may be the same array as the source.
+ @param points The points.
+ @param value The scalar.
+ @param count The number of points.
+ */
+void INSKPointsMultiplyScalar(CGPoint *destination, const CGPoint *points, CGFloat value, size_t count);
+
+/**
+ Calculates the squared distances of an array of points to an origin like CGPointDistanceSq().
+
+ @param distances Receives the squared distances.
+ @param points The points.
+ @param origin The point the distances are measured to.
+ @param count The number of points.
+ */
+void INSKPointsDistanceSq(CGFloat *distances, const CGPoint *points, CGPoint origin, size_t count);
+
+/**
+ Normalizes an array of vectors like CGPointNormalize().
+
+ @param destination Receives the normalized vectors, may be the same array as the source.
+ @param points The vectors.
+ @param count The number of vectors.
+ */
+void INSKPointsNormalize(CGPoint *destination, const CGPoint *points, size_t count);
+
+/**
+ Interpolates linearly between two arrays of points like CGPointLerp().
+
+ @param destination Receives the interpolated points, may be the same array as one of the sources.
+ @param points1 The start points.
+ @param points2 The end points.
+ @param t The percentage from 0 to 1 for all points.
+ @param count The number of points in each array.
+ */
+void INSKPointsLerp(CGPoint *destination, const CGPoint *points1, const CGPoint *points2, CGFloat t, size_t count);
+
+
+// ------------------------------------------------------------
+#pragma mark - structure of arrays
+// ------------------------------------------------------------
+/// @name structure of arrays
+
+/**
+ Adds two lists of points like CGPointAdd().
+
+ @param destination Receives the sums, may be the same arrays as one of the sources.
+ @param points1 The first points.
+ @param points2 The points to add.
+ @param count The number of points in each list.
+ */
+void INSKPointsSoAAdd(INSKPointsSoA destination, INSKPointsSoA points1, INSKPointsSoA points2, size_t count);
+
+/**
+ Subtracts two lists of points like CGPointSubtract().
+
+ @param destination Receives the differences, may be the same arrays as one of the sources.
+ @param points1 The first points.
+ @param points2 The points to subtract.
+ @param count The number of points in each list.
+ */
+void INSKPointsSoASubtract(INSKPointsSoA destination, INSKPointsSoA points1, INSKPointsSoA points2, size_t count);
+
+/**
+ Multiplies a list of points with a scalar like CGPointMultiplyScalar().
+
+ @param destination Receives the products, may be the same arrays as the source.
+ @param points The points.
+ @param value The scalar.
+ @param count The number of points.
+ */
+void INSKPointsSoAMultiplyScalar(INSKPointsSoA destination, INSKPointsSoA points, CGFloat value, size_t count);
+
+/**
+ Calculates the squared distances of a list of points to an origin like CGPointDistanceSq().
+
+ @param distances Receives the squared distances.
+ @param points The points.
+ @param origin The point the distances are measured to.
+ @param count The number of points.
+ */
+void INSKPointsSoADistanceSq(CGFloat *distances, INSKPointsSoA points, CGPoint origin, size_t count);
+
+/**
+ Normalizes a list of vectors like CGPointNormalize().
+
+ @param destination Receives the normalized vectors, may be the same arrays as the source.
+ @param points The vectors.
+ @param count The number of vectors.
+ */
+void INSKPointsSoANormalize(INSKPointsSoA destination, INSKPointsSoA points, size_t count);
+
+/**
+ Interpolates linearly between two lists of points like CGPointLerp().
+
+ @param destination Receives the interpolated points, may be the same arrays as one of the sources.
+ @param points1 The start points.
+ @param points2 The end points.
+ @param t The percentage from 0 to 1 for all points.
+ @param count The number of points in each list.
+ */
+void INSKPointsSoALerp(INSKPointsSoA destination, INSKPointsSoA points1, INSKPointsSoA points2, CGFloat t, size_t count);
+
+
+// ------------------------------------------------------------
+#pragma mark - angles
+// ------------------------------------------------------------
+/// @name angles
+
+/**
+ Wraps an array of radian angles like AngleIn2Pi().
+
+ The results are exactly the same as those of AngleIn2Pi().
+ The SIMD path handles angles from -2*M_PI to 2*M_PI, pairs of angles with bigger values fall back to AngleIn2Pi().
+
+ @param destination Receives the angles in the range of 0 to 2*M_PI, may be the same array as the source.
+ @param angles The angles in radians.
+ @param count The number of angles.
+ */
+void INSKAnglesIn2Pi(CGFloat *destination, const CGFloat *angles, size_t count);
+
+/**
+ Wraps an array of radian angles like AngleInPi().
+
+ The results are exactly the same as those of AngleInPi().
+ The SIMD path handles angles from -2*M_PI to 2*M_PI, pairs of angles with bigger values fall back to AngleInPi().
+
+ @param destination Receives the angles in the range of -M_PI to M_PI, may be the same array as the source.
+ @param angles The angles in radians.
+ @param count The number of angles.
+ */
+void INSKAnglesInPi(CGFloat *destination, const CGFloat *angles, size_t count);
+
+/**
+ Calculates the shortest angles between two arrays of radian angles like ShortestAngleBetween(), i.e. for steering from the current to the target headings.
+
+ The results are exactly the same as those of ShortestAngleBetween().
+ The SIMD path handles differences from -2*M_PI to 2*M_PI after wrapping negative angles, other pairs fall back to ShortestAngleBetween().
+
+ @param destination Receives the difference angles from -M_PI to M_PI, may be the same array as one of the sources.
+ @param angles1 The first angles in radians.
+ @param angles2 The second angles in radians.
+ @param count The number of angles in each array.
+ */
+void INSKAnglesShortestBetween(CGFloat *destination, const CGFloat *angles1, const CGFloat *angles2, size_t count);
+
+
+// ------------------------------------------------------------
+#pragma mark - affine transformations
+// ------------------------------------------------------------
+/// @name affine transformations
+
+/**
+ Transforms an array of points with one transformation like CGPointApplyINSKAffineTransform(), i.e. for converting a polyline into another node's coordinate system.
+
+ @param destination Receives the transformed points, may be the same array as the source.
+ @param points The points.
+ @param transform The transformation.
+ @param count The number of points.
+ */
+void INSKPointsApplyAffineTransform(CGPoint *destination, const CGPoint *points, INSKAffineTransform transform, size_t count);
+
+/**
+ Transforms a list of points with one transformation like CGPointApplyINSKAffineTransform().
+
+ @param destination Receives the transformed points, may be the same arrays as the source.
+ @param points The points.
+ @param transform The transformation.
+ @param count The number of points.
+ */
+void INSKPointsSoAApplyAffineTransform(INSKPointsSoA destination, INSKPointsSoA points, INSKAffineTransform transform, size_t count);
+
+/**
+ Composes a chain of transformations into one with INSKAffineTransformConcat(), so the result applies transforms[0] first and the last transformation last.
+
+ @param transforms The transformations.
+ @param count The number of transformations.
+ @return The composed transformation or the identity transformation if count is 0.
+ */
+INSKAffineTransform INSKAffineTransformConcatChain(const INSKAffineTransform *transforms, size_t count);
+
+/**
+ Composes all beginnings of a chain of transformations, so destination[i] applies transforms[0] up to transforms[i].
+
+ With the transformations from each node into its parent ordered from a leaf up to the scene, the results are the transformations of the leaf and of each ancestor into the scene.
+
+ @param destination Receives the composed transformations, may be the same array as the source.
+ @param transforms The transformations.
+ @param count The number of transformations.
+ */
+void INSKAffineTransformConcatPrefixes(INSKAffineTransform *destination, const INSKAffineTransform *transforms, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
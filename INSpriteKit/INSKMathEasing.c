@@ -0,0 +1,333 @@
+// INSKMathEasing.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKMathEasing.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+// The precision of the solved curve parameter of cubic Bézier curves, which has to be tiny where the curve is nearly vertical.
+static const double INSKEasingBezierEpsilon = 1e-12;
+
+// The most frames a table for a tween may have.
+static const double INSKEasingTableMaxFrames = 16777216.0;
+
+struct INSKEasingTable {
+    // The number of samples including the progresses 0 and 1.
+    size_t sampleCount;
+    // The factor converting a progress into a sample index.
+    CGFloat scale;
+    // The samples with a copy of the last one at the end, so the interpolation never reads beyond the array.
+    CGFloat *samples;
+};
+
+
+#pragma mark - private functions
+
+static inline CGFloat INSKEasingClamp(CGFloat t) {
+    return t > 0.0 ? (t < 1.0 ? t : 1.0) : 0.0;
+}
+
+// All curve functions take the curve, so the macros below can derive the other versions of any curve the same way.
+static inline CGFloat INSKEasingQuadIn(CGFloat t, const INSKEasingCurve *curve) {
+    (void)curve;
+    return t * t;
+}
+
+static inline CGFloat INSKEasingCubicIn(CGFloat t, const INSKEasingCurve *curve) {
+    (void)curve;
+    return t * t * t;
+}
+
+// Written as t^2 * (t + s * (t - 1)) instead of t^2 * ((s + 1) * t - s), so the value at 1 is exact.
+static inline CGFloat INSKEasingBackIn(CGFloat t, const INSKEasingCurve *curve) {
+    return t * t * (t + curve->parameters[0] * (t - 1.0));
+}
+
+static inline CGFloat INSKEasingElasticOut(CGFloat t, const INSKEasingCurve *curve) {
+    if (t <= 0.0) {
+        return 0.0;
+    }
+    if (t >= 1.0) {
+        return 1.0;
+    }
+    return curve->parameters[0] * pow(2.0, -10.0 * t) * sin((t - curve->parameters[2]) * curve->parameters[1]) + 1.0;
+}
+
+static inline CGFloat INSKEasingSpringOut(CGFloat t, const INSKEasingCurve *curve) {
+    if (t >= 1.0) {
+        return 1.0;
+    }
+    CGFloat damping = curve->parameters[0];
+    CGFloat frequency = curve->parameters[1];
+    if (damping < 1.0) {
+        // Underdamped, parameters 2 to 4 are the damped frequency, the ratio of the decay to it and the decay.
+        CGFloat dampedFrequency = curve->parameters[2];
+        return 1.0 - exp(-curve->parameters[4] * t) * (cos(dampedFrequency * t) + curve->parameters[3] * sin(dampedFrequency * t));
+    } else if (damping == 1.0) {
+        return 1.0 - exp(-frequency * t) * (1.0 + frequency * t);
+    } else {
+        // Overdamped, parameters 2 and 3 are the roots of the characteristic equation.
+        CGFloat root1 = curve->parameters[2];
+        CGFloat root2 = curve->parameters[3];
+        return 1.0 - (root2 * exp(root1 * t) - root1 * exp(root2 * t)) / (root2 - root1);
+    }
+}
+
+// Returns the x value of a cubic Bézier curve at the curve parameter s.
+static inline double INSKEasingBezierX(const INSKEasingCurve *curve, double s) {
+    return ((curve->parameters[2] * s + curve->parameters[1]) * s + curve->parameters[0]) * s;
+}
+
+// Solves the curve parameter of a cubic Bézier curve for the x value t and returns its y value.
+static CGFloat INSKEasingCubicBezier(CGFloat t, const INSKEasingCurve *curve) {
+    if (t <= 0.0) {
+        return 0.0;
+    }
+    if (t >= 1.0) {
+        return 1.0;
+    }
+    double x = t;
+    double s = x;
+    bool solved = false;
+    // Newton-Raphson converges in a few iterations for most curves.
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        double error = INSKEasingBezierX(curve, s) - x;
+        if (fabs(error) < INSKEasingBezierEpsilon) {
+            solved = true;
+            break;
+        }
+        double derivative = (3.0 * curve->parameters[2] * s + 2.0 * curve->parameters[1]) * s + curve->parameters[0];
+        if (fabs(derivative) < 1e-6) {
+            break;
+        }
+        s -= error / derivative;
+    }
+    // Bisection as the fallback where the slope is too flat for Newton-Raphson, x is monotonic in s.
+    if (!solved) {
+        double low = 0.0;
+        double high = 1.0;
+        s = x;
+        while (high - low > INSKEasingBezierEpsilon) {
+            double value = INSKEasingBezierX(curve, s);
+            if (value == x) {
+                break;
+            }
+            if (x > value) {
+                low = s;
+            } else {
+                high = s;
+            }
+            s = (low + high) * 0.5;
+        }
+    }
+    return ((curve->parameters[5] * s + curve->parameters[4]) * s + curve->parameters[3]) * s;
+}
+
+// Derive the other versions of a curve by mirroring it, the reversed in version is the out version and the other way round.
+#define INSK_EASING_REVERSED(function) (1.0 - function(1.0 - t, &curve))
+#define INSK_EASING_IN_OUT_OF_IN(function) (t < 0.5 ? 0.5 * function(2.0 * t, &curve) : 1.0 - 0.5 * function(2.0 - 2.0 * t, &curve))
+#define INSK_EASING_IN_OUT_OF_OUT(function) (t < 0.5 ? 0.5 - 0.5 * function(1.0 - 2.0 * t, &curve) : 0.5 + 0.5 * function(2.0 * t - 1.0, &curve))
+
+// The formulas of all curves for the progress t in the range of 0 to 1, used by the scalar and the batch evaluation.
+#define INSK_EASING_CURVES(CURVE) \
+    CURVE(INSKEasingTypeQuadIn, INSKEasingQuadIn(t, &curve)) \
+    CURVE(INSKEasingTypeQuadOut, INSK_EASING_REVERSED(INSKEasingQuadIn)) \
+    CURVE(INSKEasingTypeQuadInOut, INSK_EASING_IN_OUT_OF_IN(INSKEasingQuadIn)) \
+    CURVE(INSKEasingTypeCubicIn, INSKEasingCubicIn(t, &curve)) \
+    CURVE(INSKEasingTypeCubicOut, INSK_EASING_REVERSED(INSKEasingCubicIn)) \
+    CURVE(INSKEasingTypeCubicInOut, INSK_EASING_IN_OUT_OF_IN(INSKEasingCubicIn)) \
+    CURVE(INSKEasingTypeBackIn, INSKEasingBackIn(t, &curve)) \
+    CURVE(INSKEasingTypeBackOut, INSK_EASING_REVERSED(INSKEasingBackIn)) \
+    CURVE(INSKEasingTypeBackInOut, INSK_EASING_IN_OUT_OF_IN(INSKEasingBackIn)) \
+    CURVE(INSKEasingTypeElasticIn, INSK_EASING_REVERSED(INSKEasingElasticOut)) \
+    CURVE(INSKEasingTypeElasticOut, INSKEasingElasticOut(t, &curve)) \
+    CURVE(INSKEasingTypeElasticInOut, INSK_EASING_IN_OUT_OF_OUT(INSKEasingElasticOut)) \
+    CURVE(INSKEasingTypeSpringIn, INSK_EASING_REVERSED(INSKEasingSpringOut)) \
+    CURVE(INSKEasingTypeSpringOut, INSKEasingSpringOut(t, &curve)) \
+    CURVE(INSKEasingTypeSpringInOut, INSK_EASING_IN_OUT_OF_OUT(INSKEasingSpringOut)) \
+    CURVE(INSKEasingTypeCubicBezier, INSKEasingCubicBezier(t, &curve))
+
+
+#pragma mark - public functions
+
+INSKEasingCurve INSKEasingCurveMake(INSKEasingType type) {
+    switch (type) {
+        case INSKEasingTypeBackIn:
+        case INSKEasingTypeBackOut:
+        case INSKEasingTypeBackInOut:
+            return INSKEasingCurveMakeBack(type, 1.70158);
+        case INSKEasingTypeElasticIn:
+        case INSKEasingTypeElasticOut:
+        case INSKEasingTypeElasticInOut:
+            return INSKEasingCurveMakeElastic(type, 1.0, 0.3);
+        case INSKEasingTypeSpringIn:
+        case INSKEasingTypeSpringOut:
+        case INSKEasingTypeSpringInOut:
+            return INSKEasingCurveMakeSpring(type, 0.5, 15.0);
+        case INSKEasingTypeCubicBezier:
+            return INSKEasingCurveMakeCubicBezier(0.25, 0.1, 0.25, 1.0);
+        default: {
+            INSKEasingCurve curve = {type, {0}};
+            return curve;
+        }
+    }
+}
+
+INSKEasingCurve INSKEasingCurveMakeBack(INSKEasingType type, CGFloat overshoot) {
+    INSKEasingCurve curve = {INSKEasingTypeBackOut, {overshoot}};
+    if (type == INSKEasingTypeBackIn || type == INSKEasingTypeBackInOut) {
+        curve.type = type;
+    }
+    return curve;
+}
+
+INSKEasingCurve INSKEasingCurveMakeElastic(INSKEasingType type, CGFloat amplitude, CGFloat period) {
+    INSKEasingCurve curve = {INSKEasingTypeElasticOut, {0}};
+    if (type == INSKEasingTypeElasticIn || type == INSKEasingTypeElasticInOut) {
+        curve.type = type;
+    }
+    amplitude = MAX(amplitude, 1.0);
+    curve.parameters[0] = amplitude;
+    curve.parameters[1] = 2.0 * M_PI / period;
+    // The phase shift which lets the wave start at 0.
+    curve.parameters[2] = period / (2.0 * M_PI) * asin(1.0 / amplitude);
+    return curve;
+}
+
+INSKEasingCurve INSKEasingCurveMakeSpring(INSKEasingType type, CGFloat damping, CGFloat frequency) {
+    INSKEasingCurve curve = {INSKEasingTypeSpringOut, {damping, frequency}};
+    if (type == INSKEasingTypeSpringIn || type == INSKEasingTypeSpringInOut) {
+        curve.type = type;
+    }
+    if (damping < 1.0) {
+        CGFloat dampedFrequency = frequency * sqrt(1.0 - damping * damping);
+        curve.parameters[2] = dampedFrequency;
+        curve.parameters[3] = dampedFrequency > 0.0 ? damping * frequency / dampedFrequency : 0.0;
+        curve.parameters[4] = damping * frequency;
+    } else if (damping > 1.0) {
+        CGFloat root = sqrt(damping * damping - 1.0);
+        curve.parameters[2] = -frequency * (damping - root);
+        curve.parameters[3] = -frequency * (damping + root);
+    }
+    return curve;
+}
+
+INSKEasingCurve INSKEasingCurveMakeCubicBezier(CGFloat x1, CGFloat y1, CGFloat x2, CGFloat y2) {
+    INSKEasingCurve curve = {INSKEasingTypeCubicBezier, {0}};
+    x1 = Clamp(x1, 0.0, 1.0);
+    x2 = Clamp(x2, 0.0, 1.0);
+    // The polynomial coefficients of x(s) = ((a * s + b) * s + c) * s, y likewise.
+    curve.parameters[0] = 3.0 * x1;
+    curve.parameters[1] = 3.0 * (x2 - x1) - curve.parameters[0];
+    curve.parameters[2] = 1.0 - curve.parameters[0] - curve.parameters[1];
+    curve.parameters[3] = 3.0 * y1;
+    curve.parameters[4] = 3.0 * (y2 - y1) - curve.parameters[3];
+    curve.parameters[5] = 1.0 - curve.parameters[3] - curve.parameters[4];
+    return curve;
+}
+
+CGFloat INSKEasingCurveEvaluate(INSKEasingCurve curve, CGFloat t) {
+    t = INSKEasingClamp(t);
+    switch (curve.type) {
+#define INSK_EASING_RETURN(type, expression) case type: return (expression);
+        INSK_EASING_CURVES(INSK_EASING_RETURN)
+#undef INSK_EASING_RETURN
+        default:
+            return t;
+    }
+}
+
+void INSKEasingCurveEvaluateValues(CGFloat *destination, const CGFloat *times, INSKEasingCurve curve, size_t count) {
+    // One loop per type, so the loops don't branch on the type.
+    switch (curve.type) {
+#define INSK_EASING_LOOP(type, expression) \
+        case type: \
+            for (size_t index = 0; index < count; ++index) { \
+                CGFloat t = INSKEasingClamp(times[index]); \
+                destination[index] = (expression); \
+            } \
+            break;
+        INSK_EASING_CURVES(INSK_EASING_LOOP)
+#undef INSK_EASING_LOOP
+        default:
+            for (size_t index = 0; index < count; ++index) {
+                destination[index] = INSKEasingClamp(times[index]);
+            }
+            break;
+    }
+}
+
+INSKEasingTable *INSKEasingTableCreate(INSKEasingCurve curve, size_t sampleCount) {
+    if (sampleCount < 2 || sampleCount > ((size_t)-1 - sizeof(INSKEasingTable)) / sizeof(CGFloat) - 1) {
+        return NULL;
+    }
+    // The samples follow the table in the same block of memory.
+    INSKEasingTable *table = (INSKEasingTable *)malloc(sizeof(INSKEasingTable) + (sampleCount + 1) * sizeof(CGFloat));
+    if (table == NULL) {
+        return NULL;
+    }
+    table->sampleCount = sampleCount;
+    table->scale = (CGFloat)(sampleCount - 1);
+    table->samples = (CGFloat *)(table + 1);
+    for (size_t index = 0; index < sampleCount; ++index) {
+        table->samples[index] = INSKEasingCurveEvaluate(curve, (CGFloat)index / table->scale);
+    }
+    table->samples[sampleCount] = table->samples[sampleCount - 1];
+    return table;
+}
+
+INSKEasingTable *INSKEasingTableCreateForTween(INSKEasingCurve curve, double duration, double framesPerSecond) {
+    // A small tolerance, so i.e. 0.5 seconds at 60 fps are 30 frames even if the product is rounded up a bit.
+    double frames = ceil(duration * framesPerSecond - 1e-6);
+    if (!(frames >= 1.0 && frames <= INSKEasingTableMaxFrames)) {
+        return NULL;
+    }
+    return INSKEasingTableCreate(curve, (size_t)frames + 1);
+}
+
+void INSKEasingTableDestroy(INSKEasingTable *table) {
+    free(table);
+}
+
+size_t INSKEasingTableSampleCount(const INSKEasingTable *table) {
+    return table->sampleCount;
+}
+
+CGFloat INSKEasingTableEvaluate(const INSKEasingTable *table, CGFloat t) {
+    CGFloat position = INSKEasingClamp(t) * table->scale;
+    size_t index = (size_t)position;
+    CGFloat sample = table->samples[index];
+    return sample + (table->samples[index + 1] - sample) * (position - (CGFloat)index);
+}
+
+void INSKEasingTableEvaluateValues(CGFloat *destination, const CGFloat *times, const INSKEasingTable *table, size_t count) {
+    const CGFloat *samples = table->samples;
+    CGFloat scale = table->scale;
+    for (size_t index = 0; index < count; ++index) {
+        CGFloat position = INSKEasingClamp(times[index]) * scale;
+        size_t sampleIndex = (size_t)position;
+        CGFloat sample = samples[sampleIndex];
+        destination[index] = sample + (samples[sampleIndex + 1] - sample) * (position - (CGFloat)sampleIndex);
+    }
+}
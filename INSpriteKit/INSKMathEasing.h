@@ -0,0 +1,255 @@
+// INSKMathEasing.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_MATH_EASING_H
+#define INSK_MATH_EASING_H
+
+#include <stddef.h>
+#include "INSKMath.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ------------------------------------------------------------
+#pragma mark - easing curves
+// ------------------------------------------------------------
+/// @name easing curves
+
+// Easing curves map the linear progress of a tween from 0 to 1 to the eased progress, which starts at 0 and ends at 1.
+// Back, elastic and spring curves overshoot, so their values may leave the range of 0 to 1 in between.
+// Evaluate a single value with INSKEasingCurveEvaluate(), many values at once with INSKEasingCurveEvaluateValues()
+// or precalculate a curve for tweens of a fixed duration with an INSKEasingTable.
+
+/**
+ The types of easing curves.
+
+ Each curve comes in an in version, which starts slowly, an out version, which ends slowly, and an in-out version with a slow start and end.
+ */
+typedef enum {
+    /// No easing, the value is the progress.
+    INSKEasingTypeLinear = 0,
+    /// Quadratic curve t^2.
+    INSKEasingTypeQuadIn,
+    INSKEasingTypeQuadOut,
+    INSKEasingTypeQuadInOut,
+    /// Cubic curve t^3.
+    INSKEasingTypeCubicIn,
+    INSKEasingTypeCubicOut,
+    INSKEasingTypeCubicInOut,
+    /// Cubic curve which pulls back before moving, see INSKEasingCurveMakeBack().
+    INSKEasingTypeBackIn,
+    INSKEasingTypeBackOut,
+    INSKEasingTypeBackInOut,
+    /// Exponentially decaying sine wave, see INSKEasingCurveMakeElastic().
+    INSKEasingTypeElasticIn,
+    INSKEasingTypeElasticOut,
+    INSKEasingTypeElasticInOut,
+    /// Damped harmonic oscillator, see INSKEasingCurveMakeSpring().
+    INSKEasingTypeSpringIn,
+    INSKEasingTypeSpringOut,
+    INSKEasingTypeSpringInOut,
+    /// Cubic Bézier curve like the timing functions of CSS and Core Animation, see INSKEasingCurveMakeCubicBezier().
+    INSKEasingTypeCubicBezier
+} INSKEasingType;
+
+/**
+ An easing curve with its parameters.
+
+ Create curves with the make functions, which precalculate the values needed for the evaluation.
+ */
+typedef struct {
+    /// The type of the curve.
+    INSKEasingType type;
+    /// The precalculated parameters of the curve, depending on the type.
+    CGFloat parameters[6];
+} INSKEasingCurve;
+
+
+/**
+ Creates an easing curve of a type with its default parameters.
+
+ The default overshoot of back curves is 1.70158 (10%), elastic curves use an amplitude of 1 and a period of 0.3
+ and spring curves a damping ratio of 0.5 with a frequency of 15 radians per tween.
+ Cubic Bézier curves default to the control points of the CSS timing function ease (0.25, 0.1) and (0.25, 1).
+
+ @param type The type of the curve.
+ @return The curve.
+ */
+INSKEasingCurve INSKEasingCurveMake(INSKEasingType type);
+
+/**
+ Creates a back curve with a given overshoot.
+
+ @param type INSKEasingTypeBackIn, INSKEasingTypeBackOut or INSKEasingTypeBackInOut, any other type is treated as INSKEasingTypeBackOut.
+ @param overshoot How far the curve pulls back, 0 results in a cubic curve and 1.70158 in an overshoot of 10%.
+ @return The curve.
+ */
+INSKEasingCurve INSKEasingCurveMakeBack(INSKEasingType type, CGFloat overshoot);
+
+/**
+ Creates an elastic curve with a given amplitude and period.
+
+ Like the classic formula the curve is about amplitude / 1024 away from 1 shortly before the end, where it is set to exactly 1.
+
+ @param type INSKEasingTypeElasticIn, INSKEasingTypeElasticOut or INSKEasingTypeElasticInOut, any other type is treated as INSKEasingTypeElasticOut.
+ @param amplitude The amplitude of the oscillation, values less than 1 are raised to 1.
+ @param period The period of the oscillation as part of the tween's duration, i.e. 0.3.
+ @return The curve.
+ */
+INSKEasingCurve INSKEasingCurveMakeElastic(INSKEasingType type, CGFloat amplitude, CGFloat period);
+
+/**
+ Creates a spring curve with a given damping and frequency.
+
+ The curve is the position of a damped spring pulled from 0 to 1, which starts at rest.
+ The spring has to settle within the tween, otherwise the value jumps to 1 at the end;
+ the remaining distance at the end is about exp(-damping * frequency) for damping ratios less than 1.
+
+ @param type INSKEasingTypeSpringIn, INSKEasingTypeSpringOut or INSKEasingTypeSpringInOut, any other type is treated as INSKEasingTypeSpringOut.
+ @param damping The damping ratio, less than 1 oscillates, 1 is critically damped and bigger values approach 1 more slowly.
+ @param frequency The undamped angular frequency in radians per tween duration.
+ @return The curve.
+ */
+INSKEasingCurve INSKEasingCurveMakeSpring(INSKEasingType type, CGFloat damping, CGFloat frequency);
+
+/**
+ Creates a cubic Bézier curve from (0, 0) to (1, 1) with two control points like the timing functions of CSS and Core Animation.
+
+ The x values of the control points are clamped into the range of 0 to 1, so there is exactly one value for each progress.
+
+ @param x1 The x value of the first control point.
+ @param y1 The y value of the first control point.
+ @param x2 The x value of the second control point.
+ @param y2 The y value of the second control point.
+ @return The curve.
+ */
+INSKEasingCurve INSKEasingCurveMakeCubicBezier(CGFloat x1, CGFloat y1, CGFloat x2, CGFloat y2);
+
+
+// ------------------------------------------------------------
+#pragma mark - evaluation
+// ------------------------------------------------------------
+/// @name evaluation
+
+/**
+ Returns the eased value of a curve.
+
+ All curves return exactly 0 at the progress 0 and exactly 1 at the progress 1.
+ Cubic Bézier curves are solved with Newton-Raphson iterations and bisection where the curve is too steep, so the error is less than 1e-6 even there.
+
+ @param curve The curve.
+ @param t The progress of the tween, which is clamped into the range of 0 to 1, NaN counts as 0.
+ @return The eased value.
+ */
+CGFloat INSKEasingCurveEvaluate(INSKEasingCurve curve, CGFloat t);
+
+/**
+ Evaluates a curve for many values like INSKEasingCurveEvaluate(), i.e. for many tweens using the same curve.
+
+ The type of the curve is only tested once, so the loops of the simple curves can be vectorized by the compiler.
+
+ @param destination Receives the eased values, may be the same array as times.
+ @param times The progresses of the tweens.
+ @param curve The curve.
+ @param count The number of values.
+ */
+void INSKEasingCurveEvaluateValues(CGFloat *destination, const CGFloat *times, INSKEasingCurve curve, size_t count);
+
+
+// ------------------------------------------------------------
+#pragma mark - lookup tables
+// ------------------------------------------------------------
+/// @name lookup tables
+
+/**
+ A precalculated easing curve, which is evaluated by linear interpolation between equidistant samples.
+
+ The lookup costs the same for all curves, which makes the expensive elastic, spring and Bézier curves much faster.
+ The error decreases with the square of the number of samples; Tools/INSKMathEasingBenchmark.c prints the maximum error and speed for some sizes.
+ A table created for a fixed-duration tween with INSKEasingTableCreateForTween() has one sample per frame,
+ so frames at the expected times hit the samples exactly.
+ */
+typedef struct INSKEasingTable INSKEasingTable;
+
+/**
+ Creates a table of a curve.
+
+ @param curve The curve.
+ @param sampleCount The number of samples including the progresses 0 and 1, at least 2.
+ @return A new table which has to be freed with INSKEasingTableDestroy() or NULL if sampleCount is less than 2 or the memory couldn't be allocated.
+ */
+INSKEasingTable *INSKEasingTableCreate(INSKEasingCurve curve, size_t sampleCount);
+
+/**
+ Creates a table of a curve with one sample per frame of a tween.
+
+ @param curve The curve.
+ @param duration The duration of the tween in seconds.
+ @param framesPerSecond The frame rate the tween is rendered with, i.e. 60.
+ @return A new table which has to be freed with INSKEasingTableDestroy() or NULL if the tween has no frames or the memory couldn't be allocated.
+ */
+INSKEasingTable *INSKEasingTableCreateForTween(INSKEasingCurve curve, double duration, double framesPerSecond);
+
+/**
+ Frees the table and all its memory.
+
+ @param table The table to free, may be NULL.
+ */
+void INSKEasingTableDestroy(INSKEasingTable *table);
+
+/**
+ Returns the number of samples of a table.
+
+ @param table The table.
+ @return The number of samples.
+ */
+size_t INSKEasingTableSampleCount(const INSKEasingTable *table);
+
+/**
+ Returns the eased value of a table.
+
+ @param table The table.
+ @param t The progress of the tween, which is clamped into the range of 0 to 1, NaN counts as 0.
+ @return The eased value interpolated between the nearest samples.
+ */
+CGFloat INSKEasingTableEvaluate(const INSKEasingTable *table, CGFloat t);
+
+/**
+ Evaluates a table for many values like INSKEasingTableEvaluate().
+
+ @param destination Receives the eased values, may be the same array as times.
+ @param times The progresses of the tweens.
+ @param table The table.
+ @param count The number of values.
+ */
+void INSKEasingTableEvaluateValues(CGFloat *destination, const CGFloat *times, const INSKEasingTable *table, size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
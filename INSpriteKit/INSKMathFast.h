@@ -0,0 +1,197 @@
+// INSKMathFast.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_MATH_FAST_H
+#define INSK_MATH_FAST_H
+
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include "INSKMath.h"
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ------------------------------------------------------------
+#pragma mark - fast approximations
+// ------------------------------------------------------------
+/// @name fast approximations
+
+// The functions of this header trade a bit of accuracy for speed and are meant for visual work like particles, sprite orientations or UI effects.
+// Each function documents its maximum error, Tools/INSKMathFastTests.c checks them and Tools/INSKMathFastBenchmark.c compares them with libm.
+// They are only used where called explicitly, all other INSKMath functions keep calculating with the exact libm functions.
+
+/**
+ The biggest absolute angle in radians SinCosFast() calculates with the polynomials, bigger angles are passed to sin() and cos().
+ */
+#define INSK_FAST_ANGLE_LIMIT 100000.0
+
+/**
+ Calculates the sine and cosine of an angle with polynomials.
+
+ The angle is reduced to the range of -M_PI_4 to M_PI_4 and both values are calculated with the Taylor polynomials of degree 11 and 12.
+ The maximum absolute error is 1e-11 for angles up to INSK_FAST_ANGLE_LIMIT, bigger angles are calculated exactly with libm.
+
+ @param angle An angle in radians.
+ @param sine Receives the sine.
+ @param cosine Receives the cosine.
+ */
+static inline void SinCosFast(CGFloat angle, CGFloat *sine, CGFloat *cosine) {
+    if (!(fabs(angle) <= INSK_FAST_ANGLE_LIMIT)) {
+        *sine = sin(angle);
+        *cosine = cos(angle);
+        return;
+    }
+    // M_PI_2 split into a part with 33 bits, so quadrant * M_PI_2_HIGH is exact, and the rest; the quadrant is the rounded angle * 2/M_PI.
+    static const double M_PI_2_HIGH = 1.57079632673412561417e+00;
+    static const double M_PI_2_LOW = 6.07710050650619224932e-11;
+    long quadrant = (long)(angle * 0.63661977236758134308 + (angle < 0.0 ? -0.5 : 0.5));
+    double x = ((double)angle - quadrant * M_PI_2_HIGH) - quadrant * M_PI_2_LOW;
+    double x2 = x * x;
+    double s = x + x * x2 * (-1.0 / 6.0 + x2 * (1.0 / 120.0 + x2 * (-1.0 / 5040.0 + x2 * (1.0 / 362880.0 + x2 * (-1.0 / 39916800.0)))));
+    double c = 1.0 + x2 * (-0.5 + x2 * (1.0 / 24.0 + x2 * (-1.0 / 720.0 + x2 * (1.0 / 40320.0 + x2 * (-1.0 / 3628800.0 + x2 * (1.0 / 479001600.0))))));
+    // Odd quadrants swap sine and cosine, the quadrants 2 and 3 negate the sine, 1 and 2 the cosine.
+    double swappedSine = (quadrant & 1) ? c : s;
+    double swappedCosine = (quadrant & 1) ? s : c;
+    *sine = (quadrant & 2) ? -swappedSine : swappedSine;
+    *cosine = ((quadrant + 1) & 2) ? -swappedCosine : swappedCosine;
+}
+
+/**
+ Calculates the arc tangent of y/x in the range of -M_PI to M_PI like atan2() with a polynomial.
+
+ The quotient of the smaller and bigger absolute value is passed to the polynomial of degree 15 from Abramowitz and Stegun 4.4.49.
+ The maximum absolute error is 1e-7 radians, zeros, infinities and NaNs are passed to atan2().
+
+ @param y The y value.
+ @param x The x value.
+ @return The angle in radians.
+ */
+static inline CGFloat Atan2Fast(CGFloat y, CGFloat x) {
+    double absX = fabs(x);
+    double absY = fabs(y);
+    double maximum = absX > absY ? absX : absY;
+    double minimum = absX > absY ? absY : absX;
+    if (!(maximum > 0.0 && maximum <= DBL_MAX)) {
+        return atan2(y, x);
+    }
+    double t = minimum / maximum;
+    double t2 = t * t;
+    double angle = t * (0.9999993329 + t2 * (-0.3332985605 + t2 * (0.1994653599 + t2 * (-0.1390853351 + t2 * (0.0964200441 + t2 * (-0.0559098861 + t2 * (0.0218612288 + t2 * -0.0040540580)))))));
+    if (absY > absX) {
+        angle = M_PI_2 - angle;
+    }
+    if (x < 0.0) {
+        angle = M_PI - angle;
+    }
+    return signbit(y) ? -angle : angle;
+}
+
+/**
+ Calculates 1/sqrt(value) from the hardware estimate of the CPU refined by Newton-Raphson iterations.
+
+ On x86 the 12 bit estimate of rsqrtss gets one iteration, on 64 bit ARM the 8 bit estimate of frsqrte gets two.
+ Other CPUs and values outside of the float range start with the bit trick of Quake III for doubles and do three iterations.
+ The maximum relative error is 2e-7 for positive normal values, zero returns a very big value instead of infinity.
+
+ @param value A positive value.
+ @return The reciprocal of the square root.
+ */
+static inline CGFloat ReciprocalSqrtFast(CGFloat value) {
+    double x = value;
+    double halfX = 0.5 * x;
+#if defined(__SSE__) || defined(_M_X64) || defined(__aarch64__)
+    if (x >= FLT_MIN && x <= FLT_MAX) {
+#if defined(__aarch64__)
+        float64x1_t vector = vdup_n_f64(x);
+        float64x1_t estimate = vrsqrte_f64(vector);
+        estimate = vmul_f64(estimate, vrsqrts_f64(vmul_f64(vector, estimate), estimate));
+        estimate = vmul_f64(estimate, vrsqrts_f64(vmul_f64(vector, estimate), estimate));
+        return vget_lane_f64(estimate, 0);
+#else
+        double y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss((float)x)));
+        return y * (1.5 - halfX * y * y);
+#endif
+    }
+#endif
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5FE6EB50C7B537A9ull - (bits >> 1);
+    double y;
+    memcpy(&y, &bits, sizeof(y));
+    y = y * (1.5 - halfX * y * y);
+    y = y * (1.5 - halfX * y * y);
+    y = y * (1.5 - halfX * y * y);
+    return y;
+}
+
+/**
+ Given an angle in radians, creates a vector of length 1.0 like CGPointForAngle() with SinCosFast().
+
+ @param angle An angle in radians.
+ @return A CGPoint as a vector with a maximum error of 1e-11 per component.
+ */
+static inline CGPoint CGPointForAngleFast(CGFloat angle) {
+    CGFloat sine;
+    CGFloat cosine;
+    SinCosFast(angle, &sine, &cosine);
+    return CGPointMake(cosine, sine);
+}
+
+/**
+ Returns the angle in radians of the vector described by a CGPoint like CGPointToAngle() with Atan2Fast().
+
+ @param point A point as a vector.
+ @return The angle in radians from -M_PI to M_PI with a maximum error of 1e-7 radians.
+ */
+static inline CGFloat CGPointToAngleFast(CGPoint point) {
+    return Atan2Fast(point.y, point.x);
+}
+
+/**
+ Normalizes the vector described by a CGPoint to length 1.0 like CGPointNormalize() with ReciprocalSqrtFast(), so without a division.
+
+ Other than CGPointNormalize() a zero vector returns a zero vector.
+
+ @param point A point.
+ @return A new point with a maximum relative error of 2e-7 per component.
+ */
+static inline CGPoint CGPointNormalizeFast(CGPoint point) {
+    CGFloat factor = ReciprocalSqrtFast(point.x * point.x + point.y * point.y);
+    return CGPointMake(point.x * factor, point.y * factor);
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
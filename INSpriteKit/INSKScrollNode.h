@@ -53,6 +53,45 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 };
 
 
+/**
+ How the velocity of a drag is estimated from the touch or mouse movements.
+ */
+typedef NS_ENUM(NSInteger, INSKScrollNodeVelocityEstimation) {
+    /**
+     The mean of the velocities between the movements, ignoring how much time lies between them.
+     */
+    INSKScrollNodeVelocityEstimationAverage = 0,
+    /**
+     The slope of a least-squares parabola through the movements over time, the default.
+     Follows drags which speed up or slow down until the finger is lifted.
+     */
+    INSKScrollNodeVelocityEstimationLeastSquares,
+    /**
+     The movements divided by their durations, both weighted exponentially by their age.
+     */
+    INSKScrollNodeVelocityEstimationExponential
+};
+
+
+/**
+ The change of the visible part of a scroll node's content since the last notification, all rects are in the scrollContentNode's coordinate system.
+ 
+ The entered and exited regions don't overlap each other but may touch, there are at most four of each.
+ */
+typedef struct {
+    /// The visible rect of the last notification.
+    CGRect previousRect;
+    /// The visible rect now.
+    CGRect currentRect;
+    /// The parts of the current rect which weren't visible before.
+    CGRect enteredRects[4];
+    NSUInteger enteredCount;
+    /// The parts of the previous rect which aren't visible anymore.
+    CGRect exitedRects[4];
+    NSUInteger exitedCount;
+} INSKScrollNodeVisibleContentChange;
+
+
 
 @class INSKScrollNode;
 
@@ -68,7 +107,7 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 /**
  Optional delegate method which will be called when the content scroll node has been moved by the user.
  
- This method is called for every touch move event.
+ This method is called for every touch move event or once per frame if INSKView's coalescesTouchMoves is set.
  
  @param scrollNode The ISKScrollNode node which informs about the scrolling.
  @param fromOffset The scrollContentNode's starting position.
@@ -91,6 +130,108 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 - (void)scrollNode:(INSKScrollNode *)scrollNode didFinishScrollingAtPosition:(CGPoint)offset;
 
 
+/**
+ Optional delegate method which will be called when the content starts moving on its own, i.e. when it decelerates, snaps to a page, bounces back or scrolls animated.
+ 
+ The position the content will come to rest at is known as soon as the movement starts,
+ so textures and data for the content there can be loaded before it becomes visible.
+ Unless the movement is interrupted by the user, a stop or a change of the sizes didFinishScrollingAtPosition: follows with the same position.
+ 
+ @param scrollNode The ISKScrollNode node which informs about the scrolling.
+ @param offset The predicted final scrollContentNode's position.
+ @param visibleContentRect The part of the content which will be visible at the final position in the scrollContentNode's coordinate system.
+ */
+- (void)scrollNode:(INSKScrollNode *)scrollNode willFinishScrollingAtPosition:(CGPoint)offset visibleContentRect:(CGRect)visibleContentRect;
+
+
+/**
+ Optional delegate method which will be called at most once per frame when coalescesScrollNotifications is set and the visible part of the content has changed.
+ 
+ Unlike scrollNode:didScrollFromOffset:toOffset:velocity: this method is also called when the content moves on its own, is moved by code or the scroll node is resized.
+ The entered and exited regions let the delegate update only the content which came into view or left it instead of rescanning all content.
+ 
+ @param scrollNode The ISKScrollNode node which informs about the scrolling.
+ @param change The visible rects of the last and this notification and the regions between them.
+ @see coalescesScrollNotifications
+ */
+- (void)scrollNode:(INSKScrollNode *)scrollNode didChangeVisibleContentRect:(INSKScrollNodeVisibleContentChange)change;
+
+
+@end
+
+
+
+/**
+ The INSKScrollNode data source protocol which provides the items of a virtualized scroll node.
+
+ Only the items intersecting the visible area of the scroll node and a margin around it are materialized as nodes.
+ Nodes of items leaving this area are removed from the scroll content node and kept in a pool per reuse identifier,
+ so they can be reused for the next item with the same identifier entering the area.
+ */
+@protocol INSKScrollNodeDataSource <NSObject>
+
+/**
+ Returns the number of items in the scroll node.
+
+ @param scrollNode The INSKScrollNode node which asks for the items.
+ @return The number of items.
+ */
+- (NSUInteger)numberOfItemsInScrollNode:(INSKScrollNode *)scrollNode;
+
+
+/**
+ Returns the frame of an item in the scrollContentNode's coordinate system.
+
+ Like all content the frames have their origin at the top left corner of the content, so they should have negative values for the Y-axis.
+ The frames are only requested when the data is reloaded, so call reloadData after the layout has changed.
+
+ @param scrollNode The INSKScrollNode node which asks for the frame.
+ @param index The index of the item.
+ @return The frame of the item.
+ */
+- (CGRect)scrollNode:(INSKScrollNode *)scrollNode frameOfItemAtIndex:(NSUInteger)index;
+
+
+/**
+ Returns the node showing an item which has entered the visible area.
+
+ The scroll node adds the returned node to the scrollContentNode and positions it at the center of the item's frame.
+ Configure the reusable node for the item and return it, if there is one, instead of creating a new node.
+
+ @param scrollNode The INSKScrollNode node which asks for the node.
+ @param index The index of the item.
+ @param reusableNode A node of an item with the same reuse identifier which has left the visible area or nil if there is none.
+ @return The node for the item or nil if the item shouldn't be shown.
+ */
+- (SKNode *)scrollNode:(INSKScrollNode *)scrollNode nodeForItemAtIndex:(NSUInteger)index reusableNode:(SKNode *)reusableNode;
+
+@optional
+
+/**
+ Optional data source method which returns the type of an item's node.
+
+ Only nodes of the same type are reused for each other. All items have the same type if this method isn't implemented.
+
+ @param scrollNode The INSKScrollNode node which asks for the type.
+ @param index The index of the item.
+ @return The reuse identifier of the item.
+ */
+- (NSString *)scrollNode:(INSKScrollNode *)scrollNode reuseIdentifierForItemAtIndex:(NSUInteger)index;
+
+
+/**
+ Optional data source method which will be called when the content starts moving on its own with the items which will enter the visible area when the movement ends.
+ 
+ Use it to load the textures and data of the items before their nodes are requested.
+ The items are those intersecting the visible area at the predicted final position and the virtualizationMargin which aren't materialized yet.
+ 
+ @param scrollNode The INSKScrollNode node which informs about the items.
+ @param indexes The indexes of the items.
+ @see INSKScrollNodeDelegate
+ */
+- (void)scrollNode:(INSKScrollNode *)scrollNode prefetchItemsAtIndexes:(NSIndexSet *)indexes;
+
+
 @end
 
 
@@ -127,8 +268,16 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
     picture.position = CGPoint(scene.size.width / 2, -scene.size.height / 2);
     [scrollNode.scrollContentNode addChild:picture];
  
+ 
+ For big contents like long lists or grids set a dataSource instead of adding all content nodes at once.
+ The scroll node then only keeps nodes for the items inside of the visible area and recycles the others,
+ so the memory and the rendering time don't depend on the number of items anymore.
+ 
+    scrollNode.scrollContentSize = CGSizeMake(320, numberOfRows * rowHeight);
+    scrollNode.dataSource = self; // implements INSKScrollNodeDataSource
+ 
  */
-@interface INSKScrollNode : SKNode
+@interface INSKScrollNode : SKNode <INSKCoalescedTouchHandling>
 
 // ------------------------------------------------------------
 #pragma mark - properties
@@ -141,6 +290,25 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 @property (nonatomic, weak) id<INSKScrollNodeDelegate> scrollDelegate;
 
 
+/**
+ A not retained data source object which provides the items of a virtualized content. Defaults to nil.
+
+ Setting a data source loads its items with reloadData, setting nil removes all of its nodes.
+ The nodes of the data source are added to the scrollContentNode next to any other content.
+ 
+ @see reloadData
+ */
+@property (nonatomic, weak) id<INSKScrollNodeDataSource> dataSource;
+
+
+/**
+ The distance around the visible area in which the items of the dataSource are materialized too. Defaults to 64.
+
+ A margin keeps nodes from popping up at the borders and from being recycled and recreated when the content moves back and forth.
+ */
+@property (nonatomic, assign) CGFloat virtualizationMargin;
+
+
 /**
  The size of the scroll node itself.
 
@@ -251,6 +419,33 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 @property (nonatomic, assign) CGFloat deceleration;
 
 
+/**
+ Lets the content be dragged and decelerate beyond the content's borders and bounce back. Defaults to NO.
+ 
+ Dragging beyond the borders is damped like a rubber band and never exceeds the scroll node's size.
+ When released the content springs back to the border, also when a deceleration reaches the border with some velocity left.
+ */
+@property (nonatomic, assign) BOOL bounces;
+
+
+/**
+ The estimation of the velocity at which the content is released. Defaults to INSKScrollNodeVelocityEstimationLeastSquares.
+ 
+ The velocity is used for the deceleration and the paging direction and is reported to didScrollFromOffset:toOffset:velocity:.
+ @see INSKScrollNodeVelocityEstimation
+ */
+@property (nonatomic, assign) INSKScrollNodeVelocityEstimation velocityEstimation;
+
+
+/**
+ The time in seconds before the release or the latest movement from which movements are used to estimate the velocity. Defaults to 0.1.
+ 
+ Movements older than this are ignored, so content which has been held still before being released doesn't decelerate.
+ Set to 0 to use all of the last few movements.
+ */
+@property (nonatomic, assign) NSTimeInterval velocityEstimationWindow;
+
+
 /**
  Enables the user input recognition for the scrolling behavior. Defaults to YES.
  
@@ -260,6 +455,20 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 @property (nonatomic, assign, getter=isScrollingEnabled) BOOL scrollingEnabled;
 
 
+/**
+ Flag to inform the delegate about scrolling at most once per frame. Defaults to NO.
+ 
+ Without this flag scrollNode:didScrollFromOffset:toOffset:velocity: is called for every touch move, which may happen several times per rendered frame.
+ With this flag set the moves of a frame are reported as a single call from the offset before the first move to the offset after the last one
+ and additionally scrollNode:didChangeVisibleContentRect: reports the regions of the content which became visible or invisible in the frame.
+ The notifications are delivered by an action of the scroll node, which runs after the scene's update: method, or when the content is released.
+ 
+ @warning The actions of a paused scene or a scroll node without a scene don't run, call deliverScrollNotifications to get informed then.
+ @see deliverScrollNotifications
+ */
+@property (nonatomic, assign) BOOL coalescesScrollNotifications;
+
+
 // ------------------------------------------------------------
 #pragma mark - init methods
 // ------------------------------------------------------------
@@ -353,6 +562,91 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 - (NSUInteger)currentPageY;
 
 
+/**
+ The position the content will come to rest at.
+ 
+ While the content decelerates, snaps to a page, bounces back or scrolls animated this is the end position of the movement,
+ otherwise the current scrollContentPosition.
+ 
+ @return The predicted final position of the scrollContentNode.
+ */
+- (CGPoint)predictedScrollContentPosition;
+
+
+/**
+ The page's index on the X-axis the content will come to rest at.
+ 
+ Calculates
+ 
+    round(-self.predictedScrollContentPosition.x / self.pageSize.width)
+ 
+ @return The page index beginning with 0. Always 0 if page width is 0.
+ */
+- (NSUInteger)predictedPageX;
+
+
+/**
+ The page's index on the Y-axis the content will come to rest at.
+ 
+ Calculates
+ 
+    round(self.predictedScrollContentPosition.y / self.pageSize.height)
+ 
+ @return The page index beginning with 0. Always 0 if page height is 0.
+ */
+- (NSUInteger)predictedPageY;
+
+
+/**
+ The part of the content which is visible inside of the scroll node in the scrollContentNode's coordinate system.
+ 
+ Calculates
+ 
+    CGRectMake(-scrollContentPosition.x, -scrollContentPosition.y - scrollNodeSize.height, scrollNodeSize.width, scrollNodeSize.height)
+ 
+ @return The visible rect of the content.
+ */
+- (CGRect)visibleContentRect;
+
+
+/**
+ The part of the content which will be visible when the content comes to rest in the scrollContentNode's coordinate system.
+ 
+ @return The visible rect of the content at the predictedScrollContentPosition.
+ @see visibleContentRect
+ */
+- (CGRect)predictedVisibleContentRect;
+
+
+/**
+ Reloads the items of the dataSource.
+ 
+ All nodes of the items are recycled and the number of items and their frames are requested again from the data source,
+ afterwards the nodes of the visible items are requested.
+ Call this method whenever the items or their layout have changed.
+ 
+ @see dataSource
+ */
+- (void)reloadData;
+
+
+/**
+ Returns the node of an item of the dataSource.
+ 
+ @param index The index of the item.
+ @return The node of the item or nil if the item is not materialized, because it is outside of the visible area and the virtualizationMargin.
+ */
+- (SKNode *)nodeForItemAtIndex:(NSUInteger)index;
+
+
+/**
+ Delivers the buffered scroll notifications immediately.
+ 
+ Only needed when coalescesScrollNotifications is set and the delegate has to be informed before the next frame.
+ */
+- (void)deliverScrollNotifications;
+
+
 // ------------------------------------------------------------
 #pragma mark - subclassing methods
 // ------------------------------------------------------------
@@ -382,4 +676,26 @@ typedef NS_ENUM(NSInteger, INSKScrollNodeDecelerationMode) {
 - (void)didFinishScrollingAtPosition:(CGPoint)offset;
 
 
+/**
+ Will be called when the content starts decelerating, snapping to a page, bouncing back or scrolling animated.
+ 
+ Subclasses may override this method to prepare the content at the final position, but should never be called manually.
+ This method informs the delegate and the data source about the final position so subclasses should call super.
+ 
+ @param offset The predicted final scrollContentNode's position.
+ */
+- (void)willFinishScrollingAtPosition:(CGPoint)offset;
+
+
+/**
+ Will be called at most once per frame when coalescesScrollNotifications is set and the visible part of the content has changed.
+ 
+ Subclasses may override this method to update their content incrementally, but should never be called manually.
+ This method informs the delegate about the change so subclasses should call super.
+ 
+ @param change The visible rects of the last and this notification and the regions between them.
+ */
+- (void)didChangeVisibleContentRect:(INSKScrollNodeVisibleContentChange)change;
+
+
 @end
@@ -24,30 +24,73 @@
 #import "INSKScrollNode.h"
 #import "INSKOSBridge.h"
 #import "INSKMath.h"
+#import "INSKGeometry.h"
+#import "INSKVisibilityTracker.h"
+#import "INSKScrollPhysics.h"
+#import "INSKVelocityEstimator.h"
 #import "SKNode+INExtension.h"
 
 
+// The key of the action which steps the scroll physics each frame.
 static NSString * const ScrollContentMoveActionName = @"INSKScrollNodeMoveScrollContent";
-static CGFloat const ScrollContentMoveActionDuration = 0.3;
-static NSUInteger const MaxNumberOfVelocities = 5;
+// The duration of the action stepping the scroll physics, which only has to outlast any motion, the action is removed when the physics rest.
+static NSTimeInterval const ScrollContentMoveActionDuration = 60.0 * 60.0;
+static NSString * const DefaultItemReuseIdentifier = @"INSKScrollNodeDefaultItem";
+// The key of the action which delivers the coalesced scroll notifications.
+static NSString * const ScrollNotificationsActionName = @"INSKScrollNodeDeliverScrollNotifications";
 
 
-@interface INSKScrollNode ()
+@interface INSKScrollNode () {
+    // The physics moving the content, the content node's position is copied from them.
+    INSKScrollPhysics _physics;
+    // The estimator of the drag's velocity, reset when a drag begins.
+    INSKVelocityEstimator _velocityEstimator;
+}
 
 @property (nonatomic, strong, readwrite) SKSpriteNode *scrollBackgroundNode;
 @property (nonatomic, strong, readwrite) SKNode *scrollContentNode;
 
-@property (nonatomic, assign) NSTimeInterval lastTouchTimestamp;
-@property (nonatomic, strong) NSMutableArray *lastVelocities; // NSValue of CGPoint for avegate calculations
-
 // The number of mouse buttons this node is currently tracking. OS X only.
 @property (nonatomic, assign) NSUInteger numberOfMouseButtonsPressed;
 // The last mouse event's position. OS X only.
 @property (nonatomic, assign) CGPoint positionOfLastMouseEvent;
 
+// The tracker of the visible items of the data source, only used if a data source is set.
+@property (nonatomic, assign) INSKVisibilityTracker *visibilityTracker;
+// The frames of the data source's items as CGRect.
+@property (nonatomic, strong) NSMutableData *itemFrames;
+// The nodes of the materialized items and their reuse identifiers, both by the NSNumber of the item's index.
+@property (nonatomic, strong) NSMutableDictionary *itemNodes;
+@property (nonatomic, strong) NSMutableDictionary *itemReuseIdentifiers;
+// The recycled nodes by reuse identifier, each an NSMutableArray of SKNode.
+@property (nonatomic, strong) NSMutableDictionary *reusableItemNodes;
+
+// The drag waiting for its coalesced notification, the offset is from before the frame's first move.
+@property (nonatomic, assign) BOOL hasPendingScroll;
+@property (nonatomic, assign) CGPoint pendingScrollFromOffset;
+@property (nonatomic, assign) NSTimeInterval pendingScrollTimestamp;
+// The visible rect of the last coalesced notification.
+@property (nonatomic, assign) CGRect notifiedVisibleContentRect;
+
 @end
 
 
+// Visitor for the visibility tracker which collects the found items in a mutable index set passed as the context.
+static void INSKScrollNodeCollectItem(size_t item, void *context) {
+    [(__bridge NSMutableIndexSet *)context addIndex:item];
+}
+
+// Splits the part of a rect outside of another rect into at most four rects and returns their number.
+static NSUInteger INSKScrollNodeSubtractRect(CGRect rect, CGRect subtrahend, CGRect *pieces) {
+    INSKAxisAlignedBox boxes[INSKAxisAlignedBoxSubtractMaxPieces];
+    size_t count = INSKAxisAlignedBoxSubtract(INSKAxisAlignedBoxFromCGRect(rect), INSKAxisAlignedBoxFromCGRect(subtrahend), boxes);
+    for (size_t index = 0; index < count; ++index) {
+        pieces[index] = CGRectMake(boxes[index].min.x, boxes[index].min.y, boxes[index].max.x - boxes[index].min.x, boxes[index].max.y - boxes[index].min.y);
+    }
+    return count;
+}
+
+
 @implementation INSKScrollNode
 
 #pragma mark - public methods
@@ -67,8 +110,16 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     self.decelerationMode = INSKScrollNodeDecelerationModeNone;
     self.userInteractionEnabled = YES;
     self.scrollingEnabled = YES;
-    self.lastVelocities = [NSMutableArray arrayWithCapacity:MaxNumberOfVelocities];
+    self.velocityEstimation = INSKScrollNodeVelocityEstimationLeastSquares;
+    self.velocityEstimationWindow = 0.1;
+    INSKVelocityEstimatorInit(&_velocityEstimator);
     _clipContent = NO;
+    _virtualizationMargin = 64;
+    INSKScrollPhysicsInit(&_physics);
+    self.itemFrames = [NSMutableData data];
+    self.itemNodes = [NSMutableDictionary dictionary];
+    self.itemReuseIdentifiers = [NSMutableDictionary dictionary];
+    self.reusableItemNodes = [NSMutableDictionary dictionary];
     
     self.numberOfMouseButtonsPressed = 0;
 
@@ -84,6 +135,10 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     return self;
 }
 
+- (void)dealloc {
+    INSKVisibilityTrackerDestroy(_visibilityTracker);
+}
+
 - (void)setClipContent:(BOOL)clipContent {
     if (_clipContent == clipContent) {
         return;
@@ -126,6 +181,7 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     if (self.contentCropNode != nil) {
         ((SKSpriteNode *)self.contentCropNode.maskNode).size = scrollNodeSize;
     }
+    [self visibleContentRectDidChange];
 }
 
 - (void)setScrollContentSize:(CGSize)scrollContentSize {
@@ -158,30 +214,11 @@ static NSUInteger const MaxNumberOfVelocities = 5;
         return;
     }
 
-    // v(t) = a * t + v0; s(t) = (a/2) * t*t + v0 * t + s0
-    // v0 = v(t) - (a * t); sdiff = s(t) - s0; a = -2 * sdiff / t*t
-    CGPoint positionDifference = CGPointSubtract(scrollContentPosition, self.scrollContentPosition);
-    CGFloat differenceLength = CGPointLength(positionDifference);
-    CGPoint differenceNormalized = CGPointMultiplyScalar(positionDifference, 1.0 / differenceLength);
-    CGFloat deceleration = differenceLength * -2 / (duration * duration);
-    CGFloat velocity = deceleration * -duration;
-    
-    CGPoint startPosition = self.scrollContentPosition;
-    
-    SKAction *move = [SKAction customActionWithDuration:duration actionBlock:^(SKNode *node, CGFloat elapsedTime) {
-        CGFloat distance = (deceleration / 2) * (elapsedTime * elapsedTime) + velocity * elapsedTime;
-        CGPoint translation = CGPointMake(distance * differenceNormalized.x, distance * differenceNormalized.y);
-        CGPoint currentPosition = CGPointAdd(startPosition, translation);
-        currentPosition = [self positionWithScrollLimitsApplyed:currentPosition];
-        if (node.parent != self) {
-            currentPosition = [self convertPoint:currentPosition toNode:node.parent];
-        }
-        node.position = currentPosition;
-    }];
-    SKAction *callback = [SKAction runBlock:^{
-        [self didFinishScrollingAtPosition:self.scrollContentPosition];
-    }];
-    [self.scrollContentNode runActions:@[move, callback] withKey:ScrollContentMoveActionName];
+    [self stopScrollAnimations];
+    [self updatePhysicsParameters];
+    INSKScrollPhysicsSetPosition(&_physics, self.scrollContentPosition);
+    INSKScrollPhysicsScrollTo(&_physics, scrollContentPosition, duration, 0);
+    [self runScrollPhysics];
 }
 
 - (NSUInteger)numberOfPagesX {
@@ -212,165 +249,366 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     return 0;
 }
 
+- (CGRect)visibleContentRect {
+    return [self visibleContentRectAtPosition:self.scrollContentPosition];
+}
 
-#pragma mark - private methods
+- (void)setCoalescesScrollNotifications:(BOOL)coalescesScrollNotifications {
+    if (!coalescesScrollNotifications) {
+        [self deliverScrollNotifications];
+    }
+    _coalescesScrollNotifications = coalescesScrollNotifications;
+    self.notifiedVisibleContentRect = [self visibleContentRect];
+}
 
-// Position has to be in the coordinate system of self (INSKScrollNode).
-// Get the position via scrollContentPosition or convert manually if the crop node is active.
-- (CGPoint)positionWithScrollLimitsApplyed:(CGPoint)position {
-    // Limit scrolling horizontally
-    if (self.scrollContentSize.width <= self.scrollNodeSize.width) {
-        position = CGPointMake(0, position.y);
-    } else  if (position.x > 0.0) {
-        position = CGPointMake(0, position.y);
-    } else if (position.x < -(self.scrollContentSize.width - self.scrollNodeSize.width)) {
-        position = CGPointMake(-(self.scrollContentSize.width - self.scrollNodeSize.width), position.y);
+- (void)deliverScrollNotifications {
+    if (self.hasPendingScroll) {
+        self.hasPendingScroll = NO;
+        [self didScrollFromOffset:self.pendingScrollFromOffset toOffset:self.scrollContentPosition velocity:[self estimatedVelocityAtTimestamp:self.pendingScrollTimestamp]];
     }
-    
-    // Limit scrolling vertically
-    if (self.scrollContentSize.height <= self.scrollNodeSize.height) {
-        position = CGPointMake(position.x, 0);
-    } else if (position.y < 0.0) {
-        position = CGPointMake(position.x, 0);
-    } else if (position.y > self.scrollContentSize.height - self.scrollNodeSize.height) {
-        position = CGPointMake(position.x, self.scrollContentSize.height - self.scrollNodeSize.height);
+
+    CGRect previousRect = self.notifiedVisibleContentRect;
+    CGRect currentRect = [self visibleContentRect];
+    if (!self.coalescesScrollNotifications || CGRectEqualToRect(previousRect, currentRect)) {
+        return;
     }
-    
-    return position;
+    self.notifiedVisibleContentRect = currentRect;
+    INSKScrollNodeVisibleContentChange change;
+    change.previousRect = previousRect;
+    change.currentRect = currentRect;
+    change.enteredCount = INSKScrollNodeSubtractRect(currentRect, previousRect, change.enteredRects);
+    change.exitedCount = INSKScrollNodeSubtractRect(previousRect, currentRect, change.exitedRects);
+    [self didChangeVisibleContentRect:change];
+}
+
+- (CGPoint)predictedScrollContentPosition {
+    if (!INSKScrollPhysicsIsAnimating(&_physics)) {
+        return self.scrollContentPosition;
+    }
+    return INSKScrollPhysicsRestingPosition(&_physics);
 }
 
-- (void)applyScrollLimits {
-    CGPoint currentPosition = [self positionWithScrollLimitsApplyed:self.scrollContentPosition];
-    if (self.scrollContentNode.parent != self) {
-        currentPosition = [self convertPoint:currentPosition toNode:self.scrollContentNode.parent];
+- (NSUInteger)predictedPageX {
+    if (self.pageSize.width > 0) {
+        return roundf(-self.predictedScrollContentPosition.x / self.pageSize.width);
     }
-    self.scrollContentNode.position = currentPosition;
+    return 0;
 }
 
-- (void)stopScrollAnimations {
-    [self.scrollContentNode removeActionForKey:ScrollContentMoveActionName];
+- (NSUInteger)predictedPageY {
+    if (self.pageSize.height > 0) {
+        return roundf(self.predictedScrollContentPosition.y / self.pageSize.height);
+    }
+    return 0;
 }
 
-- (void)applyScrollOutWithVelocity:(CGPoint)velocity {
-    if (self.decelerationMode == INSKScrollNodeDecelerationModeNone) {
-        [self didFinishScrollingAtPosition:self.scrollContentPosition];
+- (CGRect)predictedVisibleContentRect {
+    return [self visibleContentRectAtPosition:self.predictedScrollContentPosition];
+}
+
+
+#pragma mark - virtualized content
+
+- (void)setDataSource:(id<INSKScrollNodeDataSource>)dataSource {
+    _dataSource = dataSource;
+    [self reloadData];
+}
+
+- (void)setVirtualizationMargin:(CGFloat)virtualizationMargin {
+    _virtualizationMargin = virtualizationMargin;
+    [self updateVisibleItems];
+}
+
+- (void)reloadData {
+    // Recycle all nodes, the data source may reuse them for other items.
+    if (self.visibilityTracker != NULL) {
+        INSKVisibilityTrackerReset(self.visibilityTracker);
+        [self recycleExitedItems];
+    }
+
+    id<INSKScrollNodeDataSource> dataSource = self.dataSource;
+    if (dataSource == nil) {
+        // Free all memory, the tracker will be recreated with the next data source.
+        INSKVisibilityTrackerDestroy(self.visibilityTracker);
+        self.visibilityTracker = NULL;
+        [self.itemFrames setLength:0];
+        [self.reusableItemNodes removeAllObjects];
         return;
     }
-    
-    if (self.decelerationMode == INSKScrollNodeDecelerationModeDecelerate) {
-        // Any velocity at all?
-        if (CGPointNearToPoint(velocity, CGPointZero)) {
+    if (self.visibilityTracker == NULL) {
+        self.visibilityTracker = INSKVisibilityTrackerCreate();
+        if (self.visibilityTracker == NULL) {
             return;
         }
-        
-        // Calculate and apply animation
-        // v(t) = a * t + v0; s(t) = (a/2) * t*t + v0 * t + s0
-        CGFloat velocityLength = CGPointLength(velocity);
-        CGFloat time = velocityLength / self.deceleration;
-        CGPoint velocityNormalized = CGPointMultiplyScalar(velocity, 1.0 / velocityLength);
-        
-        CGPoint startPosition = self.scrollContentPosition;
-        
-        SKAction *move = [SKAction customActionWithDuration:time actionBlock:^(SKNode *node, CGFloat elapsedTime) {
-            CGFloat distance = -self.deceleration * elapsedTime * elapsedTime / 2 + velocityLength * elapsedTime;
-            CGPoint translation = CGPointMake(distance * velocityNormalized.x, distance * velocityNormalized.y);
-            CGPoint currentPosition = CGPointAdd(startPosition, translation);
-            currentPosition = [self positionWithScrollLimitsApplyed:currentPosition];
-            if (node.parent != self) {
-                currentPosition = [self convertPoint:currentPosition toNode:node.parent];
-            }
-            node.position = currentPosition;
-        }];
-        SKAction *callback = [SKAction runBlock:^{
-            [self didFinishScrollingAtPosition:self.scrollContentPosition];
-        }];
-        [self.scrollContentNode runActions:@[move, callback] withKey:ScrollContentMoveActionName];
+    }
 
+    NSUInteger count = [dataSource numberOfItemsInScrollNode:self];
+    [self.itemFrames setLength:count * sizeof(CGRect)];
+    CGRect *frames = self.itemFrames.mutableBytes;
+    INSKSpatialBounds *bounds = malloc(MAX(count, 1) * sizeof(INSKSpatialBounds));
+    if (bounds == NULL) {
+        INSKVisibilityTrackerSetItems(self.visibilityTracker, NULL, 0);
         return;
     }
-    
-    // Calculate translation for page snapping
-    CGPoint translation = CGPointZero;
-    
-    if (self.pageSize.width > 0) {
-        CGFloat translationX = (NSInteger)self.scrollContentPosition.x % (NSInteger)self.pageSize.width;
-        BOOL snappingOccured = NO;
-        if (self.decelerationMode == INSKScrollNodeDecelerationModePagingDirection) {
-            if (velocity.x < 0) {
-                translation.x = -self.pageSize.width - translationX;
-                snappingOccured = YES;
-            } else if (velocity.x > 0) {
-                translation.x = -translationX;
-                snappingOccured = YES;
-            } else {
-                // Use INSKScrollNodeDecelerationModePagingHalfPage behavior
-            }
+    for (NSUInteger index = 0; index < count; ++index) {
+        CGRect frame = CGRectStandardize([dataSource scrollNode:self frameOfItemAtIndex:index]);
+        frames[index] = frame;
+        bounds[index] = (INSKSpatialBounds){CGRectGetMinX(frame), CGRectGetMinY(frame), CGRectGetMaxX(frame), CGRectGetMaxY(frame)};
+    }
+    // Without the memory for the items nothing is shown, which is the best that can be done.
+    INSKVisibilityTrackerSetItems(self.visibilityTracker, bounds, count);
+    free(bounds);
+
+    [self updateVisibleItems];
+}
+
+- (SKNode *)nodeForItemAtIndex:(NSUInteger)index {
+    return self.itemNodes[@(index)];
+}
+
+// Materializes the items entering the visible area and recycles the leaving ones.
+- (void)updateVisibleItems {
+    if (self.visibilityTracker == NULL) {
+        return;
+    }
+    CGRect visibleRect = CGRectInset([self visibleContentRect], -self.virtualizationMargin, -self.virtualizationMargin);
+    INSKSpatialBounds viewport = {CGRectGetMinX(visibleRect), CGRectGetMinY(visibleRect), CGRectGetMaxX(visibleRect), CGRectGetMaxY(visibleRect)};
+    INSKVisibilityTrackerUpdate(self.visibilityTracker, viewport);
+
+    // Recycle first, so the nodes can be reused for the entering items right away.
+    [self recycleExitedItems];
+
+    size_t count;
+    const size_t *entered = INSKVisibilityTrackerEntered(self.visibilityTracker, &count);
+    if (count == 0) {
+        return;
+    }
+    id<INSKScrollNodeDataSource> dataSource = self.dataSource;
+    BOOL hasReuseIdentifiers = [dataSource respondsToSelector:@selector(scrollNode:reuseIdentifierForItemAtIndex:)];
+    const CGRect *frames = self.itemFrames.bytes;
+    for (size_t enteredIndex = 0; enteredIndex < count; ++enteredIndex) {
+        NSUInteger index = entered[enteredIndex];
+        NSString *reuseIdentifier = hasReuseIdentifiers ? [dataSource scrollNode:self reuseIdentifierForItemAtIndex:index] : nil;
+        if (reuseIdentifier == nil) {
+            reuseIdentifier = DefaultItemReuseIdentifier;
         }
-        if (!snappingOccured) {
-            if (fabs(translationX) >= self.pageSize.width / 2) {
-                translation.x = -self.pageSize.width - translationX;
-            } else {
-                translation.x = -translationX;
-            }
+        NSMutableArray *reusableNodes = self.reusableItemNodes[reuseIdentifier];
+        SKNode *reusableNode = [reusableNodes lastObject];
+        if (reusableNode != nil) {
+            [reusableNodes removeLastObject];
         }
+
+        SKNode *node = [dataSource scrollNode:self nodeForItemAtIndex:index reusableNode:reusableNode];
+        if (node == nil) {
+            continue;
+        }
+        node.position = CGPointMake(CGRectGetMidX(frames[index]), CGRectGetMidY(frames[index]));
+        if (node.parent != self.scrollContentNode) {
+            [node removeFromParent];
+            [self.scrollContentNode addChild:node];
+        }
+        self.itemNodes[@(index)] = node;
+        self.itemReuseIdentifiers[@(index)] = reuseIdentifier;
     }
-    
-    if (self.pageSize.height > 0) {
-        CGFloat translationY = (NSInteger)self.scrollContentPosition.y % (NSInteger)self.pageSize.height;
-        BOOL snappingOccured = NO;
-        if (self.decelerationMode == INSKScrollNodeDecelerationModePagingDirection) {
-            if (velocity.y > 0) {
-                translation.y = self.pageSize.height - translationY;
-                snappingOccured = YES;
-            } else if (velocity.y < 0) {
-                translation.y = -translationY;
-                snappingOccured = YES;
-            } else {
-                // Use INSKScrollNodeDecelerationModePagingHalfPage behavior
-            }
+}
+
+// Removes the nodes of the items which have left the visible area and puts them into the reuse pools.
+- (void)recycleExitedItems {
+    size_t count;
+    const size_t *exited = INSKVisibilityTrackerExited(self.visibilityTracker, &count);
+    for (size_t exitedIndex = 0; exitedIndex < count; ++exitedIndex) {
+        NSNumber *index = @(exited[exitedIndex]);
+        SKNode *node = self.itemNodes[index];
+        if (node == nil) {
+            continue;
         }
-        if (!snappingOccured) {
-            if (translationY >= self.pageSize.height / 2) {
-                translation.y = self.pageSize.height - translationY;
-            } else {
-                translation.y = -translationY;
-            }
+        NSString *reuseIdentifier = self.itemReuseIdentifiers[index];
+        NSMutableArray *reusableNodes = self.reusableItemNodes[reuseIdentifier];
+        if (reusableNodes == nil) {
+            reusableNodes = [NSMutableArray array];
+            self.reusableItemNodes[reuseIdentifier] = reusableNodes;
         }
+        [node removeFromParent];
+        [reusableNodes addObject:node];
+        [self.itemNodes removeObjectForKey:index];
+        [self.itemReuseIdentifiers removeObjectForKey:index];
     }
+}
 
-    // Apply scroll bounds for destination position
-    CGPoint destinationPosition = CGPointAdd(self.scrollContentPosition, translation);
-    destinationPosition = [self positionWithScrollLimitsApplyed:destinationPosition];
-    
-    // Apply snap animation
-    if (!CGPointNearToPoint(destinationPosition, self.scrollContentPosition)) {
-        SKAction *move = [SKAction moveTo:destinationPosition duration:ScrollContentMoveActionDuration];
-        move.timingMode = SKActionTimingEaseOut;
-        SKAction *callback = [SKAction runBlock:^{
-            [self didFinishScrollingAtPosition:destinationPosition];
-        }];
-        [self.scrollContentNode runActions:@[move, callback] withKey:ScrollContentMoveActionName];
+
+#pragma mark - private methods
+
+// Updates everything depending on the visible part of the content after the content has moved or the scroll node has been resized.
+- (void)visibleContentRectDidChange {
+    [self updateVisibleItems];
+    [self scheduleScrollNotifications];
+}
+
+// Makes sure the coalesced scroll notifications are delivered in this frame.
+- (void)scheduleScrollNotifications {
+    if (!self.coalescesScrollNotifications || [self actionForKey:ScrollNotificationsActionName] != nil) {
+        return;
     }
+    // Actions are evaluated once per frame after the scene's update: method.
+    __weak INSKScrollNode *weakSelf = self;
+    [self runAction:[SKAction runBlock:^{
+        [weakSelf deliverScrollNotifications];
+    }] withKey:ScrollNotificationsActionName];
 }
 
-- (void)addVelocityToAverage:(CGPoint)velocity {
-    if (self.lastVelocities.count == MaxNumberOfVelocities) {
-        [self.lastVelocities removeObjectAtIndex:0];
+// Informs about a drag of the user at once or buffers it for the coalesced notification.
+- (void)notifyScrollFromOffset:(CGPoint)fromOffset timestamp:(NSTimeInterval)timestamp {
+    if (!self.coalescesScrollNotifications) {
+        [self didScrollFromOffset:fromOffset toOffset:self.scrollContentPosition velocity:[self estimatedVelocityAtTimestamp:timestamp]];
+        return;
+    }
+    if (!self.hasPendingScroll) {
+        self.hasPendingScroll = YES;
+        self.pendingScrollFromOffset = fromOffset;
     }
-    NSValue *value = [NSValue valueWithCGPoint:velocity];
-    [self.lastVelocities addObject:value];
+    self.pendingScrollTimestamp = timestamp;
+    [self scheduleScrollNotifications];
 }
 
-- (CGPoint)getAveragedVelocity {
-    CGPoint velocity = CGPointZero;
-    for (NSValue *value in self.lastVelocities) {
-        CGPoint point = [value CGPointValue];
-        velocity = CGPointAdd(velocity, point);
+// Position has to be in the coordinate system of self (INSKScrollNode) like scrollContentPosition.
+- (CGRect)visibleContentRectAtPosition:(CGPoint)position {
+    return CGRectMake(-position.x, -position.y - self.scrollNodeSize.height, self.scrollNodeSize.width, self.scrollNodeSize.height);
+}
+
+// Asks the data source to prefetch the items which will enter the visible area and the margin around it at a position.
+- (void)prefetchItemsAtPosition:(CGPoint)position {
+    id<INSKScrollNodeDataSource> dataSource = self.dataSource;
+    if (self.visibilityTracker == NULL || ![dataSource respondsToSelector:@selector(scrollNode:prefetchItemsAtIndexes:)]) {
+        return;
     }
-    if (self.lastVelocities.count > 0) {
-        velocity = CGPointDivideScalar(velocity, self.lastVelocities.count);
+    CGRect rect = CGRectInset([self visibleContentRectAtPosition:position], -self.virtualizationMargin, -self.virtualizationMargin);
+    INSKSpatialBounds bounds = {CGRectGetMinX(rect), CGRectGetMinY(rect), CGRectGetMaxX(rect), CGRectGetMaxY(rect)};
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    INSKVisibilityTrackerQuery(self.visibilityTracker, bounds, INSKScrollNodeCollectItem, (__bridge void *)indexes);
+    // The visible items have their nodes already.
+    size_t count;
+    const size_t *visible = INSKVisibilityTrackerVisible(self.visibilityTracker, &count);
+    for (size_t visibleIndex = 0; visibleIndex < count; ++visibleIndex) {
+        [indexes removeIndex:visible[visibleIndex]];
     }
-    return velocity;
+    if (indexes.count > 0) {
+        [dataSource scrollNode:self prefetchItemsAtIndexes:indexes];
+    }
+}
+
+// Position has to be in the coordinate system of self (INSKScrollNode).
+// Get the position via scrollContentPosition or convert manually if the crop node is active.
+- (CGPoint)positionWithScrollLimitsApplyed:(CGPoint)position {
+    [self updatePhysicsParameters];
+    return INSKScrollPhysicsClampPosition(&_physics, position);
+}
+
+// Copies the properties into the physics, which limit the position horizontally to [-(contentWidth - width), 0] and vertically to [0, contentHeight - height].
+- (void)updatePhysicsParameters {
+    CGFloat maxX = MAX(self.scrollContentSize.width - self.scrollNodeSize.width, 0);
+    CGFloat maxY = MAX(self.scrollContentSize.height - self.scrollNodeSize.height, 0);
+    INSKScrollPhysicsSetLimits(&_physics, CGPointMake(-maxX, 0), CGPointMake(0, maxY));
+    _physics.mode = (INSKScrollPhysicsMode)self.decelerationMode;
+    _physics.deceleration = self.deceleration;
+    _physics.pageSize = self.pageSize;
+    _physics.viewportSize = self.scrollNodeSize;
+    _physics.bounces = self.bounces;
+}
+
+// Moves the content node to the position of the physics.
+- (void)applyPhysicsPosition {
+    CGPoint position = INSKScrollPhysicsPosition(&_physics);
+    if (self.scrollContentNode.parent != self) {
+        position = [self convertPoint:position toNode:self.scrollContentNode.parent];
+    }
+    self.scrollContentNode.position = position;
+    [self visibleContentRectDidChange];
+}
+
+// Moves the content by a drag of the user, starting the drag at the current position if needed.
+- (void)dragScrollContentBy:(CGPoint)translation {
+    if (!INSKScrollPhysicsIsDragging(&_physics)) {
+        [self updatePhysicsParameters];
+        INSKScrollPhysicsBeginDrag(&_physics, self.scrollContentPosition);
+    }
+    INSKScrollPhysicsDrag(&_physics, translation);
+    [self applyPhysicsPosition];
+}
+
+// Runs the motion of the physics with the start time 0 until it rests.
+- (void)runScrollPhysics {
+    [self applyPhysicsPosition];
+    if (!INSKScrollPhysicsIsAnimating(&_physics)) {
+        [self didFinishScrollingAtPosition:self.scrollContentPosition];
+        return;
+    }
+    [self willFinishScrollingAtPosition:INSKScrollPhysicsRestingPosition(&_physics)];
+
+    // A single action steps the physics each frame with the time elapsed in the scene,
+    // so the motion pauses with the scene instead of jumping ahead when it resumes.
+    __weak INSKScrollNode *weakSelf = self;
+    [self.scrollContentNode runAction:[SKAction customActionWithDuration:ScrollContentMoveActionDuration actionBlock:^(SKNode *node, CGFloat elapsedTime) {
+        [weakSelf stepScrollPhysicsAtTime:elapsedTime];
+    }] withKey:ScrollContentMoveActionName];
+}
+
+// Moves the content to the physics' position at the time since the motion has started and stops the motion when the physics rest.
+- (void)stepScrollPhysicsAtTime:(NSTimeInterval)time {
+    // The physics are closed-form functions of the time, so dropped frames don't slow down the motion.
+    BOOL animating = INSKScrollPhysicsStep(&_physics, time);
+    [self applyPhysicsPosition];
+    if (animating) {
+        return;
+    }
+    [self stopScrollAnimations];
+    [self didFinishScrollingAtPosition:self.scrollContentPosition];
+}
+
+- (void)applyScrollLimits {
+    CGPoint currentPosition = [self positionWithScrollLimitsApplyed:self.scrollContentPosition];
+    if (self.scrollContentNode.parent != self) {
+        currentPosition = [self convertPoint:currentPosition toNode:self.scrollContentNode.parent];
+    }
+    self.scrollContentNode.position = currentPosition;
+    [self visibleContentRectDidChange];
+}
+
+- (void)stopScrollAnimations {
+    [self.scrollContentNode removeActionForKey:ScrollContentMoveActionName];
+    INSKScrollPhysicsStop(&_physics);
+}
+
+- (void)applyScrollOutWithVelocity:(CGPoint)velocity {
+    // The drag's notifications come before the ones of the motion.
+    [self deliverScrollNotifications];
+
+    // The physics decelerate, snap to a page or bounce back depending on the mode.
+    [self updatePhysicsParameters];
+    if (!INSKScrollPhysicsIsDragging(&_physics)) {
+        INSKScrollPhysicsBeginDrag(&_physics, self.scrollContentPosition);
+    }
+    INSKScrollPhysicsRelease(&_physics, velocity, 0);
+    [self runScrollPhysics];
+}
+
+- (void)beginVelocityEstimationAtTimestamp:(NSTimeInterval)timestamp {
+    _velocityEstimator.method = (INSKVelocityEstimatorMethod)self.velocityEstimation;
+    _velocityEstimator.window = self.velocityEstimationWindow;
+    INSKVelocityEstimatorReset(&_velocityEstimator, timestamp);
+}
+
+- (void)addVelocityMovement:(CGPoint)translation timestamp:(NSTimeInterval)timestamp {
+    INSKVelocityEstimatorAddMovement(&_velocityEstimator, translation, timestamp);
+}
+
+- (CGPoint)estimatedVelocityAtTimestamp:(NSTimeInterval)timestamp {
+    return INSKVelocityEstimatorVelocity(&_velocityEstimator, timestamp);
+}
+
+// Location has to be in the coordinate system of self (INSKScrollNode).
+- (BOOL)isLocationInsideScrollNode:(CGPoint)location {
+    INSKAxisAlignedBox bounds = INSKAxisAlignedBoxFromCGRect(CGRectMake(0, 0, self.scrollNodeSize.width, -self.scrollNodeSize.height));
+    return INSKAxisAlignedBoxContainsPoint(bounds, location);
 }
 
 
@@ -384,8 +622,7 @@ static NSUInteger const MaxNumberOfVelocities = 5;
         [self stopScrollAnimations];
 
         UITouch *touch = [touches anyObject];
-        self.lastTouchTimestamp = touch.timestamp;
-        [self.lastVelocities removeAllObjects];
+        [self beginVelocityEstimationAtTimestamp:touch.timestamp];
     }
 }
 
@@ -399,8 +636,7 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     // Ignore touches outside of scroll node if clipping is on
     if (self.clipContent) {
         CGPoint locationInBounds = [self.scene convertPoint:location toNode:self];
-        CGRect frame = CGRectMake(0, 0, self.scrollNodeSize.width, -self.scrollNodeSize.height);
-        if (!CGRectContainsPoint(frame, locationInBounds)) {
+        if (![self isLocationInsideScrollNode:locationInBounds]) {
             return;
         }
     }
@@ -409,32 +645,29 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     CGPoint lastLocation = [touch previousLocationInNode:self.scene];
     CGPoint translation = CGPointSubtract(location, lastLocation);
     CGPoint oldPosition = self.scrollContentNode.position;
-    self.scrollContentNode.position = CGPointAdd(self.scrollContentNode.position, translation);
+    [self dragScrollContentBy:translation];
 
-    // Calculate velocity
-    NSTimeInterval timeDifferecne = touch.timestamp - self.lastTouchTimestamp;
-    self.lastTouchTimestamp = touch.timestamp;
-    CGPoint scrollVelocity = CGPointDivideScalar(translation, timeDifferecne);
-    [self addVelocityToAverage:scrollVelocity];
-
-    [self applyScrollLimits];
+    // Estimate velocity
+    [self addVelocityMovement:translation timestamp:touch.timestamp];
     
     // Inform subclasses and delegate
-    [self didScrollFromOffset:oldPosition toOffset:self.scrollContentPosition velocity:[self getAveragedVelocity]];
+    [self notifyScrollFromOffset:oldPosition timestamp:touch.timestamp];
 }
 
 - (void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event {
     if (!self.scrollingEnabled) return;
 
     if (event.allTouches.count == touches.count) {
-        [self applyScrollOutWithVelocity:[self getAveragedVelocity]];
+        UITouch *touch = [touches anyObject];
+        [self applyScrollOutWithVelocity:[self estimatedVelocityAtTimestamp:touch.timestamp]];
     }
 }
 
 - (void)touchesCancelled:(NSSet *)touches withEvent:(UIEvent *)event {
     if (!self.scrollingEnabled) return;
 
-    [self applyScrollOutWithVelocity:[self getAveragedVelocity]];
+    UITouch *touch = [touches anyObject];
+    [self applyScrollOutWithVelocity:[self estimatedVelocityAtTimestamp:touch.timestamp]];
 }
 
 #else // OSX
@@ -462,9 +695,8 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     if (self.numberOfMouseButtonsPressed == 1) {
         [self stopScrollAnimations];
         
-        self.lastTouchTimestamp = theEvent.timestamp;
         self.positionOfLastMouseEvent = [theEvent locationInNode:self];
-        [self.lastVelocities removeAllObjects];
+        [self beginVelocityEstimationAtTimestamp:theEvent.timestamp];
     }
 }
 
@@ -486,8 +718,7 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     // Ignore touches outside of scroll node if clipping is on
     CGPoint location = [theEvent locationInNode:self];
     if (self.clipContent) {
-        CGRect frame = CGRectMake(0, 0, self.scrollNodeSize.width, -self.scrollNodeSize.height);
-        if (!CGRectContainsPoint(frame, location)) {
+        if (![self isLocationInsideScrollNode:location]) {
             return;
         }
     }
@@ -496,20 +727,15 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     CGPoint lastLocation = self.positionOfLastMouseEvent;
     CGPoint translation = CGPointSubtract(location, lastLocation);
     CGPoint oldPosition = self.scrollContentNode.position;
-    self.scrollContentNode.position = CGPointAdd(self.scrollContentNode.position, translation);
+    [self dragScrollContentBy:translation];
 
-    // Calculate velocity
-    NSTimeInterval timeDifferecne = theEvent.timestamp - self.lastTouchTimestamp;
-    CGPoint scrollVelocity = CGPointDivideScalar(translation, timeDifferecne);
-    [self addVelocityToAverage:scrollVelocity];
+    // Estimate velocity
+    [self addVelocityMovement:translation timestamp:theEvent.timestamp];
 
-    self.lastTouchTimestamp = theEvent.timestamp;
     self.positionOfLastMouseEvent = location;
-
-    [self applyScrollLimits];
     
     // Inform subclasses and delegate
-    [self didScrollFromOffset:oldPosition toOffset:self.scrollContentPosition velocity:[self getAveragedVelocity]];
+    [self notifyScrollFromOffset:oldPosition timestamp:theEvent.timestamp];
 }
 
 - (void)mouseUp:(NSEvent *)theEvent {
@@ -532,13 +758,62 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     
     // Apply deceleration only when the last button has been lifted
     if (self.numberOfMouseButtonsPressed == 0) {
-        [self applyScrollOutWithVelocity:[self getAveragedVelocity]];
+        [self applyScrollOutWithVelocity:[self estimatedVelocityAtTimestamp:theEvent.timestamp]];
     }
 }
 
 #endif
 
 
+#pragma mark - coalesced touch handling
+
+- (void)touchMovedCoalesced:(id)touch samples:(const INSKTouchSample *)samples count:(NSUInteger)count startLocation:(CGPoint)startLocation {
+    if (!self.scrollingEnabled) return;
+
+    // Touches are handled in the scene's coordinate system on iOS and in the node's one on OS X.
+#if TARGET_OS_IPHONE
+    CGPoint location = samples[count - 1].location;
+    CGPoint lastLocation = startLocation;
+#else
+    CGPoint location = [self convertPointFromScene:samples[count - 1].location];
+    CGPoint lastLocation = self.positionOfLastMouseEvent;
+#endif
+    
+    // Add the movement of each sample, so the velocity isn't falsified by the coalescing.
+    // Samples outside of the scroll node are ignored if clipping is on, like the touches of touchesMoved:withEvent:.
+    CGPoint previousSampleLocation = lastLocation;
+    for (NSUInteger index = 0; index < count; ++index) {
+        CGPoint sampleLocation = samples[index].location;
+#if !TARGET_OS_IPHONE
+        sampleLocation = [self convertPointFromScene:sampleLocation];
+#endif
+        if (!self.clipContent || [self isLocationInsideScrollNode:[self convertPointFromScene:samples[index].location]]) {
+            [self addVelocityMovement:CGPointSubtract(sampleLocation, previousSampleLocation) timestamp:samples[index].timestamp];
+        }
+        previousSampleLocation = sampleLocation;
+    }
+    
+    // Ignore touches outside of scroll node if clipping is on
+    if (self.clipContent) {
+        CGPoint locationInBounds = [self convertPointFromScene:samples[count - 1].location];
+        if (![self isLocationInsideScrollNode:locationInBounds]) {
+            return;
+        }
+    }
+#if !TARGET_OS_IPHONE
+    self.positionOfLastMouseEvent = location;
+#endif
+
+    // Apply the translation of all samples at once
+    CGPoint translation = CGPointSubtract(location, lastLocation);
+    CGPoint oldPosition = self.scrollContentNode.position;
+    [self dragScrollContentBy:translation];
+    
+    // Inform subclasses and delegate
+    [self notifyScrollFromOffset:oldPosition timestamp:samples[count - 1].timestamp];
+}
+
+
 #pragma mark - methods to override
 
 - (void)didScrollFromOffset:(CGPoint)fromOffset toOffset:(CGPoint)toOffset velocity:(CGPoint)velocity {
@@ -553,5 +828,18 @@ static NSUInteger const MaxNumberOfVelocities = 5;
     }
 }
 
+- (void)didChangeVisibleContentRect:(INSKScrollNodeVisibleContentChange)change {
+    if ([self.scrollDelegate respondsToSelector:@selector(scrollNode:didChangeVisibleContentRect:)]) {
+        [self.scrollDelegate scrollNode:self didChangeVisibleContentRect:change];
+    }
+}
+
+- (void)willFinishScrollingAtPosition:(CGPoint)offset {
+    [self prefetchItemsAtPosition:offset];
+    if ([self.scrollDelegate respondsToSelector:@selector(scrollNode:willFinishScrollingAtPosition:visibleContentRect:)]) {
+        [self.scrollDelegate scrollNode:self willFinishScrollingAtPosition:offset visibleContentRect:[self visibleContentRectAtPosition:offset]];
+    }
+}
+
 
 @end
@@ -0,0 +1,399 @@
+// INSKScrollPhysics.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKScrollPhysics.h"
+#include <math.h>
+
+
+// A bouncing axis comes to rest when it is nearer than this to the limit and slower than INSKScrollPhysicsRestVelocity.
+#define INSKScrollPhysicsRestDistance 0.1
+#define INSKScrollPhysicsRestVelocity 1.0
+// The step of the numerical derivative of the snap curves.
+#define INSKScrollPhysicsCurveDelta 0.001
+
+
+#pragma mark - private functions
+
+static CGFloat INSKScrollPhysicsClamp(CGFloat value, CGFloat min, CGFloat max) {
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+// The damped distance of an overscroll, which approaches the dimension for long drags.
+static CGFloat INSKScrollPhysicsRubberBand(CGFloat overscroll, CGFloat constant, CGFloat dimension) {
+    if (!(constant > 0) || !(dimension > 0)) {
+        return 0;
+    }
+    return dimension * overscroll * constant / (overscroll * constant + dimension);
+}
+
+// The inverse of INSKScrollPhysicsRubberBand(), used to continue a drag from an overscrolled position.
+static CGFloat INSKScrollPhysicsRubberBandInverse(CGFloat distance, CGFloat constant, CGFloat dimension) {
+    if (!(constant > 0) || !(dimension > 0)) {
+        return 0;
+    }
+    if (distance >= dimension) {
+        distance = dimension * (1 - INSK_EPSILON);
+    }
+    return distance * dimension / (constant * (dimension - distance));
+}
+
+// Returns the displayed position of an unlimited drag position.
+static CGFloat INSKScrollPhysicsDragDisplay(const INSKScrollPhysics *physics, CGFloat position, CGFloat min, CGFloat max, CGFloat dimension) {
+    if (position < min) {
+        return physics->bounces ? min - INSKScrollPhysicsRubberBand(min - position, physics->rubberBandConstant, dimension) : min;
+    }
+    if (position > max) {
+        return physics->bounces ? max + INSKScrollPhysicsRubberBand(position - max, physics->rubberBandConstant, dimension) : max;
+    }
+    return position;
+}
+
+static void INSKScrollPhysicsAxisRest(INSKScrollPhysicsAxis *axis, CGFloat position) {
+    axis->phase = INSKScrollPhysicsPhaseRest;
+    axis->position = position;
+    axis->velocity = 0;
+}
+
+static void INSKScrollPhysicsAxisBeginDrag(const INSKScrollPhysics *physics, INSKScrollPhysicsAxis *axis, CGFloat position, CGFloat min, CGFloat max, CGFloat dimension) {
+    axis->phase = INSKScrollPhysicsPhaseDrag;
+    axis->position = position;
+    axis->velocity = 0;
+    // Find the drag position which is displayed at the position, so the content doesn't jump.
+    if (position < min && physics->bounces) {
+        axis->dragPosition = min - INSKScrollPhysicsRubberBandInverse(min - position, physics->rubberBandConstant, dimension);
+    } else if (position > max && physics->bounces) {
+        axis->dragPosition = max + INSKScrollPhysicsRubberBandInverse(position - max, physics->rubberBandConstant, dimension);
+    } else {
+        axis->dragPosition = position;
+    }
+}
+
+// Starts a critically damped spring from the position towards the target.
+static void INSKScrollPhysicsAxisStartBounce(INSKScrollPhysicsAxis *axis, double timestamp, CGFloat position, CGFloat velocity, CGFloat target) {
+    axis->phase = INSKScrollPhysicsPhaseBounce;
+    axis->startTime = timestamp;
+    axis->startPosition = position;
+    axis->startVelocity = velocity;
+    axis->target = target;
+    axis->position = position;
+    axis->velocity = velocity;
+}
+
+static void INSKScrollPhysicsAxisStartSnap(INSKScrollPhysicsAxis *axis, double timestamp, CGFloat target, double duration, INSKEasingCurve curve) {
+    if (ScalarNearOther(axis->position, target) || !(duration > 0)) {
+        INSKScrollPhysicsAxisRest(axis, target);
+        return;
+    }
+    axis->phase = INSKScrollPhysicsPhaseSnap;
+    axis->startTime = timestamp;
+    axis->startPosition = axis->position;
+    axis->target = target;
+    axis->duration = duration;
+    axis->curve = curve;
+}
+
+// Starts a deceleration, which ends when the velocity reaches zero or at the first limit on the way.
+static void INSKScrollPhysicsAxisStartDecelerate(INSKScrollPhysicsAxis *axis, double timestamp, CGFloat velocity, CGFloat acceleration, double duration, CGFloat min, CGFloat max, bool bounces) {
+    CGFloat position = axis->position;
+    axis->phase = INSKScrollPhysicsPhaseDecelerate;
+    axis->startTime = timestamp;
+    axis->startPosition = position;
+    axis->startVelocity = velocity;
+    axis->acceleration = acceleration;
+    axis->duration = duration;
+    axis->velocity = velocity;
+    axis->bouncesAtEnd = false;
+    // A constant deceleration to zero at the end is the quadratic ease out curve.
+    axis->curve = INSKEasingCurveMake(INSKEasingTypeQuadOut);
+
+    // s(t) = s0 + v0 * t + (a/2) * t*t, which stops at s0 + v0 * T / 2.
+    CGFloat end = position + velocity * (CGFloat)duration / 2;
+    if (end >= min && end <= max) {
+        axis->target = end;
+        return;
+    }
+
+    // Stop at the limit, the earlier root of (a/2) * t*t + v0 * t + (s0 - limit) = 0 in a cancellation free form.
+    CGFloat limit = (end < min) ? min : max;
+    CGFloat discriminant = velocity * velocity - 2 * acceleration * (position - limit);
+    CGFloat root = sqrt(discriminant > 0 ? discriminant : 0);
+    CGFloat denominator = (velocity > 0) ? velocity + root : velocity - root;
+    double time = (denominator != 0) ? 2 * (limit - position) / denominator : 0;
+    axis->duration = INSKScrollPhysicsClamp(time, 0, duration);
+    axis->target = limit;
+    axis->bouncesAtEnd = bounces;
+}
+
+// Moves an axis which ended outside of the limits back inside.
+static void INSKScrollPhysicsAxisEndInsideLimits(const INSKScrollPhysics *physics, INSKScrollPhysicsAxis *axis, double timestamp, CGFloat min, CGFloat max) {
+    CGFloat limited = INSKScrollPhysicsClamp(axis->position, min, max);
+    if (limited == axis->position) {
+        return;
+    }
+    if (physics->bounces) {
+        INSKScrollPhysicsAxisStartBounce(axis, timestamp, axis->position, 0, limited);
+    } else {
+        INSKScrollPhysicsAxisRest(axis, limited);
+    }
+}
+
+static void INSKScrollPhysicsAxisStep(const INSKScrollPhysics *physics, INSKScrollPhysicsAxis *axis, double timestamp, CGFloat min, CGFloat max) {
+    // A phase may end within the step and start the next one, which then is evaluated at the same time.
+    for (;;) {
+        double elapsed = timestamp - axis->startTime;
+        if (elapsed < 0) {
+            elapsed = 0;
+        }
+        switch (axis->phase) {
+            case INSKScrollPhysicsPhaseDecelerate: {
+                if (elapsed >= axis->duration) {
+                    double endTime = axis->startTime + axis->duration;
+                    CGFloat endVelocity = axis->startVelocity + axis->acceleration * (CGFloat)axis->duration;
+                    INSKScrollPhysicsAxisRest(axis, axis->target);
+                    if (axis->bouncesAtEnd) {
+                        INSKScrollPhysicsAxisStartBounce(axis, endTime, axis->target, endVelocity, axis->target);
+                        continue;
+                    }
+                    INSKScrollPhysicsAxisEndInsideLimits(physics, axis, endTime, min, max);
+                    if (axis->phase != INSKScrollPhysicsPhaseRest) {
+                        continue;
+                    }
+                    return;
+                }
+                // The curve runs over the time to the full stop, so a deceleration ending early at a limit follows the same curve.
+                CGFloat t = (CGFloat)elapsed;
+                if (axis->acceleration != 0) {
+                    CGFloat stopDuration = -axis->startVelocity / axis->acceleration;
+                    CGFloat stopDistance = axis->startVelocity * stopDuration / 2;
+                    axis->position = axis->startPosition + stopDistance * INSKEasingCurveEvaluate(axis->curve, t / stopDuration);
+                }
+                axis->velocity = axis->startVelocity + axis->acceleration * t;
+                break;
+            }
+            case INSKScrollPhysicsPhaseBounce: {
+                // x(t) = target + (d0 + (v0 + w * d0) * t) * e^(-w * t)
+                CGFloat frequency = physics->bounceFrequency;
+                if (!(frequency > 0)) {
+                    INSKScrollPhysicsAxisRest(axis, INSKScrollPhysicsClamp(axis->target, min, max));
+                    return;
+                }
+                CGFloat t = (CGFloat)elapsed;
+                CGFloat distance = axis->startPosition - axis->target;
+                CGFloat slope = axis->startVelocity + frequency * distance;
+                CGFloat decay = exp(-frequency * t);
+                CGFloat offset = (distance + slope * t) * decay;
+                axis->velocity = (axis->startVelocity - frequency * slope * t) * decay;
+                axis->position = axis->target + offset;
+                if (fabs(offset) < INSKScrollPhysicsRestDistance && fabs(axis->velocity) < INSKScrollPhysicsRestVelocity) {
+                    // The limits may have changed during the bounce.
+                    INSKScrollPhysicsAxisRest(axis, INSKScrollPhysicsClamp(axis->target, min, max));
+                }
+                return;
+            }
+            case INSKScrollPhysicsPhaseSnap: {
+                if (elapsed >= axis->duration) {
+                    double endTime = axis->startTime + axis->duration;
+                    INSKScrollPhysicsAxisRest(axis, axis->target);
+                    INSKScrollPhysicsAxisEndInsideLimits(physics, axis, endTime, min, max);
+                    if (axis->phase != INSKScrollPhysicsPhaseRest) {
+                        continue;
+                    }
+                    return;
+                }
+                CGFloat progress = (CGFloat)(elapsed / axis->duration);
+                CGFloat distance = axis->target - axis->startPosition;
+                axis->position = axis->startPosition + distance * INSKEasingCurveEvaluate(axis->curve, progress);
+                CGFloat before = MAX(progress - INSKScrollPhysicsCurveDelta, 0);
+                CGFloat after = MIN(progress + INSKScrollPhysicsCurveDelta, 1);
+                CGFloat slope = (INSKEasingCurveEvaluate(axis->curve, after) - INSKEasingCurveEvaluate(axis->curve, before)) / (after - before);
+                axis->velocity = distance * slope / (CGFloat)axis->duration;
+                break;
+            }
+            default:
+                return;
+        }
+        // Without bouncing the content never leaves the limits, even if they changed during the motion.
+        if (!physics->bounces) {
+            axis->position = INSKScrollPhysicsClamp(axis->position, min, max);
+        }
+        return;
+    }
+}
+
+static void INSKScrollPhysicsAxisRelease(const INSKScrollPhysics *physics, INSKScrollPhysicsAxis *axis, double timestamp, CGFloat velocity, CGFloat speed, CGFloat pageSize, CGFloat min, CGFloat max) {
+    CGFloat position = axis->position;
+    INSKScrollPhysicsAxisRest(axis, position);
+
+    // An overscrolled axis always returns to the limit.
+    if (position < min || position > max) {
+        INSKScrollPhysicsAxisStartBounce(axis, timestamp, position, 0, INSKScrollPhysicsClamp(position, min, max));
+        return;
+    }
+
+    switch (physics->mode) {
+        case INSKScrollPhysicsModeDecelerate: {
+            if (velocity == 0 || !(speed > 0) || !(physics->deceleration > 0)) {
+                return;
+            }
+            // Both axes decelerate along the direction of the velocity, so they stop at the same time.
+            CGFloat acceleration = -physics->deceleration * velocity / speed;
+            INSKScrollPhysicsAxisStartDecelerate(axis, timestamp, velocity, acceleration, speed / physics->deceleration, min, max, physics->bounces);
+            return;
+        }
+        case INSKScrollPhysicsModePagingHalfPage:
+        case INSKScrollPhysicsModePagingDirection: {
+            if (!(pageSize > 0)) {
+                return;
+            }
+            CGFloat page = position / pageSize;
+            CGFloat targetPage = round(page);
+            if (physics->mode == INSKScrollPhysicsModePagingDirection && velocity != 0) {
+                targetPage = (velocity > 0) ? ceil(page) : floor(page);
+            }
+            CGFloat target = INSKScrollPhysicsClamp(targetPage * pageSize, min, max);
+            INSKScrollPhysicsAxisStartSnap(axis, timestamp, target, physics->pagingDuration, physics->pagingCurve);
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+
+#pragma mark - public functions
+
+void INSKScrollPhysicsInit(INSKScrollPhysics *physics) {
+    physics->mode = INSKScrollPhysicsModeNone;
+    physics->deceleration = 10000;
+    physics->pageSize = CGSizeMake(0, 0);
+    physics->pagingDuration = 0.3;
+    physics->pagingCurve = INSKEasingCurveMake(INSKEasingTypeQuadOut);
+    physics->bounces = false;
+    physics->viewportSize = CGSizeMake(0, 0);
+    physics->rubberBandConstant = 0.55;
+    physics->bounceFrequency = 12;
+    physics->minPosition = CGPointMake(0, 0);
+    physics->maxPosition = CGPointMake(0, 0);
+    INSKScrollPhysicsAxis axis = {INSKScrollPhysicsPhaseRest, 0, 0, 0, 0, 0, 0, 0, 0, 0, false, INSKEasingCurveMake(INSKEasingTypeLinear)};
+    physics->x = axis;
+    physics->y = axis;
+}
+
+void INSKScrollPhysicsSetLimits(INSKScrollPhysics *physics, CGPoint minPosition, CGPoint maxPosition) {
+    physics->minPosition = minPosition;
+    physics->maxPosition = CGPointMake(MAX(minPosition.x, maxPosition.x), MAX(minPosition.y, maxPosition.y));
+    if (physics->x.phase == INSKScrollPhysicsPhaseRest) {
+        physics->x.position = INSKScrollPhysicsClamp(physics->x.position, physics->minPosition.x, physics->maxPosition.x);
+    }
+    if (physics->y.phase == INSKScrollPhysicsPhaseRest) {
+        physics->y.position = INSKScrollPhysicsClamp(physics->y.position, physics->minPosition.y, physics->maxPosition.y);
+    }
+}
+
+CGPoint INSKScrollPhysicsClampPosition(const INSKScrollPhysics *physics, CGPoint position) {
+    return CGPointMake(INSKScrollPhysicsClamp(position.x, physics->minPosition.x, physics->maxPosition.x),
+                       INSKScrollPhysicsClamp(position.y, physics->minPosition.y, physics->maxPosition.y));
+}
+
+void INSKScrollPhysicsSetPosition(INSKScrollPhysics *physics, CGPoint position) {
+    position = INSKScrollPhysicsClampPosition(physics, position);
+    INSKScrollPhysicsAxisRest(&physics->x, position.x);
+    INSKScrollPhysicsAxisRest(&physics->y, position.y);
+}
+
+void INSKScrollPhysicsBeginDrag(INSKScrollPhysics *physics, CGPoint position) {
+    INSKScrollPhysicsAxisBeginDrag(physics, &physics->x, position.x, physics->minPosition.x, physics->maxPosition.x, physics->viewportSize.width);
+    INSKScrollPhysicsAxisBeginDrag(physics, &physics->y, position.y, physics->minPosition.y, physics->maxPosition.y, physics->viewportSize.height);
+}
+
+void INSKScrollPhysicsDrag(INSKScrollPhysics *physics, CGPoint translation) {
+    if (!INSKScrollPhysicsIsDragging(physics)) {
+        INSKScrollPhysicsBeginDrag(physics, INSKScrollPhysicsPosition(physics));
+    }
+    INSKScrollPhysicsAxis *x = &physics->x;
+    INSKScrollPhysicsAxis *y = &physics->y;
+    x->dragPosition += translation.x;
+    y->dragPosition += translation.y;
+    if (!physics->bounces) {
+        // Without a rubber band the drag stops at the limits, so dragging back moves the content at once.
+        x->dragPosition = INSKScrollPhysicsClamp(x->dragPosition, physics->minPosition.x, physics->maxPosition.x);
+        y->dragPosition = INSKScrollPhysicsClamp(y->dragPosition, physics->minPosition.y, physics->maxPosition.y);
+    }
+    x->position = INSKScrollPhysicsDragDisplay(physics, x->dragPosition, physics->minPosition.x, physics->maxPosition.x, physics->viewportSize.width);
+    y->position = INSKScrollPhysicsDragDisplay(physics, y->dragPosition, physics->minPosition.y, physics->maxPosition.y, physics->viewportSize.height);
+}
+
+void INSKScrollPhysicsRelease(INSKScrollPhysics *physics, CGPoint velocity, double timestamp) {
+    CGFloat speed = sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+    INSKScrollPhysicsAxisRelease(physics, &physics->x, timestamp, velocity.x, speed, physics->pageSize.width, physics->minPosition.x, physics->maxPosition.x);
+    INSKScrollPhysicsAxisRelease(physics, &physics->y, timestamp, velocity.y, speed, physics->pageSize.height, physics->minPosition.y, physics->maxPosition.y);
+    INSKScrollPhysicsStep(physics, timestamp);
+}
+
+void INSKScrollPhysicsScrollTo(INSKScrollPhysics *physics, CGPoint position, double duration, double timestamp) {
+    position = INSKScrollPhysicsClampPosition(physics, position);
+    if (!(duration > 0)) {
+        INSKScrollPhysicsSetPosition(physics, position);
+        return;
+    }
+    // A constant deceleration to zero at the end is the quadratic ease out curve.
+    INSKEasingCurve curve = INSKEasingCurveMake(INSKEasingTypeQuadOut);
+    INSKScrollPhysicsAxisRest(&physics->x, physics->x.position);
+    INSKScrollPhysicsAxisRest(&physics->y, physics->y.position);
+    INSKScrollPhysicsAxisStartSnap(&physics->x, timestamp, position.x, duration, curve);
+    INSKScrollPhysicsAxisStartSnap(&physics->y, timestamp, position.y, duration, curve);
+}
+
+void INSKScrollPhysicsStop(INSKScrollPhysics *physics) {
+    INSKScrollPhysicsAxisRest(&physics->x, INSKScrollPhysicsClamp(physics->x.position, physics->minPosition.x, physics->maxPosition.x));
+    INSKScrollPhysicsAxisRest(&physics->y, INSKScrollPhysicsClamp(physics->y.position, physics->minPosition.y, physics->maxPosition.y));
+}
+
+bool INSKScrollPhysicsStep(INSKScrollPhysics *physics, double timestamp) {
+    INSKScrollPhysicsAxisStep(physics, &physics->x, timestamp, physics->minPosition.x, physics->maxPosition.x);
+    INSKScrollPhysicsAxisStep(physics, &physics->y, timestamp, physics->minPosition.y, physics->maxPosition.y);
+    return INSKScrollPhysicsIsAnimating(physics);
+}
+
+CGPoint INSKScrollPhysicsPosition(const INSKScrollPhysics *physics) {
+    return CGPointMake(physics->x.position, physics->y.position);
+}
+
+CGPoint INSKScrollPhysicsVelocity(const INSKScrollPhysics *physics) {
+    return CGPointMake(physics->x.velocity, physics->y.velocity);
+}
+
+CGPoint INSKScrollPhysicsRestingPosition(const INSKScrollPhysics *physics) {
+    // Every motion ends at its target, a deceleration crossing a limit bounces back to it.
+    CGFloat x = (physics->x.phase > INSKScrollPhysicsPhaseDrag) ? physics->x.target : physics->x.position;
+    CGFloat y = (physics->y.phase > INSKScrollPhysicsPhaseDrag) ? physics->y.target : physics->y.position;
+    return INSKScrollPhysicsClampPosition(physics, CGPointMake(x, y));
+}
+
+bool INSKScrollPhysicsIsAnimating(const INSKScrollPhysics *physics) {
+    return physics->x.phase > INSKScrollPhysicsPhaseDrag || physics->y.phase > INSKScrollPhysicsPhaseDrag;
+}
+
+bool INSKScrollPhysicsIsDragging(const INSKScrollPhysics *physics) {
+    return physics->x.phase == INSKScrollPhysicsPhaseDrag || physics->y.phase == INSKScrollPhysicsPhaseDrag;
+}
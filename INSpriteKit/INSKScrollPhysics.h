@@ -0,0 +1,307 @@
+// INSKScrollPhysics.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_SCROLL_PHYSICS_H
+#define INSK_SCROLL_PHYSICS_H
+
+#include <stdbool.h>
+#include "INSKMath.h"
+#include "INSKMathEasing.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ------------------------------------------------------------
+#pragma mark - types
+// ------------------------------------------------------------
+/// @name types
+
+/**
+ What happens after the content has been released, the values match INSKScrollNodeDecelerationMode.
+ */
+typedef enum {
+    /// The content stops where it has been released.
+    INSKScrollPhysicsModeNone = 0,
+    /// The content snaps to the nearest page.
+    INSKScrollPhysicsModePagingHalfPage,
+    /// The content snaps to the next page in the direction of the release velocity.
+    INSKScrollPhysicsModePagingDirection,
+    /// The content decelerates with a constant rate.
+    INSKScrollPhysicsModeDecelerate
+} INSKScrollPhysicsMode;
+
+/**
+ The motion of one axis of a INSKScrollPhysics.
+ */
+typedef enum {
+    /// The axis doesn't move.
+    INSKScrollPhysicsPhaseRest = 0,
+    /// The axis follows a drag.
+    INSKScrollPhysicsPhaseDrag,
+    /// The axis decelerates with a constant rate.
+    INSKScrollPhysicsPhaseDecelerate,
+    /// The axis springs back from an overscroll to the limit.
+    INSKScrollPhysicsPhaseBounce,
+    /// The axis moves along an easing curve to a target, used for paging and animated scrolling.
+    INSKScrollPhysicsPhaseSnap
+} INSKScrollPhysicsPhase;
+
+/**
+ The state of one axis of a INSKScrollPhysics, don't change it directly.
+
+ Each phase is a closed-form function of the time since the phase started,
+ so the positions don't depend on how often or at which times the physics are stepped.
+ */
+typedef struct {
+    INSKScrollPhysicsPhase phase;
+    /// The current position and velocity.
+    CGFloat position;
+    CGFloat velocity;
+    /// The unlimited position of a drag, which is rubber banded into the displayed position.
+    CGFloat dragPosition;
+    /// The start of the current phase.
+    double startTime;
+    CGFloat startPosition;
+    CGFloat startVelocity;
+    /// The signed deceleration of a deceleration phase.
+    CGFloat acceleration;
+    /// The duration of a deceleration or snap phase.
+    double duration;
+    /// The end position of a snap or bounce phase.
+    CGFloat target;
+    /// Whether the axis bounces at the limit after a deceleration phase, which then has ended at the limit.
+    bool bouncesAtEnd;
+    /// The easing of a snap or deceleration phase.
+    INSKEasingCurve curve;
+} INSKScrollPhysicsAxis;
+
+/**
+ The scroll physics of the content of a scroll view, i.e. INSKScrollNode.
+
+ This is a plain C implementation without any dependencies to Sprite Kit or Foundation and can be used on any platform.
+ The content is dragged with INSKScrollPhysicsDrag() and afterwards released with INSKScrollPhysicsRelease(),
+ which starts a deceleration, page snapping or bounce back depending on the mode.
+ Call INSKScrollPhysicsStep() once per frame with the current time and copy the position with INSKScrollPhysicsPosition().
+ All motions are closed-form functions of the timestamps, so the same inputs always lead to the same positions,
+ independent of the frame rate.
+ The physics never allocate any memory.
+
+ The parameters may be changed directly at any time, they are used by the next drag, release or scroll animation.
+ Change the limits with INSKScrollPhysicsSetLimits() though, so the position is kept inside.
+ Initialize the physics with INSKScrollPhysicsInit() before use.
+ */
+typedef struct {
+    /// What happens after the content has been released. Defaults to INSKScrollPhysicsModeNone.
+    INSKScrollPhysicsMode mode;
+    /// The deceleration in points per squared second for INSKScrollPhysicsModeDecelerate. Defaults to 10'000.
+    CGFloat deceleration;
+    /// The size of a page for the paging modes, a width or height of 0 disables paging on that axis. Defaults to zero.
+    CGSize pageSize;
+    /// The duration of the snap to a page in seconds. Defaults to 0.3.
+    CGFloat pagingDuration;
+    /// The easing of the snap to a page. Defaults to INSKEasingTypeQuadOut.
+    INSKEasingCurve pagingCurve;
+    /// Whether the content can be dragged or decelerate beyond the limits and bounces back. Defaults to false.
+    bool bounces;
+    /// The size of the visible area, the maximum overscroll of a drag. Defaults to zero.
+    CGSize viewportSize;
+    /// How strong a drag beyond the limits is damped, 0 stops at once and bigger values give in more. Defaults to 0.55.
+    CGFloat rubberBandConstant;
+    /// The angular frequency in radians per second of the critically damped spring pulling the content back to the limits. Defaults to 12.
+    CGFloat bounceFrequency;
+
+    /// The range of the position, set with INSKScrollPhysicsSetLimits().
+    CGPoint minPosition;
+    CGPoint maxPosition;
+    /// The state of the axes.
+    INSKScrollPhysicsAxis x;
+    INSKScrollPhysicsAxis y;
+} INSKScrollPhysics;
+
+
+// ------------------------------------------------------------
+#pragma mark - setup
+// ------------------------------------------------------------
+/// @name setup
+
+/**
+ Initializes the physics with the default parameters, the limits and the position at zero.
+
+ @param physics The physics.
+ */
+void INSKScrollPhysicsInit(INSKScrollPhysics *physics);
+
+/**
+ Sets the range of the position.
+
+ A resting position outside of the new limits is moved inside, running motions keep running and end inside of the new limits.
+
+ @param physics The physics.
+ @param minPosition The smallest position on both axes.
+ @param maxPosition The biggest position on both axes, a smaller value than the minimum is raised to the minimum.
+ */
+void INSKScrollPhysicsSetLimits(INSKScrollPhysics *physics, CGPoint minPosition, CGPoint maxPosition);
+
+/**
+ Returns a position moved into the limits.
+
+ @param physics The physics.
+ @param position The position.
+ @return The nearest position inside of the limits.
+ */
+CGPoint INSKScrollPhysicsClampPosition(const INSKScrollPhysics *physics, CGPoint position);
+
+
+// ------------------------------------------------------------
+#pragma mark - input
+// ------------------------------------------------------------
+/// @name input
+
+/**
+ Stops any motion and moves the content to a position at once.
+
+ @param physics The physics.
+ @param position The new position, which is moved into the limits.
+ */
+void INSKScrollPhysicsSetPosition(INSKScrollPhysics *physics, CGPoint position);
+
+/**
+ Stops any motion and starts a drag at a position.
+
+ The position isn't limited, so the content may be dragged on from an overscroll.
+
+ @param physics The physics.
+ @param position The current position of the content.
+ */
+void INSKScrollPhysicsBeginDrag(INSKScrollPhysics *physics, CGPoint position);
+
+/**
+ Moves the content with a drag.
+
+ Starts a drag at the current position if none is running.
+ Without bouncing the position stops at the limits, otherwise the movement beyond the limits is damped like a rubber band
+ and the content can't be dragged further than viewportSize beyond the limits.
+
+ @param physics The physics.
+ @param translation The movement of the finger or mouse.
+ */
+void INSKScrollPhysicsDrag(INSKScrollPhysics *physics, CGPoint translation);
+
+/**
+ Ends a drag and starts the motion of the mode.
+
+ An axis dragged beyond the limits always bounces back.
+
+ @param physics The physics.
+ @param velocity The velocity of the drag in points per second.
+ @param timestamp The time of the release in seconds, the time base of the following steps.
+ */
+void INSKScrollPhysicsRelease(INSKScrollPhysics *physics, CGPoint velocity, double timestamp);
+
+/**
+ Moves the content to a position in a given time with a constant deceleration.
+
+ @param physics The physics.
+ @param position The target position, which is moved into the limits.
+ @param duration The duration of the motion in seconds, 0 or less moves the content at once.
+ @param timestamp The start time of the motion in seconds.
+ */
+void INSKScrollPhysicsScrollTo(INSKScrollPhysics *physics, CGPoint position, double duration, double timestamp);
+
+/**
+ Stops any motion and drag at the current position, which is moved into the limits.
+
+ @param physics The physics.
+ */
+void INSKScrollPhysicsStop(INSKScrollPhysics *physics);
+
+
+// ------------------------------------------------------------
+#pragma mark - simulation
+// ------------------------------------------------------------
+/// @name simulation
+
+/**
+ Advances the motion to a time.
+
+ Times before the start of the motion count as its start.
+
+ @param physics The physics.
+ @param timestamp The current time in seconds, using the same time base as the release or scroll animation.
+ @return True if the content is still moving, false if it has come to rest or is dragged.
+ */
+bool INSKScrollPhysicsStep(INSKScrollPhysics *physics, double timestamp);
+
+/**
+ Returns the current position.
+
+ @param physics The physics.
+ @return The position of the last step, drag or reset.
+ */
+CGPoint INSKScrollPhysicsPosition(const INSKScrollPhysics *physics);
+
+/**
+ Returns the current velocity.
+
+ @param physics The physics.
+ @return The velocity of the last step in points per second, zero while resting or dragging.
+ */
+CGPoint INSKScrollPhysicsVelocity(const INSKScrollPhysics *physics);
+
+/**
+ Returns the position at which the current motion comes to rest.
+
+ The motions are closed-form, so the position is known as soon as a release or scroll animation starts,
+ i.e. to load the content there before it becomes visible.
+ Later changes of the limits or parameters aren't foreseen.
+
+ @param physics The physics.
+ @return The end position of the motion, the current position moved into the limits if the content rests or is dragged.
+ */
+CGPoint INSKScrollPhysicsRestingPosition(const INSKScrollPhysics *physics);
+
+/**
+ Returns whether the content moves on its own.
+
+ @param physics The physics.
+ @return True if any axis decelerates, bounces or snaps.
+ */
+bool INSKScrollPhysicsIsAnimating(const INSKScrollPhysics *physics);
+
+/**
+ Returns whether the content is dragged.
+
+ @param physics The physics.
+ @return True between the start of a drag and the release.
+ */
+bool INSKScrollPhysicsIsDragging(const INSKScrollPhysics *physics);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
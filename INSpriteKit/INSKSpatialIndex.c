@@ -0,0 +1,336 @@
+// INSKSpatialIndex.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKSpatialIndex.h"
+#include <stdlib.h>
+#include <math.h>
+
+
+// The maximum depth of the tree, deeper trees won't speed up queries anymore.
+#define INSKSpatialIndexMaxDepthLimit 24
+// The initial number of entries for the entry and node arrays.
+#define INSKSpatialIndexInitialCapacity 16
+
+
+typedef struct INSKSpatialIndexNode {
+    // The four quadrants, created lazily, in the order bottom left, bottom right, top left, top right.
+    struct INSKSpatialIndexNode *children[4];
+    // The center and the half size of the node's cell, the loose bounds are twice as big as the cell.
+    double centerX;
+    double centerY;
+    double halfSize;
+    unsigned int depth;
+    // The indexes of the entries stored in this node.
+    size_t *entries;
+    size_t count;
+    size_t capacity;
+} INSKSpatialIndexNode;
+
+typedef struct {
+    INSKSpatialBounds bounds;
+    void *object;
+    // The node the entry is stored in or NULL if the entry is unused.
+    INSKSpatialIndexNode *node;
+    // The position inside of the node's entries array or the next free entry if unused.
+    size_t slot;
+} INSKSpatialIndexEntry;
+
+struct INSKSpatialIndex {
+    INSKSpatialIndexNode root;
+    unsigned int maxDepth;
+    INSKSpatialIndexEntry *entries;
+    size_t entriesUsed;
+    size_t entriesCapacity;
+    size_t freeEntry;
+    size_t count;
+};
+
+
+#pragma mark - private functions
+
+static void INSKSpatialIndexNodeFreeChildren(INSKSpatialIndexNode *node) {
+    for (int i = 0; i < 4; ++i) {
+        INSKSpatialIndexNode *child = node->children[i];
+        if (child != NULL) {
+            INSKSpatialIndexNodeFreeChildren(child);
+            free(child->entries);
+            free(child);
+            node->children[i] = NULL;
+        }
+    }
+}
+
+static void INSKSpatialIndexSetupRoot(INSKSpatialIndex *index, INSKSpatialBounds worldBounds) {
+    double width = worldBounds.maxX - worldBounds.minX;
+    double height = worldBounds.maxY - worldBounds.minY;
+    double size = (width > height) ? width : height;
+    if (!(size > 0.0) || !isfinite(size)) {
+        // Degenerated world, all objects will be kept in the root.
+        size = 0.0;
+    }
+    index->root.centerX = (worldBounds.minX + worldBounds.maxX) / 2.0;
+    index->root.centerY = (worldBounds.minY + worldBounds.maxY) / 2.0;
+    index->root.halfSize = size / 2.0;
+    index->root.depth = 0;
+}
+
+static bool INSKSpatialIndexNodeContainsCenter(const INSKSpatialIndexNode *node, double x, double y) {
+    return x >= node->centerX - node->halfSize && x < node->centerX + node->halfSize
+        && y >= node->centerY - node->halfSize && y < node->centerY + node->halfSize;
+}
+
+// Returns the quadrant of the node in which the point lies.
+static int INSKSpatialIndexNodeQuadrant(const INSKSpatialIndexNode *node, double x, double y) {
+    return (x >= node->centerX ? 1 : 0) + (y >= node->centerY ? 2 : 0);
+}
+
+// Walks down the tree to the node where the bounds belong to.
+// If create is false NULL is returned when the node doesn't exist yet.
+static INSKSpatialIndexNode *INSKSpatialIndexFindNode(INSKSpatialIndex *index, INSKSpatialBounds bounds, bool create) {
+    INSKSpatialIndexNode *node = &index->root;
+    double x = (bounds.minX + bounds.maxX) / 2.0;
+    double y = (bounds.minY + bounds.maxY) / 2.0;
+    double width = bounds.maxX - bounds.minX;
+    double height = bounds.maxY - bounds.minY;
+    double halfExtent = ((width > height) ? width : height) / 2.0;
+
+    // Objects outside of the world or with invalid bounds stay in the root.
+    if (!INSKSpatialIndexNodeContainsCenter(node, x, y) || !(halfExtent >= 0.0)) {
+        return node;
+    }
+
+    while (node->depth < index->maxDepth) {
+        // An object fits into a child's loose bounds when its center is inside of the child's cell
+        // and it is not bigger than the child's cell.
+        double childHalfSize = node->halfSize / 2.0;
+        if (halfExtent > childHalfSize) {
+            break;
+        }
+        int quadrant = INSKSpatialIndexNodeQuadrant(node, x, y);
+        INSKSpatialIndexNode *child = node->children[quadrant];
+        if (child == NULL) {
+            if (!create) {
+                return NULL;
+            }
+            child = calloc(1, sizeof(INSKSpatialIndexNode));
+            if (child == NULL) {
+                // Out of memory, keep the object in the current node.
+                break;
+            }
+            child->halfSize = childHalfSize;
+            child->centerX = node->centerX + ((quadrant & 1) ? childHalfSize : -childHalfSize);
+            child->centerY = node->centerY + ((quadrant & 2) ? childHalfSize : -childHalfSize);
+            child->depth = node->depth + 1;
+            node->children[quadrant] = child;
+        }
+        node = child;
+    }
+    return node;
+}
+
+static bool INSKSpatialIndexNodeAddEntry(INSKSpatialIndex *index, INSKSpatialIndexNode *node, size_t entryIndex) {
+    if (node->count == node->capacity) {
+        size_t capacity = (node->capacity == 0) ? 4 : node->capacity * 2;
+        size_t *entries = realloc(node->entries, capacity * sizeof(size_t));
+        if (entries == NULL) {
+            return false;
+        }
+        node->entries = entries;
+        node->capacity = capacity;
+    }
+    INSKSpatialIndexEntry *entry = &index->entries[entryIndex];
+    entry->node = node;
+    entry->slot = node->count;
+    node->entries[node->count++] = entryIndex;
+    return true;
+}
+
+static void INSKSpatialIndexNodeRemoveEntry(INSKSpatialIndex *index, size_t entryIndex) {
+    INSKSpatialIndexEntry *entry = &index->entries[entryIndex];
+    INSKSpatialIndexNode *node = entry->node;
+    // Move the last entry into the gap.
+    size_t lastEntryIndex = node->entries[--node->count];
+    node->entries[entry->slot] = lastEntryIndex;
+    index->entries[lastEntryIndex].slot = entry->slot;
+    entry->node = NULL;
+}
+
+static void INSKSpatialIndexReleaseEntry(INSKSpatialIndex *index, size_t entryIndex) {
+    INSKSpatialIndexEntry *entry = &index->entries[entryIndex];
+    entry->node = NULL;
+    entry->object = NULL;
+    entry->slot = index->freeEntry;
+    index->freeEntry = entryIndex;
+    index->count--;
+}
+
+static bool INSKSpatialBoundsContainPoint(INSKSpatialBounds bounds, double x, double y) {
+    return x >= bounds.minX && x <= bounds.maxX && y >= bounds.minY && y <= bounds.maxY;
+}
+
+static bool INSKSpatialBoundsIntersect(INSKSpatialBounds bounds, INSKSpatialBounds other) {
+    return bounds.minX <= other.maxX && bounds.maxX >= other.minX && bounds.minY <= other.maxY && bounds.maxY >= other.minY;
+}
+
+// The loose bounds of a node are twice the size of its cell.
+static INSKSpatialBounds INSKSpatialIndexNodeLooseBounds(const INSKSpatialIndexNode *node) {
+    double looseHalfSize = node->halfSize * 2.0;
+    INSKSpatialBounds bounds = {node->centerX - looseHalfSize, node->centerY - looseHalfSize, node->centerX + looseHalfSize, node->centerY + looseHalfSize};
+    return bounds;
+}
+
+static size_t INSKSpatialIndexNodeQueryPoint(const INSKSpatialIndex *index, const INSKSpatialIndexNode *node, double x, double y, INSKSpatialIndexVisitor visitor, void *context) {
+    size_t found = 0;
+    for (size_t i = 0; i < node->count; ++i) {
+        const INSKSpatialIndexEntry *entry = &index->entries[node->entries[i]];
+        if (INSKSpatialBoundsContainPoint(entry->bounds, x, y)) {
+            visitor(entry->object, context);
+            found++;
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        const INSKSpatialIndexNode *child = node->children[i];
+        if (child != NULL && INSKSpatialBoundsContainPoint(INSKSpatialIndexNodeLooseBounds(child), x, y)) {
+            found += INSKSpatialIndexNodeQueryPoint(index, child, x, y, visitor, context);
+        }
+    }
+    return found;
+}
+
+static size_t INSKSpatialIndexNodeQueryBounds(const INSKSpatialIndex *index, const INSKSpatialIndexNode *node, INSKSpatialBounds bounds, INSKSpatialIndexVisitor visitor, void *context) {
+    size_t found = 0;
+    for (size_t i = 0; i < node->count; ++i) {
+        const INSKSpatialIndexEntry *entry = &index->entries[node->entries[i]];
+        if (INSKSpatialBoundsIntersect(entry->bounds, bounds)) {
+            visitor(entry->object, context);
+            found++;
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        const INSKSpatialIndexNode *child = node->children[i];
+        if (child != NULL && INSKSpatialBoundsIntersect(INSKSpatialIndexNodeLooseBounds(child), bounds)) {
+            found += INSKSpatialIndexNodeQueryBounds(index, child, bounds, visitor, context);
+        }
+    }
+    return found;
+}
+
+
+#pragma mark - public functions
+
+INSKSpatialIndex *INSKSpatialIndexCreate(INSKSpatialBounds worldBounds, unsigned int maxDepth) {
+    INSKSpatialIndex *index = calloc(1, sizeof(INSKSpatialIndex));
+    if (index == NULL) {
+        return NULL;
+    }
+    index->maxDepth = (maxDepth > INSKSpatialIndexMaxDepthLimit) ? INSKSpatialIndexMaxDepthLimit : maxDepth;
+    index->freeEntry = INSKSpatialIndexInvalidHandle;
+    INSKSpatialIndexSetupRoot(index, worldBounds);
+    return index;
+}
+
+void INSKSpatialIndexDestroy(INSKSpatialIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    INSKSpatialIndexNodeFreeChildren(&index->root);
+    free(index->root.entries);
+    free(index->entries);
+    free(index);
+}
+
+void INSKSpatialIndexReset(INSKSpatialIndex *index, INSKSpatialBounds worldBounds) {
+    INSKSpatialIndexNodeFreeChildren(&index->root);
+    index->root.count = 0;
+    index->entriesUsed = 0;
+    index->freeEntry = INSKSpatialIndexInvalidHandle;
+    index->count = 0;
+    INSKSpatialIndexSetupRoot(index, worldBounds);
+}
+
+size_t INSKSpatialIndexCount(const INSKSpatialIndex *index) {
+    return index->count;
+}
+
+INSKSpatialIndexHandle INSKSpatialIndexInsert(INSKSpatialIndex *index, INSKSpatialBounds bounds, void *object) {
+    // Get an unused entry.
+    size_t entryIndex = index->freeEntry;
+    if (entryIndex != INSKSpatialIndexInvalidHandle) {
+        index->freeEntry = index->entries[entryIndex].slot;
+    } else {
+        if (index->entriesUsed == index->entriesCapacity) {
+            size_t capacity = (index->entriesCapacity == 0) ? INSKSpatialIndexInitialCapacity : index->entriesCapacity * 2;
+            INSKSpatialIndexEntry *entries = realloc(index->entries, capacity * sizeof(INSKSpatialIndexEntry));
+            if (entries == NULL) {
+                return INSKSpatialIndexInvalidHandle;
+            }
+            index->entries = entries;
+            index->entriesCapacity = capacity;
+        }
+        entryIndex = index->entriesUsed++;
+    }
+    index->count++;
+
+    INSKSpatialIndexEntry *entry = &index->entries[entryIndex];
+    entry->bounds = bounds;
+    entry->object = object;
+    INSKSpatialIndexNode *node = INSKSpatialIndexFindNode(index, bounds, true);
+    if (!INSKSpatialIndexNodeAddEntry(index, node, entryIndex)) {
+        INSKSpatialIndexReleaseEntry(index, entryIndex);
+        return INSKSpatialIndexInvalidHandle;
+    }
+    return entryIndex;
+}
+
+bool INSKSpatialIndexUpdate(INSKSpatialIndex *index, INSKSpatialIndexHandle handle, INSKSpatialBounds bounds) {
+    INSKSpatialIndexEntry *entry = &index->entries[handle];
+    entry->bounds = bounds;
+
+    // Nothing more to do if the entry still belongs to the same node.
+    INSKSpatialIndexNode *node = INSKSpatialIndexFindNode(index, bounds, false);
+    if (node == entry->node) {
+        return true;
+    }
+
+    // Move the entry to the new node.
+    INSKSpatialIndexNodeRemoveEntry(index, handle);
+    node = INSKSpatialIndexFindNode(index, bounds, true);
+    if (!INSKSpatialIndexNodeAddEntry(index, node, handle)) {
+        INSKSpatialIndexReleaseEntry(index, handle);
+        return false;
+    }
+    return true;
+}
+
+void INSKSpatialIndexRemove(INSKSpatialIndex *index, INSKSpatialIndexHandle handle) {
+    INSKSpatialIndexNodeRemoveEntry(index, handle);
+    INSKSpatialIndexReleaseEntry(index, handle);
+}
+
+size_t INSKSpatialIndexQueryPoint(const INSKSpatialIndex *index, double x, double y, INSKSpatialIndexVisitor visitor, void *context) {
+    return INSKSpatialIndexNodeQueryPoint(index, &index->root, x, y, visitor, context);
+}
+
+size_t INSKSpatialIndexQueryBounds(const INSKSpatialIndex *index, INSKSpatialBounds bounds, INSKSpatialIndexVisitor visitor, void *context) {
+    return INSKSpatialIndexNodeQueryBounds(index, &index->root, bounds, visitor, context);
+}
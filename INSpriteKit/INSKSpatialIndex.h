@@ -0,0 +1,174 @@
+// INSKSpatialIndex.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_SPATIAL_INDEX_H
+#define INSK_SPATIAL_INDEX_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ An axis aligned bounding box used by the spatial index.
+ */
+typedef struct {
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+} INSKSpatialBounds;
+
+
+/**
+ A handle to an object stored in a spatial index.
+
+ Handles stay valid until the object is removed or the index is cleared or destroyed.
+ */
+typedef size_t INSKSpatialIndexHandle;
+
+/**
+ Returned by INSKSpatialIndexInsert() if the object couldn't be added.
+ */
+#define INSKSpatialIndexInvalidHandle ((INSKSpatialIndexHandle)-1)
+
+
+/**
+ The callback for queries. Called once for each object whose bounds match the query.
+
+ @param object The object passed to INSKSpatialIndexInsert().
+ @param context The context passed to the query function.
+ */
+typedef void (*INSKSpatialIndexVisitor)(void *object, void *context);
+
+
+/**
+ A loose quadtree for fast point and rect queries over a set of axis aligned bounding boxes.
+
+ This is a plain C implementation without any dependencies to Sprite Kit or Foundation and can be used on any platform.
+ Objects are sorted into the tree by the size and center of their bounds, so each object is stored exactly once.
+ Updating an object which only moves a little bit doesn't touch the tree at all.
+ Objects outside of the world bounds are kept in the root and are always tested, so the world bounds should cover most of the objects.
+ */
+typedef struct INSKSpatialIndex INSKSpatialIndex;
+
+
+/**
+ Creates a new empty index.
+
+ @param worldBounds The area where most of the objects will be in.
+ @param maxDepth The maximum depth of the tree, a value of 8 is a good choice for most scenes.
+ @return A new index which has to be freed with INSKSpatialIndexDestroy() or NULL if the memory couldn't be allocated.
+ */
+INSKSpatialIndex *INSKSpatialIndexCreate(INSKSpatialBounds worldBounds, unsigned int maxDepth);
+
+/**
+ Frees the index and all its memory.
+
+ @param index The index to free, may be NULL.
+ */
+void INSKSpatialIndexDestroy(INSKSpatialIndex *index);
+
+/**
+ Removes all objects from the index and changes the world bounds.
+
+ The memory of the entries is kept for reusage.
+
+ @param index The index.
+ @param worldBounds The new world bounds.
+ */
+void INSKSpatialIndexReset(INSKSpatialIndex *index, INSKSpatialBounds worldBounds);
+
+/**
+ Returns the number of objects in the index.
+
+ @param index The index.
+ @return The number of objects.
+ */
+size_t INSKSpatialIndexCount(const INSKSpatialIndex *index);
+
+/**
+ Adds an object to the index.
+
+ @param index The index.
+ @param bounds The bounds of the object.
+ @param object A pointer passed back to the visitor of the queries. The index doesn't retain or free it.
+ @return The handle of the new entry or INSKSpatialIndexInvalidHandle if the memory couldn't be allocated.
+ */
+INSKSpatialIndexHandle INSKSpatialIndexInsert(INSKSpatialIndex *index, INSKSpatialBounds bounds, void *object);
+
+/**
+ Changes the bounds of an object in the index.
+
+ @param index The index.
+ @param handle The handle returned by INSKSpatialIndexInsert().
+ @param bounds The new bounds.
+ @return False if the object had to be moved in the tree, but the memory couldn't be allocated in which case the object is lost.
+ */
+bool INSKSpatialIndexUpdate(INSKSpatialIndex *index, INSKSpatialIndexHandle handle, INSKSpatialBounds bounds);
+
+/**
+ Removes an object from the index.
+
+ @param index The index.
+ @param handle The handle returned by INSKSpatialIndexInsert(). The handle is invalid afterwards.
+ */
+void INSKSpatialIndexRemove(INSKSpatialIndex *index, INSKSpatialIndexHandle handle);
+
+/**
+ Calls the visitor for each object whose bounds contain a point, inclusive the borders.
+
+ The order in which the objects are visited is undefined.
+
+ @param index The index.
+ @param x The X coordinate of the point.
+ @param y The Y coordinate of the point.
+ @param visitor The callback.
+ @param context Passed to the visitor.
+ @return The number of objects visited.
+ */
+size_t INSKSpatialIndexQueryPoint(const INSKSpatialIndex *index, double x, double y, INSKSpatialIndexVisitor visitor, void *context);
+
+/**
+ Calls the visitor for each object whose bounds intersect a rect, inclusive the borders.
+
+ The order in which the objects are visited is undefined.
+
+ @param index The index.
+ @param bounds The rect to test against.
+ @param visitor The callback.
+ @param context Passed to the visitor.
+ @return The number of objects visited.
+ */
+size_t INSKSpatialIndexQueryBounds(const INSKSpatialIndex *index, INSKSpatialBounds bounds, INSKSpatialIndexVisitor visitor, void *context);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+// INSKTouchSlotTable.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKTouchSlotTable.h"
+
+
+// Returns the preferred slot for a key.
+static size_t INSKTouchSlotTableHash(uintptr_t key) {
+    // Object pointers are aligned, so mix the higher bits in (Fibonacci hashing).
+    uint64_t hash = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(hash >> 32) & (INSKTouchSlotTableCapacity - 1);
+}
+
+// Returns the slot of the key or the first free slot where it can be inserted, or -1 if the table is full.
+static long INSKTouchSlotTableFind(const INSKTouchSlotTable *table, uintptr_t key) {
+    size_t slot = INSKTouchSlotTableHash(key);
+    for (size_t probe = 0; probe < INSKTouchSlotTableCapacity; ++probe) {
+        uintptr_t slotKey = table->slots[slot].key;
+        if (slotKey == key || slotKey == 0) {
+            return (long)slot;
+        }
+        slot = (slot + 1) & (INSKTouchSlotTableCapacity - 1);
+    }
+    return -1;
+}
+
+
+void INSKTouchSlotTableInit(INSKTouchSlotTable *table) {
+    for (size_t slot = 0; slot < INSKTouchSlotTableCapacity; ++slot) {
+        table->slots[slot].key = 0;
+        table->slots[slot].value = NULL;
+    }
+    table->count = 0;
+}
+
+bool INSKTouchSlotTableSet(INSKTouchSlotTable *table, uintptr_t key, void *value, void **previousValue) {
+    if (previousValue != NULL) {
+        *previousValue = NULL;
+    }
+    long slot = INSKTouchSlotTableFind(table, key);
+    if (slot < 0 || key == 0) {
+        return false;
+    }
+    INSKTouchSlot *touchSlot = &table->slots[slot];
+    if (touchSlot->key == key) {
+        if (previousValue != NULL) {
+            *previousValue = touchSlot->value;
+        }
+    } else {
+        touchSlot->key = key;
+        table->count++;
+    }
+    touchSlot->value = value;
+    return true;
+}
+
+void *INSKTouchSlotTableGet(const INSKTouchSlotTable *table, uintptr_t key) {
+    long slot = INSKTouchSlotTableFind(table, key);
+    if (slot < 0 || key == 0 || table->slots[slot].key != key) {
+        return NULL;
+    }
+    return table->slots[slot].value;
+}
+
+void *INSKTouchSlotTableRemove(INSKTouchSlotTable *table, uintptr_t key) {
+    long found = INSKTouchSlotTableFind(table, key);
+    if (found < 0 || key == 0 || table->slots[found].key != key) {
+        return NULL;
+    }
+    size_t slot = (size_t)found;
+    void *value = table->slots[slot].value;
+    table->count--;
+
+    // Shift the following entries back so no lookup chain gets broken (no tombstones needed).
+    size_t next = slot;
+    for (size_t probe = 1; probe < INSKTouchSlotTableCapacity; ++probe) {
+        next = (next + 1) & (INSKTouchSlotTableCapacity - 1);
+        uintptr_t nextKey = table->slots[next].key;
+        if (nextKey == 0) {
+            break;
+        }
+        // Move the entry only if the free slot lies cyclically between its preferred slot and its current slot.
+        size_t preferred = INSKTouchSlotTableHash(nextKey);
+        size_t distanceToFree = (slot - preferred) & (INSKTouchSlotTableCapacity - 1);
+        size_t distanceToNext = (next - preferred) & (INSKTouchSlotTableCapacity - 1);
+        if (distanceToFree < distanceToNext) {
+            table->slots[slot] = table->slots[next];
+            slot = next;
+        }
+    }
+    table->slots[slot].key = 0;
+    table->slots[slot].value = NULL;
+    return value;
+}
@@ -0,0 +1,112 @@
+// INSKTouchSlotTable.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_TOUCH_SLOT_TABLE_H
+#define INSK_TOUCH_SLOT_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ The number of slots in a INSKTouchSlotTable, which is the maximum number of touches which can be tracked at the same time.
+ 
+ Needs to be a power of two.
+ */
+#define INSKTouchSlotTableCapacity 32
+
+
+/**
+ A single slot of a INSKTouchSlotTable.
+ */
+typedef struct {
+    /// The identity of the touch, 0 if the slot is unused.
+    uintptr_t key;
+    /// The value stored for the touch.
+    void *value;
+} INSKTouchSlot;
+
+
+/**
+ A fixed size hash table which maps touch identities to values, i.e. the pointer of a UITouch object to the node handling the touch.
+ 
+ The table uses open addressing, so it never allocates any memory and lookups, updates and removals are in O(1).
+ Because the key is the identity of the touch and not its location two touches at the same location are no problem.
+ The table is plain C, so it doesn't retain the values, this has to be done by the caller.
+ 
+ Initialize the table with INSKTouchSlotTableInit() before use.
+ */
+typedef struct {
+    INSKTouchSlot slots[INSKTouchSlotTableCapacity];
+    size_t count;
+} INSKTouchSlotTable;
+
+
+/**
+ Initializes a table so it is empty.
+
+ @param table The table.
+ */
+void INSKTouchSlotTableInit(INSKTouchSlotTable *table);
+
+/**
+ Stores a value for a touch.
+
+ @param table The table.
+ @param key The identity of the touch, must not be 0.
+ @param value The value to store.
+ @param previousValue Receives the value which has been replaced or NULL if there was none. May be NULL.
+ @return False if the table is full and the value couldn't be stored.
+ */
+bool INSKTouchSlotTableSet(INSKTouchSlotTable *table, uintptr_t key, void *value, void **previousValue);
+
+/**
+ Returns the value stored for a touch.
+
+ @param table The table.
+ @param key The identity of the touch.
+ @return The value or NULL if there is no value for the touch.
+ */
+void *INSKTouchSlotTableGet(const INSKTouchSlotTable *table, uintptr_t key);
+
+/**
+ Removes the value of a touch.
+
+ @param table The table.
+ @param key The identity of the touch.
+ @return The removed value or NULL if there was no value for the touch.
+ */
+void *INSKTouchSlotTableRemove(INSKTouchSlotTable *table, uintptr_t key);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -35,3 +35,57 @@ typedef NS_OPTIONS(NSUInteger, INSKMouseButton) {
     INSKMouseButtonAll = INSKMouseButtonLeft | INSKMouseButtonRight | INSKMouseButtonOther
 };
 
+
+/**
+ Flags to indicate the phases of touches or mouse events a touch observer of INSKView is interested in.
+ 
+ On OS X a mouse down is treated as began, a mouse dragged as moved and a mouse up as ended.
+ */
+typedef NS_OPTIONS(NSUInteger, INSKTouchPhase) {
+    /// A touch began or a mouse button has been pressed.
+    INSKTouchPhaseBegan = 1 << 0,
+    /// A touch moved or the mouse has been dragged.
+    INSKTouchPhaseMoved = 1 << 1,
+    /// A touch ended or a mouse button has been released.
+    INSKTouchPhaseEnded = 1 << 2,
+    /// A touch has been cancelled. iOS only.
+    INSKTouchPhaseCancelled = 1 << 3,
+    /// All phases, same as OR-ing all other values.
+    INSKTouchPhaseAll = INSKTouchPhaseBegan | INSKTouchPhaseMoved | INSKTouchPhaseEnded | INSKTouchPhaseCancelled
+};
+
+
+/**
+ A single location of a touch or the mouse together with its time stamp.
+ */
+typedef struct {
+    /// The location in the scene's coordinate system.
+    CGPoint location;
+    /// The time stamp of the event the location belongs to.
+    NSTimeInterval timestamp;
+} INSKTouchSample;
+
+
+/**
+ A protocol for nodes which want to receive the moves of a touch only once per frame.
+ 
+ When INSKView's coalescesTouchMoves property is set, nodes adopting this protocol don't receive touchesMoved:withEvent: or mouseDragged: (and its variants) anymore.
+ Instead the view collects all moves of a touch and calls touchMovedCoalesced:samples:count:startLocation: once per frame with the whole history of the touch since the last call,
+ so the node can do its work once per frame and still use every sample, i.e. for calculating the velocity.
+ Nodes not adopting the protocol still receive each move event as before.
+ */
+@protocol INSKCoalescedTouchHandling <NSObject>
+
+/**
+ Called once per frame with all moves of a touch since the last call.
+ 
+ The moves are always delivered before the touch ends or is cancelled and before other touches begin.
+ 
+ @param touch The UITouch on iOS or the last mouse dragged NSEvent on OS X.
+ @param samples The locations and time stamps of all moves in the order they occurred, the last one is the current location.
+ @param count The number of samples, at least 1.
+ @param startLocation The location in the scene's coordinate system before the first sample.
+ */
+- (void)touchMovedCoalesced:(id)touch samples:(const INSKTouchSample *)samples count:(NSUInteger)count startLocation:(CGPoint)startLocation;
+
+@end
@@ -0,0 +1,186 @@
+// INSKVelocityEstimator.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKVelocityEstimator.h"
+#include <math.h>
+
+
+#pragma mark - private functions
+
+// Returns the sample with the given age rank, 0 is the newest.
+static const INSKVelocitySample *INSKVelocityEstimatorSample(const INSKVelocityEstimator *estimator, size_t rank) {
+    return &estimator->samples[(estimator->head + INSKVelocityEstimatorCapacity - rank) % INSKVelocityEstimatorCapacity];
+}
+
+// Returns the number of the newest samples which are used for the velocity at a time.
+static size_t INSKVelocityEstimatorUsedCount(const INSKVelocityEstimator *estimator, double timestamp) {
+    size_t maxSamples = estimator->maxSamples;
+    if (maxSamples < 2 || maxSamples > INSKVelocityEstimatorCapacity) {
+        maxSamples = INSKVelocityEstimatorCapacity;
+    }
+    size_t limit = (estimator->count < maxSamples) ? estimator->count : maxSamples;
+    size_t used = 0;
+    while (used < limit) {
+        double age = timestamp - INSKVelocityEstimatorSample(estimator, used)->timestamp;
+        if (estimator->window > 0 && age > estimator->window) {
+            break;
+        }
+        used++;
+    }
+    return used;
+}
+
+static CGPoint INSKVelocityEstimatorAverage(const INSKVelocityEstimator *estimator, size_t used) {
+    double sumX = 0, sumY = 0;
+    for (size_t rank = 0; rank + 1 < used; ++rank) {
+        const INSKVelocitySample *newer = INSKVelocityEstimatorSample(estimator, rank);
+        const INSKVelocitySample *older = INSKVelocityEstimatorSample(estimator, rank + 1);
+        double duration = newer->timestamp - older->timestamp;
+        sumX += (newer->position.x - older->position.x) / duration;
+        sumY += (newer->position.y - older->position.y) / duration;
+    }
+    return CGPointMake((CGFloat)(sumX / (used - 1)), (CGFloat)(sumY / (used - 1)));
+}
+
+static CGPoint INSKVelocityEstimatorLeastSquares(const INSKVelocityEstimator *estimator, size_t used) {
+    // Fits position = a + b * t + c * t^2 with t relative to the newest sample, so b is the velocity at the newest sample.
+    // The positions are relative to the newest sample too, which keeps the sums small.
+    const INSKVelocitySample *newest = INSKVelocityEstimatorSample(estimator, 0);
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+    double sx0 = 0, sx1 = 0, sx2 = 0, sy0 = 0, sy1 = 0, sy2 = 0;
+    for (size_t rank = 0; rank < used; ++rank) {
+        const INSKVelocitySample *sample = INSKVelocityEstimatorSample(estimator, rank);
+        double t = sample->timestamp - newest->timestamp;
+        double t2 = t * t;
+        double x = sample->position.x - newest->position.x;
+        double y = sample->position.y - newest->position.y;
+        s0 += 1;
+        s1 += t;
+        s2 += t2;
+        s3 += t2 * t;
+        s4 += t2 * t2;
+        sx0 += x;
+        sx1 += x * t;
+        sx2 += x * t2;
+        sy0 += y;
+        sy1 += y * t;
+        sy2 += y * t2;
+    }
+    if (used >= 3) {
+        // Solves the normal equations with Cramer's rule for b.
+        double determinant = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s2 * s3) + s2 * (s1 * s3 - s2 * s2);
+        // Samples at less than three different times give no parabola.
+        if (determinant > 1e-9 * s0 * s2 * s4) {
+            double bx = s0 * (sx1 * s4 - s3 * sx2) - sx0 * (s1 * s4 - s2 * s3) + s2 * (s1 * sx2 - s2 * sx1);
+            double by = s0 * (sy1 * s4 - s3 * sy2) - sy0 * (s1 * s4 - s2 * s3) + s2 * (s1 * sy2 - s2 * sy1);
+            return CGPointMake((CGFloat)(bx / determinant), (CGFloat)(by / determinant));
+        }
+    }
+    // A line through two samples.
+    double variance = s0 * s2 - s1 * s1;
+    if (!(variance > 0)) {
+        return CGPointMake(0, 0);
+    }
+    return CGPointMake((CGFloat)((s0 * sx1 - s1 * sx0) / variance), (CGFloat)((s0 * sy1 - s1 * sy0) / variance));
+}
+
+static CGPoint INSKVelocityEstimatorExponential(const INSKVelocityEstimator *estimator, size_t used, double timestamp) {
+    double sumX = 0, sumY = 0, sumDuration = 0;
+    for (size_t rank = 0; rank + 1 < used; ++rank) {
+        const INSKVelocitySample *newer = INSKVelocityEstimatorSample(estimator, rank);
+        const INSKVelocitySample *older = INSKVelocityEstimatorSample(estimator, rank + 1);
+        double weight = 1;
+        if (estimator->timeConstant > 0) {
+            double age = timestamp - 0.5 * (newer->timestamp + older->timestamp);
+            weight = exp(-age / estimator->timeConstant);
+        }
+        sumX += weight * (newer->position.x - older->position.x);
+        sumY += weight * (newer->position.y - older->position.y);
+        sumDuration += weight * (newer->timestamp - older->timestamp);
+    }
+    if (!(sumDuration > 0)) {
+        return CGPointMake(0, 0);
+    }
+    return CGPointMake((CGFloat)(sumX / sumDuration), (CGFloat)(sumY / sumDuration));
+}
+
+
+#pragma mark - public functions
+
+void INSKVelocityEstimatorInit(INSKVelocityEstimator *estimator) {
+    estimator->method = INSKVelocityEstimatorMethodLeastSquares;
+    estimator->window = 0.1;
+    estimator->timeConstant = 0.04;
+    estimator->maxSamples = INSKVelocityEstimatorCapacity;
+    estimator->head = 0;
+    estimator->count = 0;
+}
+
+void INSKVelocityEstimatorReset(INSKVelocityEstimator *estimator, double timestamp) {
+    estimator->head = 0;
+    estimator->count = 1;
+    estimator->samples[0].timestamp = timestamp;
+    estimator->samples[0].position = CGPointMake(0, 0);
+}
+
+void INSKVelocityEstimatorAddMovement(INSKVelocityEstimator *estimator, CGPoint translation, double timestamp) {
+    if (estimator->count == 0) {
+        INSKVelocityEstimatorReset(estimator, timestamp);
+    }
+    INSKVelocitySample *last = &estimator->samples[estimator->head];
+    CGPoint position = CGPointMake(last->position.x + translation.x, last->position.y + translation.y);
+    if (!(timestamp > last->timestamp)) {
+        // No time has passed, so the movement belongs to the previous sample.
+        last->position = position;
+        return;
+    }
+    estimator->head = (estimator->head + 1) % INSKVelocityEstimatorCapacity;
+    if (estimator->count < INSKVelocityEstimatorCapacity) {
+        estimator->count++;
+    }
+    estimator->samples[estimator->head].timestamp = timestamp;
+    estimator->samples[estimator->head].position = position;
+}
+
+CGPoint INSKVelocityEstimatorVelocity(const INSKVelocityEstimator *estimator, double timestamp) {
+    size_t used = INSKVelocityEstimatorUsedCount(estimator, timestamp);
+    if (used < 2) {
+        return CGPointMake(0, 0);
+    }
+    switch (estimator->method) {
+        case INSKVelocityEstimatorMethodAverage:
+            return INSKVelocityEstimatorAverage(estimator, used);
+        case INSKVelocityEstimatorMethodExponential:
+            return INSKVelocityEstimatorExponential(estimator, used, timestamp);
+        case INSKVelocityEstimatorMethodLeastSquares:
+        default:
+            return INSKVelocityEstimatorLeastSquares(estimator, used);
+    }
+}
+
+double INSKVelocityEstimatorLastTimestamp(const INSKVelocityEstimator *estimator) {
+    if (estimator->count == 0) {
+        return 0;
+    }
+    return estimator->samples[estimator->head].timestamp;
+}
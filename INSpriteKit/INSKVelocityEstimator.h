@@ -0,0 +1,149 @@
+// INSKVelocityEstimator.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_VELOCITY_ESTIMATOR_H
+#define INSK_VELOCITY_ESTIMATOR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "INSKMath.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ------------------------------------------------------------
+#pragma mark - types
+// ------------------------------------------------------------
+/// @name types
+
+/**
+ The number of samples a INSKVelocityEstimator keeps, older samples are overwritten.
+ */
+#define INSKVelocityEstimatorCapacity 16
+
+/**
+ How a INSKVelocityEstimator calculates the velocity from its samples, the values match INSKScrollNodeVelocityEstimation.
+ */
+typedef enum {
+    /// The unweighted mean of the velocities between the samples, which ignores irregular intervals.
+    INSKVelocityEstimatorMethodAverage = 0,
+    /// The slope at the newest sample of the least-squares parabola through the positions over time, which follows speeding up and slowing down drags.
+    INSKVelocityEstimatorMethodLeastSquares,
+    /// The movement divided by the time between the samples, both weighted exponentially by the age of the samples.
+    INSKVelocityEstimatorMethodExponential
+} INSKVelocityEstimatorMethod;
+
+/**
+ A position at a time.
+ */
+typedef struct {
+    double timestamp;
+    CGPoint position;
+} INSKVelocitySample;
+
+/**
+ Estimates the velocity of a drag from its movements.
+
+ The samples are kept in a fixed ring buffer, so the estimator never allocates any memory.
+ Movements with the same or an earlier timestamp than the previous one are merged into the previous sample,
+ so irregular or duplicated timestamps never lead to a division by zero.
+ Only samples within the window before the time the velocity is asked for are used,
+ so a drag which has rested before the release has no velocity.
+
+ The parameters may be changed directly at any time.
+ Initialize the estimator with INSKVelocityEstimatorInit() before use.
+ */
+typedef struct {
+    /// The calculation of the velocity. Defaults to INSKVelocityEstimatorMethodLeastSquares.
+    INSKVelocityEstimatorMethod method;
+    /// The age in seconds of the oldest sample used, 0 uses all samples. Defaults to 0.1.
+    double window;
+    /// The age in seconds at which a sample has a weight of 1/e with INSKVelocityEstimatorMethodExponential. Defaults to 0.04.
+    double timeConstant;
+    /// The maximum number of samples used, between 2 and INSKVelocityEstimatorCapacity. Defaults to INSKVelocityEstimatorCapacity.
+    size_t maxSamples;
+
+    /// The samples, the newest at head, don't change them directly.
+    INSKVelocitySample samples[INSKVelocityEstimatorCapacity];
+    size_t head;
+    size_t count;
+} INSKVelocityEstimator;
+
+
+// ------------------------------------------------------------
+#pragma mark - functions
+// ------------------------------------------------------------
+/// @name functions
+
+/**
+ Initializes an estimator with the default parameters and no samples.
+
+ @param estimator The estimator.
+ */
+void INSKVelocityEstimatorInit(INSKVelocityEstimator *estimator);
+
+/**
+ Removes all samples and starts a new drag at position zero.
+
+ @param estimator The estimator.
+ @param timestamp The start time of the drag in seconds.
+ */
+void INSKVelocityEstimatorReset(INSKVelocityEstimator *estimator, double timestamp);
+
+/**
+ Adds the movement of the drag since the previous sample.
+
+ Starts a drag at the timestamp if there are no samples.
+
+ @param estimator The estimator.
+ @param translation The movement since the previous sample.
+ @param timestamp The time of the movement in seconds.
+ */
+void INSKVelocityEstimatorAddMovement(INSKVelocityEstimator *estimator, CGPoint translation, double timestamp);
+
+/**
+ Returns the estimated velocity.
+
+ @param estimator The estimator.
+ @param timestamp The current time in seconds, samples older than the window are ignored.
+ @return The velocity in points per second or zero if there are less than two samples within the window.
+ */
+CGPoint INSKVelocityEstimatorVelocity(const INSKVelocityEstimator *estimator, double timestamp);
+
+/**
+ Returns the time of the newest sample.
+
+ @param estimator The estimator.
+ @return The timestamp of the newest sample or 0 if there are no samples.
+ */
+double INSKVelocityEstimatorLastTimestamp(const INSKVelocityEstimator *estimator);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
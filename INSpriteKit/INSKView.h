@@ -23,6 +23,7 @@
 
 #import <SpriteKit/SpriteKit.h>
 #import "INSKTypes.h"
+#import "INSKInputRecording.h"
 
 
 /**
@@ -53,13 +54,14 @@
  
  Nodes which currently handle a touch are retained and do receive touch events even when their interactions or visibility state changes during a touch event.
  
- @warning *Limitation:* Each node may have at most 65'536 children otherwise the correct touch receiver won't be determined.
+ To find out where the time of the touch delivery is spent compile the library with INSK_INSTRUMENTATION defined to 1.
+ INSKView then measures the scene queries, the filtering, the order resolution and the delivery of each event, see INSKInstrumentation.h for reading the results.
  */
 @interface INSKView : SKView
 
 
 /**
- Adds a node as a global touch observer.
+ Adds a node as a global touch observer for all touch phases and everywhere in the scene.
  
  Global touch observers will get each touch event regardless of their position in the scene, their visibility or their userInteractionEnabled state.
  Each observer will be informed before the proper touched object.
@@ -68,12 +70,33 @@
  To prevent the double calls set userInteractionEnabled to NO so the node won't get regular touches, only those as an observer.
  When the node isn't interested in touch events anymore remove it from the observing list with removeTouchObservingNode:.
  
+ Same as calling addTouchObservingNode:phases:region: with INSKTouchPhaseAll and CGRectNull.
+ 
  @param node The node which will be informed about any touch events.
+ @see addTouchObservingNode:phases:region:
  @see removeTouchObservingNode:
  */
 - (void)addTouchObservingNode:(SKNode *)node;
 
 
+/**
+ Adds a node as a global touch observer which is only interested in some touch phases or in a part of the scene.
+ 
+ The observer is only informed about touch or mouse events of the given phases.
+ If a region is given the observer is only informed when at least one of the event's touches or the mouse is inside of the region, the touches passed are not filtered.
+ The observers are informed in the order they are added, the filters don't change this order.
+ Adding a node which is already an observer only changes its filter and keeps its position in the order.
+ Observers with a filter are cheaper, because INSKView doesn't call those which aren't interested in an event.
+ 
+ @param node The node which will be informed about the touch events.
+ @param phases The phases of the touches the node is interested in.
+ @param region A rect in the scene's coordinate system where the touches have to be in or CGRectNull for everywhere. If there is no scene presented no touch is inside of a region.
+ @see addTouchObservingNode:
+ @see removeTouchObservingNode:
+ */
+- (void)addTouchObservingNode:(SKNode *)node phases:(INSKTouchPhase)phases region:(CGRect)region;
+
+
 /**
  Removes the node from the list of global touch observers.
  
@@ -110,6 +133,119 @@
 - (SKNode *)topInteractingNodeAtPosition:(CGPoint)position withSupportedMouseButton:(INSKMouseButton)mouseButton;
 
 
+/**
+ Returns the nodes which will receive touches/mouse clicks occuring at several positions at once.
+ 
+ Calls topInteractingNodesAtPositions:count:withSupportedMouseButton: with INSKMouseButtonAll for the mouseButton value.
+ 
+ @param positions A C array of positions in the scene coordinate system.
+ @param count The number of positions in the array.
+ @return An array with count entries, each is the interacting node for the position at the same index or NSNull if there is none.
+ */
+- (NSArray *)topInteractingNodesAtPositions:(const CGPoint *)positions count:(NSUInteger)count;
+
+
+/**
+ Returns the nodes which will receive touches/clicks occuring at several positions at once and for a specific mouse button.
+ 
+ The result is the same as calling topInteractingNodeAtPosition:withSupportedMouseButton: for each position, but faster for multiple positions.
+ The scene is queried only once for all positions: with hitTestIndexEnabled the index is queried with the bounds enclosing all positions,
+ otherwise the tree is walked once and branches whose accumulated frame contains none of the positions are skipped.
+ Each found node is then checked only once for its interaction state and the conversion of the positions into the node's coordinate system
+ is calculated only once for all positions.
+ INSKView uses this method for all touches which begin at the same time.
+ 
+ @param positions A C array of positions in the scene coordinate system.
+ @param count The number of positions in the array.
+ @param mouseButton A specific mouse button which has to be supported by the node or INSKMouseButtonAll for any interacting node. On iOS the value will be ignored.
+ @return An array with count entries, each is the interacting node for the position at the same index or NSNull if there is none.
+ @see topInteractingNodeAtPosition:withSupportedMouseButton:
+ */
+- (NSArray *)topInteractingNodesAtPositions:(const CGPoint *)positions count:(NSUInteger)count withSupportedMouseButton:(INSKMouseButton)mouseButton;
+
+
+/**
+ Flag to use a spatial index for finding the nodes at a touch position. Defaults to NO.
+ 
+ Without an index topInteractingNodeAtPosition:withSupportedMouseButton: asks the scene for all nodes at the position, which has to test each node in the scene.
+ With the index enabled the view keeps the interacting nodes in a loose quadtree (see INSKSpatialIndex.h) so only nodes whose frame contains the position have to be tested.
+ This speeds up the touch delivery in scenes with many nodes.
+ 
+ The index is maintained incrementally with a table registered by [SKNode addSceneGraphChangeTable:], which collects the nodes added, removed, moved, rotated, scaled or resized, including sprites getting another texture and labels getting another text or font.
+ Before the next touch only the entries of these nodes, their descendants and their ancestors are inserted, updated or removed, once and not for each change.
+ The whole index is only rebuilt for a new scene, after [SKNode sceneGraphDidChange] or when more nodes have changed than there are in the index.
+ 
+ @warning Changes done by running actions, i.e. moving a button with an SKAction, can't be tracked. Call [SKNode sceneGraphDidChange] after such changes otherwise the touches may be delivered to the wrong nodes.
+ The same applies to frame changes by properties which aren't tracked, i.e. the path of a shape node or the attributedText of a label node.
+ @see [SKNode addSceneGraphChangeTable:]
+ */
+@property (nonatomic, assign) BOOL hitTestIndexEnabled;
+
+
+/**
+ Flag to cache the results of topInteractingNodeAtPosition:withSupportedMouseButton:. Defaults to NO.
+ 
+ Gesture recognizers or other callers asking for the same position several times per frame get the result out of the cache instead of testing the nodes again.
+ The results are stored for the position rounded to hitTestCacheGranularity and the mouse button.
+ The whole cache is dropped as soon as [SKNode sceneGraphStructureGeneration] changes, i.e. when a node is added or removed or its userInteractionEnabled property changes,
+ and when another scene is presented.
+ The found nodes are held weakly and a cached node is only returned if it is still in the scene, still contains the position and still may receive touches there,
+ otherwise the position is tested again. So moving nodes, i.e. the content of a scroll node while dragging, doesn't drop the cache.
+ 
+ @warning A node moved onto a position which has been cached before or raised above the cached node there with its zPosition or touchPriority is only found
+ after the next change of the tree, call [SKNode sceneGraphDidChange] if this matters.
+ @see hitTestCacheGranularity
+ */
+@property (nonatomic, assign) BOOL hitTestCacheEnabled;
+
+
+/**
+ The size of the grid in scene points the positions are rounded to for the hit test cache. Defaults to 1.0.
+ 
+ Positions in the same grid cell share their cached result, so a finger resting on a button hits the cache even if it's trembling a bit.
+ The result for a position near the border of a node may therefore be the result of a neighbour position within the same cell.
+ Set to 0 to only use cached results for exactly the same positions.
+ Changing the value clears the cache.
+ */
+@property (nonatomic, assign) CGFloat hitTestCacheGranularity;
+
+
+/**
+ A recording which receives all touch and mouse events delivered by the view. Defaults to NULL.
+ 
+ When set each touch or mouse event is added to the recording with its phase, location in the scene, time stamp and mouse button before it is delivered.
+ The events can be saved with INSKInputRecordingWriteFile() and replayed headless with INSKInputReplayRun() on any platform,
+ so sessions recorded on a device can be used as benchmarks for the touch delivery, see INSKInputReplay.h.
+ Events are only recorded while a scene is presented.
+ 
+ The view doesn't take the ownership, the recording has to be created with INSKInputRecordingCreate() and freed with INSKInputRecordingDestroy() after setting this property back to NULL.
+ */
+@property (nonatomic, assign) INSKInputRecording *inputRecording;
+
+
+/**
+ Flag to deliver the moves of touches or mouse drags only once per frame to nodes adopting INSKCoalescedTouchHandling. Defaults to NO.
+ 
+ Input devices with a high sampling rate call touchesMoved:withEvent: several times per rendered frame, so nodes like INSKScrollNode would reposition their content and inform their delegates several times per frame.
+ With this flag set the view buffers the moves of each touch and delivers them as a single touchMovedCoalesced:samples:count:startLocation: call with all samples once per frame.
+ The buffered moves are delivered by an action of the scene, which runs after the scene's update: method,
+ or with the next began, ended or cancelled event before any observer or node is informed about it.
+ Nodes not adopting the protocol and the touch observers still receive every move immediately, so both have got all moves before they are informed about the end of a touch.
+ 
+ @warning The actions of a paused scene don't run, so while the scene is paused the moves are only delivered with the next began, ended or cancelled event or by calling deliverCoalescedTouchMoves.
+ @see deliverCoalescedTouchMoves
+ */
+@property (nonatomic, assign) BOOL coalescesTouchMoves;
+
+
+/**
+ Delivers all buffered moves to their nodes immediately.
+ 
+ Only needed when coalescesTouchMoves is set and the moves have to be processed before the next frame.
+ */
+- (void)deliverCoalescedTouchMoves;
+
+
 /**
  Flag to deliver right mouse button events to the scene and their nodes. OS X only. Defaults to YES.
  
@@ -24,19 +24,134 @@
 #import "INSKView.h"
 #import "SKNode+INExtension.h"
 #import "SKSpriteNode+INExtension.h"
+#import "INSKSpatialIndex.h"
+#import "INSKTouchSlotTable.h"
+#import "INSKInputRecording.h"
+#import "INSKInstrumentation.h"
 
 
-@interface INSKView ()
+// The depth of the hit test index's quadtree.
+static unsigned int const HitTestIndexMaxDepth = 8;
+
+// The key of the scene's action which delivers the coalesced touch moves.
+static NSString * const CoalescedTouchMovesActionKey = @"INSKViewDeliverCoalescedTouchMoves";
+
+// The number of entries in the hit test cache, needs to be a power of two.
+#define HitTestCacheSize 64
+
+// An entry of the hit test cache.
+typedef struct {
+    BOOL valid;
+    // The quantized position.
+    int64_t x;
+    int64_t y;
+    INSKMouseButton mouseButton;
+    // Whether a node has been found, the node itself is held weakly at the same index in hitTestCacheNodes.
+    BOOL hasNode;
+} INSKViewHitTestCacheEntry;
+
+// The filter of a touch observer.
+typedef struct {
+    INSKTouchPhase phases;
+    // The region in the scene or CGRectNull for everywhere.
+    CGRect region;
+} INSKViewTouchObserverFilter;
+
+
+// Returns the key for a touch in the touch slot table, which is the touch object's identity.
+static inline uintptr_t INSKViewTouchKey(id touch) {
+    return (uintptr_t)(__bridge void *)touch;
+}
+
+// Returns an identifier for a touch in a recording, which is the folded identity of the touch object.
+static inline uint32_t INSKViewRecordingTouchId(id touch) {
+    uint64_t identity = (uint64_t)(uintptr_t)(__bridge void *)touch;
+    return (uint32_t)(identity >> 4 ^ identity >> 36);
+}
+
+// Visitor for the hit test index which collects the found nodes in a mutable array passed as the context.
+static void INSKViewCollectHitTestCandidate(void *object, void *context) {
+    [(__bridge NSMutableArray *)context addObject:(__bridge SKNode *)object];
+}
+
+// Returns the bounds enclosing all positions, count must be at least 1.
+static INSKSpatialBounds INSKViewBoundsOfPositions(const CGPoint *positions, NSUInteger count) {
+    INSKSpatialBounds bounds = {positions[0].x, positions[0].y, positions[0].x, positions[0].y};
+    for (NSUInteger index = 1; index < count; ++index) {
+        bounds.minX = MIN(bounds.minX, positions[index].x);
+        bounds.minY = MIN(bounds.minY, positions[index].y);
+        bounds.maxX = MAX(bounds.maxX, positions[index].x);
+        bounds.maxY = MAX(bounds.maxY, positions[index].y);
+    }
+    return bounds;
+}
+
+
+// The buffered moves of a touch for a node adopting INSKCoalescedTouchHandling.
+@interface INSKViewCoalescedTouchMove : NSObject
+
+@property (nonatomic, strong) SKNode<INSKCoalescedTouchHandling> *node;
+// The identity of the touch, 0 for the mouse.
+@property (nonatomic, assign) uintptr_t key;
+// The UITouch or the last NSEvent.
+@property (nonatomic, strong) id touch;
+@property (nonatomic, assign) CGPoint startLocation;
+// The INSKTouchSample structs.
+@property (nonatomic, strong) NSMutableData *samples;
+
+@end
+
+
+@implementation INSKViewCoalescedTouchMove
+
+@end
+
+
+@interface INSKView () {
+    // A table with the touches as keys and the top node which handles the touch as value, the nodes are retained. iOS only.
+    INSKTouchSlotTable _nodeForTouchTable;
+    // A direct mapped cache of the results of topInteractingNodeAtPosition:withSupportedMouseButton:.
+    INSKViewHitTestCacheEntry _hitTestCache[HitTestCacheSize];
+}
+
+// The nodes of the touches which didn't fit into _nodeForTouchTable by the touches' keys, the nodes are retained. iOS only.
+@property (nonatomic, strong) NSMapTable *overflowNodeForTouchTable;
 
-// A dictionary with touch locations as keys and the top node which handles the touch as value. iOS only.
-@property (nonatomic, strong) NSMutableDictionary *nodeForTouchMapping;
 // The node which currently is attached to a mouse event. OS X only.
 @property (nonatomic, weak) SKNode *nodeForMouseEvent;
 // The number of actually pressed buttons. OS X only.
 @property (nonatomic, assign) NSInteger numberOfMouseButtonsPressed;
+// The location of the last mouse down or dragged event in the scene. OS X only.
+@property (nonatomic, assign) CGPoint lastMouseLocation;
 
-// A list of nodes which want to receive each touch regardless of their position.
-@property (nonatomic, strong) NSMutableSet *touchObservingNodes;
+// A list of nodes which want to receive each touch regardless of their position in the order they have been added.
+// The filters of the observers are at the same positions in touchObserverFilters.
+// Both are replaced when changed, so the touch delivery can iterate over them while an observer adds or removes observers.
+@property (nonatomic, copy) NSArray *touchObservingNodes;
+@property (nonatomic, copy) NSData *touchObserverFilters;
+
+// The spatial index with the interacting nodes of the scene, only used if hitTestIndexEnabled is YES.
+@property (nonatomic, assign) INSKSpatialIndex *hitTestIndex;
+// The handles of the nodes in the hit test index plus one, the nodes are retained so the index never points to a freed node.
+@property (nonatomic, strong) NSMapTable *hitTestIndexHandles;
+// The nodes changed since the last update of the hit test index, registered with [SKNode addSceneGraphChangeTable:].
+@property (nonatomic, strong) NSHashTable *hitTestIndexChangedNodes;
+// The scene the hit test index has been built for.
+@property (nonatomic, weak) SKScene *hitTestIndexScene;
+@property (nonatomic, assign) BOOL hitTestIndexNeedsRebuild;
+// A reused array for the nodes found in the hit test index.
+@property (nonatomic, strong) NSMutableArray *hitTestCandidates;
+
+// The nodes found for the entries of the hit test cache, held weakly so removed and freed nodes become nil.
+@property (nonatomic, strong) NSPointerArray *hitTestCacheNodes;
+// The scene and the scene graph structure generation the entries of the hit test cache are valid for.
+@property (nonatomic, weak) SKScene *hitTestCacheScene;
+@property (nonatomic, assign) NSUInteger hitTestCacheGeneration;
+
+// The moves buffered for the next frame in the order of their first move, only used if coalescesTouchMoves is YES.
+@property (nonatomic, strong) NSMutableArray *coalescedTouchMoves;
+// The same moves by the NSNumber of their touch's key.
+@property (nonatomic, strong) NSMutableDictionary *coalescedTouchMovesByKey;
 
 @end
 
@@ -64,37 +179,308 @@
 }
 
 - (void)setupINSKView {
-    self.nodeForTouchMapping = [NSMutableDictionary dictionary];
-    self.touchObservingNodes = [NSMutableSet set];
+    INSKTouchSlotTableInit(&_nodeForTouchTable);
+    self.overflowNodeForTouchTable = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality valueOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPersonality];
+    self.touchObservingNodes = @[];
+    self.touchObserverFilters = [NSData data];
     self.deliverRightMouseButtonEventsToScene = YES;
+    self.hitTestIndexHandles = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsIntegerPersonality];
+    self.hitTestIndexChangedNodes = [NSHashTable weakObjectsHashTable];
+    self.hitTestCandidates = [NSMutableArray array];
+    self.hitTestIndexNeedsRebuild = YES;
+    self.hitTestCacheNodes = [NSPointerArray weakObjectsPointerArray];
+    self.hitTestCacheGranularity = 1.0;
+    self.coalescedTouchMoves = [NSMutableArray array];
+    self.coalescedTouchMovesByKey = [NSMutableDictionary dictionary];
 }
 
+- (void)dealloc {
+    [SKNode removeSceneGraphChangeTable:_hitTestIndexChangedNodes];
+    INSKSpatialIndexDestroy(_hitTestIndex);
+    // Release all nodes still handling a touch.
+    for (NSUInteger slot = 0; slot < INSKTouchSlotTableCapacity; ++slot) {
+        if (_nodeForTouchTable.slots[slot].key != 0) {
+            CFRelease(_nodeForTouchTable.slots[slot].value);
+        }
+    }
+}
 
-#pragma mark - private methods
 
-- (NSString *)treeOrderTagForNode:(SKNode *)node {
-    // Walks the tree up to the root which is the scene and collects the index for each subnode.
-    // Each subnode's index will be printed as a hexadecimal value with 4 digits.
-    // Returns the empty string for the scene itself.
-    NSString *tag = @"";
-    SKNode *currentNode = node;
-    while (currentNode.parent != nil) {
-        NSUInteger index = [currentNode.parent.children indexOfObject:currentNode];
-        tag = [NSString stringWithFormat:@"%04lx%@", (unsigned long)index, tag];
-        currentNode = currentNode.parent;
+#pragma mark - hit test index
+
+- (void)setHitTestIndexEnabled:(BOOL)hitTestIndexEnabled {
+    _hitTestIndexEnabled = hitTestIndexEnabled;
+    if (hitTestIndexEnabled) {
+        // Registering the table starts the tracking of the scene graph.
+        [SKNode addSceneGraphChangeTable:self.hitTestIndexChangedNodes];
+    } else {
+        // Free the memory, the index will be rebuilt when enabled again.
+        [SKNode removeSceneGraphChangeTable:self.hitTestIndexChangedNodes];
+        [self.hitTestIndexChangedNodes removeAllObjects];
+        INSKSpatialIndexDestroy(self.hitTestIndex);
+        self.hitTestIndex = NULL;
+        [self.hitTestIndexHandles removeAllObjects];
+        [self.hitTestCandidates removeAllObjects];
+        self.hitTestIndexNeedsRebuild = YES;
+    }
+}
+
+// Returns the bounds of the node in the scene's coordinate system.
+- (INSKSpatialBounds)hitTestBoundsForNode:(SKNode *)node inScene:(SKScene *)scene {
+    // Sprite nodes only receive touches inside of their own frame, all other nodes inside of their accumulated frame.
+    CGRect frame = [node isKindOfClass:[SKSpriteNode class]] ? node.frame : [self accumulatedFrameOfNode:node];
+    if (node.parent == scene) {
+        INSKSpatialBounds bounds = {CGRectGetMinX(frame), CGRectGetMinY(frame), CGRectGetMaxX(frame), CGRectGetMaxY(frame)};
+        return bounds;
+    }
+
+    // Convert all corners into the scene, because any parent may be rotated.
+    CGPoint corners[4] = {
+        CGPointMake(CGRectGetMinX(frame), CGRectGetMinY(frame)),
+        CGPointMake(CGRectGetMaxX(frame), CGRectGetMinY(frame)),
+        CGPointMake(CGRectGetMinX(frame), CGRectGetMaxY(frame)),
+        CGPointMake(CGRectGetMaxX(frame), CGRectGetMaxY(frame))
+    };
+    INSKSpatialBounds bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    for (NSUInteger index = 0; index < 4; ++index) {
+        CGPoint corner = [node.parent convertPoint:corners[index] toNode:scene];
+        bounds.minX = MIN(bounds.minX, corner.x);
+        bounds.minY = MIN(bounds.minY, corner.y);
+        bounds.maxX = MAX(bounds.maxX, corner.x);
+        bounds.maxY = MAX(bounds.maxY, corner.y);
+    }
+    return bounds;
+}
+
+- (void)addInteractingNodesOfNode:(SKNode *)parent toHitTestIndexForScene:(SKScene *)scene {
+    for (SKNode *node in parent.children) {
+        if (node.userInteractionEnabled) {
+            INSKSpatialBounds bounds = [self hitTestBoundsForNode:node inScene:scene];
+            INSKSpatialIndexHandle handle = INSKSpatialIndexInsert(self.hitTestIndex, bounds, (__bridge void *)node);
+            if (handle != INSKSpatialIndexInvalidHandle) {
+                // The map stores the handle plus one, because 0 means not found.
+                NSMapInsert(self.hitTestIndexHandles, (__bridge void *)node, (void *)(handle + 1));
+            }
+        }
+        [self addInteractingNodesOfNode:node toHitTestIndexForScene:scene];
+    }
+}
+
+- (void)rebuildHitTestIndex {
+    SKScene *scene = self.scene;
+    INSKSpatialBounds worldBounds = {
+        -scene.anchorPoint.x * scene.size.width,
+        -scene.anchorPoint.y * scene.size.height,
+        (1.0 - scene.anchorPoint.x) * scene.size.width,
+        (1.0 - scene.anchorPoint.y) * scene.size.height
+    };
+    if (self.hitTestIndex == NULL) {
+        self.hitTestIndex = INSKSpatialIndexCreate(worldBounds, HitTestIndexMaxDepth);
+    } else {
+        INSKSpatialIndexReset(self.hitTestIndex, worldBounds);
+    }
+    [self.hitTestIndexHandles removeAllObjects];
+    if (self.hitTestIndex == NULL) {
+        return;
+    }
+
+    [self addInteractingNodesOfNode:scene toHitTestIndexForScene:scene];
+    self.hitTestIndexNeedsRebuild = NO;
+}
+
+// Inserts, updates or removes the entry of a node depending on whether it is an interacting node in the scene.
+- (void)updateHitTestIndexEntryOfNode:(SKNode *)node inScene:(SKScene *)scene updatedNodes:(NSHashTable *)updatedNodes {
+    if ([updatedNodes containsObject:node]) {
+        return;
+    }
+    [updatedNodes addObject:node];
+
+    INSKSpatialIndexHandle handle = (INSKSpatialIndexHandle)(uintptr_t)NSMapGet(self.hitTestIndexHandles, (__bridge void *)node) - 1;
+    BOOL isIndexed = (handle != INSKSpatialIndexInvalidHandle);
+    BOOL shouldBeIndexed = node.userInteractionEnabled && node != scene && node.scene == scene;
+    if (!shouldBeIndexed) {
+        if (isIndexed) {
+            INSKSpatialIndexRemove(self.hitTestIndex, handle);
+            NSMapRemove(self.hitTestIndexHandles, (__bridge void *)node);
+        }
+        return;
+    }
+
+    INSKSpatialBounds bounds = [self hitTestBoundsForNode:node inScene:scene];
+    if (isIndexed) {
+        if (!INSKSpatialIndexUpdate(self.hitTestIndex, handle, bounds)) {
+            // Out of memory, the node got lost, so try again with a new index next time.
+            NSMapRemove(self.hitTestIndexHandles, (__bridge void *)node);
+            self.hitTestIndexNeedsRebuild = YES;
+        }
+        return;
+    }
+    handle = INSKSpatialIndexInsert(self.hitTestIndex, bounds, (__bridge void *)node);
+    if (handle != INSKSpatialIndexInvalidHandle) {
+        NSMapInsert(self.hitTestIndexHandles, (__bridge void *)node, (void *)(handle + 1));
+    } else {
+        self.hitTestIndexNeedsRebuild = YES;
+    }
+}
+
+// Updates the entries of a changed node and its descendants, which have moved with it.
+- (void)updateHitTestIndexForChangedNode:(SKNode *)node inScene:(SKScene *)scene updatedNodes:(NSHashTable *)updatedNodes {
+    [self updateHitTestIndexEntryOfNode:node inScene:scene updatedNodes:updatedNodes];
+    for (SKNode *child in node.children) {
+        [self updateHitTestIndexForChangedNode:child inScene:scene updatedNodes:updatedNodes];
+    }
+}
+
+- (void)updateHitTestIndex {
+    SKScene *scene = self.scene;
+    NSHashTable *changedNodes = self.hitTestIndexChangedNodes;
+    // Rebuild for a new scene, when anything may have changed or when updating each changed node would take longer.
+    if (self.hitTestIndexNeedsRebuild || self.hitTestIndexScene != scene || [changedNodes containsObject:[NSNull null]] || changedNodes.count > self.hitTestIndexHandles.count) {
+        [changedNodes removeAllObjects];
+        [self rebuildHitTestIndex];
+        self.hitTestIndexScene = scene;
+        return;
+    }
+    if (changedNodes.count == 0 || self.hitTestIndex == NULL) {
+        return;
+    }
+
+    // Removed nodes aren't in the scene anymore and their old ancestors keep their bounds,
+    // which is no problem because the real frames of the candidates are checked.
+    NSArray *nodes = changedNodes.allObjects;
+    [changedNodes removeAllObjects];
+    NSHashTable *updatedNodes = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    for (SKNode *node in nodes) {
+        [self updateHitTestIndexForChangedNode:node inScene:scene updatedNodes:updatedNodes];
+        // The accumulated frames of the ancestors contain the node.
+        for (SKNode *ancestor = node.parent; ancestor != nil && ancestor != scene; ancestor = ancestor.parent) {
+            [self updateHitTestIndexEntryOfNode:ancestor inScene:scene updatedNodes:updatedNodes];
+        }
+    }
+}
+
+// Returns the interacting nodes of the scene with a frame containing the position.
+- (NSArray *)hitTestIndexNodesAtPosition:(CGPoint)position {
+    [self updateHitTestIndex];
+
+    NSMutableArray *candidates = self.hitTestCandidates;
+    [candidates removeAllObjects];
+    if (self.hitTestIndex == NULL) {
+        return candidates;
+    }
+    INSKSpatialIndexQueryPoint(self.hitTestIndex, position.x, position.y, INSKViewCollectHitTestCandidate, (__bridge void *)candidates);
+
+    // The index uses axis aligned frames in the scene, so check the real frames of none sprite nodes like the scene would do.
+    // Nodes removed without being noticed, i.e. by an action, are dropped.
+    SKScene *scene = self.scene;
+    for (NSInteger index = candidates.count - 1; index >= 0; --index) {
+        SKNode *node = candidates[index];
+        if (node.scene != scene) {
+            [candidates removeObjectAtIndex:index];
+        } else if (![node isKindOfClass:[SKSpriteNode class]]) {
+            CGPoint positionInParent = [scene convertPoint:position toNode:node.parent];
+            if (![node containsPoint:positionInParent]) {
+                [candidates removeObjectAtIndex:index];
+            }
+        }
+    }
+    return candidates;
+}
+
+
+#pragma mark - hit test cache
+
+- (void)setHitTestCacheEnabled:(BOOL)hitTestCacheEnabled {
+    _hitTestCacheEnabled = hitTestCacheEnabled;
+    if (hitTestCacheEnabled) {
+        [SKNode startSceneGraphTracking];
     }
-    return tag;
+    [self clearHitTestCache];
+}
+
+- (void)setHitTestCacheGranularity:(CGFloat)hitTestCacheGranularity {
+    _hitTestCacheGranularity = MAX(hitTestCacheGranularity, 0.0);
+    [self clearHitTestCache];
+}
+
+- (void)clearHitTestCache {
+    memset(_hitTestCache, 0, sizeof(_hitTestCache));
+    self.hitTestCacheNodes.count = 0;
+    self.hitTestCacheNodes.count = HitTestCacheSize;
+}
+
+// Returns the cache entry for the position and mouse button which may be an entry for another position.
+- (INSKViewHitTestCacheEntry *)hitTestCacheEntryForPosition:(CGPoint)position mouseButton:(INSKMouseButton)mouseButton quantizedX:(int64_t *)x quantizedY:(int64_t *)y {
+    // Drop all entries when nodes have been added, removed or enabled for touches.
+    // Moved nodes are noticed by testing a cached node again before returning it, so moves don't drop the cache each frame while scrolling.
+    NSUInteger generation = [SKNode sceneGraphStructureGeneration];
+    if (self.hitTestCacheScene != self.scene || self.hitTestCacheGeneration != generation) {
+        [self clearHitTestCache];
+        self.hitTestCacheScene = self.scene;
+        self.hitTestCacheGeneration = generation;
+    }
+
+    CGFloat granularity = self.hitTestCacheGranularity;
+    if (granularity > 0.0) {
+        *x = (int64_t)floor(position.x / granularity);
+        *y = (int64_t)floor(position.y / granularity);
+    } else {
+        // Use the exact bits of the coordinates.
+        double exactX = position.x;
+        double exactY = position.y;
+        memcpy(x, &exactX, sizeof(*x));
+        memcpy(y, &exactY, sizeof(*y));
+    }
+    uint64_t hash = ((uint64_t)*x * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)*y * 0xC2B2AE3D27D4EB4Full) ^ (uint64_t)mouseButton;
+    hash ^= hash >> 29;
+    return &_hitTestCache[(hash * 0x9E3779B97F4A7C15ull) >> 58 & (HitTestCacheSize - 1)];
 }
 
 
 #pragma mark - public methods
 
+- (void)presentScene:(SKScene *)scene {
+    [super presentScene:scene];
+    [self clearHitTestCache];
+}
+
+- (void)presentScene:(SKScene *)scene transition:(SKTransition *)transition {
+    [super presentScene:scene transition:transition];
+    [self clearHitTestCache];
+}
+
 - (void)addTouchObservingNode:(SKNode *)node {
-    [self.touchObservingNodes addObject:node];
+    [self addTouchObservingNode:node phases:INSKTouchPhaseAll region:CGRectNull];
+}
+
+- (void)addTouchObservingNode:(SKNode *)node phases:(INSKTouchPhase)phases region:(CGRect)region {
+    if (node == nil) {
+        return;
+    }
+    INSKViewTouchObserverFilter filter = {phases, CGRectStandardize(region)};
+    NSMutableData *filters = [self.touchObserverFilters mutableCopy];
+    NSUInteger index = [self.touchObservingNodes indexOfObjectIdenticalTo:node];
+    if (index != NSNotFound) {
+        // Already observing, only change the filter.
+        ((INSKViewTouchObserverFilter *)filters.mutableBytes)[index] = filter;
+    } else {
+        self.touchObservingNodes = [self.touchObservingNodes arrayByAddingObject:node];
+        [filters appendBytes:&filter length:sizeof(filter)];
+    }
+    self.touchObserverFilters = filters;
 }
 
 - (void)removeTouchObservingNode:(SKNode *)node {
-    [self.touchObservingNodes removeObject:node];
+    NSUInteger index = [self.touchObservingNodes indexOfObjectIdenticalTo:node];
+    if (index == NSNotFound) {
+        return;
+    }
+    NSMutableArray *nodes = [self.touchObservingNodes mutableCopy];
+    [nodes removeObjectAtIndex:index];
+    NSMutableData *filters = [self.touchObserverFilters mutableCopy];
+    [filters replaceBytesInRange:NSMakeRange(index * sizeof(INSKViewTouchObserverFilter), sizeof(INSKViewTouchObserverFilter)) withBytes:NULL length:0];
+    self.touchObservingNodes = nodes;
+    self.touchObserverFilters = filters;
 }
 
 - (SKNode *)topInteractingNodeAtPosition:(CGPoint)position {
@@ -102,93 +488,479 @@
 }
 
 - (SKNode *)topInteractingNodeAtPosition:(CGPoint)position withSupportedMouseButton:(INSKMouseButton)mouseButton {
-    NSArray *nodesAtPosition = [self.scene nodesAtPoint:position];
+    // Nodes may have been moved by actions or the physics simulation since the last query.
+    [SKNode sceneToNodeTransformsDidChange];
+    if (!self.hitTestCacheEnabled) {
+        return [self uncachedTopInteractingNodeAtPosition:position withSupportedMouseButton:mouseButton];
+    }
+
+    int64_t x, y;
+    INSKViewHitTestCacheEntry *entry = [self hitTestCacheEntryForPosition:position mouseButton:mouseButton quantizedX:&x quantizedY:&y];
+    NSUInteger entryIndex = entry - _hitTestCache;
+    if (entry->valid && entry->x == x && entry->y == y && entry->mouseButton == mouseButton) {
+        if (!entry->hasNode) {
+            return nil;
+        }
+        // A node which has been freed, removed or moved without being noticed, i.e. by an action, is tested again.
+        SKNode *node = [self.hitTestCacheNodes pointerAtIndex:entryIndex];
+        if (node != nil && node.scene == self.scene && [node containsPoint:[node.parent convertPointFromScene:position]]
+            && [self isNode:node interactingAtPosition:position withSupportedMouseButton:mouseButton]) {
+            return node;
+        }
+    }
+    SKNode *nodeForTouch = [self uncachedTopInteractingNodeAtPosition:position withSupportedMouseButton:mouseButton];
+    entry->valid = YES;
+    entry->x = x;
+    entry->y = y;
+    entry->mouseButton = mouseButton;
+    entry->hasNode = (nodeForTouch != nil);
+    [self.hitTestCacheNodes replacePointerAtIndex:entryIndex withPointer:(__bridge void *)nodeForTouch];
+    return nodeForTouch;
+}
+
+- (NSArray *)topInteractingNodesAtPositions:(const CGPoint *)positions count:(NSUInteger)count {
+    return [self topInteractingNodesAtPositions:positions count:count withSupportedMouseButton:INSKMouseButtonAll];
+}
+
+- (NSArray *)topInteractingNodesAtPositions:(const CGPoint *)positions count:(NSUInteger)count withSupportedMouseButton:(INSKMouseButton)mouseButton {
+    // Nodes may have been moved by actions or the physics simulation since the last query.
+    [SKNode sceneToNodeTransformsDidChange];
+    NSMutableArray *nodesForTouches = [NSMutableArray arrayWithCapacity:count];
+    // Each node keeps the positions it is found at as a bit mask, so process the positions in chunks.
+    NSUInteger const chunkSize = 64;
+    for (NSUInteger chunkStart = 0; chunkStart < count; chunkStart += chunkSize) {
+        NSUInteger chunkCount = MIN(chunkSize, count - chunkStart);
+        [nodesForTouches addObjectsFromArray:[self topInteractingNodesAtPositions:positions + chunkStart chunkCount:chunkCount withSupportedMouseButton:mouseButton]];
+    }
+    return nodesForTouches;
+}
+
+
+#pragma mark - private methods
+
+// Finds the top interacting node at the position without using the hit test cache.
+- (SKNode *)uncachedTopInteractingNodeAtPosition:(CGPoint)position withSupportedMouseButton:(INSKMouseButton)mouseButton {
+    NSArray *nodesAtPosition = nil;
+    INSK_INSTRUMENT(INSKInstrumentationStageSceneQuery, nodesAtPosition = [self nodesAtPosition:position]);
+    INSK_INSTRUMENT_ACCUMULATOR(filteringTime);
+    INSK_INSTRUMENT_ACCUMULATOR(orderResolutionTime);
     SKNode *nodeForTouch = nil;
-    NSInteger nodeForTouchPriority = 0;
-    NSString *nodeForTouchTag = nil;
     for (SKNode *node in nodesAtPosition) {
-        // Only nodes which are enabled for touches, not hidden and not fully transparent should receive touches.
-        if (!node.userInteractionEnabled || node.hidden || node.alpha == 0.0) {
+        BOOL isInteracting;
+        INSK_INSTRUMENT_ACCUMULATE(filteringTime, isInteracting = [self isNode:node interactingAtPosition:position withSupportedMouseButton:mouseButton]);
+        if (!isInteracting) {
             continue;
         }
+        
+        BOOL isAbove;
+        INSK_INSTRUMENT_ACCUMULATE(orderResolutionTime, isAbove = [self isNode:node aboveNode:nodeForTouch]);
+        if (isAbove) {
+            nodeForTouch = node;
+        }
+    }
+    INSK_INSTRUMENT_RECORD(INSKInstrumentationStageFiltering, filteringTime);
+    INSK_INSTRUMENT_RECORD(INSKInstrumentationStageOrderResolution, orderResolutionTime);
+    return nodeForTouch;
+}
+
+// Returns the nodes in the scene whose frame contains the position.
+- (NSArray *)nodesAtPosition:(CGPoint)position {
+    if (self.hitTestIndexEnabled && self.scene != nil) {
+        return [self hitTestIndexNodesAtPosition:position];
+    }
+    return [self.scene nodesAtPoint:position];
+}
+
+// Returns YES if the node may receive touches or mouse events of the given button.
+- (BOOL)isNodeInteracting:(SKNode *)node withSupportedMouseButton:(INSKMouseButton)mouseButton {
+    // Only nodes which are enabled for touches, not hidden and not fully transparent should receive touches.
+    if (!node.userInteractionEnabled || node.hidden || node.alpha == 0.0) {
+        return NO;
+    }
 
 #if !TARGET_OS_IPHONE
-        // Only accept nodes which support the mouse buttons, but only on OS X.
-        if (!(node.supportedMouseButtons & mouseButton)) {
-            continue;
-        }
+    // Only accept nodes which support the mouse buttons, but only on OS X.
+    if (!(node.supportedMouseButtons & mouseButton)) {
+        return NO;
+    }
 #endif
-        
-        // For sprite nodes only accept touches inside of the texture.
-        if ([node isKindOfClass:[SKSpriteNode class]]) {
-            CGPoint positionInNode = [node.scene convertPoint:position toNode:node];
-            if (![(SKSpriteNode *)node isPointInside:positionInNode]) {
-                continue;
-            }
+
+    return YES;
+}
+
+// Returns YES if the node may receive touches or mouse events at the position, which is in the scene's coordinate system.
+- (BOOL)isNode:(SKNode *)node interactingAtPosition:(CGPoint)position withSupportedMouseButton:(INSKMouseButton)mouseButton {
+    if (![self isNodeInteracting:node withSupportedMouseButton:mouseButton]) {
+        return NO;
+    }
+
+    // For sprite nodes only accept touches inside of the texture.
+    // The node caches its transformation from the scene, which is calculated once per query and shared with its siblings.
+    if ([node isKindOfClass:[SKSpriteNode class]]) {
+        CGPoint positionInNode = [node convertPointFromScene:position];
+        if (![(SKSpriteNode *)node isPointInside:positionInNode]) {
+            return NO;
         }
-        
-        // Use first node found.
-        if (nodeForTouch == nil) {
-            nodeForTouch = node;
-            nodeForTouchPriority = nodeForTouch.touchPriority;
-            nodeForTouchTag = nil;
-            continue;
+    }
+
+    return YES;
+}
+
+// Returns YES if the node should receive a touch instead of the current top node, which may be nil.
+- (BOOL)isNode:(SKNode *)node aboveNode:(SKNode *)topNode {
+    // Use first node found.
+    if (topNode == nil) {
+        return YES;
+    }
+
+    // The highest touch priority has always priority.
+    NSInteger nodePriority = node.touchPriority;
+    NSInteger topNodePriority = topNode.touchPriority;
+    if (nodePriority != topNodePriority) {
+        return nodePriority > topNodePriority;
+    }
+
+    // The zPosition has a global impact on the rendering order.
+    // The higher the zPosition the later the rendering,
+    // so take the one with the highest zPosition for touch interaction.
+    if (node.zPosition != topNode.zPosition) {
+        return node.zPosition > topNode.zPosition;
+    }
+
+    // The rendering order in the tree has to descide, the last rendered object receives the touch.
+    return [topNode compareTreeOrder:node] == NSOrderedAscending;
+}
+
+// Returns the accumulated frame of the node, which is its frame if it has no children.
+- (CGRect)accumulatedFrameOfNode:(SKNode *)node {
+    // Most nodes are leafs, so don't let Sprite Kit walk their empty subtree.
+    return (node.children.count == 0) ? node.frame : [node calculateAccumulatedFrame];
+}
+
+// Returns a bit mask of the positions inside of the node's frame, the positions and the node's accumulated frame are in the coordinate system of the node's parent.
+- (uint64_t)positionMaskOfNode:(SKNode *)node accumulatedFrame:(CGRect)accumulatedFrame positionsInParent:(const CGPoint *)positions count:(NSUInteger)count {
+    // Sprite nodes only receive touches inside of their own frame, all other nodes inside of their accumulated frame like nodesAtPoint: checks.
+    CGRect frame = [node isKindOfClass:[SKSpriteNode class]] ? node.frame : accumulatedFrame;
+    uint64_t mask = 0;
+    for (NSUInteger positionIndex = 0; positionIndex < count; ++positionIndex) {
+        if (CGRectContainsPoint(frame, positions[positionIndex])) {
+            mask |= (uint64_t)1 << positionIndex;
         }
-        
-        // The highest touch priority has always priority.
-        NSInteger nodePriority = node.touchPriority;
-        if (nodePriority > nodeForTouchPriority) {
-            nodeForTouch = node;
-            nodeForTouchPriority = nodePriority;
-            nodeForTouchTag = nil;
-            continue;
-        } else if (node.touchPriority < nodeForTouch.touchPriority) {
-            // Ignore nodes with lower touch priority.
+    }
+    return mask;
+}
+
+// Adds the descendants of the parent containing any of the positions to the candidates with a bit mask of the positions they contain.
+- (void)addNodesOfNode:(SKNode *)parent atPositions:(const CGPoint *)positions count:(NSUInteger)count candidates:(NSMutableArray *)candidates masks:(NSMutableData *)masks {
+    NSArray *children = parent.children;
+    if (children.count == 0) {
+        return;
+    }
+
+    // Convert the positions into the parent once for all children.
+    CGPoint positionsInParent[64];
+    memcpy(positionsInParent, positions, count * sizeof(CGPoint));
+    [parent convertPoints:positionsInParent count:count fromNode:self.scene];
+    INSKSpatialBounds positionsBounds = INSKViewBoundsOfPositions(positionsInParent, count);
+
+    for (SKNode *node in children) {
+        // The accumulated frame contains all descendants, so skip the whole branch if it contains no position.
+        // It is calculated once per node and also used for the node's own mask.
+        CGRect accumulatedFrame = [self accumulatedFrameOfNode:node];
+        if (CGRectGetMaxX(accumulatedFrame) < positionsBounds.minX || CGRectGetMinX(accumulatedFrame) > positionsBounds.maxX
+            || CGRectGetMaxY(accumulatedFrame) < positionsBounds.minY || CGRectGetMinY(accumulatedFrame) > positionsBounds.maxY) {
             continue;
         }
-        
-        // The zPosition has a global impact on the rendering order.
-        // The higher the zPosition the later the rendering,
-        // so take the one with the highest zPosition for touch interaction.
-        if (node.zPosition > nodeForTouch.zPosition) {
-            nodeForTouch = node;
-            nodeForTouchPriority = nodePriority;
-            nodeForTouchTag = nil;
-            continue;
-        } else if (node.zPosition < nodeForTouch.zPosition) {
-            // Ignore any nodes with a lower zPosition
+        uint64_t mask = [self positionMaskOfNode:node accumulatedFrame:accumulatedFrame positionsInParent:positionsInParent count:count];
+        if (mask != 0) {
+            [candidates addObject:node];
+            [masks appendBytes:&mask length:sizeof(mask)];
+        }
+        [self addNodesOfNode:node atPositions:positions count:count candidates:candidates masks:masks];
+    }
+}
+
+// Collects the nodes in the scene whose frame contains any of the positions with one query for all positions,
+// each with a bit mask of the positions it contains.
+- (void)collectNodesAtPositions:(const CGPoint *)positions count:(NSUInteger)count candidates:(NSMutableArray *)candidates masks:(NSMutableData *)masks {
+    SKScene *scene = self.scene;
+    if (scene == nil || count == 0) {
+        return;
+    }
+    if (!self.hitTestIndexEnabled) {
+        // Walk the tree once for all positions.
+        [self addNodesOfNode:scene atPositions:positions count:count candidates:candidates masks:masks];
+        return;
+    }
+
+    [self updateHitTestIndex];
+    if (self.hitTestIndex == NULL) {
+        return;
+    }
+    NSMutableArray *indexedNodes = self.hitTestCandidates;
+    [indexedNodes removeAllObjects];
+    INSKSpatialIndexQueryBounds(self.hitTestIndex, INSKViewBoundsOfPositions(positions, count), INSKViewCollectHitTestCandidate, (__bridge void *)indexedNodes);
+
+    // The index only knows the axis aligned bounds in the scene, so check the real frames.
+    // Nodes removed without being noticed, i.e. by an action, are dropped.
+    CGPoint positionsInParent[64];
+    for (SKNode *node in indexedNodes) {
+        if (node.scene != scene) {
             continue;
         }
-        
-        // The rendering order in the tree has to descide, the last rendered object receives the touch.
-        NSString *nodeTag = [self treeOrderTagForNode:node];
-        // The tag is lazily created, so create it now if not yet done.
-        if (nodeForTouchTag == nil) {
-            nodeForTouchTag = [self treeOrderTagForNode:nodeForTouch];
+        memcpy(positionsInParent, positions, count * sizeof(CGPoint));
+        [node.parent convertPoints:positionsInParent count:count fromNode:scene];
+        // Sprite nodes are tested with their own frame, so don't calculate their accumulated frame.
+        CGRect accumulatedFrame = [node isKindOfClass:[SKSpriteNode class]] ? CGRectNull : [self accumulatedFrameOfNode:node];
+        uint64_t mask = [self positionMaskOfNode:node accumulatedFrame:accumulatedFrame positionsInParent:positionsInParent count:count];
+        if (mask != 0) {
+            [candidates addObject:node];
+            [masks appendBytes:&mask length:sizeof(mask)];
         }
-        if ([nodeForTouchTag compare:nodeTag] == NSOrderedAscending) {
-            // Higher string tags should receive touches.
-            nodeForTouch = node;
-            nodeForTouchPriority = nodePriority;
-            nodeForTouchTag = nodeTag;
+    }
+    [indexedNodes removeAllObjects];
+}
+
+// Resolves at most 64 positions at once.
+- (NSArray *)topInteractingNodesAtPositions:(const CGPoint *)positions chunkCount:(NSUInteger)count withSupportedMouseButton:(INSKMouseButton)mouseButton {
+    // Collect all nodes found at any position with a bit mask of the positions they are found at.
+    NSMutableArray *candidates = [NSMutableArray array];
+    NSMutableData *candidateMasksData = [NSMutableData data];
+    INSK_INSTRUMENT_ACCUMULATOR(sceneQueryTime);
+    INSK_INSTRUMENT_ACCUMULATOR(filteringTime);
+    INSK_INSTRUMENT_ACCUMULATOR(orderResolutionTime);
+    INSK_INSTRUMENT_ACCUMULATE(sceneQueryTime, [self collectNodesAtPositions:positions count:count candidates:candidates masks:candidateMasksData]);
+
+    // Check each node only once for all positions it has been found at.
+    NSMutableArray *nodesForPositions = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger positionIndex = 0; positionIndex < count; ++positionIndex) {
+        [nodesForPositions addObject:[NSNull null]];
+    }
+    const uint64_t *candidateMasks = candidateMasksData.bytes;
+    NSUInteger candidateIndex = 0;
+    for (SKNode *node in candidates) {
+        uint64_t mask = candidateMasks[candidateIndex++];
+        BOOL isInteracting;
+        INSK_INSTRUMENT_ACCUMULATE(filteringTime, isInteracting = [self isNodeInteracting:node withSupportedMouseButton:mouseButton]);
+        if (!isInteracting) {
             continue;
-        } else {
-            // Not highest node, ignore it.
+        }
+
+        // For sprite nodes only accept touches inside of the texture.
+        // Get the cached transformation from the scene into the node once for all positions.
+        BOOL isSpriteNode = [node isKindOfClass:[SKSpriteNode class]];
+        CGAffineTransform sceneToNode = CGAffineTransformIdentity;
+        if (isSpriteNode) {
+            INSK_INSTRUMENT_ACCUMULATE(filteringTime, sceneToNode = [node sceneToNodeTransform]);
+        }
+
+        for (NSUInteger positionIndex = 0; positionIndex < count; ++positionIndex) {
+            if (!(mask & ((uint64_t)1 << positionIndex))) {
+                continue;
+            }
+            if (isSpriteNode) {
+                BOOL isInside;
+                INSK_INSTRUMENT_ACCUMULATE(filteringTime, isInside = [(SKSpriteNode *)node isPointInside:CGPointApplyAffineTransform(positions[positionIndex], sceneToNode)]);
+                if (!isInside) {
+                    continue;
+                }
+            }
+            SKNode *topNode = nodesForPositions[positionIndex];
+            BOOL isAbove;
+            INSK_INSTRUMENT_ACCUMULATE(orderResolutionTime, isAbove = [self isNode:node aboveNode:(topNode != (id)[NSNull null]) ? topNode : nil]);
+            if (isAbove) {
+                nodesForPositions[positionIndex] = node;
+            }
+        }
+    }
+    INSK_INSTRUMENT_RECORD(INSKInstrumentationStageSceneQuery, sceneQueryTime);
+    INSK_INSTRUMENT_RECORD(INSKInstrumentationStageFiltering, filteringTime);
+    INSK_INSTRUMENT_RECORD(INSKInstrumentationStageOrderResolution, orderResolutionTime);
+
+    return nodesForPositions;
+}
+
+
+#pragma mark - touch observers
+
+// Calls the block for each observer interested in the phase with at least one of the locations in its region.
+// The locations are in the scene's coordinate system and are only requested when an observer has a region.
+- (void)enumerateTouchObserversForPhase:(INSKTouchPhase)phase locations:(NSArray *(^)(void))locations usingBlock:(void (^)(SKNode *node))block {
+    // Iterate over the current lists, changes made by the observers only take effect with the next event.
+    NSArray *observers = self.touchObservingNodes;
+    const INSKViewTouchObserverFilter *filters = self.touchObserverFilters.bytes;
+    NSArray *locationsInScene = nil;
+    NSUInteger numberOfObservers = observers.count;
+    for (NSUInteger index = 0; index < numberOfObservers; ++index) {
+        const INSKViewTouchObserverFilter *filter = &filters[index];
+        if (!(filter->phases & phase)) {
             continue;
         }
+        if (!CGRectIsNull(filter->region)) {
+            if (locationsInScene == nil) {
+                locationsInScene = (self.scene != nil) ? locations() : @[];
+            }
+            BOOL isInRegion = NO;
+            for (NSValue *location in locationsInScene) {
+#if TARGET_OS_IPHONE
+                CGPoint point = [location CGPointValue];
+#else
+                CGPoint point = [location pointValue];
+#endif
+                if (CGRectContainsPoint(filter->region, point)) {
+                    isInRegion = YES;
+                    break;
+                }
+            }
+            if (!isInRegion) {
+                continue;
+            }
+        }
+        INSK_INSTRUMENT(INSKInstrumentationStageDelivery, block(observers[index]));
     }
-    return nodeForTouch;
+}
+
+
+#pragma mark - coalesced touch moves
+
+- (void)setCoalescesTouchMoves:(BOOL)coalescesTouchMoves {
+    _coalescesTouchMoves = coalescesTouchMoves;
+    if (!coalescesTouchMoves) {
+        [self deliverCoalescedTouchMoves];
+    }
+}
+
+// Buffers a move of a touch for a node adopting INSKCoalescedTouchHandling and makes sure the scene delivers the moves in this frame.
+- (void)coalesceMoveOfTouch:(id)touch key:(uintptr_t)key forNode:(SKNode<INSKCoalescedTouchHandling> *)node location:(CGPoint)location previousLocation:(CGPoint)previousLocation timestamp:(NSTimeInterval)timestamp {
+    NSNumber *moveKey = @(key);
+    INSKViewCoalescedTouchMove *move = self.coalescedTouchMovesByKey[moveKey];
+    if (move != nil && move.node != node) {
+        // The touch has got another node, which must not get the moves for the previous one.
+        [self deliverCoalescedTouchMoves];
+        move = nil;
+    }
+    if (move == nil) {
+        move = [[INSKViewCoalescedTouchMove alloc] init];
+        move.node = node;
+        move.key = key;
+        move.startLocation = previousLocation;
+        move.samples = [NSMutableData dataWithCapacity:4 * sizeof(INSKTouchSample)];
+        [self.coalescedTouchMoves addObject:move];
+        self.coalescedTouchMovesByKey[moveKey] = move;
+    }
+    move.touch = touch;
+    INSKTouchSample sample = {location, timestamp};
+    [move.samples appendBytes:&sample length:sizeof(INSKTouchSample)];
+    
+    // Actions are evaluated once per frame after the scene's update: method.
+    if ([self.scene actionForKey:CoalescedTouchMovesActionKey] == nil) {
+        __weak INSKView *weakSelf = self;
+        [self.scene runAction:[SKAction runBlock:^{
+            [weakSelf deliverCoalescedTouchMoves];
+        }] withKey:CoalescedTouchMovesActionKey];
+    }
+}
+
+- (void)deliverCoalescedTouchMoves {
+    if (self.coalescedTouchMoves.count == 0) {
+        return;
+    }
+    // The nodes convert the samples with their cached transformations, which may have been changed by actions since the moves have been buffered.
+    [SKNode sceneToNodeTransformsDidChange];
+    // Nodes may cause new moves while being informed, so deliver a copy.
+    NSArray *moves = [self.coalescedTouchMoves copy];
+    [self.coalescedTouchMoves removeAllObjects];
+    [self.coalescedTouchMovesByKey removeAllObjects];
+    for (INSKViewCoalescedTouchMove *move in moves) {
+        INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [move.node touchMovedCoalesced:move.touch samples:move.samples.bytes count:move.samples.length / sizeof(INSKTouchSample) startLocation:move.startLocation]);
+    }
+}
+
+
+#pragma mark - input recording
+
+// Adds an event to the input recording.
+- (void)recordEventAtLocation:(CGPoint)location touchId:(uint32_t)touchId phase:(INSKTouchPhase)phase button:(INSKMouseButton)button timestamp:(NSTimeInterval)timestamp {
+    INSKInputEvent inputEvent = {timestamp, (float)location.x, (float)location.y, touchId, (uint8_t)phase, (uint8_t)button};
+    INSKInputRecordingAppend(self.inputRecording, &inputEvent);
 }
 
 
 #if TARGET_OS_IPHONE
 #pragma mark - touches
 
+- (void)recordTouches:(NSSet *)touches phase:(INSKTouchPhase)phase {
+    if (self.inputRecording == NULL || self.scene == nil) {
+        return;
+    }
+    for (UITouch *touch in touches) {
+        [self recordEventAtLocation:[touch locationInNode:self.scene] touchId:INSKViewRecordingTouchId(touch) phase:phase button:0 timestamp:touch.timestamp];
+    }
+}
+
+// Informs the interested touch observers about touches.
+- (void)enumerateTouchObserversForPhase:(INSKTouchPhase)phase touches:(NSSet *)touches usingBlock:(void (^)(SKNode *node))block {
+    [self enumerateTouchObserversForPhase:phase locations:^NSArray *{
+        NSMutableArray *locations = [NSMutableArray arrayWithCapacity:touches.count];
+        for (UITouch *touch in touches) {
+            [locations addObject:[NSValue valueWithCGPoint:[touch locationInNode:self.scene]]];
+        }
+        return locations;
+    } usingBlock:block];
+}
+
+// Saves the node which handles the touch, the node is retained until removeNodeForTouch: is called.
+- (void)setNode:(SKNode *)node forTouch:(UITouch *)touch {
+    uintptr_t key = INSKViewTouchKey(touch);
+    if (self.overflowNodeForTouchTable.count == 0 || NSMapGet(self.overflowNodeForTouchTable, (void *)key) == NULL) {
+        void *retainedNode = (__bridge_retained void *)node;
+        void *previousNode = NULL;
+        if (INSKTouchSlotTableSet(&_nodeForTouchTable, key, retainedNode, &previousNode)) {
+            if (previousNode != NULL) {
+                CFRelease(previousNode);
+            }
+            return;
+        }
+        CFRelease(retainedNode);
+    }
+    // More touches than the table can track, i.e. a stuck touch which never ended, so keep the others in the slower map instead of ignoring them.
+    NSMapInsert(self.overflowNodeForTouchTable, (void *)key, (__bridge void *)node);
+}
+
+// Returns the node which handles the touch.
+- (SKNode *)nodeForTouch:(UITouch *)touch {
+    uintptr_t key = INSKViewTouchKey(touch);
+    SKNode *node = (__bridge SKNode *)INSKTouchSlotTableGet(&_nodeForTouchTable, key);
+    if (node == nil && self.overflowNodeForTouchTable.count > 0) {
+        node = (__bridge SKNode *)NSMapGet(self.overflowNodeForTouchTable, (void *)key);
+    }
+    return node;
+}
+
+// Removes and returns the node which handles the touch.
+- (SKNode *)removeNodeForTouch:(UITouch *)touch {
+    uintptr_t key = INSKViewTouchKey(touch);
+    // The table's reference is transfered to the returned node.
+    SKNode *node = CFBridgingRelease(INSKTouchSlotTableRemove(&_nodeForTouchTable, key));
+    if (node == nil && self.overflowNodeForTouchTable.count > 0) {
+        node = (__bridge SKNode *)NSMapGet(self.overflowNodeForTouchTable, (void *)key);
+        NSMapRemove(self.overflowNodeForTouchTable, (void *)key);
+    }
+    return node;
+}
+
 - (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
-    // Deliver touches to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record touches if wanted.
+    [self recordTouches:touches phase:INSKTouchPhaseBegan];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver touches to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseBegan touches:touches usingBlock:^(SKNode *node) {
         [node touchesBegan:touches withEvent:event];
-    }
+    }];
     
     // No scene at all, ignore all touches.
     if (self.scene == nil) {
@@ -200,118 +972,164 @@
         return;
     }
 
+    // Find new nodes for all touches at once.
+    NSArray *touchList = touches.allObjects;
+    NSUInteger numberOfTouches = touchList.count;
+    CGPoint touchLocations[numberOfTouches];
+    for (NSUInteger index = 0; index < numberOfTouches; ++index) {
+        touchLocations[index] = [touchList[index] locationInNode:self.scene];
+    }
+    NSArray *nodesForTouches = nil;
+    if (numberOfTouches == 1) {
+        SKNode *nodeForTouch = [self topInteractingNodeAtPosition:touchLocations[0]];
+        nodesForTouches = @[(nodeForTouch != nil) ? nodeForTouch : [NSNull null]];
+    } else {
+        nodesForTouches = [self topInteractingNodesAtPositions:touchLocations count:numberOfTouches];
+    }
+
     // Deliver touches to touched nodes.
-    for (UITouch *touch in touches) {
-        // Find new node for touch.
-        CGPoint touchLocation = [touch locationInNode:self.scene];
-        SKNode *nodeForTouch = [self topInteractingNodeAtPosition:touchLocation];
-        if (nodeForTouch == nil) {
+    for (NSUInteger index = 0; index < numberOfTouches; ++index) {
+        UITouch *touch = touchList[index];
+        SKNode *nodeForTouch = nodesForTouches[index];
+        if ((id)nodeForTouch == [NSNull null]) {
             // No node found for touch at the position, use the scene.
             nodeForTouch = self.scene;
         }
         
-        // save found node for touch position
-        NSValue *key = [NSValue valueWithCGPoint:[touch locationInView:nil]];
-        [self.nodeForTouchMapping setObject:nodeForTouch forKey:key];
+        // save found node for touch, the table holds a strong reference to the node
+        [self setNode:nodeForTouch forTouch:touch];
         // deliver touch to node
-        [nodeForTouch touchesBegan:[NSSet setWithObject:touch] withEvent:event];
+        INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [nodeForTouch touchesBegan:[NSSet setWithObject:touch] withEvent:event]);
     }
 }
 
 - (void)touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event {
-    // Deliver touches to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record touches if wanted.
+    [self recordTouches:touches phase:INSKTouchPhaseMoved];
+
+    // Deliver touches to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseMoved touches:touches usingBlock:^(SKNode *node) {
         [node touchesMoved:touches withEvent:event];
-    }
+    }];
     
     // Deliver touches to touched nodes.
     for (UITouch *touch in touches) {
         // Get saved node for touch.
-        NSValue *key = [NSValue valueWithCGPoint:[touch previousLocationInView:nil]];
-        SKNode *nodeForTouch = [self.nodeForTouchMapping objectForKey:key];
-        // Fallback because the touch with the same location may be returned.
+        SKNode *nodeForTouch = [self nodeForTouch:touch];
         if (nodeForTouch == nil) {
-            key = [NSValue valueWithCGPoint:[touch locationInView:nil]];
-            nodeForTouch = [self.nodeForTouchMapping objectForKey:key];
-            if (nodeForTouch == nil) {
-                // Still no node found, maybe there is no scene so ignore touch.
-                continue;
-            }
+            // No node found, maybe there is no scene so ignore touch.
+            continue;
+        }
+        
+        // Buffer the move if the node wants all moves once per frame.
+        if (self.coalescesTouchMoves && self.scene != nil && [nodeForTouch conformsToProtocol:@protocol(INSKCoalescedTouchHandling)]) {
+            [self coalesceMoveOfTouch:touch key:INSKViewTouchKey(touch) forNode:(SKNode<INSKCoalescedTouchHandling> *)nodeForTouch location:[touch locationInNode:self.scene] previousLocation:[touch previousLocationInNode:self.scene] timestamp:touch.timestamp];
+            continue;
         }
         
-        // Update touch key.
-        [self.nodeForTouchMapping removeObjectForKey:key];
-        key = [NSValue valueWithCGPoint:[touch locationInNode:nil]];
-        [self.nodeForTouchMapping setObject:nodeForTouch forKey:key];
         // Deliver touch to node.
-        [nodeForTouch touchesMoved:[NSSet setWithObject:touch] withEvent:event];
+        INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [nodeForTouch touchesMoved:[NSSet setWithObject:touch] withEvent:event]);
     }
 }
 
 - (void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event {
-    // Deliver touches to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record touches if wanted.
+    [self recordTouches:touches phase:INSKTouchPhaseEnded];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver touches to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseEnded touches:touches usingBlock:^(SKNode *node) {
         [node touchesEnded:touches withEvent:event];
-    }
+    }];
     
     // Deliver touches to touched nodes.
     for (UITouch *touch in touches) {
-        // Get saved node for touch.
-        NSValue *key = [NSValue valueWithCGPoint:[touch previousLocationInView:nil]];
-        SKNode *nodeForTouch = [self.nodeForTouchMapping objectForKey:key];
-        // Fallback because the touch with the same location may be returned.
+        // Get saved node for touch and clean up the touch mapping.
+        SKNode *nodeForTouch = [self removeNodeForTouch:touch];
         if (nodeForTouch == nil) {
-            key = [NSValue valueWithCGPoint:[touch locationInView:nil]];
-            nodeForTouch = [self.nodeForTouchMapping objectForKey:key];
-            if (nodeForTouch == nil) {
-                // Still no node found, maybe there is no scene so ignore touch.
-                continue;
-            }
+            // No node found, maybe there is no scene so ignore touch.
+            continue;
         }
         
-        // Clean up touch mapping.
-        [self.nodeForTouchMapping removeObjectForKey:key];
         // Deliver touch to node.
-        [nodeForTouch touchesEnded:[NSSet setWithObject:touch] withEvent:event];
+        INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [nodeForTouch touchesEnded:[NSSet setWithObject:touch] withEvent:event]);
     }
 }
 
 - (void)touchesCancelled:(NSSet *)touches withEvent:(UIEvent *)event {
-    // Deliver touches to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record touches if wanted.
+    [self recordTouches:touches phase:INSKTouchPhaseCancelled];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver touches to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseCancelled touches:touches usingBlock:^(SKNode *node) {
         [node touchesCancelled:touches withEvent:event];
-    }
+    }];
     
     // Deliver touches to touched nodes.
     for (UITouch *touch in touches) {
-        // Get saved node for touch.
-        NSValue *key = [NSValue valueWithCGPoint:[touch previousLocationInView:nil]];
-        SKNode *nodeForTouch = [self.nodeForTouchMapping objectForKey:key];
-        // Fallback because the touch with the same location may be returned.
+        // Get saved node for touch and clean up the touch mapping.
+        SKNode *nodeForTouch = [self removeNodeForTouch:touch];
         if (nodeForTouch == nil) {
-            key = [NSValue valueWithCGPoint:[touch locationInView:nil]];
-            nodeForTouch = [self.nodeForTouchMapping objectForKey:key];
-            if (nodeForTouch == nil) {
-                // Still no node found, maybe there is no scene so ignore touch.
-                continue;
-            }
+            // No node found, maybe there is no scene so ignore touch.
+            continue;
         }
         
-        // Clean up touch mapping.
-        [self.nodeForTouchMapping removeObjectForKey:key];
         // Deliver touch to node.
-        [nodeForTouch touchesCancelled:[NSSet setWithObject:touch] withEvent:event];
+        INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [nodeForTouch touchesCancelled:[NSSet setWithObject:touch] withEvent:event]);
     }
 }
 
 #else // OSX
 #pragma mark - mouse events
 
+- (void)recordMouseEvent:(NSEvent *)theEvent phase:(INSKTouchPhase)phase button:(INSKMouseButton)button {
+    if (self.inputRecording == NULL || self.scene == nil) {
+        return;
+    }
+    [self recordEventAtLocation:[theEvent locationInNode:self.scene] touchId:0 phase:phase button:button timestamp:theEvent.timestamp];
+}
+
+// Buffers a mouse dragged event if the active node wants all moves once per frame, returns NO if the event has to be delivered directly.
+- (BOOL)coalesceMouseDragged:(NSEvent *)theEvent {
+    if (self.scene == nil) {
+        return NO;
+    }
+    CGPoint previousLocation = self.lastMouseLocation;
+    self.lastMouseLocation = [theEvent locationInNode:self.scene];
+    SKNode *node = self.nodeForMouseEvent;
+    if (!self.coalescesTouchMoves || ![node conformsToProtocol:@protocol(INSKCoalescedTouchHandling)]) {
+        return NO;
+    }
+    [self coalesceMoveOfTouch:theEvent key:0 forNode:(SKNode<INSKCoalescedTouchHandling> *)node location:self.lastMouseLocation previousLocation:previousLocation timestamp:theEvent.timestamp];
+    return YES;
+}
+
+// Informs the interested touch observers about a mouse event.
+- (void)enumerateTouchObserversForPhase:(INSKTouchPhase)phase mouseEvent:(NSEvent *)theEvent usingBlock:(void (^)(SKNode *node))block {
+    [self enumerateTouchObserversForPhase:phase locations:^NSArray *{
+        return @[[NSValue valueWithPoint:[theEvent locationInNode:self.scene]]];
+    } usingBlock:block];
+}
+
 - (void)mouseDown:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseBegan button:INSKMouseButtonLeft];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseBegan mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node mouseDown:theEvent];
-    }
+    }];
     
     // Track mouse events
     self.numberOfMouseButtonsPressed++;
@@ -334,17 +1152,25 @@
         
         // save found node for event processing
         self.nodeForMouseEvent = nodeForEvent;
+        self.lastMouseLocation = positionInScene;
     }
     
     // Deliver touch to node
-    [self.nodeForMouseEvent mouseDown:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent mouseDown:theEvent]);
 }
 
 - (void)rightMouseDown:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseBegan button:INSKMouseButtonRight];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseBegan mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node rightMouseDown:theEvent];
-    }
+    }];
     
     // Track mouse events
     self.numberOfMouseButtonsPressed++;
@@ -373,17 +1199,25 @@
         
         // save found node for event processing
         self.nodeForMouseEvent = nodeForEvent;
+        self.lastMouseLocation = positionInScene;
     }
     
     // Deliver touch to node
-    [self.nodeForMouseEvent rightMouseDown:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent rightMouseDown:theEvent]);
 }
 
 - (void)otherMouseDown:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseBegan button:INSKMouseButtonOther];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseBegan mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node otherMouseDown:theEvent];
-    }
+    }];
     
     // Track mouse events
     self.numberOfMouseButtonsPressed++;
@@ -406,27 +1240,39 @@
         
         // save found node for event processing
         self.nodeForMouseEvent = nodeForEvent;
+        self.lastMouseLocation = positionInScene;
     }
     
     // Deliver touch to node
-    [self.nodeForMouseEvent otherMouseDown:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent otherMouseDown:theEvent]);
 }
 
 - (void)mouseDragged:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseMoved button:INSKMouseButtonLeft];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseMoved mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node mouseDragged:theEvent];
+    }];
+    
+    // Buffer the event if the node wants all moves once per frame.
+    if ([self coalesceMouseDragged:theEvent]) {
+        return;
     }
     
     // Deliver event to active node.
-    [self.nodeForMouseEvent mouseDragged:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent mouseDragged:theEvent]);
 }
 
 - (void)rightMouseDragged:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseMoved button:INSKMouseButtonRight];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseMoved mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node rightMouseDragged:theEvent];
-    }
+    }];
     
     // Support AppKit's defaults behavior
     if (!self.deliverRightMouseButtonEventsToScene) {
@@ -434,39 +1280,66 @@
         return;
     }
     
+    // Buffer the event if the node wants all moves once per frame.
+    if ([self coalesceMouseDragged:theEvent]) {
+        return;
+    }
+    
     // Deliver event to active node.
-    [self.nodeForMouseEvent rightMouseDragged:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent rightMouseDragged:theEvent]);
 }
 
 - (void)otherMouseDragged:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseMoved button:INSKMouseButtonOther];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseMoved mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node otherMouseDragged:theEvent];
+    }];
+    
+    // Buffer the event if the node wants all moves once per frame.
+    if ([self coalesceMouseDragged:theEvent]) {
+        return;
     }
     
     // Deliver event to active node.
-    [self.nodeForMouseEvent otherMouseDragged:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent otherMouseDragged:theEvent]);
 }
 
 - (void)mouseUp:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseEnded button:INSKMouseButtonLeft];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseEnded mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node mouseUp:theEvent];
-    }
+    }];
     
     // Track mouse events
     self.numberOfMouseButtonsPressed--;
     //NSLog(@"currently mouse buttons pressed: %ld", (long)self.numberOfMouseButtonsPressed);
     
     // Deliver event to active node.
-    [self.nodeForMouseEvent mouseUp:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent mouseUp:theEvent]);
 }
 
 - (void)rightMouseUp:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseEnded button:INSKMouseButtonRight];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseEnded mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node rightMouseUp:theEvent];
-    }
+    }];
     
     // Track mouse events
     self.numberOfMouseButtonsPressed--;
@@ -479,21 +1352,28 @@
     }
 
     // Deliver event to active node.
-    [self.nodeForMouseEvent rightMouseUp:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent rightMouseUp:theEvent]);
 }
 
 - (void)otherMouseUp:(NSEvent *)theEvent {
-    // Deliver mouse event to all observers.
-    for (SKNode *node in self.touchObservingNodes) {
+    // Record mouse event if wanted.
+    [self recordMouseEvent:theEvent phase:INSKTouchPhaseEnded button:INSKMouseButtonOther];
+
+    // The buffered moves happened before this event, so their nodes get them before any observer or node is informed about it.
+    // The observers have already got each move when it happened.
+    [self deliverCoalescedTouchMoves];
+
+    // Deliver mouse event to all interested observers.
+    [self enumerateTouchObserversForPhase:INSKTouchPhaseEnded mouseEvent:theEvent usingBlock:^(SKNode *node) {
         [node otherMouseUp:theEvent];
-    }
+    }];
     
     // Track mouse events
     self.numberOfMouseButtonsPressed--;
     //NSLog(@"currently mouse buttons pressed: %ld", (long)self.numberOfMouseButtonsPressed);
     
     // Deliver event to active node.
-    [self.nodeForMouseEvent otherMouseUp:theEvent];
+    INSK_INSTRUMENT(INSKInstrumentationStageDelivery, [self.nodeForMouseEvent otherMouseUp:theEvent]);
 }
 
 #endif // OS X
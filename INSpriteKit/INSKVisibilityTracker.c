@@ -0,0 +1,293 @@
+// INSKVisibilityTracker.c
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "INSKVisibilityTracker.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+// The deepest tree the tracker creates, enough for a million rows.
+#define INSKVisibilityTrackerMaxDepth 20
+// The initial number of indexes in the lists.
+#define INSKVisibilityTrackerInitialCapacity 64
+
+
+typedef struct {
+    size_t *indexes;
+    size_t count;
+    size_t capacity;
+} INSKVisibilityTrackerList;
+
+struct INSKVisibilityTracker {
+    INSKSpatialIndex *index;
+    size_t itemCount;
+    // An item is visible when its stamp equals the current frame.
+    uint32_t *stamps;
+    uint32_t frame;
+    INSKVisibilityTrackerList visible;
+    INSKVisibilityTrackerList nextVisible;
+    INSKVisibilityTrackerList entered;
+    INSKVisibilityTrackerList exited;
+    // Set by the query visitor when a list couldn't grow.
+    bool failed;
+};
+
+
+#pragma mark - private functions
+
+static bool INSKVisibilityTrackerListAppend(INSKVisibilityTrackerList *list, size_t value) {
+    if (list->count == list->capacity) {
+        size_t capacity = (list->capacity == 0) ? INSKVisibilityTrackerInitialCapacity : list->capacity * 2;
+        size_t *indexes = (size_t *)realloc(list->indexes, capacity * sizeof(size_t));
+        if (indexes == NULL) {
+            return false;
+        }
+        list->indexes = indexes;
+        list->capacity = capacity;
+    }
+    list->indexes[list->count++] = value;
+    return true;
+}
+
+static void INSKVisibilityTrackerListFree(INSKVisibilityTrackerList *list) {
+    free(list->indexes);
+    list->indexes = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+// Advances the frame counter, which invalidates all stamps of the previous frame.
+// Returns the previous frame.
+static uint32_t INSKVisibilityTrackerNextFrame(INSKVisibilityTracker *tracker) {
+    if (tracker->frame == UINT32_MAX) {
+        // Restart the counter after the wrap around, keeping the visible items visible.
+        if (tracker->itemCount > 0) {
+            memset(tracker->stamps, 0, tracker->itemCount * sizeof(uint32_t));
+        }
+        for (size_t i = 0; i < tracker->visible.count; ++i) {
+            tracker->stamps[tracker->visible.indexes[i]] = 1;
+        }
+        tracker->frame = 1;
+    }
+    return tracker->frame++;
+}
+
+// Chooses a tree depth where the cells are about the size of an average item.
+static unsigned int INSKVisibilityTrackerDepth(INSKSpatialBounds world, double averageExtent) {
+    double size = fmax(world.maxX - world.minX, world.maxY - world.minY);
+    unsigned int depth = 0;
+    while (depth < INSKVisibilityTrackerMaxDepth && size / 2.0 >= averageExtent) {
+        size /= 2.0;
+        depth++;
+    }
+    return depth;
+}
+
+typedef struct {
+    INSKVisibilityTracker *tracker;
+    uint32_t previousFrame;
+} INSKVisibilityTrackerQueryContext;
+
+static void INSKVisibilityTrackerVisitItem(void *object, void *context) {
+    INSKVisibilityTrackerQueryContext *query = (INSKVisibilityTrackerQueryContext *)context;
+    INSKVisibilityTracker *tracker = query->tracker;
+    size_t item = (size_t)(uintptr_t)object;
+    if (tracker->stamps[item] != query->previousFrame) {
+        if (!INSKVisibilityTrackerListAppend(&tracker->entered, item)) {
+            tracker->failed = true;
+            return;
+        }
+    }
+    if (!INSKVisibilityTrackerListAppend(&tracker->nextVisible, item)) {
+        tracker->failed = true;
+        if (tracker->entered.count > 0 && tracker->entered.indexes[tracker->entered.count - 1] == item) {
+            tracker->entered.count--;
+        }
+        return;
+    }
+    tracker->stamps[item] = tracker->frame;
+}
+
+typedef struct {
+    INSKVisibilityTrackerVisitor visitor;
+    void *context;
+} INSKVisibilityTrackerLookContext;
+
+static void INSKVisibilityTrackerLookAtItem(void *object, void *context) {
+    INSKVisibilityTrackerLookContext *look = (INSKVisibilityTrackerLookContext *)context;
+    look->visitor((size_t)(uintptr_t)object, look->context);
+}
+
+
+#pragma mark - public functions
+
+INSKVisibilityTracker *INSKVisibilityTrackerCreate(void) {
+    INSKVisibilityTracker *tracker = (INSKVisibilityTracker *)calloc(1, sizeof(INSKVisibilityTracker));
+    if (tracker == NULL) {
+        return NULL;
+    }
+    INSKSpatialBounds empty = {0.0, 0.0, 0.0, 0.0};
+    tracker->index = INSKSpatialIndexCreate(empty, 0);
+    if (tracker->index == NULL) {
+        free(tracker);
+        return NULL;
+    }
+    tracker->frame = 1;
+    return tracker;
+}
+
+void INSKVisibilityTrackerDestroy(INSKVisibilityTracker *tracker) {
+    if (tracker == NULL) {
+        return;
+    }
+    INSKSpatialIndexDestroy(tracker->index);
+    free(tracker->stamps);
+    INSKVisibilityTrackerListFree(&tracker->visible);
+    INSKVisibilityTrackerListFree(&tracker->nextVisible);
+    INSKVisibilityTrackerListFree(&tracker->entered);
+    INSKVisibilityTrackerListFree(&tracker->exited);
+    free(tracker);
+}
+
+bool INSKVisibilityTrackerSetItems(INSKVisibilityTracker *tracker, const INSKSpatialBounds *bounds, size_t count) {
+    tracker->visible.count = 0;
+    tracker->entered.count = 0;
+    tracker->exited.count = 0;
+    tracker->itemCount = 0;
+    tracker->frame = 1;
+
+    // Find the world and the average size of the items for a tree fitting the layout.
+    INSKSpatialBounds world = {0.0, 0.0, 0.0, 0.0};
+    double extentSum = 0.0;
+    size_t validCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        INSKSpatialBounds item = bounds[i];
+        if (!isfinite(item.minX) || !isfinite(item.minY) || !isfinite(item.maxX) || !isfinite(item.maxY)) {
+            continue;
+        }
+        if (validCount == 0) {
+            world = item;
+        } else {
+            world.minX = fmin(world.minX, item.minX);
+            world.minY = fmin(world.minY, item.minY);
+            world.maxX = fmax(world.maxX, item.maxX);
+            world.maxY = fmax(world.maxY, item.maxY);
+        }
+        extentSum += fmax(item.maxX - item.minX, item.maxY - item.minY);
+        validCount++;
+    }
+    double averageExtent = (validCount > 0) ? extentSum / validCount : 0.0;
+    INSKSpatialIndexDestroy(tracker->index);
+    tracker->index = INSKSpatialIndexCreate(world, INSKVisibilityTrackerDepth(world, averageExtent));
+    if (tracker->index == NULL) {
+        // Keep a valid empty index, so the tracker can still be used.
+        INSKSpatialBounds empty = {0.0, 0.0, 0.0, 0.0};
+        tracker->index = INSKSpatialIndexCreate(empty, 0);
+        return false;
+    }
+
+    if (count > 0) {
+        uint32_t *stamps = (uint32_t *)realloc(tracker->stamps, count * sizeof(uint32_t));
+        if (stamps == NULL) {
+            return false;
+        }
+        tracker->stamps = stamps;
+        memset(tracker->stamps, 0, count * sizeof(uint32_t));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (INSKSpatialIndexInsert(tracker->index, bounds[i], (void *)(uintptr_t)i) == INSKSpatialIndexInvalidHandle) {
+            INSKSpatialIndexReset(tracker->index, world);
+            return false;
+        }
+    }
+    tracker->itemCount = count;
+    return true;
+}
+
+size_t INSKVisibilityTrackerItemCount(const INSKVisibilityTracker *tracker) {
+    return tracker->itemCount;
+}
+
+void INSKVisibilityTrackerReset(INSKVisibilityTracker *tracker) {
+    INSKVisibilityTrackerNextFrame(tracker);
+    tracker->entered.count = 0;
+    // The visible list becomes the exited list.
+    INSKVisibilityTrackerList exited = tracker->exited;
+    tracker->exited = tracker->visible;
+    tracker->visible = exited;
+    tracker->visible.count = 0;
+}
+
+bool INSKVisibilityTrackerUpdate(INSKVisibilityTracker *tracker, INSKSpatialBounds viewport) {
+    INSKVisibilityTrackerQueryContext query;
+    query.tracker = tracker;
+    query.previousFrame = INSKVisibilityTrackerNextFrame(tracker);
+    tracker->failed = false;
+    tracker->entered.count = 0;
+    tracker->exited.count = 0;
+    tracker->nextVisible.count = 0;
+    INSKSpatialIndexQueryBounds(tracker->index, viewport, INSKVisibilityTrackerVisitItem, &query);
+
+    // Items of the previous frame which haven't been stamped again have left the viewport.
+    for (size_t i = 0; i < tracker->visible.count; ++i) {
+        size_t item = tracker->visible.indexes[i];
+        if (tracker->stamps[item] != tracker->frame) {
+            if (!INSKVisibilityTrackerListAppend(&tracker->exited, item)) {
+                tracker->failed = true;
+            }
+        }
+    }
+
+    INSKVisibilityTrackerList visible = tracker->visible;
+    tracker->visible = tracker->nextVisible;
+    tracker->nextVisible = visible;
+    return !tracker->failed;
+}
+
+const size_t *INSKVisibilityTrackerEntered(const INSKVisibilityTracker *tracker, size_t *count) {
+    *count = tracker->entered.count;
+    return tracker->entered.indexes;
+}
+
+const size_t *INSKVisibilityTrackerExited(const INSKVisibilityTracker *tracker, size_t *count) {
+    *count = tracker->exited.count;
+    return tracker->exited.indexes;
+}
+
+const size_t *INSKVisibilityTrackerVisible(const INSKVisibilityTracker *tracker, size_t *count) {
+    *count = tracker->visible.count;
+    return tracker->visible.indexes;
+}
+
+bool INSKVisibilityTrackerIsVisible(const INSKVisibilityTracker *tracker, size_t item) {
+    return item < tracker->itemCount && tracker->stamps[item] == tracker->frame;
+}
+
+size_t INSKVisibilityTrackerQuery(const INSKVisibilityTracker *tracker, INSKSpatialBounds bounds, INSKVisibilityTrackerVisitor visitor, void *context) {
+    INSKVisibilityTrackerLookContext look;
+    look.visitor = visitor;
+    look.context = context;
+    return INSKSpatialIndexQueryBounds(tracker->index, bounds, INSKVisibilityTrackerLookAtItem, &look);
+}
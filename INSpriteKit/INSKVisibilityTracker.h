@@ -0,0 +1,174 @@
+// INSKVisibilityTracker.h
+//
+// Copyright (c) 2014 Sven Korset
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef INSK_VISIBILITY_TRACKER_H
+#define INSK_VISIBILITY_TRACKER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "INSKSpatialIndex.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ Tracks which items of a big static layout intersect a moving viewport.
+
+ This is a plain C implementation without any dependencies to Sprite Kit or Foundation and can be used on any platform.
+ The item bounds are kept in a INSKSpatialIndex, so an update costs about as much as the number of visible items
+ and not as the total number of items.
+ Each update reports the items which became visible and the ones which aren't visible anymore,
+ which is all that's needed to create nodes for entering items and recycle the nodes of leaving items.
+ Items are identified by their index in the array passed to INSKVisibilityTrackerSetItems().
+ */
+typedef struct INSKVisibilityTracker INSKVisibilityTracker;
+
+/**
+ The callback for INSKVisibilityTrackerQuery(). Called once for each item intersecting the queried bounds.
+
+ @param item The index of the item.
+ @param context The context passed to INSKVisibilityTrackerQuery().
+ */
+typedef void (*INSKVisibilityTrackerVisitor)(size_t item, void *context);
+
+
+/**
+ Creates a new tracker without any items.
+
+ @return A new tracker which has to be freed with INSKVisibilityTrackerDestroy() or NULL if the memory couldn't be allocated.
+ */
+INSKVisibilityTracker *INSKVisibilityTrackerCreate(void);
+
+/**
+ Frees the tracker and all its memory.
+
+ @param tracker The tracker to free, may be NULL.
+ */
+void INSKVisibilityTrackerDestroy(INSKVisibilityTracker *tracker);
+
+/**
+ Replaces all items of the tracker.
+
+ Afterwards no item is visible, so the next update reports all items inside of the viewport as entered.
+ Call INSKVisibilityTrackerReset() before to get the currently visible items reported as exited.
+
+ @param tracker The tracker.
+ @param bounds The bounds of the items, the array is copied.
+ @param count The number of items.
+ @return False if the memory couldn't be allocated, the tracker has no items then.
+ */
+bool INSKVisibilityTrackerSetItems(INSKVisibilityTracker *tracker, const INSKSpatialBounds *bounds, size_t count);
+
+/**
+ Returns the number of items.
+
+ @param tracker The tracker.
+ @return The number of items set with INSKVisibilityTrackerSetItems().
+ */
+size_t INSKVisibilityTrackerItemCount(const INSKVisibilityTracker *tracker);
+
+/**
+ Marks all items as invisible and reports all previously visible items as exited.
+
+ @param tracker The tracker.
+ */
+void INSKVisibilityTrackerReset(INSKVisibilityTracker *tracker);
+
+/**
+ Updates the visible items for a new viewport.
+
+ An item is visible when its bounds intersect the viewport, inclusive the borders.
+ Afterwards INSKVisibilityTrackerEntered() returns the items which weren't visible before
+ and INSKVisibilityTrackerExited() the items which aren't visible anymore.
+
+ @param tracker The tracker.
+ @param viewport The visible area including any margin.
+ @return False if the memory couldn't be allocated, the visible items may be incomplete then.
+ */
+bool INSKVisibilityTrackerUpdate(INSKVisibilityTracker *tracker, INSKSpatialBounds viewport);
+
+/**
+ Returns the indexes of the items which became visible with the last update.
+
+ The order of the indexes is undefined.
+
+ @param tracker The tracker.
+ @param count Receives the number of indexes.
+ @return The indexes, valid until the next update.
+ */
+const size_t *INSKVisibilityTrackerEntered(const INSKVisibilityTracker *tracker, size_t *count);
+
+/**
+ Returns the indexes of the items which aren't visible anymore since the last update or reset.
+
+ The order of the indexes is undefined.
+
+ @param tracker The tracker.
+ @param count Receives the number of indexes.
+ @return The indexes, valid until the next update.
+ */
+const size_t *INSKVisibilityTrackerExited(const INSKVisibilityTracker *tracker, size_t *count);
+
+/**
+ Returns the indexes of all visible items.
+
+ The order of the indexes is undefined.
+
+ @param tracker The tracker.
+ @param count Receives the number of indexes.
+ @return The indexes, valid until the next update.
+ */
+const size_t *INSKVisibilityTrackerVisible(const INSKVisibilityTracker *tracker, size_t *count);
+
+/**
+ Returns whether an item is visible.
+
+ @param tracker The tracker.
+ @param item The index of the item.
+ @return True if the item intersected the viewport of the last update, false for invalid indexes.
+ */
+bool INSKVisibilityTrackerIsVisible(const INSKVisibilityTracker *tracker, size_t item);
+
+/**
+ Calls the visitor for each item intersecting some bounds, inclusive the borders.
+
+ The visible, entered and exited items aren't changed, so this can be used to look ahead, i.e. at the viewport a scroll motion ends in.
+ The order in which the items are visited is undefined.
+
+ @param tracker The tracker.
+ @param bounds The bounds to test against.
+ @param visitor The callback.
+ @param context Passed to the visitor.
+ @return The number of items visited.
+ */
+size_t INSKVisibilityTrackerQuery(const INSKVisibilityTracker *tracker, INSKSpatialBounds bounds, INSKVisibilityTrackerVisitor visitor, void *context);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
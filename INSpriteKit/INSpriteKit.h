@@ -26,7 +26,21 @@
 
 #import "INSKTypes.h"
 #import "INSKMath.h"
+#import "INSKMathBatch.h"
+#import "INSKMathFast.h"
+#import "INSKMathEasing.h"
+#import "INSKFixed.h"
+#import "INSKGeometry.h"
+#import "INSKSpatialIndex.h"
+#import "INSKVisibilityTracker.h"
+#import "INSKScrollPhysics.h"
+#import "INSKVelocityEstimator.h"
+#import "INSKInputRecording.h"
+#import "INSKInputReplay.h"
+#import "INSKInstrumentation.h"
+#import "INSKAlphaBitmask.h"
 
+#import "INSKAlphaMask.h"
 #import "INSKButtonNode.h"
 #import "INSKScrollNode.h"
 #import "INSKView.h"
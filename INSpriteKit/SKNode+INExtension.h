@@ -55,6 +55,173 @@
  */
 @property (nonatomic, assign) INSKMouseButton supportedMouseButtons;
 
+#pragma mark - Scene graph changes
+/// @name Scene graph changes
+
+/**
+ Starts tracking the changes of all scene graphs.
+ 
+ The tracking swizzles Sprite Kit's methods which change the tree or the geometry of nodes, see sceneGraphGeneration for the list.
+ It is only started when needed, i.e. when INSKView's hitTestIndexEnabled or hitTestCacheEnabled is set, when sceneGraphGeneration or sceneGraphStructureGeneration is read
+ for the first time or when a table is registered with addSceneGraphChangeTable:. Changes made before aren't counted.
+ Calling this method again does nothing, the tracking can't be stopped.
+ 
+ @see sceneGraphGeneration
+ */
++ (void)startSceneGraphTracking;
+
+
+/**
+ A counter which is increased on each change of any node which has an impact on the touch delivery.
+ 
+ The counter is increased when the tree of any node changes (addChild:, insertChild:atIndex:, moveToParent:, removeFromParent, removeAllChildren and removeChildrenInArray:)
+ or when the position, zRotation, xScale, yScale, zPosition, hidden, alpha, userInteractionEnabled, touchPriority or supportedMouseButtons of any node have been set.
+ A sprite node's size, anchorPoint and texture and a label node's text, fontName, fontSize, horizontalAlignmentMode and verticalAlignmentMode are also tracked.
+ INSKView uses this value to find out if any cached hit test data has become outdated.
+ The first call starts the tracking with startSceneGraphTracking.
+ 
+ Changes made by running actions or the physics simulation bypass the properties' setters and aren't counted.
+ Call sceneGraphDidChange manually if needed.
+ 
+ @return The current generation of all scene graphs.
+ @see sceneGraphDidChange
+ */
++ (NSUInteger)sceneGraphGeneration;
+
+
+/**
+ A counter which is increased on each change of any node's tree or when any node's userInteractionEnabled property has been set.
+ 
+ When this value doesn't change, but sceneGraphGeneration does, then only the geometry or the visibility of nodes have changed.
+ 
+ @return The current structure generation of all scene graphs.
+ @see sceneGraphGeneration
+ */
++ (NSUInteger)sceneGraphStructureGeneration;
+
+
+/**
+ Increases sceneGraphGeneration and sceneGraphStructureGeneration manually.
+ 
+ Should be called after changes which can't be tracked automatically, i.e. when an action has moved an interacting node.
+ Also marks the cached transformations of all nodes as outdated like sceneToNodeTransformsDidChange.
+ 
+ @see sceneGraphGeneration
+ @see sceneToNodeTransformsDidChange
+ */
++ (void)sceneGraphDidChange;
+
+
+/**
+ Registers a hash table which collects the nodes whose place in the tree or geometry changes.
+ 
+ A node is added to each registered table when it is added to or removed from a parent,
+ when its position, zRotation, xScale, yScale or userInteractionEnabled property is set, for sprite nodes when the size, anchorPoint or texture is set
+ and for label nodes when the text, fontName, fontSize, horizontalAlignmentMode or verticalAlignmentMode is set.
+ When children are removed from a parent, the children are added and not the parent.
+ sceneGraphDidChange adds [NSNull null] which means that any node may have changed.
+ The owner of the table takes the nodes out when it has processed them, i.e. INSKView only updates the changed nodes in its hit test index.
+ Registering a table starts the tracking with startSceneGraphTracking.
+ 
+ Changes made by running actions bypass the properties' setters and won't be collected.
+ 
+ @param table A hash table which should hold its objects weakly, i.e. one created with [NSHashTable weakObjectsHashTable]. The table itself isn't retained.
+ @see removeSceneGraphChangeTable:
+ */
++ (void)addSceneGraphChangeTable:(NSHashTable *)table;
+
+
+/**
+ Stops collecting changed nodes in a hash table registered with addSceneGraphChangeTable:.
+ 
+ @param table The registered table.
+ */
++ (void)removeSceneGraphChangeTable:(NSHashTable *)table;
+
+
+#pragma mark - Coordinate conversion
+/// @name Coordinate conversion
+
+/**
+ Returns the affine transformation from the scene's coordinate system into this node's coordinate system.
+ 
+ The transformation is cached per node and calculated with the cached transformation of the parent, so siblings share the work for their ancestors.
+ Setting the position, zRotation, xScale, yScale or scale of a node or adding it to or removing it from a parent marks the cached transformations
+ of the node and all its descendants as outdated, so returning a valid cached transformation doesn't need to look at the ancestors.
+ This needs the tracking of startSceneGraphTracking, before it has been started the transformation is calculated on each call.
+ 
+ @warning Changes made by running actions or the physics simulation bypass the setters and aren't noticed.
+ Call sceneToNodeTransformsDidChange after such changes. INSKView calls it before each hit test and delivery of coalesced moves.
+ @return The transformation from the scene into this node or the identity transformation if the node isn't in a scene.
+ @see convertPointFromScene:
+ @see sceneToNodeTransformsDidChange
+ */
+- (CGAffineTransform)sceneToNodeTransform;
+
+
+/**
+ Marks the cached transformations of all nodes returned by sceneToNodeTransform as outdated.
+ 
+ Should be called after nodes have been moved, rotated or scaled by actions or the physics simulation before converting points with the cached transformations.
+ Only increases a counter, the transformations are calculated again when they are used the next time.
+ 
+ @see sceneToNodeTransform
+ */
++ (void)sceneToNodeTransformsDidChange;
+
+
+/**
+ Converts a point from the scene's coordinate system into this node's coordinate system with the cached transformation.
+ 
+ Same as [self.scene convertPoint:point toNode:self], but faster when called several times.
+ 
+ @param point A point in the scene's coordinate system.
+ @return The point in the node's coordinate system.
+ @see sceneToNodeTransform
+ */
+- (CGPoint)convertPointFromScene:(CGPoint)point;
+
+
+/**
+ Returns the affine transformation from this node's coordinate system into another node's coordinate system.
+ 
+ For nodes in the same scene the transformation is composed of the cached sceneToNodeTransform of both nodes,
+ otherwise it is calculated with convertPoint:toNode:.
+ 
+ @param node The node into which coordinate system the transformation leads.
+ @return The transformation from this node into the other node.
+ @see convertPoints:count:toNode:
+ */
+- (CGAffineTransform)transformToNode:(SKNode *)node;
+
+
+/**
+ Converts several points from this node's coordinate system into another node's coordinate system in one call.
+ 
+ Same as calling convertPoint:toNode: for each point, but the transformation is calculated only once with transformToNode:
+ and applied to all points with INSKPointsApplyAffineTransform(), i.e. for converting polylines, particle positions or touch histories.
+ 
+ @param points The points in this node's coordinate system, which are replaced by the converted points.
+ @param count The number of points.
+ @param node The node into which coordinate system the points are converted.
+ @see convertPoints:count:fromNode:
+ */
+- (void)convertPoints:(CGPoint *)points count:(NSUInteger)count toNode:(SKNode *)node;
+
+
+/**
+ Converts several points from another node's coordinate system into this node's coordinate system in one call.
+ 
+ Same as calling convertPoint:fromNode: for each point, see convertPoints:count:toNode:.
+ 
+ @param points The points in the other node's coordinate system, which are replaced by the converted points.
+ @param count The number of points.
+ @param node The node from which coordinate system the points are converted.
+ @see convertPoints:count:toNode:
+ */
+- (void)convertPoints:(CGPoint *)points count:(NSUInteger)count fromNode:(SKNode *)node;
+
+
 #pragma mark - Tree order manipulation
 /// @name Tree order manipulation
 
@@ -101,6 +268,23 @@
 - (void)insertChildOrNil:(SKNode *)node atIndex:(NSInteger)index;
 
 
+/**
+ Compares the rendering order of this node with another node in the same tree.
+ 
+ A node is rendered after its parent and after all previous siblings including their children.
+ The zPosition is not taken into count, only the order in the tree.
+ 
+ The comparison uses the index of each node in its parent's children array which is cached for each node.
+ The cache is invalidated when the children of the parent change and each cached index is checked against the children array before it is used,
+ so children removed by an action are noticed too. Comparing nodes is cheap, only the first comparison of a node allocates a small object holding its cached index.
+ There is no limit for the number of children.
+ 
+ @param node The other node to compare with.
+ @return NSOrderedAscending if this node will be rendered before the other node, NSOrderedDescending if it will be rendered after it and NSOrderedSame if both are the same or are not in the same tree.
+ */
+- (NSComparisonResult)compareTreeOrder:(SKNode *)node;
+
+
 /**
  Replaces the node's parent and converts its position.
  
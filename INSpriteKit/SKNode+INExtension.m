@@ -24,20 +24,179 @@
 #import "SKNode+INExtension.h"
 #import <objc/runtime.h>
 #import "INSKOSBridge.h"
+#import "INSKMathBatch.h"
 
 
 static const char *SKNodeINExtensionTouchPriorityKey = "SKNodeINExtensionTouchPriorityKey";
 static const char *SKNodeINExtensionSupportedMouseButtonKey = "SKNodeINExtensionSupportedMouseButtonKey";
+static const char *SKNodeINExtensionTreeOrderKey = "SKNodeINExtensionTreeOrderKey";
+static const char *SKNodeINExtensionTransformKey = "SKNodeINExtensionTransformKey";
+
+// Whether the methods changing the scene graph have been swizzled to track the changes.
+static BOOL SKNodeINExtensionSceneGraphTracking = NO;
+
+// The counters for changes in any scene graph.
+static NSUInteger SKNodeINExtensionSceneGraphGeneration = 0;
+static NSUInteger SKNodeINExtensionSceneGraphStructureGeneration = 0;
+
+
+static inline void SKNodeINExtensionGeometryDidChange(void) {
+    SKNodeINExtensionSceneGraphGeneration++;
+}
+
+static inline void SKNodeINExtensionStructureDidChange(void) {
+    SKNodeINExtensionSceneGraphGeneration++;
+    SKNodeINExtensionSceneGraphStructureGeneration++;
+}
+
+// The registered tables collecting the changed nodes, held weakly.
+static NSHashTable *SKNodeINExtensionChangeTables = nil;
+
+// Adds the node to all registered change tables.
+static inline void SKNodeINExtensionNodeDidChange(id node) {
+    if (SKNodeINExtensionChangeTables.count == 0) {
+        return;
+    }
+    for (NSHashTable *table in SKNodeINExtensionChangeTables) {
+        [table addObject:node];
+    }
+}
+
+// A generation counter for the children of the nodes, each change gets a new unique value.
+static NSUInteger SKNodeINExtensionChildrenGeneration = 0;
+
+// A generation counter for all cached transformations, increasing it marks all of them as outdated at once.
+static NSUInteger SKNodeINExtensionTransformGeneration = 0;
+
+
+// The cached position of a node in the tree.
+@interface SKNodeINExtensionTreeOrder : NSObject {
+@public
+    // The generation of this node's children, changes when any child is added or removed.
+    NSUInteger childrenGeneration;
+    // The index in the parent's children array.
+    NSUInteger index;
+    // The parent and its children generation for which the index is valid.
+    __unsafe_unretained SKNode *parent;
+    NSUInteger parentChildrenGeneration;
+}
+@end
+
+@implementation SKNodeINExtensionTreeOrder
+@end
+
+
+// The cached transformation from the scene into a node.
+@interface SKNodeINExtensionTransform : NSObject {
+@public
+    // Whether sceneToNode is up to date, cleared when the node or any ancestor is moved, rotated, scaled or gets another parent.
+    BOOL valid;
+    // The transform generation for which sceneToNode has been calculated.
+    NSUInteger generation;
+    // Whether the root of the node's tree is a scene.
+    BOOL inScene;
+    CGAffineTransform sceneToNode;
+}
+@end
+
+@implementation SKNodeINExtensionTransform
+@end
+
+// Returns YES if the transformation has been calculated and isn't outdated.
+static inline BOOL SKNodeINExtensionTransformIsValid(SKNodeINExtensionTransform *transform) {
+    return transform != nil && transform->valid && transform->generation == SKNodeINExtensionTransformGeneration;
+}
+
+
+// Exchanges the implementations of two methods so the original implementation can be called with the swizzled selector.
+static void SKNodeINExtensionSwizzleMethod(Class class, SEL originalSelector, SEL swizzledSelector) {
+    Method originalMethod = class_getInstanceMethod(class, originalSelector);
+    Method swizzledMethod = class_getInstanceMethod(class, swizzledSelector);
+    if (class_addMethod(class, originalSelector, method_getImplementation(swizzledMethod), method_getTypeEncoding(swizzledMethod))) {
+        // The class only inherited the original method, so don't touch the super class' implementation.
+        class_replaceMethod(class, swizzledSelector, method_getImplementation(originalMethod), method_getTypeEncoding(originalMethod));
+    } else {
+        method_exchangeImplementations(originalMethod, swizzledMethod);
+    }
+}
 
 
 @implementation SKNode (INExtension)
 
++ (void)startSceneGraphTracking {
+    // Only swizzle the methods when someone is interested in the changes, so apps not using them don't pay for the tracking.
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        Class nodeClass = [SKNode class];
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(addChild:), @selector(insk_addChild:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(insertChild:atIndex:), @selector(insk_insertChild:atIndex:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(removeFromParent), @selector(insk_removeFromParent));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(removeAllChildren), @selector(insk_removeAllChildren));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(removeChildrenInArray:), @selector(insk_removeChildrenInArray:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setUserInteractionEnabled:), @selector(insk_setUserInteractionEnabled:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setPosition:), @selector(insk_setPosition:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setZRotation:), @selector(insk_setZRotation:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setXScale:), @selector(insk_setXScale:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setYScale:), @selector(insk_setYScale:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setScale:), @selector(insk_setScale:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setZPosition:), @selector(insk_setZPosition:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setHidden:), @selector(insk_setHidden:));
+        SKNodeINExtensionSwizzleMethod(nodeClass, @selector(setAlpha:), @selector(insk_setAlpha:));
+        // moveToParent: is only available since iOS 9 and OS X 10.11.
+        SEL moveToParentSelector = NSSelectorFromString(@"moveToParent:");
+        if ([nodeClass instancesRespondToSelector:moveToParentSelector]) {
+            SKNodeINExtensionSwizzleMethod(nodeClass, moveToParentSelector, @selector(insk_moveToParent:));
+        }
+        Class spriteNodeClass = [SKSpriteNode class];
+        SKNodeINExtensionSwizzleMethod(spriteNodeClass, @selector(setSize:), @selector(insk_setSize:));
+        SKNodeINExtensionSwizzleMethod(spriteNodeClass, @selector(setAnchorPoint:), @selector(insk_setAnchorPoint:));
+        SKNodeINExtensionSwizzleMethod(spriteNodeClass, @selector(setTexture:), @selector(insk_setTexture:));
+        // The frame of a label depends on its text and font.
+        Class labelNodeClass = [SKLabelNode class];
+        SKNodeINExtensionSwizzleMethod(labelNodeClass, @selector(setText:), @selector(insk_setText:));
+        SKNodeINExtensionSwizzleMethod(labelNodeClass, @selector(setFontName:), @selector(insk_setFontName:));
+        SKNodeINExtensionSwizzleMethod(labelNodeClass, @selector(setFontSize:), @selector(insk_setFontSize:));
+        SKNodeINExtensionSwizzleMethod(labelNodeClass, @selector(setHorizontalAlignmentMode:), @selector(insk_setHorizontalAlignmentMode:));
+        SKNodeINExtensionSwizzleMethod(labelNodeClass, @selector(setVerticalAlignmentMode:), @selector(insk_setVerticalAlignmentMode:));
+        SKNodeINExtensionSceneGraphTracking = YES;
+    });
+}
+
++ (NSUInteger)sceneGraphGeneration {
+    [self startSceneGraphTracking];
+    return SKNodeINExtensionSceneGraphGeneration;
+}
+
++ (NSUInteger)sceneGraphStructureGeneration {
+    [self startSceneGraphTracking];
+    return SKNodeINExtensionSceneGraphStructureGeneration;
+}
+
++ (void)sceneGraphDidChange {
+    SKNodeINExtensionStructureDidChange();
+    SKNodeINExtensionNodeDidChange([NSNull null]);
+    SKNodeINExtensionTransformGeneration++;
+}
+
++ (void)addSceneGraphChangeTable:(NSHashTable *)table {
+    [self startSceneGraphTracking];
+    if (SKNodeINExtensionChangeTables == nil) {
+        SKNodeINExtensionChangeTables = [NSHashTable weakObjectsHashTable];
+    }
+    [SKNodeINExtensionChangeTables addObject:table];
+}
+
++ (void)removeSceneGraphChangeTable:(NSHashTable *)table {
+    [SKNodeINExtensionChangeTables removeObject:table];
+}
+
 - (NSInteger)touchPriority {
     return [((NSNumber *)objc_getAssociatedObject(self, SKNodeINExtensionTouchPriorityKey)) integerValue];
 }
 
 - (void)setTouchPriority:(NSInteger)touchPriority {
     objc_setAssociatedObject(self, SKNodeINExtensionTouchPriorityKey, @(touchPriority), OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    SKNodeINExtensionGeometryDidChange();
 }
 
 - (INSKMouseButton)supportedMouseButtons {
@@ -51,6 +210,7 @@ static const char *SKNodeINExtensionSupportedMouseButtonKey = "SKNodeINExtension
 
 - (void)setSupportedMouseButtons:(INSKMouseButton)supportedMouseButtons {
     objc_setAssociatedObject(self, SKNodeINExtensionSupportedMouseButtonKey, @(supportedMouseButtons), OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    SKNodeINExtensionGeometryDidChange();
 }
 
 - (void)bringToFront {
@@ -97,6 +257,91 @@ static const char *SKNodeINExtensionSupportedMouseButtonKey = "SKNodeINExtension
     }
 }
 
+- (NSComparisonResult)compareTreeOrder:(SKNode *)node {
+    if (node == self || node == nil) {
+        return NSOrderedSame;
+    }
+    
+    // Bring both nodes to the same depth.
+    NSUInteger depth = 0;
+    for (SKNode *ancestor = self.parent; ancestor != nil; ancestor = ancestor.parent) {
+        depth++;
+    }
+    NSUInteger otherDepth = 0;
+    for (SKNode *ancestor = node.parent; ancestor != nil; ancestor = ancestor.parent) {
+        otherDepth++;
+    }
+    SKNode *ancestor = self;
+    SKNode *otherAncestor = node;
+    for (; depth > otherDepth; --depth) {
+        ancestor = ancestor.parent;
+    }
+    for (; otherDepth > depth; --otherDepth) {
+        otherAncestor = otherAncestor.parent;
+    }
+    
+    // One node is a child of the other, the parent is rendered first.
+    if (ancestor == otherAncestor) {
+        return (self == ancestor) ? NSOrderedAscending : NSOrderedDescending;
+    }
+    
+    // Walk up until both have the same parent, so the siblings' indexes decide.
+    while (ancestor.parent != otherAncestor.parent) {
+        ancestor = ancestor.parent;
+        otherAncestor = otherAncestor.parent;
+    }
+    if (ancestor.parent == nil) {
+        // Not in the same tree.
+        return NSOrderedSame;
+    }
+    NSUInteger index = [ancestor insk_indexInParent];
+    NSUInteger otherIndex = [otherAncestor insk_indexInParent];
+    return (index < otherIndex) ? NSOrderedAscending : NSOrderedDescending;
+}
+
+- (CGAffineTransform)sceneToNodeTransform {
+    SKNodeINExtensionTransform *transform = [self insk_validTransform];
+    return transform->inScene ? transform->sceneToNode : CGAffineTransformIdentity;
+}
+
++ (void)sceneToNodeTransformsDidChange {
+    SKNodeINExtensionTransformGeneration++;
+}
+
+- (CGPoint)convertPointFromScene:(CGPoint)point {
+    return CGPointApplyAffineTransform(point, [self sceneToNodeTransform]);
+}
+
+- (CGAffineTransform)transformToNode:(SKNode *)node {
+    if (node == self) {
+        return CGAffineTransformIdentity;
+    }
+    SKScene *scene = self.scene;
+    if (scene != nil && node.scene == scene) {
+        // From this node into the scene and from the scene into the other node.
+        CGAffineTransform nodeToScene = CGAffineTransformInvert([self sceneToNodeTransform]);
+        return CGAffineTransformConcat(nodeToScene, [node sceneToNodeTransform]);
+    }
+    
+    // Calculate the transformation by converting the base vectors.
+    CGPoint origin = [self convertPoint:CGPointZero toNode:node];
+    CGPoint unitX = [self convertPoint:CGPointMake(1.0, 0.0) toNode:node];
+    CGPoint unitY = [self convertPoint:CGPointMake(0.0, 1.0) toNode:node];
+    return CGAffineTransformMake(unitX.x - origin.x, unitX.y - origin.y, unitY.x - origin.x, unitY.y - origin.y, origin.x, origin.y);
+}
+
+- (void)convertPoints:(CGPoint *)points count:(NSUInteger)count toNode:(SKNode *)node {
+    if (count == 0) {
+        return;
+    }
+    INSKAffineTransform transform = INSKAffineTransformFromCGAffineTransform([self transformToNode:node]);
+    INSKPointsApplyAffineTransform(points, points, transform, count);
+}
+
+- (void)convertPoints:(CGPoint *)points count:(NSUInteger)count fromNode:(SKNode *)node {
+    [node convertPoints:points count:count toNode:self];
+}
+
 - (void)changeParent:(SKNode *)parent {
     if (self.parent == nil) {
         [parent addChild:self];
@@ -141,4 +386,276 @@ static const char *SKNodeINExtensionSupportedMouseButtonKey = "SKNodeINExtension
 }
 
 
+#pragma mark - tree order
+
+- (SKNodeINExtensionTreeOrder *)insk_treeOrder {
+    SKNodeINExtensionTreeOrder *treeOrder = objc_getAssociatedObject(self, SKNodeINExtensionTreeOrderKey);
+    if (treeOrder == nil) {
+        treeOrder = [[SKNodeINExtensionTreeOrder alloc] init];
+        treeOrder->childrenGeneration = ++SKNodeINExtensionChildrenGeneration;
+        objc_setAssociatedObject(self, SKNodeINExtensionTreeOrderKey, treeOrder, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return treeOrder;
+}
+
+// Returns the cached index of the node in its parent's children array.
+- (NSUInteger)insk_indexInParent {
+    SKNode *parent = self.parent;
+    NSArray *children = parent.children;
+    SKNodeINExtensionTreeOrder *treeOrder = [self insk_treeOrder];
+    SKNodeINExtensionTreeOrder *parentTreeOrder = [parent insk_treeOrder];
+    // Children removed bypassing the tracked methods, i.e. by [SKAction removeFromParent], don't change the generation,
+    // so the cached index is also checked against the children array.
+    if (treeOrder->parent != parent || treeOrder->parentChildrenGeneration != parentTreeOrder->childrenGeneration
+        || treeOrder->index >= children.count || children[treeOrder->index] != self) {
+        // The children have changed, so update the indexes of all siblings at once.
+        NSUInteger index = 0;
+        for (SKNode *child in children) {
+            SKNodeINExtensionTreeOrder *childTreeOrder = [child insk_treeOrder];
+            childTreeOrder->index = index++;
+            childTreeOrder->parent = parent;
+            childTreeOrder->parentChildrenGeneration = parentTreeOrder->childrenGeneration;
+        }
+    }
+    return treeOrder->index;
+}
+
+// Invalidates the cached indexes of the children.
+- (void)insk_childrenDidChange {
+    // Nodes without a tree order haven't any children with a cached index.
+    SKNodeINExtensionTreeOrder *treeOrder = objc_getAssociatedObject(self, SKNodeINExtensionTreeOrderKey);
+    if (treeOrder != nil) {
+        treeOrder->childrenGeneration = ++SKNodeINExtensionChildrenGeneration;
+    }
+    SKNodeINExtensionStructureDidChange();
+}
+
+
+#pragma mark - transform cache
+
+// Returns the cached transformation of the node, which is calculated again with the parent's cached transformation if it is outdated.
+- (SKNodeINExtensionTransform *)insk_validTransform {
+    SKNodeINExtensionTransform *transform = objc_getAssociatedObject(self, SKNodeINExtensionTransformKey);
+    if (SKNodeINExtensionTransformIsValid(transform)) {
+        return transform;
+    }
+    if (transform == nil) {
+        transform = [[SKNodeINExtensionTransform alloc] init];
+        objc_setAssociatedObject(self, SKNodeINExtensionTransformKey, transform, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    
+    SKNode *parent = self.parent;
+    if (parent == nil) {
+        // The scene itself or the root of a tree without a scene.
+        transform->inScene = [self isKindOfClass:[SKScene class]];
+        transform->sceneToNode = CGAffineTransformIdentity;
+    } else {
+        // A node is scaled, rotated and then translated into its parent, so invert this and append it to the parent's transformation.
+        SKNodeINExtensionTransform *parentTransform = [parent insk_validTransform];
+        CGPoint position = self.position;
+        CGAffineTransform nodeToParent = CGAffineTransformMakeScale(self.xScale, self.yScale);
+        nodeToParent = CGAffineTransformConcat(nodeToParent, CGAffineTransformMakeRotation(self.zRotation));
+        nodeToParent = CGAffineTransformConcat(nodeToParent, CGAffineTransformMakeTranslation(position.x, position.y));
+        transform->inScene = parentTransform->inScene;
+        transform->sceneToNode = CGAffineTransformConcat(parentTransform->sceneToNode, CGAffineTransformInvert(nodeToParent));
+    }
+    // Without the tracking nobody would mark the transformation as outdated, so it is calculated on each call.
+    transform->valid = SKNodeINExtensionSceneGraphTracking;
+    transform->generation = SKNodeINExtensionTransformGeneration;
+    return transform;
+}
+
+// Marks the cached transformations of the node and its descendants as outdated.
+- (void)insk_transformDidChange {
+    // A transformation is only calculated with the valid one of the parent,
+    // so there are no valid transformations below a node without one.
+    SKNodeINExtensionTransform *transform = objc_getAssociatedObject(self, SKNodeINExtensionTransformKey);
+    if (!SKNodeINExtensionTransformIsValid(transform)) {
+        return;
+    }
+    transform->valid = NO;
+    for (SKNode *child in self.children) {
+        [child insk_transformDidChange];
+    }
+}
+
+
+#pragma mark - scene graph tracking
+
+// These methods are swizzled with the Sprite Kit methods, so calling them calls the original implementation.
+
+- (void)insk_addChild:(SKNode *)node {
+    [self insk_addChild:node];
+    [self insk_childrenDidChange];
+    [node insk_transformDidChange];
+    SKNodeINExtensionNodeDidChange(node);
+}
+
+- (void)insk_insertChild:(SKNode *)node atIndex:(NSInteger)index {
+    [self insk_insertChild:node atIndex:index];
+    [self insk_childrenDidChange];
+    [node insk_transformDidChange];
+    SKNodeINExtensionNodeDidChange(node);
+}
+
+- (void)insk_removeFromParent {
+    SKNode *parent = self.parent;
+    [self insk_removeFromParent];
+    [parent insk_childrenDidChange];
+    [self insk_transformDidChange];
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_moveToParent:(SKNode *)parent {
+    SKNode *oldParent = self.parent;
+    [self insk_moveToParent:parent];
+    [oldParent insk_childrenDidChange];
+    [parent insk_childrenDidChange];
+    [self insk_transformDidChange];
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_removeAllChildren {
+    // Only copy the children when someone collects them.
+    NSArray *children = (SKNodeINExtensionChangeTables.count > 0) ? [self.children copy] : nil;
+    for (SKNode *child in self.children) {
+        [child insk_transformDidChange];
+    }
+    [self insk_removeAllChildren];
+    [self insk_childrenDidChange];
+    for (SKNode *child in children) {
+        SKNodeINExtensionNodeDidChange(child);
+    }
+}
+
+- (void)insk_removeChildrenInArray:(NSArray *)nodes {
+    [self insk_removeChildrenInArray:nodes];
+    [self insk_childrenDidChange];
+    for (SKNode *node in nodes) {
+        [node insk_transformDidChange];
+        SKNodeINExtensionNodeDidChange(node);
+    }
+}
+
+- (void)insk_setUserInteractionEnabled:(BOOL)userInteractionEnabled {
+    [self insk_setUserInteractionEnabled:userInteractionEnabled];
+    SKNodeINExtensionStructureDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setPosition:(CGPoint)position {
+    [self insk_setPosition:position];
+    [self insk_transformDidChange];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setZRotation:(CGFloat)zRotation {
+    [self insk_setZRotation:zRotation];
+    [self insk_transformDidChange];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setXScale:(CGFloat)xScale {
+    [self insk_setXScale:xScale];
+    [self insk_transformDidChange];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setYScale:(CGFloat)yScale {
+    [self insk_setYScale:yScale];
+    [self insk_transformDidChange];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setScale:(CGFloat)scale {
+    [self insk_setScale:scale];
+    [self insk_transformDidChange];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setZPosition:(CGFloat)zPosition {
+    [self insk_setZPosition:zPosition];
+    SKNodeINExtensionGeometryDidChange();
+}
+
+- (void)insk_setHidden:(BOOL)hidden {
+    [self insk_setHidden:hidden];
+    SKNodeINExtensionGeometryDidChange();
+}
+
+- (void)insk_setAlpha:(CGFloat)alpha {
+    [self insk_setAlpha:alpha];
+    SKNodeINExtensionGeometryDidChange();
+}
+
+
+@end
+
+
+@implementation SKSpriteNode (INExtensionSceneGraphTracking)
+
+// These methods are swizzled with the Sprite Kit methods, so calling them calls the original implementation.
+
+- (void)insk_setSize:(CGSize)size {
+    [self insk_setSize:size];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setAnchorPoint:(CGPoint)anchorPoint {
+    [self insk_setAnchorPoint:anchorPoint];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setTexture:(SKTexture *)texture {
+    [self insk_setTexture:texture];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+
+@end
+
+
+@implementation SKLabelNode (INExtensionSceneGraphTracking)
+
+// These methods are swizzled with the Sprite Kit methods, so calling them calls the original implementation.
+
+- (void)insk_setText:(NSString *)text {
+    [self insk_setText:text];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setFontName:(NSString *)fontName {
+    [self insk_setFontName:fontName];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setFontSize:(CGFloat)fontSize {
+    [self insk_setFontSize:fontSize];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setHorizontalAlignmentMode:(SKLabelHorizontalAlignmentMode)horizontalAlignmentMode {
+    [self insk_setHorizontalAlignmentMode:horizontalAlignmentMode];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+- (void)insk_setVerticalAlignmentMode:(SKLabelVerticalAlignmentMode)verticalAlignmentMode {
+    [self insk_setVerticalAlignmentMode:verticalAlignmentMode];
+    SKNodeINExtensionGeometryDidChange();
+    SKNodeINExtensionNodeDidChange(self);
+}
+
+
 @end
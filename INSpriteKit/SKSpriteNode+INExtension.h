@@ -22,10 +22,21 @@
 
 
 #import <SpriteKit/SpriteKit.h>
+#import "INSKAlphaMask.h"
 
 @interface SKSpriteNode (INExtension)
 
 
+/**
+ An optional alpha mask of the sprite's image for pixel accurate hit tests, nil by default.
+
+ When set, isPointInside: only returns YES for points on opaque parts of the image, so transparent corners of irregular or rotated sprites don't steal touches from nodes below.
+ The mask is stretched over the sprite's whole size, so it should be made of the same image as the sprite's texture.
+ Use INSKAlphaMask's alphaMaskWithImageNamed: to share one mask with all sprites of an image.
+ */
+@property (nonatomic, strong) INSKAlphaMask *alphaMask;
+
+
 /**
  Returns the sprite node's unscaled size by dividing the node's size with the scale factor.
  
@@ -54,9 +65,10 @@
  
  Normally a sprite node shows an image. With this method you can determine easily if a touch point is inside of this image or not.
  The anchor point and scale is taken into count.
+ If an alphaMask is set, the point has to be on an opaque texel of the mask, too.
  
  @param point The position point to check, has to be in the coordinate system of this sprite node.
- @return YES if the point is inside of the node's image or size if no image is assigned. Otherwise returns NO.
+ @return YES if the point is inside of the node's image or size if no image is assigned and not on a transparent texel of the alphaMask. Otherwise returns NO.
  */
 - (BOOL)isPointInside:(CGPoint)point;
 
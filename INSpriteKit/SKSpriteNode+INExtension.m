@@ -23,10 +23,23 @@
 
 #import "SKSpriteNode+INExtension.h"
 #import "INSKMath.h"
+#import "INSKGeometry.h"
+#import <objc/runtime.h>
+
+
+static const char *SKSpriteNodeINExtensionAlphaMaskKey = "SKSpriteNodeINExtensionAlphaMaskKey";
 
 
 @implementation SKSpriteNode (INExtension)
 
+- (INSKAlphaMask *)alphaMask {
+    return objc_getAssociatedObject(self, SKSpriteNodeINExtensionAlphaMaskKey);
+}
+
+- (void)setAlphaMask:(INSKAlphaMask *)alphaMask {
+    objc_setAssociatedObject(self, SKSpriteNodeINExtensionAlphaMaskKey, alphaMask, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+}
+
 - (CGSize)sizeUnscaled {
     return CGSizeMake(self.size.width / self.xScale, self.size.height / self.yScale);
 }
@@ -40,17 +53,16 @@
 
 - (BOOL)isPointInside:(CGPoint)point {
     CGSize size = self.sizeUnscaled;
-    if (point.x < -size.width * self.anchorPoint.x) {
+    CGPoint anchorOffset = CGPointMake(size.width * self.anchorPoint.x, size.height * self.anchorPoint.y);
+    INSKAxisAlignedBox bounds = INSKAxisAlignedBoxMake(-anchorOffset.x, -anchorOffset.y, size.width - anchorOffset.x, size.height - anchorOffset.y);
+    if (!INSKAxisAlignedBoxContainsPoint(bounds, point)) {
         return NO;
     }
-    if (point.x > size.width - size.width * self.anchorPoint.x) {
-        return NO;
-    }
-    if (point.y < -size.height * self.anchorPoint.y) {
-        return NO;
-    }
-    if (point.y > size.height - size.height * self.anchorPoint.y) {
-        return NO;
+    INSKAlphaMask *alphaMask = self.alphaMask;
+    if (alphaMask != nil && size.width > 0 && size.height > 0) {
+        double u = point.x / size.width + self.anchorPoint.x;
+        double v = point.y / size.height + self.anchorPoint.y;
+        return INSKAlphaBitmaskTestNormalized(alphaMask.bitmask, u, v);
     }
     return YES;
 }
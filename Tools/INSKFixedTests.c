@@ -0,0 +1,280 @@
+// Tests the fixed-point functions of INSKFixed.h and checks that a simulation using all of them results in the same checksum on every platform.
+//
+// Build and run it with a C99 compiler, the checksum has to be the same with any compiler, optimization level and CPU:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKFixedTests.c INSpriteKit/INSKFixed.c -lm -o insk-fixed-tests && ./insk-fixed-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <math.h>
+#include "INSKFixed.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The documented maximum error of the CORDIC functions.
+#define INSKTestCORDICMaxError (2.0 / 65536.0)
+
+// The checksum of INSKTestSimulationChecksum(), which has to be the same on all platforms.
+#define INSKTestSimulationExpectedChecksum 0x40CC6F1233CD6F11ull
+
+// Converts a fixed-point number into a double, which is exact even with a float CGFloat.
+#define INSKTestToDouble(value) ((double)(value) / 65536.0)
+
+
+// conversions
+
+static void test_conversions_roundToNearest(void) {
+    INSK_TEST_ASSERT(INSKFixedFromInt(3) == 3 * 65536, "FromInt(3) is %d", INSKFixedFromInt(3));
+    INSK_TEST_ASSERT(INSKFixedFromInt(-2) == -2 * 65536, "FromInt(-2) is %d", INSKFixedFromInt(-2));
+    INSK_TEST_ASSERT(INSKFixedToInt(INSKFixedFromCGFloat(-1.5)) == -2, "ToInt(-1.5) doesn't round down");
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(1.0) == INSKFixedOne, "FromCGFloat(1.0) is %d", INSKFixedFromCGFloat(1.0));
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(0.25) == 16384, "FromCGFloat(0.25) is %d", INSKFixedFromCGFloat(0.25));
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(-0.25) == -16384, "FromCGFloat(-0.25) is %d", INSKFixedFromCGFloat(-0.25));
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(1.0 / 65536.0 * 0.6) == 1, "FromCGFloat() doesn't round to nearest");
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(M_PI) == INSKFixedPi, "FromCGFloat(M_PI) is %d", INSKFixedFromCGFloat(M_PI));
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(M_PI_2) == INSKFixedPiHalf, "FromCGFloat(M_PI_2) is %d", INSKFixedFromCGFloat(M_PI_2));
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(M_PI * 2.0) == INSKFixedPiX2, "FromCGFloat(M_PI*2) is %d", INSKFixedFromCGFloat(M_PI * 2.0));
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(1e10) == INT32_MAX, "FromCGFloat() doesn't clamp big values");
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(-1e10) == INT32_MIN, "FromCGFloat() doesn't clamp small values");
+    INSK_TEST_ASSERT(INSKFixedFromCGFloat(NAN) == 0, "FromCGFloat(NAN) isn't 0");
+    INSK_TEST_ASSERT(INSKFixedToCGFloat(98304) == 1.5, "ToCGFloat(98304) is %f", (double)INSKFixedToCGFloat(98304));
+
+    CGPoint point = CGPointFromINSKFixedPoint(INSKFixedPointFromCGPoint(CGPointMake(12.5, -7.25)));
+    INSK_TEST_ASSERT(point.x == 12.5 && point.y == -7.25, "point conversion is (%f, %f)", (double)point.x, (double)point.y);
+}
+
+
+// scalar calculations
+
+static void test_scalarCalculations_matchDouble(void) {
+    INSK_TEST_ASSERT(INSKFixedAdd(INSKFixedOne, INSKFixedOne) == 2 * INSKFixedOne, "Add() failed");
+    INSK_TEST_ASSERT(INSKFixedSubtract(INSKFixedOne, 2 * INSKFixedOne) == -INSKFixedOne, "Subtract() failed");
+    INSK_TEST_ASSERT(INSKFixedAdd(INT32_MAX, 1) == INT32_MIN, "Add() doesn't wrap around");
+    INSK_TEST_ASSERT(INSKFixedDivide(INSKFixedOne, 0) == INT32_MAX, "Divide() by 0 isn't the biggest value");
+    INSK_TEST_ASSERT(INSKFixedDivide(-INSKFixedOne, 0) == INT32_MIN, "Divide() by 0 isn't the smallest value");
+    INSK_TEST_ASSERT(INSKFixedAbs(-5) == 5, "Abs() failed");
+    INSK_TEST_ASSERT(INSKFixedClamp(5 * INSKFixedOne, 0, INSKFixedOne) == INSKFixedOne, "Clamp() failed");
+    INSK_TEST_ASSERT(INSKFixedSign(-3) == -INSKFixedOne && INSKFixedSign(0) == 0 && INSKFixedSign(7) == INSKFixedOne, "Sign() failed");
+    INSK_TEST_ASSERT(INSKFixedSqrt(4 * INSKFixedOne) == 2 * INSKFixedOne, "Sqrt(4) is %d", INSKFixedSqrt(4 * INSKFixedOne));
+    INSK_TEST_ASSERT(INSKFixedSqrt(-INSKFixedOne) == 0, "Sqrt() of a negative value isn't 0");
+
+    // Products and quotients are rounded or truncated, square roots rounded down, so all are within one step of the exact value.
+    for (int32_t a = -2000000; a <= 2000000; a += 9973) {
+        for (int32_t b = -2000000; b <= 2000000; b += 10007) {
+            double product = (double)a * (double)b / 65536.0 / 65536.0;
+            if (fabs(product) < 32767.0) {
+                double error = fabs(INSKTestToDouble(INSKFixedMultiply(a, b)) - product);
+                INSK_TEST_ASSERT(error <= 0.5 / 65536.0, "Multiply(%d, %d) is off by %g", a, b, error);
+            }
+            double quotient = (double)a / (double)b;
+            if (b != 0 && fabs(quotient) < 32767.0) {
+                double error = fabs(INSKTestToDouble(INSKFixedDivide(a, b)) - quotient);
+                INSK_TEST_ASSERT(error < 1.0 / 65536.0, "Divide(%d, %d) is off by %g", a, b, error);
+            }
+        }
+        if (a >= 0) {
+            double root = sqrt((double)a / 65536.0);
+            double error = root - INSKTestToDouble(INSKFixedSqrt(a));
+            INSK_TEST_ASSERT(error >= 0.0 && error < 1.0 / 65536.0, "Sqrt(%d) is off by %g", a, error);
+        }
+    }
+}
+
+
+// point calculations
+
+static void test_pointCalculations_matchDouble(void) {
+    INSKFixedPoint point1 = INSKFixedPointFromCGPoint(CGPointMake(3.0, 4.0));
+    INSKFixedPoint point2 = INSKFixedPointFromCGPoint(CGPointMake(-1.0, 2.0));
+    INSKFixedPoint sum = INSKFixedPointAdd(point1, point2);
+    INSK_TEST_ASSERT(sum.x == 2 * INSKFixedOne && sum.y == 6 * INSKFixedOne, "PointAdd() failed");
+    INSKFixedPoint difference = INSKFixedPointSubtract(point1, point2);
+    INSK_TEST_ASSERT(difference.x == 4 * INSKFixedOne && difference.y == 2 * INSKFixedOne, "PointSubtract() failed");
+    INSKFixedPoint scaled = INSKFixedPointMultiplyScalar(point1, INSKFixedOne / 2);
+    INSK_TEST_ASSERT(scaled.x == 3 * INSKFixedOne / 2 && scaled.y == 2 * INSKFixedOne, "PointMultiplyScalar() failed");
+    INSKFixedPoint negated = INSKFixedPointNegate(point2);
+    INSK_TEST_ASSERT(negated.x == INSKFixedOne && negated.y == -2 * INSKFixedOne, "PointNegate() failed");
+    INSK_TEST_ASSERT(INSKFixedPointDotProduct(point1, point2) == 5 * INSKFixedOne, "PointDotProduct() failed");
+    INSK_TEST_ASSERT(INSKFixedPointCrossProduct(point1, point2) == 10 * INSKFixedOne, "PointCrossProduct() failed");
+    INSK_TEST_ASSERT(INSKFixedPointLength(point1) == 5 * INSKFixedOne, "PointLength() is %d", INSKFixedPointLength(point1));
+    INSK_TEST_ASSERT(INSKFixedPointLengthSq(point1) == 25 * INSKFixedOne, "PointLengthSq() failed");
+    INSK_TEST_ASSERT(INSKFixedPointDistance(point1, point2) == INSKFixedSqrt(20 * INSKFixedOne), "PointDistance() failed");
+    INSK_TEST_ASSERT(INSKFixedPointDistanceSq(point1, point2) == 20 * INSKFixedOne, "PointDistanceSq() failed");
+    INSKFixedPoint normalized = INSKFixedPointNormalize(point1);
+    INSK_TEST_ASSERT(normalized.x == INSKFixedFromCGFloat(0.6) - 1 || normalized.x == INSKFixedFromCGFloat(0.6), "PointNormalize() x is %d", normalized.x);
+    INSK_TEST_ASSERT(normalized.y == INSKFixedFromCGFloat(0.8) - 1 || normalized.y == INSKFixedFromCGFloat(0.8), "PointNormalize() y is %d", normalized.y);
+    INSKFixedPoint zero = INSKFixedPointNormalize(INSKFixedPointMake(0, 0));
+    INSK_TEST_ASSERT(zero.x == 0 && zero.y == 0, "PointNormalize() of the zero vector isn't zero");
+    INSKFixedPoint lerped = INSKFixedPointLerp(point1, point2, INSKFixedOne / 4);
+    INSK_TEST_ASSERT(lerped.x == 2 * INSKFixedOne && lerped.y == 7 * INSKFixedOne / 2, "PointLerp() failed");
+
+    // Long vectors don't overflow in Length().
+    INSKFixedPoint longVector = INSKFixedPointMake(INSKFixedFromInt(20000), INSKFixedFromInt(-20000));
+    double length = INSKTestToDouble(INSKFixedPointLength(longVector));
+    INSK_TEST_ASSERT(fabs(length - 20000.0 * sqrt(2.0)) < 1.0 / 65536.0, "PointLength() of a long vector is %f", length);
+}
+
+
+// angular calculations
+
+static void test_angleWrapping_staysInRange(void) {
+    INSK_TEST_ASSERT(INSKFixedAngleIn2Pi(-INSKFixedPiHalf) == INSKFixedPiX2 - INSKFixedPiHalf, "AngleIn2Pi() failed");
+    INSK_TEST_ASSERT(INSKFixedAngleIn2Pi(INSKFixedPiX2) == 0, "AngleIn2Pi(2*pi) isn't 0");
+    INSK_TEST_ASSERT(INSKFixedAngleInPi(INSKFixedPi) == INSKFixedPi - INSKFixedPiX2, "AngleInPi(pi) isn't -pi");
+    INSKFixed angle1 = INSKFixedFromCGFloat(0.1);
+    INSKFixed angle2 = INSKFixedFromCGFloat(6.2);
+    INSK_TEST_ASSERT(INSKFixedShortestAngleBetween(angle1, angle2) == angle2 - angle1 - INSKFixedPiX2, "ShortestAngleBetween() doesn't take the short way");
+    INSK_TEST_ASSERT(INSKFixedShortestAngleBetween(angle2, angle1) == angle1 - angle2 + INSKFixedPiX2, "ShortestAngleBetween() doesn't take the short way back");
+    for (int64_t angle = INT32_MIN; angle <= INT32_MAX; angle += 999983) {
+        INSKFixed in2Pi = INSKFixedAngleIn2Pi((INSKFixed)angle);
+        INSKFixed inPi = INSKFixedAngleInPi((INSKFixed)angle);
+        INSK_TEST_ASSERT(in2Pi >= 0 && in2Pi < INSKFixedPiX2, "AngleIn2Pi(%d) is %d", (INSKFixed)angle, in2Pi);
+        INSK_TEST_ASSERT(inPi >= -INSKFixedPi && inPi < INSKFixedPi, "AngleInPi(%d) is %d", (INSKFixed)angle, inPi);
+        INSK_TEST_ASSERT((in2Pi - inPi) % INSKFixedPiX2 == 0, "AngleIn2Pi() and AngleInPi() of %d differ", (INSKFixed)angle);
+    }
+}
+
+static void test_sinCos_staysInMaxError(void) {
+    double maxError = 0.0;
+    // All angles near the circle and a sparse sweep over the whole range, the reduction mustn't lose precision for big angles.
+    for (int64_t angle = -4 * INSKFixedPiX2; angle <= INT32_MAX; angle += (angle < 4 * INSKFixedPiX2) ? 1 : 9973) {
+        INSKFixed sine;
+        INSKFixed cosine;
+        INSKFixedSinCos((INSKFixed)angle, &sine, &cosine);
+        double radians = (double)angle / 65536.0;
+        double error = fmax(fabs(INSKTestToDouble(sine) - sin(radians)), fabs(INSKTestToDouble(cosine) - cos(radians)));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    for (int64_t angle = INT32_MIN; angle < -4 * INSKFixedPiX2; angle += 9973) {
+        INSKFixed sine;
+        INSKFixed cosine;
+        INSKFixedSinCos((INSKFixed)angle, &sine, &cosine);
+        double radians = (double)angle / 65536.0;
+        double error = fmax(fabs(INSKTestToDouble(sine) - sin(radians)), fabs(INSKTestToDouble(cosine) - cos(radians)));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    INSK_TEST_ASSERT(maxError <= INSKTestCORDICMaxError, "SinCos() max error is %g", maxError);
+
+    INSKFixedPoint right = INSKFixedPointForAngle(0);
+    INSK_TEST_ASSERT(right.x == INSKFixedOne && right.y == 0, "PointForAngle(0) is (%d, %d)", right.x, right.y);
+}
+
+static void test_pointToAngle_staysInMaxError(void) {
+    double maxError = 0.0;
+    // Vectors of all lengths around the circle.
+    for (int32_t step = 0; step < 100000; ++step) {
+        double radians = -M_PI + 2.0 * M_PI * step / 100000.0;
+        double length = (step % 3 == 0) ? 0.01 : ((step % 3 == 1) ? 1.0 : 20000.0);
+        INSKFixedPoint point = INSKFixedPointFromCGPoint(CGPointMake(cos(radians) * length, sin(radians) * length));
+        double angle = INSKTestToDouble(INSKFixedPointToAngle(point));
+        double error = fabs(angle - atan2((double)point.y, (double)point.x));
+        if (error > maxError) {
+            maxError = error;
+        }
+    }
+    INSK_TEST_ASSERT(maxError <= INSKTestCORDICMaxError, "PointToAngle() max error is %g", maxError);
+    INSK_TEST_ASSERT(INSKFixedPointToAngle(INSKFixedPointMake(0, 0)) == 0, "PointToAngle() of the zero vector isn't 0");
+    INSK_TEST_ASSERT(INSKFixedPointToAngle(INSKFixedPointMake(-INSKFixedOne, 0)) == INSKFixedPi, "PointToAngle() to the left isn't pi");
+    INSK_TEST_ASSERT(INSKFixedPointToAngle(INSKFixedPointMake(0, -1)) == -INSKFixedPiHalf, "PointToAngle() down isn't -pi/2");
+    INSK_TEST_ASSERT(INSKFixedPointToAngle(INSKFixedPointMake(INT32_MIN, INT32_MIN)) == INSKFixedFromCGFloat(-0.75 * M_PI), "PointToAngle() of the smallest vector failed");
+}
+
+
+// determinism
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKTestRandom(uint32_t *state) {
+    uint32_t value = *state;
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    *state = value;
+    return value;
+}
+
+// Adds a value to a FNV-1a checksum byte by byte, so the byte order of the platform doesn't matter.
+static uint64_t INSKTestChecksumAdd(uint64_t checksum, INSKFixed value) {
+    uint32_t bits = (uint32_t)value;
+    for (int byte = 0; byte < 4; ++byte) {
+        checksum ^= (bits >> (byte * 8)) & 0xFF;
+        checksum *= 0x100000001B3ull;
+    }
+    return checksum;
+}
+
+// Steers a swarm of agents with all fixed-point functions and returns the checksum of all states.
+static uint64_t INSKTestSimulationChecksum(void) {
+    enum { agentCount = 64, stepCount = 2000 };
+    INSKFixedPoint positions[agentCount];
+    INSKFixed headings[agentCount];
+    uint32_t state = 1;
+    for (int agent = 0; agent < agentCount; ++agent) {
+        positions[agent] = INSKFixedPointMake((INSKFixed)(INSKTestRandom(&state) % (1000u * 65536u)) - 500 * INSKFixedOne,
+                                              (INSKFixed)(INSKTestRandom(&state) % (1000u * 65536u)) - 500 * INSKFixedOne);
+        headings[agent] = (INSKFixed)(INSKTestRandom(&state) % (uint32_t)INSKFixedPiX2);
+    }
+
+    uint64_t checksum = 0xCBF29CE484222325ull;
+    INSKFixed timeStep = INSKFixedDivide(INSKFixedOne, INSKFixedFromInt(60));
+    INSKFixed maxTurn = INSKFixedMultiply(INSKFixedPi, timeStep);
+    for (int step = 0; step < stepCount; ++step) {
+        // A target moving on a circle.
+        INSKFixedPoint target = INSKFixedPointMultiplyScalar(INSKFixedPointForAngle(INSKFixedMultiply(INSKFixedFromInt(step), timeStep)), INSKFixedFromInt(200));
+        for (int agent = 0; agent < agentCount; ++agent) {
+            INSKFixedPoint toTarget = INSKFixedPointSubtract(target, positions[agent]);
+            INSKFixed turn = INSKFixedShortestAngleBetween(headings[agent], INSKFixedPointToAngle(toTarget));
+            headings[agent] = INSKFixedAngleInPi(INSKFixedAdd(headings[agent], INSKFixedClamp(turn, -maxTurn, maxTurn)));
+            INSKFixed distance = INSKFixedPointDistance(positions[agent], target);
+            INSKFixed speed = INSKFixedClamp(INSKFixedSqrt(distance) * 8, INSKFixedFromInt(10), INSKFixedFromInt(150));
+            INSKFixedPoint velocity = INSKFixedPointMultiplyScalar(INSKFixedPointForAngle(headings[agent]), INSKFixedMultiply(speed, timeStep));
+            INSKFixedPoint direction = INSKFixedPointNormalize(toTarget);
+            if (INSKFixedPointDotProduct(direction, velocity) < 0) {
+                velocity = INSKFixedPointLerp(velocity, INSKFixedPointMultiplyScalar(direction, INSKFixedAbs(INSKFixedPointCrossProduct(direction, velocity))), INSKFixedOne / 8);
+            }
+            positions[agent] = INSKFixedPointAdd(positions[agent], velocity);
+            checksum = INSKTestChecksumAdd(checksum, positions[agent].x);
+            checksum = INSKTestChecksumAdd(checksum, positions[agent].y);
+            checksum = INSKTestChecksumAdd(checksum, headings[agent]);
+        }
+    }
+    return checksum;
+}
+
+static void test_simulation_matchesChecksum(void) {
+    uint64_t checksum = INSKTestSimulationChecksum();
+    INSK_TEST_ASSERT(checksum == INSKTestSimulationExpectedChecksum, "simulation checksum is 0x%016llX instead of 0x%016llX",
+                     (unsigned long long)checksum, (unsigned long long)INSKTestSimulationExpectedChecksum);
+}
+
+
+int main(void) {
+    test_conversions_roundToNearest();
+    test_scalarCalculations_matchDouble();
+    test_pointCalculations_matchDouble();
+    test_angleWrapping_staysInRange();
+    test_sinCos_staysInMaxError();
+    test_pointToAngle_staysInMaxError();
+    test_simulation_matchesChecksum();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
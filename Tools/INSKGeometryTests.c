@@ -0,0 +1,350 @@
+// Tests the containment and overlap functions of INSKGeometry.h and checks that the batch functions match the single shape functions.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKGeometryTests.c INSpriteKit/INSKGeometry.c -lm -o insk-geometry-tests && ./insk-geometry-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "INSKGeometry.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The number of random points and shapes of the batch tests.
+#define INSKTestSampleCount 4096
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKTestRandomState = 1;
+
+static CGFloat INSKTestRandom(CGFloat min, CGFloat max) {
+    INSKTestRandomState ^= INSKTestRandomState << 13;
+    INSKTestRandomState ^= INSKTestRandomState >> 17;
+    INSKTestRandomState ^= INSKTestRandomState << 5;
+    return min + (max - min) * (CGFloat)(INSKTestRandomState / 4294967296.0);
+}
+
+static CGPoint INSKTestRandomPoint(void) {
+    return CGPointMake(INSKTestRandom(-100.0, 100.0), INSKTestRandom(-100.0, 100.0));
+}
+
+// A convex pentagon in counterclockwise order.
+static const CGPoint INSKTestPentagon[] = {{0, -10}, {10, -3}, {6, 8}, {-6, 8}, {-10, -3}};
+
+// A concave U shape in clockwise order, the gap is between x -2 and 2 above y 0.
+static const CGPoint INSKTestUShape[] = {{-5, 5}, {-2, 5}, {-2, 0}, {2, 0}, {2, 5}, {5, 5}, {5, -5}, {-5, -5}};
+
+
+// shapes
+
+static void test_shapes_areCreatedCorrectly(void) {
+    INSKAxisAlignedBox box = INSKAxisAlignedBoxFromCGRect(CGRectMake(10, 20, -4, 5));
+    INSK_TEST_ASSERT(box.min.x == 6 && box.min.y == 20 && box.max.x == 10 && box.max.y == 25, "negative rect converted to (%f, %f, %f, %f)",
+                     (double)box.min.x, (double)box.min.y, (double)box.max.x, (double)box.max.y);
+
+    CGPoint points[] = {{3, -1}, {-2, 4}, {5, 2}};
+    box = INSKAxisAlignedBoxFromPoints(points, 3);
+    INSK_TEST_ASSERT(box.min.x == -2 && box.min.y == -1 && box.max.x == 5 && box.max.y == 4, "bounding box of points is wrong");
+    box = INSKAxisAlignedBoxFromPoints(NULL, 0);
+    INSK_TEST_ASSERT(box.min.x == 0 && box.min.y == 0 && box.max.x == 0 && box.max.y == 0, "bounding box of no points isn't zero");
+
+    INSKOrientedBox orientedBox = INSKOrientedBoxMake(CGPointMake(1, 2), CGSizeMake(4, 2), M_PI_2);
+    box = INSKOrientedBoxGetBoundingBox(orientedBox);
+    INSK_TEST_ASSERT(fabs(box.min.x - 0.0) < 1e-5 && fabs(box.max.x - 2.0) < 1e-5 && fabs(box.min.y - 0.0) < 1e-5 && fabs(box.max.y - 4.0) < 1e-5,
+                     "bounding box of rotated box is (%f, %f, %f, %f)", (double)box.min.x, (double)box.min.y, (double)box.max.x, (double)box.max.y);
+
+    box = INSKCircleGetBoundingBox(INSKCircleMake(CGPointMake(1, -1), 2));
+    INSK_TEST_ASSERT(box.min.x == -1 && box.min.y == -3 && box.max.x == 3 && box.max.y == 1, "bounding box of circle is wrong");
+}
+
+
+// containment
+
+static void test_containment_includesBoundary(void) {
+    INSKAxisAlignedBox box = INSKAxisAlignedBoxMake(-1, -2, 3, 4);
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxContainsPoint(box, CGPointMake(0, 0)), "box doesn't contain its center");
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxContainsPoint(box, CGPointMake(3, 4)), "box doesn't contain its corner");
+    INSK_TEST_ASSERT(!INSKAxisAlignedBoxContainsPoint(box, CGPointMake(3.01, 0)), "box contains an outside point");
+
+    INSKOrientedBox orientedBox = INSKOrientedBoxMake(CGPointMake(0, 0), CGSizeMake(4, 2), M_PI_4);
+    INSK_TEST_ASSERT(INSKOrientedBoxContainsPoint(orientedBox, CGPointMake(1.4, 1.4)), "rotated box doesn't contain a point along its axis");
+    INSK_TEST_ASSERT(!INSKOrientedBoxContainsPoint(orientedBox, CGPointMake(1.9, 0)), "rotated box contains a point of its unrotated area");
+    INSK_TEST_ASSERT(!INSKOrientedBoxContainsPoint(orientedBox, CGPointMake(-1.0, 1.0)), "rotated box contains a point beyond its height");
+
+    INSKCircle circle = INSKCircleMake(CGPointMake(1, 1), 2);
+    INSK_TEST_ASSERT(INSKCircleContainsPoint(circle, CGPointMake(3, 1)), "circle doesn't contain its boundary");
+    INSK_TEST_ASSERT(!INSKCircleContainsPoint(circle, CGPointMake(2.5, 2.5)), "circle contains an outside point");
+
+    INSKPolygon pentagon = INSKPolygonMake(INSKTestPentagon, 5);
+    INSK_TEST_ASSERT(INSKConvexPolygonContainsPoint(pentagon, CGPointMake(0, 0)), "pentagon doesn't contain its center");
+    INSK_TEST_ASSERT(INSKConvexPolygonContainsPoint(pentagon, CGPointMake(0, 8)), "pentagon doesn't contain its edge");
+    INSK_TEST_ASSERT(!INSKConvexPolygonContainsPoint(pentagon, CGPointMake(9, 7)), "pentagon contains an outside point");
+    INSK_TEST_ASSERT(!INSKConvexPolygonContainsPoint(INSKPolygonMake(NULL, 0), CGPointMake(0, 0)), "empty polygon contains a point");
+
+    CGPoint clockwise[5];
+    for (int index = 0; index < 5; ++index) {
+        clockwise[index] = INSKTestPentagon[4 - index];
+    }
+    INSK_TEST_ASSERT(INSKConvexPolygonContainsPoint(INSKPolygonMake(clockwise, 5), CGPointMake(1, 1)), "clockwise pentagon doesn't contain a point");
+
+    INSKPolygon uShape = INSKPolygonMake(INSKTestUShape, 8);
+    INSK_TEST_ASSERT(INSKPolygonContainsPoint(uShape, CGPointMake(-3.5, 3)), "U shape doesn't contain its left arm");
+    INSK_TEST_ASSERT(INSKPolygonContainsPoint(uShape, CGPointMake(0, -3)), "U shape doesn't contain its bottom");
+    INSK_TEST_ASSERT(!INSKPolygonContainsPoint(uShape, CGPointMake(0, 3)), "U shape contains its gap");
+    INSK_TEST_ASSERT(!INSKPolygonContainsPoint(uShape, CGPointMake(-7, 0)), "U shape contains an outside point");
+    INSK_TEST_ASSERT(!INSKPolygonContainsPoint(uShape, CGPointMake(-7, 5)), "U shape contains a point in line with its top edges");
+    INSK_TEST_ASSERT(!INSKPolygonContainsPoint(INSKPolygonMake(NULL, 0), CGPointMake(0, 0)), "empty polygon contains a point");
+}
+
+static void test_polygonContainment_matchesConvexContainment(void) {
+    INSKPolygon pentagon = INSKPolygonMake(INSKTestPentagon, 5);
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        CGPoint point = CGPointMake(INSKTestRandom(-12.0, 12.0), INSKTestRandom(-12.0, 12.0));
+        INSK_TEST_ASSERT(INSKPolygonContainsPoint(pentagon, point) == INSKConvexPolygonContainsPoint(pentagon, point),
+                         "polygon tests differ at (%f, %f)", (double)point.x, (double)point.y);
+    }
+}
+
+
+// overlap
+
+static void test_overlap_includesTouchingShapes(void) {
+    INSKAxisAlignedBox box = INSKAxisAlignedBoxMake(0, 0, 2, 2);
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxOverlapsBox(box, INSKAxisAlignedBoxMake(2, 2, 3, 3)), "touching boxes don't overlap");
+    INSK_TEST_ASSERT(!INSKAxisAlignedBoxOverlapsBox(box, INSKAxisAlignedBoxMake(2.5, 0, 3, 3)), "separate boxes overlap");
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxOverlapsCircle(box, INSKCircleMake(CGPointMake(4, 1), 2)), "touching circle doesn't overlap the box");
+    INSK_TEST_ASSERT(!INSKAxisAlignedBoxOverlapsCircle(box, INSKCircleMake(CGPointMake(3, 3), 1.4)), "circle near the corner overlaps the box");
+    INSK_TEST_ASSERT(INSKCircleOverlapsCircle(INSKCircleMake(CGPointMake(0, 0), 1), INSKCircleMake(CGPointMake(3, 0), 2)), "touching circles don't overlap");
+    INSK_TEST_ASSERT(!INSKCircleOverlapsCircle(INSKCircleMake(CGPointMake(0, 0), 1), INSKCircleMake(CGPointMake(3, 1), 2)), "separate circles overlap");
+
+    INSKOrientedBox diamond = INSKOrientedBoxMake(CGPointMake(0, 0), CGSizeMake(2, 2), M_PI_4);
+    INSK_TEST_ASSERT(INSKOrientedBoxOverlapsCircle(diamond, INSKCircleMake(CGPointMake(1.9, 0), 0.5)), "circle at the tip doesn't overlap the diamond");
+    INSK_TEST_ASSERT(!INSKOrientedBoxOverlapsCircle(diamond, INSKCircleMake(CGPointMake(1.2, 1.2), 0.5)), "circle beside the diamond overlaps");
+
+    INSKOrientedBox square = INSKOrientedBoxMake(CGPointMake(2.5, 0), CGSizeMake(2, 2), 0.0);
+    INSK_TEST_ASSERT(!INSKOrientedBoxOverlapsBox(diamond, square), "separate boxes overlap");
+    square.center.x = 2.3;
+    INSK_TEST_ASSERT(INSKOrientedBoxOverlapsBox(diamond, square), "overlapping boxes don't overlap");
+    INSKOrientedBox rotated = INSKOrientedBoxMake(CGPointMake(1.5, 1.5), CGSizeMake(1, 1), M_PI_4);
+    INSK_TEST_ASSERT(!INSKOrientedBoxOverlapsBox(INSKOrientedBoxMake(CGPointMake(0, 0), CGSizeMake(2, 2), 0.0), rotated), "boxes separated on a diagonal overlap");
+
+    INSKPolygon pentagon = INSKPolygonMake(INSKTestPentagon, 5);
+    CGPoint triangle[] = {{9, 9}, {20, 9}, {9, 20}};
+    INSK_TEST_ASSERT(!INSKConvexPolygonOverlapsPolygon(pentagon, INSKPolygonMake(triangle, 3)), "separate polygons overlap");
+    triangle[0] = CGPointMake(5, 5);
+    INSK_TEST_ASSERT(INSKConvexPolygonOverlapsPolygon(pentagon, INSKPolygonMake(triangle, 3)), "overlapping polygons don't overlap");
+    INSK_TEST_ASSERT(!INSKConvexPolygonOverlapsPolygon(pentagon, INSKPolygonMake(NULL, 0)), "empty polygon overlaps");
+
+    INSK_TEST_ASSERT(INSKConvexPolygonOverlapsCircle(pentagon, INSKCircleMake(CGPointMake(0, 0), 1)), "circle inside doesn't overlap");
+    INSK_TEST_ASSERT(INSKConvexPolygonOverlapsCircle(pentagon, INSKCircleMake(CGPointMake(0, 10), 2)), "touching circle doesn't overlap");
+    INSK_TEST_ASSERT(!INSKConvexPolygonOverlapsCircle(pentagon, INSKCircleMake(CGPointMake(10, 8), 2)), "separate circle overlaps");
+    INSK_TEST_ASSERT(!INSKConvexPolygonOverlapsCircle(INSKPolygonMake(NULL, 0), INSKCircleMake(CGPointMake(0, 0), 1)), "empty polygon overlaps");
+}
+
+static void test_orientedBoxOverlap_matchesPolygonOverlap(void) {
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSKOrientedBox boxes[2];
+        CGPoint corners[2][4];
+        for (int box = 0; box < 2; ++box) {
+            boxes[box] = INSKOrientedBoxMake(CGPointMake(INSKTestRandom(-10.0, 10.0), INSKTestRandom(-10.0, 10.0)),
+                                             CGSizeMake(INSKTestRandom(0.5, 10.0), INSKTestRandom(0.5, 10.0)), INSKTestRandom(-M_PI, M_PI));
+            CGPoint axisX = CGPointMultiplyScalar(boxes[box].axis, boxes[box].halfSize.width);
+            CGPoint axisY = CGPointMultiplyScalar(CGPointMake(-boxes[box].axis.y, boxes[box].axis.x), boxes[box].halfSize.height);
+            corners[box][0] = CGPointSubtract(CGPointSubtract(boxes[box].center, axisX), axisY);
+            corners[box][1] = CGPointSubtract(CGPointAdd(boxes[box].center, axisX), axisY);
+            corners[box][2] = CGPointAdd(CGPointAdd(boxes[box].center, axisX), axisY);
+            corners[box][3] = CGPointAdd(CGPointSubtract(boxes[box].center, axisX), axisY);
+        }
+        INSK_TEST_ASSERT(INSKOrientedBoxOverlapsBox(boxes[0], boxes[1]) == INSKConvexPolygonOverlapsPolygon(INSKPolygonMake(corners[0], 4), INSKPolygonMake(corners[1], 4)),
+                         "oriented box and polygon overlap differ in sample %d", index);
+    }
+}
+
+
+// batches
+
+static void test_pointBatches_matchSingleTests(void) {
+    static CGPoint points[INSKTestSampleCount];
+    static bool results[INSKTestSampleCount];
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        points[index] = INSKTestRandomPoint();
+    }
+
+    INSKAxisAlignedBox box = INSKAxisAlignedBoxMake(-30, -50, 40, 20);
+    size_t inside = INSKAxisAlignedBoxContainsPoints(box, points, results, INSKTestSampleCount);
+    size_t expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKAxisAlignedBoxContainsPoint(box, points[index]), "box batch differs at %d", index);
+        expected += INSKAxisAlignedBoxContainsPoint(box, points[index]);
+    }
+    INSK_TEST_ASSERT(inside == expected && inside > 0, "box batch counted %zu instead of %zu", inside, expected);
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxContainsPoints(box, points, NULL, INSKTestSampleCount) == expected, "box batch without results counted wrong");
+
+    INSKOrientedBox orientedBox = INSKOrientedBoxMake(CGPointMake(10, -5), CGSizeMake(120, 30), 0.7);
+    inside = INSKOrientedBoxContainsPoints(orientedBox, points, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKOrientedBoxContainsPoint(orientedBox, points[index]), "oriented box batch differs at %d", index);
+        expected += INSKOrientedBoxContainsPoint(orientedBox, points[index]);
+    }
+    INSK_TEST_ASSERT(inside == expected && inside > 0, "oriented box batch counted %zu instead of %zu", inside, expected);
+    INSK_TEST_ASSERT(INSKOrientedBoxContainsPoints(orientedBox, points, NULL, INSKTestSampleCount) == expected, "oriented box batch without results counted wrong");
+
+    INSKCircle circle = INSKCircleMake(CGPointMake(-20, 15), 45);
+    inside = INSKCircleContainsPoints(circle, points, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKCircleContainsPoint(circle, points[index]), "circle batch differs at %d", index);
+        expected += INSKCircleContainsPoint(circle, points[index]);
+    }
+    INSK_TEST_ASSERT(inside == expected && inside > 0, "circle batch counted %zu instead of %zu", inside, expected);
+    INSK_TEST_ASSERT(INSKCircleContainsPoints(circle, points, NULL, INSKTestSampleCount) == expected, "circle batch without results counted wrong");
+
+    CGPoint uShape[8];
+    for (int index = 0; index < 8; ++index) {
+        uShape[index] = CGPointMultiplyScalar(INSKTestUShape[index], 15.0);
+    }
+    INSKPolygon polygon = INSKPolygonMake(uShape, 8);
+    inside = INSKPolygonContainsPoints(polygon, points, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKPolygonContainsPoint(polygon, points[index]), "polygon batch differs at %d", index);
+        expected += INSKPolygonContainsPoint(polygon, points[index]);
+    }
+    INSK_TEST_ASSERT(inside == expected && inside > 0, "polygon batch counted %zu instead of %zu", inside, expected);
+}
+
+static void test_shapeBatches_matchSingleTests(void) {
+    static INSKAxisAlignedBox boxes[INSKTestSampleCount];
+    static INSKOrientedBox orientedBoxes[INSKTestSampleCount];
+    static INSKCircle circles[INSKTestSampleCount];
+    static bool results[INSKTestSampleCount];
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        CGPoint corner = INSKTestRandomPoint();
+        boxes[index] = INSKAxisAlignedBoxMake(corner.x, corner.y, corner.x + INSKTestRandom(0.0, 50.0), corner.y + INSKTestRandom(0.0, 50.0));
+        orientedBoxes[index] = INSKOrientedBoxMake(INSKTestRandomPoint(), CGSizeMake(INSKTestRandom(0.0, 80.0), INSKTestRandom(0.0, 80.0)), INSKTestRandom(-M_PI, M_PI));
+        circles[index] = INSKCircleMake(INSKTestRandomPoint(), INSKTestRandom(0.0, 40.0));
+    }
+    CGPoint point = CGPointMake(5, -7);
+    INSKAxisAlignedBox visibleBox = INSKAxisAlignedBoxMake(-20, -10, 30, 25);
+
+    size_t count = INSKAxisAlignedBoxesContainPoint(boxes, point, results, INSKTestSampleCount);
+    size_t expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKAxisAlignedBoxContainsPoint(boxes[index], point), "boxes batch differs at %d", index);
+        expected += results[index];
+    }
+    INSK_TEST_ASSERT(count == expected && count > 0, "boxes batch counted %zu instead of %zu", count, expected);
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxesContainPoint(boxes, point, NULL, INSKTestSampleCount) == expected, "boxes batch without results counted wrong");
+
+    count = INSKOrientedBoxesContainPoint(orientedBoxes, point, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKOrientedBoxContainsPoint(orientedBoxes[index], point), "oriented boxes batch differs at %d", index);
+        expected += results[index];
+    }
+    INSK_TEST_ASSERT(count == expected && count > 0, "oriented boxes batch counted %zu instead of %zu", count, expected);
+    INSK_TEST_ASSERT(INSKOrientedBoxesContainPoint(orientedBoxes, point, NULL, INSKTestSampleCount) == expected, "oriented boxes batch without results counted wrong");
+
+    count = INSKCirclesContainPoint(circles, point, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKCircleContainsPoint(circles[index], point), "circles batch differs at %d", index);
+        expected += results[index];
+    }
+    INSK_TEST_ASSERT(count == expected && count > 0, "circles batch counted %zu instead of %zu", count, expected);
+    INSK_TEST_ASSERT(INSKCirclesContainPoint(circles, point, NULL, INSKTestSampleCount) == expected, "circles batch without results counted wrong");
+
+    count = INSKAxisAlignedBoxesOverlapBox(boxes, visibleBox, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKAxisAlignedBoxOverlapsBox(boxes[index], visibleBox), "box overlap batch differs at %d", index);
+        expected += results[index];
+    }
+    INSK_TEST_ASSERT(count == expected && count > 0, "box overlap batch counted %zu instead of %zu", count, expected);
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxesOverlapBox(boxes, visibleBox, NULL, INSKTestSampleCount) == expected, "box overlap batch without results counted wrong");
+
+    count = INSKCirclesOverlapBox(circles, visibleBox, results, INSKTestSampleCount);
+    expected = 0;
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        INSK_TEST_ASSERT(results[index] == INSKAxisAlignedBoxOverlapsCircle(visibleBox, circles[index]), "circle overlap batch differs at %d", index);
+        expected += results[index];
+    }
+    INSK_TEST_ASSERT(count == expected && count > 0, "circle overlap batch counted %zu instead of %zu", count, expected);
+    INSK_TEST_ASSERT(INSKCirclesOverlapBox(circles, visibleBox, NULL, INSKTestSampleCount) == expected, "circle overlap batch without results counted wrong");
+}
+
+
+
+// regions
+
+static CGFloat INSKTestBoxArea(INSKAxisAlignedBox box) {
+    return MAX(box.max.x - box.min.x, 0) * MAX(box.max.y - box.min.y, 0);
+}
+
+static INSKAxisAlignedBox INSKTestBoxIntersection(INSKAxisAlignedBox box1, INSKAxisAlignedBox box2) {
+    return INSKAxisAlignedBoxMake(MAX(box1.min.x, box2.min.x), MAX(box1.min.y, box2.min.y), MIN(box1.max.x, box2.max.x), MIN(box1.max.y, box2.max.y));
+}
+
+static void test_boxSubtraction_coversDifference(void) {
+    INSKAxisAlignedBox pieces[INSKAxisAlignedBoxSubtractMaxPieces];
+    INSKAxisAlignedBox box = INSKAxisAlignedBoxMake(0, 0, 10, 10);
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxSubtract(box, INSKAxisAlignedBoxMake(-1, -1, 11, 11), pieces) == 0, "box inside of the subtrahend has pieces");
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxSubtract(box, INSKAxisAlignedBoxMake(10, 0, 20, 10), pieces) == 1 && pieces[0].max.x == 10, "touching box isn't kept");
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxSubtract(box, INSKAxisAlignedBoxMake(2, 2, 8, 8), pieces) == 4, "hole doesn't give four pieces");
+    INSK_TEST_ASSERT(INSKAxisAlignedBoxSubtract(box, INSKAxisAlignedBoxMake(0, 3, 10, 13), pieces) == 1 && pieces[0].max.y == 3, "scrolled box doesn't give one band");
+
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        // Integer coordinates, so the areas are exact.
+        CGFloat x = floor(INSKTestRandom(-20, 20)), y = floor(INSKTestRandom(-20, 20));
+        box = INSKAxisAlignedBoxMake(x, y, x + floor(INSKTestRandom(0, 30)), y + floor(INSKTestRandom(0, 30)));
+        x = floor(INSKTestRandom(-20, 20));
+        y = floor(INSKTestRandom(-20, 20));
+        INSKAxisAlignedBox subtrahend = INSKAxisAlignedBoxMake(x, y, x + floor(INSKTestRandom(0, 30)), y + floor(INSKTestRandom(0, 30)));
+        size_t count = INSKAxisAlignedBoxSubtract(box, subtrahend, pieces);
+
+        CGFloat area = 0;
+        bool valid = count <= INSKAxisAlignedBoxSubtractMaxPieces;
+        for (size_t piece = 0; piece < count && valid; ++piece) {
+            area += INSKTestBoxArea(pieces[piece]);
+            valid = INSKTestBoxArea(pieces[piece]) > 0 && INSKTestBoxArea(INSKTestBoxIntersection(pieces[piece], box)) == INSKTestBoxArea(pieces[piece])
+                && INSKTestBoxArea(INSKTestBoxIntersection(pieces[piece], subtrahend)) == 0;
+            for (size_t other = 0; other < piece && valid; ++other) {
+                valid = INSKTestBoxArea(INSKTestBoxIntersection(pieces[piece], pieces[other])) == 0;
+            }
+        }
+        CGFloat expected = INSKTestBoxArea(box) - INSKTestBoxArea(INSKTestBoxIntersection(box, subtrahend));
+        INSK_TEST_ASSERT(valid && area == expected, "subtraction %d has the area %f instead of %f", index, (double)area, (double)expected);
+    }
+}
+
+
+int main(void) {
+    test_shapes_areCreatedCorrectly();
+    test_containment_includesBoundary();
+    test_polygonContainment_matchesConvexContainment();
+    test_overlap_includesTouchingShapes();
+    test_orientedBoxOverlap_matchesPolygonOverlap();
+    test_pointBatches_matchSingleTests();
+    test_shapeBatches_matchSingleTests();
+    test_boxSubtraction_coversDifference();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+// A command line tool which replays recorded touch events against a synthetic scene and prints the latencies per event.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKInputReplayTool.c INSpriteKit/INSKInputReplay.c INSpriteKit/INSKInputRecording.c INSpriteKit/INSKInstrumentation.c INSpriteKit/INSKSpatialIndex.c INSpriteKit/INSKTouchSlotTable.c -lm -o insk-input-replay
+//
+// Usage:
+//   insk-input-replay [-nodes count] [-observers count] [-iterations count] [-seed value] [recording file]
+//
+// Without a recording file random touches are replayed. Recordings can be made with [INSKView inputRecording].
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKInputReplay.h"
+
+
+int main(int argc, char *argv[]) {
+    size_t nodeCount = 1000;
+    size_t observerCount = 4;
+    unsigned int iterations = 20;
+    unsigned int seed = 1;
+    const char *path = NULL;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-nodes") == 0 && argument + 1 < argc) {
+            nodeCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-observers") == 0 && argument + 1 < argc) {
+            observerCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-seed") == 0 && argument + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else if (argv[argument][0] != '-' && path == NULL) {
+            path = argv[argument];
+        } else {
+            fprintf(stderr, "usage: %s [-nodes count] [-observers count] [-iterations count] [-seed value] [recording file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // A scene of the size of a tablet screen.
+    INSKSpatialBounds worldBounds = {0.0, 0.0, 1024.0, 768.0};
+
+    INSKInputRecording *recording = NULL;
+    if (path != NULL) {
+        recording = INSKInputRecordingReadFile(path);
+        if (recording == NULL) {
+            fprintf(stderr, "couldn't read recording %s\n", path);
+            return 1;
+        }
+    } else {
+        recording = INSKInputRecordingCreate();
+        if (recording == NULL || !INSKInputReplayAppendRandomTouches(recording, 1000, worldBounds, seed)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+
+    INSKInputReplayNode *nodes = calloc(nodeCount > 0 ? nodeCount : 1, sizeof(INSKInputReplayNode));
+    INSKInputReplayObserver *observers = calloc(observerCount > 0 ? observerCount : 1, sizeof(INSKInputReplayObserver));
+    if (nodes == NULL || observers == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    INSKInputReplayFillRandomNodes(nodes, nodeCount, worldBounds, seed);
+    // Every second observer only wants began and ended events in the left half.
+    for (size_t index = 0; index < observerCount; ++index) {
+        INSKInputReplayObserver *observer = &observers[index];
+        observer->phases = INSKInputPhaseBegan | INSKInputPhaseMoved | INSKInputPhaseEnded | INSKInputPhaseCancelled;
+        if (index % 2 == 1) {
+            INSKSpatialBounds region = {0.0, 0.0, 512.0, 768.0};
+            observer->phases = INSKInputPhaseBegan | INSKInputPhaseEnded;
+            observer->hasRegion = true;
+            observer->region = region;
+        }
+    }
+
+    INSKInputReplayScene scene = {nodes, nodeCount, observers, observerCount};
+    INSKInputReplayResult result;
+    if (!INSKInputReplayRun(&scene, recording, iterations, &result)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("events %zu nodes %zu observers %zu\n", result.eventCount, nodeCount, observerCount);
+    printf("p50 %.0f ns p99 %.0f ns max %.0f ns mean %.1f ns\n", result.p50, result.p99, result.max, result.mean);
+    printf("node hits %zu observer calls %zu\n", result.nodeHits, result.observerCalls);
+
+    free(observers);
+    free(nodes);
+    INSKInputRecordingDestroy(recording);
+    return 0;
+}
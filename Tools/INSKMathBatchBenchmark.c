@@ -0,0 +1,173 @@
+// A command line tool which measures the throughput of the batch functions of INSKMathBatch.h against loops over the scalar point functions of INSKMath.h.
+//
+// Build it on Linux x86-64 or any other platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKMathBatchBenchmark.c INSpriteKit/INSKMathBatch.c INSpriteKit/INSKInstrumentation.c -lm -o insk-math-batch-benchmark
+// Add -mavx to build the AVX paths on x86-64.
+//
+// Usage:
+//   insk-math-batch-benchmark [-points count] [-iterations count]
+//
+// Prints the million points per second of each function for the scalar loop, the batch function with SIMD and the batch function with the scalar fallback.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKMathBatch.h"
+#include "INSKInstrumentation.h"
+
+
+// The kinds of measured loops.
+enum {
+    INSKBenchmarkLoop = 0,
+    INSKBenchmarkBatchSIMD,
+    INSKBenchmarkBatchScalar,
+    INSKBenchmarkBatchSoA,
+    INSKBenchmarkVariantCount
+};
+
+// The data all functions work on.
+typedef struct {
+    CGPoint *points1;
+    CGPoint *points2;
+    CGPoint *result;
+    INSKPointsSoA soa1;
+    INSKPointsSoA soa2;
+    INSKPointsSoA soaResult;
+    CGFloat *distances;
+    size_t count;
+} INSKBenchmarkData;
+
+// The benchmarked operations.
+typedef enum {
+    INSKBenchmarkAdd = 0,
+    INSKBenchmarkMultiplyScalar,
+    INSKBenchmarkDistanceSq,
+    INSKBenchmarkNormalize,
+    INSKBenchmarkLerp,
+    INSKBenchmarkOperationCount
+} INSKBenchmarkOperation;
+
+static const char *const INSKBenchmarkOperationNames[INSKBenchmarkOperationCount] = {"add", "multiplyScalar", "distanceSq", "normalize", "lerp"};
+
+// Used to keep the compiler from removing the scalar loops.
+static volatile CGFloat INSKBenchmarkSink;
+
+
+// Runs one pass of an operation with the scalar point functions.
+static void INSKBenchmarkRunLoop(INSKBenchmarkData *data, INSKBenchmarkOperation operation) {
+    CGPoint origin = CGPointMake(12.0, -7.0);
+    for (size_t index = 0; index < data->count; ++index) {
+        switch (operation) {
+            case INSKBenchmarkAdd: data->result[index] = CGPointAdd(data->points1[index], data->points2[index]); break;
+            case INSKBenchmarkMultiplyScalar: data->result[index] = CGPointMultiplyScalar(data->points1[index], 1.5); break;
+            case INSKBenchmarkDistanceSq: data->distances[index] = CGPointDistanceSq(data->points1[index], origin); break;
+            case INSKBenchmarkNormalize: data->result[index] = CGPointNormalize(data->points1[index]); break;
+            default: data->result[index] = CGPointLerp(data->points1[index], data->points2[index], 0.25); break;
+        }
+    }
+}
+
+// Runs one pass of an operation with the batch functions.
+static void INSKBenchmarkRunBatch(INSKBenchmarkData *data, INSKBenchmarkOperation operation, bool soa) {
+    CGPoint origin = CGPointMake(12.0, -7.0);
+    size_t count = data->count;
+    switch (operation) {
+        case INSKBenchmarkAdd:
+            soa ? INSKPointsSoAAdd(data->soaResult, data->soa1, data->soa2, count) : INSKPointsAdd(data->result, data->points1, data->points2, count);
+            break;
+        case INSKBenchmarkMultiplyScalar:
+            soa ? INSKPointsSoAMultiplyScalar(data->soaResult, data->soa1, 1.5, count) : INSKPointsMultiplyScalar(data->result, data->points1, 1.5, count);
+            break;
+        case INSKBenchmarkDistanceSq:
+            soa ? INSKPointsSoADistanceSq(data->distances, data->soa1, origin, count) : INSKPointsDistanceSq(data->distances, data->points1, origin, count);
+            break;
+        case INSKBenchmarkNormalize:
+            soa ? INSKPointsSoANormalize(data->soaResult, data->soa1, count) : INSKPointsNormalize(data->result, data->points1, count);
+            break;
+        default:
+            soa ? INSKPointsSoALerp(data->soaResult, data->soa1, data->soa2, 0.25, count) : INSKPointsLerp(data->result, data->points1, data->points2, 0.25, count);
+            break;
+    }
+}
+
+// Returns the million points per second of an operation.
+static double INSKBenchmarkMeasure(INSKBenchmarkData *data, INSKBenchmarkOperation operation, int variant, unsigned int iterations) {
+    INSKMathBatchSetSIMDEnabled(variant != INSKBenchmarkBatchScalar);
+    uint64_t start = INSKInstrumentationNow();
+    for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+        if (variant == INSKBenchmarkLoop) {
+            INSKBenchmarkRunLoop(data, operation);
+        } else {
+            INSKBenchmarkRunBatch(data, operation, variant == INSKBenchmarkBatchSoA);
+        }
+        INSKBenchmarkSink = data->result[iteration % data->count].x + data->soaResult.x[iteration % data->count] + data->distances[iteration % data->count];
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    INSKMathBatchSetSIMDEnabled(true);
+    return nanoseconds > 0 ? (double)data->count * iterations * 1000.0 / (double)nanoseconds : 0.0;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t count = 4096;
+    unsigned int iterations = 2000;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-points") == 0 && argument + 1 < argc) {
+            count = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-points count] [-iterations count]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count == 0) {
+        count = 1;
+    }
+
+    INSKBenchmarkData data;
+    data.count = count;
+    data.points1 = malloc(count * sizeof(CGPoint));
+    data.points2 = malloc(count * sizeof(CGPoint));
+    data.result = calloc(count, sizeof(CGPoint));
+    data.distances = calloc(count, sizeof(CGFloat));
+    CGFloat *values = calloc(count * 6, sizeof(CGFloat));
+    if (data.points1 == NULL || data.points2 == NULL || data.result == NULL || data.distances == NULL || values == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    INSKPointsSoA soa1 = {values, values + count};
+    INSKPointsSoA soa2 = {values + count * 2, values + count * 3};
+    INSKPointsSoA soaResult = {values + count * 4, values + count * 5};
+    data.soa1 = soa1;
+    data.soa2 = soa2;
+    data.soaResult = soaResult;
+    for (size_t index = 0; index < count; ++index) {
+        data.points1[index] = CGPointMake((CGFloat)(index % 97) - 48.0, (CGFloat)(index % 89) + 1.0);
+        data.points2[index] = CGPointMake((CGFloat)(index % 83), (CGFloat)(index % 79) - 39.0);
+        soa1.x[index] = data.points1[index].x;
+        soa1.y[index] = data.points1[index].y;
+        soa2.x[index] = data.points2[index].x;
+        soa2.y[index] = data.points2[index].y;
+    }
+
+    const char *names[] = {"scalar", "SSE2", "AVX", "NEON"};
+    printf("implementation %s points %zu iterations %u\n", names[INSKMathBatchGetImplementation()], count, iterations);
+    printf("%-16s %12s %12s %12s %12s\n", "Mpoints/s", "loop", "batch", "batch-scalar", "batch-soa");
+    for (int operation = 0; operation < INSKBenchmarkOperationCount; ++operation) {
+        double results[INSKBenchmarkVariantCount];
+        for (int variant = 0; variant < INSKBenchmarkVariantCount; ++variant) {
+            // A short warm up pass first, so the caches are filled.
+            INSKBenchmarkMeasure(&data, (INSKBenchmarkOperation)operation, variant, iterations / 10 + 1);
+            results[variant] = INSKBenchmarkMeasure(&data, (INSKBenchmarkOperation)operation, variant, iterations);
+        }
+        printf("%-16s %12.1f %12.1f %12.1f %12.1f\n", INSKBenchmarkOperationNames[operation], results[INSKBenchmarkLoop], results[INSKBenchmarkBatchSIMD], results[INSKBenchmarkBatchScalar], results[INSKBenchmarkBatchSoA]);
+    }
+
+    free(values);
+    free(data.distances);
+    free(data.result);
+    free(data.points2);
+    free(data.points1);
+    return 0;
+}
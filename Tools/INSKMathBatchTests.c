@@ -0,0 +1,285 @@
+// Validates the batch functions of INSKMathBatch.h against the scalar point functions of INSKMath.h on random data.
+//
+// Build and run it with a C99 compiler, optionally with -mavx on x86-64 for the AVX paths:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKMathBatchTests.c INSpriteKit/INSKMathBatch.c -lm -o insk-math-batch-tests && ./insk-math-batch-tests
+//
+// Each test runs once with the SIMD paths and once with the scalar fallback, for several counts to cover the remainders of the SIMD loops.
+// The tool prints each failed comparison and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "INSKMathBatch.h"
+
+
+// The number of points of the biggest test.
+#define INSKTestMaxCount 67
+
+// The counts each batch function is tested with.
+static const size_t INSKTestCounts[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 16, 33, INSKTestMaxCount};
+
+// The number of failed comparisons.
+static int INSKTestFailures = 0;
+
+// The state of the random number generator.
+static uint32_t INSKTestRandomState = 1;
+
+
+// Returns a random value in the range [-1000, 1000].
+static CGFloat INSKTestRandomValue(void) {
+    INSKTestRandomState ^= INSKTestRandomState << 13;
+    INSKTestRandomState ^= INSKTestRandomState >> 17;
+    INSKTestRandomState ^= INSKTestRandomState << 5;
+    return (CGFloat)(-1000.0 + 2000.0 * (INSKTestRandomState / (double)UINT32_MAX));
+}
+
+static void INSKTestFillPoints(CGPoint *points, size_t count) {
+    for (size_t index = 0; index < count; ++index) {
+        points[index] = CGPointMake(INSKTestRandomValue(), INSKTestRandomValue());
+    }
+}
+
+static void INSKTestCopyToSoA(INSKPointsSoA destination, const CGPoint *points, size_t count) {
+    for (size_t index = 0; index < count; ++index) {
+        destination.x[index] = points[index].x;
+        destination.y[index] = points[index].y;
+    }
+}
+
+// Compares with a relative tolerance, because the SIMD paths may round differently than the compiled scalar code, i.e. when contracting to FMA.
+static void INSKTestCompare(const char *name, size_t count, size_t index, CGFloat value, CGFloat expected) {
+    double tolerance = 1e-12 * fmax(1.0, fabs((double)expected));
+#if !CGFLOAT_IS_DOUBLE
+    tolerance = 1e-5 * fmax(1.0, fabs((double)expected));
+#endif
+    if (!(fabs((double)value - (double)expected) <= tolerance)) {
+        INSKTestFailures++;
+        printf("%s (%s, count %zu): value %zu is %.17g instead of %.17g\n", name, INSKMathBatchGetImplementation() == INSKMathBatchImplementationScalar ? "scalar" : "simd", count, index, (double)value, (double)expected);
+    }
+}
+
+static void INSKTestComparePoints(const char *name, size_t count, const CGPoint *points, const CGPoint *expected) {
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompare(name, count, index, points[index].x, expected[index].x);
+        INSKTestCompare(name, count, index, points[index].y, expected[index].y);
+    }
+}
+
+static void INSKTestCompareSoA(const char *name, size_t count, INSKPointsSoA points, const CGPoint *expected) {
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompare(name, count, index, points.x[index], expected[index].x);
+        INSKTestCompare(name, count, index, points.y[index], expected[index].y);
+    }
+}
+
+
+static void test_batchFunctions_matchScalarFunctions(size_t count) {
+    CGPoint points1[INSKTestMaxCount], points2[INSKTestMaxCount], result[INSKTestMaxCount];
+    CGPoint expected[INSKTestMaxCount] = {{0, 0}};
+    CGFloat x1[INSKTestMaxCount], y1[INSKTestMaxCount], x2[INSKTestMaxCount], y2[INSKTestMaxCount], x3[INSKTestMaxCount], y3[INSKTestMaxCount];
+    CGFloat distances[INSKTestMaxCount];
+    INSKPointsSoA soa1 = {x1, y1};
+    INSKPointsSoA soa2 = {x2, y2};
+    INSKPointsSoA soaResult = {x3, y3};
+    INSKTestFillPoints(points1, count);
+    INSKTestFillPoints(points2, count);
+    INSKTestCopyToSoA(soa1, points1, count);
+    INSKTestCopyToSoA(soa2, points2, count);
+    CGPoint origin = CGPointMake(INSKTestRandomValue(), INSKTestRandomValue());
+    CGFloat value = INSKTestRandomValue() / 100;
+    CGFloat t = 0.3;
+
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointAdd(points1[index], points2[index]);
+    }
+    INSKPointsAdd(result, points1, points2, count);
+    INSKTestComparePoints("INSKPointsAdd", count, result, expected);
+    INSKPointsSoAAdd(soaResult, soa1, soa2, count);
+    INSKTestCompareSoA("INSKPointsSoAAdd", count, soaResult, expected);
+
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointSubtract(points1[index], points2[index]);
+    }
+    INSKPointsSubtract(result, points1, points2, count);
+    INSKTestComparePoints("INSKPointsSubtract", count, result, expected);
+    INSKPointsSoASubtract(soaResult, soa1, soa2, count);
+    INSKTestCompareSoA("INSKPointsSoASubtract", count, soaResult, expected);
+
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointMultiplyScalar(points1[index], value);
+    }
+    INSKPointsMultiplyScalar(result, points1, value, count);
+    INSKTestComparePoints("INSKPointsMultiplyScalar", count, result, expected);
+    INSKPointsSoAMultiplyScalar(soaResult, soa1, value, count);
+    INSKTestCompareSoA("INSKPointsSoAMultiplyScalar", count, soaResult, expected);
+
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointNormalize(points1[index]);
+    }
+    INSKPointsNormalize(result, points1, count);
+    INSKTestComparePoints("INSKPointsNormalize", count, result, expected);
+    INSKPointsSoANormalize(soaResult, soa1, count);
+    INSKTestCompareSoA("INSKPointsSoANormalize", count, soaResult, expected);
+
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointLerp(points1[index], points2[index], t);
+    }
+    INSKPointsLerp(result, points1, points2, t, count);
+    INSKTestComparePoints("INSKPointsLerp", count, result, expected);
+    INSKPointsSoALerp(soaResult, soa1, soa2, t, count);
+    INSKTestCompareSoA("INSKPointsSoALerp", count, soaResult, expected);
+
+    INSKPointsDistanceSq(distances, points1, origin, count);
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompare("INSKPointsDistanceSq", count, index, distances[index], CGPointDistanceSq(points1[index], origin));
+    }
+    INSKPointsSoADistanceSq(distances, soa1, origin, count);
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompare("INSKPointsSoADistanceSq", count, index, distances[index], CGPointDistanceSq(points1[index], origin));
+    }
+}
+
+static void test_batchFunctions_workInPlace(size_t count) {
+    CGPoint points[INSKTestMaxCount], expected[INSKTestMaxCount];
+    CGFloat x[INSKTestMaxCount], y[INSKTestMaxCount];
+    INSKPointsSoA soa = {x, y};
+    INSKTestFillPoints(points, count);
+    INSKTestCopyToSoA(soa, points, count);
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointNormalize(CGPointAdd(points[index], points[index]));
+    }
+
+    INSKPointsAdd(points, points, points, count);
+    INSKPointsNormalize(points, points, count);
+    INSKTestComparePoints("INSKPointsAdd and INSKPointsNormalize in place", count, points, expected);
+    INSKPointsSoAAdd(soa, soa, soa, count);
+    INSKPointsSoANormalize(soa, soa, count);
+    INSKTestCompareSoA("INSKPointsSoAAdd and INSKPointsSoANormalize in place", count, soa, expected);
+}
+
+// Compares bit by bit, because the angle functions promise exactly the same results.
+static void INSKTestCompareExactly(const char *name, size_t count, size_t index, CGFloat value, CGFloat expected) {
+    if (memcmp(&value, &expected, sizeof(CGFloat)) != 0) {
+        INSKTestFailures++;
+        printf("%s (%s, count %zu): value %zu is %.17g instead of %.17g\n", name, INSKMathBatchGetImplementation() == INSKMathBatchImplementationScalar ? "scalar" : "simd", count, index, (double)value, (double)expected);
+    }
+}
+
+// Returns mostly angles around the usual ranges, some exactly on the boundaries and some accumulated by long rotations.
+static CGFloat INSKTestRandomAngle(void) {
+    static const CGFloat boundaries[] = {0.0, -0.0, M_PI, -M_PI, M_PI_X_2, -M_PI_X_2, 3 * M_PI, -3 * M_PI};
+    CGFloat value = INSKTestRandomValue();
+    if (fabs(value) > 990.0) {
+        return boundaries[(size_t)(fabs(value) * 1000.0) % (sizeof(boundaries) / sizeof(boundaries[0]))];
+    }
+    if (fabs(value) > 900.0) {
+        return value * 1000.0;
+    }
+    return value / 1000.0 * 2.0 * M_PI;
+}
+
+static void test_angleBatchFunctions_matchScalarFunctionsExactly(size_t count) {
+    CGFloat angles1[INSKTestMaxCount] = {0}, angles2[INSKTestMaxCount] = {0}, result[INSKTestMaxCount];
+    for (size_t index = 0; index < count; ++index) {
+        angles1[index] = INSKTestRandomAngle();
+        angles2[index] = INSKTestRandomAngle();
+    }
+
+    INSKAnglesIn2Pi(result, angles1, count);
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompareExactly("INSKAnglesIn2Pi", count, index, result[index], AngleIn2Pi(angles1[index]));
+    }
+    INSKAnglesInPi(result, angles1, count);
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompareExactly("INSKAnglesInPi", count, index, result[index], AngleInPi(angles1[index]));
+    }
+    INSKAnglesShortestBetween(result, angles1, angles2, count);
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompareExactly("INSKAnglesShortestBetween", count, index, result[index], ShortestAngleBetween(angles1[index], angles2[index]));
+    }
+
+    // In place the second array receives the results.
+    memcpy(result, angles2, count * sizeof(CGFloat));
+    INSKAnglesShortestBetween(angles2, angles1, angles2, count);
+    for (size_t index = 0; index < count; ++index) {
+        INSKTestCompareExactly("INSKAnglesShortestBetween in place", count, index, angles2[index], ShortestAngleBetween(angles1[index], result[index]));
+    }
+}
+
+
+static INSKAffineTransform INSKTestRandomTransform(void) {
+    INSKAffineTransform transform = INSKAffineTransformMakeTranslation(INSKTestRandomValue(), INSKTestRandomValue());
+    transform = INSKAffineTransformRotate(transform, INSKTestRandomValue() / 100);
+    return INSKAffineTransformScale(transform, INSKTestRandomValue() / 500, INSKTestRandomValue() / 500);
+}
+
+static void INSKTestCompareTransforms(const char *name, size_t count, size_t index, INSKAffineTransform transform, INSKAffineTransform expected) {
+    INSKTestCompare(name, count, index, transform.a, expected.a);
+    INSKTestCompare(name, count, index, transform.b, expected.b);
+    INSKTestCompare(name, count, index, transform.c, expected.c);
+    INSKTestCompare(name, count, index, transform.d, expected.d);
+    INSKTestCompare(name, count, index, transform.tx, expected.tx);
+    INSKTestCompare(name, count, index, transform.ty, expected.ty);
+}
+
+static void test_affineTransformBatchFunctions_matchScalarFunctions(size_t count) {
+    CGPoint points[INSKTestMaxCount], result[INSKTestMaxCount];
+    CGPoint expected[INSKTestMaxCount] = {{0, 0}};
+    CGFloat x[INSKTestMaxCount], y[INSKTestMaxCount];
+    INSKPointsSoA soa = {x, y};
+    INSKTestFillPoints(points, count);
+    INSKTestCopyToSoA(soa, points, count);
+    INSKAffineTransform transform = INSKTestRandomTransform();
+    for (size_t index = 0; index < count; ++index) {
+        expected[index] = CGPointApplyINSKAffineTransform(points[index], transform);
+    }
+    INSKPointsApplyAffineTransform(result, points, transform, count);
+    INSKTestComparePoints("INSKPointsApplyAffineTransform", count, result, expected);
+    INSKPointsApplyAffineTransform(points, points, transform, count);
+    INSKTestComparePoints("INSKPointsApplyAffineTransform in place", count, points, expected);
+    INSKPointsSoAApplyAffineTransform(soa, soa, transform, count);
+    INSKTestCompareSoA("INSKPointsSoAApplyAffineTransform", count, soa, expected);
+
+    // Short chains, so the products stay in a sensible range.
+    size_t chainLength = count % 6;
+    INSKAffineTransform transforms[6];
+    INSKAffineTransform prefixes[6];
+    INSKAffineTransform product = INSKAffineTransformMakeIdentity();
+    for (size_t index = 0; index < chainLength; ++index) {
+        transforms[index] = INSKTestRandomTransform();
+    }
+    INSKAffineTransformConcatPrefixes(prefixes, transforms, chainLength);
+    for (size_t index = 0; index < chainLength; ++index) {
+        product = index == 0 ? transforms[0] : INSKAffineTransformConcat(product, transforms[index]);
+        INSKTestCompareTransforms("INSKAffineTransformConcatPrefixes", chainLength, index, prefixes[index], product);
+    }
+    INSKTestCompareTransforms("INSKAffineTransformConcatChain", chainLength, 0, INSKAffineTransformConcatChain(transforms, chainLength), product);
+}
+
+
+int main(void) {
+    const char *names[] = {"scalar", "SSE2", "AVX", "NEON"};
+    INSKMathBatchSetSIMDEnabled(true);
+    printf("implementation %s\n", names[INSKMathBatchGetImplementation()]);
+
+    for (int simd = 1; simd >= 0; --simd) {
+        INSKMathBatchSetSIMDEnabled(simd != 0);
+        for (size_t index = 0; index < sizeof(INSKTestCounts) / sizeof(INSKTestCounts[0]); ++index) {
+            test_batchFunctions_matchScalarFunctions(INSKTestCounts[index]);
+            test_batchFunctions_workInPlace(INSKTestCounts[index]);
+            test_affineTransformBatchFunctions_matchScalarFunctions(INSKTestCounts[index]);
+            for (int repetition = 0; repetition < 100; ++repetition) {
+                test_angleBatchFunctions_matchScalarFunctionsExactly(INSKTestCounts[index]);
+            }
+        }
+    }
+
+    if (INSKTestFailures > 0) {
+        printf("%d comparisons failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,525 @@
+// A command line tool which measures every function of INSKMath.h and INSKMathBatch.h and the fixed-point functions of INSKFixed.h and prints the nanoseconds per operation as JSON lines.
+//
+// Build it on any platform with a C99 compiler once with a double and once with a float CGFloat, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKMathBenchmark.c INSpriteKit/INSKMathBatch.c INSpriteKit/INSKFixed.c INSpriteKit/INSKInstrumentation.c -lm -o insk-math-benchmark
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -DINSK_MATH_CGFLOAT_IS_FLOAT -IINSpriteKit Tools/INSKMathBenchmark.c INSpriteKit/INSKMathBatch.c INSpriteKit/INSKFixed.c INSpriteKit/INSKInstrumentation.c -lm -o insk-math-benchmark-float
+//
+// Usage:
+//   insk-math-benchmark [-values count] [-iterations count] [-repeats count] [-filter text]
+//
+// Each line is a JSON object with the function, the variant (scalar, fixed, batch, batch-scalar or batch-soa), the CGFloat type,
+// the batch implementation and the nanoseconds per operation, which is the best of all repeats.
+// The fixed variant is the INSKFixed counterpart of the CGFloat function of the same name.
+// The lines are sorted the same way in every run, so the output of two releases can be compared with diff or joined by function and variant.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKMathBatch.h"
+#include "INSKFixed.h"
+#include "INSKInstrumentation.h"
+
+
+// The input and output values of the benchmarks.
+typedef struct {
+    size_t count;
+    CGFloat *scalars1;
+    CGFloat *scalars2;
+    CGPoint *points1;
+    CGPoint *points2;
+    CGSize *sizes;
+    INSKAffineTransform *transforms;
+    INSKPointsSoA soa1;
+    INSKPointsSoA soa2;
+    CGFloat *resultScalars;
+    CGPoint *resultPoints;
+    CGSize *resultSizes;
+    INSKAffineTransform *resultTransforms;
+    INSKPointsSoA resultSoA;
+    INSKFixed *fixedScalars1;
+    INSKFixed *fixedScalars2;
+    INSKFixedPoint *fixedPoints1;
+    INSKFixedPoint *fixedPoints2;
+    INSKFixed *fixedResultScalars;
+    INSKFixedPoint *fixedResultPoints;
+} INSKBenchmarkData;
+
+// A benchmarked function which processes all values of the data once.
+typedef void (*INSKBenchmarkFunction)(INSKBenchmarkData *data);
+
+// A line of the output.
+typedef struct {
+    const char *name;
+    const char *variant;
+    INSKBenchmarkFunction function;
+    // Whether the batch functions may use SIMD instructions.
+    bool simd;
+} INSKBenchmarkCase;
+
+// Used to keep the compiler from removing the loops.
+static volatile CGFloat INSKBenchmarkSink;
+
+
+// Defines a function which calls an INSKMath function for all values and stores the result of the given type.
+#define INSK_BENCHMARK_SCALAR(function, expression) \
+    static void INSKBenchmark##function(INSKBenchmarkData *data) { \
+        for (size_t i = 0; i < data->count; ++i) { data->resultScalars[i] = (CGFloat)(expression); } \
+    }
+#define INSK_BENCHMARK_POINT(function, expression) \
+    static void INSKBenchmark##function(INSKBenchmarkData *data) { \
+        for (size_t i = 0; i < data->count; ++i) { data->resultPoints[i] = (expression); } \
+    }
+#define INSK_BENCHMARK_SIZE(function, expression) \
+    static void INSKBenchmark##function(INSKBenchmarkData *data) { \
+        for (size_t i = 0; i < data->count; ++i) { data->resultSizes[i] = (expression); } \
+    }
+#define INSK_BENCHMARK_TRANSFORM(function, expression) \
+    static void INSKBenchmark##function(INSKBenchmarkData *data) { \
+        for (size_t i = 0; i < data->count; ++i) { data->resultTransforms[i] = (expression); } \
+    }
+#define INSK_BENCHMARK_FIXED_SCALAR(function, expression) \
+    static void INSKBenchmarkFixed##function(INSKBenchmarkData *data) { \
+        for (size_t i = 0; i < data->count; ++i) { data->fixedResultScalars[i] = (expression); } \
+    }
+#define INSK_BENCHMARK_FIXED_POINT(function, expression) \
+    static void INSKBenchmarkFixed##function(INSKBenchmarkData *data) { \
+        for (size_t i = 0; i < data->count; ++i) { data->fixedResultPoints[i] = (expression); } \
+    }
+
+
+// conversions
+
+INSK_BENCHMARK_POINT(CGPointFromSize, CGPointFromSize(data->sizes[i]))
+INSK_BENCHMARK_SIZE(CGSizeFromPoint, CGSizeFromPoint(data->points1[i]))
+INSK_BENCHMARK_POINT(CGPointFromCGVector, CGPointFromCGVector(CGVectorFromCGPoint(data->points1[i])))
+
+
+// scalar calculations
+
+INSK_BENCHMARK_SCALAR(Clamp, Clamp(data->scalars1[i], -1.0, 1.0))
+INSK_BENCHMARK_SCALAR(ScalarNearOtherWithVariance, ScalarNearOtherWithVariance(data->scalars1[i], data->scalars2[i], 0.5))
+INSK_BENCHMARK_SCALAR(ScalarNearOther, ScalarNearOther(data->scalars1[i], data->scalars2[i]))
+INSK_BENCHMARK_SCALAR(ScalarSign, ScalarSign(data->scalars1[i]))
+
+
+// CGPoint calculations
+
+INSK_BENCHMARK_POINT(CGPointOffset, CGPointOffset(data->points1[i], 1.0, 2.0))
+INSK_BENCHMARK_POINT(CGPointAdd, CGPointAdd(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointSubtract, CGPointSubtract(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointMultiply, CGPointMultiply(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointMultiplyScalar, CGPointMultiplyScalar(data->points1[i], 1.5))
+INSK_BENCHMARK_POINT(CGPointDivide, CGPointDivide(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointDivideScalar, CGPointDivideScalar(data->points1[i], 1.5))
+INSK_BENCHMARK_SCALAR(CGPointLength, CGPointLength(data->points1[i]))
+INSK_BENCHMARK_SCALAR(CGPointLengthSq, CGPointLengthSq(data->points1[i]))
+INSK_BENCHMARK_POINT(CGPointNormalize, CGPointNormalize(data->points1[i]))
+INSK_BENCHMARK_SCALAR(CGPointDistance, CGPointDistance(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_SCALAR(CGPointDistanceSq, CGPointDistanceSq(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointNegate, CGPointNegate(data->points1[i]))
+INSK_BENCHMARK_POINT(CGPointLerp, CGPointLerp(data->points1[i], data->points2[i], 0.25))
+INSK_BENCHMARK_SCALAR(CGPointDotProduct, CGPointDotProduct(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_SCALAR(CGPointCrossProduct, CGPointCrossProduct(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointProject, CGPointProject(data->points1[i], data->points2[i]))
+INSK_BENCHMARK_POINT(CGPointClamp, CGPointClamp(data->points1[i], CGPointMake(-10.0, -10.0), CGPointMake(10.0, 10.0)))
+INSK_BENCHMARK_POINT(CGPointNormalizedInRect, CGPointNormalizedInRect(data->points1[i], CGRectMake(-50.0, -50.0, 100.0, 100.0)))
+INSK_BENCHMARK_POINT(CGPointNormalizedInSize, CGPointNormalizedInSize(data->points1[i], data->sizes[i]))
+INSK_BENCHMARK_SCALAR(CGPointNearToPointWithVariance, CGPointNearToPointWithVariance(data->points1[i], data->points2[i], 0.5))
+INSK_BENCHMARK_SCALAR(CGPointNearToPoint, CGPointNearToPoint(data->points1[i], data->points2[i]))
+
+
+// CGSize calculations
+
+INSK_BENCHMARK_SCALAR(CGSizeScaleFactorToSizeAspectFit, CGSizeScaleFactorToSizeAspectFit(data->sizes[i], CGSizeMake(320.0, 480.0)))
+INSK_BENCHMARK_SIZE(CGSizeScaledToSizeAspectFit, CGSizeScaledToSizeAspectFit(data->sizes[i], CGSizeMake(320.0, 480.0)))
+INSK_BENCHMARK_SCALAR(CGSizeScaleFactorToSizeAspectFill, CGSizeScaleFactorToSizeAspectFill(data->sizes[i], CGSizeMake(320.0, 480.0)))
+INSK_BENCHMARK_SIZE(CGSizeScaledToSizeAspectFill, CGSizeScaledToSizeAspectFill(data->sizes[i], CGSizeMake(320.0, 480.0)))
+
+
+// angular convertions and calculations
+
+INSK_BENCHMARK_SCALAR(DegreesToRadians, DegreesToRadians(data->scalars1[i]))
+INSK_BENCHMARK_SCALAR(RadiansToDegrees, RadiansToDegrees(data->scalars1[i]))
+INSK_BENCHMARK_POINT(CGPointForAngle, CGPointForAngle(data->scalars1[i]))
+INSK_BENCHMARK_SCALAR(CGPointToAngle, CGPointToAngle(data->points1[i]))
+INSK_BENCHMARK_SCALAR(AngleIn2Pi, AngleIn2Pi(data->scalars1[i]))
+INSK_BENCHMARK_SCALAR(AngleInPi, AngleInPi(data->scalars1[i]))
+INSK_BENCHMARK_SCALAR(ShortestAngleBetween, ShortestAngleBetween(data->scalars1[i], data->scalars2[i]))
+
+
+// affine transformations
+
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformMake, INSKAffineTransformMake(data->scalars1[i], 0.0, 0.0, data->scalars2[i], 1.0, 2.0))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformMakeIdentity, INSKAffineTransformMakeIdentity())
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformMakeTranslation, INSKAffineTransformMakeTranslation(data->scalars1[i], data->scalars2[i]))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformMakeRotation, INSKAffineTransformMakeRotation(data->scalars1[i]))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformMakeScale, INSKAffineTransformMakeScale(data->scalars1[i], data->scalars2[i]))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformConcat, INSKAffineTransformConcat(data->transforms[i], data->transforms[data->count - 1 - i]))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformTranslate, INSKAffineTransformTranslate(data->transforms[i], 1.0, 2.0))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformRotate, INSKAffineTransformRotate(data->transforms[i], data->scalars1[i]))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformScale, INSKAffineTransformScale(data->transforms[i], 2.0, 0.5))
+INSK_BENCHMARK_TRANSFORM(INSKAffineTransformInvert, INSKAffineTransformInvert(data->transforms[i]))
+INSK_BENCHMARK_SCALAR(INSKAffineTransformIsIdentity, INSKAffineTransformIsIdentity(data->transforms[i]))
+INSK_BENCHMARK_POINT(CGPointApplyINSKAffineTransform, CGPointApplyINSKAffineTransform(data->points1[i], data->transforms[0]))
+
+
+// fixed-point functions
+
+INSK_BENCHMARK_FIXED_SCALAR(Clamp, INSKFixedClamp(data->fixedScalars1[i], -INSKFixedOne, INSKFixedOne))
+INSK_BENCHMARK_FIXED_SCALAR(ScalarSign, INSKFixedSign(data->fixedScalars1[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointAdd, INSKFixedPointAdd(data->fixedPoints1[i], data->fixedPoints2[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointSubtract, INSKFixedPointSubtract(data->fixedPoints1[i], data->fixedPoints2[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointMultiplyScalar, INSKFixedPointMultiplyScalar(data->fixedPoints1[i], INSKFixedOne * 3 / 2))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointLength, INSKFixedPointLength(data->fixedPoints1[i]))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointLengthSq, INSKFixedPointLengthSq(data->fixedPoints1[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointNormalize, INSKFixedPointNormalize(data->fixedPoints1[i]))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointDistance, INSKFixedPointDistance(data->fixedPoints1[i], data->fixedPoints2[i]))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointDistanceSq, INSKFixedPointDistanceSq(data->fixedPoints1[i], data->fixedPoints2[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointNegate, INSKFixedPointNegate(data->fixedPoints1[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointLerp, INSKFixedPointLerp(data->fixedPoints1[i], data->fixedPoints2[i], INSKFixedOne / 4))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointDotProduct, INSKFixedPointDotProduct(data->fixedPoints1[i], data->fixedPoints2[i]))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointCrossProduct, INSKFixedPointCrossProduct(data->fixedPoints1[i], data->fixedPoints2[i]))
+INSK_BENCHMARK_FIXED_POINT(CGPointForAngle, INSKFixedPointForAngle(data->fixedScalars1[i]))
+INSK_BENCHMARK_FIXED_SCALAR(CGPointToAngle, INSKFixedPointToAngle(data->fixedPoints1[i]))
+INSK_BENCHMARK_FIXED_SCALAR(AngleIn2Pi, INSKFixedAngleIn2Pi(data->fixedScalars1[i]))
+INSK_BENCHMARK_FIXED_SCALAR(AngleInPi, INSKFixedAngleInPi(data->fixedScalars1[i]))
+INSK_BENCHMARK_FIXED_SCALAR(ShortestAngleBetween, INSKFixedShortestAngleBetween(data->fixedScalars1[i], data->fixedScalars2[i]))
+
+
+// batch functions
+
+static void INSKBenchmarkPointsAdd(INSKBenchmarkData *data) {
+    INSKPointsAdd(data->resultPoints, data->points1, data->points2, data->count);
+}
+
+static void INSKBenchmarkPointsSubtract(INSKBenchmarkData *data) {
+    INSKPointsSubtract(data->resultPoints, data->points1, data->points2, data->count);
+}
+
+static void INSKBenchmarkPointsMultiplyScalar(INSKBenchmarkData *data) {
+    INSKPointsMultiplyScalar(data->resultPoints, data->points1, 1.5, data->count);
+}
+
+static void INSKBenchmarkPointsDistanceSq(INSKBenchmarkData *data) {
+    INSKPointsDistanceSq(data->resultScalars, data->points1, data->points2[0], data->count);
+}
+
+static void INSKBenchmarkPointsNormalize(INSKBenchmarkData *data) {
+    INSKPointsNormalize(data->resultPoints, data->points1, data->count);
+}
+
+static void INSKBenchmarkPointsLerp(INSKBenchmarkData *data) {
+    INSKPointsLerp(data->resultPoints, data->points1, data->points2, 0.25, data->count);
+}
+
+static void INSKBenchmarkPointsApplyAffineTransform(INSKBenchmarkData *data) {
+    INSKPointsApplyAffineTransform(data->resultPoints, data->points1, data->transforms[0], data->count);
+}
+
+static void INSKBenchmarkPointsSoAAdd(INSKBenchmarkData *data) {
+    INSKPointsSoAAdd(data->resultSoA, data->soa1, data->soa2, data->count);
+}
+
+static void INSKBenchmarkPointsSoASubtract(INSKBenchmarkData *data) {
+    INSKPointsSoASubtract(data->resultSoA, data->soa1, data->soa2, data->count);
+}
+
+static void INSKBenchmarkPointsSoAMultiplyScalar(INSKBenchmarkData *data) {
+    INSKPointsSoAMultiplyScalar(data->resultSoA, data->soa1, 1.5, data->count);
+}
+
+static void INSKBenchmarkPointsSoADistanceSq(INSKBenchmarkData *data) {
+    INSKPointsSoADistanceSq(data->resultScalars, data->soa1, data->points2[0], data->count);
+}
+
+static void INSKBenchmarkPointsSoANormalize(INSKBenchmarkData *data) {
+    INSKPointsSoANormalize(data->resultSoA, data->soa1, data->count);
+}
+
+static void INSKBenchmarkPointsSoALerp(INSKBenchmarkData *data) {
+    INSKPointsSoALerp(data->resultSoA, data->soa1, data->soa2, 0.25, data->count);
+}
+
+static void INSKBenchmarkPointsSoAApplyAffineTransform(INSKBenchmarkData *data) {
+    INSKPointsSoAApplyAffineTransform(data->resultSoA, data->soa1, data->transforms[0], data->count);
+}
+
+static void INSKBenchmarkAnglesIn2Pi(INSKBenchmarkData *data) {
+    INSKAnglesIn2Pi(data->resultScalars, data->scalars1, data->count);
+}
+
+static void INSKBenchmarkAnglesInPi(INSKBenchmarkData *data) {
+    INSKAnglesInPi(data->resultScalars, data->scalars1, data->count);
+}
+
+static void INSKBenchmarkAnglesShortestBetween(INSKBenchmarkData *data) {
+    INSKAnglesShortestBetween(data->resultScalars, data->scalars1, data->scalars2, data->count);
+}
+
+static void INSKBenchmarkAffineTransformConcatPrefixes(INSKBenchmarkData *data) {
+    INSKAffineTransformConcatPrefixes(data->resultTransforms, data->transforms, data->count);
+}
+
+static void INSKBenchmarkAffineTransformConcatChain(INSKBenchmarkData *data) {
+    data->resultTransforms[0] = INSKAffineTransformConcatChain(data->transforms, data->count);
+}
+
+
+// All benchmarks in the order of the output, the batch functions once with and once without SIMD instructions.
+// New benchmarks are appended, so the lines of older releases keep their place.
+#define INSK_BENCHMARK(function, variant) {#function, variant, INSKBenchmark##function, true}
+#define INSK_BENCHMARK_FIXED(function) {#function, "fixed", INSKBenchmarkFixed##function, true}
+#define INSK_BENCHMARK_BATCH(function) \
+    {"INSK" #function, "batch", INSKBenchmark##function, true}, \
+    {"INSK" #function, "batch-scalar", INSKBenchmark##function, false}
+#define INSK_BENCHMARK_BATCH_SOA(function) \
+    {"INSK" #function, "batch-soa", INSKBenchmark##function, true}, \
+    {"INSK" #function, "batch-soa-scalar", INSKBenchmark##function, false}
+
+static const INSKBenchmarkCase INSKBenchmarkCases[] = {
+    INSK_BENCHMARK(CGPointFromSize, "scalar"),
+    INSK_BENCHMARK(CGSizeFromPoint, "scalar"),
+    INSK_BENCHMARK(CGPointFromCGVector, "scalar"),
+    INSK_BENCHMARK(Clamp, "scalar"),
+    INSK_BENCHMARK(ScalarNearOtherWithVariance, "scalar"),
+    INSK_BENCHMARK(ScalarNearOther, "scalar"),
+    INSK_BENCHMARK(ScalarSign, "scalar"),
+    INSK_BENCHMARK(CGPointOffset, "scalar"),
+    INSK_BENCHMARK(CGPointAdd, "scalar"),
+    INSK_BENCHMARK(CGPointSubtract, "scalar"),
+    INSK_BENCHMARK(CGPointMultiply, "scalar"),
+    INSK_BENCHMARK(CGPointMultiplyScalar, "scalar"),
+    INSK_BENCHMARK(CGPointDivide, "scalar"),
+    INSK_BENCHMARK(CGPointDivideScalar, "scalar"),
+    INSK_BENCHMARK(CGPointLength, "scalar"),
+    INSK_BENCHMARK(CGPointLengthSq, "scalar"),
+    INSK_BENCHMARK(CGPointNormalize, "scalar"),
+    INSK_BENCHMARK(CGPointDistance, "scalar"),
+    INSK_BENCHMARK(CGPointDistanceSq, "scalar"),
+    INSK_BENCHMARK(CGPointNegate, "scalar"),
+    INSK_BENCHMARK(CGPointLerp, "scalar"),
+    INSK_BENCHMARK(CGPointDotProduct, "scalar"),
+    INSK_BENCHMARK(CGPointCrossProduct, "scalar"),
+    INSK_BENCHMARK(CGPointProject, "scalar"),
+    INSK_BENCHMARK(CGPointClamp, "scalar"),
+    INSK_BENCHMARK(CGPointNormalizedInRect, "scalar"),
+    INSK_BENCHMARK(CGPointNormalizedInSize, "scalar"),
+    INSK_BENCHMARK(CGPointNearToPointWithVariance, "scalar"),
+    INSK_BENCHMARK(CGPointNearToPoint, "scalar"),
+    INSK_BENCHMARK(CGSizeScaleFactorToSizeAspectFit, "scalar"),
+    INSK_BENCHMARK(CGSizeScaledToSizeAspectFit, "scalar"),
+    INSK_BENCHMARK(CGSizeScaleFactorToSizeAspectFill, "scalar"),
+    INSK_BENCHMARK(CGSizeScaledToSizeAspectFill, "scalar"),
+    INSK_BENCHMARK(DegreesToRadians, "scalar"),
+    INSK_BENCHMARK(RadiansToDegrees, "scalar"),
+    INSK_BENCHMARK(CGPointForAngle, "scalar"),
+    INSK_BENCHMARK(CGPointToAngle, "scalar"),
+    INSK_BENCHMARK(AngleIn2Pi, "scalar"),
+    INSK_BENCHMARK(AngleInPi, "scalar"),
+    INSK_BENCHMARK(ShortestAngleBetween, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformMake, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformMakeIdentity, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformMakeTranslation, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformMakeRotation, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformMakeScale, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformConcat, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformTranslate, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformRotate, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformScale, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformInvert, "scalar"),
+    INSK_BENCHMARK(INSKAffineTransformIsIdentity, "scalar"),
+    INSK_BENCHMARK(CGPointApplyINSKAffineTransform, "scalar"),
+    INSK_BENCHMARK_BATCH(PointsAdd),
+    INSK_BENCHMARK_BATCH(PointsSubtract),
+    INSK_BENCHMARK_BATCH(PointsMultiplyScalar),
+    INSK_BENCHMARK_BATCH(PointsDistanceSq),
+    INSK_BENCHMARK_BATCH(PointsNormalize),
+    INSK_BENCHMARK_BATCH(PointsLerp),
+    INSK_BENCHMARK_BATCH(PointsApplyAffineTransform),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoAAdd),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoASubtract),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoAMultiplyScalar),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoADistanceSq),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoANormalize),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoALerp),
+    INSK_BENCHMARK_BATCH_SOA(PointsSoAApplyAffineTransform),
+    INSK_BENCHMARK_BATCH(AnglesIn2Pi),
+    INSK_BENCHMARK_BATCH(AnglesInPi),
+    INSK_BENCHMARK_BATCH(AnglesShortestBetween),
+    INSK_BENCHMARK_BATCH(AffineTransformConcatPrefixes),
+    INSK_BENCHMARK_BATCH(AffineTransformConcatChain),
+    INSK_BENCHMARK_FIXED(Clamp),
+    INSK_BENCHMARK_FIXED(ScalarSign),
+    INSK_BENCHMARK_FIXED(CGPointAdd),
+    INSK_BENCHMARK_FIXED(CGPointSubtract),
+    INSK_BENCHMARK_FIXED(CGPointMultiplyScalar),
+    INSK_BENCHMARK_FIXED(CGPointLength),
+    INSK_BENCHMARK_FIXED(CGPointLengthSq),
+    INSK_BENCHMARK_FIXED(CGPointNormalize),
+    INSK_BENCHMARK_FIXED(CGPointDistance),
+    INSK_BENCHMARK_FIXED(CGPointDistanceSq),
+    INSK_BENCHMARK_FIXED(CGPointNegate),
+    INSK_BENCHMARK_FIXED(CGPointLerp),
+    INSK_BENCHMARK_FIXED(CGPointDotProduct),
+    INSK_BENCHMARK_FIXED(CGPointCrossProduct),
+    INSK_BENCHMARK_FIXED(CGPointForAngle),
+    INSK_BENCHMARK_FIXED(CGPointToAngle),
+    INSK_BENCHMARK_FIXED(AngleIn2Pi),
+    INSK_BENCHMARK_FIXED(AngleInPi),
+    INSK_BENCHMARK_FIXED(ShortestAngleBetween),
+};
+
+
+// Returns the nanoseconds per value of the fastest of several runs of a benchmark.
+static double INSKBenchmarkMeasure(const INSKBenchmarkCase *benchmark, INSKBenchmarkData *data, unsigned int iterations, unsigned int repeats) {
+    INSKMathBatchSetSIMDEnabled(benchmark->simd);
+    // A short warm up pass first, so the caches are filled.
+    for (unsigned int iteration = 0; iteration < iterations / 10 + 1; ++iteration) {
+        benchmark->function(data);
+    }
+    uint64_t best = UINT64_MAX;
+    for (unsigned int repeat = 0; repeat < repeats; ++repeat) {
+        uint64_t start = INSKInstrumentationNow();
+        for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+            benchmark->function(data);
+            INSKBenchmarkSink = data->resultScalars[iteration % data->count] + data->resultPoints[iteration % data->count].x;
+        }
+        uint64_t nanoseconds = INSKInstrumentationNow() - start;
+        if (nanoseconds < best) {
+            best = nanoseconds;
+        }
+    }
+    INSKMathBatchSetSIMDEnabled(true);
+    return (double)best / ((double)data->count * iterations);
+}
+
+static const char *INSKBenchmarkImplementationName(INSKMathBatchImplementation implementation) {
+    switch (implementation) {
+        case INSKMathBatchImplementationSSE2:
+            return "SSE2";
+        case INSKMathBatchImplementationAVX:
+            return "AVX";
+        case INSKMathBatchImplementationNEON:
+            return "NEON";
+        default:
+            return "scalar";
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t count = 1024;
+    unsigned int iterations = 2000;
+    unsigned int repeats = 5;
+    const char *filter = NULL;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-values") == 0 && argument + 1 < argc) {
+            count = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-repeats") == 0 && argument + 1 < argc) {
+            repeats = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-filter") == 0 && argument + 1 < argc) {
+            filter = argv[++argument];
+        } else {
+            fprintf(stderr, "usage: %s [-values count] [-iterations count] [-repeats count] [-filter text]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count == 0) {
+        count = 1;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    if (repeats == 0) {
+        repeats = 1;
+    }
+
+    INSKBenchmarkData data;
+    data.count = count;
+    data.scalars1 = malloc(count * sizeof(CGFloat));
+    data.scalars2 = malloc(count * sizeof(CGFloat));
+    data.points1 = malloc(count * sizeof(CGPoint));
+    data.points2 = malloc(count * sizeof(CGPoint));
+    data.sizes = malloc(count * sizeof(CGSize));
+    data.transforms = malloc(count * sizeof(INSKAffineTransform));
+    data.soa1.x = malloc(count * sizeof(CGFloat));
+    data.soa1.y = malloc(count * sizeof(CGFloat));
+    data.soa2.x = malloc(count * sizeof(CGFloat));
+    data.soa2.y = malloc(count * sizeof(CGFloat));
+    data.resultScalars = calloc(count, sizeof(CGFloat));
+    data.resultPoints = calloc(count, sizeof(CGPoint));
+    data.resultSizes = calloc(count, sizeof(CGSize));
+    data.resultTransforms = calloc(count, sizeof(INSKAffineTransform));
+    data.resultSoA.x = calloc(count, sizeof(CGFloat));
+    data.resultSoA.y = calloc(count, sizeof(CGFloat));
+    data.fixedScalars1 = malloc(count * sizeof(INSKFixed));
+    data.fixedScalars2 = malloc(count * sizeof(INSKFixed));
+    data.fixedPoints1 = malloc(count * sizeof(INSKFixedPoint));
+    data.fixedPoints2 = malloc(count * sizeof(INSKFixedPoint));
+    data.fixedResultScalars = calloc(count, sizeof(INSKFixed));
+    data.fixedResultPoints = calloc(count, sizeof(INSKFixedPoint));
+    if (data.scalars1 == NULL || data.scalars2 == NULL || data.points1 == NULL || data.points2 == NULL || data.sizes == NULL || data.transforms == NULL
+        || data.soa1.x == NULL || data.soa1.y == NULL || data.soa2.x == NULL || data.soa2.y == NULL || data.resultScalars == NULL || data.resultPoints == NULL
+        || data.resultSizes == NULL || data.resultTransforms == NULL || data.resultSoA.x == NULL || data.resultSoA.y == NULL
+        || data.fixedScalars1 == NULL || data.fixedScalars2 == NULL || data.fixedPoints1 == NULL || data.fixedPoints2 == NULL
+        || data.fixedResultScalars == NULL || data.fixedResultPoints == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    // Angles of up to two turns in both directions and points in all quadrants with no zero coordinates, so nothing is divided by zero.
+    for (size_t index = 0; index < count; ++index) {
+        CGFloat angle = -2.0 * M_PI_X_2 + 4.0 * M_PI_X_2 * (CGFloat)index / (CGFloat)count;
+        data.scalars1[index] = angle;
+        data.scalars2[index] = -angle * 0.5 + 0.1;
+        data.points1[index] = CGPointMultiplyScalar(CGPointForAngle(angle + 0.1), 1.0 + (CGFloat)(index % 100));
+        data.points2[index] = CGPointMake(1.0 + (CGFloat)(index % 7), -2.0 - (CGFloat)(index % 11));
+        data.sizes[index] = CGSizeMake(10.0 + (CGFloat)(index % 50), 20.0 + (CGFloat)(index % 30));
+        data.transforms[index] = INSKAffineTransformScale(INSKAffineTransformMakeRotation(angle), 1.0 + (CGFloat)(index % 3) * 0.001, 1.0);
+        data.soa1.x[index] = data.points1[index].x;
+        data.soa1.y[index] = data.points1[index].y;
+        data.soa2.x[index] = data.points2[index].x;
+        data.soa2.y[index] = data.points2[index].y;
+        data.fixedScalars1[index] = INSKFixedFromCGFloat(data.scalars1[index]);
+        data.fixedScalars2[index] = INSKFixedFromCGFloat(data.scalars2[index]);
+        data.fixedPoints1[index] = INSKFixedPointFromCGPoint(data.points1[index]);
+        data.fixedPoints2[index] = INSKFixedPointFromCGPoint(data.points2[index]);
+    }
+
+    const char *cgfloat = CGFLOAT_IS_DOUBLE ? "double" : "float";
+    const char *implementation = INSKBenchmarkImplementationName(INSKMathBatchGetImplementation());
+    for (size_t index = 0; index < sizeof(INSKBenchmarkCases) / sizeof(INSKBenchmarkCases[0]); ++index) {
+        const INSKBenchmarkCase *benchmark = &INSKBenchmarkCases[index];
+        if (filter != NULL && strstr(benchmark->name, filter) == NULL) {
+            continue;
+        }
+        double nanoseconds = INSKBenchmarkMeasure(benchmark, &data, iterations, repeats);
+        printf("{\"function\":\"%s\",\"variant\":\"%s\",\"cgfloat\":\"%s\",\"implementation\":\"%s\",\"values\":%zu,\"iterations\":%u,\"nsPerOp\":%.3f}\n",
+               benchmark->name, benchmark->variant, cgfloat, benchmark->simd ? implementation : "scalar", count, iterations, nanoseconds);
+    }
+
+    free(data.fixedResultPoints);
+    free(data.fixedResultScalars);
+    free(data.fixedPoints2);
+    free(data.fixedPoints1);
+    free(data.fixedScalars2);
+    free(data.fixedScalars1);
+    free(data.resultSoA.y);
+    free(data.resultSoA.x);
+    free(data.resultTransforms);
+    free(data.resultSizes);
+    free(data.resultPoints);
+    free(data.resultScalars);
+    free(data.soa2.y);
+    free(data.soa2.x);
+    free(data.soa1.y);
+    free(data.soa1.x);
+    free(data.transforms);
+    free(data.sizes);
+    free(data.points2);
+    free(data.points1);
+    free(data.scalars2);
+    free(data.scalars1);
+    return 0;
+}
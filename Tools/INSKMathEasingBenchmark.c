@@ -0,0 +1,147 @@
+// A command line tool which measures the accuracy and speed of the easing curves of INSKMathEasing.h and their lookup tables.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKMathEasingBenchmark.c INSpriteKit/INSKMathEasing.c INSpriteKit/INSKInstrumentation.c -lm -o insk-math-easing-benchmark
+//
+// Usage:
+//   insk-math-easing-benchmark [-values count] [-iterations count]
+//
+// Prints for each curve the nanoseconds per value of INSKEasingCurveEvaluate(), INSKEasingCurveEvaluateValues() and
+// INSKEasingTableEvaluateValues() with tables of several sizes, followed by the maximum error of each table.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKMathEasing.h"
+#include "INSKInstrumentation.h"
+
+
+// The sample counts of the measured tables.
+static const size_t INSKBenchmarkTableSizes[] = {16, 64, 256, 1024};
+#define INSKBenchmarkTableSizeCount (sizeof(INSKBenchmarkTableSizes) / sizeof(INSKBenchmarkTableSizes[0]))
+
+// The number of progresses the maximum error of the tables is measured at.
+#define INSKBenchmarkErrorSampleCount 100000
+
+static const char *const INSKBenchmarkTypeNames[] = {
+    "Linear",
+    "QuadIn", "QuadOut", "QuadInOut",
+    "CubicIn", "CubicOut", "CubicInOut",
+    "BackIn", "BackOut", "BackInOut",
+    "ElasticIn", "ElasticOut", "ElasticInOut",
+    "SpringIn", "SpringOut", "SpringInOut",
+    "CubicBezier"
+};
+#define INSKBenchmarkTypeCount (sizeof(INSKBenchmarkTypeNames) / sizeof(INSKBenchmarkTypeNames[0]))
+
+// The ways of evaluating a curve.
+typedef enum {
+    INSKBenchmarkModeScalar = 0,
+    INSKBenchmarkModeBatch,
+    INSKBenchmarkModeTable
+} INSKBenchmarkMode;
+
+// Used to keep the compiler from removing the loops.
+static volatile CGFloat INSKBenchmarkSink;
+
+
+// Returns the nanoseconds per value of evaluating a curve or a table.
+static double INSKBenchmarkMeasure(INSKBenchmarkMode mode, INSKEasingCurve curve, const INSKEasingTable *table, const CGFloat *times, CGFloat *values, size_t count, unsigned int iterations) {
+    uint64_t start = INSKInstrumentationNow();
+    for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+        switch (mode) {
+            case INSKBenchmarkModeScalar:
+                for (size_t index = 0; index < count; ++index) {
+                    values[index] = INSKEasingCurveEvaluate(curve, times[index]);
+                }
+                break;
+            case INSKBenchmarkModeBatch:
+                INSKEasingCurveEvaluateValues(values, times, curve, count);
+                break;
+            default:
+                INSKEasingTableEvaluateValues(values, times, table, count);
+                break;
+        }
+        INSKBenchmarkSink = values[iteration % count];
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    return (double)nanoseconds / ((double)count * iterations);
+}
+
+// Returns the biggest difference between a table and its curve.
+static double INSKBenchmarkMaxError(INSKEasingCurve curve, const INSKEasingTable *table) {
+    double maxError = 0.0;
+    for (int index = 0; index <= INSKBenchmarkErrorSampleCount; ++index) {
+        CGFloat t = (CGFloat)index / INSKBenchmarkErrorSampleCount;
+        double error = fabs((double)INSKEasingTableEvaluate(table, t) - (double)INSKEasingCurveEvaluate(curve, t));
+        maxError = MAX(maxError, error);
+    }
+    return maxError;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t count = 4096;
+    unsigned int iterations = 2000;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-values") == 0 && argument + 1 < argc) {
+            count = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-values count] [-iterations count]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count == 0) {
+        count = 1;
+    }
+
+    CGFloat *times = (CGFloat *)malloc(count * sizeof(CGFloat));
+    CGFloat *values = (CGFloat *)calloc(count, sizeof(CGFloat));
+    if (times == NULL || values == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    // Tweens at all stages, not in order, like many elements started at different times.
+    for (size_t index = 0; index < count; ++index) {
+        times[index] = (CGFloat)((index * 7919) % count) / (CGFloat)count;
+    }
+
+    printf("values %zu iterations %u\n", count, iterations);
+    printf("%-14s %9s %9s", "ns/value", "scalar", "batch");
+    for (size_t size = 0; size < INSKBenchmarkTableSizeCount; ++size) {
+        printf(" %8s%-4zu", "table", INSKBenchmarkTableSizes[size]);
+    }
+    printf("   max error of the tables\n");
+
+    for (size_t type = 0; type < INSKBenchmarkTypeCount; ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake((INSKEasingType)type);
+        // A short warm up pass first, so the caches are filled.
+        INSKBenchmarkMeasure(INSKBenchmarkModeScalar, curve, NULL, times, values, count, iterations / 10 + 1);
+        double scalar = INSKBenchmarkMeasure(INSKBenchmarkModeScalar, curve, NULL, times, values, count, iterations);
+        double batch = INSKBenchmarkMeasure(INSKBenchmarkModeBatch, curve, NULL, times, values, count, iterations);
+        printf("%-14s %9.2f %9.2f", INSKBenchmarkTypeNames[type], scalar, batch);
+
+        double errors[INSKBenchmarkTableSizeCount];
+        for (size_t size = 0; size < INSKBenchmarkTableSizeCount; ++size) {
+            INSKEasingTable *table = INSKEasingTableCreate(curve, INSKBenchmarkTableSizes[size]);
+            if (table == NULL) {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+            printf(" %12.2f", INSKBenchmarkMeasure(INSKBenchmarkModeTable, curve, table, times, values, count, iterations));
+            errors[size] = INSKBenchmarkMaxError(curve, table);
+            INSKEasingTableDestroy(table);
+        }
+        printf("  ");
+        for (size_t size = 0; size < INSKBenchmarkTableSizeCount; ++size) {
+            printf(" %8.1e", errors[size]);
+        }
+        printf("\n");
+    }
+
+    free(values);
+    free(times);
+    return 0;
+}
@@ -0,0 +1,264 @@
+// Tests the easing curves and lookup tables of INSKMathEasing.h against their formulas and checks that the batch functions match the scalar ones.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKMathEasingTests.c INSpriteKit/INSKMathEasing.c -lm -o insk-math-easing-tests && ./insk-math-easing-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKMathEasing.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The number of sampled progresses per curve.
+#define INSKTestSampleCount 1000
+
+// The allowed error of values calculated in a different but equivalent way, which is bigger with a float CGFloat.
+// Rounding the progress to a float changes the values of Bézier curves by the precision times the slope, which is huge where they are steep.
+#if CGFLOAT_IS_DOUBLE
+#define INSKTestTolerance 1e-9
+#define INSKTestProgressPrecision 0.0
+#else
+#define INSKTestTolerance 1e-5
+#define INSKTestProgressPrecision 1e-6
+#endif
+
+// The number of easing types.
+#define INSKTestTypeCount (INSKEasingTypeCubicBezier + 1)
+
+
+// endpoints
+
+static void test_allCurves_startAtZeroAndEndAtOne(void) {
+    for (int type = 0; type < INSKTestTypeCount; ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake((INSKEasingType)type);
+        INSK_TEST_ASSERT(INSKEasingCurveEvaluate(curve, 0.0) == 0.0, "type %d doesn't start at 0 but %g", type, (double)INSKEasingCurveEvaluate(curve, 0.0));
+        INSK_TEST_ASSERT(INSKEasingCurveEvaluate(curve, 1.0) == 1.0, "type %d doesn't end at 1 but %g", type, (double)INSKEasingCurveEvaluate(curve, 1.0));
+        INSK_TEST_ASSERT(INSKEasingCurveEvaluate(curve, -3.0) == 0.0, "type %d doesn't clamp negative progresses", type);
+        INSK_TEST_ASSERT(INSKEasingCurveEvaluate(curve, 7.0) == 1.0, "type %d doesn't clamp big progresses", type);
+        INSK_TEST_ASSERT(INSKEasingCurveEvaluate(curve, NAN) == 0.0, "type %d doesn't treat NaN as 0", type);
+    }
+}
+
+static void test_inOutCurves_arePointSymmetric(void) {
+    const INSKEasingType types[] = {INSKEasingTypeQuadInOut, INSKEasingTypeCubicInOut, INSKEasingTypeBackInOut, INSKEasingTypeElasticInOut, INSKEasingTypeSpringInOut};
+    for (size_t type = 0; type < sizeof(types) / sizeof(types[0]); ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake(types[type]);
+        for (int index = 0; index <= INSKTestSampleCount; ++index) {
+            CGFloat t = (CGFloat)index / INSKTestSampleCount;
+            double sum = INSKEasingCurveEvaluate(curve, t) + INSKEasingCurveEvaluate(curve, 1.0 - t);
+            INSK_TEST_ASSERT(fabs(sum - 1.0) < INSKTestTolerance * 10.0, "type %d isn't symmetric at %g", (int)types[type], (double)t);
+        }
+    }
+}
+
+
+// formulas
+
+static void test_polynomialCurves_matchFormulas(void) {
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeLinear), 0.3) == (CGFloat)0.3, "linear isn't the progress");
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeQuadIn), 0.5) == 0.25, "QuadIn(0.5) is wrong");
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeQuadOut), 0.5) == 0.75, "QuadOut(0.5) is wrong");
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeQuadInOut), 0.25) == 0.125, "QuadInOut(0.25) is wrong");
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeCubicIn), 0.5) == 0.125, "CubicIn(0.5) is wrong");
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeCubicOut), 0.5) == 0.875, "CubicOut(0.5) is wrong");
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeCubicInOut), 0.75) == 0.9375, "CubicInOut(0.75) is wrong");
+
+    // The default back curve overshoots by 10%.
+    INSKEasingCurve back = INSKEasingCurveMake(INSKEasingTypeBackOut);
+    double maximum = 0.0;
+    for (int index = 0; index <= INSKTestSampleCount; ++index) {
+        CGFloat t = (CGFloat)index / INSKTestSampleCount;
+        double value = INSKEasingCurveEvaluate(back, t);
+        double s = 1.70158;
+        double u = t - 1.0;
+        double expected = u * u * ((s + 1.0) * u + s) + 1.0;
+        INSK_TEST_ASSERT(fabs(value - expected) < INSKTestTolerance, "BackOut(%g) is %g instead of %g", (double)t, value, expected);
+        maximum = MAX(maximum, value);
+    }
+    INSK_TEST_ASSERT(fabs(maximum - 1.1) < 0.001, "BackOut overshoots to %g", maximum);
+    INSKEasingCurve cubic = INSKEasingCurveMakeBack(INSKEasingTypeBackIn, 0.0);
+    INSK_TEST_ASSERT(fabs(INSKEasingCurveEvaluate(cubic, 0.4) - 0.064) < INSKTestTolerance, "back without overshoot isn't cubic");
+}
+
+static void test_elasticCurve_matchesFormula(void) {
+    INSKEasingCurve curve = INSKEasingCurveMake(INSKEasingTypeElasticOut);
+    for (int index = 1; index < INSKTestSampleCount; ++index) {
+        CGFloat t = (CGFloat)index / INSKTestSampleCount;
+        double expected = pow(2.0, -10.0 * t) * sin((10.0 * t - 0.75) * (2.0 * M_PI / 3.0)) + 1.0;
+        double value = INSKEasingCurveEvaluate(curve, t);
+        INSK_TEST_ASSERT(fabs(value - expected) < INSKTestTolerance * 10.0, "ElasticOut(%g) is %g instead of %g", (double)t, value, expected);
+    }
+    // Amplitudes less than 1 are raised to 1.
+    INSKEasingCurve small = INSKEasingCurveMakeElastic(INSKEasingTypeElasticIn, 0.2, 0.3);
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(small, 0.7) == INSKEasingCurveEvaluate(INSKEasingCurveMake(INSKEasingTypeElasticIn), 0.7), "amplitude isn't raised to 1");
+}
+
+// Integrates the spring with small Runge-Kutta steps and compares the positions with the closed form of the curve.
+static void INSKTestSpringMatchesIntegration(CGFloat damping, CGFloat frequency) {
+    INSKEasingCurve curve = INSKEasingCurveMakeSpring(INSKEasingTypeSpringOut, damping, frequency);
+    const int steps = 100000;
+    double step = 1.0 / steps;
+    double position = 0.0;
+    double velocity = 0.0;
+    for (int index = 1; index < steps; ++index) {
+        // x'' = frequency^2 * (1 - x) - 2 * damping * frequency * x'
+        double k1x = velocity;
+        double k1v = frequency * frequency * (1.0 - position) - 2.0 * damping * frequency * velocity;
+        double k2x = velocity + 0.5 * step * k1v;
+        double k2v = frequency * frequency * (1.0 - position - 0.5 * step * k1x) - 2.0 * damping * frequency * k2x;
+        double k3x = velocity + 0.5 * step * k2v;
+        double k3v = frequency * frequency * (1.0 - position - 0.5 * step * k2x) - 2.0 * damping * frequency * k3x;
+        double k4x = velocity + step * k3v;
+        double k4v = frequency * frequency * (1.0 - position - step * k3x) - 2.0 * damping * frequency * k4x;
+        position += step / 6.0 * (k1x + 2.0 * k2x + 2.0 * k3x + k4x);
+        velocity += step / 6.0 * (k1v + 2.0 * k2v + 2.0 * k3v + k4v);
+        if (index % 1000 == 0) {
+            double value = INSKEasingCurveEvaluate(curve, (CGFloat)(index * step));
+            INSK_TEST_ASSERT(fabs(value - position) < 1e-5, "spring %g/%g at %g is %g instead of %g", (double)damping, (double)frequency, index * step, value, position);
+        }
+    }
+}
+
+static void test_springCurves_matchIntegration(void) {
+    INSKTestSpringMatchesIntegration(0.5, 15.0);
+    INSKTestSpringMatchesIntegration(0.2, 30.0);
+    INSKTestSpringMatchesIntegration(1.0, 10.0);
+    INSKTestSpringMatchesIntegration(2.5, 20.0);
+    INSKTestSpringMatchesIntegration(0.0, 5.0);
+}
+
+// Compares the solved Bézier curve with the points of the curve's parametric form.
+static void INSKTestBezierMatchesParametricForm(CGFloat x1, CGFloat y1, CGFloat x2, CGFloat y2) {
+    INSKEasingCurve curve = INSKEasingCurveMakeCubicBezier(x1, y1, x2, y2);
+    for (int index = 0; index <= INSKTestSampleCount; ++index) {
+        double s = (double)index / INSKTestSampleCount;
+        double u = 1.0 - s;
+        double x = 3.0 * u * u * s * x1 + 3.0 * u * s * s * x2 + s * s * s;
+        double y = 3.0 * u * u * s * y1 + 3.0 * u * s * s * y2 + s * s * s;
+        double slopeX = 3.0 * u * u * x1 + 6.0 * u * s * (x2 - x1) + 3.0 * s * s * (1.0 - x2);
+        double slopeY = 3.0 * u * u * y1 + 6.0 * u * s * (y2 - y1) + 3.0 * s * s * (1.0 - y2);
+        double tolerance = 1e-6 + INSKTestProgressPrecision * fabs(slopeY) / MAX(fabs(slopeX), 1e-3);
+        double value = INSKEasingCurveEvaluate(curve, (CGFloat)x);
+        INSK_TEST_ASSERT(fabs(value - y) < tolerance, "bezier (%g, %g, %g, %g) at %g is %g instead of %g", (double)x1, (double)y1, (double)x2, (double)y2, x, value, y);
+    }
+}
+
+static void test_cubicBezierCurves_matchParametricForm(void) {
+    INSKTestBezierMatchesParametricForm(0.25, 0.1, 0.25, 1.0);
+    INSKTestBezierMatchesParametricForm(0.42, 0.0, 1.0, 1.0);
+    INSKTestBezierMatchesParametricForm(0.0, 0.0, 0.58, 1.0);
+    INSKTestBezierMatchesParametricForm(0.68, -0.55, 0.27, 1.55);
+    // Flat slopes at the ends, where Newton-Raphson needs the bisection fallback.
+    INSKTestBezierMatchesParametricForm(1.0, 0.0, 0.0, 1.0);
+    INSKTestBezierMatchesParametricForm(0.0, 1.0, 1.0, 0.0);
+
+    INSKEasingCurve linear = INSKEasingCurveMakeCubicBezier(0.0, 0.0, 1.0, 1.0);
+    INSK_TEST_ASSERT(fabs(INSKEasingCurveEvaluate(linear, 0.37) - 0.37) < 1e-6, "linear bezier isn't the progress");
+    INSKEasingCurve clamped = INSKEasingCurveMakeCubicBezier(-1.0, 0.0, 2.0, 1.0);
+    INSKEasingCurve expected = INSKEasingCurveMakeCubicBezier(0.0, 0.0, 1.0, 1.0);
+    INSK_TEST_ASSERT(INSKEasingCurveEvaluate(clamped, 0.6) == INSKEasingCurveEvaluate(expected, 0.6), "control points aren't clamped");
+}
+
+
+// batches
+
+static void test_batchEvaluation_matchesScalarEvaluation(void) {
+    CGFloat *times = (CGFloat *)malloc(INSKTestSampleCount * sizeof(CGFloat));
+    CGFloat *values = (CGFloat *)malloc(INSKTestSampleCount * sizeof(CGFloat));
+    for (int index = 0; index < INSKTestSampleCount; ++index) {
+        times[index] = -0.1 + 1.2 * index / (INSKTestSampleCount - 1);
+    }
+    times[0] = NAN;
+    for (int type = 0; type < INSKTestTypeCount; ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake((INSKEasingType)type);
+        INSKEasingCurveEvaluateValues(values, times, curve, INSKTestSampleCount);
+        for (int index = 0; index < INSKTestSampleCount; ++index) {
+            INSK_TEST_ASSERT(values[index] == INSKEasingCurveEvaluate(curve, times[index]), "type %d differs at %g", type, (double)times[index]);
+        }
+    }
+    // In place.
+    INSKEasingCurve curve = INSKEasingCurveMake(INSKEasingTypeCubicOut);
+    INSKEasingCurveEvaluateValues(values, times, curve, INSKTestSampleCount);
+    INSKEasingCurveEvaluateValues(times, times, curve, INSKTestSampleCount);
+    INSK_TEST_ASSERT(memcmp(values, times, INSKTestSampleCount * sizeof(CGFloat)) == 0, "evaluation in place differs");
+    free(values);
+    free(times);
+}
+
+
+// tables
+
+static void test_tables_interpolateCurves(void) {
+    INSK_TEST_ASSERT(INSKEasingTableCreate(INSKEasingCurveMake(INSKEasingTypeQuadIn), 1) == NULL, "table with 1 sample created");
+    INSK_TEST_ASSERT(INSKEasingTableCreateForTween(INSKEasingCurveMake(INSKEasingTypeQuadIn), 0.0, 60.0) == NULL, "table without frames created");
+    INSK_TEST_ASSERT(INSKEasingTableCreateForTween(INSKEasingCurveMake(INSKEasingTypeQuadIn), NAN, 60.0) == NULL, "table for NaN duration created");
+    INSKEasingTableDestroy(NULL);
+
+    for (int type = 0; type < INSKTestTypeCount; ++type) {
+        INSKEasingCurve curve = INSKEasingCurveMake((INSKEasingType)type);
+        INSKEasingTable *table = INSKEasingTableCreate(curve, 1024);
+        INSK_TEST_ASSERT(table != NULL && INSKEasingTableSampleCount(table) == 1024, "table not created");
+        INSK_TEST_ASSERT(INSKEasingTableEvaluate(table, 0.0) == 0.0 && INSKEasingTableEvaluate(table, 1.0) == 1.0, "table of type %d has wrong endpoints", type);
+        INSK_TEST_ASSERT(INSKEasingTableEvaluate(table, 2.0) == 1.0 && INSKEasingTableEvaluate(table, NAN) == 0.0, "table of type %d doesn't clamp", type);
+        double maxError = 0.0;
+        for (int index = 0; index <= INSKTestSampleCount; ++index) {
+            CGFloat t = (CGFloat)index / INSKTestSampleCount;
+            maxError = MAX(maxError, fabs(INSKEasingTableEvaluate(table, t) - INSKEasingCurveEvaluate(curve, t)));
+        }
+        // The error is at most h^2 / 8 of the biggest second derivative, which is about 1000 for the in-out versions of the elastic and spring curves.
+        INSK_TEST_ASSERT(maxError < 1000.0 / (8.0 * 1023.0 * 1023.0), "table of type %d has an error of %g", type, maxError);
+        INSKEasingTableDestroy(table);
+    }
+}
+
+static void test_tweenTables_hitFramesExactly(void) {
+    INSKEasingCurve curve = INSKEasingCurveMake(INSKEasingTypeSpringOut);
+    INSKEasingTable *table = INSKEasingTableCreateForTween(curve, 0.5, 60.0);
+    INSK_TEST_ASSERT(table != NULL && INSKEasingTableSampleCount(table) == 31, "0.5s at 60fps has %zu samples", table != NULL ? INSKEasingTableSampleCount(table) : 0);
+    CGFloat times[31];
+    CGFloat values[31];
+    for (int frame = 0; frame <= 30; ++frame) {
+        times[frame] = (CGFloat)frame / 30.0;
+        double expected = INSKEasingCurveEvaluate(curve, times[frame]);
+        INSK_TEST_ASSERT(fabs(INSKEasingTableEvaluate(table, times[frame]) - expected) < INSKTestTolerance, "frame %d is interpolated", frame);
+    }
+    INSKEasingTableEvaluateValues(values, times, table, 31);
+    for (int frame = 0; frame <= 30; ++frame) {
+        INSK_TEST_ASSERT(values[frame] == INSKEasingTableEvaluate(table, times[frame]), "table batch differs at frame %d", frame);
+    }
+    INSKEasingTableDestroy(table);
+}
+
+
+int main(void) {
+    test_allCurves_startAtZeroAndEndAtOne();
+    test_inOutCurves_arePointSymmetric();
+    test_polynomialCurves_matchFormulas();
+    test_elasticCurve_matchesFormula();
+    test_springCurves_matchIntegration();
+    test_cubicBezierCurves_matchParametricForm();
+    test_batchEvaluation_matchesScalarEvaluation();
+    test_tables_interpolateCurves();
+    test_tweenTables_hitFramesExactly();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+// A command line tool which measures the fast approximations of INSKMathFast.h against the exact INSKMath functions calling libm.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKMathFastBenchmark.c INSpriteKit/INSKInstrumentation.c -lm -o insk-math-fast-benchmark
+//
+// Usage:
+//   insk-math-fast-benchmark [-values count] [-iterations count]
+//
+// Prints the nanoseconds per call of the exact and the fast function and the speedup.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKMathFast.h"
+#include "INSKInstrumentation.h"
+
+
+// The benchmarked pairs of functions.
+typedef enum {
+    INSKBenchmarkForAngle = 0,
+    INSKBenchmarkToAngle,
+    INSKBenchmarkNormalize,
+    INSKBenchmarkFunctionCount
+} INSKBenchmarkFunction;
+
+static const char *const INSKBenchmarkFunctionNames[INSKBenchmarkFunctionCount] = {"CGPointForAngle", "CGPointToAngle", "CGPointNormalize"};
+
+// Used to keep the compiler from removing the loops.
+static volatile CGFloat INSKBenchmarkSink;
+
+
+// Returns the nanoseconds per call of the exact or fast version of a function.
+static double INSKBenchmarkMeasure(INSKBenchmarkFunction function, bool fast, const CGFloat *angles, const CGPoint *points, CGPoint *results, size_t count, unsigned int iterations) {
+    uint64_t start = INSKInstrumentationNow();
+    for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+        for (size_t index = 0; index < count; ++index) {
+            switch (function) {
+                case INSKBenchmarkForAngle:
+                    results[index] = fast ? CGPointForAngleFast(angles[index]) : CGPointForAngle(angles[index]);
+                    break;
+                case INSKBenchmarkToAngle:
+                    results[index].x = fast ? CGPointToAngleFast(points[index]) : CGPointToAngle(points[index]);
+                    break;
+                default:
+                    results[index] = fast ? CGPointNormalizeFast(points[index]) : CGPointNormalize(points[index]);
+                    break;
+            }
+        }
+        INSKBenchmarkSink = results[iteration % count].x;
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    return (double)nanoseconds / ((double)count * iterations);
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t count = 4096;
+    unsigned int iterations = 2000;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-values") == 0 && argument + 1 < argc) {
+            count = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-values count] [-iterations count]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count == 0) {
+        count = 1;
+    }
+
+    CGFloat *angles = malloc(count * sizeof(CGFloat));
+    CGPoint *points = malloc(count * sizeof(CGPoint));
+    CGPoint *results = calloc(count, sizeof(CGPoint));
+    if (angles == NULL || points == NULL || results == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (size_t index = 0; index < count; ++index) {
+        angles[index] = -M_PI + 2.0 * M_PI * (double)index / (double)count;
+        points[index] = CGPointMultiplyScalar(CGPointForAngle(angles[index]), 1.0 + (double)(index % 100));
+    }
+
+    printf("values %zu iterations %u\n", count, iterations);
+    printf("%-18s %12s %12s %10s\n", "ns/call", "libm", "fast", "speedup");
+    for (int function = 0; function < INSKBenchmarkFunctionCount; ++function) {
+        // A short warm up pass first, so the caches are filled.
+        INSKBenchmarkMeasure((INSKBenchmarkFunction)function, false, angles, points, results, count, iterations / 10 + 1);
+        double exact = INSKBenchmarkMeasure((INSKBenchmarkFunction)function, false, angles, points, results, count, iterations);
+        double fast = INSKBenchmarkMeasure((INSKBenchmarkFunction)function, true, angles, points, results, count, iterations);
+        printf("%-18s %12.2f %12.2f %9.2fx\n", INSKBenchmarkFunctionNames[function], exact, fast, fast > 0.0 ? exact / fast : 0.0);
+    }
+
+    free(results);
+    free(points);
+    free(angles);
+    return 0;
+}
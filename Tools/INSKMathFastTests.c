@@ -0,0 +1,181 @@
+// Checks the documented maximum errors of the fast approximations of INSKMathFast.h against libm on millions of sampled values.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKMathFastTests.c -lm -o insk-math-fast-tests && ./insk-math-fast-tests
+//
+// The tool prints the maximum error found for each function and exits with 1 if any error is bigger than documented.
+
+#include <stdio.h>
+#include <math.h>
+#include "INSKMathFast.h"
+
+
+// The number of samples per sweep.
+#define INSKTestSampleCount 10000000
+
+// The documented maximum errors.
+#define INSKTestSinCosMaxError 1e-11
+#define INSKTestAtan2MaxError 1e-7
+#define INSKTestReciprocalSqrtMaxError 2e-7
+
+// The number of functions exceeding their maximum error.
+static int INSKTestFailures = 0;
+
+
+static void INSKTestReport(const char *name, double maxError, double at, double documentedError) {
+    bool failed = !(maxError <= documentedError);
+    printf("%-22s max error %.3g at %.17g, documented %.3g%s\n", name, maxError, at, documentedError, failed ? " FAILED" : "");
+    if (failed) {
+        INSKTestFailures++;
+    }
+}
+
+// Returns the absolute error of SinCosFast() for an angle, the bigger one of both values.
+static double INSKTestSinCosError(double angle) {
+    CGFloat sine;
+    CGFloat cosine;
+    SinCosFast(angle, &sine, &cosine);
+    return fmax(fabs(sine - sin(angle)), fabs(cosine - cos(angle)));
+}
+
+static void test_sinCosFast_staysInMaxError(void) {
+    double maxError = 0.0;
+    double at = 0.0;
+    // A dense sweep over the angles used most and a sparse one over all angles calculated with the polynomials.
+    for (long index = 0; index <= INSKTestSampleCount; ++index) {
+        double angles[2] = {
+            -4.0 * M_PI + 8.0 * M_PI * index / INSKTestSampleCount,
+            -INSK_FAST_ANGLE_LIMIT + 2.0 * INSK_FAST_ANGLE_LIMIT * index / INSKTestSampleCount
+        };
+        for (int sweep = 0; sweep < 2; ++sweep) {
+            double error = INSKTestSinCosError(angles[sweep]);
+            if (!(error <= maxError)) {
+                maxError = error;
+                at = angles[sweep];
+            }
+        }
+    }
+    // The boundaries of the quadrants and beyond the limit.
+    for (long quadrant = -8; quadrant <= 8; ++quadrant) {
+        double angles[3] = {quadrant * M_PI_4, nextafter(quadrant * M_PI_4, -INFINITY), nextafter(quadrant * M_PI_4, INFINITY)};
+        for (int index = 0; index < 3; ++index) {
+            double error = INSKTestSinCosError(angles[index]);
+            if (!(error <= maxError)) {
+                maxError = error;
+                at = angles[index];
+            }
+        }
+    }
+    double beyondLimit = INSKTestSinCosError(INSK_FAST_ANGLE_LIMIT * 10.0);
+    if (!(beyondLimit <= maxError)) {
+        maxError = beyondLimit;
+        at = INSK_FAST_ANGLE_LIMIT * 10.0;
+    }
+    INSKTestReport("SinCosFast", maxError, at, INSKTestSinCosMaxError);
+}
+
+static void test_atan2Fast_staysInMaxError(void) {
+    double maxError = 0.0;
+    double at = 0.0;
+    for (long index = 0; index <= INSKTestSampleCount; ++index) {
+        double angle = -M_PI + 2.0 * M_PI * index / INSKTestSampleCount;
+        // Vectors of very different lengths.
+        double length = ldexp(1.0 + (index % 1000) / 1000.0, (int)(index % 200) - 100);
+        double x = cos(angle) * length;
+        double y = sin(angle) * length;
+        double error = fabs(Atan2Fast(y, x) - atan2(y, x));
+        if (!(error <= maxError)) {
+            maxError = error;
+            at = angle;
+        }
+    }
+    // Zeros, infinities and NaNs are passed to atan2().
+    double specials[] = {0.0, -0.0, 1.0, -1.0, INFINITY, -INFINITY};
+    for (int yIndex = 0; yIndex < 6; ++yIndex) {
+        for (int xIndex = 0; xIndex < 6; ++xIndex) {
+            double y = specials[yIndex];
+            double x = specials[xIndex];
+            double error = fabs(Atan2Fast(y, x) - atan2(y, x));
+            if (!(error <= maxError)) {
+                maxError = error;
+                at = atan2(y, x);
+            }
+        }
+    }
+    if (!isnan(Atan2Fast(NAN, 1.0)) || !isnan(Atan2Fast(1.0, NAN))) {
+        maxError = NAN;
+    }
+    INSKTestReport("Atan2Fast", maxError, at, INSKTestAtan2MaxError);
+}
+
+static void test_reciprocalSqrtFast_staysInMaxError(void) {
+    double maxError = 0.0;
+    double at = 0.0;
+    // All exponents of normal doubles, so the paths for values inside and outside of the float range are checked.
+    for (long index = 0; index < INSKTestSampleCount; ++index) {
+        double value = ldexp(1.0 + (double)index / INSKTestSampleCount, (int)(index % 2044) - 1021);
+        double error = fabs(ReciprocalSqrtFast(value) * sqrt(value) - 1.0);
+        if (!(error <= maxError)) {
+            maxError = error;
+            at = value;
+        }
+    }
+    INSKTestReport("ReciprocalSqrtFast", maxError, at, INSKTestReciprocalSqrtMaxError);
+}
+
+static void test_pointFunctions_stayInMaxError(void) {
+    double forAngleError = 0.0;
+    double toAngleError = 0.0;
+    double normalizeError = 0.0;
+    double forAngleAt = 0.0;
+    double toAngleAt = 0.0;
+    double normalizeAt = 0.0;
+    for (long index = 0; index <= INSKTestSampleCount / 10; ++index) {
+        double angle = -M_PI + 2.0 * M_PI * index / (INSKTestSampleCount / 10);
+        CGPoint fast = CGPointForAngleFast(angle);
+        CGPoint exact = CGPointForAngle(angle);
+        double error = fmax(fabs(fast.x - exact.x), fabs(fast.y - exact.y));
+        if (!(error <= forAngleError)) {
+            forAngleError = error;
+            forAngleAt = angle;
+        }
+
+        CGPoint vector = CGPointMultiplyScalar(exact, 1.0 + index % 500);
+        error = fabs(CGPointToAngleFast(vector) - CGPointToAngle(vector));
+        if (!(error <= toAngleError)) {
+            toAngleError = error;
+            toAngleAt = angle;
+        }
+
+        // The relative error per component, zero components have to be exactly zero.
+        fast = CGPointNormalizeFast(vector);
+        exact = CGPointNormalize(vector);
+        error = fmax(exact.x != 0.0 ? fabs(fast.x / exact.x - 1.0) : fabs(fast.x), exact.y != 0.0 ? fabs(fast.y / exact.y - 1.0) : fabs(fast.y));
+        if (!(error <= normalizeError)) {
+            normalizeError = error;
+            normalizeAt = angle;
+        }
+    }
+    CGPoint zero = CGPointNormalizeFast(CGPointMake(0.0, 0.0));
+    if (zero.x != 0.0 || zero.y != 0.0) {
+        normalizeError = NAN;
+    }
+    INSKTestReport("CGPointForAngleFast", forAngleError, forAngleAt, INSKTestSinCosMaxError);
+    INSKTestReport("CGPointToAngleFast", toAngleError, toAngleAt, INSKTestAtan2MaxError);
+    INSKTestReport("CGPointNormalizeFast", normalizeError, normalizeAt, INSKTestReciprocalSqrtMaxError);
+}
+
+
+int main(void) {
+    test_sinCosFast_staysInMaxError();
+    test_atan2Fast_staysInMaxError();
+    test_reciprocalSqrtFast_staysInMaxError();
+    test_pointFunctions_stayInMaxError();
+
+    if (INSKTestFailures > 0) {
+        printf("%d functions exceeded their maximum error\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
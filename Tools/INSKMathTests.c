@@ -0,0 +1,619 @@
+// Runs the test cases of Example/TestFiles/INSKMathTests.m without Xcode, so INSKMath.h can be tested on any platform, i.e. on Linux.
+//
+// Build and run it with a C99 compiler:
+//   cc -std=c99 -IINSpriteKit Tools/INSKMathTests.c -lm -o insk-math-tests && ./insk-math-tests
+//
+// Compiled as C++ the constexpr templates of INSKMath.h are checked at compile time, too:
+//   c++ -std=c++11 -IINSpriteKit -x c++ Tools/INSKMathTests.c -o insk-math-tests && ./insk-math-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <math.h>
+#include "INSKMath.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+#define INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(value1, value2, accuracy, ...) INSK_TEST_ASSERT(fabs((double)(value1) - (double)(value2)) <= (double)(accuracy), __VA_ARGS__)
+
+
+#ifdef __cplusplus
+// templates
+
+// The templates have to be evaluable at compile time.
+static_assert(INSKMath::Add(INSKMath::Make(1.0f, 2.0f), INSKMath::Make(3.0f, 4.0f)).x == 4.0f, "Add() is not constexpr");
+static_assert(INSKMath::Lerp(INSKMath::Make(0.0, 0.0), INSKMath::Make(2.0, 4.0), 0.5).y == 2.0, "Lerp() is not constexpr");
+static_assert(INSKMath::CrossProduct(INSKMath::Make(2.0, 3.0), INSKMath::Make(4.0, -1.0)) == -14.0, "CrossProduct() is not constexpr");
+static_assert(INSKMath::Clamp(5, 1, 3) == 3, "Clamp() is not constexpr");
+
+static void test_templates_matchCFunctions(void) {
+    CGPoint point1 = CGPointMake(3.0, -4.0);
+    CGPoint point2 = CGPointMake(0.5, 2.0);
+    INSKMath::Vector2<double> vector1 = INSKMath::FromCGPoint<double>(point1);
+    INSKMath::Vector2<double> vector2 = INSKMath::FromCGPoint<double>(point2);
+    CGPoint result = INSKMath::ToCGPoint(INSKMath::Lerp(vector1, vector2, 0.3));
+    INSK_TEST_ASSERT(CGPointNearToPoint(result, CGPointLerp(point1, point2, 0.3)), "Lerp() differs");
+    result = INSKMath::ToCGPoint(INSKMath::Normalize(vector1));
+    INSK_TEST_ASSERT(CGPointNearToPoint(result, CGPointNormalize(point1)), "Normalize() differs");
+    result = INSKMath::ToCGPoint(INSKMath::Project(vector1, vector2));
+    INSK_TEST_ASSERT(CGPointNearToPoint(result, CGPointProject(point1, point2)), "Project() differs");
+    INSK_TEST_ASSERT(ScalarNearOther(INSKMath::Distance(vector1, vector2), CGPointDistance(point1, point2)), "Distance() differs");
+    INSKMath::Vector2<float> floatVector = INSKMath::FromCGPoint<float>(point1);
+    INSK_TEST_ASSERT(INSKMath::Length(floatVector) == 5.0f, "Length() differs for floats");
+}
+#endif
+
+
+// convertions
+
+static void test_convertions_returnsCorrectStructs(void) {
+    CGPoint point = CGPointMake(100, 200);
+    CGSize size = CGSizeMake(300, 400);
+    CGVector vector = CGVectorMake(500, 600);
+    
+    CGPoint resultPoint = CGPointFromSize(size);
+    INSK_TEST_ASSERT(resultPoint.x == size.width && resultPoint.y == size.height, "convertion is not correct");
+    
+    CGSize resultSize = CGSizeFromPoint(point);
+    INSK_TEST_ASSERT(resultSize.width == point.x && resultSize.height == point.y, "convertion is not correct");
+    
+    resultPoint = CGPointFromCGVector(vector);
+    INSK_TEST_ASSERT(resultPoint.x == vector.dx && resultPoint.y == vector.dy, "convertion is not correct");
+    
+    CGVector resultVector = CGVectorFromCGPoint(point);
+    INSK_TEST_ASSERT(resultVector.dx == point.x && resultVector.dy == point.y, "convertion is not correct");
+
+}
+
+
+// Clamp()
+
+static void test_clamp_withValueInside_returnsSameValue(void) {
+    CGFloat result = Clamp(5.4, 2.3, 7.8);
+    INSK_TEST_ASSERT(ScalarNearOther(result, 5.4), "%f not the correct result value", result);
+
+    result = Clamp(2.3, 2.3, 7.8);
+    INSK_TEST_ASSERT(ScalarNearOther(result, 2.3), "%f not the correct result value", result);
+
+    result = Clamp(7.8, 2.3, 7.8);
+    INSK_TEST_ASSERT(ScalarNearOther(result, 7.8), "%f not the correct result value", result);
+}
+
+static void test_clamp_withValueTooLow_returnsLowerBoundary(void) {
+    CGFloat result = Clamp(1.2, 2.3, 7.8);
+    INSK_TEST_ASSERT(ScalarNearOther(result, 2.3), "%f not the correct result value", result);
+}
+
+static void test_clamp_withValueTooHigh_returnsHigherBoundary(void) {
+    CGFloat result = Clamp(8.9, 2.3, 7.8);
+    INSK_TEST_ASSERT(ScalarNearOther(result, 7.8), "%f not the correct result value", result);
+}
+
+
+// ScalarNearOther()
+
+static void test_scalarNearOther_withSameValues_returnsTrue(void) {
+    BOOL result = ScalarNearOther(5.6, 5.6);
+    INSK_TEST_ASSERT(result == YES, "same values should be near each other");
+}
+
+static void test_scalarNearOther_withDifferentValues_returnsFalse(void) {
+    BOOL result = ScalarNearOther(1.2, 5.6);
+    INSK_TEST_ASSERT(result == NO, "different values should not be near each other");
+}
+
+static void test_scalarNearOtherWithVariance_withSameValues_returnsTrue(void) {
+    BOOL result = ScalarNearOtherWithVariance(5.6, 5.6, 0.2);
+    INSK_TEST_ASSERT(result == YES, "same values should be near each other");
+
+    result = ScalarNearOtherWithVariance(5.6, 5.7, 0.2);
+    INSK_TEST_ASSERT(result == YES, "same values should be near each other");
+
+    result = ScalarNearOtherWithVariance(5.5, 5.7, 0.2);
+    INSK_TEST_ASSERT(result == YES, "same values should be near each other");
+}
+
+static void test_scalarNearOtherWithVariance_withDifferentValues_returnsFalse(void) {
+    BOOL result = ScalarNearOtherWithVariance(1.2, 5.6, 0.1);
+    INSK_TEST_ASSERT(result == NO, "different values should not be near each other");
+
+    result = ScalarNearOtherWithVariance(5.4, 5.7, 0.2);
+    INSK_TEST_ASSERT(result == NO, "different values should not be near each other");
+}
+
+
+// ScalarSign()
+
+static void test_scalarSign_withNegativeValue_returnsMinusOne(void) {
+    CGFloat sign = ScalarSign(-4.5);
+    INSK_TEST_ASSERT(ScalarNearOther(sign, -1) == YES, "%f is the wrong value", sign);
+}
+
+static void test_scalarSign_withPositiveValue_returnsPlusOne(void) {
+    CGFloat sign = ScalarSign(4.5);
+    INSK_TEST_ASSERT(ScalarNearOther(sign, 1) == YES, "%f is the wrong value", sign);
+}
+
+static void test_scalarSign_withZeroValue_returnsPlusOne(void) {
+    CGFloat sign = ScalarSign(0.0);
+    INSK_TEST_ASSERT(ScalarNearOther(sign, 1) == YES, "%f is the wrong value", sign);
+}
+
+
+// CGPoint calculations
+
+static void test_pointArithmetic_returnsCorrectPoints(void) {
+    CGPoint point1 = CGPointMake(3.0, -4.0);
+    CGPoint point2 = CGPointMake(0.5, 2.0);
+    CGPoint result = CGPointAdd(point1, point2);
+    INSK_TEST_ASSERT(result.x == 3.5 && result.y == -2.0, "addition is not correct");
+    result = CGPointSubtract(point1, point2);
+    INSK_TEST_ASSERT(result.x == 2.5 && result.y == -6.0, "subtraction is not correct");
+    result = CGPointMultiply(point1, point2);
+    INSK_TEST_ASSERT(result.x == 1.5 && result.y == -8.0, "multiplication is not correct");
+    result = CGPointMultiplyScalar(point1, 2.0);
+    INSK_TEST_ASSERT(result.x == 6.0 && result.y == -8.0, "scalar multiplication is not correct");
+    result = CGPointDivide(point1, point2);
+    INSK_TEST_ASSERT(result.x == 6.0 && result.y == -2.0, "division is not correct");
+    result = CGPointDivideScalar(point1, 2.0);
+    INSK_TEST_ASSERT(result.x == 1.5 && result.y == -2.0, "scalar division is not correct");
+    result = CGPointOffset(point1, 1.0, 1.0);
+    INSK_TEST_ASSERT(result.x == 4.0 && result.y == -3.0, "offset is not correct");
+    result = CGPointNegate(point1);
+    INSK_TEST_ASSERT(result.x == -3.0 && result.y == 4.0, "negation is not correct");
+}
+
+static void test_pointLengths_returnCorrectValues(void) {
+    CGPoint point = CGPointMake(3.0, -4.0);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(CGPointLength(point), 5.0, INSK_EPSILON, "length is not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(CGPointLengthSq(point), 25.0, INSK_EPSILON, "squared length is not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(CGPointDistance(point, CGPointMake(0.0, 0.0)), 5.0, INSK_EPSILON, "distance is not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(CGPointDistanceSq(point, CGPointMake(3.0, 0.0)), 16.0, INSK_EPSILON, "squared distance is not correct");
+    CGPoint normalized = CGPointNormalize(point);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(normalized.x, 0.6, INSK_EPSILON, "normalization is not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(normalized.y, -0.8, INSK_EPSILON, "normalization is not correct");
+}
+
+static void test_pointProducts_returnCorrectValues(void) {
+    CGPoint point1 = CGPointMake(2.0, 3.0);
+    CGPoint point2 = CGPointMake(4.0, -1.0);
+    INSK_TEST_ASSERT(CGPointDotProduct(point1, point2) == 5.0, "dot product is not correct");
+    INSK_TEST_ASSERT(CGPointCrossProduct(point1, point2) == -14.0, "cross product is not correct");
+    CGPoint projection = CGPointProject(point1, CGPointMake(2.0, 0.0));
+    INSK_TEST_ASSERT(projection.x == 2.0 && projection.y == 0.0, "projection is not correct");
+    CGPoint lerp = CGPointLerp(point1, point2, 0.25);
+    INSK_TEST_ASSERT(lerp.x == 2.5 && lerp.y == 2.0, "interpolation is not correct");
+    CGPoint normalized = CGPointNormalizedInRect(CGPointMake(15.0, 30.0), CGRectMake(10.0, 20.0, 10.0, 40.0));
+    INSK_TEST_ASSERT(normalized.x == 0.5 && normalized.y == 0.25, "normalization in rect is not correct");
+    normalized = CGPointNormalizedInSize(CGPointMake(5.0, 10.0), CGSizeMake(10.0, 40.0));
+    INSK_TEST_ASSERT(normalized.x == 0.5 && normalized.y == 0.25, "normalization in size is not correct");
+}
+
+#if CGFLOAT_IS_DOUBLE
+// A float CGFloat rounds these values anyway, so this test only runs with a double CGFloat.
+static void test_pointCalculations_keepCGFloatPrecision(void) {
+    // A float only has 24 bits of mantissa, so these values would be rounded when calculating with floats.
+    CGPoint point = CGPointMake(16777216.0, 0.1);
+    CGPoint result = CGPointAdd(point, CGPointMake(1.0, 0.2));
+    INSK_TEST_ASSERT(result.x == 16777217.0, "precision is lost");
+    INSK_TEST_ASSERT(result.y == 0.1 + 0.2, "precision is lost");
+    result = CGPointLerp(point, CGPointMake(16777218.0, 0.1), 0.5);
+    INSK_TEST_ASSERT(result.x == 16777217.0, "precision is lost");
+}
+#endif
+
+
+// CGSize calculations
+
+static void test_CGSizeScaleFactorToSizeAspectFit_withSmallerOrigSize_returnsFactorGreaterOne(void) {
+    CGSize origSize = CGSizeMake(200, 300);
+    CGSize destSize = CGSizeMake(600, 600);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 2), "the factor %f is not correct", factor);
+
+    origSize = CGSizeMake(300, 200);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 2), "the factor %f is not correct", factor);
+
+    origSize = CGSizeMake(200, 200);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+
+    destSize = CGSizeMake(800, 600);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+    
+    destSize = CGSizeMake(600, 800);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaleFactorToSizeAspectFit_withGreaterOrigSize_returnsFactorSmallerOne(void) {
+    CGSize origSize = CGSizeMake(400, 800);
+    CGSize destSize = CGSizeMake(200, 200);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(800, 400);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(400, 400);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.5), "the factor %f is not correct", factor);
+
+    destSize = CGSizeMake(100, 200);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+
+    destSize = CGSizeMake(200, 100);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaleFactorToSizeAspectFit_withSameSize_returnsOne(void) {
+    CGSize origSize = CGSizeMake(400, 800);
+    CGSize destSize = CGSizeMake(400, 800);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 1), "the factor %f is not correct", factor);
+
+    origSize = CGSizeMake(500, 300);
+    destSize = CGSizeMake(500, 300);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 1), "the factor %f is not correct", factor);
+
+    origSize = CGSizeMake(100, 100);
+    destSize = CGSizeMake(100, 100);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 1), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaleFactorToSizeAspectFit_withOneSideGreaterAndTheOtherSideSmaller_returnsFactorSmallerOne(void) {
+    CGSize origSize = CGSizeMake(200, 800);
+    CGSize destSize = CGSizeMake(400, 400);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.5), "the factor %f is not correct", factor);
+
+    origSize = CGSizeMake(600, 100);
+    destSize = CGSizeMake(300, 300);
+    factor = CGSizeScaleFactorToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.5), "the factor %f is not correct", factor);
+}
+
+
+static void test_CGSizeScaleFactorToSizeAspectFill_withSmallerOrigSize_returnsFactorGreaterOne(void) {
+    CGSize origSize = CGSizeMake(200, 300);
+    CGSize destSize = CGSizeMake(600, 600);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(300, 200);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(300, 300);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 2), "the factor %f is not correct", factor);
+    
+    destSize = CGSizeMake(900, 600);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+    
+    destSize = CGSizeMake(900, 800);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaleFactorToSizeAspectFill_withGreaterOrigSize_returnsFactorSmallerOne(void) {
+    CGSize origSize = CGSizeMake(400, 800);
+    CGSize destSize = CGSizeMake(200, 200);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.5), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(800, 400);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.5), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(800, 800);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+    
+    destSize = CGSizeMake(100, 200);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+    
+    destSize = CGSizeMake(200, 100);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 0.25), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaleFactorToSizeAspectFill_withSameSize_returnsOne(void) {
+    CGSize origSize = CGSizeMake(400, 800);
+    CGSize destSize = CGSizeMake(400, 800);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 1), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(500, 300);
+    destSize = CGSizeMake(500, 300);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 1), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(100, 100);
+    destSize = CGSizeMake(100, 100);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 1), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaleFactorToSizeAspectFill_withOneSideGreaterAndTheOtherSideSmaller_returnsFactorGreaterOne(void) {
+    CGSize origSize = CGSizeMake(200, 800);
+    CGSize destSize = CGSizeMake(400, 400);
+    CGFloat factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 2), "the factor %f is not correct", factor);
+    
+    origSize = CGSizeMake(600, 100);
+    destSize = CGSizeMake(300, 300);
+    factor = CGSizeScaleFactorToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(factor, 3), "the factor %f is not correct", factor);
+}
+
+static void test_CGSizeScaledToSizeAspectFit_withSizes_returnsScaledSize(void) {
+    CGSize origSize = CGSizeMake(200, 800);
+    CGSize destSize = CGSizeMake(400, 400);
+    CGSize scaledSize = CGSizeScaledToSizeAspectFit(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(scaledSize.width, 100) && ScalarNearOther(scaledSize.height, 400), "the scaled size is not correct");
+}
+
+static void test_CGSizeScaledToSizeAspectFill_withSizes_returnsScaledSize(void) {
+    CGSize origSize = CGSizeMake(200, 800);
+    CGSize destSize = CGSizeMake(400, 400);
+    CGSize scaledSize = CGSizeScaledToSizeAspectFill(origSize, destSize);
+    INSK_TEST_ASSERT(ScalarNearOther(scaledSize.width, 400) && ScalarNearOther(scaledSize.height, 1600), "the scaled size is not correct");
+}
+
+
+// angular convertions and calculations
+
+static void test_angularConvertions_returnsCorrectValues(void) {
+    CGFloat degrees = 0.0;
+    CGFloat radians = 0.0;
+    INSK_TEST_ASSERT(ScalarNearOther(DegreesToRadians(degrees), radians), "convertion not correct");
+    INSK_TEST_ASSERT(ScalarNearOther(RadiansToDegrees(radians), degrees), "convertion not correct");
+    degrees = 90.0;
+    radians = M_PI_2;
+    INSK_TEST_ASSERT(ScalarNearOther(DegreesToRadians(degrees), radians), "convertion not correct");
+    INSK_TEST_ASSERT(ScalarNearOther(RadiansToDegrees(radians), degrees), "convertion not correct");
+    degrees = 180.0;
+    radians = M_PI;
+    INSK_TEST_ASSERT(ScalarNearOther(DegreesToRadians(degrees), radians), "convertion not correct");
+    INSK_TEST_ASSERT(ScalarNearOther(RadiansToDegrees(radians), degrees), "convertion not correct");
+    degrees = 360.0;
+    radians = M_PI_X_2;
+    INSK_TEST_ASSERT(ScalarNearOther(DegreesToRadians(degrees), radians), "convertion not correct");
+    INSK_TEST_ASSERT(ScalarNearOther(RadiansToDegrees(radians), degrees), "convertion not correct");
+}
+
+static void test_angularPointConvertions_returnsCorrectStructsAndValues(void) {
+    CGFloat angle = 0.0;
+    CGPoint point = CGPointMake(1.0, 0.0);
+    CGPoint retPoint = CGPointForAngle(angle);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, CGPointToAngle(point), INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.x, point.x, INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.y, point.y, INSK_EPSILON, "convertion not correct");
+    
+    point = CGPointMake(0.0, 1.0);
+    angle = M_PI_2;
+    retPoint = CGPointForAngle(angle);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, CGPointToAngle(point), INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.x, point.x, INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.y, point.y, INSK_EPSILON, "convertion not correct");
+
+    point = CGPointMake(0.0, -1.0);
+    angle = -M_PI_2;
+    retPoint = CGPointForAngle(angle);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, CGPointToAngle(point), INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.x, point.x, INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.y, point.y, INSK_EPSILON, "convertion not correct");
+
+    point = CGPointMake(-1.0, 0.0);
+    angle = M_PI;
+    retPoint = CGPointForAngle(angle);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, CGPointToAngle(point), INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.x, point.x, INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.y, point.y, INSK_EPSILON, "convertion not correct");
+    angle = -M_PI;
+    retPoint = CGPointForAngle(angle);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.x, point.x, INSK_EPSILON, "convertion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(retPoint.y, point.y, INSK_EPSILON, "convertion not correct");
+}
+
+static void test_angleIn2Pi_withAngleInBounds_returnsSameAngle(void) {
+    CGFloat angle = 0.0;
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, AngleIn2Pi(angle), INSK_EPSILON, "wrapping not correct");
+    angle = M_PI_2;
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, AngleIn2Pi(angle), INSK_EPSILON, "wrapping not correct");
+    angle = M_PI;
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, AngleIn2Pi(angle), INSK_EPSILON, "wrapping not correct");
+}
+
+static void test_angleIn2Pi_withNegativeAngle_returnsPositiveAngleWrappedAround(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(3*M_PI_2, AngleIn2Pi(-M_PI_2), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI, AngleIn2Pi(-M_PI), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, AngleIn2Pi(-2.0*M_PI+INSK_EPSILON), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI, AngleIn2Pi(-3*M_PI), 0.001, "wrapping not correct");
+}
+
+static void test_angleIn2Pi_withTooBigAngle_returnsPositiveAngleWrappedAround(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, AngleIn2Pi(M_PI_X_2), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI, AngleIn2Pi(3*M_PI), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI_2, AngleIn2Pi(5*M_PI_2), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, AngleIn2Pi(4*M_PI), 0.001, "wrapping not correct");
+}
+
+static void test_angleInPi_withAngleInBounds_returnsSameAngle(void) {
+    CGFloat angle = 0.0;
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, AngleInPi(angle), INSK_EPSILON, "wrapping not correct");
+    angle = M_PI_2;
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, AngleInPi(angle), INSK_EPSILON, "wrapping not correct");
+    angle = -M_PI_2;
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(angle, AngleInPi(angle), INSK_EPSILON, "wrapping not correct");
+}
+
+static void test_angleInPi_withTooSmallAngle_returnsAngleWrappedAround(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI, AngleInPi(-M_PI-0.0001), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI_2, AngleInPi(-3*M_PI_2-INSK_EPSILON), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, AngleInPi(-2.0*M_PI+INSK_EPSILON), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI_2, AngleInPi(-5*M_PI_2), 0.001, "wrapping not correct");
+}
+
+static void test_angleInPi_withTooBigAngle_returnsAngleWrappedAround(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI, AngleInPi(M_PI+INSK_EPSILON), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI_2, AngleInPi(3*M_PI_2), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, AngleInPi(4*M_PI_2+INSK_EPSILON), 0.001, "wrapping not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, AngleInPi(4*M_PI+INSK_EPSILON), 0.001, "wrapping not correct");
+}
+
+static void test_shortestAngleBetween_withTwoEqualAngles_returnsZero(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, ShortestAngleBetween(0.1, 0.1), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, ShortestAngleBetween(3*M_PI, 3*M_PI), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.0, ShortestAngleBetween(-M_PI_4, -M_PI_4), 0.001, "calculation not correct");
+}
+
+static void test_shortestAngleBetween_aSmallAngle_andABigAngle_returnsTheDifference(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI_2, ShortestAngleBetween(0.0, M_PI_2-INSK_EPSILON), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI_4, ShortestAngleBetween(M_PI_4, M_PI_2-INSK_EPSILON), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI, ShortestAngleBetween(M_PI_2, 3*M_PI_2-0.0001), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI, ShortestAngleBetween(M_PI_2, 3*M_PI_2+0.0001), 0.001, "calculation not correct");
+}
+
+static void test_shortestAngleBetween_aBigAngle_andASmallAngle_returnsTheDifference(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI_2, ShortestAngleBetween(M_PI_2-INSK_EPSILON, 0.0), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI_4, ShortestAngleBetween(M_PI_2-INSK_EPSILON, M_PI_4), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-M_PI, ShortestAngleBetween(3*M_PI_2-0.0001, M_PI_2), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(M_PI, ShortestAngleBetween(3*M_PI_2+0.0001, M_PI_2), 0.001, "calculation not correct");
+}
+
+static void test_angleWrapping_withHugeAngles_returnsExactlyWrappedAngles(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(fmod(1000000.0, M_PI_X_2), AngleIn2Pi(1000000.0), 0.000001, "wrapping not exact");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(fmod(1000000.0, M_PI_X_2) - M_PI_X_2, AngleInPi(1000000.0), 0.000001, "wrapping not exact");
+    CGFloat angle = AngleIn2Pi(-1.0e15);
+    INSK_TEST_ASSERT(angle >= 0.0 && angle < M_PI_X_2, "wrapping not correct");
+    angle = AngleInPi(1.0e15);
+    INSK_TEST_ASSERT(angle >= -M_PI && angle < M_PI, "wrapping not correct");
+}
+
+static void test_shortestAngleBetween_withHugeAngles_returnsTheDifference(void) {
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(0.5, ShortestAngleBetween(1000*M_PI_X_2, 1000*M_PI_X_2+0.5), 0.001, "calculation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(-0.5, ShortestAngleBetween(-1000*M_PI_X_2+0.5, -1000*M_PI_X_2), 0.001, "calculation not correct");
+}
+
+
+// affine transformations
+
+static void test_affineTransformApply_withComposedTransform_returnsTransformedPoint(void) {
+    // Scaled by 2, then rotated by 90 degrees, then moved by (10, 20).
+    INSKAffineTransform transform = INSKAffineTransformConcat(INSKAffineTransformConcat(INSKAffineTransformMakeScale(2.0, 2.0), INSKAffineTransformMakeRotation(M_PI_2)), INSKAffineTransformMakeTranslation(10.0, 20.0));
+    CGPoint point = CGPointApplyINSKAffineTransform(CGPointMake(1.0, 0.0), transform);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(point.x, 10.0, 0.00001, "transformation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(point.y, 22.0, 0.00001, "transformation not correct");
+}
+
+static void test_affineTransformTranslateRotateScale_prependToTransform(void) {
+    INSKAffineTransform transform = INSKAffineTransformScale(INSKAffineTransformRotate(INSKAffineTransformTranslate(INSKAffineTransformMakeIdentity(), 10.0, 20.0), M_PI_2), 2.0, 2.0);
+    // Like CGAffineTransform the last added transformation is applied first: scaled, rotated and then moved.
+    CGPoint point = CGPointApplyINSKAffineTransform(CGPointMake(1.0, 0.0), transform);
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(point.x, 10.0, 0.00001, "transformation not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(point.y, 22.0, 0.00001, "transformation not correct");
+}
+
+static void test_affineTransformInvert_returnsTransformBack(void) {
+    INSKAffineTransform transform = INSKAffineTransformRotate(INSKAffineTransformMakeTranslation(-3.0, 7.0), 0.3);
+    transform = INSKAffineTransformScale(transform, 1.5, -0.5);
+    INSKAffineTransform identity = INSKAffineTransformConcat(transform, INSKAffineTransformInvert(transform));
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(identity.a, 1.0, 0.00001, "inversion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(identity.b, 0.0, 0.00001, "inversion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(identity.c, 0.0, 0.00001, "inversion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(identity.d, 1.0, 0.00001, "inversion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(identity.tx, 0.0, 0.00001, "inversion not correct");
+    INSK_TEST_ASSERT_EQUAL_WITH_ACCURACY(identity.ty, 0.0, 0.00001, "inversion not correct");
+}
+
+static void test_affineTransformInvert_withSingularTransform_returnsSameTransform(void) {
+    INSKAffineTransform transform = INSKAffineTransformMakeScale(0.0, 2.0);
+    INSKAffineTransform inverted = INSKAffineTransformInvert(transform);
+    INSK_TEST_ASSERT(inverted.a == transform.a, "singular transformation changed");
+    INSK_TEST_ASSERT(inverted.d == transform.d, "singular transformation changed");
+}
+
+static void test_affineTransformIsIdentity_returnsCorrectValues(void) {
+    INSK_TEST_ASSERT(INSKAffineTransformIsIdentity(INSKAffineTransformMakeIdentity()), "identity not recognized");
+    INSK_TEST_ASSERT(!INSKAffineTransformIsIdentity(INSKAffineTransformMakeTranslation(1.0, 0.0)), "translation recognized as identity");
+}
+
+int main(void) {
+    test_convertions_returnsCorrectStructs();
+    test_clamp_withValueInside_returnsSameValue();
+    test_clamp_withValueTooLow_returnsLowerBoundary();
+    test_clamp_withValueTooHigh_returnsHigherBoundary();
+    test_scalarNearOther_withSameValues_returnsTrue();
+    test_scalarNearOther_withDifferentValues_returnsFalse();
+    test_scalarNearOtherWithVariance_withSameValues_returnsTrue();
+    test_scalarNearOtherWithVariance_withDifferentValues_returnsFalse();
+    test_scalarSign_withNegativeValue_returnsMinusOne();
+    test_scalarSign_withPositiveValue_returnsPlusOne();
+    test_scalarSign_withZeroValue_returnsPlusOne();
+    test_pointArithmetic_returnsCorrectPoints();
+    test_pointLengths_returnCorrectValues();
+    test_pointProducts_returnCorrectValues();
+#if CGFLOAT_IS_DOUBLE
+    test_pointCalculations_keepCGFloatPrecision();
+#endif
+    test_CGSizeScaleFactorToSizeAspectFit_withSmallerOrigSize_returnsFactorGreaterOne();
+    test_CGSizeScaleFactorToSizeAspectFit_withGreaterOrigSize_returnsFactorSmallerOne();
+    test_CGSizeScaleFactorToSizeAspectFit_withSameSize_returnsOne();
+    test_CGSizeScaleFactorToSizeAspectFit_withOneSideGreaterAndTheOtherSideSmaller_returnsFactorSmallerOne();
+    test_CGSizeScaleFactorToSizeAspectFill_withSmallerOrigSize_returnsFactorGreaterOne();
+    test_CGSizeScaleFactorToSizeAspectFill_withGreaterOrigSize_returnsFactorSmallerOne();
+    test_CGSizeScaleFactorToSizeAspectFill_withSameSize_returnsOne();
+    test_CGSizeScaleFactorToSizeAspectFill_withOneSideGreaterAndTheOtherSideSmaller_returnsFactorGreaterOne();
+    test_CGSizeScaledToSizeAspectFit_withSizes_returnsScaledSize();
+    test_CGSizeScaledToSizeAspectFill_withSizes_returnsScaledSize();
+    test_angularConvertions_returnsCorrectValues();
+    test_angularPointConvertions_returnsCorrectStructsAndValues();
+    test_angleIn2Pi_withAngleInBounds_returnsSameAngle();
+    test_angleIn2Pi_withNegativeAngle_returnsPositiveAngleWrappedAround();
+    test_angleIn2Pi_withTooBigAngle_returnsPositiveAngleWrappedAround();
+    test_angleInPi_withAngleInBounds_returnsSameAngle();
+    test_angleInPi_withTooSmallAngle_returnsAngleWrappedAround();
+    test_angleInPi_withTooBigAngle_returnsAngleWrappedAround();
+    test_shortestAngleBetween_withTwoEqualAngles_returnsZero();
+    test_shortestAngleBetween_aSmallAngle_andABigAngle_returnsTheDifference();
+    test_shortestAngleBetween_aBigAngle_andASmallAngle_returnsTheDifference();
+    test_angleWrapping_withHugeAngles_returnsExactlyWrappedAngles();
+    test_shortestAngleBetween_withHugeAngles_returnsTheDifference();
+    test_affineTransformApply_withComposedTransform_returnsTransformedPoint();
+    test_affineTransformTranslateRotateScale_prependToTransform();
+    test_affineTransformInvert_returnsTransformBack();
+    test_affineTransformInvert_withSingularTransform_returnsSameTransform();
+    test_affineTransformIsIdentity_returnsCorrectValues();
+#ifdef __cplusplus
+    test_templates_matchCFunctions();
+#endif
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+// A command line tool which measures the cost of stepping INSKScrollPhysics.h and checks that the motions are deterministic.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKScrollPhysicsBenchmark.c INSpriteKit/INSKScrollPhysics.c INSpriteKit/INSKMathEasing.c INSpriteKit/INSKInstrumentation.c -lm -o insk-scroll-physics-benchmark
+//
+// Usage:
+//   insk-scroll-physics-benchmark [-instances count] [-iterations count]
+//
+// Releases the given number of scroll physics with different velocities in each scenario and steps them at 60 frames per second
+// until all have come to rest. Prints for each scenario the nanoseconds per step, the number of frames until the last one rests
+// and a checksum of all positions, which is the same for every run and has to match when stepped at 120 frames per second.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKScrollPhysics.h"
+#include "INSKInstrumentation.h"
+
+
+// The scroll scenarios.
+typedef enum {
+    INSKBenchmarkScenarioDecelerate = 0,
+    INSKBenchmarkScenarioDecelerateBounce,
+    INSKBenchmarkScenarioPaging,
+    INSKBenchmarkScenarioBounceBack,
+    INSKBenchmarkScenarioCount
+} INSKBenchmarkScenario;
+
+static const char *const INSKBenchmarkScenarioNames[] = {"decelerate", "decelerate+bounce", "paging", "bounce back"};
+
+// The latest time a checksum is sampled at, all scenarios rest before.
+#define INSKBenchmarkChecksumTime 4.0
+
+// Used to keep the compiler from removing the loops.
+static volatile CGFloat INSKBenchmarkSink;
+
+
+// Sets up and releases the physics of a scenario, the instances differ in their positions and velocities.
+static void INSKBenchmarkRelease(INSKScrollPhysics *physics, size_t count, INSKBenchmarkScenario scenario) {
+    for (size_t index = 0; index < count; ++index) {
+        INSKScrollPhysics *instance = &physics[index];
+        INSKScrollPhysicsInit(instance);
+        instance->viewportSize = CGSizeMake(320, 480);
+        instance->pageSize = CGSizeMake(320, 480);
+        instance->bounces = (scenario != INSKBenchmarkScenarioDecelerate);
+        instance->mode = (scenario == INSKBenchmarkScenarioPaging) ? INSKScrollPhysicsModePagingDirection : INSKScrollPhysicsModeDecelerate;
+        INSKScrollPhysicsSetLimits(instance, CGPointMake(-2880, 0), CGPointMake(0, 9120));
+
+        CGFloat variation = (CGFloat)(index % 97) / 97;
+        CGPoint position = CGPointMake(-1440 * variation, 4560 + 4000 * variation);
+        CGPoint velocity = CGPointMake(-400 + 800 * variation, 3000 + 6000 * variation);
+        if (scenario == INSKBenchmarkScenarioBounceBack) {
+            INSKScrollPhysicsBeginDrag(instance, CGPointMake(0, 0));
+            INSKScrollPhysicsDrag(instance, CGPointMake(0, -300 * variation - 10));
+            velocity = CGPointMake(0, 0);
+        } else {
+            INSKScrollPhysicsSetPosition(instance, position);
+        }
+        INSKScrollPhysicsRelease(instance, velocity, 0.0);
+    }
+}
+
+// Steps all physics at a frame rate until all rest and returns the nanoseconds per step.
+static double INSKBenchmarkRun(INSKScrollPhysics *physics, size_t count, double framesPerSecond, unsigned int *frames) {
+    unsigned int frame = 0;
+    size_t steps = 0;
+    bool animating = true;
+    uint64_t start = INSKInstrumentationNow();
+    while (animating && frame < 100000) {
+        frame++;
+        double time = frame / framesPerSecond;
+        animating = false;
+        for (size_t index = 0; index < count; ++index) {
+            animating |= INSKScrollPhysicsStep(&physics[index], time);
+        }
+        steps += count;
+        INSKBenchmarkSink = INSKScrollPhysicsPosition(&physics[frame % count]).y;
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    *frames = frame;
+    return (double)nanoseconds / (double)steps;
+}
+
+// Returns a checksum of the positions of all physics at some fixed times.
+static double INSKBenchmarkChecksum(INSKScrollPhysics *physics, size_t count, INSKBenchmarkScenario scenario, double framesPerSecond) {
+    INSKBenchmarkRelease(physics, count, scenario);
+    double checksum = 0;
+    double nextSample = 0.25;
+    for (unsigned int frame = 1; frame <= INSKBenchmarkChecksumTime * framesPerSecond; ++frame) {
+        double time = frame / framesPerSecond;
+        for (size_t index = 0; index < count; ++index) {
+            INSKScrollPhysicsStep(&physics[index], time);
+        }
+        // Sample at times hit by both frame rates.
+        if (time >= nextSample - 1e-9) {
+            for (size_t index = 0; index < count; ++index) {
+                CGPoint position = INSKScrollPhysicsPosition(&physics[index]);
+                checksum += position.x * 0.5 + position.y;
+            }
+            nextSample += 0.25;
+        }
+    }
+    return checksum;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t count = 1000;
+    unsigned int iterations = 20;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-instances") == 0 && argument + 1 < argc) {
+            count = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-instances count] [-iterations count]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (count == 0) {
+        count = 1;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    INSKScrollPhysics *physics = (INSKScrollPhysics *)malloc(count * sizeof(INSKScrollPhysics));
+    if (physics == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("instances %zu iterations %u\n", count, iterations);
+    printf("%-18s %10s %8s %22s %10s\n", "scenario", "ns/step", "frames", "checksum", "120 fps");
+    int result = 0;
+    for (int scenario = 0; scenario < INSKBenchmarkScenarioCount; ++scenario) {
+        double best = 0;
+        unsigned int frames = 0;
+        for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+            INSKBenchmarkRelease(physics, count, (INSKBenchmarkScenario)scenario);
+            double nanoseconds = INSKBenchmarkRun(physics, count, 60, &frames);
+            best = (iteration == 0 || nanoseconds < best) ? nanoseconds : best;
+        }
+        double checksum = INSKBenchmarkChecksum(physics, count, (INSKBenchmarkScenario)scenario, 60);
+        double checksum120 = INSKBenchmarkChecksum(physics, count, (INSKBenchmarkScenario)scenario, 120);
+        bool matches = fabs(checksum - checksum120) <= fabs(checksum) * 1e-6;
+        printf("%-18s %10.2f %8u %22.6f %10s\n", INSKBenchmarkScenarioNames[scenario], best, frames, checksum, matches ? "matches" : "DIFFERS");
+        if (!matches) {
+            result = 1;
+        }
+    }
+
+    free(physics);
+    return result;
+}
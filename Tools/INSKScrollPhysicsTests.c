@@ -0,0 +1,311 @@
+// Tests the deceleration, paging, rubber banding and determinism of INSKScrollPhysics.h.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKScrollPhysicsTests.c INSpriteKit/INSKScrollPhysics.c INSpriteKit/INSKMathEasing.c -lm -o insk-scroll-physics-tests && ./insk-scroll-physics-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <math.h>
+#include "INSKScrollPhysics.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The allowed difference of positions, big enough for a float CGFloat.
+#define INSKTestPrecision 0.01
+
+static bool INSKTestNear(CGFloat value, CGFloat expected) {
+    return fabs((double)value - (double)expected) <= INSKTestPrecision;
+}
+
+// A scroll view of 320 x 480 points showing content of 320 x 4800 points, scrolled like INSKScrollNode.
+static INSKScrollPhysics INSKTestPhysics(INSKScrollPhysicsMode mode) {
+    INSKScrollPhysics physics;
+    INSKScrollPhysicsInit(&physics);
+    physics.mode = mode;
+    physics.viewportSize = CGSizeMake(320, 480);
+    INSKScrollPhysicsSetLimits(&physics, CGPointMake(0, 0), CGPointMake(0, 4800 - 480));
+    return physics;
+}
+
+// Steps the physics with a fixed frame rate until it rests and returns the time it took.
+static double INSKTestRunUntilRest(INSKScrollPhysics *physics, double start, double framesPerSecond) {
+    double time = start;
+    for (int frame = 1; frame < 100000; ++frame) {
+        time = start + frame / framesPerSecond;
+        if (!INSKScrollPhysicsStep(physics, time)) {
+            break;
+        }
+    }
+    return time - start;
+}
+
+
+// setup
+
+static void test_setup_clampsIntoLimits(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeNone);
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(50, -100));
+    CGPoint position = INSKScrollPhysicsPosition(&physics);
+    INSK_TEST_ASSERT(position.x == 0 && position.y == 0, "position (%f, %f) not clamped", (double)position.x, (double)position.y);
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(0, 4000));
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 4000, "valid position changed");
+
+    INSKScrollPhysicsSetLimits(&physics, CGPointMake(0, 0), CGPointMake(0, 1000));
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 1000, "resting position not moved into the new limits");
+    INSKScrollPhysicsSetLimits(&physics, CGPointMake(0, 0), CGPointMake(0, -50));
+    INSK_TEST_ASSERT(physics.maxPosition.y == 0 && INSKScrollPhysicsPosition(&physics).y == 0, "maximum smaller than the minimum");
+    INSK_TEST_ASSERT(!INSKScrollPhysicsIsAnimating(&physics) && !INSKScrollPhysicsIsDragging(&physics), "physics not resting");
+}
+
+
+// dragging
+
+static void test_drag_stopsAtLimitsWithoutBouncing(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeNone);
+    INSKScrollPhysicsDrag(&physics, CGPointMake(0, 100));
+    INSK_TEST_ASSERT(INSKScrollPhysicsIsDragging(&physics), "drag not started");
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 100, "drag didn't move");
+    INSKScrollPhysicsDrag(&physics, CGPointMake(20, -300));
+    CGPoint position = INSKScrollPhysicsPosition(&physics);
+    INSK_TEST_ASSERT(position.x == 0 && position.y == 0, "drag left the limits to (%f, %f)", (double)position.x, (double)position.y);
+    // Dragging back moves the content at once.
+    INSKScrollPhysicsDrag(&physics, CGPointMake(0, 10));
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 10, "drag back didn't move at once");
+
+    INSKScrollPhysicsRelease(&physics, CGPointMake(0, 500), 1.0);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsIsAnimating(&physics) && !INSKScrollPhysicsIsDragging(&physics), "mode none moves after the release");
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 10, "release moved the content");
+}
+
+static void test_drag_rubberBandsBeyondLimits(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeNone);
+    physics.bounces = true;
+    INSKScrollPhysicsDrag(&physics, CGPointMake(0, -100));
+    CGFloat first = INSKScrollPhysicsPosition(&physics).y;
+    INSK_TEST_ASSERT(first < 0 && first > -100, "overscroll of %f not damped", (double)first);
+    INSKScrollPhysicsDrag(&physics, CGPointMake(0, -100000));
+    CGFloat far = INSKScrollPhysicsPosition(&physics).y;
+    INSK_TEST_ASSERT(far < first && far > -480, "overscroll of %f not limited by the viewport", (double)far);
+    INSKScrollPhysicsDrag(&physics, CGPointMake(0, 100000));
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsPosition(&physics).y, first), "drag back didn't return to %f", (double)first);
+
+    // Continuing from an overscrolled position doesn't jump.
+    INSKScrollPhysicsBeginDrag(&physics, CGPointMake(0, -40));
+    INSKScrollPhysicsDrag(&physics, CGPointMake(0, 0));
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsPosition(&physics).y, -40), "drag from an overscroll jumped to %f", (double)INSKScrollPhysicsPosition(&physics).y);
+
+    // Releasing bounces back to the limit.
+    INSKScrollPhysicsRelease(&physics, CGPointMake(0, 0), 0.0);
+    INSK_TEST_ASSERT(INSKScrollPhysicsIsAnimating(&physics), "overscroll doesn't bounce back");
+    INSKScrollPhysicsStep(&physics, 0.1);
+    CGFloat bouncing = INSKScrollPhysicsPosition(&physics).y;
+    INSK_TEST_ASSERT(bouncing > -40 && bouncing < 0, "bounce at %f", (double)bouncing);
+    double duration = INSKTestRunUntilRest(&physics, 0.1, 60);
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 0, "bounce ended at %f", (double)INSKScrollPhysicsPosition(&physics).y);
+    INSK_TEST_ASSERT(duration < 2, "bounce took %f seconds", duration);
+}
+
+
+// deceleration
+
+static void test_deceleration_isClosedForm(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeDecelerate);
+    physics.deceleration = 1000;
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(0, 1000));
+    INSKScrollPhysicsBeginDrag(&physics, CGPointMake(0, 1000));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(0, 1000), 2.0);
+    INSK_TEST_ASSERT(INSKScrollPhysicsIsAnimating(&physics), "deceleration not started");
+
+    // s(t) = v * t - a/2 * t*t, stops after v/a = 1 second at v*v / 2a = 500.
+    INSKScrollPhysicsStep(&physics, 2.5);
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsPosition(&physics).y, 1375), "position %f after 0.5 seconds", (double)INSKScrollPhysicsPosition(&physics).y);
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsVelocity(&physics).y, 500), "velocity %f after 0.5 seconds", (double)INSKScrollPhysicsVelocity(&physics).y);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsStep(&physics, 3.5), "deceleration didn't stop");
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsPosition(&physics).y, 1500), "deceleration stopped at %f", (double)INSKScrollPhysicsPosition(&physics).y);
+
+    // Diagonal velocities decelerate along their direction.
+    INSKScrollPhysicsSetLimits(&physics, CGPointMake(-4000, 0), CGPointMake(0, 4320));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(-600, 800), 0.0);
+    INSKTestRunUntilRest(&physics, 0.0, 60);
+    CGPoint position = INSKScrollPhysicsPosition(&physics);
+    INSK_TEST_ASSERT(INSKTestNear(position.x, -300) && INSKTestNear(position.y, 1900), "diagonal deceleration stopped at (%f, %f)", (double)position.x, (double)position.y);
+}
+
+static void test_deceleration_endsAtLimits(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeDecelerate);
+    physics.deceleration = 1000;
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(0, 4000));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(0, 2000), 0.0);
+    INSKScrollPhysicsStep(&physics, 0.1);
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsPosition(&physics).y, 4195), "position %f before the limit", (double)INSKScrollPhysicsPosition(&physics).y);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsStep(&physics, 0.2), "deceleration didn't stop at the limit");
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 4320, "deceleration stopped at %f", (double)INSKScrollPhysicsPosition(&physics).y);
+
+    // With bouncing the content overshoots and springs back.
+    physics.bounces = true;
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(0, 4000));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(0, 2000), 0.0);
+    CGFloat maximum = 0;
+    double time = 0;
+    while (INSKScrollPhysicsStep(&physics, time) && time < 10) {
+        maximum = MAX(maximum, INSKScrollPhysicsPosition(&physics).y);
+        time += 1.0 / 60;
+    }
+    INSK_TEST_ASSERT(maximum > 4330 && maximum < 4320 + 480, "bounce overshot to %f", (double)maximum);
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 4320, "bounce ended at %f", (double)INSKScrollPhysicsPosition(&physics).y);
+    INSK_TEST_ASSERT(time < 3, "bounce took %f seconds", time);
+}
+
+static void test_deceleration_isIndependentOfFrameRate(void) {
+    double rates[] = {30, 60, 120, 7.3};
+    CGPoint positions[4];
+    for (int rate = 0; rate < 4; ++rate) {
+        INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeDecelerate);
+        physics.bounces = true;
+        physics.deceleration = 1500;
+        INSKScrollPhysicsSetPosition(&physics, CGPointMake(0, 3000));
+        INSKScrollPhysicsRelease(&physics, CGPointMake(0, 3000), 10.0);
+        for (double time = 10.0; time < 11.0; time += 1.0 / rates[rate]) {
+            INSKScrollPhysicsStep(&physics, time);
+        }
+        INSKScrollPhysicsStep(&physics, 11.0);
+        positions[rate] = INSKScrollPhysicsPosition(&physics);
+    }
+    for (int rate = 1; rate < 4; ++rate) {
+        INSK_TEST_ASSERT(positions[rate].x == positions[0].x && positions[rate].y == positions[0].y, "%f fps ended at %f instead of %f",
+                         rates[rate], (double)positions[rate].y, (double)positions[0].y);
+    }
+}
+
+
+// paging
+
+static void test_paging_snapsToPages(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModePagingHalfPage);
+    physics.pageSize = CGSizeMake(320, 480);
+    INSKScrollPhysicsSetLimits(&physics, CGPointMake(-1280, 0), CGPointMake(0, 4320));
+
+    // Less than half a page returns, more snaps to the next one.
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(-150, 730));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(-100, -100), 0.0);
+    INSK_TEST_ASSERT(INSKScrollPhysicsIsAnimating(&physics), "snap not started");
+    INSKScrollPhysicsStep(&physics, 0.15);
+    CGPoint position = INSKScrollPhysicsPosition(&physics);
+    // The quadratic ease out has moved 75% after half of the time.
+    INSK_TEST_ASSERT(INSKTestNear(position.x, -150 + 150 * 0.75) && INSKTestNear(position.y, 730 + 230 * 0.75), "snap at (%f, %f) after half the time", (double)position.x, (double)position.y);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsStep(&physics, 0.5), "snap didn't end");
+    position = INSKScrollPhysicsPosition(&physics);
+    INSK_TEST_ASSERT(position.x == 0 && position.y == 960, "half page snapped to (%f, %f)", (double)position.x, (double)position.y);
+
+    // The direction mode follows the velocity.
+    physics.mode = INSKScrollPhysicsModePagingDirection;
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(-150, 730));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(-100, -100), 0.0);
+    INSKScrollPhysicsStep(&physics, 1.0);
+    position = INSKScrollPhysicsPosition(&physics);
+    INSK_TEST_ASSERT(position.x == -320 && position.y == 480, "direction paging snapped to (%f, %f)", (double)position.x, (double)position.y);
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(-150, 730));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(100, 100), 0.0);
+    INSKScrollPhysicsStep(&physics, 1.0);
+    position = INSKScrollPhysicsPosition(&physics);
+    INSK_TEST_ASSERT(position.x == 0 && position.y == 960, "direction paging snapped to (%f, %f)", (double)position.x, (double)position.y);
+
+    // Already on a page nothing moves, and the last page is limited.
+    INSKScrollPhysicsSetPosition(&physics, CGPointMake(-320, 4320));
+    INSKScrollPhysicsRelease(&physics, CGPointMake(0, 100), 0.0);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsIsAnimating(&physics), "snap started on a page");
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 4320, "snapped beyond the limit to %f", (double)INSKScrollPhysicsPosition(&physics).y);
+}
+
+static void test_scrollTo_deceleratesToTarget(void) {
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeNone);
+    INSKScrollPhysicsScrollTo(&physics, CGPointMake(0, 1000), 2.0, 5.0);
+    INSKScrollPhysicsStep(&physics, 6.0);
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsPosition(&physics).y, 750), "position %f after half the time", (double)INSKScrollPhysicsPosition(&physics).y);
+    INSK_TEST_ASSERT(INSKTestNear(INSKScrollPhysicsVelocity(&physics).y, 500), "velocity %f after half the time", (double)INSKScrollPhysicsVelocity(&physics).y);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsStep(&physics, 7.0), "scroll animation didn't end");
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 1000, "scroll animation ended at %f", (double)INSKScrollPhysicsPosition(&physics).y);
+
+    INSKScrollPhysicsScrollTo(&physics, CGPointMake(0, 99999), 1.0, 0.0);
+    INSKScrollPhysicsStep(&physics, 1.0);
+    INSK_TEST_ASSERT(INSKScrollPhysicsPosition(&physics).y == 4320, "scroll animation ended beyond the limit at %f", (double)INSKScrollPhysicsPosition(&physics).y);
+    INSKScrollPhysicsScrollTo(&physics, CGPointMake(0, 100), 0.0, 0.0);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsIsAnimating(&physics) && INSKScrollPhysicsPosition(&physics).y == 100, "scroll without duration didn't jump");
+
+    INSKScrollPhysicsScrollTo(&physics, CGPointMake(0, 1000), 1.0, 0.0);
+    INSKScrollPhysicsStep(&physics, 0.5);
+    INSKScrollPhysicsStop(&physics);
+    INSK_TEST_ASSERT(!INSKScrollPhysicsIsAnimating(&physics) && INSKTestNear(INSKScrollPhysicsPosition(&physics).y, 775), "stop didn't keep the position");
+}
+
+
+
+// prediction
+
+static void test_restingPosition_predictsEndOfMotion(void) {
+    static const INSKScrollPhysicsMode modes[] = {INSKScrollPhysicsModeNone, INSKScrollPhysicsModePagingHalfPage, INSKScrollPhysicsModePagingDirection, INSKScrollPhysicsModeDecelerate};
+    static const CGFloat velocities[] = {-9000, -2500, -300, 0, 120, 2000, 7000};
+    for (size_t modeIndex = 0; modeIndex < sizeof(modes) / sizeof(modes[0]); ++modeIndex) {
+        for (int bounces = 0; bounces <= 1; ++bounces) {
+            for (size_t velocityIndex = 0; velocityIndex < sizeof(velocities) / sizeof(velocities[0]); ++velocityIndex) {
+                INSKScrollPhysics physics = INSKTestPhysics(modes[modeIndex]);
+                physics.bounces = (bounces != 0);
+                physics.pageSize = CGSizeMake(320, 480);
+                INSKScrollPhysicsSetLimits(&physics, CGPointMake(-2880, 0), CGPointMake(0, 4320));
+                CGFloat velocity = velocities[velocityIndex];
+                // Every second release starts from an overscroll at the top.
+                if (velocityIndex % 2 == 0) {
+                    INSKScrollPhysicsSetPosition(&physics, CGPointMake(-1000, 2000));
+                } else {
+                    INSKScrollPhysicsBeginDrag(&physics, CGPointMake(-1000, 0));
+                    INSKScrollPhysicsDrag(&physics, CGPointMake(0, -150));
+                }
+                INSKScrollPhysicsRelease(&physics, CGPointMake(velocity / 3, velocity), 0.0);
+                CGPoint predicted = INSKScrollPhysicsRestingPosition(&physics);
+                INSKTestRunUntilRest(&physics, 0.0, 60);
+                CGPoint position = INSKScrollPhysicsPosition(&physics);
+                INSK_TEST_ASSERT(INSKTestNear(predicted.x, position.x) && INSKTestNear(predicted.y, position.y),
+                                 "mode %d bounces %d velocity %f: predicted %f, %f but rests at %f, %f", (int)modes[modeIndex], bounces, (double)velocity,
+                                 (double)predicted.x, (double)predicted.y, (double)position.x, (double)position.y);
+            }
+        }
+    }
+
+    INSKScrollPhysics physics = INSKTestPhysics(INSKScrollPhysicsModeNone);
+    INSKScrollPhysicsScrollTo(&physics, CGPointMake(0, 99999), 1.0, 0.0);
+    INSK_TEST_ASSERT(INSKScrollPhysicsRestingPosition(&physics).y == 4320, "scroll animation predicted beyond the limit");
+    INSKScrollPhysicsStop(&physics);
+    INSK_TEST_ASSERT(INSKScrollPhysicsRestingPosition(&physics).y == INSKScrollPhysicsPosition(&physics).y, "resting physics predicted elsewhere");
+}
+
+
+int main(void) {
+    test_setup_clampsIntoLimits();
+    test_drag_stopsAtLimitsWithoutBouncing();
+    test_drag_rubberBandsBeyondLimits();
+    test_deceleration_isClosedForm();
+    test_deceleration_endsAtLimits();
+    test_deceleration_isIndependentOfFrameRate();
+    test_paging_snapsToPages();
+    test_scrollTo_deceleratesToTarget();
+    test_restingPosition_predictsEndOfMotion();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,348 @@
+// A command line tool which measures hit testing with INSKSpatialIndex.h against a scan over all nodes of synthetic scene trees.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKSpatialIndexBenchmark.c INSpriteKit/INSKSpatialIndex.c INSpriteKit/INSKInstrumentation.c -lm -o insk-spatial-index-benchmark
+//
+// Usage:
+//   insk-spatial-index-benchmark [-queries count] [-moved percent]
+//
+// Builds trees of 100 up to 100'000 rotated and scaled nodes in a 1024 x 768 scene, eight children per node,
+// and hit tests random points the way INSKView does it without an index, which is a walk over the whole tree
+// converting the point into each node like SKNode's nodesAtPoint:, and with the index, which only tests the nodes whose
+// axis aligned bounds in the scene contain the point. Both have to find the same nodes.
+// Afterwards the given percentage of leaf nodes is moved per frame and the index is updated once for only the moved nodes
+// and once for all nodes, which is what a refit without tracking the changed nodes has to do.
+// Prints the nanoseconds per query for both ways, the average number of candidates of the index,
+// the nanoseconds per node for building the index and the nanoseconds per frame for both updates.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "INSKSpatialIndex.h"
+#include "INSKInstrumentation.h"
+
+
+// The measured tree sizes.
+static const size_t INSKBenchmarkNodeCounts[] = {100, 1000, 10000, 100000};
+#define INSKBenchmarkNodeCountCount (sizeof(INSKBenchmarkNodeCounts) / sizeof(INSKBenchmarkNodeCounts[0]))
+
+// The number of children of each inner node.
+#define INSKBenchmarkBranching 8
+// The number of frames with moved nodes.
+#define INSKBenchmarkMoveFrames 100
+
+// The scene.
+#define INSKBenchmarkSceneWidth 1024.0
+#define INSKBenchmarkSceneHeight 768.0
+
+// Used to keep the compiler from removing the loops.
+static volatile size_t INSKBenchmarkSink;
+
+
+// A 2D affine transformation, the same layout as CGAffineTransform.
+typedef struct {
+    double a, b, c, d, tx, ty;
+} INSKBenchmarkTransform;
+
+// A node of the synthetic tree, parents always come before their children.
+typedef struct {
+    size_t parent;
+    // The transformation into the parent and back.
+    INSKBenchmarkTransform toParent;
+    INSKBenchmarkTransform fromParent;
+    // The transformation from the scene into the node.
+    INSKBenchmarkTransform fromScene;
+    // The node's frame in its own coordinate system is centered at the origin.
+    double halfWidth;
+    double halfHeight;
+    INSKSpatialIndexHandle handle;
+} INSKBenchmarkNode;
+
+typedef struct {
+    INSKBenchmarkNode *nodes;
+    size_t count;
+    // The indexes of the first child of each node, the children of a node are consecutive.
+    size_t *firstChild;
+    size_t *childCount;
+} INSKBenchmarkTree;
+
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKBenchmarkRandomState = 1;
+
+static double INSKBenchmarkRandom(double min, double max) {
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState << 13;
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState >> 17;
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState << 5;
+    return min + (max - min) * (INSKBenchmarkRandomState / 4294967296.0);
+}
+
+static INSKBenchmarkTransform INSKBenchmarkTransformConcat(INSKBenchmarkTransform t1, INSKBenchmarkTransform t2) {
+    INSKBenchmarkTransform result = {
+        t1.a * t2.a + t1.b * t2.c, t1.a * t2.b + t1.b * t2.d,
+        t1.c * t2.a + t1.d * t2.c, t1.c * t2.b + t1.d * t2.d,
+        t1.tx * t2.a + t1.ty * t2.c + t2.tx, t1.tx * t2.b + t1.ty * t2.d + t2.ty
+    };
+    return result;
+}
+
+static void INSKBenchmarkTransformApply(INSKBenchmarkTransform t, double x, double y, double *resultX, double *resultY) {
+    *resultX = t.a * x + t.c * y + t.tx;
+    *resultY = t.b * x + t.d * y + t.ty;
+}
+
+// Sets the position, rotation and scale of a node like SKNode's properties do.
+static void INSKBenchmarkNodeSetTransform(INSKBenchmarkNode *node, double x, double y, double rotation, double scale) {
+    double cosine = cos(rotation);
+    double sine = sin(rotation);
+    INSKBenchmarkTransform toParent = {cosine * scale, sine * scale, -sine * scale, cosine * scale, x, y};
+    INSKBenchmarkTransform fromParent = {cosine / scale, -sine / scale, sine / scale, cosine / scale, 0.0, 0.0};
+    fromParent.tx = -(fromParent.a * x + fromParent.c * y);
+    fromParent.ty = -(fromParent.b * x + fromParent.d * y);
+    node->toParent = toParent;
+    node->fromParent = fromParent;
+}
+
+// Calculates the transformation from the scene into a node, the parent's one has to be up to date.
+static void INSKBenchmarkNodeUpdateFromScene(INSKBenchmarkTree *tree, size_t index) {
+    INSKBenchmarkNode *node = &tree->nodes[index];
+    if (index == 0) {
+        node->fromScene = node->fromParent;
+    } else {
+        node->fromScene = INSKBenchmarkTransformConcat(tree->nodes[node->parent].fromScene, node->fromParent);
+    }
+}
+
+// Returns the axis aligned bounds of the node's frame in the scene, which needs the transformation into the scene.
+static INSKSpatialBounds INSKBenchmarkNodeBounds(const INSKBenchmarkTree *tree, size_t index) {
+    const INSKBenchmarkNode *node = &tree->nodes[index];
+    // Walk up the tree like SKNode's convertPoint:toNode: does.
+    INSKBenchmarkTransform toScene = node->toParent;
+    for (size_t ancestor = node->parent; ancestor != (size_t)-1; ancestor = tree->nodes[ancestor].parent) {
+        toScene = INSKBenchmarkTransformConcat(toScene, tree->nodes[ancestor].toParent);
+    }
+    INSKSpatialBounds bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    for (int corner = 0; corner < 4; ++corner) {
+        double x, y;
+        INSKBenchmarkTransformApply(toScene, (corner & 1) ? node->halfWidth : -node->halfWidth, (corner & 2) ? node->halfHeight : -node->halfHeight, &x, &y);
+        bounds.minX = fmin(bounds.minX, x);
+        bounds.minY = fmin(bounds.minY, y);
+        bounds.maxX = fmax(bounds.maxX, x);
+        bounds.maxY = fmax(bounds.maxY, y);
+    }
+    return bounds;
+}
+
+static bool INSKBenchmarkNodeContains(const INSKBenchmarkNode *node, double x, double y) {
+    return fabs(x) <= node->halfWidth && fabs(y) <= node->halfHeight;
+}
+
+// Builds a tree where the nodes get smaller with each level, the root is the scene.
+static bool INSKBenchmarkTreeCreate(INSKBenchmarkTree *tree, size_t count) {
+    tree->nodes = (INSKBenchmarkNode *)calloc(count, sizeof(INSKBenchmarkNode));
+    tree->firstChild = (size_t *)calloc(count, sizeof(size_t));
+    tree->childCount = (size_t *)calloc(count, sizeof(size_t));
+    tree->count = count;
+    if (tree->nodes == NULL || tree->firstChild == NULL || tree->childCount == NULL) {
+        return false;
+    }
+
+    INSKBenchmarkNode *root = &tree->nodes[0];
+    root->parent = (size_t)-1;
+    INSKBenchmarkNodeSetTransform(root, 0.0, 0.0, 0.0, 1.0);
+    root->halfWidth = INSKBenchmarkSceneWidth / 2.0;
+    root->halfHeight = INSKBenchmarkSceneHeight / 2.0;
+    INSKBenchmarkNodeUpdateFromScene(tree, 0);
+    for (size_t index = 1; index < count; ++index) {
+        size_t parentIndex = (index - 1) / INSKBenchmarkBranching;
+        INSKBenchmarkNode *node = &tree->nodes[index];
+        const INSKBenchmarkNode *parent = &tree->nodes[parentIndex];
+        if (tree->childCount[parentIndex] == 0) {
+            tree->firstChild[parentIndex] = index;
+        }
+        tree->childCount[parentIndex]++;
+        node->parent = parentIndex;
+        // Children are spread over their parent's frame and are about a third of its size.
+        double x = INSKBenchmarkRandom(-parent->halfWidth, parent->halfWidth);
+        double y = INSKBenchmarkRandom(-parent->halfHeight, parent->halfHeight);
+        INSKBenchmarkNodeSetTransform(node, x, y, INSKBenchmarkRandom(-0.5, 0.5), INSKBenchmarkRandom(0.8, 1.2));
+        node->halfWidth = fmax(parent->halfWidth * INSKBenchmarkRandom(0.2, 0.4), 4.0);
+        node->halfHeight = fmax(parent->halfHeight * INSKBenchmarkRandom(0.2, 0.4), 4.0);
+        INSKBenchmarkNodeUpdateFromScene(tree, index);
+    }
+    return true;
+}
+
+static void INSKBenchmarkTreeDestroy(INSKBenchmarkTree *tree) {
+    free(tree->nodes);
+    free(tree->firstChild);
+    free(tree->childCount);
+}
+
+// Walks the tree and converts the point into each node like nodesAtPoint: does, returns the number of hit nodes.
+static size_t INSKBenchmarkScanNode(const INSKBenchmarkTree *tree, size_t index, double x, double y) {
+    size_t hits = 0;
+    size_t first = tree->firstChild[index];
+    for (size_t child = first; child < first + tree->childCount[index]; ++child) {
+        const INSKBenchmarkNode *node = &tree->nodes[child];
+        double nodeX, nodeY;
+        INSKBenchmarkTransformApply(node->fromParent, x, y, &nodeX, &nodeY);
+        hits += INSKBenchmarkNodeContains(node, nodeX, nodeY) ? 1 : 0;
+        hits += INSKBenchmarkScanNode(tree, child, nodeX, nodeY);
+    }
+    return hits;
+}
+
+typedef struct {
+    const INSKBenchmarkTree *tree;
+    double x;
+    double y;
+    size_t candidates;
+    size_t hits;
+} INSKBenchmarkQuery;
+
+// Tests a candidate of the index with its transformation from the scene.
+static void INSKBenchmarkTestCandidate(void *object, void *context) {
+    INSKBenchmarkQuery *query = (INSKBenchmarkQuery *)context;
+    const INSKBenchmarkNode *node = &query->tree->nodes[(size_t)(uintptr_t)object];
+    double nodeX, nodeY;
+    INSKBenchmarkTransformApply(node->fromScene, query->x, query->y, &nodeX, &nodeY);
+    query->candidates++;
+    query->hits += INSKBenchmarkNodeContains(node, nodeX, nodeY) ? 1 : 0;
+}
+
+static bool INSKBenchmarkBuildIndex(INSKSpatialIndex *index, INSKBenchmarkTree *tree) {
+    INSKSpatialBounds world = {-INSKBenchmarkSceneWidth / 2.0, -INSKBenchmarkSceneHeight / 2.0, INSKBenchmarkSceneWidth / 2.0, INSKBenchmarkSceneHeight / 2.0};
+    INSKSpatialIndexReset(index, world);
+    for (size_t node = 1; node < tree->count; ++node) {
+        tree->nodes[node].handle = INSKSpatialIndexInsert(index, INSKBenchmarkNodeBounds(tree, node), (void *)(uintptr_t)node);
+        if (tree->nodes[node].handle == INSKSpatialIndexInvalidHandle) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Moves some leaves and returns their indexes in moved, which needs space for all nodes.
+static size_t INSKBenchmarkMoveLeaves(INSKBenchmarkTree *tree, double percent, size_t *moved) {
+    size_t firstLeaf = (tree->count - 1) / INSKBenchmarkBranching + 1;
+    size_t leafCount = tree->count - firstLeaf;
+    size_t count = (size_t)(leafCount * percent / 100.0);
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = firstLeaf + (size_t)INSKBenchmarkRandom(0.0, (double)leafCount);
+        INSKBenchmarkNode *node = &tree->nodes[index];
+        INSKBenchmarkNodeSetTransform(node, node->toParent.tx + INSKBenchmarkRandom(-4.0, 4.0), node->toParent.ty + INSKBenchmarkRandom(-4.0, 4.0), INSKBenchmarkRandom(-0.5, 0.5), 1.0);
+        INSKBenchmarkNodeUpdateFromScene(tree, index);
+        moved[i] = index;
+    }
+    return count;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t queryCount = 10000;
+    double movedPercent = 1.0;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-queries") == 0 && argument + 1 < argc) {
+            queryCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-moved") == 0 && argument + 1 < argc) {
+            movedPercent = strtod(argv[++argument], NULL);
+        } else {
+            fprintf(stderr, "usage: %s [-queries count] [-moved percent]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (queryCount == 0) {
+        queryCount = 1;
+    }
+    movedPercent = fmin(fmax(movedPercent, 0.0), 100.0);
+
+    printf("queries %zu moved %.2f%%\n", queryCount, movedPercent);
+    printf("%8s %12s %12s %9s %11s %12s %14s %14s\n", "nodes", "scan ns/q", "index ns/q", "speedup", "candidates", "build ns/n", "moved ns/fr", "refit ns/fr");
+    int result = 0;
+    for (size_t sizeIndex = 0; sizeIndex < INSKBenchmarkNodeCountCount; ++sizeIndex) {
+        size_t count = INSKBenchmarkNodeCounts[sizeIndex];
+        INSKBenchmarkTree tree;
+        INSKSpatialBounds empty = {0.0, 0.0, 0.0, 0.0};
+        INSKSpatialIndex *index = INSKSpatialIndexCreate(empty, 8);
+        size_t *moved = (size_t *)malloc(count * sizeof(size_t));
+        double *points = (double *)malloc(2 * queryCount * sizeof(double));
+        if (!INSKBenchmarkTreeCreate(&tree, count) || index == NULL || moved == NULL || points == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        for (size_t query = 0; query < queryCount; ++query) {
+            points[2 * query] = INSKBenchmarkRandom(-INSKBenchmarkSceneWidth / 2.0, INSKBenchmarkSceneWidth / 2.0);
+            points[2 * query + 1] = INSKBenchmarkRandom(-INSKBenchmarkSceneHeight / 2.0, INSKBenchmarkSceneHeight / 2.0);
+        }
+
+        uint64_t start = INSKInstrumentationNow();
+        bool built = INSKBenchmarkBuildIndex(index, &tree);
+        double buildTime = (double)(INSKInstrumentationNow() - start) / (double)count;
+        if (!built) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+
+        // The scan's queries are fewer for big trees to keep the run short, the time is per query anyway.
+        size_t scanQueryCount = (count >= 10000) ? queryCount / 10 + 1 : queryCount;
+        size_t scanHits = 0;
+        start = INSKInstrumentationNow();
+        for (size_t query = 0; query < scanQueryCount; ++query) {
+            scanHits += INSKBenchmarkScanNode(&tree, 0, points[2 * query], points[2 * query + 1]);
+        }
+        double scanTime = (double)(INSKInstrumentationNow() - start) / (double)scanQueryCount;
+        INSKBenchmarkSink = scanHits;
+
+        INSKBenchmarkQuery query = {&tree, 0.0, 0.0, 0, 0};
+        size_t indexHitsOfScanQueries = 0;
+        start = INSKInstrumentationNow();
+        for (size_t point = 0; point < queryCount; ++point) {
+            if (point == scanQueryCount) {
+                indexHitsOfScanQueries = query.hits;
+            }
+            query.x = points[2 * point];
+            query.y = points[2 * point + 1];
+            INSKSpatialIndexQueryPoint(index, query.x, query.y, INSKBenchmarkTestCandidate, &query);
+        }
+        double indexTime = (double)(INSKInstrumentationNow() - start) / (double)queryCount;
+        if (scanQueryCount == queryCount) {
+            indexHitsOfScanQueries = query.hits;
+        }
+        if (indexHitsOfScanQueries != scanHits) {
+            fprintf(stderr, "%zu nodes: the index found %zu nodes, the scan %zu\n", count, indexHitsOfScanQueries, scanHits);
+            result = 1;
+        }
+
+        // Update only the moved nodes.
+        uint64_t movedTime = 0;
+        uint64_t refitTime = 0;
+        for (unsigned int frame = 0; frame < INSKBenchmarkMoveFrames; ++frame) {
+            size_t movedCount = INSKBenchmarkMoveLeaves(&tree, movedPercent, moved);
+            start = INSKInstrumentationNow();
+            for (size_t i = 0; i < movedCount; ++i) {
+                INSKBenchmarkNode *node = &tree.nodes[moved[i]];
+                INSKSpatialIndexUpdate(index, node->handle, INSKBenchmarkNodeBounds(&tree, moved[i]));
+            }
+            movedTime += INSKInstrumentationNow() - start;
+
+            // Update all nodes like without knowing the moved ones.
+            start = INSKInstrumentationNow();
+            for (size_t node = 1; node < count; ++node) {
+                INSKSpatialIndexUpdate(index, tree.nodes[node].handle, INSKBenchmarkNodeBounds(&tree, node));
+            }
+            refitTime += INSKInstrumentationNow() - start;
+        }
+
+        printf("%8zu %12.1f %12.1f %8.1fx %11.2f %12.1f %14.1f %14.1f\n", count, scanTime, indexTime, scanTime / indexTime, (double)query.candidates / (double)queryCount, buildTime,
+               (double)movedTime / INSKBenchmarkMoveFrames, (double)refitTime / INSKBenchmarkMoveFrames);
+
+        INSKSpatialIndexDestroy(index);
+        INSKBenchmarkTreeDestroy(&tree);
+        free(moved);
+        free(points);
+    }
+    return result;
+}
@@ -0,0 +1,339 @@
+// Tests INSKSpatialIndex.h by comparing the query results with a brute force scan over random objects.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKSpatialIndexTests.c INSpriteKit/INSKSpatialIndex.c -lm -o insk-spatial-index-tests && ./insk-spatial-index-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "INSKSpatialIndex.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The number of objects of the random sets.
+#define INSKTestObjectCount 3000
+// The number of queries per comparison.
+#define INSKTestQueryCount 500
+
+// The world of the random sets.
+static const INSKSpatialBounds INSKTestWorld = {-512.0, -384.0, 512.0, 384.0};
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKTestRandomState = 1;
+
+static double INSKTestRandom(double min, double max) {
+    INSKTestRandomState ^= INSKTestRandomState << 13;
+    INSKTestRandomState ^= INSKTestRandomState >> 17;
+    INSKTestRandomState ^= INSKTestRandomState << 5;
+    return min + (max - min) * (INSKTestRandomState / 4294967296.0);
+}
+
+static INSKSpatialBounds INSKTestBounds(double x, double y, double width, double height) {
+    INSKSpatialBounds bounds = {x, y, x + width, y + height};
+    return bounds;
+}
+
+// Returns random bounds, mostly small ones inside of the world, but also big ones, empty ones and ones outside of the world.
+static INSKSpatialBounds INSKTestRandomBounds(void) {
+    double kind = INSKTestRandom(0.0, 1.0);
+    double x = INSKTestRandom(-600.0, 600.0);
+    double y = INSKTestRandom(-450.0, 450.0);
+    if (kind < 0.05) {
+        return INSKTestBounds(x, y, 0.0, 0.0);
+    } else if (kind < 0.1) {
+        return INSKTestBounds(INSKTestRandom(-2000.0, 0.0), INSKTestRandom(-2000.0, 0.0), INSKTestRandom(0.0, 4000.0), INSKTestRandom(0.0, 4000.0));
+    } else if (kind < 0.2) {
+        return INSKTestBounds(x, y, INSKTestRandom(0.0, 600.0), INSKTestRandom(0.0, 400.0));
+    }
+    return INSKTestBounds(x, y, INSKTestRandom(0.0, 40.0), INSKTestRandom(0.0, 40.0));
+}
+
+static bool INSKTestContainsPoint(INSKSpatialBounds bounds, double x, double y) {
+    return x >= bounds.minX && x <= bounds.maxX && y >= bounds.minY && y <= bounds.maxY;
+}
+
+static bool INSKTestIntersect(INSKSpatialBounds bounds, INSKSpatialBounds other) {
+    return bounds.minX <= other.maxX && bounds.maxX >= other.minX && bounds.minY <= other.maxY && bounds.maxY >= other.minY;
+}
+
+
+// The objects of a test set, each object's pointer is its position plus one.
+typedef struct {
+    INSKSpatialIndex *index;
+    INSKSpatialBounds bounds[INSKTestObjectCount];
+    INSKSpatialIndexHandle handles[INSKTestObjectCount];
+    bool inserted[INSKTestObjectCount];
+    // Counts how often each object has been visited by a query.
+    unsigned int visits[INSKTestObjectCount];
+    // Set if the visitor got an object which isn't in the set.
+    bool unknownObject;
+} INSKTestSet;
+
+static void *INSKTestObject(size_t object) {
+    return (void *)(uintptr_t)(object + 1);
+}
+
+static void INSKTestVisit(void *object, void *context) {
+    INSKTestSet *set = (INSKTestSet *)context;
+    size_t position = (size_t)(uintptr_t)object;
+    if (position == 0 || position > INSKTestObjectCount || !set->inserted[position - 1]) {
+        set->unknownObject = true;
+        return;
+    }
+    set->visits[position - 1]++;
+}
+
+static void INSKTestInsert(INSKTestSet *set, size_t object, INSKSpatialBounds bounds) {
+    set->bounds[object] = bounds;
+    set->handles[object] = INSKSpatialIndexInsert(set->index, bounds, INSKTestObject(object));
+    set->inserted[object] = (set->handles[object] != INSKSpatialIndexInvalidHandle);
+}
+
+// Returns the number of objects of the set whose visits don't match a point query, or a rect query if rect isn't NULL.
+static size_t INSKTestMismatches(INSKTestSet *set, double x, double y, const INSKSpatialBounds *rect) {
+    size_t mismatches = set->unknownObject ? 1 : 0;
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        bool expected = (rect != NULL) ? INSKTestIntersect(set->bounds[object], *rect) : INSKTestContainsPoint(set->bounds[object], x, y);
+        unsigned int expectedVisits = (set->inserted[object] && expected) ? 1 : 0;
+        if (set->visits[object] != expectedVisits) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Queries random points and rects and compares the visited objects with a brute force scan.
+static void INSKTestCompareQueries(INSKTestSet *set, const char *name) {
+    size_t failedQueries = 0;
+    size_t insertedCount = 0;
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        insertedCount += set->inserted[object] ? 1 : 0;
+    }
+    INSK_TEST_ASSERT(INSKSpatialIndexCount(set->index) == insertedCount, "%s: count %zu instead of %zu", name, INSKSpatialIndexCount(set->index), insertedCount);
+
+    for (size_t query = 0; query < INSKTestQueryCount; ++query) {
+        double x = INSKTestRandom(-700.0, 700.0);
+        double y = INSKTestRandom(-500.0, 500.0);
+        // Also query exactly at the borders of objects.
+        if (query % 5 == 0) {
+            INSKSpatialBounds bounds = set->bounds[query % INSKTestObjectCount];
+            x = (query % 2 == 0) ? bounds.minX : bounds.maxX;
+            y = (query % 3 == 0) ? bounds.minY : bounds.maxY;
+        }
+        memset(set->visits, 0, sizeof(set->visits));
+        set->unknownObject = false;
+        size_t found = INSKSpatialIndexQueryPoint(set->index, x, y, INSKTestVisit, set);
+        size_t expectedFound = 0;
+        for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+            expectedFound += (set->inserted[object] && INSKTestContainsPoint(set->bounds[object], x, y)) ? 1 : 0;
+        }
+        if (found != expectedFound || INSKTestMismatches(set, x, y, NULL) > 0) {
+            failedQueries++;
+        }
+
+        INSKSpatialBounds rect = INSKTestBounds(x, y, INSKTestRandom(0.0, 200.0), INSKTestRandom(0.0, 200.0));
+        memset(set->visits, 0, sizeof(set->visits));
+        set->unknownObject = false;
+        INSKSpatialIndexQueryBounds(set->index, rect, INSKTestVisit, set);
+        if (INSKTestMismatches(set, 0.0, 0.0, &rect) > 0) {
+            failedQueries++;
+        }
+    }
+    INSK_TEST_ASSERT(failedQueries == 0, "%s: %zu queries differ from the brute force scan", name, failedQueries);
+}
+
+static void INSKTestSetUp(INSKTestSet *set, unsigned int maxDepth) {
+    memset(set, 0, sizeof(*set));
+    set->index = INSKSpatialIndexCreate(INSKTestWorld, maxDepth);
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        INSKTestInsert(set, object, INSKTestRandomBounds());
+    }
+}
+
+
+// insert and query
+
+static void test_query_matchesBruteForce(void) {
+    static INSKTestSet set;
+    unsigned int depths[] = {0, 1, 4, 8, 12, 100};
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); ++i) {
+        INSKTestSetUp(&set, depths[i]);
+        for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+            INSK_TEST_ASSERT(set.inserted[object], "object %zu not inserted for depth %u", object, depths[i]);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "insert depth %u", depths[i]);
+        INSKTestCompareQueries(&set, name);
+        INSKSpatialIndexDestroy(set.index);
+    }
+}
+
+
+// remove
+
+static void test_remove_dropsObjectsAndReusesHandles(void) {
+    static INSKTestSet set;
+    INSKTestSetUp(&set, 8);
+    for (size_t object = 0; object < INSKTestObjectCount; object += 2) {
+        INSKSpatialIndexRemove(set.index, set.handles[object]);
+        set.inserted[object] = false;
+    }
+    INSKTestCompareQueries(&set, "remove every second");
+
+    // The freed entries are used again, so the handles stay below the number of objects.
+    for (size_t object = 0; object < INSKTestObjectCount; object += 2) {
+        INSKTestInsert(&set, object, INSKTestRandomBounds());
+        INSK_TEST_ASSERT(set.handles[object] < INSKTestObjectCount, "handle %zu of a reinserted object not reused", set.handles[object]);
+    }
+    INSKTestCompareQueries(&set, "reinsert");
+
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        INSKSpatialIndexRemove(set.index, set.handles[object]);
+        set.inserted[object] = false;
+    }
+    INSKTestCompareQueries(&set, "remove all");
+    INSKSpatialIndexDestroy(set.index);
+}
+
+
+// refit
+
+static void test_update_movesObjects(void) {
+    static INSKTestSet set;
+    INSKTestSetUp(&set, 8);
+    // Small moves mostly stay in their tree node.
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        INSKSpatialBounds bounds = set.bounds[object];
+        double dx = INSKTestRandom(-2.0, 2.0);
+        double dy = INSKTestRandom(-2.0, 2.0);
+        bounds = INSKTestBounds(bounds.minX + dx, bounds.minY + dy, bounds.maxX - bounds.minX, bounds.maxY - bounds.minY);
+        INSK_TEST_ASSERT(INSKSpatialIndexUpdate(set.index, set.handles[object], bounds), "update of object %zu failed", object);
+        set.bounds[object] = bounds;
+    }
+    INSKTestCompareQueries(&set, "small moves");
+
+    // Big moves and size changes move the objects to other tree nodes, some out of the world and back.
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        INSKSpatialBounds bounds = INSKTestRandomBounds();
+        INSK_TEST_ASSERT(INSKSpatialIndexUpdate(set.index, set.handles[object], bounds), "update of object %zu failed", object);
+        set.bounds[object] = bounds;
+    }
+    INSKTestCompareQueries(&set, "big moves");
+    INSKSpatialIndexDestroy(set.index);
+}
+
+
+// loose bounds edge cases
+
+static void test_edges_areFound(void) {
+    static INSKTestSet set;
+    memset(&set, 0, sizeof(set));
+    set.index = INSKSpatialIndexCreate(INSKTestWorld, 8);
+    size_t object = 0;
+    // Objects centered exactly on the cell borders of several levels.
+    double borders[] = {-512.0, -256.0, -128.0, 0.0, 64.0, 256.0, 512.0};
+    for (size_t i = 0; i < sizeof(borders) / sizeof(borders[0]); ++i) {
+        for (size_t j = 0; j < sizeof(borders) / sizeof(borders[0]); ++j) {
+            INSKTestInsert(&set, object++, INSKTestBounds(borders[i] - 1.0, borders[j] - 1.0, 2.0, 2.0));
+            INSKTestInsert(&set, object++, INSKTestBounds(borders[i], borders[j], 0.0, 0.0));
+        }
+    }
+    // Objects exactly as big as a cell of the different levels, which fit into the loose bounds but not into the cell.
+    for (double size = 4.0; size <= 1024.0; size *= 2.0) {
+        INSKTestInsert(&set, object++, INSKTestBounds(-size / 2.0 + 3.0, -size / 2.0 - 5.0, size, size));
+        INSKTestInsert(&set, object++, INSKTestBounds(100.0, 100.0, size, size / 8.0));
+    }
+    // Objects at the world's edges and far away.
+    INSKTestInsert(&set, object++, INSKTestBounds(511.0, 383.0, 1.0, 1.0));
+    INSKTestInsert(&set, object++, INSKTestBounds(-512.0, -384.0, 1.0, 1.0));
+    INSKTestInsert(&set, object++, INSKTestBounds(1e6, -1e6, 10.0, 10.0));
+    INSKTestInsert(&set, object++, INSKTestBounds(-1e9, -1e9, 2e9, 2e9));
+    size_t edgeObjects = object;
+
+    // Test each object with points at all of its corners and its center.
+    size_t failures = 0;
+    for (size_t tested = 0; tested < edgeObjects; ++tested) {
+        INSKSpatialBounds bounds = set.bounds[tested];
+        double xs[] = {bounds.minX, (bounds.minX + bounds.maxX) / 2.0, bounds.maxX};
+        double ys[] = {bounds.minY, (bounds.minY + bounds.maxY) / 2.0, bounds.maxY};
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                memset(set.visits, 0, sizeof(set.visits));
+                INSKSpatialIndexQueryPoint(set.index, xs[i], ys[j], INSKTestVisit, &set);
+                if (set.visits[tested] != 1) {
+                    failures++;
+                }
+            }
+        }
+    }
+    INSK_TEST_ASSERT(failures == 0, "%zu border points not found", failures);
+    INSKTestCompareQueries(&set, "edges");
+    INSKSpatialIndexDestroy(set.index);
+}
+
+static void test_degeneratedWorld_keepsObjectsInRoot(void) {
+    static INSKTestSet set;
+    memset(&set, 0, sizeof(set));
+    INSKSpatialBounds empty = {0.0, 0.0, 0.0, 0.0};
+    set.index = INSKSpatialIndexCreate(empty, 8);
+    for (size_t object = 0; object < 200; ++object) {
+        INSKTestInsert(&set, object, INSKTestRandomBounds());
+    }
+    INSKTestCompareQueries(&set, "empty world");
+
+    // Reset clears all objects and takes the new world.
+    INSKSpatialIndexReset(set.index, INSKTestWorld);
+    INSK_TEST_ASSERT(INSKSpatialIndexCount(set.index) == 0, "reset index not empty");
+    memset(set.inserted, 0, sizeof(set.inserted));
+    for (size_t object = 0; object < INSKTestObjectCount; ++object) {
+        INSKTestInsert(&set, object, INSKTestRandomBounds());
+    }
+    INSKTestCompareQueries(&set, "reset");
+    INSKSpatialIndexDestroy(set.index);
+}
+
+static void test_invalidBounds_neverMatch(void) {
+    INSKSpatialIndex *index = INSKSpatialIndexCreate(INSKTestWorld, 8);
+    INSKSpatialBounds invalid = {NAN, 0.0, NAN, 10.0};
+    INSK_TEST_ASSERT(INSKSpatialIndexInsert(index, invalid, INSKTestObject(0)) != INSKSpatialIndexInvalidHandle, "invalid bounds not inserted");
+    static INSKTestSet set;
+    memset(&set, 0, sizeof(set));
+    set.inserted[0] = true;
+    size_t found = INSKSpatialIndexQueryPoint(index, 5.0, 5.0, INSKTestVisit, &set);
+    found += INSKSpatialIndexQueryBounds(index, INSKTestWorld, INSKTestVisit, &set);
+    INSK_TEST_ASSERT(found == 0, "invalid bounds found %zu times", found);
+    INSKSpatialIndexDestroy(index);
+    INSKSpatialIndexDestroy(NULL);
+}
+
+
+int main(void) {
+    test_query_matchesBruteForce();
+    test_remove_dropsObjectsAndReusesHandles();
+    test_update_movesObjects();
+    test_edges_areFound();
+    test_degeneratedWorld_keepsObjectsInRoot();
+    test_invalidBounds_neverMatch();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
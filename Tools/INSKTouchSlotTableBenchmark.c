@@ -0,0 +1,176 @@
+// A command line tool which replays ten fingers touching at 120 Hz through INSKTouchSlotTable and INSKInputReplay and prints the cost per event.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKTouchSlotTableBenchmark.c INSpriteKit/INSKInputReplay.c INSpriteKit/INSKInputRecording.c INSpriteKit/INSKInstrumentation.c INSpriteKit/INSKSpatialIndex.c INSpriteKit/INSKTouchSlotTable.c -lm -o insk-touch-slot-table-benchmark
+//
+// Usage:
+//   insk-touch-slot-table-benchmark [-fingers count] [-seconds value] [-nodes count] [-iterations count]
+//
+// Each finger touches down, moves every 1/120 s for up to a second, lifts and touches down again; the first two fingers always touch
+// at the same location. Prints the nanoseconds per event of the slot table alone, the number of events which didn't find the value
+// of their touch, and the p50/p99 latencies of the complete replay including the hit test against a synthetic scene.
+// Recorded sessions can be replayed the same way with Tools/INSKInputReplayTool.c.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKInputReplay.h"
+#include "INSKInstrumentation.h"
+#include "INSKTouchSlotTable.h"
+
+
+// Used to keep the compiler from removing the loops.
+static volatile uintptr_t INSKBenchmarkSink;
+
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKBenchmarkRandomState = 1;
+
+static double INSKBenchmarkRandom(double min, double max) {
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState << 13;
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState >> 17;
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState << 5;
+    return min + (max - min) * (INSKBenchmarkRandomState / 4294967296.0);
+}
+
+// Adds the events of fingers touching for the given seconds at 120 Hz to a recording.
+static bool INSKBenchmarkAppendFingers(INSKInputRecording *recording, size_t fingerCount, double seconds, INSKSpatialBounds worldBounds) {
+    INSKInputEvent *fingers = (INSKInputEvent *)calloc(fingerCount, sizeof(INSKInputEvent));
+    // The frame at which each finger lifts.
+    size_t *endFrames = (size_t *)calloc(fingerCount, sizeof(size_t));
+    if (fingers == NULL || endFrames == NULL) {
+        free(fingers);
+        free(endFrames);
+        return false;
+    }
+    bool success = true;
+    uint32_t touchId = 1;
+    size_t frameCount = (size_t)(seconds * 120.0);
+    for (size_t frame = 0; success && frame <= frameCount; ++frame) {
+        for (size_t finger = 0; success && finger < fingerCount; ++finger) {
+            INSKInputEvent *event = &fingers[finger];
+            event->timestamp = frame / 120.0;
+            if (event->phase == 0 || event->phase == INSKInputPhaseEnded) {
+                // Touch down with a new touch.
+                event->touchId = touchId++;
+                event->phase = INSKInputPhaseBegan;
+                if (finger == 1) {
+                    event->x = fingers[0].x;
+                    event->y = fingers[0].y;
+                } else {
+                    event->x = (float)INSKBenchmarkRandom(worldBounds.minX, worldBounds.maxX);
+                    event->y = (float)INSKBenchmarkRandom(worldBounds.minY, worldBounds.maxY);
+                }
+                endFrames[finger] = frame + 1 + (size_t)INSKBenchmarkRandom(0.0, 120.0);
+            } else if (frame >= endFrames[finger] || frame == frameCount) {
+                event->phase = INSKInputPhaseEnded;
+            } else {
+                event->phase = INSKInputPhaseMoved;
+                event->x += (float)INSKBenchmarkRandom(-4.0, 4.0);
+                event->y += (float)INSKBenchmarkRandom(-4.0, 4.0);
+            }
+            success = INSKInputRecordingAppend(recording, event);
+        }
+    }
+    free(fingers);
+    free(endFrames);
+    return success;
+}
+
+// Returns the key of a touch, which looks like an object pointer as on a device.
+static uintptr_t INSKBenchmarkKey(uint32_t touchId) {
+    return 0x100000 + (uintptr_t)touchId * 48;
+}
+
+// Replays the events through a slot table only and returns the nanoseconds per event.
+static double INSKBenchmarkSlotTable(const INSKInputEvent *events, size_t eventCount, unsigned int iterations, size_t *lostEvents) {
+    INSKTouchSlotTable table;
+    *lostEvents = 0;
+    uint64_t time = 0;
+    for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+        INSKTouchSlotTableInit(&table);
+        uintptr_t sum = 0;
+        size_t lost = 0;
+        uint64_t start = INSKInstrumentationNow();
+        for (size_t index = 0; index < eventCount; ++index) {
+            const INSKInputEvent *event = &events[index];
+            uintptr_t key = INSKBenchmarkKey(event->touchId);
+            // The value is the touch identifier, so each lookup can be checked.
+            void *expected = (void *)(uintptr_t)event->touchId;
+            void *value;
+            if (event->phase == INSKInputPhaseBegan) {
+                value = INSKTouchSlotTableSet(&table, key, expected, NULL) ? expected : NULL;
+            } else if (event->phase == INSKInputPhaseMoved) {
+                value = INSKTouchSlotTableGet(&table, key);
+            } else {
+                value = INSKTouchSlotTableRemove(&table, key);
+            }
+            lost += (value != expected);
+            sum += (uintptr_t)value;
+        }
+        time += INSKInstrumentationNow() - start;
+        INSKBenchmarkSink = sum;
+        *lostEvents = lost;
+    }
+    return (double)time / ((double)eventCount * iterations);
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t fingerCount = 10;
+    double seconds = 10.0;
+    size_t nodeCount = 1000;
+    unsigned int iterations = 20;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-fingers") == 0 && argument + 1 < argc) {
+            fingerCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-seconds") == 0 && argument + 1 < argc) {
+            seconds = strtod(argv[++argument], NULL);
+        } else if (strcmp(argv[argument], "-nodes") == 0 && argument + 1 < argc) {
+            nodeCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-fingers count] [-seconds value] [-nodes count] [-iterations count]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (fingerCount == 0 || fingerCount > INSKTouchSlotTableCapacity) {
+        fprintf(stderr, "the number of fingers has to be between 1 and %d\n", INSKTouchSlotTableCapacity);
+        return 1;
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    // A scene of the size of a tablet screen.
+    INSKSpatialBounds worldBounds = {0.0, 0.0, 1024.0, 768.0};
+    INSKInputRecording *recording = INSKInputRecordingCreate();
+    INSKInputReplayNode *nodes = (INSKInputReplayNode *)calloc(nodeCount > 0 ? nodeCount : 1, sizeof(INSKInputReplayNode));
+    if (recording == NULL || nodes == NULL || !INSKBenchmarkAppendFingers(recording, fingerCount, seconds, worldBounds)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    INSKInputReplayFillRandomNodes(nodes, nodeCount, worldBounds, 1);
+    size_t eventCount = INSKInputRecordingCount(recording);
+
+    size_t lostEvents = 0;
+    double tableTime = INSKBenchmarkSlotTable(INSKInputRecordingEvents(recording), eventCount, iterations, &lostEvents);
+
+    INSKInputReplayScene scene = {nodes, nodeCount, NULL, 0};
+    INSKInputReplayResult result;
+    if (!INSKInputReplayRun(&scene, recording, iterations, &result)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("fingers %zu, %.1f s at 120 Hz, %zu events, %zu nodes, %u iterations\n", fingerCount, seconds, eventCount, nodeCount, iterations);
+    printf("slot table     %8.1f ns/event, %zu lost events\n", tableTime, lostEvents);
+    printf("replay         p50 %8.1f ns  p99 %8.1f ns  max %8.1f ns  mean %8.1f ns\n", result.p50, result.p99, result.max, result.mean);
+    printf("frame budget   %8.1f ns of 8333333 ns per frame for the table\n", tableTime * fingerCount);
+
+    free(nodes);
+    INSKInputRecordingDestroy(recording);
+    return lostEvents > 0 ? 1 : 0;
+}
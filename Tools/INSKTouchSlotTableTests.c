@@ -0,0 +1,321 @@
+// Tests INSKTouchSlotTable.h with colliding keys, clusters wrapping around the end of the slots, removals inside of clusters and a full table.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKTouchSlotTableTests.c INSpriteKit/INSKTouchSlotTable.c -o insk-touch-slot-table-tests && ./insk-touch-slot-table-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKTouchSlotTable.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The number of random operations compared with the reference.
+#define INSKTestOperationCount 200000
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKTestRandomState = 1;
+
+static uint32_t INSKTestRandom(void) {
+    INSKTestRandomState ^= INSKTestRandomState << 13;
+    INSKTestRandomState ^= INSKTestRandomState >> 17;
+    INSKTestRandomState ^= INSKTestRandomState << 5;
+    return INSKTestRandomState;
+}
+
+// Returns the preferred slot of a key, the same as the table calculates it.
+static size_t INSKTestPreferredSlot(uintptr_t key) {
+    uint64_t hash = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(hash >> 32) & (INSKTouchSlotTableCapacity - 1);
+}
+
+// Fills keys with aligned pointer like values which all prefer the given slot.
+static void INSKTestKeysForSlot(size_t slot, uintptr_t *keys, size_t count) {
+    uintptr_t key = 0x10000;
+    for (size_t found = 0; found < count; key += 16) {
+        if (INSKTestPreferredSlot(key) == slot) {
+            keys[found++] = key;
+        }
+    }
+}
+
+// Returns the slot holding a key or -1.
+static long INSKTestSlotOfKey(const INSKTouchSlotTable *table, uintptr_t key) {
+    for (size_t slot = 0; slot < INSKTouchSlotTableCapacity; ++slot) {
+        if (table->slots[slot].key == key) {
+            return (long)slot;
+        }
+    }
+    return -1;
+}
+
+// Returns a distinct value for a key.
+static void *INSKTestValue(uintptr_t key) {
+    return (void *)(key * 2 + 1);
+}
+
+
+// init
+
+static void test_init_isEmpty(void) {
+    INSKTouchSlotTable table;
+    memset(&table, 0xff, sizeof(table));
+    INSKTouchSlotTableInit(&table);
+    INSK_TEST_ASSERT(table.count == 0, "count is %zu after init", table.count);
+    for (size_t slot = 0; slot < INSKTouchSlotTableCapacity; ++slot) {
+        INSK_TEST_ASSERT(table.slots[slot].key == 0 && table.slots[slot].value == NULL, "slot %zu not empty after init", slot);
+    }
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, 0x1234) == NULL, "get on an empty table found a value");
+    INSK_TEST_ASSERT(INSKTouchSlotTableRemove(&table, 0x1234) == NULL, "remove on an empty table found a value");
+}
+
+
+// set and get
+
+static void test_set_replacesValueOfSameKey(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    void *previous = (void *)1;
+    INSK_TEST_ASSERT(INSKTouchSlotTableSet(&table, 0x1000, (void *)0xa, &previous), "set failed");
+    INSK_TEST_ASSERT(previous == NULL, "previous value of a new key is %p", previous);
+    INSK_TEST_ASSERT(INSKTouchSlotTableSet(&table, 0x1000, (void *)0xb, &previous), "set failed");
+    INSK_TEST_ASSERT(previous == (void *)0xa, "previous value is %p instead of 0xa", previous);
+    INSK_TEST_ASSERT(table.count == 1, "count is %zu after replacing", table.count);
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, 0x1000) == (void *)0xb, "get didn't return the replaced value");
+}
+
+static void test_set_rejectsKeyZero(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    INSK_TEST_ASSERT(!INSKTouchSlotTableSet(&table, 0, (void *)0xa, NULL), "key 0 has been accepted");
+    INSK_TEST_ASSERT(table.count == 0, "count is %zu after rejecting key 0", table.count);
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, 0) == NULL, "get found a value for key 0");
+}
+
+static void test_set_touchesAtSameLocationStaySeparate(void) {
+    // Two fingers at the same location are different touch objects, so they have different keys and keep their own nodes.
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    uintptr_t firstTouch = 0x7f0000a0;
+    uintptr_t secondTouch = 0x7f0000f0;
+    INSKTouchSlotTableSet(&table, firstTouch, (void *)0xa, NULL);
+    INSKTouchSlotTableSet(&table, secondTouch, (void *)0xb, NULL);
+    INSK_TEST_ASSERT(table.count == 2, "count is %zu for two touches", table.count);
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, firstTouch) == (void *)0xa, "first touch lost its value");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, secondTouch) == (void *)0xb, "second touch lost its value");
+    INSK_TEST_ASSERT(INSKTouchSlotTableRemove(&table, firstTouch) == (void *)0xa, "remove of the first touch failed");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, secondTouch) == (void *)0xb, "second touch lost its value after the first ended");
+}
+
+
+// collisions
+
+static void test_collisions_probeToFollowingSlots(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    uintptr_t keys[4];
+    INSKTestKeysForSlot(5, keys, 4);
+    for (size_t index = 0; index < 4; ++index) {
+        INSK_TEST_ASSERT(INSKTouchSlotTableSet(&table, keys[index], INSKTestValue(keys[index]), NULL), "set of colliding key %zu failed", index);
+    }
+    for (size_t index = 0; index < 4; ++index) {
+        INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keys[index]) == (long)(5 + index), "colliding key %zu is in slot %ld", index, INSKTestSlotOfKey(&table, keys[index]));
+        INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keys[index]) == INSKTestValue(keys[index]), "colliding key %zu lost its value", index);
+    }
+}
+
+static void test_collisions_wrapAroundTheEnd(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    size_t lastSlot = INSKTouchSlotTableCapacity - 1;
+    uintptr_t keys[3];
+    INSKTestKeysForSlot(lastSlot, keys, 3);
+    for (size_t index = 0; index < 3; ++index) {
+        INSKTouchSlotTableSet(&table, keys[index], INSKTestValue(keys[index]), NULL);
+    }
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keys[0]) == (long)lastSlot, "first key is in slot %ld", INSKTestSlotOfKey(&table, keys[0]));
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keys[1]) == 0, "second key didn't wrap around to slot 0");
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keys[2]) == 1, "third key didn't wrap around to slot 1");
+    for (size_t index = 0; index < 3; ++index) {
+        INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keys[index]) == INSKTestValue(keys[index]), "wrapped key %zu lost its value", index);
+    }
+
+    // Removing the key in the last slot shifts the wrapped keys back over the end.
+    INSK_TEST_ASSERT(INSKTouchSlotTableRemove(&table, keys[0]) == INSKTestValue(keys[0]), "remove of the first key failed");
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keys[1]) == (long)lastSlot, "second key hasn't been shifted back to the last slot");
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keys[2]) == 0, "third key hasn't been shifted back to slot 0");
+    INSK_TEST_ASSERT(table.slots[1].key == 0, "slot 1 hasn't been freed");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keys[2]) == INSKTestValue(keys[2]), "third key lost its value after the shift");
+}
+
+
+// remove
+
+static void test_remove_insideClusterShiftsFollowingKeysBack(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    // A cluster of slots 10 to 14: three keys preferring 10, one preferring 12 pushed to 13 and one preferring 14.
+    uintptr_t keysFor10[3], keysFor12[2], keysFor14[1];
+    INSKTestKeysForSlot(10, keysFor10, 3);
+    INSKTestKeysForSlot(12, keysFor12, 2);
+    INSKTestKeysForSlot(14, keysFor14, 1);
+    INSKTouchSlotTableSet(&table, keysFor10[0], INSKTestValue(keysFor10[0]), NULL);
+    INSKTouchSlotTableSet(&table, keysFor10[1], INSKTestValue(keysFor10[1]), NULL);
+    INSKTouchSlotTableSet(&table, keysFor10[2], INSKTestValue(keysFor10[2]), NULL);
+    INSKTouchSlotTableSet(&table, keysFor12[0], INSKTestValue(keysFor12[0]), NULL);
+    INSKTouchSlotTableSet(&table, keysFor14[0], INSKTestValue(keysFor14[0]), NULL);
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keysFor12[0]) == 13, "key preferring 12 is in slot %ld", INSKTestSlotOfKey(&table, keysFor12[0]));
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keysFor14[0]) == 14, "key preferring 14 is in slot %ld", INSKTestSlotOfKey(&table, keysFor14[0]));
+
+    // Removing the second key moves the third key to slot 11 and the key preferring 12 to slot 12, but the key in its preferred slot 14 stays.
+    INSK_TEST_ASSERT(INSKTouchSlotTableRemove(&table, keysFor10[1]) == INSKTestValue(keysFor10[1]), "remove inside of the cluster failed");
+    INSK_TEST_ASSERT(table.count == 4, "count is %zu after the remove", table.count);
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keysFor10[2]) == 11, "third key is in slot %ld instead of 11", INSKTestSlotOfKey(&table, keysFor10[2]));
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keysFor12[0]) == 12, "key preferring 12 is in slot %ld instead of 12", INSKTestSlotOfKey(&table, keysFor12[0]));
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keysFor14[0]) == 14, "key in its preferred slot has been moved to %ld", INSKTestSlotOfKey(&table, keysFor14[0]));
+    INSK_TEST_ASSERT(table.slots[13].key == 0, "slot 13 hasn't been freed");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keysFor10[1]) == NULL, "removed key is still found");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keysFor10[2]) == INSKTestValue(keysFor10[2]), "third key lost its value");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keysFor12[0]) == INSKTestValue(keysFor12[0]), "key preferring 12 lost its value");
+
+    // A new key preferring 12 gets the freed slot 13 again.
+    INSKTouchSlotTableSet(&table, keysFor12[1], INSKTestValue(keysFor12[1]), NULL);
+    INSK_TEST_ASSERT(INSKTestSlotOfKey(&table, keysFor12[1]) == 13, "new key preferring 12 is in slot %ld", INSKTestSlotOfKey(&table, keysFor12[1]));
+}
+
+static void test_remove_unknownKeyChangesNothing(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    uintptr_t keys[3];
+    INSKTestKeysForSlot(7, keys, 3);
+    INSKTouchSlotTableSet(&table, keys[0], INSKTestValue(keys[0]), NULL);
+    INSKTouchSlotTableSet(&table, keys[1], INSKTestValue(keys[1]), NULL);
+    INSKTouchSlotTable before = table;
+    INSK_TEST_ASSERT(INSKTouchSlotTableRemove(&table, keys[2]) == NULL, "remove of an unknown colliding key returned a value");
+    INSK_TEST_ASSERT(memcmp(&before, &table, sizeof(table)) == 0, "remove of an unknown key changed the table");
+}
+
+
+// full capacity
+
+static void test_full_rejectsNewKeysButKeepsOld(void) {
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    uintptr_t keys[INSKTouchSlotTableCapacity + 1];
+    for (size_t index = 0; index <= INSKTouchSlotTableCapacity; ++index) {
+        keys[index] = 0x20000 + index * 48;
+    }
+    for (size_t index = 0; index < INSKTouchSlotTableCapacity; ++index) {
+        INSK_TEST_ASSERT(INSKTouchSlotTableSet(&table, keys[index], INSKTestValue(keys[index]), NULL), "set %zu failed before the table is full", index);
+    }
+    INSK_TEST_ASSERT(table.count == INSKTouchSlotTableCapacity, "count is %zu for a full table", table.count);
+
+    void *previous = (void *)1;
+    INSK_TEST_ASSERT(!INSKTouchSlotTableSet(&table, keys[INSKTouchSlotTableCapacity], (void *)0xa, &previous), "a full table accepted a new key");
+    INSK_TEST_ASSERT(previous == NULL, "previous value of a rejected key is %p", previous);
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keys[INSKTouchSlotTableCapacity]) == NULL, "get of an unknown key in a full table found a value");
+    INSK_TEST_ASSERT(INSKTouchSlotTableRemove(&table, keys[INSKTouchSlotTableCapacity]) == NULL, "remove of an unknown key in a full table found a value");
+    INSK_TEST_ASSERT(table.count == INSKTouchSlotTableCapacity, "count changed by a rejected key");
+
+    // Known keys can still be updated.
+    INSK_TEST_ASSERT(INSKTouchSlotTableSet(&table, keys[3], (void *)0xb, &previous), "a full table rejected an update");
+    INSK_TEST_ASSERT(previous == INSKTestValue(keys[3]), "previous value of an update in a full table is %p", previous);
+    for (size_t index = 0; index < INSKTouchSlotTableCapacity; ++index) {
+        void *expected = (index == 3) ? (void *)0xb : INSKTestValue(keys[index]);
+        INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keys[index]) == expected, "key %zu lost its value in a full table", index);
+    }
+
+    // After a removal there is room again.
+    INSKTouchSlotTableRemove(&table, keys[10]);
+    INSK_TEST_ASSERT(INSKTouchSlotTableSet(&table, keys[INSKTouchSlotTableCapacity], (void *)0xa, NULL), "set after a removal from a full table failed");
+    INSK_TEST_ASSERT(INSKTouchSlotTableGet(&table, keys[INSKTouchSlotTableCapacity]) == (void *)0xa, "new key lost its value");
+
+    // Empty the table completely.
+    for (size_t index = 0; index <= INSKTouchSlotTableCapacity; ++index) {
+        INSKTouchSlotTableRemove(&table, keys[index]);
+    }
+    INSK_TEST_ASSERT(table.count == 0, "count is %zu after removing everything", table.count);
+    for (size_t slot = 0; slot < INSKTouchSlotTableCapacity; ++slot) {
+        INSK_TEST_ASSERT(table.slots[slot].key == 0, "slot %zu still used after removing everything", slot);
+    }
+}
+
+
+// random operations
+
+static void test_random_matchesReference(void) {
+    // Few different keys with only a few preferred slots, so there are many collisions and clusters wrapping around the end.
+    enum { keyCount = 50, slotCount = 5 };
+    uintptr_t keys[keyCount];
+    for (size_t slotIndex = 0; slotIndex < slotCount; ++slotIndex) {
+        INSKTestKeysForSlot((INSKTouchSlotTableCapacity - 2 + slotIndex) % INSKTouchSlotTableCapacity, &keys[slotIndex * (keyCount / slotCount)], keyCount / slotCount);
+    }
+    void *reference[keyCount];
+    memset(reference, 0, sizeof(reference));
+    size_t referenceCount = 0;
+
+    INSKTouchSlotTable table;
+    INSKTouchSlotTableInit(&table);
+    int mismatches = 0;
+    for (unsigned int operation = 0; operation < INSKTestOperationCount; ++operation) {
+        size_t keyIndex = INSKTestRandom() % keyCount;
+        uintptr_t key = keys[keyIndex];
+        uint32_t kind = INSKTestRandom() % 3;
+        if (kind == 0) {
+            void *value = (void *)(uintptr_t)(operation * 2 + 1);
+            bool stored = INSKTouchSlotTableSet(&table, key, value, NULL);
+            bool expected = reference[keyIndex] != NULL || referenceCount < INSKTouchSlotTableCapacity;
+            mismatches += (stored != expected);
+            if (expected) {
+                referenceCount += (reference[keyIndex] == NULL);
+                reference[keyIndex] = value;
+            }
+        } else if (kind == 1) {
+            mismatches += (INSKTouchSlotTableGet(&table, key) != reference[keyIndex]);
+        } else {
+            mismatches += (INSKTouchSlotTableRemove(&table, key) != reference[keyIndex]);
+            referenceCount -= (reference[keyIndex] != NULL);
+            reference[keyIndex] = NULL;
+        }
+        mismatches += (table.count != referenceCount);
+    }
+    for (size_t index = 0; index < keyCount; ++index) {
+        mismatches += (INSKTouchSlotTableGet(&table, keys[index]) != reference[index]);
+    }
+    INSK_TEST_ASSERT(mismatches == 0, "%d mismatches with the reference in %d random operations", mismatches, INSKTestOperationCount);
+}
+
+
+int main(void) {
+    test_init_isEmpty();
+    test_set_replacesValueOfSameKey();
+    test_set_rejectsKeyZero();
+    test_set_touchesAtSameLocationStaySeparate();
+    test_collisions_probeToFollowingSlots();
+    test_collisions_wrapAroundTheEnd();
+    test_remove_insideClusterShiftsFollowingKeysBack();
+    test_remove_unknownKeyChangesNothing();
+    test_full_rejectsNewKeysButKeepsOld();
+    test_random_matchesReference();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,317 @@
+// A command line tool which measures how the cost of resolving the top node of a touch scales with deep and wide trees.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKTreeOrderBenchmark.c INSpriteKit/INSKInstrumentation.c -lm -o insk-tree-order-benchmark
+//
+// Usage:
+//   insk-tree-order-benchmark [-candidates count] [-nodes count]
+//
+// The tree order of SKNode+INExtension can't run without Sprite Kit, so this tool implements both ways on plain C trees the same way:
+// the string tags INSKView used before, which walk up to the root, search each node in its parent's children and prepend its index
+// as 4 hex digits, and the integer indexes of compareTreeOrder:, which are cached per node and only calculated again for all siblings
+// at once after the children of their parent have changed.
+// The trees have 100 to 100'000 nodes, but not more than the given number of nodes.
+// For each tree the given number of random nodes is resolved to the last rendered one like for a touch hitting overlapping nodes.
+// Prints the nanoseconds per resolution with tags, with warm cached indexes and with cached indexes which have been invalidated before
+// each resolution by a change of the candidates' parents, and the number of resolutions where the tags found another node,
+// which happens for more than 65'536 children.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKInstrumentation.h"
+
+
+// The measured tree sizes.
+static const size_t INSKBenchmarkNodeCounts[] = {100, 1000, 10000, 100000};
+#define INSKBenchmarkNodeCountCount (sizeof(INSKBenchmarkNodeCounts) / sizeof(INSKBenchmarkNodeCounts[0]))
+
+// The tree shapes.
+typedef enum {
+    // All nodes are children of the root.
+    INSKBenchmarkShapeWide = 0,
+    // Each node has eight children.
+    INSKBenchmarkShapeBalanced,
+    // A chain where each node has a leaf and the next node of the chain as children.
+    INSKBenchmarkShapeDeep,
+    INSKBenchmarkShapeCount
+} INSKBenchmarkShape;
+
+static const char *const INSKBenchmarkShapeNames[] = {"wide", "balanced", "deep"};
+
+// The tags take quadratic time with the depth, so they are skipped for deeper trees.
+#define INSKBenchmarkMaxTagDepth 5000
+// Each measurement runs at least this many nanoseconds.
+#define INSKBenchmarkMinimumTime 100000000ull
+
+// Used to keep the compiler from removing the loops.
+static volatile size_t INSKBenchmarkSink;
+
+
+typedef struct INSKBenchmarkNode {
+    struct INSKBenchmarkNode *parent;
+    struct INSKBenchmarkNode **children;
+    size_t childCount;
+    // The cached tree order like SKNodeINExtensionTreeOrder.
+    size_t childrenGeneration;
+    size_t index;
+    struct INSKBenchmarkNode *indexParent;
+    size_t parentChildrenGeneration;
+} INSKBenchmarkNode;
+
+static size_t INSKBenchmarkChildrenGeneration = 0;
+
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKBenchmarkRandomState = 1;
+
+static size_t INSKBenchmarkRandomIndex(size_t count) {
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState << 13;
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState >> 17;
+    INSKBenchmarkRandomState ^= INSKBenchmarkRandomState << 5;
+    return (size_t)(count * (INSKBenchmarkRandomState / 4294967296.0));
+}
+
+// Creates the nodes of a tree, the first node is the root. Returns the depth of the tree.
+static size_t INSKBenchmarkTreeCreate(INSKBenchmarkNode *nodes, size_t count, INSKBenchmarkShape shape) {
+    memset(nodes, 0, count * sizeof(INSKBenchmarkNode));
+    size_t depth = 0;
+    for (size_t index = 1; index < count; ++index) {
+        size_t parentIndex = 0;
+        if (shape == INSKBenchmarkShapeBalanced) {
+            parentIndex = (index - 1) / 8;
+        } else if (shape == INSKBenchmarkShapeDeep) {
+            // Odd nodes continue the chain, even nodes are leaves.
+            parentIndex = (index == 1) ? 0 : ((index - 2) & ~(size_t)1) + 1;
+        }
+        INSKBenchmarkNode *parent = &nodes[parentIndex];
+        // The children arrays are allocated for the maximum number of children of the shape.
+        if (parent->children == NULL) {
+            size_t capacity = (shape == INSKBenchmarkShapeWide) ? count : 8;
+            parent->children = (INSKBenchmarkNode **)malloc(capacity * sizeof(INSKBenchmarkNode *));
+            parent->childrenGeneration = ++INSKBenchmarkChildrenGeneration;
+        }
+        parent->children[parent->childCount++] = &nodes[index];
+        nodes[index].parent = parent;
+        nodes[index].childrenGeneration = ++INSKBenchmarkChildrenGeneration;
+    }
+    for (size_t index = 0; index < count; ++index) {
+        size_t nodeDepth = 0;
+        for (INSKBenchmarkNode *ancestor = nodes[index].parent; ancestor != NULL; ancestor = ancestor->parent) {
+            nodeDepth++;
+        }
+        depth = (nodeDepth > depth) ? nodeDepth : depth;
+    }
+    return depth;
+}
+
+static void INSKBenchmarkTreeDestroy(INSKBenchmarkNode *nodes, size_t count) {
+    for (size_t index = 0; index < count; ++index) {
+        free(nodes[index].children);
+    }
+}
+
+
+#pragma mark - string tags
+
+// Returns the tag of a node like treeOrderTagForNode: did, the string has to be freed.
+static char *INSKBenchmarkTag(const INSKBenchmarkNode *node) {
+    char *tag = (char *)calloc(1, 1);
+    size_t length = 0;
+    for (const INSKBenchmarkNode *current = node; current->parent != NULL; current = current->parent) {
+        // Search the node in its parent's children like indexOfObject:.
+        size_t index = 0;
+        while (current->parent->children[index] != current) {
+            index++;
+        }
+        char digits[32];
+        int digitCount = snprintf(digits, sizeof(digits), "%04lx", (unsigned long)index);
+        // Each level creates a new string like stringWithFormat: does.
+        char *newTag = (char *)malloc(length + digitCount + 1);
+        memcpy(newTag, digits, digitCount);
+        memcpy(newTag + digitCount, tag, length + 1);
+        free(tag);
+        tag = newTag;
+        length += digitCount;
+    }
+    return tag;
+}
+
+// Returns the last rendered candidate by comparing the tags.
+static const INSKBenchmarkNode *INSKBenchmarkResolveWithTags(INSKBenchmarkNode *const *candidates, size_t count) {
+    const INSKBenchmarkNode *top = NULL;
+    char *topTag = NULL;
+    for (size_t i = 0; i < count; ++i) {
+        char *tag = INSKBenchmarkTag(candidates[i]);
+        if (top == NULL || strcmp(topTag, tag) < 0) {
+            free(topTag);
+            top = candidates[i];
+            topTag = tag;
+        } else {
+            free(tag);
+        }
+    }
+    free(topTag);
+    return top;
+}
+
+
+#pragma mark - cached indexes
+
+// Returns the cached index of the node in its parent's children array like insk_indexInParent.
+static size_t INSKBenchmarkIndexInParent(INSKBenchmarkNode *node) {
+    INSKBenchmarkNode *parent = node->parent;
+    if (node->indexParent != parent || node->parentChildrenGeneration != parent->childrenGeneration
+        || node->index >= parent->childCount || parent->children[node->index] != node) {
+        // The children have changed, so update the indexes of all siblings at once.
+        for (size_t index = 0; index < parent->childCount; ++index) {
+            INSKBenchmarkNode *child = parent->children[index];
+            child->index = index;
+            child->indexParent = parent;
+            child->parentChildrenGeneration = parent->childrenGeneration;
+        }
+    }
+    return node->index;
+}
+
+// Returns -1 if the node is rendered before the other node, 1 if after it and 0 if both are the same like compareTreeOrder:.
+static int INSKBenchmarkCompareTreeOrder(INSKBenchmarkNode *node, INSKBenchmarkNode *other) {
+    if (node == other || other == NULL) {
+        return 0;
+    }
+    size_t depth = 0;
+    for (INSKBenchmarkNode *ancestor = node->parent; ancestor != NULL; ancestor = ancestor->parent) {
+        depth++;
+    }
+    size_t otherDepth = 0;
+    for (INSKBenchmarkNode *ancestor = other->parent; ancestor != NULL; ancestor = ancestor->parent) {
+        otherDepth++;
+    }
+    INSKBenchmarkNode *ancestor = node;
+    INSKBenchmarkNode *otherAncestor = other;
+    for (; depth > otherDepth; --depth) {
+        ancestor = ancestor->parent;
+    }
+    for (; otherDepth > depth; --otherDepth) {
+        otherAncestor = otherAncestor->parent;
+    }
+    if (ancestor == otherAncestor) {
+        return (node == ancestor) ? -1 : 1;
+    }
+    while (ancestor->parent != otherAncestor->parent) {
+        ancestor = ancestor->parent;
+        otherAncestor = otherAncestor->parent;
+    }
+    if (ancestor->parent == NULL) {
+        return 0;
+    }
+    return (INSKBenchmarkIndexInParent(ancestor) < INSKBenchmarkIndexInParent(otherAncestor)) ? -1 : 1;
+}
+
+// Returns the last rendered candidate by comparing the cached indexes.
+static INSKBenchmarkNode *INSKBenchmarkResolveWithIndexes(INSKBenchmarkNode *const *candidates, size_t count) {
+    INSKBenchmarkNode *top = NULL;
+    for (size_t i = 0; i < count; ++i) {
+        if (top == NULL || INSKBenchmarkCompareTreeOrder(top, candidates[i]) < 0) {
+            top = candidates[i];
+        }
+    }
+    return top;
+}
+
+
+#pragma mark - measurement
+
+typedef enum {
+    INSKBenchmarkMethodTags = 0,
+    INSKBenchmarkMethodWarmIndexes,
+    INSKBenchmarkMethodColdIndexes
+} INSKBenchmarkMethod;
+
+// Resolves random candidates again and again and returns the nanoseconds per resolution.
+static double INSKBenchmarkMeasure(INSKBenchmarkNode *nodes, size_t count, INSKBenchmarkNode **candidates, size_t candidateCount, INSKBenchmarkMethod method) {
+    size_t resolutions = 0;
+    uint64_t time = 0;
+    while (time < INSKBenchmarkMinimumTime) {
+        for (size_t i = 0; i < candidateCount; ++i) {
+            candidates[i] = &nodes[1 + INSKBenchmarkRandomIndex(count - 1)];
+            if (method == INSKBenchmarkMethodColdIndexes) {
+                // Like a child added to or removed from the candidate's parent.
+                candidates[i]->parent->childrenGeneration = ++INSKBenchmarkChildrenGeneration;
+            }
+        }
+        uint64_t start = INSKInstrumentationNow();
+        const INSKBenchmarkNode *top = (method == INSKBenchmarkMethodTags) ? INSKBenchmarkResolveWithTags(candidates, candidateCount) : INSKBenchmarkResolveWithIndexes(candidates, candidateCount);
+        time += INSKInstrumentationNow() - start;
+        INSKBenchmarkSink = (size_t)(uintptr_t)top;
+        resolutions++;
+    }
+    return (double)time / (double)resolutions;
+}
+
+// Returns the number of random resolutions out of 1000 for which the tags find another node than the indexes.
+static size_t INSKBenchmarkTagErrors(INSKBenchmarkNode *nodes, size_t count, INSKBenchmarkNode **candidates, size_t candidateCount) {
+    size_t errors = 0;
+    for (unsigned int resolution = 0; resolution < 1000; ++resolution) {
+        for (size_t i = 0; i < candidateCount; ++i) {
+            candidates[i] = &nodes[1 + INSKBenchmarkRandomIndex(count - 1)];
+        }
+        if (INSKBenchmarkResolveWithTags(candidates, candidateCount) != INSKBenchmarkResolveWithIndexes(candidates, candidateCount)) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t candidateCount = 8;
+    size_t maxNodeCount = INSKBenchmarkNodeCounts[INSKBenchmarkNodeCountCount - 1];
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-candidates") == 0 && argument + 1 < argc) {
+            candidateCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-nodes") == 0 && argument + 1 < argc) {
+            maxNodeCount = strtoul(argv[++argument], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-candidates count] [-nodes count]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (candidateCount == 0) {
+        candidateCount = 1;
+    }
+
+    INSKBenchmarkNode **candidates = (INSKBenchmarkNode **)malloc(candidateCount * sizeof(INSKBenchmarkNode *));
+    INSKBenchmarkNode *nodes = (INSKBenchmarkNode *)malloc(INSKBenchmarkNodeCounts[INSKBenchmarkNodeCountCount - 1] * sizeof(INSKBenchmarkNode));
+    if (candidates == NULL || nodes == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("candidates %zu\n", candidateCount);
+    printf("%-9s %8s %8s %14s %14s %14s %11s\n", "shape", "nodes", "depth", "tags ns/hit", "warm ns/hit", "cold ns/hit", "tag errors");
+    for (int shape = 0; shape < INSKBenchmarkShapeCount; ++shape) {
+        for (size_t sizeIndex = 0; sizeIndex < INSKBenchmarkNodeCountCount; ++sizeIndex) {
+            size_t count = INSKBenchmarkNodeCounts[sizeIndex];
+            if (count > maxNodeCount) {
+                break;
+            }
+            size_t depth = INSKBenchmarkTreeCreate(nodes, count, (INSKBenchmarkShape)shape);
+            double warmTime = INSKBenchmarkMeasure(nodes, count, candidates, candidateCount, INSKBenchmarkMethodWarmIndexes);
+            double coldTime = INSKBenchmarkMeasure(nodes, count, candidates, candidateCount, INSKBenchmarkMethodColdIndexes);
+            if (depth <= INSKBenchmarkMaxTagDepth) {
+                double tagTime = INSKBenchmarkMeasure(nodes, count, candidates, candidateCount, INSKBenchmarkMethodTags);
+                size_t errors = INSKBenchmarkTagErrors(nodes, count, candidates, candidateCount);
+                printf("%-9s %8zu %8zu %14.1f %14.1f %14.1f %11zu\n", INSKBenchmarkShapeNames[shape], count, depth, tagTime, warmTime, coldTime, errors);
+            } else {
+                printf("%-9s %8zu %8zu %14s %14.1f %14.1f %11s\n", INSKBenchmarkShapeNames[shape], count, depth, "skipped", warmTime, coldTime, "-");
+            }
+            INSKBenchmarkTreeDestroy(nodes, count);
+        }
+    }
+
+    free(nodes);
+    free(candidates);
+    return 0;
+}
@@ -0,0 +1,297 @@
+// A command line tool which replays drags against the methods of INSKVelocityEstimator.h and measures their accuracy and cost.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKVelocityEstimatorBenchmark.c INSpriteKit/INSKVelocityEstimator.c INSpriteKit/INSKInputRecording.c INSpriteKit/INSKInstrumentation.c -lm -o insk-velocity-estimator-benchmark
+//
+// Usage:
+//   insk-velocity-estimator-benchmark [-gestures count] [-iterations count] [-seed value] [recording file]
+//
+// Without a recording file random drags with a known velocity are recorded and replayed: flicks speeding up until the release,
+// drags slowing down until the release and drags which rest before the release. The events have a jittered rate of 60 or 120 Hz,
+// duplicated timestamps and locations rounded to half points like on a retina screen.
+// Prints for each method the nanoseconds per event, which adds a movement and estimates the velocity like INSKScrollNode does,
+// the root mean square and mean relative error of the release velocity of the moving drags and the mean release speed
+// of the resting drags, which should be 0. Recordings made with [INSKView inputRecording] only show the cost and the mean release speed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "INSKVelocityEstimator.h"
+#include "INSKInputRecording.h"
+#include "INSKInstrumentation.h"
+
+
+// The kinds of drags.
+typedef enum {
+    INSKBenchmarkDragFlick = 0,
+    INSKBenchmarkDragSlowing,
+    INSKBenchmarkDragResting,
+    INSKBenchmarkDragCount
+} INSKBenchmarkDrag;
+
+// A configuration of the estimator to measure.
+typedef struct {
+    const char *name;
+    INSKVelocityEstimatorMethod method;
+    double window;
+    size_t maxSamples;
+} INSKBenchmarkConfiguration;
+
+// The mean of the last five velocities over all times was the estimation of INSKScrollNode before INSKVelocityEstimator.
+static const INSKBenchmarkConfiguration INSKBenchmarkConfigurations[] = {
+    {"last 5 average", INSKVelocityEstimatorMethodAverage, 0, 6},
+    {"average", INSKVelocityEstimatorMethodAverage, 0.1, INSKVelocityEstimatorCapacity},
+    {"least squares", INSKVelocityEstimatorMethodLeastSquares, 0.1, INSKVelocityEstimatorCapacity},
+    {"exponential", INSKVelocityEstimatorMethodExponential, 0.1, INSKVelocityEstimatorCapacity},
+};
+#define INSKBenchmarkConfigurationCount (sizeof(INSKBenchmarkConfigurations) / sizeof(INSKBenchmarkConfigurations[0]))
+
+// The result of replaying all drags with a configuration.
+typedef struct {
+    double squaredErrorSum;
+    double relativeErrorSum;
+    size_t movingCount;
+    double restingSpeedSum;
+    size_t restingCount;
+    double speedSum;
+    size_t releaseCount;
+} INSKBenchmarkAccuracy;
+
+// Used to keep the compiler from removing the loops.
+static volatile CGFloat INSKBenchmarkSink;
+
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKBenchmarkRandom(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static double INSKBenchmarkRandomInRange(uint32_t *state, double min, double max) {
+    return min + (max - min) * (INSKBenchmarkRandom(state) / 4294967295.0);
+}
+
+// Returns the distance and sets the speed of a drag at a time since its start.
+static double INSKBenchmarkDragDistance(INSKBenchmarkDrag drag, double speed, double time, double moveDuration, double *currentSpeed) {
+    switch (drag) {
+        case INSKBenchmarkDragFlick: {
+            // Speeds up to the full speed with a time constant of 50 ms.
+            double rise = exp(-time / 0.05);
+            *currentSpeed = speed * (1 - rise);
+            return speed * (time - 0.05 * (1 - rise));
+        }
+        case INSKBenchmarkDragSlowing: {
+            // Slows down with a time constant of 150 ms.
+            double fall = exp(-time / 0.15);
+            *currentSpeed = speed * fall;
+            return speed * 0.15 * (1 - fall);
+        }
+        case INSKBenchmarkDragResting:
+        default: {
+            // Moves with full speed and stops at once after the move duration.
+            double movingTime = (time < moveDuration) ? time : moveDuration;
+            *currentSpeed = (time < moveDuration) ? speed : 0;
+            return speed * movingTime;
+        }
+    }
+}
+
+static bool INSKBenchmarkAppend(INSKInputRecording *recording, double timestamp, double x, double y, uint32_t touchId, INSKInputPhase phase) {
+    INSKInputEvent event;
+    // Retina screens report locations in half points.
+    event.timestamp = timestamp;
+    event.x = (float)(round(x * 2) / 2);
+    event.y = (float)(round(y * 2) / 2);
+    event.touchId = touchId;
+    event.phase = (uint8_t)phase;
+    event.buttons = 0;
+    return INSKInputRecordingAppend(recording, &event);
+}
+
+// Records random drags and stores the release velocity of each, NAN for the unknown velocities of resting drags.
+static bool INSKBenchmarkRecordDrags(INSKInputRecording *recording, CGPoint *releaseVelocities, size_t count, uint32_t seed) {
+    uint32_t state = (seed != 0) ? seed : 1;
+    double timestamp = 0;
+    for (size_t gesture = 0; gesture < count; ++gesture) {
+        INSKBenchmarkDrag drag = (INSKBenchmarkDrag)(INSKBenchmarkRandom(&state) % INSKBenchmarkDragCount);
+        double speed = INSKBenchmarkRandomInRange(&state, 200, 6000);
+        double angle = INSKBenchmarkRandomInRange(&state, 0, 2 * M_PI);
+        double interval = (INSKBenchmarkRandom(&state) % 2 == 0) ? 1.0 / 60.0 : 1.0 / 120.0;
+        double moveDuration = INSKBenchmarkRandomInRange(&state, 0.08, 0.3);
+        double duration = (drag == INSKBenchmarkDragResting) ? moveDuration + INSKBenchmarkRandomInRange(&state, 0.12, 0.4) : moveDuration;
+        double startX = INSKBenchmarkRandomInRange(&state, 0, 1024);
+        double startY = INSKBenchmarkRandomInRange(&state, 0, 768);
+        uint32_t touchId = (uint32_t)gesture + 1;
+        if (!INSKBenchmarkAppend(recording, timestamp, startX, startY, touchId, INSKInputPhaseBegan)) {
+            return false;
+        }
+
+        double time = 0;
+        double currentSpeed = 0;
+        while (time < duration) {
+            double eventTime = time + interval + INSKBenchmarkRandomInRange(&state, -0.002, 0.002);
+            // Some events are delivered with the timestamp of the previous one.
+            if (INSKBenchmarkRandom(&state) % 20 == 0) {
+                eventTime = time;
+            }
+            if (eventTime > duration) {
+                eventTime = duration;
+            }
+            bool last = (eventTime >= duration);
+            double distance = INSKBenchmarkDragDistance(drag, speed, eventTime, moveDuration, &currentSpeed);
+            // No events are delivered while the finger rests.
+            if (last || drag != INSKBenchmarkDragResting || eventTime <= moveDuration + interval) {
+                INSKInputPhase phase = last ? INSKInputPhaseEnded : INSKInputPhaseMoved;
+                if (!INSKBenchmarkAppend(recording, timestamp + eventTime, startX + distance * cos(angle), startY + distance * sin(angle), touchId, phase)) {
+                    return false;
+                }
+            }
+            time = eventTime;
+            if (last) {
+                break;
+            }
+        }
+        releaseVelocities[gesture] = CGPointMake((CGFloat)(currentSpeed * cos(angle)), (CGFloat)(currentSpeed * sin(angle)));
+        timestamp += duration + 1;
+    }
+    return true;
+}
+
+// Replays all drags of a recording, one touch at a time, and returns the nanoseconds per event.
+// Compares the release velocities with the known ones if given.
+static double INSKBenchmarkReplay(const INSKInputRecording *recording, const INSKBenchmarkConfiguration *configuration,
+                                  const CGPoint *releaseVelocities, size_t releaseVelocityCount, INSKBenchmarkAccuracy *accuracy) {
+    INSKVelocityEstimator estimator;
+    INSKVelocityEstimatorInit(&estimator);
+    estimator.method = configuration->method;
+    estimator.window = configuration->window;
+    estimator.maxSamples = configuration->maxSamples;
+    memset(accuracy, 0, sizeof(INSKBenchmarkAccuracy));
+
+    const INSKInputEvent *events = INSKInputRecordingEvents(recording);
+    size_t count = INSKInputRecordingCount(recording);
+    uint32_t touchId = 0;
+    float lastX = 0, lastY = 0;
+    size_t gesture = 0;
+    size_t eventCount = 0;
+    uint64_t start = INSKInstrumentationNow();
+    for (size_t index = 0; index < count; ++index) {
+        const INSKInputEvent *event = &events[index];
+        if (event->phase == INSKInputPhaseBegan) {
+            if (touchId == 0) {
+                touchId = event->touchId;
+                lastX = event->x;
+                lastY = event->y;
+                INSKVelocityEstimatorReset(&estimator, event->timestamp);
+            }
+            continue;
+        }
+        if (event->touchId != touchId || touchId == 0) {
+            continue;
+        }
+        CGPoint translation = CGPointMake(event->x - lastX, event->y - lastY);
+        lastX = event->x;
+        lastY = event->y;
+        INSKVelocityEstimatorAddMovement(&estimator, translation, event->timestamp);
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, event->timestamp);
+        INSKBenchmarkSink = velocity.x;
+        eventCount++;
+        if (event->phase == INSKInputPhaseMoved) {
+            continue;
+        }
+
+        touchId = 0;
+        double speed = sqrt((double)velocity.x * velocity.x + (double)velocity.y * velocity.y);
+        accuracy->speedSum += speed;
+        accuracy->releaseCount++;
+        if (gesture < releaseVelocityCount) {
+            CGPoint expected = releaseVelocities[gesture];
+            double expectedSpeed = sqrt((double)expected.x * expected.x + (double)expected.y * expected.y);
+            if (expectedSpeed > 0) {
+                double errorX = velocity.x - expected.x;
+                double errorY = velocity.y - expected.y;
+                double squaredError = errorX * errorX + errorY * errorY;
+                accuracy->squaredErrorSum += squaredError;
+                accuracy->relativeErrorSum += sqrt(squaredError) / expectedSpeed;
+                accuracy->movingCount++;
+            } else {
+                accuracy->restingSpeedSum += speed;
+                accuracy->restingCount++;
+            }
+        }
+        gesture++;
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    return (eventCount > 0) ? (double)nanoseconds / (double)eventCount : 0;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t gestureCount = 3000;
+    unsigned int iterations = 20;
+    unsigned int seed = 1;
+    const char *path = NULL;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-gestures") == 0 && argument + 1 < argc) {
+            gestureCount = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-iterations") == 0 && argument + 1 < argc) {
+            iterations = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-seed") == 0 && argument + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++argument], NULL, 10);
+        } else if (argv[argument][0] != '-' && path == NULL) {
+            path = argv[argument];
+        } else {
+            fprintf(stderr, "usage: %s [-gestures count] [-iterations count] [-seed value] [recording file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    INSKInputRecording *recording = NULL;
+    CGPoint *releaseVelocities = NULL;
+    size_t releaseVelocityCount = 0;
+    if (path != NULL) {
+        recording = INSKInputRecordingReadFile(path);
+        if (recording == NULL) {
+            fprintf(stderr, "couldn't read recording %s\n", path);
+            return 1;
+        }
+    } else {
+        recording = INSKInputRecordingCreate();
+        releaseVelocities = (CGPoint *)malloc((gestureCount > 0 ? gestureCount : 1) * sizeof(CGPoint));
+        if (recording == NULL || releaseVelocities == NULL || !INSKBenchmarkRecordDrags(recording, releaseVelocities, gestureCount, seed)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        releaseVelocityCount = gestureCount;
+    }
+
+    printf("events %zu iterations %u\n", INSKInputRecordingCount(recording), iterations);
+    printf("%-16s %10s %14s %12s %14s %14s\n", "method", "ns/event", "rms error", "rel error", "resting speed", "mean speed");
+    for (size_t index = 0; index < INSKBenchmarkConfigurationCount; ++index) {
+        const INSKBenchmarkConfiguration *configuration = &INSKBenchmarkConfigurations[index];
+        INSKBenchmarkAccuracy accuracy;
+        double best = 0;
+        for (unsigned int iteration = 0; iteration < iterations; ++iteration) {
+            double nanoseconds = INSKBenchmarkReplay(recording, configuration, releaseVelocities, releaseVelocityCount, &accuracy);
+            best = (iteration == 0 || nanoseconds < best) ? nanoseconds : best;
+        }
+        double meanSpeed = (accuracy.releaseCount > 0) ? accuracy.speedSum / accuracy.releaseCount : 0;
+        if (accuracy.movingCount > 0) {
+            printf("%-16s %10.2f %14.1f %11.1f%% %14.1f %14.1f\n", configuration->name, best,
+                   sqrt(accuracy.squaredErrorSum / accuracy.movingCount), 100 * accuracy.relativeErrorSum / accuracy.movingCount,
+                   (accuracy.restingCount > 0) ? accuracy.restingSpeedSum / accuracy.restingCount : 0, meanSpeed);
+        } else {
+            printf("%-16s %10.2f %14s %12s %14s %14.1f\n", configuration->name, best, "-", "-", "-", meanSpeed);
+        }
+    }
+
+    free(releaseVelocities);
+    INSKInputRecordingDestroy(recording);
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Tests the methods, the ring buffer and the time handling of INSKVelocityEstimator.h.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKVelocityEstimatorTests.c INSpriteKit/INSKVelocityEstimator.c -lm -o insk-velocity-estimator-tests && ./insk-velocity-estimator-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <math.h>
+#include "INSKVelocityEstimator.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The allowed difference of velocities, big enough for a float CGFloat.
+#define INSKTestPrecision 0.5
+
+static bool INSKTestNear(CGPoint value, CGFloat expectedX, CGFloat expectedY) {
+    return fabs((double)value.x - (double)expectedX) <= INSKTestPrecision && fabs((double)value.y - (double)expectedY) <= INSKTestPrecision;
+}
+
+static const INSKVelocityEstimatorMethod INSKTestMethods[] = {
+    INSKVelocityEstimatorMethodAverage,
+    INSKVelocityEstimatorMethodLeastSquares,
+    INSKVelocityEstimatorMethodExponential
+};
+#define INSKTestMethodCount (sizeof(INSKTestMethods) / sizeof(INSKTestMethods[0]))
+
+static INSKVelocityEstimator INSKTestEstimator(INSKVelocityEstimatorMethod method) {
+    INSKVelocityEstimator estimator;
+    INSKVelocityEstimatorInit(&estimator);
+    estimator.method = method;
+    INSKVelocityEstimatorReset(&estimator, 1.0);
+    return estimator;
+}
+
+
+int main(void) {
+    // a constant velocity with irregular intervals is exact for all methods
+    for (size_t index = 0; index < INSKTestMethodCount; ++index) {
+        INSKVelocityEstimator estimator = INSKTestEstimator(INSKTestMethods[index]);
+        static const double intervals[] = {0.008, 0.017, 0.004, 0.011, 0.016, 0.009};
+        double time = 1.0;
+        for (size_t sample = 0; sample < sizeof(intervals) / sizeof(intervals[0]); ++sample) {
+            time += intervals[sample];
+            INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(300 * intervals[sample], -1200 * intervals[sample]), time);
+        }
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, time);
+        INSK_TEST_ASSERT(INSKTestNear(velocity, 300, -1200), "method %d: constant velocity is %f, %f", (int)INSKTestMethods[index], (double)velocity.x, (double)velocity.y);
+    }
+
+    // least squares follows a drag speeding up
+    {
+        INSKVelocityEstimator estimator = INSKTestEstimator(INSKVelocityEstimatorMethodLeastSquares);
+        double lastPosition = 0;
+        for (int sample = 1; sample <= 10; ++sample) {
+            double time = sample / 120.0;
+            double position = 20000 * time * time;
+            INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(0, (CGFloat)(position - lastPosition)), 1.0 + time);
+            lastPosition = position;
+        }
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, 1.0 + 10 / 120.0);
+        INSK_TEST_ASSERT(fabs((double)velocity.y - 40000 * 10 / 120.0) < 5, "accelerating drag has %f", (double)velocity.y);
+    }
+
+    // movements without time passing are merged instead of dividing by zero
+    for (size_t index = 0; index < INSKTestMethodCount; ++index) {
+        INSKVelocityEstimator estimator = INSKTestEstimator(INSKTestMethods[index]);
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(5, 0), 1.0);
+        INSK_TEST_ASSERT(estimator.count == 1, "method %d: movement at the start time added a sample", (int)INSKTestMethods[index]);
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, 1.0);
+        INSK_TEST_ASSERT(velocity.x == 0 && velocity.y == 0, "method %d: single sample has a velocity", (int)INSKTestMethods[index]);
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(10, 0), 1.01);
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(10, 0), 1.01);
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(10, 0), 1.005);
+        velocity = INSKVelocityEstimatorVelocity(&estimator, 1.01);
+        INSK_TEST_ASSERT(estimator.count == 2, "method %d: %zu samples instead of 2", (int)INSKTestMethods[index], estimator.count);
+        INSK_TEST_ASSERT(isfinite(velocity.x) && INSKTestNear(velocity, 3000, 0), "method %d: merged velocity is %f", (int)INSKTestMethods[index], (double)velocity.x);
+    }
+
+    // samples older than the window are ignored, so a rested drag has no velocity
+    for (size_t index = 0; index < INSKTestMethodCount; ++index) {
+        INSKVelocityEstimator estimator = INSKTestEstimator(INSKTestMethods[index]);
+        for (int sample = 1; sample <= 5; ++sample) {
+            INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(10, 10), 1.0 + sample / 60.0);
+        }
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, 1.0 + 5 / 60.0 + 0.2);
+        INSK_TEST_ASSERT(velocity.x == 0 && velocity.y == 0, "method %d: rested drag has a velocity", (int)INSKTestMethods[index]);
+        estimator.window = 0;
+        velocity = INSKVelocityEstimatorVelocity(&estimator, 1.0 + 5 / 60.0 + 0.2);
+        INSK_TEST_ASSERT(INSKTestNear(velocity, 600, 600), "method %d: unlimited window has %f", (int)INSKTestMethods[index], (double)velocity.x);
+    }
+
+    // the ring buffer keeps the newest samples
+    {
+        INSKVelocityEstimator estimator;
+        INSKVelocityEstimatorInit(&estimator);
+        estimator.method = INSKVelocityEstimatorMethodAverage;
+        estimator.window = 0;
+        for (int sample = 1; sample <= 3 * INSKVelocityEstimatorCapacity; ++sample) {
+            CGFloat distance = (sample > 2 * INSKVelocityEstimatorCapacity) ? 2 : 1;
+            INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(distance, 0), sample * 0.01);
+        }
+        INSK_TEST_ASSERT(estimator.count == INSKVelocityEstimatorCapacity, "%zu samples kept", estimator.count);
+        INSK_TEST_ASSERT(INSKVelocityEstimatorLastTimestamp(&estimator) == 3 * INSKVelocityEstimatorCapacity * 0.01, "wrong newest sample");
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, 1.0);
+        INSK_TEST_ASSERT(INSKTestNear(velocity, 200, 0), "old samples used, velocity is %f", (double)velocity.x);
+        estimator.maxSamples = 2;
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(5, 0), 3 * INSKVelocityEstimatorCapacity * 0.01 + 0.01);
+        velocity = INSKVelocityEstimatorVelocity(&estimator, 1.0);
+        INSK_TEST_ASSERT(INSKTestNear(velocity, 500, 0), "max samples ignored, velocity is %f", (double)velocity.x);
+    }
+
+    // the exponential weights prefer the newest movements
+    {
+        INSKVelocityEstimator estimator = INSKTestEstimator(INSKVelocityEstimatorMethodExponential);
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(0, 10), 1.04);
+        INSKVelocityEstimatorAddMovement(&estimator, CGPointMake(0, 40), 1.05);
+        CGPoint velocity = INSKVelocityEstimatorVelocity(&estimator, 1.05);
+        INSK_TEST_ASSERT(velocity.y > 1000 && velocity.y < 4000, "exponential velocity is %f", (double)velocity.y);
+    }
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,166 @@
+// A command line tool which measures the scroll throughput of a virtualized list with INSKVisibilityTracker.h against the number of items.
+//
+// Build it on any platform with a C99 compiler, i.e.:
+//   cc -O2 -std=c99 -D_POSIX_C_SOURCE=199309L -IINSpriteKit Tools/INSKVisibilityTrackerBenchmark.c INSpriteKit/INSKVisibilityTracker.c INSpriteKit/INSKSpatialIndex.c INSpriteKit/INSKInstrumentation.c -lm -o insk-visibility-tracker-benchmark
+//
+// Usage:
+//   insk-visibility-tracker-benchmark [-frames count] [-speed points]
+//
+// Scrolls a list of 44 point high rows in a 320 x 568 viewport with a margin of 64 points from the top to the bottom and back,
+// moving the given number of points per frame, for lists of 100 up to 1'000'000 rows.
+// Prints for each list the nanoseconds per frame of INSKVisibilityTrackerUpdate() including the recycling of the rows,
+// the nanoseconds per frame of testing all rows against the viewport, which is the least a non-virtualized list has to do,
+// and the average number of materialized rows, which is the number of nodes a virtualized scroll node keeps in memory.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKVisibilityTracker.h"
+#include "INSKInstrumentation.h"
+
+
+// The measured list sizes.
+static const size_t INSKBenchmarkItemCounts[] = {100, 1000, 10000, 100000, 1000000};
+#define INSKBenchmarkItemCountCount (sizeof(INSKBenchmarkItemCounts) / sizeof(INSKBenchmarkItemCounts[0]))
+
+// The layout of the list.
+#define INSKBenchmarkRowWidth 320.0
+#define INSKBenchmarkRowHeight 44.0
+#define INSKBenchmarkViewportHeight 568.0
+#define INSKBenchmarkMargin 64.0
+
+// Used to keep the compiler from removing the loops.
+static volatile size_t INSKBenchmarkSink;
+
+
+// Returns the viewport for a frame, scrolling down the list and back up again.
+static INSKSpatialBounds INSKBenchmarkViewport(size_t frame, double speed, size_t itemCount) {
+    double scrollRange = itemCount * INSKBenchmarkRowHeight - INSKBenchmarkViewportHeight;
+    if (scrollRange < 0.0) {
+        scrollRange = 0.0;
+    }
+    double offset = frame * speed;
+    if (scrollRange > 0.0) {
+        double period = 2.0 * scrollRange;
+        offset -= period * (size_t)(offset / period);
+        if (offset > scrollRange) {
+            offset = period - offset;
+        }
+    } else {
+        offset = 0.0;
+    }
+    INSKSpatialBounds viewport = {
+        -INSKBenchmarkMargin,
+        -offset - INSKBenchmarkViewportHeight - INSKBenchmarkMargin,
+        INSKBenchmarkRowWidth + INSKBenchmarkMargin,
+        -offset + INSKBenchmarkMargin
+    };
+    return viewport;
+}
+
+// Returns the nanoseconds per frame of scrolling with the tracker and adds the number of visible rows to visibleSum.
+static double INSKBenchmarkMeasureTracker(INSKVisibilityTracker *tracker, size_t itemCount, size_t frames, double speed, double *visibleSum) {
+    // The reuse pool of the rows, only the row numbers are recycled here.
+    size_t *pool = (size_t *)malloc(itemCount * sizeof(size_t));
+    size_t poolCount = 0;
+    size_t materialized = 0;
+    if (pool == NULL) {
+        return 0.0;
+    }
+    *visibleSum = 0.0;
+
+    uint64_t start = INSKInstrumentationNow();
+    for (size_t frame = 0; frame < frames; ++frame) {
+        INSKVisibilityTrackerUpdate(tracker, INSKBenchmarkViewport(frame, speed, itemCount));
+        size_t count;
+        const size_t *exited = INSKVisibilityTrackerExited(tracker, &count);
+        for (size_t i = 0; i < count; ++i) {
+            pool[poolCount++] = exited[i];
+        }
+        const size_t *entered = INSKVisibilityTrackerEntered(tracker, &count);
+        for (size_t i = 0; i < count; ++i) {
+            if (poolCount > 0) {
+                INSKBenchmarkSink = pool[--poolCount] + entered[i];
+            } else {
+                materialized++;
+            }
+        }
+        INSKVisibilityTrackerVisible(tracker, &count);
+        *visibleSum += count;
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    INSKBenchmarkSink = materialized;
+    free(pool);
+    return (double)nanoseconds / frames;
+}
+
+// Returns the nanoseconds per frame of testing all rows against the viewport.
+static double INSKBenchmarkMeasureFullScan(const INSKSpatialBounds *items, size_t itemCount, size_t frames, double speed) {
+    uint64_t start = INSKInstrumentationNow();
+    for (size_t frame = 0; frame < frames; ++frame) {
+        INSKSpatialBounds viewport = INSKBenchmarkViewport(frame, speed, itemCount);
+        size_t visible = 0;
+        for (size_t i = 0; i < itemCount; ++i) {
+            visible += (items[i].minX <= viewport.maxX && items[i].maxX >= viewport.minX
+                        && items[i].minY <= viewport.maxY && items[i].maxY >= viewport.minY);
+        }
+        INSKBenchmarkSink = visible;
+    }
+    uint64_t nanoseconds = INSKInstrumentationNow() - start;
+    return (double)nanoseconds / frames;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t frames = 2000;
+    double speed = 25.0;
+    for (int argument = 1; argument < argc; ++argument) {
+        if (strcmp(argv[argument], "-frames") == 0 && argument + 1 < argc) {
+            frames = strtoul(argv[++argument], NULL, 10);
+        } else if (strcmp(argv[argument], "-speed") == 0 && argument + 1 < argc) {
+            speed = strtod(argv[++argument], NULL);
+        } else {
+            fprintf(stderr, "usage: %s [-frames count] [-speed points]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (frames == 0) {
+        frames = 1;
+    }
+
+    printf("frames %zu speed %.1f points per frame\n", frames, speed);
+    printf("%10s %14s %14s %14s %10s\n", "rows", "setup ms", "tracker ns", "full scan ns", "visible");
+
+    INSKVisibilityTracker *tracker = INSKVisibilityTrackerCreate();
+    if (tracker == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (size_t list = 0; list < INSKBenchmarkItemCountCount; ++list) {
+        size_t itemCount = INSKBenchmarkItemCounts[list];
+        INSKSpatialBounds *items = (INSKSpatialBounds *)malloc(itemCount * sizeof(INSKSpatialBounds));
+        if (items == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        for (size_t i = 0; i < itemCount; ++i) {
+            INSKSpatialBounds row = {0.0, -(i + 1.0) * INSKBenchmarkRowHeight, INSKBenchmarkRowWidth, -(double)i * INSKBenchmarkRowHeight};
+            items[i] = row;
+        }
+
+        uint64_t start = INSKInstrumentationNow();
+        if (!INSKVisibilityTrackerSetItems(tracker, items, itemCount)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        double setup = (double)(INSKInstrumentationNow() - start) / 1e6;
+
+        double visibleSum = 0.0;
+        double trackerTime = INSKBenchmarkMeasureTracker(tracker, itemCount, frames, speed, &visibleSum);
+        double fullScanTime = INSKBenchmarkMeasureFullScan(items, itemCount, frames, speed);
+        printf("%10zu %14.2f %14.1f %14.1f %10.1f\n", itemCount, setup, trackerTime, fullScanTime, visibleSum / frames);
+        free(items);
+    }
+    INSKVisibilityTrackerDestroy(tracker);
+    return 0;
+}
@@ -0,0 +1,258 @@
+// Tests INSKVisibilityTracker.h by comparing the reported items with a brute force scan over random layouts and viewports.
+//
+// Build and run it with a C99 compiler:
+//   cc -O2 -std=c99 -IINSpriteKit Tools/INSKVisibilityTrackerTests.c INSpriteKit/INSKVisibilityTracker.c INSpriteKit/INSKSpatialIndex.c -lm -o insk-visibility-tracker-tests && ./insk-visibility-tracker-tests
+//
+// The tool prints each failed assertion and exits with 1 if any test failed.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "INSKVisibilityTracker.h"
+
+
+// The number of failed assertions.
+static int INSKTestFailures = 0;
+
+#define INSK_TEST_ASSERT(condition, ...) do { \
+        if (!(condition)) { \
+            INSKTestFailures++; \
+            printf("%s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+// The number of items of the random layouts.
+#define INSKTestItemCount 2000
+// The number of viewports tested per layout.
+#define INSKTestViewportCount 300
+
+// A xorshift random number generator which returns the same numbers on all platforms.
+static uint32_t INSKTestRandomState = 1;
+
+static double INSKTestRandom(double min, double max) {
+    INSKTestRandomState ^= INSKTestRandomState << 13;
+    INSKTestRandomState ^= INSKTestRandomState >> 17;
+    INSKTestRandomState ^= INSKTestRandomState << 5;
+    return min + (max - min) * (INSKTestRandomState / 4294967296.0);
+}
+
+static INSKSpatialBounds INSKTestBounds(double x, double y, double width, double height) {
+    INSKSpatialBounds bounds = {x, y, x + width, y + height};
+    return bounds;
+}
+
+static bool INSKTestIntersect(INSKSpatialBounds bounds, INSKSpatialBounds other) {
+    return bounds.minX <= other.maxX && bounds.maxX >= other.minX && bounds.minY <= other.maxY && bounds.maxY >= other.minY;
+}
+
+// Returns true if the index list contains each item with a set flag exactly once and no other items.
+static bool INSKTestListMatches(const size_t *indexes, size_t count, const bool *expected, size_t itemCount) {
+    bool *seen = (bool *)calloc(itemCount, sizeof(bool));
+    size_t expectedCount = 0;
+    bool matches = true;
+    for (size_t item = 0; item < itemCount; ++item) {
+        expectedCount += expected[item] ? 1 : 0;
+    }
+    for (size_t i = 0; i < count && matches; ++i) {
+        if (indexes[i] >= itemCount || !expected[indexes[i]] || seen[indexes[i]]) {
+            matches = false;
+        } else {
+            seen[indexes[i]] = true;
+        }
+    }
+    free(seen);
+    return matches && count == expectedCount;
+}
+
+static void INSKTestMarkItem(size_t item, void *context) {
+    bool *marked = (bool *)context;
+    marked[item] = true;
+}
+
+// Updates the tracker and compares the visible, entered and exited items with a brute force scan.
+static void INSKTestUpdateAndCompare(INSKVisibilityTracker *tracker, const INSKSpatialBounds *items, size_t itemCount, INSKSpatialBounds viewport, bool *wasVisible, const char *name) {
+    bool *isVisible = (bool *)calloc(itemCount, sizeof(bool));
+    bool *entered = (bool *)calloc(itemCount, sizeof(bool));
+    bool *exited = (bool *)calloc(itemCount, sizeof(bool));
+    for (size_t item = 0; item < itemCount; ++item) {
+        isVisible[item] = INSKTestIntersect(items[item], viewport);
+        entered[item] = isVisible[item] && !wasVisible[item];
+        exited[item] = !isVisible[item] && wasVisible[item];
+    }
+
+    INSK_TEST_ASSERT(INSKVisibilityTrackerUpdate(tracker, viewport), "%s: update failed", name);
+    size_t count;
+    const size_t *indexes = INSKVisibilityTrackerVisible(tracker, &count);
+    INSK_TEST_ASSERT(INSKTestListMatches(indexes, count, isVisible, itemCount), "%s: visible items differ", name);
+    indexes = INSKVisibilityTrackerEntered(tracker, &count);
+    INSK_TEST_ASSERT(INSKTestListMatches(indexes, count, entered, itemCount), "%s: entered items differ", name);
+    indexes = INSKVisibilityTrackerExited(tracker, &count);
+    INSK_TEST_ASSERT(INSKTestListMatches(indexes, count, exited, itemCount), "%s: exited items differ", name);
+    bool flagsMatch = true;
+    for (size_t item = 0; item < itemCount; ++item) {
+        flagsMatch = flagsMatch && INSKVisibilityTrackerIsVisible(tracker, item) == isVisible[item];
+    }
+    INSK_TEST_ASSERT(flagsMatch, "%s: visibility flags differ", name);
+
+    memcpy(wasVisible, isVisible, itemCount * sizeof(bool));
+    free(exited);
+    free(entered);
+    free(isVisible);
+}
+
+
+// empty trackers
+
+static void test_emptyTracker_hasNoVisibleItems(void) {
+    INSKVisibilityTracker *tracker = INSKVisibilityTrackerCreate();
+    INSK_TEST_ASSERT(tracker != NULL, "tracker not created");
+    INSK_TEST_ASSERT(INSKVisibilityTrackerItemCount(tracker) == 0, "new tracker has items");
+    INSK_TEST_ASSERT(INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(-100, -100, 200, 200)), "update failed");
+    size_t count = 1;
+    INSKVisibilityTrackerVisible(tracker, &count);
+    INSK_TEST_ASSERT(count == 0, "empty tracker has %zu visible items", count);
+    INSK_TEST_ASSERT(!INSKVisibilityTrackerIsVisible(tracker, 0), "invalid item is visible");
+
+    INSK_TEST_ASSERT(INSKVisibilityTrackerSetItems(tracker, NULL, 0), "setting no items failed");
+    INSK_TEST_ASSERT(INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(-100, -100, 200, 200)), "update failed");
+    INSKVisibilityTrackerVisible(tracker, &count);
+    INSK_TEST_ASSERT(count == 0, "tracker without items has %zu visible items", count);
+    INSKVisibilityTrackerDestroy(tracker);
+    INSKVisibilityTrackerDestroy(NULL);
+}
+
+
+// lists
+
+static void test_scrollingList_reportsEnteringAndLeavingRows(void) {
+    // A list of 100 rows with a height of 10 going down from the origin like the content of a scroll node.
+    INSKSpatialBounds rows[100];
+    for (int row = 0; row < 100; ++row) {
+        rows[row] = INSKTestBounds(0, -10 * (row + 1), 320, 10);
+    }
+    INSKVisibilityTracker *tracker = INSKVisibilityTrackerCreate();
+    INSK_TEST_ASSERT(INSKVisibilityTrackerSetItems(tracker, rows, 100), "setting the rows failed");
+    INSK_TEST_ASSERT(INSKVisibilityTrackerItemCount(tracker) == 100, "item count is %zu", INSKVisibilityTrackerItemCount(tracker));
+
+    // Rows 0 to 4, the borders are not touched.
+    INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(0, -49, 320, 48));
+    size_t count;
+    INSKVisibilityTrackerEntered(tracker, &count);
+    INSK_TEST_ASSERT(count == 5, "%zu rows entered instead of 5", count);
+    INSK_TEST_ASSERT(INSKVisibilityTrackerIsVisible(tracker, 4) && !INSKVisibilityTrackerIsVisible(tracker, 5), "wrong rows are visible");
+
+    // Scroll down by 20, rows 0 and 1 leave, rows 5 and 6 enter.
+    INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(0, -69, 320, 48));
+    const size_t *entered = INSKVisibilityTrackerEntered(tracker, &count);
+    INSK_TEST_ASSERT(count == 2 && entered[0] + entered[1] == 11, "rows 5 and 6 haven't entered");
+    const size_t *exited = INSKVisibilityTrackerExited(tracker, &count);
+    INSK_TEST_ASSERT(count == 2 && exited[0] + exited[1] == 1, "rows 0 and 1 haven't exited");
+
+    // Not moving reports nothing.
+    INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(0, -69, 320, 48));
+    INSKVisibilityTrackerEntered(tracker, &count);
+    INSK_TEST_ASSERT(count == 0, "%zu rows entered without moving", count);
+    INSKVisibilityTrackerExited(tracker, &count);
+    INSK_TEST_ASSERT(count == 0, "%zu rows exited without moving", count);
+
+    // Resetting reports all visible rows as exited.
+    INSKVisibilityTrackerReset(tracker);
+    INSKVisibilityTrackerExited(tracker, &count);
+    INSK_TEST_ASSERT(count == 5, "%zu rows exited on reset instead of 5", count);
+    INSKVisibilityTrackerVisible(tracker, &count);
+    INSK_TEST_ASSERT(count == 0 && !INSKVisibilityTrackerIsVisible(tracker, 3), "rows are visible after reset");
+    INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(0, -69, 320, 48));
+    INSKVisibilityTrackerEntered(tracker, &count);
+    INSK_TEST_ASSERT(count == 5, "%zu rows entered after reset instead of 5", count);
+
+    // Replacing the items hides all rows without reporting them.
+    INSK_TEST_ASSERT(INSKVisibilityTrackerSetItems(tracker, rows, 50), "setting the rows failed");
+    INSKVisibilityTrackerExited(tracker, &count);
+    INSK_TEST_ASSERT(count == 0 && !INSKVisibilityTrackerIsVisible(tracker, 3), "rows are visible after replacing them");
+    INSKVisibilityTrackerUpdate(tracker, INSKTestBounds(0, -10000, 320, 10000));
+    INSKVisibilityTrackerVisible(tracker, &count);
+    INSK_TEST_ASSERT(count == 50, "%zu rows visible instead of 50", count);
+
+    INSKVisibilityTrackerDestroy(tracker);
+}
+
+
+// random layouts
+
+static void test_randomLayouts_matchBruteForce(void) {
+    INSKSpatialBounds *items = (INSKSpatialBounds *)malloc(INSKTestItemCount * sizeof(INSKSpatialBounds));
+    bool *wasVisible = (bool *)calloc(INSKTestItemCount, sizeof(bool));
+    INSKVisibilityTracker *tracker = INSKVisibilityTrackerCreate();
+
+    // A grid of tiles, mixed sizes and some huge items.
+    for (int layout = 0; layout < 3; ++layout) {
+        for (size_t item = 0; item < INSKTestItemCount; ++item) {
+            if (layout == 0) {
+                items[item] = INSKTestBounds((item % 40) * 25.0, -((item / 40) + 1) * 25.0, 25, 25);
+            } else if (layout == 1) {
+                items[item] = INSKTestBounds(INSKTestRandom(0, 2000), INSKTestRandom(-4000, 0), INSKTestRandom(1, 200), INSKTestRandom(1, 200));
+            } else {
+                double size = (item % 100 == 0) ? 3000 : 10;
+                items[item] = INSKTestBounds(INSKTestRandom(-1000, 1000), INSKTestRandom(-1000, 1000), size, size);
+            }
+        }
+        INSK_TEST_ASSERT(INSKVisibilityTrackerSetItems(tracker, items, INSKTestItemCount), "setting layout %d failed", layout);
+        memset(wasVisible, 0, INSKTestItemCount * sizeof(bool));
+
+        // Jump around and scroll smoothly in between.
+        INSKSpatialBounds viewport = INSKTestBounds(0, -568, 320, 568);
+        for (int step = 0; step < INSKTestViewportCount; ++step) {
+            if (step % 50 == 0) {
+                viewport = INSKTestBounds(INSKTestRandom(-1500, 2000), INSKTestRandom(-4500, 500), INSKTestRandom(0, 600), INSKTestRandom(0, 800));
+            } else {
+                double dx = INSKTestRandom(-30, 30);
+                double dy = INSKTestRandom(-30, 30);
+                viewport = INSKTestBounds(viewport.minX + dx, viewport.minY + dy, viewport.maxX - viewport.minX, viewport.maxY - viewport.minY);
+            }
+            char name[64];
+            snprintf(name, sizeof(name), "layout %d step %d", layout, step);
+            INSKTestUpdateAndCompare(tracker, items, INSKTestItemCount, viewport, wasVisible, name);
+
+            // Looking ahead finds the same items as a brute force scan and doesn't change the visible items.
+            if (step % 10 == 0) {
+                INSKSpatialBounds ahead = INSKTestBounds(viewport.minX + INSKTestRandom(-500, 500), viewport.minY + INSKTestRandom(-500, 500), 320, 568);
+                bool *marked = (bool *)calloc(INSKTestItemCount, sizeof(bool));
+                bool *expected = (bool *)calloc(INSKTestItemCount, sizeof(bool));
+                size_t expectedCount = 0;
+                bool matches = true;
+                for (size_t item = 0; item < INSKTestItemCount; ++item) {
+                    expected[item] = INSKTestIntersect(items[item], ahead);
+                    expectedCount += expected[item] ? 1 : 0;
+                }
+                size_t count = INSKVisibilityTrackerQuery(tracker, ahead, INSKTestMarkItem, marked);
+                for (size_t item = 0; item < INSKTestItemCount; ++item) {
+                    matches = matches && marked[item] == expected[item] && INSKVisibilityTrackerIsVisible(tracker, item) == wasVisible[item];
+                }
+                INSK_TEST_ASSERT(matches && count == expectedCount, "%s: queried items differ", name);
+                free(expected);
+                free(marked);
+            }
+        }
+    }
+
+    INSKVisibilityTrackerDestroy(tracker);
+    free(wasVisible);
+    free(items);
+}
+
+
+int main(void) {
+    test_emptyTracker_hasNoVisibleItems();
+    test_scrollingList_reportsEnteringAndLeavingRows();
+    test_randomLayouts_matchBruteForce();
+
+    if (INSKTestFailures > 0) {
+        printf("%d assertions failed\n", INSKTestFailures);
+        return 1;
+    }
+    printf("all tests passed\n");
+    return 0;
+}